@@ -2,6 +2,7 @@
 
 #include "ConfigManager.h"
 #include "OutputManager.h"
+#include "OverlayTransformCache.h"
 
 BackgroundOverlay::BackgroundOverlay() : m_OvrlHandle(vr::k_ulOverlayHandleInvalid)
 {
@@ -13,6 +14,7 @@ BackgroundOverlay::~BackgroundOverlay()
     if (m_OvrlHandle != vr::k_ulOverlayHandleInvalid)
     {
         vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
+        OverlayTransformCache::Get().Invalidate(m_OvrlHandle);
     }
 }
 
@@ -25,6 +27,7 @@ void BackgroundOverlay::Update()
         if (m_OvrlHandle != vr::k_ulOverlayHandleInvalid)
         {
             vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
+            OverlayTransformCache::Get().Invalidate(m_OvrlHandle);
             m_OvrlHandle = vr::k_ulOverlayHandleInvalid;
         }
     }
@@ -54,7 +57,7 @@ void BackgroundOverlay::Update()
             Matrix4 transform;
             transform.setTranslation({0.0f, 0.0f, -10.0f});
             vr::HmdMatrix34_t transform_openvr = transform.toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(m_OvrlHandle, vr::k_unTrackedDeviceIndex_Hmd, &transform_openvr);
+            OverlayTransformCache::Get().SetOverlayTransformTrackedDeviceRelative(m_OvrlHandle, vr::k_unTrackedDeviceIndex_Hmd, &transform_openvr);
         }
 
         bool display_overlay = true; //ui_bgcolor_dispmode_always
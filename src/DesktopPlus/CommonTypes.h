@@ -12,6 +12,9 @@
 #include <string>
 
 #include "DPRect.h"
+#include "DuplicationWaitPolicy.h"
+#include "CursorState.h"
+#include "OutputComposer.h"
 
 #include "PixelShader.h"
 #include "PixelShaderCursor.h"
@@ -54,18 +57,18 @@ DUPL_RETURN ProcessFailure(_In_opt_ ID3D11Device* device, _In_ LPCWSTR str, _In_
 void DisplayMsg(_In_ LPCWSTR str, _In_ LPCWSTR title, HRESULT hr);
 
 //
-// Holds info about the pointer/cursor
+// Holds info about the pointer/cursor, as read by the main thread from the CursorState (see THREADMANAGER::GetPointerInfo())
 //
 typedef struct _PTR_INFO
 {
-    _Field_size_bytes_(BufferSize) BYTE* PtrShapeBuffer;
+    _Field_size_bytes_(BufferSize) const BYTE* PtrShapeBuffer;
     DXGI_OUTDUPL_POINTER_SHAPE_INFO ShapeInfo;
     POINT Position;
     bool Visible;
     UINT BufferSize;
     UINT WhoUpdatedPositionLast;
     LARGE_INTEGER LastTimeStamp;
-    bool CursorShapeChanged;
+    bool CursorShapeChanged;        //Set when a new shape was read, until reset by whoever handled it
 } PTR_INFO;
 
 //
@@ -103,10 +106,11 @@ typedef struct _THREAD_DATA
     UINT Output;
     INT OffsetX;
     INT OffsetY;
-    PTR_INFO* PtrInfo;
+    CursorState* Cursor;
     DX_RESOURCES DxRes;
-    DPRect* DirtyRegionTotal;
+    ComposeOutput* Compose;
     bool WMRIgnoreVScreens;
+    DuplicationWaitPolicy* WaitPolicy;
 } THREAD_DATA;
 
 //
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+//Hands the cursor position and shape from the duplication threads to the main thread (see DUPLICATIONMANAGER::GetMouse() and THREADMANAGER::GetPointerInfo())
+//Triple buffered: Writers fill the back slot and swap it with the middle one, the reader swaps its front slot with the middle one if it was published since the last read
+//Neither side waits on the other and the reader always gets position and shape from the same update
+//Writers still wait on each other, as merging updates from multiple outputs needs the previous state
+//Shape storage is preallocated for common cursor sizes and only grows on the writer side, in slots the reader isn't using
+//Kept free of Windows headers so it can be tested anywhere
+
+struct CursorShapeInfo                      //Same as DXGI_OUTDUPL_POINTER_SHAPE_INFO
+{
+    uint32_t Type;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Pitch;
+    int32_t HotSpotX;
+    int32_t HotSpotY;
+};
+
+struct CursorStateData
+{
+    int32_t PositionX;
+    int32_t PositionY;
+    bool Visible;
+    uint32_t WhoUpdatedPositionLast;
+    int64_t LastTimeStamp;
+    CursorShapeInfo ShapeInfo;
+    uint32_t ShapeSize;                     //Size of the shape data in bytes, 0 if there is none
+    uint32_t ShapeID;                       //Changes with every new shape
+    uint64_t Sequence;                      //Changes with every published update
+};
+
+struct CursorStateMetrics
+{
+    uint64_t PublishCount;                  //Updates published by writers
+    uint64_t WriterContentionCount;         //Updates that had to wait for another writer first
+    uint64_t ReadCount;                     //Reads that picked up a newly published update
+    uint64_t CoalescedCount;                //Updates replaced by a newer one before they were read
+    uint64_t ShapeGrowCount;                //Times a shape didn't fit into the preallocated storage
+};
+
+class CursorState
+{
+    public:
+        static const uint32_t ShapeReserveSize = 256 * 256 * 4; //Covers color cursors up to 256x256
+
+    private:
+        static const uint32_t IndexMask = 0x3;
+        static const uint32_t NewBit    = 0x4;  //Set in m_MiddleIndex while it holds an update not read yet
+
+        struct Slot
+        {
+            CursorStateData Data;
+            std::vector<uint8_t> ShapeBuffer;
+            uint32_t ShapeBufferID;             //ShapeID of the data in ShapeBuffer
+        };
+
+        Slot m_Slots[3];
+        alignas(64) std::atomic<uint32_t> m_MiddleIndex;
+
+        //- Only accessed by the writer holding m_WriterMutex
+        alignas(64) std::mutex m_WriterMutex;
+        uint32_t m_BackIndex;
+        uint32_t m_LatestIndex;                 //Slot of the last published update, either the middle or the front one
+        uint32_t m_ShapeIDCounter;
+        bool m_HasNewShape;
+
+        //- Only accessed by the reader
+        alignas(64) uint32_t m_FrontIndex;
+
+        std::atomic<uint64_t> m_PublishCount;
+        std::atomic<uint64_t> m_WriterContentionCount;
+        std::atomic<uint64_t> m_ReadCount;
+        std::atomic<uint64_t> m_CoalescedCount;
+        std::atomic<uint64_t> m_ShapeGrowCount;
+
+        static void ReserveShapeBuffer(Slot& slot, uint32_t size, std::atomic<uint64_t>& grow_count)
+        {
+            if (slot.ShapeBuffer.size() < size)
+            {
+                slot.ShapeBuffer.resize(size);
+                grow_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void BeginWrite()
+        {
+            if (!m_WriterMutex.try_lock())
+            {
+                m_WriterContentionCount.fetch_add(1, std::memory_order_relaxed);
+                m_WriterMutex.lock();
+            }
+
+            //Start from the last published state
+            m_Slots[m_BackIndex].Data = m_Slots[m_LatestIndex].Data;
+            m_HasNewShape = false;
+        }
+
+        uint8_t* BeginNewShape(uint32_t size)
+        {
+            Slot& back = m_Slots[m_BackIndex];
+            ReserveShapeBuffer(back, size, m_ShapeGrowCount);
+
+            back.Data.ShapeSize = size;
+            back.Data.ShapeID   = ++m_ShapeIDCounter;
+            back.ShapeBufferID  = back.Data.ShapeID;
+            m_HasNewShape = true;
+
+            return back.ShapeBuffer.data();
+        }
+
+        void EndWrite()
+        {
+            Slot& back = m_Slots[m_BackIndex];
+
+            //Bring the shape over from the last update if this slot has an older one. Reading the latest slot is fine even if it's the reader's front slot
+            if ( (!m_HasNewShape) && (back.ShapeBufferID != back.Data.ShapeID) )
+            {
+                const Slot& latest = m_Slots[m_LatestIndex];
+
+                ReserveShapeBuffer(back, latest.Data.ShapeSize, m_ShapeGrowCount);
+                if (latest.Data.ShapeSize != 0)
+                {
+                    memcpy(back.ShapeBuffer.data(), latest.ShapeBuffer.data(), latest.Data.ShapeSize);
+                }
+                back.ShapeBufferID = back.Data.ShapeID;
+            }
+
+            back.Data.Sequence = m_Slots[m_LatestIndex].Data.Sequence + 1;
+
+            const uint32_t published_index = m_BackIndex;
+            const uint32_t prev_middle = m_MiddleIndex.exchange(published_index | NewBit, std::memory_order_acq_rel);
+
+            if ((prev_middle & NewBit) != 0)
+            {
+                m_CoalescedCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            m_BackIndex   = prev_middle & IndexMask;
+            m_LatestIndex = published_index;
+            m_PublishCount.fetch_add(1, std::memory_order_relaxed);
+
+            m_WriterMutex.unlock();
+        }
+
+        friend class CursorStateWriter;
+
+    public:
+        CursorState() : m_MiddleIndex(1), m_BackIndex(2), m_LatestIndex(1), m_ShapeIDCounter(0), m_HasNewShape(false), m_FrontIndex(0),
+                        m_PublishCount(0), m_WriterContentionCount(0), m_ReadCount(0), m_CoalescedCount(0), m_ShapeGrowCount(0)
+        {
+            for (Slot& slot : m_Slots)
+            {
+                slot.Data = CursorStateData();
+                slot.ShapeBuffer.resize(ShapeReserveSize);
+                slot.ShapeBufferID = 0;
+            }
+        }
+
+        //Clears the state back to no cursor. No writer or reader may be active during this
+        void Reset()
+        {
+            for (Slot& slot : m_Slots)
+            {
+                slot.Data = CursorStateData();
+                slot.ShapeBufferID = 0;
+            }
+
+            m_MiddleIndex.store(1);
+            m_BackIndex   = 2;
+            m_LatestIndex = 1;
+            m_ShapeIDCounter = 0;
+            m_FrontIndex  = 0;
+        }
+
+        //- Reader (single thread only)
+        //Returns the last published state. It and shape_buffer_out (ShapeSize bytes) stay unchanged until the next call
+        const CursorStateData& Read(const uint8_t*& shape_buffer_out)
+        {
+            if ((m_MiddleIndex.load(std::memory_order_relaxed) & NewBit) != 0)
+            {
+                m_FrontIndex = m_MiddleIndex.exchange(m_FrontIndex, std::memory_order_acq_rel) & IndexMask;
+                m_ReadCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const Slot& front = m_Slots[m_FrontIndex];
+            shape_buffer_out = front.ShapeBuffer.data();
+
+            return front.Data;
+        }
+
+        //Can be called from any thread
+        CursorStateMetrics GetMetrics() const
+        {
+            return {m_PublishCount.load(std::memory_order_relaxed), m_WriterContentionCount.load(std::memory_order_relaxed), m_ReadCount.load(std::memory_order_relaxed),
+                    m_CoalescedCount.load(std::memory_order_relaxed), m_ShapeGrowCount.load(std::memory_order_relaxed)};
+        }
+};
+
+//Writes an update to the CursorState, published when this goes out of scope
+//Data starts out as the last published state
+class CursorStateWriter
+{
+    private:
+        CursorState& m_State;
+
+    public:
+        CursorStateWriter(CursorState& state) : m_State(state) { m_State.BeginWrite(); }
+        ~CursorStateWriter()                                   { m_State.EndWrite(); }
+
+        CursorStateWriter(const CursorStateWriter&) = delete;
+        CursorStateWriter& operator=(const CursorStateWriter&) = delete;
+
+        CursorStateData& GetData() { return m_State.m_Slots[m_State.m_BackIndex].Data; }
+
+        //Starts a new shape of the given size and returns the buffer to write it to. Size can be 0 for no shape
+        uint8_t* BeginNewShape(uint32_t size) { return m_State.BeginNewShape(size); }
+};
@@ -20,6 +20,8 @@
 #include "ThreadManager.h"
 #include "InterprocessMessaging.h"
 #include "ElevatedMode.h"
+#include "PerformanceTrace.h"
+#include "ErrorLog.h"
 
 // Below are lists of errors expect from Dxgi API calls when a transition event like mode change, PnpStop, PnpStart
 // desktop switch, TDR or session disconnect/reconnect. In all these cases we want the application to clean up the threads that process
@@ -63,9 +65,9 @@ HRESULT EnumOutputsExpectedErrors[] = {
 DWORD WINAPI CaptureThreadEntry(_In_ void* Param);
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 bool SpawnProcessWithDefaultEnv(LPCWSTR application_name, LPWSTR commandline = nullptr);
-void ProcessCmdline(bool& use_elevated_mode);
+void ProcessCmdline(bool& use_elevated_mode, bool& record_vr_stream);
 bool DisplayInitError(vr::EVRInitError vr_init_error, vr::EVROverlayError vr_overlay_error, bool vr_input_success);
-void WriteMessageToLog(_In_ LPCWSTR str);
+void WriteMessageToLog(_In_ LPCWSTR str, LogSeverity severity = log_severity_error);
 
 //
 // Class for progressive waits
@@ -158,7 +160,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     UNREFERENCED_PARAMETER(lpCmdLine);
 
     bool use_elevated_mode = false;
-    ProcessCmdline(use_elevated_mode);
+    bool record_vr_stream  = false;
+    ProcessCmdline(use_elevated_mode, record_vr_stream);
 
     if (use_elevated_mode)
     {
@@ -166,6 +169,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
         return ElevatedModeEnter(hInstance);
     }
 
+    //Messages logged before this are still written when the process exits
+    //Stops the writer thread and writes what's left on every return from here on, after the other locals are destroyed but before static destruction
+    ErrorLogScope error_log_scope;
+
     INT SingleOutput = 0;
 
     // Synchronization
@@ -271,6 +278,12 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     THREADMANAGER ThreadMgr;
     OutputManager OutMgr(PauseDuplicationEvent, ResumeDuplicationEvent);
     RECT DeskBounds;
+
+    //Recorded until exit, for looking into input-dependent issues
+    if (record_vr_stream)
+    {
+        OutMgr.StartVRStreamRecording((ConfigManager::Get().GetApplicationPath() + "vr_stream.dpvrs").c_str());
+    }
     UINT OutputCount;
 
     //Start up UI process unless disabled or already running
@@ -378,12 +391,12 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             Ret = OutMgr.InitOutput(WindowHandle, SingleOutput, &OutputCount, &DeskBounds);
             if (Ret == DUPL_RETURN_SUCCESS)
             {
-                HANDLE SharedHandle = OutMgr.GetSharedHandle();
-                if (SharedHandle)
+                std::vector<HANDLE> SharedHandles = OutMgr.GetOutputSharedHandles();
+                if (!SharedHandles.empty())
                 {
                     Ret = ThreadMgr.Initialize(SingleOutput, OutputCount, UnexpectedErrorEvent, ExpectedErrorEvent, NewFrameProcessedEvent, PauseDuplicationEvent,
-                                               ResumeDuplicationEvent, TerminateThreadsEvent, SharedHandle, &DeskBounds, OutMgr.GetDXGIAdapter(), 
-                                               (ConfigManager::Get().GetConfigInt(configid_int_interface_wmr_ignore_vscreens) == 1));
+                                               ResumeDuplicationEvent, TerminateThreadsEvent, SharedHandles, OutMgr.GetOutputComposer(), &DeskBounds, OutMgr.GetDXGIAdapter(), 
+                                               (ConfigManager::Get().GetConfigInt(configid_int_interface_wmr_ignore_vscreens) == 1), &OutMgr.GetDuplicationWaitPolicy());
                 }
                 else
                 {
@@ -444,7 +457,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 SkipFrame = false;
             }
 
-            RetUpdate = OutMgr.Update(ThreadMgr.GetPointerInfo(), ThreadMgr.GetDirtyRegionTotal(), IsNewFrame, SkipFrame);
+            RetUpdate = OutMgr.Update(ThreadMgr.GetPointerInfo(), IsNewFrame, SkipFrame);
 
             //Map return value to DUPL_RETRUN Ret
             switch (RetUpdate)
@@ -460,7 +473,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
                 QueryPerformanceCounter(&UpdateLimiterStartingTime);
             }
 
-            OutMgr.UpdatePerformanceStates();
+            OutMgr.UpdatePerformanceStates(ThreadMgr.GetCursorStateMetrics());
+            OutMgr.UpdateCaptureWorkerBalance();
         }
 
         // Check if for errors
@@ -609,7 +623,7 @@ bool SpawnProcessWithDefaultEnv(LPCWSTR application_name, LPWSTR commandline)
     return false;
 }
 
-void ProcessCmdline(bool& use_elevated_mode)
+void ProcessCmdline(bool& use_elevated_mode, bool& record_vr_stream)
 {
     //__argv and __argc are global vars set by system
     for (UINT i = 0; i < static_cast<UINT>(__argc); ++i)
@@ -619,6 +633,11 @@ void ProcessCmdline(bool& use_elevated_mode)
         {
             use_elevated_mode = true;
         }
+        else if ((strcmp(__argv[i], "-RecordVRStream") == 0) ||
+                 (strcmp(__argv[i], "/RecordVRStream") == 0))
+        {
+            record_vr_stream = true;
+        }
     }
 }
 
@@ -660,7 +679,7 @@ bool DisplayInitError(vr::EVRInitError vr_init_error, vr::EVROverlayError vr_ove
     if (!vr_input_success)
     {
         //VRInput not working is bad, but doesn't stop us from running, so just log it
-        WriteMessageToLog(L"Failed to load VRInput action manifest. Some input-related functionality will not be available.");
+        WriteMessageToLog(L"Failed to load VRInput action manifest. Some input-related functionality will not be available.", log_severity_warning);
     }
 
     return false;
@@ -674,6 +693,7 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
     // Classes
     DISPLAYMANAGER DispMgr;
     DUPLICATIONMANAGER DuplMgr;
+    DuplicationWaitState WaitState;
 
     // D3D objects
     ID3D11Texture2D* SharedSurf = nullptr;
@@ -735,9 +755,24 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
     RtlZeroMemory(&DesktopDesc, sizeof(DXGI_OUTPUT_DESC));
     DuplMgr.GetOutputDesc(&DesktopDesc);
 
+    // The output surface is created for this output's size. If it doesn't match, the layout changed since and duplication needs to be restarted
+    {
+        D3D11_TEXTURE2D_DESC SurfDesc;
+        SharedSurf->GetDesc(&SurfDesc);
+
+        if ( ((INT)SurfDesc.Width  != DesktopDesc.DesktopCoordinates.right  - DesktopDesc.DesktopCoordinates.left) ||
+             ((INT)SurfDesc.Height != DesktopDesc.DesktopCoordinates.bottom - DesktopDesc.DesktopCoordinates.top) )
+        {
+            Ret = DUPL_RETURN_ERROR_EXPECTED;
+            goto Exit;
+        }
+    }
+
     // Main duplication loop
     bool WaitToProcessCurrentFrame = false;
     FRAME_DATA CurrentData;
+    DuplicationWaitPolicy* WaitPolicy = TData->WaitPolicy;
+    WaitState.SetOutputRect({DesktopDesc.DesktopCoordinates.left, DesktopDesc.DesktopCoordinates.top, DesktopDesc.DesktopCoordinates.right, DesktopDesc.DesktopCoordinates.bottom});
 
     while ((WaitForSingleObjectEx(TData->TerminateThreadsEvent, 0, FALSE) == WAIT_TIMEOUT))
     {
@@ -749,9 +784,18 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
 
         if (!WaitToProcessCurrentFrame)
         {
+            //Wait without holding a frame first if the output isn't shown or updates are limited
+            DuplicationWaitStep WaitStep = WaitPolicy->GetNextStep(WaitState, ::GetTickCount64());
+            if (WaitStep.IdleMS != 0)
+            {
+                //Check for pause and termination again after waiting
+                WaitPolicy->WaitIdle(WaitState, WaitStep.IdleMS);
+                continue;
+            }
+
             // Get new frame from desktop duplication
             bool TimeOut;
-            Ret = DuplMgr.GetFrame(&CurrentData, &TimeOut);
+            Ret = DuplMgr.GetFrame(&CurrentData, WaitStep.AcquireTimeoutMS, &TimeOut);
             if (Ret != DUPL_RETURN_SUCCESS)
             {
                 // An error occurred getting the next frame drop out of loop which
@@ -763,8 +807,19 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
             if (TimeOut)
             {
                 // No new frame at the moment
+                WaitPolicy->OnAcquireTimeout(WaitState);
                 continue;
             }
+
+            WaitPolicy->OnFrame(WaitState, ::GetTickCount64());
+
+            // Get mouse info. Doesn't need the shared surface, so it's published right away even if the main thread still holds it
+            Ret = DuplMgr.GetMouse(*TData->Cursor, &(CurrentData.FrameInfo), TData->OffsetX, TData->OffsetY);
+            if (Ret != DUPL_RETURN_SUCCESS)
+            {
+                DuplMgr.DoneWithFrame();
+                break;
+            }
         }
 
         // We have a new frame so try and process it
@@ -787,26 +842,29 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
         // We can now process the current frame
         WaitToProcessCurrentFrame = false;
 
-        // Get mouse info
-        Ret = DuplMgr.GetMouse(TData->PtrInfo, &(CurrentData.FrameInfo), TData->OffsetX, TData->OffsetY);
-        if (Ret != DUPL_RETURN_SUCCESS)
+        // Process new frame
+        DPRect FrameDirtyRect(-1, -1, -1, -1);
         {
-            DuplMgr.DoneWithFrame();
-            KeyMutex->ReleaseSync(1);
-            break;
+            PerformanceTraceScope trace_scope(perftrace_dupl_process_frame);
+            //The output surface starts at the output's origin, so the dirty rect comes out output-local
+            Ret = DispMgr.ProcessFrame(&CurrentData, SharedSurf, DesktopDesc.DesktopCoordinates.left, DesktopDesc.DesktopCoordinates.top, &DesktopDesc, FrameDirtyRect);
+        }
+
+        if (FrameDirtyRect.GetTL().x != -1)
+        {
+            TData->Compose->AddDirtyRect({FrameDirtyRect.GetTL().x, FrameDirtyRect.GetTL().y, FrameDirtyRect.GetBR().x, FrameDirtyRect.GetBR().y});
         }
 
-        // Process new frame
-        Ret = DispMgr.ProcessFrame(&CurrentData, SharedSurf, TData->OffsetX, TData->OffsetY, &DesktopDesc, *TData->DirtyRegionTotal);
         if (Ret != DUPL_RETURN_SUCCESS)
         {
             DuplMgr.DoneWithFrame();
             KeyMutex->ReleaseSync(1);
+            TData->Compose->SetFrameReady();
             SetEvent(TData->NewFrameProcessedEvent);
             break;
         }
 
-        // Release acquired keyed mutex
+        // Release acquired keyed mutex, the main thread only acquires it after the frame is marked as ready
         hr = KeyMutex->ReleaseSync(1);
         if (FAILED(hr))
         {
@@ -815,6 +873,8 @@ DWORD WINAPI CaptureThreadEntry(_In_ void* Param)
             break;
         }
 
+        TData->Compose->SetFrameReady();
+
         // Release frame back to desktop duplication
         Ret = DuplMgr.DoneWithFrame();
         if (Ret != DUPL_RETURN_SUCCESS)
@@ -938,28 +998,8 @@ void DisplayMsg(_In_ LPCWSTR str, _In_ LPCWSTR title, HRESULT hr)
     IPCManager::Get().SendStringToUIApp(configid_str_state_dashboard_error_string, StringConvertFromUTF16(ss.str().c_str()), window);
 }
 
-void WriteMessageToLog(_In_ LPCWSTR str)
+void WriteMessageToLog(_In_ LPCWSTR str, LogSeverity severity)
 {
-    //Get rid of newlines (system error strings comes with CRLF while \n is treated as LF-only before writing to file...)
-    std::wstring wstr(str);
-    std::wstring nline(L"\r\n");
-    size_t start_pos = 0;
-    while ((start_pos = wstr.find(nline, start_pos)) != std::string::npos)
-    {
-        wstr.replace(start_pos, nline.length(), L" ");
-    }
-
-    start_pos = 0;
-    nline = L"\n";
-    while ((start_pos = wstr.find(nline, start_pos)) != std::string::npos)
-    {
-        wstr.replace(start_pos, nline.length(), L" ");
-    }
-
-    //Get the time
-    std::time_t t = std::time(nullptr);
-    std::tm tm = *std::localtime(&t);
-
-    std::wofstream err_log("error.log", std::ios::app | std::ios::binary); //btw. the resulting file is in local encoding, not utf-16, but that's good enough
-    err_log << std::put_time(&tm, L"[%Y-%m-%d %H:%M] ") << wstr << L"\n";
+    //Queued and written to error.log by the log's writer thread
+    ErrorLog::Get().Write(severity, str);
 }
\ No newline at end of file
@@ -165,24 +165,11 @@ void DISPLAYMANAGER::SetMoveRect(_Out_ RECT* SrcRect, _Out_ RECT* DestRect, _In_
 DUPL_RETURN DISPLAYMANAGER::CopyMove(_Inout_ ID3D11Texture2D* SharedSurf, _In_reads_(MoveCount) DXGI_OUTDUPL_MOVE_RECT* MoveBuffer, UINT MoveCount, INT OffsetX, INT OffsetY, _In_ DXGI_OUTPUT_DESC* DeskDesc,
                                      INT TexWidth, INT TexHeight, _Inout_ DPRect& DirtyRectTotal)
 {
-    D3D11_TEXTURE2D_DESC FullDesc;
-    SharedSurf->GetDesc(&FullDesc);
+    //Moves in shared surface coordinates
+    const INT SurfOffsetX = DeskDesc->DesktopCoordinates.left - OffsetX;
+    const INT SurfOffsetY = DeskDesc->DesktopCoordinates.top  - OffsetY;
 
-    // Make new intermediate surface to copy into for moving
-    if (!m_MoveSurf)
-    {
-        D3D11_TEXTURE2D_DESC MoveDesc;
-        MoveDesc = FullDesc;
-        MoveDesc.Width = DeskDesc->DesktopCoordinates.right - DeskDesc->DesktopCoordinates.left;
-        MoveDesc.Height = DeskDesc->DesktopCoordinates.bottom - DeskDesc->DesktopCoordinates.top;
-        MoveDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
-        MoveDesc.MiscFlags = 0;
-        HRESULT hr = m_Device->CreateTexture2D(&MoveDesc, nullptr, &m_MoveSurf);
-        if (FAILED(hr))
-        {
-            return ProcessFailure(m_Device, L"Failed to create staging texture for move rects", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
-        }
-    }
+    m_MovePlanMoves.clear();
 
     for (UINT i = 0; i < MoveCount; ++i)
     {
@@ -191,34 +178,77 @@ DUPL_RETURN DISPLAYMANAGER::CopyMove(_Inout_ ID3D11Texture2D* SharedSurf, _In_re
 
         SetMoveRect(&SrcRect, &DestRect, DeskDesc, &(MoveBuffer[i]), TexWidth, TexHeight);
 
-        // Copy rect out of shared surface
+        MovePlanMove move;
+        move.Source = {SrcRect.left + SurfOffsetX, SrcRect.top + SurfOffsetY, SrcRect.right + SurfOffsetX, SrcRect.bottom + SurfOffsetY};
+        move.DestX  = DestRect.left + SurfOffsetX;
+        move.DestY  = DestRect.top  + SurfOffsetY;
+
+        m_MovePlanMoves.push_back(move);
+    }
+
+    PlanMoveRects(m_MovePlanMoves.data(), m_MovePlanMoves.size(), m_MovePlan);
+
+    //Make sure the scratch surface is large enough if any moves need it
+    if (m_MovePlan.ScratchWidth != 0)
+    {
+        //Grow to the largest size needed so far, so it's not recreated for slightly different scroll areas
+        UINT ScratchWidth  = m_MovePlan.ScratchWidth;
+        UINT ScratchHeight = m_MovePlan.ScratchHeight;
+
+        if (m_MoveSurf)
+        {
+            D3D11_TEXTURE2D_DESC MoveDesc;
+            m_MoveSurf->GetDesc(&MoveDesc);
+
+            if ( (MoveDesc.Width < ScratchWidth) || (MoveDesc.Height < ScratchHeight) )
+            {
+                ScratchWidth  = std::max(ScratchWidth,  MoveDesc.Width);
+                ScratchHeight = std::max(ScratchHeight, MoveDesc.Height);
+
+                m_MoveSurf->Release();
+                m_MoveSurf = nullptr;
+            }
+        }
+
+        if (!m_MoveSurf)
+        {
+            D3D11_TEXTURE2D_DESC MoveDesc;
+            SharedSurf->GetDesc(&MoveDesc);
+            MoveDesc.Width     = ScratchWidth;
+            MoveDesc.Height    = ScratchHeight;
+            MoveDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+            MoveDesc.MiscFlags = 0;
+            HRESULT hr = m_Device->CreateTexture2D(&MoveDesc, nullptr, &m_MoveSurf);
+            if (FAILED(hr))
+            {
+                return ProcessFailure(m_Device, L"Failed to create staging texture for move rects", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+            }
+        }
+    }
+
+    for (const MovePlanCopy& copy : m_MovePlan.Copies)
+    {
         D3D11_BOX Box;
-        Box.left = SrcRect.left + DeskDesc->DesktopCoordinates.left - OffsetX;
-        Box.top = SrcRect.top + DeskDesc->DesktopCoordinates.top - OffsetY;
-        Box.front = 0;
-        Box.right = SrcRect.right + DeskDesc->DesktopCoordinates.left - OffsetX;
-        Box.bottom = SrcRect.bottom + DeskDesc->DesktopCoordinates.top - OffsetY;
-        Box.back = 1;
-        m_DeviceContext->CopySubresourceRegion(m_MoveSurf, 0, SrcRect.left, SrcRect.top, 0, SharedSurf, 0, &Box);
-
-        // Copy back to shared surface
-        Box.left = SrcRect.left;
-        Box.top = SrcRect.top;
-        Box.front = 0;
-        Box.right = SrcRect.right;
-        Box.bottom = SrcRect.bottom;
-        Box.back = 1;
-
-        //Adjust by desktop and destination offsets
-        DestRect.left += DeskDesc->DesktopCoordinates.left - OffsetX;
-        DestRect.top  += DeskDesc->DesktopCoordinates.top  - OffsetY;
-
-        m_DeviceContext->CopySubresourceRegion(SharedSurf, 0, DestRect.left, DestRect.top, 0, m_MoveSurf, 0, &Box);
-    
-        //Add rect to total dirty region rect
-        DPRect drect(DestRect.left, DestRect.top, (int)Box.right, (int)Box.bottom);
+        Box.left   = copy.Source.Left;
+        Box.top    = copy.Source.Top;
+        Box.front  = 0;
+        Box.right  = copy.Source.Right;
+        Box.bottom = copy.Source.Bottom;
+        Box.back   = 1;
+
+        switch (copy.Type)
+        {
+            case moveplan_copy_direct:       m_DeviceContext->CopySubresourceRegion(SharedSurf, 0, copy.DestX, copy.DestY, 0, SharedSurf,  0, &Box); break;
+            case moveplan_copy_to_scratch:   m_DeviceContext->CopySubresourceRegion(m_MoveSurf, 0, copy.DestX, copy.DestY, 0, SharedSurf,  0, &Box); break;
+            case moveplan_copy_from_scratch: m_DeviceContext->CopySubresourceRegion(SharedSurf, 0, copy.DestX, copy.DestY, 0, m_MoveSurf,  0, &Box); break;
+        }
+    }
+
+    //Add destination of each move to total dirty region rect
+    for (const MovePlanRect& dirty : m_MovePlan.DirtyRects)
+    {
+        DPRect drect(dirty.Left, dirty.Top, dirty.Right, dirty.Bottom);
         (DirtyRectTotal.GetTL().x == -1) ? DirtyRectTotal = drect : DirtyRectTotal.Add(drect);
-        
     }
 
     return DUPL_RETURN_SUCCESS;
@@ -2,6 +2,7 @@
 #define _DISPLAYMANAGER_H_
 
 #include "CommonTypes.h"
+#include "MoveRectPlanner.h"
 
 //
 // Handles the task of processing frames
@@ -29,7 +30,9 @@ class DISPLAYMANAGER
     // variables
         ID3D11Device* m_Device;
         ID3D11DeviceContext* m_DeviceContext;
-        ID3D11Texture2D* m_MoveSurf;
+        ID3D11Texture2D* m_MoveSurf;                //Scratch surface for overlapping moves, grown to the largest size planned so far
+        std::vector<MovePlanMove> m_MovePlanMoves;
+        MovePlan m_MovePlan;
         ID3D11VertexShader* m_VertexShader;
         ID3D11PixelShader* m_PixelShader;
         ID3D11InputLayout* m_InputLayout;
@@ -1,6 +1,8 @@
 #include "DuplicationManager.h"
 #include <wrl/client.h>
 
+#include "PerformanceTrace.h"
+
 //
 // Constructor sets up references / variables
 //
@@ -142,9 +144,9 @@ DUPL_RETURN DUPLICATIONMANAGER::InitDupl(_In_ ID3D11Device* Device, UINT Output,
 }
 
 //
-// Retrieves mouse info and write it into PtrInfo
+// Retrieves mouse info and publishes it to Cursor
 //
-DUPL_RETURN DUPLICATIONMANAGER::GetMouse(_Inout_ PTR_INFO* PtrInfo, _In_ DXGI_OUTDUPL_FRAME_INFO* FrameInfo, INT OffsetX, INT OffsetY)
+DUPL_RETURN DUPLICATIONMANAGER::GetMouse(_Inout_ CursorState& Cursor, _In_ DXGI_OUTDUPL_FRAME_INFO* FrameInfo, INT OffsetX, INT OffsetY)
 {
     // A non-zero mouse update timestamp indicates that there is a mouse position update and optionally a shape change
     if (FrameInfo->LastMouseUpdateTime.QuadPart == 0)
@@ -152,18 +154,22 @@ DUPL_RETURN DUPLICATIONMANAGER::GetMouse(_Inout_ PTR_INFO* PtrInfo, _In_ DXGI_OU
         return DUPL_RETURN_SUCCESS;
     }
 
+    // Published when going out of scope. Only waits on other duplication threads writing their update
+    CursorStateWriter CursorWriter(Cursor);
+    CursorStateData& PtrData = CursorWriter.GetData();
+
     bool UpdatePosition = true;
 
     // Make sure we don't update pointer position wrongly
     // If pointer is invisible, make sure we did not get an update from another output that the last time that said pointer
     // was visible, if so, don't set it to invisible or update.
-    if (!FrameInfo->PointerPosition.Visible && (PtrInfo->WhoUpdatedPositionLast != m_OutputNumber))
+    if (!FrameInfo->PointerPosition.Visible && (PtrData.WhoUpdatedPositionLast != m_OutputNumber))
     {
         UpdatePosition = false;
     }
 
     // If two outputs both say they have a visible, only update if new update has newer timestamp
-    if (FrameInfo->PointerPosition.Visible && PtrInfo->Visible && (PtrInfo->WhoUpdatedPositionLast != m_OutputNumber) && (PtrInfo->LastTimeStamp.QuadPart > FrameInfo->LastMouseUpdateTime.QuadPart))
+    if (FrameInfo->PointerPosition.Visible && PtrData.Visible && (PtrData.WhoUpdatedPositionLast != m_OutputNumber) && (PtrData.LastTimeStamp > FrameInfo->LastMouseUpdateTime.QuadPart))
     {
         UpdatePosition = false;
     }
@@ -171,59 +177,39 @@ DUPL_RETURN DUPLICATIONMANAGER::GetMouse(_Inout_ PTR_INFO* PtrInfo, _In_ DXGI_OU
     // Update position
     if (UpdatePosition)
     {
-        PtrInfo->Position.x = FrameInfo->PointerPosition.Position.x + m_OutputDesc.DesktopCoordinates.left - OffsetX;
-        PtrInfo->Position.y = FrameInfo->PointerPosition.Position.y + m_OutputDesc.DesktopCoordinates.top - OffsetY;
-        PtrInfo->WhoUpdatedPositionLast = m_OutputNumber;
-        PtrInfo->LastTimeStamp = FrameInfo->LastMouseUpdateTime;
-        PtrInfo->Visible = FrameInfo->PointerPosition.Visible != 0;
+        PtrData.PositionX = FrameInfo->PointerPosition.Position.x + m_OutputDesc.DesktopCoordinates.left - OffsetX;
+        PtrData.PositionY = FrameInfo->PointerPosition.Position.y + m_OutputDesc.DesktopCoordinates.top - OffsetY;
+        PtrData.WhoUpdatedPositionLast = m_OutputNumber;
+        PtrData.LastTimeStamp = FrameInfo->LastMouseUpdateTime.QuadPart;
+        PtrData.Visible = FrameInfo->PointerPosition.Visible != 0;
 
         //If pointer is not visible, set the hotspot to 0,0
-        if (!PtrInfo->Visible)
+        if (!PtrData.Visible)
         {
-            PtrInfo->ShapeInfo.HotSpot.x = 0;
-            PtrInfo->ShapeInfo.HotSpot.y = 0;
+            PtrData.ShapeInfo.HotSpotX = 0;
+            PtrData.ShapeInfo.HotSpotY = 0;
         }
     }
 
     // No new shape
     if (FrameInfo->PointerShapeBufferSize == 0)
     {
-        PtrInfo->CursorShapeChanged = false;
         return DUPL_RETURN_SUCCESS;
     }
 
-    PtrInfo->CursorShapeChanged = true;
-
-    // Old buffer too small
-    if (FrameInfo->PointerShapeBufferSize > PtrInfo->BufferSize)
-    {
-        if (PtrInfo->PtrShapeBuffer)
-        {
-            delete [] PtrInfo->PtrShapeBuffer;
-            PtrInfo->PtrShapeBuffer = nullptr;
-        }
-        PtrInfo->PtrShapeBuffer = new (std::nothrow) BYTE[FrameInfo->PointerShapeBufferSize];
-        if (!PtrInfo->PtrShapeBuffer)
-        {
-            PtrInfo->BufferSize = 0;
-            return ProcessFailure(nullptr, L"Failed to allocate memory for pointer shape", L"Desktop+ Error", E_OUTOFMEMORY);
-        }
-
-        // Update buffer size
-        PtrInfo->BufferSize = FrameInfo->PointerShapeBufferSize;
-    }
-
-    // Get shape
+    // Get shape, directly into the cursor state's storage which is preallocated for common sizes
+    BYTE* ShapeBuffer = CursorWriter.BeginNewShape(FrameInfo->PointerShapeBufferSize);
     UINT BufferSizeRequired;
-    HRESULT hr = m_DeskDupl->GetFramePointerShape(FrameInfo->PointerShapeBufferSize, reinterpret_cast<VOID*>(PtrInfo->PtrShapeBuffer), &BufferSizeRequired, &(PtrInfo->ShapeInfo));
+    DXGI_OUTDUPL_POINTER_SHAPE_INFO ShapeInfo;
+    HRESULT hr = m_DeskDupl->GetFramePointerShape(FrameInfo->PointerShapeBufferSize, reinterpret_cast<VOID*>(ShapeBuffer), &BufferSizeRequired, &ShapeInfo);
     if (FAILED(hr))
     {
-        delete [] PtrInfo->PtrShapeBuffer;
-        PtrInfo->PtrShapeBuffer = nullptr;
-        PtrInfo->BufferSize = 0;
+        CursorWriter.BeginNewShape(0);
         return ProcessFailure(m_Device, L"Failed to get frame pointer shape", L"Desktop+ Error", hr, FrameInfoExpectedErrors);
     }
 
+    PtrData.ShapeInfo = {ShapeInfo.Type, ShapeInfo.Width, ShapeInfo.Height, ShapeInfo.Pitch, ShapeInfo.HotSpot.x, ShapeInfo.HotSpot.y};
+
     return DUPL_RETURN_SUCCESS;
 }
 
@@ -232,13 +218,13 @@ DUPL_RETURN DUPLICATIONMANAGER::GetMouse(_Inout_ PTR_INFO* PtrInfo, _In_ DXGI_OU
 // Get next frame and write it into Data
 //
 _Success_(*Timeout == false && return == DUPL_RETURN_SUCCESS)
-DUPL_RETURN DUPLICATIONMANAGER::GetFrame(_Out_ FRAME_DATA* Data, _Out_ bool* Timeout)
+DUPL_RETURN DUPLICATIONMANAGER::GetFrame(_Out_ FRAME_DATA* Data, UINT TimeoutMS, _Out_ bool* Timeout)
 {
     IDXGIResource* DesktopResource = nullptr;
     DXGI_OUTDUPL_FRAME_INFO FrameInfo;
 
     // Get new frame
-    HRESULT hr = m_DeskDupl->AcquireNextFrame(100, &FrameInfo, &DesktopResource);
+    HRESULT hr = m_DeskDupl->AcquireNextFrame(TimeoutMS, &FrameInfo, &DesktopResource);
     if (hr == DXGI_ERROR_WAIT_TIMEOUT)
     {
         *Timeout = true;
@@ -251,6 +237,9 @@ DUPL_RETURN DUPLICATIONMANAGER::GetFrame(_Out_ FRAME_DATA* Data, _Out_ bool* Tim
         return ProcessFailure(m_Device, L"Failed to acquire next frame", L"Desktop+ Error", hr, FrameInfoExpectedErrors);
     }
 
+    //Only trace the work after the frame was acquired, the wait before would dominate the timings otherwise
+    PerformanceTraceScope trace_scope(perftrace_dupl_get_frame);
+
     // If still holding old frame, destroy it
     if (m_AcquiredDesktopImage)
     {
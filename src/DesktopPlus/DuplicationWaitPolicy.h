@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//Decides how the desktop duplication threads wait for new frames (see CaptureThreadEntry())
+//- Outputs shown by a visible overlay block in AcquireNextFrame(), with a short timeout for a moment after a state change so follow-up changes are picked up quickly
+//- With the update limiter active, frames arriving faster than the limit are left to accumulate in the duplication interface instead of being processed and skipped
+//- Outputs no overlay shows only poll for frames after an idle wait backing off exponentially, so they don't wake up for every change of the desktop
+//Idle waits end early when the visible outputs or the limiter change, or on Wake(). Kept free of Windows headers so it can be tested anywhere
+
+struct DuplicationWaitRect
+{
+    int Left;
+    int Top;
+    int Right;
+    int Bottom;
+
+    bool Overlaps(const DuplicationWaitRect& r) const { return ( (r.Top < Bottom) && (r.Bottom > Top) && (r.Left < Right) && (r.Right > Left) ); }
+    bool operator==(const DuplicationWaitRect& r) const { return ( (Left == r.Left) && (Top == r.Top) && (Right == r.Right) && (Bottom == r.Bottom) ); }
+};
+
+struct DuplicationWaitStep
+{
+    uint32_t IdleMS;                            //Time to wait before acquiring the next frame, 0 to acquire right away
+    uint32_t AcquireTimeoutMS;                  //Timeout to pass to AcquireNextFrame() after the idle wait
+};
+
+static const uint32_t g_DuplWaitAcquireTimeoutMS     = 100;    //Same as the fixed timeout used before, limits how long pause and termination can go unnoticed
+static const uint32_t g_DuplWaitAcquireTimeoutFastMS = 16;
+static const uint32_t g_DuplWaitFastDurationMS       = 500;    //Time the fast timeout is used after a state change
+static const uint32_t g_DuplWaitBackoffMinMS         = 100;
+static const uint32_t g_DuplWaitBackoffMaxMS         = 3200;
+
+//Per-thread state, only touched by the duplication thread it belongs to
+class DuplicationWaitState
+{
+    friend class DuplicationWaitPolicy;
+
+    private:
+        DuplicationWaitRect m_OutputRect;
+        uint32_t m_Generation;                  //Generation of the policy the visibility was last evaluated for
+        bool m_IsVisible;
+        bool m_IsIdleDone;                      //Idle wait for the next frame has passed, acquire next
+        uint32_t m_BackoffMS;
+        uint64_t m_FastUntilTick;
+        uint64_t m_LastFrameTick;
+
+    public:
+        DuplicationWaitState() : m_OutputRect{0, 0, 0, 0}, m_Generation(0), m_IsVisible(true), m_IsIdleDone(false), m_BackoffMS(g_DuplWaitBackoffMinMS), m_FastUntilTick(0),
+                                 m_LastFrameTick(0) {}
+
+        //Output rect in desktop coordinates, visibility is evaluated again on the next step
+        void SetOutputRect(const DuplicationWaitRect& output_rect) { m_OutputRect = output_rect; m_Generation = 0; }
+        bool IsVisible() const       { return m_IsVisible; }
+        uint32_t GetBackoffMS() const { return m_BackoffMS; }
+};
+
+//Shared by all duplication threads, updated by OutputManager
+class DuplicationWaitPolicy
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        std::vector<DuplicationWaitRect> m_VisibleRects;
+        bool m_IsAllVisible;                                //Visibility isn't known or an overlay shows the combined desktop
+        std::atomic<uint32_t> m_Generation;                 //Incremented on every change, starting at 1
+        std::atomic<uint32_t> m_LimiterIntervalMS;
+
+        std::atomic<uint64_t> m_FrameCount;
+        std::atomic<uint64_t> m_AcquireTimeoutCount;
+        std::atomic<uint64_t> m_IdleTimeoutCount;
+        std::atomic<uint64_t> m_SignaledWakeupCount;
+
+        //Called with m_Mutex held
+        void SignalChange()
+        {
+            m_Generation++;
+            m_WakeCondition.notify_all();
+        }
+
+        void UpdateState(DuplicationWaitState& state, uint64_t tick)
+        {
+            const uint32_t generation = m_Generation.load();
+
+            if (state.m_Generation == generation)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                state.m_IsVisible = m_IsAllVisible;
+
+                for (const DuplicationWaitRect& rect : m_VisibleRects)
+                {
+                    state.m_IsVisible |= rect.Overlaps(state.m_OutputRect);
+                }
+            }
+
+            state.m_Generation    = generation;
+            state.m_BackoffMS     = g_DuplWaitBackoffMinMS;
+            state.m_FastUntilTick = tick + g_DuplWaitFastDurationMS;
+            state.m_IsIdleDone    = false;
+        }
+
+        //Hidden outputs back off further after every poll
+        void OnAcquireDone(DuplicationWaitState& state)
+        {
+            if ( (state.m_IsIdleDone) && (!state.m_IsVisible) )
+            {
+                state.m_BackoffMS = std::min(state.m_BackoffMS * 2, g_DuplWaitBackoffMaxMS);
+            }
+
+            state.m_IsIdleDone = false;
+        }
+
+    public:
+        DuplicationWaitPolicy() : m_IsAllVisible(true), m_Generation(1), m_LimiterIntervalMS(0), m_FrameCount(0), m_AcquireTimeoutCount(0), m_IdleTimeoutCount(0),
+                                  m_SignaledWakeupCount(0) {}
+
+        //Sets the desktop rects shown by visible overlays. all_visible is used when every output is shown, e.g. by an overlay showing the combined desktop
+        //Returns true and wakes the threads if anything changed
+        bool SetVisibleRects(const std::vector<DuplicationWaitRect>& rects, bool all_visible)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if ( (m_IsAllVisible == all_visible) && (m_VisibleRects == rects) )
+                return false;
+
+            m_VisibleRects = rects;
+            m_IsAllVisible = all_visible;
+            SignalChange();
+
+            return true;
+        }
+
+        //0 = update limiter not active
+        bool SetLimiterInterval(uint32_t interval_ms)
+        {
+            if (m_LimiterIntervalMS.load() == interval_ms)
+                return false;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_LimiterIntervalMS = interval_ms;
+            SignalChange();
+
+            return true;
+        }
+
+        //Ends all idle waits, e.g. to have the threads check for termination
+        void Wake()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            SignalChange();
+        }
+
+        //tick is a millisecond time stamp, such as from GetTickCount64()
+        DuplicationWaitStep GetNextStep(DuplicationWaitState& state, uint64_t tick)
+        {
+            UpdateState(state, tick);
+
+            const uint32_t acquire_timeout_ms = (tick < state.m_FastUntilTick) ? g_DuplWaitAcquireTimeoutFastMS : g_DuplWaitAcquireTimeoutMS;
+
+            if (!state.m_IsVisible)
+            {
+                //Poll once after every backoff wait
+                if (state.m_IsIdleDone)
+                    return {0, 0};
+
+                return {state.m_BackoffMS, 0};
+            }
+
+            const uint64_t limiter_interval_ms = m_LimiterIntervalMS.load();
+
+            if ( (limiter_interval_ms != 0) && (!state.m_IsIdleDone) && (state.m_LastFrameTick + limiter_interval_ms > tick) )
+            {
+                return {(uint32_t)(state.m_LastFrameTick + limiter_interval_ms - tick), acquire_timeout_ms};
+            }
+
+            return {0, acquire_timeout_ms};
+        }
+
+        //Waits for up to idle_ms or until woken. Returns true if woken
+        bool WaitIdle(DuplicationWaitState& state, uint32_t idle_ms)
+        {
+            bool woken;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                woken = m_WakeCondition.wait_for(lock, std::chrono::milliseconds(idle_ms), [&](){ return (m_Generation.load() != state.m_Generation); });
+            }
+
+            if (woken)
+            {
+                m_SignaledWakeupCount++;
+            }
+            else
+            {
+                m_IdleTimeoutCount++;
+                state.m_IsIdleDone = true;
+            }
+
+            return woken;
+        }
+
+        void OnFrame(DuplicationWaitState& state, uint64_t tick)
+        {
+            m_FrameCount++;
+            OnAcquireDone(state);
+            state.m_LastFrameTick = tick;
+        }
+
+        void OnAcquireTimeout(DuplicationWaitState& state)
+        {
+            m_AcquireTimeoutCount++;
+            OnAcquireDone(state);
+        }
+
+        //Counters are totals across all threads since construction
+        uint64_t GetFrameCount()           const { return m_FrameCount.load(); }
+        uint64_t GetAcquireTimeoutCount()  const { return m_AcquireTimeoutCount.load(); }
+        uint64_t GetIdleTimeoutCount()     const { return m_IdleTimeoutCount.load(); }
+        uint64_t GetSignaledWakeupCount()  const { return m_SignaledWakeupCount.load(); }
+        //Every time a thread returned from waiting, whether for a frame, a timeout or a wake signal
+        uint64_t GetWakeupCount() const { return GetFrameCount() + GetAcquireTimeoutCount() + GetIdleTimeoutCount() + GetSignaledWakeupCount(); }
+};
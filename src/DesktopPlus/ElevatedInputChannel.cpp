@@ -0,0 +1,174 @@
+#include "ElevatedInputChannel.h"
+
+static LPCWSTR const g_ElevatedInputRingName      = L"DesktopPlusElevatedInputRing";
+static LPCWSTR const g_ElevatedInputDoorbellName  = L"DesktopPlusElevatedInputDoorbell";
+
+ElevatedInputChannel::ElevatedInputChannel() : m_FileMapping(nullptr), m_DoorbellEvent(nullptr), m_Ring(nullptr), m_HasPendingMouseMove(false), m_PendingMouseMove(0)
+{
+}
+
+ElevatedInputChannel::~ElevatedInputChannel()
+{
+    Close();
+}
+
+bool ElevatedInputChannel::MapRing()
+{
+    if ( (m_FileMapping != nullptr) && (m_DoorbellEvent != nullptr) )
+    {
+        m_Ring = (ElevatedInputRing*)::MapViewOfFile(m_FileMapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(ElevatedInputRing));
+    }
+
+    if (m_Ring == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool ElevatedInputChannel::TryPush(IPCElevatedActionID action_id, LPARAM lparam)
+{
+    ElevatedInputEvent input_events[2] = {0};
+    uint32_t event_count = 0;
+
+    if (m_HasPendingMouseMove)
+    {
+        input_events[0].ActionID = ipceact_mouse_move;
+        input_events[0].Value    = m_PendingMouseMove;
+        event_count++;
+    }
+
+    input_events[event_count].ActionID = action_id;
+    input_events[event_count].Value    = lparam;
+    event_count++;
+
+    bool needs_doorbell = false;
+    if (!m_Ring->Push(input_events, event_count, needs_doorbell))
+        return false;
+
+    m_HasPendingMouseMove = false;
+
+    if (needs_doorbell)
+    {
+        ::SetEvent(m_DoorbellEvent);
+    }
+
+    return true;
+}
+
+void ElevatedInputChannel::PostFallback(IPCElevatedActionID action_id, LPARAM lparam)
+{
+    //The elevated mode process drains the ring before handling each message, so this can't overtake anything already pushed
+    if (m_HasPendingMouseMove)
+    {
+        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_mouse_move, m_PendingMouseMove);
+        m_Ring->OnFallbackPosted();
+        m_HasPendingMouseMove = false;
+    }
+
+    IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, action_id, lparam);
+    m_Ring->OnFallbackPosted();
+}
+
+bool ElevatedInputChannel::Create()
+{
+    Close();
+
+    //Pagefile-backed memory is zero-initialized, which is a valid empty ring
+    m_FileMapping   = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(ElevatedInputRing), g_ElevatedInputRingName);
+    m_DoorbellEvent = ::CreateEventW(nullptr, FALSE, FALSE, g_ElevatedInputDoorbellName);
+
+    return MapRing();
+}
+
+bool ElevatedInputChannel::Open()
+{
+    Close();
+
+    m_FileMapping   = ::OpenFileMappingW(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, g_ElevatedInputRingName);
+    m_DoorbellEvent = ::OpenEventW(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, g_ElevatedInputDoorbellName);
+
+    return MapRing();
+}
+
+void ElevatedInputChannel::Close()
+{
+    if (m_Ring != nullptr)
+    {
+        ::UnmapViewOfFile(m_Ring);
+        m_Ring = nullptr;
+    }
+
+    if (m_FileMapping != nullptr)
+    {
+        ::CloseHandle(m_FileMapping);
+        m_FileMapping = nullptr;
+    }
+
+    if (m_DoorbellEvent != nullptr)
+    {
+        ::CloseHandle(m_DoorbellEvent);
+        m_DoorbellEvent = nullptr;
+    }
+
+    m_HasPendingMouseMove = false;
+}
+
+bool ElevatedInputChannel::IsOpen() const
+{
+    return (m_Ring != nullptr);
+}
+
+bool ElevatedInputChannel::PushEvent(IPCElevatedActionID action_id, LPARAM lparam)
+{
+    if (m_Ring == nullptr)
+        return false;
+
+    //A newer mouse movement supersedes the pending one
+    if (action_id == ipceact_mouse_move)
+    {
+        m_HasPendingMouseMove = false;
+    }
+
+    //Keep using window messages until the elevated mode process has handled all of them, or ring events could overtake them
+    if (m_Ring->IsFallbackPending())
+    {
+        PostFallback(action_id, lparam);
+        return true;
+    }
+
+    if (TryPush(action_id, lparam))
+        return true;
+
+    //Ring is full. Mouse movements are only needed for the latest position, so keep it around for the next event instead of waiting
+    if (action_id == ipceact_mouse_move)
+    {
+        m_HasPendingMouseMove = true;
+        m_PendingMouseMove    = lparam;
+        return true;
+    }
+
+    //Anything else, key-ups in particular, must arrive. Give the elevated mode process a moment to catch up before falling back to a message
+    for (int i = 0; i < FullWaitMaxMilliseconds; ++i)
+    {
+        ::Sleep(1);
+
+        if (TryPush(action_id, lparam))
+            return true;
+    }
+
+    PostFallback(action_id, lparam);
+    return true;
+}
+
+ElevatedInputRing* ElevatedInputChannel::GetRing() const
+{
+    return m_Ring;
+}
+
+HANDLE ElevatedInputChannel::GetDoorbellEvent() const
+{
+    return m_DoorbellEvent;
+}
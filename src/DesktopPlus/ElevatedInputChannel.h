@@ -0,0 +1,42 @@
+#pragma once
+
+#define NOMINMAX
+#include <windows.h>
+
+#include "InterprocessMessaging.h"
+#include "ElevatedInputRing.h"
+
+//Shared memory ElevatedInputRing and doorbell event for forwarding input to the elevated mode process without flooding its message queue
+//Created by the dashboard process so the objects don't end up with a high integrity level, opened by the elevated mode process
+//
+//Nothing pushed is ever dropped, except mouse movements superseded by newer ones. When the ring is full, mouse movements are coalesced into one
+//that is sent ahead of the next event. Other events wait briefly for the consumer to make room and are sent as window messages if it doesn't
+class ElevatedInputChannel
+{
+    private:
+        HANDLE m_FileMapping;
+        HANDLE m_DoorbellEvent;
+        ElevatedInputRing* m_Ring;
+        bool m_HasPendingMouseMove;
+        LPARAM m_PendingMouseMove;
+
+        bool MapRing();
+        bool TryPush(IPCElevatedActionID action_id, LPARAM lparam);     //Sends the pending mouse movement first if there is one
+        void PostFallback(IPCElevatedActionID action_id, LPARAM lparam);
+
+    public:
+        static const int FullWaitMaxMilliseconds = 10;
+
+        ElevatedInputChannel();
+        ~ElevatedInputChannel();
+
+        bool Create();
+        bool Open();
+        void Close();
+        bool IsOpen() const;
+
+        //Returns false if the channel isn't open, in which case the event wasn't sent
+        bool PushEvent(IPCElevatedActionID action_id, LPARAM lparam);
+        ElevatedInputRing* GetRing() const;
+        HANDLE GetDoorbellEvent() const;
+};
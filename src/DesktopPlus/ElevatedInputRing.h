@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//Single-producer/single-consumer ring of input events sent from the dashboard process to the elevated mode process
+//The ring lives in shared memory, so it has no constructor and relies on the memory being zero-initialized, which is an empty ring
+//Indices are free-running and only wrap on the uint32 boundary, which is why the capacity needs to be a power of two
+//Kept free of Windows headers so it can be used and tested anywhere. Mapping the memory and waiting on the doorbell event is up to the caller (see ElevatedInputChannel)
+//
+//When the ring is full, the producer can fall back to sending events as window messages, which the consumer handles after draining the ring.
+//The fallback counters track those messages so the producer only switches back to the ring once the consumer has handled all of them, keeping the order
+
+struct ElevatedInputEvent
+{
+    uint32_t ActionID;      //IPCElevatedActionID
+    uint32_t Padding;
+    int64_t Value;          //Same value as the lParam of the matching ipcmsg_elevated_action message
+};
+
+class ElevatedInputRing
+{
+    public:
+        static const uint32_t Capacity = 1024;
+
+    private:
+        //Indices on separate cache lines as they're written by different processes
+        alignas(64) std::atomic<uint32_t> m_WriteIndex;
+        std::atomic<uint32_t> m_FallbackPostedCount;
+        alignas(64) std::atomic<uint32_t> m_ReadIndex;
+        std::atomic<uint32_t> m_FallbackHandledCount;
+        alignas(64) ElevatedInputEvent m_Events[Capacity];
+
+        static_assert((Capacity & (Capacity - 1)) == 0, "ElevatedInputRing::Capacity must be a power of two");
+
+    public:
+        //- Producer
+        //Adds all events or none if there's not enough space.
+        //Sets needs_doorbell if the consumer may have seen the ring as empty before and has to be woken up
+        bool Push(const ElevatedInputEvent* events, uint32_t count, bool& needs_doorbell)
+        {
+            const uint32_t write_index = m_WriteIndex.load(std::memory_order_relaxed);
+            const uint32_t read_index  = m_ReadIndex.load(std::memory_order_acquire);
+
+            needs_doorbell = false;
+
+            if (Capacity - (write_index - read_index) < count)
+                return false;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                m_Events[(write_index + i) & (Capacity - 1)] = events[i];
+            }
+
+            //Publishing the write index and checking the read index afterwards is paired with the same in the opposite order in Pop()
+            //Both sequentially consistent, so at least one side is guaranteed to see the other's update and no wake-up is lost
+            m_WriteIndex.store(write_index + count, std::memory_order_seq_cst);
+            needs_doorbell = (m_ReadIndex.load(std::memory_order_seq_cst) == write_index);
+
+            return true;
+        }
+
+        //Call after an event was sent as a window message instead
+        void OnFallbackPosted()
+        {
+            m_FallbackPostedCount.fetch_add(1, std::memory_order_release);
+        }
+
+        //Returns true while the consumer hasn't handled all events sent as window messages. New events have to be sent the same way until then
+        bool IsFallbackPending() const
+        {
+            return ((int32_t)(m_FallbackPostedCount.load(std::memory_order_relaxed) - m_FallbackHandledCount.load(std::memory_order_acquire)) > 0);
+        }
+
+        //- Consumer
+        //Returns the number of events copied to events_out. The ring is empty once this returns 0, at which point the consumer can wait for the doorbell
+        uint32_t Pop(ElevatedInputEvent* events_out, uint32_t max_count)
+        {
+            const uint32_t read_index  = m_ReadIndex.load(std::memory_order_relaxed);
+            const uint32_t write_index = m_WriteIndex.load(std::memory_order_seq_cst);
+
+            uint32_t count = write_index - read_index;
+
+            //Protect against garbage from a misbehaving producer
+            if (count > Capacity)
+            {
+                m_ReadIndex.store(write_index, std::memory_order_seq_cst);
+                return 0;
+            }
+
+            if (count > max_count)
+            {
+                count = max_count;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                events_out[i] = m_Events[(read_index + i) & (Capacity - 1)];
+            }
+
+            if (count != 0)
+            {
+                m_ReadIndex.store(read_index + count, std::memory_order_seq_cst);
+            }
+
+            return count;
+        }
+
+        //Call after handling an event that was received as a window message
+        void OnFallbackHandled()
+        {
+            m_FallbackHandledCount.fetch_add(1, std::memory_order_release);
+        }
+
+        //Drops all pending events. Called by the consumer on startup, since events might be left over from a previous consumer process
+        void DiscardPending()
+        {
+            m_FallbackHandledCount.store(m_FallbackPostedCount.load(std::memory_order_acquire), std::memory_order_release);
+            m_ReadIndex.store(m_WriteIndex.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        }
+};
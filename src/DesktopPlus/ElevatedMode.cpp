@@ -3,13 +3,24 @@
 #include <windowsx.h>
 
 #include "InterprocessMessaging.h"
+#include "ElevatedInputChannel.h"
 #include "InputSimulator.h"
 #include "Util.h"
 
 static bool g_ElevatedMode_ComInitDone = false;
+static ElevatedInputChannel g_ElevatedMode_InputChannel;
 
 LRESULT CALLBACK WndProcElevated(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 bool HandleIPCMessage(MSG msg);
+void HandleQueuedIPCMessage(MSG msg);
+void HandleInputChannelEvents();
+
+static InputSimulator& GetElevatedModeInputSimulator()
+{
+    //Function-local so it's only constructed when actually running in elevated mode
+    static InputSimulator input_sim;
+    return input_sim;
+}
 
 int ElevatedModeEnter(HINSTANCE hinstance)
 {
@@ -51,21 +62,45 @@ int ElevatedModeEnter(HINSTANCE hinstance)
     //Allow IPC messages even when elevated
     IPCManager::Get().DisableUIPForRegisteredMessages(window_handle);
 
+    //Open input channel created by the dashboard app. Input is only received as window messages if this fails
+    if (g_ElevatedMode_InputChannel.Open())
+    {
+        g_ElevatedMode_InputChannel.GetRing()->DiscardPending();
+    }
+
     //Send config update to dashboard and UI process to set elevated mode active
     IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_state_misc_elevated_mode_active), true);
     IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_state_misc_elevated_mode_active), true);
 
-	//Wait for callbacks, update or quit message
+	//Wait for input channel events, callbacks, update or quit message
 	MSG msg;
-	while (::GetMessage(&msg, 0, 0, 0))
+    HANDLE doorbell_event = g_ElevatedMode_InputChannel.GetDoorbellEvent();
+    bool do_quit = false;
+
+	while (!do_quit)
 	{
-        //Custom IPC messages
-        if (msg.message >= 0xC000)
+        ::MsgWaitForMultipleObjects((doorbell_event != nullptr) ? 1 : 0, &doorbell_event, FALSE, INFINITE, QS_ALLINPUT);
+
+        HandleInputChannelEvents();
+
+        while (::PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
         {
-            HandleIPCMessage(msg);
+            if (msg.message == WM_QUIT)
+            {
+                do_quit = true;
+                break;
+            }
+
+            //Custom IPC messages
+            if (msg.message >= 0xC000)
+            {
+                HandleQueuedIPCMessage(msg);
+            }
         }
 	}
 
+    g_ElevatedMode_InputChannel.Close();
+
     //Send config update to dashboard and UI process to disable it again
     IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_state_misc_elevated_mode_active), false);
     IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_state_misc_elevated_mode_active), false);
@@ -87,10 +122,12 @@ LRESULT CALLBACK WndProcElevated(HWND hWnd, UINT message, WPARAM wParam, LPARAM
         case WM_COPYDATA:
         {
             MSG msg;
-            // Process all custom window messages posted before this
+            // Process all input channel events and custom window messages posted before this
+            HandleInputChannelEvents();
+
             while (::PeekMessage(&msg, nullptr, 0xC000, 0xFFFF, PM_REMOVE))
             {
-                HandleIPCMessage(msg);
+                HandleQueuedIPCMessage(msg);
             }
 
             msg.hwnd = hWnd;
@@ -115,7 +152,7 @@ LRESULT CALLBACK WndProcElevated(HWND hWnd, UINT message, WPARAM wParam, LPARAM
 
 bool HandleIPCMessage(MSG msg)
 {
-    static InputSimulator input_sim;
+    InputSimulator& input_sim = GetElevatedModeInputSimulator();
 
     static std::string action_exe_path;
     static std::string action_exe_arg;
@@ -254,3 +291,65 @@ bool HandleIPCMessage(MSG msg)
 
     return true;
 }
+
+void HandleQueuedIPCMessage(MSG msg)
+{
+    //Input channel events are always queued before messages sent after them, so handle those first to keep the order
+    HandleInputChannelEvents();
+    HandleIPCMessage(msg);
+
+    //Let the dashboard app know when it can switch back to the input channel after falling back to messages
+    ElevatedInputRing* ring = g_ElevatedMode_InputChannel.GetRing();
+
+    if ( (ring != nullptr) && (msg.message == IPCManager::Get().GetWin32MessageID(ipcmsg_elevated_action)) )
+    {
+        ring->OnFallbackHandled();
+    }
+}
+
+void HandleInputChannelEvents()
+{
+    ElevatedInputRing* ring = g_ElevatedMode_InputChannel.GetRing();
+
+    if (ring == nullptr)
+        return;
+
+    static std::vector<POINT> mouse_positions;
+    ElevatedInputEvent events[64];
+    uint32_t event_count;
+
+    while ((event_count = ring->Pop(events, 64)) != 0)
+    {
+        for (uint32_t i = 0; i < event_count; ++i)
+        {
+            const LPARAM lparam = (LPARAM)events[i].Value;
+
+            //Collect consecutive mouse movements and submit them together, everything else goes down the same path as the window messages
+            if (events[i].ActionID == ipceact_mouse_move)
+            {
+                mouse_positions.push_back({GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)});
+                continue;
+            }
+
+            if (!mouse_positions.empty())
+            {
+                GetElevatedModeInputSimulator().MouseMove(mouse_positions.data(), mouse_positions.size());
+                mouse_positions.clear();
+            }
+
+            MSG msg  = {0};
+            msg.message = IPCManager::Get().GetWin32MessageID(ipcmsg_elevated_action);
+            msg.wParam  = events[i].ActionID;
+            msg.lParam  = lparam;
+
+            HandleIPCMessage(msg);
+        }
+    }
+
+    if (!mouse_positions.empty())
+    {
+        GetElevatedModeInputSimulator().MouseMove(mouse_positions.data(), mouse_positions.size());
+        mouse_positions.clear();
+    }
+}
+
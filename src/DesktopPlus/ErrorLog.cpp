@@ -0,0 +1,240 @@
+#include "ErrorLog.h"
+
+#include <ctime>
+#include <cstdio>
+#include <sstream>
+
+#define ERROR_LOG_FILE_NAME     "error.log"
+#define ERROR_LOG_MAX_FILE_SIZE (1024 * 1024)
+#define ERROR_LOG_BACKUP_COUNT  2
+#define ERROR_LOG_WRITER_INTERVAL 1000  //Max time between writer wake-ups, for writing out rate limiter reports
+
+static ErrorLog g_ErrorLog;
+
+ErrorLog& ErrorLog::Get()
+{
+    return g_ErrorLog;
+}
+
+ErrorLog::ErrorLog() : m_MinSeverity(log_severity_info),
+                       m_IsWriterWaiting(false),
+                       m_FileWriter(ERROR_LOG_FILE_NAME, ERROR_LOG_MAX_FILE_SIZE, ERROR_LOG_BACKUP_COUNT),
+                       m_DroppedCountWritten(0),
+                       m_ThreadHandle(nullptr),
+                       m_PrevExceptionFilter(nullptr)
+{
+    m_WakeEvent = ::CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_StopEvent = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+}
+
+ErrorLog::~ErrorLog()
+{
+    Stop();
+
+    if (m_WakeEvent != nullptr)
+    {
+        ::CloseHandle(m_WakeEvent);
+    }
+
+    if (m_StopEvent != nullptr)
+    {
+        ::CloseHandle(m_StopEvent);
+    }
+}
+
+void ErrorLog::Drain(bool is_final)
+{
+    //Report messages suppressed by the rate limiter once their window ended, or all of them if nothing is written after this
+    const int64_t time_now = std::time(nullptr);
+    m_RateLimiter.Expire((is_final) ? INT64_MAX : time_now, [&](LogSeverity severity, const std::wstring& text, uint32_t suppressed_count)
+                         {
+                             std::wstringstream ss;
+                             ss << L"Previous message repeated " << suppressed_count << L" more times: " << text;
+                             m_FileWriter.Write(severity, time_now, ss.str().c_str());
+                         });
+
+    bool has_written = false;
+
+    while (m_Queue.Pop(m_PopEntry))
+    {
+        if (m_RateLimiter.Check(m_PopEntry))
+        {
+            m_FileWriter.Write(m_PopEntry.Severity, m_PopEntry.Time, m_PopEntry.Text);
+            has_written = true;
+        }
+    }
+
+    const uint64_t dropped_count = m_Queue.GetDroppedCount();
+    if (dropped_count != m_DroppedCountWritten)
+    {
+        std::wstringstream ss;
+        ss << (dropped_count - m_DroppedCountWritten) << L" messages were dropped due to the log queue being full";
+        m_FileWriter.Write(log_severity_warning, time_now, ss.str().c_str());
+
+        m_DroppedCountWritten = dropped_count;
+        has_written = true;
+    }
+
+    //Don't keep the file open between writes, so it can be rotated or written by another instance
+    if ( (has_written) || (is_final) )
+    {
+        m_FileWriter.Close();
+    }
+}
+
+void ErrorLog::DrainCrash()
+{
+    //Shared with the writer in case it crashed while having the file open
+    HANDLE file = ::CreateFileA(ERROR_LOG_FILE_NAME, FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    //Same format as LogFileWriter::Write(), in the local encoding as well
+    char line[(LogEntry::MaxLength * 4) + 64];
+
+    while (m_Queue.Pop(m_PopEntry))
+    {
+        //std::time_t to FILETIME, which counts 100ns intervals since 1601
+        ULARGE_INTEGER time_utc;
+        time_utc.QuadPart = ((uint64_t)m_PopEntry.Time * 10000000ULL) + 116444736000000000ULL;
+
+        FILETIME filetime_utc = {time_utc.LowPart, time_utc.HighPart}, filetime_local;
+        SYSTEMTIME systime = {};
+        ::FileTimeToLocalFileTime(&filetime_utc, &filetime_local);
+        ::FileTimeToSystemTime(&filetime_local, &systime);
+
+        const char* prefix = "";
+        switch (m_PopEntry.Severity)
+        {
+            case log_severity_debug:   prefix = "Debug: ";   break;
+            case log_severity_info:    prefix = "Info: ";    break;
+            case log_severity_warning: prefix = "Warning: "; break;
+            default: break;
+        }
+
+        int length = _snprintf_s(line, _TRUNCATE, "[%04u-%02u-%02u %02u:%02u] %s", systime.wYear, systime.wMonth, systime.wDay, systime.wHour, systime.wMinute, prefix);
+        length = std::max(length, 0);
+        length += std::max(::WideCharToMultiByte(CP_ACP, 0, m_PopEntry.Text, (int)m_PopEntry.Length, line + length, (int)sizeof(line) - length - 1, nullptr, nullptr), 0);
+        line[length++] = '\n';
+
+        DWORD bytes_written = 0;
+        ::WriteFile(file, line, (DWORD)length, &bytes_written, nullptr);
+    }
+
+    ::CloseHandle(file);
+}
+
+DWORD WINAPI ErrorLog::WriterThreadEntry(void* param)
+{
+    ErrorLog& log = *(ErrorLog*)param;
+    const HANDLE handles[2] = {log.m_StopEvent, log.m_WakeEvent};
+
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(log.m_ConsumerMutex);
+            log.Drain(false);
+        }
+
+        //Producers only signal the wake event while this is set. Checking the queue after setting it makes sure no message is missed
+        log.m_IsWriterWaiting.store(true);
+
+        bool has_pending;
+        {
+            std::lock_guard<std::mutex> lock(log.m_ConsumerMutex);
+            has_pending = log.m_Queue.HasPending();
+        }
+
+        if (has_pending)
+        {
+            log.m_IsWriterWaiting.store(false);
+            continue;
+        }
+
+        if (::WaitForMultipleObjects(2, handles, FALSE, ERROR_LOG_WRITER_INTERVAL) == WAIT_OBJECT_0)
+            break;
+    }
+
+    return 0;
+}
+
+LONG WINAPI ErrorLog::UnhandledExceptionFilter(EXCEPTION_POINTERS* exception_info)
+{
+    ErrorLog& log = Get();
+
+    //The heap may be what's broken, so nothing on this path allocates
+    //The message is formatted on the stack and queued, then everything queued is written with DrainCrash() instead of the rate limiter and LogFileWriter
+    wchar_t message[128];
+    swprintf_s(message, L"Unhandled exception 0x%08X at address 0x%p", (unsigned int)exception_info->ExceptionRecord->ExceptionCode, exception_info->ExceptionRecord->ExceptionAddress);
+    log.Write(log_severity_error, message);
+
+    //The writer thread may be in the middle of writing, but don't wait forever in case it crashed while holding the lock
+    for (int i = 0; i < 100; ++i)
+    {
+        if (log.m_ConsumerMutex.try_lock())
+        {
+            log.DrainCrash();
+            log.m_ConsumerMutex.unlock();
+            break;
+        }
+
+        ::Sleep(5);
+    }
+
+    return (log.m_PrevExceptionFilter != nullptr) ? log.m_PrevExceptionFilter(exception_info) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+void ErrorLog::Start()
+{
+    if ( (m_ThreadHandle != nullptr) || (m_WakeEvent == nullptr) || (m_StopEvent == nullptr) )
+        return;
+
+    ::ResetEvent(m_StopEvent);
+    m_ThreadHandle = ::CreateThread(nullptr, 0, WriterThreadEntry, this, 0, nullptr);
+
+    m_PrevExceptionFilter = ::SetUnhandledExceptionFilter(UnhandledExceptionFilter);
+}
+
+void ErrorLog::Stop()
+{
+    if (m_ThreadHandle != nullptr)
+    {
+        ::SetUnhandledExceptionFilter(m_PrevExceptionFilter);
+        m_PrevExceptionFilter = nullptr;
+
+        ::SetEvent(m_StopEvent);
+        ::WaitForSingleObject(m_ThreadHandle, INFINITE);
+        ::CloseHandle(m_ThreadHandle);
+        m_ThreadHandle = nullptr;
+        m_IsWriterWaiting.store(false);
+    }
+
+    std::lock_guard<std::mutex> lock(m_ConsumerMutex);
+    Drain(true);
+}
+
+void ErrorLog::SetMinSeverity(LogSeverity severity)
+{
+    m_MinSeverity.store(severity);
+}
+
+void ErrorLog::Write(LogSeverity severity, LPCWSTR str)
+{
+    if (severity < m_MinSeverity.load(std::memory_order_relaxed))
+        return;
+
+    m_Queue.Push(severity, std::time(nullptr), str);
+
+    //Only signal if the writer is waiting, so bursts of messages don't each cost a system call
+    if ( (m_IsWriterWaiting.load()) && (m_IsWriterWaiting.exchange(false)) )
+    {
+        ::SetEvent(m_WakeEvent);
+    }
+}
+
+void ErrorLog::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_ConsumerMutex);
+    Drain(false);
+}
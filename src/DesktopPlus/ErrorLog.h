@@ -0,0 +1,65 @@
+#pragma once
+
+#define NOMINMAX
+#include <windows.h>
+
+#include <atomic>
+#include <mutex>
+
+#include "LogQueue.h"
+
+//Writes error.log on a background thread so logging threads never wait on the disk (e.g. duplication threads hitting a burst of errors during display mode changes)
+//Messages are queued by Write() from any thread and written by the writer thread, rate limited and with the file rotated once it gets too large
+//Messages queued while the writer thread isn't running are written by Flush() or Stop(). When the process crashes, they're written without allocating by DrainCrash()
+class ErrorLog
+{
+    private:
+        LogQueue m_Queue;
+        std::atomic<int> m_MinSeverity;
+        std::atomic<bool> m_IsWriterWaiting;
+
+        //- Only accessed by the consumer, which is whoever holds m_ConsumerMutex
+        std::mutex m_ConsumerMutex;
+        LogRateLimiter m_RateLimiter;
+        LogFileWriter m_FileWriter;
+        uint64_t m_DroppedCountWritten;
+        LogEntry m_PopEntry;
+
+        //- Only accessed in the thread calling Start() and Stop()
+        HANDLE m_ThreadHandle;
+        HANDLE m_WakeEvent;
+        HANDLE m_StopEvent;
+        LPTOP_LEVEL_EXCEPTION_FILTER m_PrevExceptionFilter;
+
+        void Drain(bool is_final);
+        void DrainCrash();                  //Writes the queued entries straight to the file with Win32 calls only. Skips rate limiting and rotation
+        static DWORD WINAPI WriterThreadEntry(void* param);
+        static LONG WINAPI UnhandledExceptionFilter(EXCEPTION_POINTERS* exception_info);
+
+    public:
+        static ErrorLog& Get();
+        ErrorLog();
+        ~ErrorLog();
+
+        //Starts the writer thread and installs the crash hook
+        void Start();
+        //Writes everything still queued and stops the writer thread
+        void Stop();
+
+        //Messages below the minimum severity are ignored. Default is log_severity_info
+        void SetMinSeverity(LogSeverity severity);
+        void Write(LogSeverity severity, LPCWSTR str);
+        //Writes everything queued on the calling thread
+        void Flush();
+};
+
+//Calls ErrorLog::Start() on construction and ErrorLog::Stop() on destruction, so every return path stops the writer thread
+class ErrorLogScope
+{
+    public:
+        ErrorLogScope()  { ErrorLog::Get().Start(); }
+        ~ErrorLogScope() { ErrorLog::Get().Stop(); }
+
+        ErrorLogScope(const ErrorLogScope&) = delete;
+        ErrorLogScope& operator=(const ErrorLogScope&) = delete;
+};
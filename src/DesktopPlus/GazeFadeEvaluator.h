@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "MatricesSIMD.h"   //For DPLUS_MATH_SSE2
+
+//Computes the Gaze Fade opacity of all overlays using it in one pass against a single HMD pose (see OutputManager::DetachedOverlayGazeFadeAll())
+//Overlay data is stored in one array per value, which is evaluated 4 overlays at a time with SSE2 and one at a time for the rest
+//The SSE2 path does the same operations in the same order as the scalar one, so results are the same no matter how many overlays are evaluated together
+//Kept free of Windows and OpenVR headers so it can be tested anywhere
+
+struct GazeFadeOverlay
+{
+    unsigned int OverlayID;
+    float PosX;                             //Overlay position in tracking space
+    float PosY;
+    float PosZ;
+    float GazeDistance;                     //configid_float_overlay_gazefade_distance, 0 for auto
+    float FadeRate;                         //configid_float_overlay_gazefade_rate
+    float OpacityMax;                       //configid_float_overlay_opacity
+    float OpacityMin;                       //configid_float_overlay_gazefade_opacity
+    float OpacityCurrent;
+    bool IsHovered;                         //Overlay or the Floating UI targeting it is being pointed at
+};
+
+struct GazeFadeHMDPose
+{
+    float PosX;
+    float PosY;
+    float PosZ;
+    float AxisZX;                           //Z axis of the HMD rotation, pointing backwards from the view direction
+    float AxisZY;
+    float AxisZZ;
+};
+
+struct GazeFadeResult
+{
+    unsigned int OverlayID;
+    float Opacity;
+};
+
+class GazeFadeEvaluator
+{
+    private:
+        std::vector<unsigned int> m_OverlayID;
+        std::vector<float> m_PosX;
+        std::vector<float> m_PosY;
+        std::vector<float> m_PosZ;
+        std::vector<float> m_GazeDistance;
+        std::vector<float> m_FadeRate;
+        std::vector<float> m_OpacityMax;
+        std::vector<float> m_OpacityMin;
+        std::vector<float> m_OpacityCurrent;
+        std::vector<float> m_OpacityNew;
+        std::vector<uint8_t> m_IsHovered;
+
+    public:
+        //Removes all overlays, keeping the allocations
+        void Clear()
+        {
+            m_OverlayID.clear();
+            m_PosX.clear();
+            m_PosY.clear();
+            m_PosZ.clear();
+            m_GazeDistance.clear();
+            m_FadeRate.clear();
+            m_OpacityMax.clear();
+            m_OpacityMin.clear();
+            m_OpacityCurrent.clear();
+            m_IsHovered.clear();
+        }
+
+        void Add(const GazeFadeOverlay& overlay)
+        {
+            m_OverlayID.push_back(overlay.OverlayID);
+            m_PosX.push_back(overlay.PosX);
+            m_PosY.push_back(overlay.PosY);
+            m_PosZ.push_back(overlay.PosZ);
+            m_GazeDistance.push_back(overlay.GazeDistance);
+            m_FadeRate.push_back(overlay.FadeRate);
+            m_OpacityMax.push_back(overlay.OpacityMax);
+            m_OpacityMin.push_back(overlay.OpacityMin);
+            m_OpacityCurrent.push_back(overlay.OpacityCurrent);
+            m_IsHovered.push_back(overlay.IsHovered);
+        }
+
+        size_t GetOverlayCount() const { return m_OverlayID.size(); }
+
+        //Replaces the contents of results_out with the overlays whose opacity changed, in the order they were added
+        void Evaluate(const GazeFadeHMDPose& hmd_pose, std::vector<GazeFadeResult>& results_out)
+        {
+            const size_t count = m_OverlayID.size();
+            m_OpacityNew.resize(count);
+
+            size_t i = 0;
+
+            #ifdef DPLUS_MATH_SSE2
+                for (; i + 4 <= count; i += 4)
+                {
+                    EvaluateSSE2(hmd_pose, i);
+                }
+            #endif
+
+            for (; i < count; ++i)
+            {
+                EvaluateScalar(hmd_pose, i);
+            }
+
+            //Every overlay is written, but only kept if it changed
+            results_out.resize(count);
+            size_t changed_count = 0;
+
+            for (i = 0; i < count; ++i)
+            {
+                results_out[changed_count] = {m_OverlayID[i], m_OpacityNew[i]};
+                changed_count += (m_OpacityNew[i] != m_OpacityCurrent[i]);
+            }
+
+            results_out.resize(changed_count);
+        }
+
+    private:
+        void EvaluateScalar(const GazeFadeHMDPose& hmd_pose, size_t i)
+        {
+            //Distance the gaze point is offset from HMD. Auto distance (0) matches the distance between HMD and overlay
+            //Useful range of the setting starts at ~0.20 - 0.25 (lower is in HMD or culled away), so it's offset by that
+            float gaze_distance = m_GazeDistance[i];
+
+            if (gaze_distance == 0.0f)
+            {
+                const float hmd_dx = hmd_pose.PosX - m_PosX[i];
+                const float hmd_dy = hmd_pose.PosY - m_PosY[i];
+                const float hmd_dz = hmd_pose.PosZ - m_PosZ[i];
+                gaze_distance = sqrtf(hmd_dx * hmd_dx + hmd_dy * hmd_dy + hmd_dz * hmd_dz);
+            }
+            else
+            {
+                gaze_distance += 0.20f;
+            }
+
+            const float gaze_dx = (hmd_pose.PosX + (-gaze_distance * hmd_pose.AxisZX)) - m_PosX[i];
+            const float gaze_dy = (hmd_pose.PosY + (-gaze_distance * hmd_pose.AxisZY)) - m_PosY[i];
+            const float gaze_dz = (hmd_pose.PosZ + (-gaze_distance * hmd_pose.AxisZZ)) - m_PosZ[i];
+            const float distance = sqrtf(gaze_dx * gaze_dx + gaze_dy * gaze_dy + gaze_dz * gaze_dz);
+
+            gaze_distance = std::min(gaze_distance, 1.0f); //To get useful fading past 1m distance we'll have to limit the value to 1m here for the math below
+
+            //There's nothing smart behind this, just trial and error
+            float alpha = std::max(0.0f, std::min((distance * -(m_FadeRate[i] * 10.0f)) + ((gaze_distance - 0.1f) * 10.0f), 1.0f));
+
+            const float opacity_max = m_OpacityMax[i];
+            const float opacity_min = m_OpacityMin[i];
+
+            if (m_IsHovered[i] != 0) //Take whatever's more visible as the user probably wants to be able to see the overlay
+            {
+                alpha = std::max(opacity_min, opacity_max);
+            }
+            else //Adapt alpha result from a 0.0 - 1.0 range to gazefade_opacity - overlay_opacity and invert if necessary
+            {
+                const float range_length = opacity_max - opacity_min;
+
+                if (range_length >= 0.0f)
+                {
+                    alpha = (alpha * range_length) + opacity_min;
+                }
+                else //Gaze Fade target opacity higher than overlay opcacity, invert behavior
+                {
+                    alpha = ((alpha - 1.0f) * range_length) + opacity_max;
+                }
+            }
+
+            //Limit alpha change per frame to smooth out things when abrupt changes happen (i.e. overlay capture took a bit to re-enable or laser pointer forces full alpha)
+            const float diff = alpha - m_OpacityCurrent[i];
+            m_OpacityNew[i] = m_OpacityCurrent[i] + std::max(-0.1f, std::min(diff, 0.1f));
+        }
+
+    #ifdef DPLUS_MATH_SSE2
+        //Same as EvaluateScalar() for overlays i to i + 3, with branches done as selects
+        //std::min(a, b) is _mm_min_ps(b, a) and std::max(a, b) is _mm_max_ps(b, a), which keeps the result the same when a value is NaN
+        static __m128 SelectSSE2(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+        void EvaluateSSE2(const GazeFadeHMDPose& hmd_pose, size_t i)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one  = _mm_set1_ps(1.0f);
+            const __m128 ten  = _mm_set1_ps(10.0f);
+
+            const __m128 pos_x = _mm_loadu_ps(&m_PosX[i]);
+            const __m128 pos_y = _mm_loadu_ps(&m_PosY[i]);
+            const __m128 pos_z = _mm_loadu_ps(&m_PosZ[i]);
+            const __m128 hmd_x = _mm_set1_ps(hmd_pose.PosX);
+            const __m128 hmd_y = _mm_set1_ps(hmd_pose.PosY);
+            const __m128 hmd_z = _mm_set1_ps(hmd_pose.PosZ);
+
+            const __m128 hmd_dx = _mm_sub_ps(hmd_x, pos_x);
+            const __m128 hmd_dy = _mm_sub_ps(hmd_y, pos_y);
+            const __m128 hmd_dz = _mm_sub_ps(hmd_z, pos_z);
+            const __m128 gaze_distance_auto = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(hmd_dx, hmd_dx), _mm_mul_ps(hmd_dy, hmd_dy)), _mm_mul_ps(hmd_dz, hmd_dz)));
+
+            const __m128 gaze_distance_set = _mm_loadu_ps(&m_GazeDistance[i]);
+            __m128 gaze_distance = SelectSSE2(_mm_cmpeq_ps(gaze_distance_set, zero), gaze_distance_auto, _mm_add_ps(gaze_distance_set, _mm_set1_ps(0.20f)));
+
+            const __m128 gaze_distance_neg = _mm_xor_ps(gaze_distance, _mm_set1_ps(-0.0f));
+            const __m128 gaze_dx = _mm_sub_ps(_mm_add_ps(hmd_x, _mm_mul_ps(gaze_distance_neg, _mm_set1_ps(hmd_pose.AxisZX))), pos_x);
+            const __m128 gaze_dy = _mm_sub_ps(_mm_add_ps(hmd_y, _mm_mul_ps(gaze_distance_neg, _mm_set1_ps(hmd_pose.AxisZY))), pos_y);
+            const __m128 gaze_dz = _mm_sub_ps(_mm_add_ps(hmd_z, _mm_mul_ps(gaze_distance_neg, _mm_set1_ps(hmd_pose.AxisZZ))), pos_z);
+            const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(gaze_dx, gaze_dx), _mm_mul_ps(gaze_dy, gaze_dy)), _mm_mul_ps(gaze_dz, gaze_dz)));
+
+            gaze_distance = _mm_min_ps(one, gaze_distance);
+
+            const __m128 fade_rate_neg = _mm_xor_ps(_mm_mul_ps(_mm_loadu_ps(&m_FadeRate[i]), ten), _mm_set1_ps(-0.0f));
+            __m128 alpha = _mm_add_ps(_mm_mul_ps(distance, fade_rate_neg), _mm_mul_ps(_mm_sub_ps(gaze_distance, _mm_set1_ps(0.1f)), ten));
+            alpha = _mm_max_ps(_mm_min_ps(one, alpha), zero);
+
+            const __m128 opacity_max  = _mm_loadu_ps(&m_OpacityMax[i]);
+            const __m128 opacity_min  = _mm_loadu_ps(&m_OpacityMin[i]);
+            const __m128 range_length = _mm_sub_ps(opacity_max, opacity_min);
+
+            const __m128 alpha_ranged     = _mm_add_ps(_mm_mul_ps(alpha, range_length), opacity_min);
+            const __m128 alpha_ranged_inv = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(alpha, one), range_length), opacity_max);
+            alpha = SelectSSE2(_mm_cmpge_ps(range_length, zero), alpha_ranged, alpha_ranged_inv);
+
+            const __m128 hovered = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_setr_epi32(m_IsHovered[i], m_IsHovered[i + 1], m_IsHovered[i + 2], m_IsHovered[i + 3]), _mm_setzero_si128()));
+            alpha = SelectSSE2(hovered, alpha, _mm_max_ps(opacity_max, opacity_min));       //Mask is set for lanes that are not hovered
+
+            const __m128 opacity_current = _mm_loadu_ps(&m_OpacityCurrent[i]);
+            const __m128 diff = _mm_sub_ps(alpha, opacity_current);
+            _mm_storeu_ps(&m_OpacityNew[i], _mm_add_ps(opacity_current, _mm_max_ps(_mm_min_ps(_mm_set1_ps(0.1f), diff), _mm_set1_ps(-0.1f))));
+        }
+    #endif
+};
@@ -100,7 +100,7 @@ void InputSimulator::RefreshScreenOffsets()
 {
     if (m_ForwardToElevatedModeProcess)
     {
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_refresh);
+        ForwardToElevatedModeProcess(ipceact_refresh);
     }
 
     m_SpaceMultiplierX = 65536.0f / GetSystemMetrics(SM_CXVIRTUALSCREEN);
@@ -114,7 +114,7 @@ void InputSimulator::MouseMove(int x, int y)
 {
     if (m_ForwardToElevatedModeProcess)
     {
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_mouse_move, MAKELPARAM(x, y));
+        ForwardToElevatedModeProcess(ipceact_mouse_move, MAKELPARAM(x, y));
         return;
     }
 
@@ -128,6 +128,33 @@ void InputSimulator::MouseMove(int x, int y)
     ::SendInput(1, &input_event, sizeof(INPUT));
 }
 
+void InputSimulator::MouseMove(const POINT* positions, size_t count)
+{
+    if (m_ForwardToElevatedModeProcess)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            ForwardToElevatedModeProcess(ipceact_mouse_move, MAKELPARAM(positions[i].x, positions[i].y));
+        }
+        return;
+    }
+
+    if (count == 0)
+        return;
+
+    std::vector<INPUT> input_events(count, INPUT{0});
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        input_events[i].type = INPUT_MOUSE;
+        input_events[i].mi.dx = (positions[i].x + m_SpaceOffsetX) * m_SpaceMultiplierX;
+        input_events[i].mi.dy = (positions[i].y + m_SpaceOffsetY) * m_SpaceMultiplierY;
+        input_events[i].mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_VIRTUALDESK | MOUSEEVENTF_ABSOLUTE;
+    }
+
+    ::SendInput((UINT)input_events.size(), input_events.data(), sizeof(INPUT));
+}
+
 void InputSimulator::MouseSetLeftDown(bool down)
 {
     (down) ? KeyboardSetDown(VK_LBUTTON) : KeyboardSetUp(VK_LBUTTON);
@@ -175,7 +202,7 @@ void InputSimulator::KeyboardSetDown(unsigned char keycode)
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         elevated_keycodes[0] = keycode;
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_down, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_down, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -212,7 +239,7 @@ void InputSimulator::KeyboardSetUp(unsigned char keycode)
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         elevated_keycodes[0] = keycode;
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_up, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_up, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -247,7 +274,7 @@ void InputSimulator::KeyboardSetDown(unsigned char keycodes[3])
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         std::copy(keycodes, keycodes + 3, elevated_keycodes);
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_down, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_down, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -284,7 +311,7 @@ void InputSimulator::KeyboardSetUp(unsigned char keycodes[3])
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         std::copy(keycodes, keycodes + 3, elevated_keycodes);
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_up, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_up, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -325,7 +352,7 @@ void InputSimulator::KeyboardToggleState(unsigned char keycode)
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         elevated_keycodes[0] = keycode;
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_toggle, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_toggle, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -346,7 +373,7 @@ void InputSimulator::KeyboardToggleState(unsigned char keycodes[3])
         unsigned char elevated_keycodes[sizeof(LPARAM)] = {0};
         std::copy(keycodes, keycodes + 3, elevated_keycodes);
 
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_toggle, *(LPARAM*)&elevated_keycodes);
+        ForwardToElevatedModeProcess(ipceact_key_toggle, *(LPARAM*)&elevated_keycodes);
         return;
     }
 
@@ -382,7 +409,7 @@ void InputSimulator::KeyboardPressAndRelease(unsigned char keycode)
 {
     if (m_ForwardToElevatedModeProcess)
     {
-        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_key_press_and_release, keycode);
+        ForwardToElevatedModeProcess(ipceact_key_press_and_release, keycode);
         return;
     }
 
@@ -538,7 +565,7 @@ void InputSimulator::KeyboardTextFinish()
         //Only send if we know there is queued text in that process
         if (m_ElevatedModeHasTextQueued)
         {
-            IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, ipceact_keyboard_text_finish);
+            ForwardToElevatedModeProcess(ipceact_keyboard_text_finish);
             m_ElevatedModeHasTextQueued = false;
         }
         return;
@@ -556,3 +583,17 @@ void InputSimulator::SetElevatedModeForwardingActive(bool do_forward)
 {
     m_ForwardToElevatedModeProcess = do_forward;
 }
+
+bool InputSimulator::CreateElevatedModeInputChannel()
+{
+    return m_ElevatedModeInputChannel.Create();
+}
+
+void InputSimulator::ForwardToElevatedModeProcess(IPCElevatedActionID action_id, LPARAM lparam)
+{
+    //Use the input channel if it's available, which avoids flooding the elevated mode process' message queue
+    if (!m_ElevatedModeInputChannel.PushEvent(action_id, lparam))
+    {
+        IPCManager::Get().PostMessageToElevatedModeProcess(ipcmsg_elevated_action, action_id, lparam);
+    }
+}
@@ -6,6 +6,8 @@
 #include <vector>
 #include <windows.h>
 
+#include "ElevatedInputChannel.h"
+
 //Dashboard_Back exists, but not doesn't map to "Go Back" ...okay!
 #define Button_Dashboard_GoHome vr::k_EButton_IndexController_A
 #define Button_Dashboard_GoBack vr::k_EButton_IndexController_B
@@ -21,14 +23,17 @@ class InputSimulator
         std::vector<INPUT> m_KeyboardTextQueue;
         bool m_ForwardToElevatedModeProcess;
         bool m_ElevatedModeHasTextQueued;
+        ElevatedInputChannel m_ElevatedModeInputChannel;
 
         void SetEventForMouseKeyCode(INPUT& input_event, unsigned char keycode, bool down) const;
         void SetEventForKeyCode(INPUT& input_event, unsigned char keycode, bool down) const;
+        void ForwardToElevatedModeProcess(IPCElevatedActionID action_id, LPARAM lparam = 0);
 
     public:
         InputSimulator();
         void RefreshScreenOffsets();
         void MouseMove(int x, int y);
+        void MouseMove(const POINT* positions, size_t count);   //Submits all movements in a single SendInput call
         void MouseSetLeftDown(bool down);
         void MouseSetRightDown(bool down);
         void MouseSetMiddleDown(bool down);
@@ -46,6 +51,8 @@ class InputSimulator
         void KeyboardTextFinish();
 
         void SetElevatedModeForwardingActive(bool do_forward);
+        bool CreateElevatedModeInputChannel();                  //Only called by the dashboard process
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <cwchar>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+//Building blocks of the error log (see ErrorLog)
+//- LogQueue: Bounded lock-free multi-producer/single-consumer queue, so any thread can log without waiting on the disk or other threads
+//- LogRateLimiter: Suppresses bursts of the same message and counts them instead
+//- LogFileWriter: Appends to the log file and rotates it once it gets too large
+//Kept free of Windows headers so it can be tested anywhere
+
+enum LogSeverity
+{
+    log_severity_debug,
+    log_severity_info,
+    log_severity_warning,
+    log_severity_error
+};
+
+struct LogEntry
+{
+    static const uint32_t MaxLength = 511;      //Longer messages are truncated
+
+    LogSeverity Severity;
+    int64_t Time;                               //std::time_t of when the message was queued
+    uint32_t Length;
+    wchar_t Text[MaxLength + 1];
+};
+
+class LogQueue
+{
+    public:
+        static const uint32_t Capacity = 256;
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint32_t> Sequence;     //Index the slot can be written for next, or index + 1 once it's been written and can be read
+            LogEntry Entry;
+        };
+
+        static_assert((Capacity & (Capacity - 1)) == 0, "LogQueue::Capacity must be a power of two");
+
+        alignas(64) std::atomic<uint32_t> m_WriteIndex;
+        alignas(64) uint32_t m_ReadIndex;       //Only touched by the consumer
+        alignas(64) std::atomic<uint64_t> m_DroppedCount;
+        Slot m_Slots[Capacity];
+
+    public:
+        LogQueue() : m_WriteIndex(0), m_ReadIndex(0), m_DroppedCount(0)
+        {
+            for (uint32_t i = 0; i < Capacity; ++i)
+            {
+                m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        //- Producers
+        //Copies the message with line breaks replaced by spaces so every message stays on one line
+        //Returns false and counts the message as dropped if the queue is full
+        bool Push(LogSeverity severity, int64_t time, const wchar_t* str)
+        {
+            uint32_t write_index = m_WriteIndex.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &m_Slots[write_index & (Capacity - 1)];
+                const int32_t diff = (int32_t)(slot->Sequence.load(std::memory_order_acquire) - write_index);
+
+                if (diff == 0)
+                {
+                    //Slot is free, try claiming it. Sequentially consistent so the consumer's HasPending() after announcing it's about to wait can't miss it
+                    if (m_WriteIndex.compare_exchange_weak(write_index, write_index + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    //Slot still holds an entry from the previous round, queue is full
+                    m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    //Another producer claimed it first
+                    write_index = m_WriteIndex.load(std::memory_order_relaxed);
+                }
+            }
+
+            LogEntry& entry = slot->Entry;
+            entry.Severity = severity;
+            entry.Time     = time;
+
+            uint32_t length = 0;
+            for (const wchar_t* c = str; (*c != L'\0') && (length < LogEntry::MaxLength); ++c)
+            {
+                if ( (c[0] == L'\r') && (c[1] == L'\n') ) //System error strings come with CRLF
+                {
+                    ++c;
+                }
+
+                entry.Text[length++] = (*c == L'\n') ? L' ' : *c;
+            }
+
+            entry.Text[length] = L'\0';
+            entry.Length = length;
+
+            slot->Sequence.store(write_index + 1, std::memory_order_release);
+            return true;
+        }
+
+        //- Consumer
+        //Returns false if there's nothing to read. Entries are read in the order the producers claimed their slots
+        bool Pop(LogEntry& entry_out)
+        {
+            Slot& slot = m_Slots[m_ReadIndex & (Capacity - 1)];
+
+            if (slot.Sequence.load(std::memory_order_acquire) != m_ReadIndex + 1)
+                return false;
+
+            entry_out = slot.Entry;
+            slot.Sequence.store(m_ReadIndex + Capacity, std::memory_order_release);
+            ++m_ReadIndex;
+
+            return true;
+        }
+
+        //True if a producer has claimed a slot not read yet, even if it's still being written. Consumer only
+        bool HasPending() const
+        {
+            return (m_WriteIndex.load(std::memory_order_seq_cst) != m_ReadIndex);
+        }
+
+        //Total messages dropped due to a full queue
+        uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+};
+
+//Lets through up to MaxPerWindow of the same message per window, and reports how many were suppressed once the window is over
+//Messages are identified by a hash of their severity and text. Only the most recent messages are tracked
+class LogRateLimiter
+{
+    public:
+        static const uint32_t MaxPerWindow  = 5;
+        static const int64_t WindowSeconds  = 60;
+        static const size_t MaxTracked      = 32;
+
+    private:
+        struct MessageState
+        {
+            uint64_t Hash;
+            int64_t WindowStart;
+            uint32_t Count;                     //Messages in the current window, including suppressed ones
+            LogSeverity Severity;
+            std::wstring Text;                  //Kept to report suppressed messages
+        };
+
+        std::vector<MessageState> m_Messages;
+
+        static uint64_t HashEntry(const LogEntry& entry)
+        {
+            //FNV-1a
+            uint64_t hash = 14695981039346656037ULL ^ (uint64_t)entry.Severity;
+
+            for (uint32_t i = 0; i < entry.Length; ++i)
+            {
+                hash = (hash ^ (uint64_t)entry.Text[i]) * 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+    public:
+        //Returns true if the entry should be written
+        bool Check(const LogEntry& entry)
+        {
+            const uint64_t hash = HashEntry(entry);
+
+            auto it = std::find_if(m_Messages.begin(), m_Messages.end(), [&](const MessageState& state){ return (state.Hash == hash); });
+
+            if (it == m_Messages.end())
+            {
+                if (m_Messages.size() >= MaxTracked)
+                {
+                    //Forget the one with the oldest window. Its suppressed count is lost, but it takes a lot of different messages for that to happen
+                    m_Messages.erase(std::min_element(m_Messages.begin(), m_Messages.end(), [](const MessageState& a, const MessageState& b){ return (a.WindowStart < b.WindowStart); }));
+                }
+
+                m_Messages.push_back({hash, entry.Time, 1, entry.Severity, std::wstring(entry.Text, entry.Length)});
+                return true;
+            }
+
+            it->Count++;
+            return (it->Count <= MaxPerWindow);
+        }
+
+        //Ends windows older than WindowSeconds at the given time and calls report(severity, text, suppressed_count) for each with suppressed messages
+        //Pass a time far in the future to end all of them, e.g. before exiting
+        template<typename F> void Expire(int64_t time, F report)
+        {
+            for (auto it = m_Messages.begin(); it != m_Messages.end();)
+            {
+                if (time - it->WindowStart >= WindowSeconds)
+                {
+                    if (it->Count > MaxPerWindow)
+                    {
+                        report(it->Severity, it->Text, it->Count - MaxPerWindow);
+                    }
+
+                    it = m_Messages.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+};
+
+//Appends lines to the log file, which is opened on the first write after Close()
+//Once the file exceeds the maximum size, it's renamed to path.1 (previous path.1 to path.2 and so on) and a new file is started
+class LogFileWriter
+{
+    private:
+        std::string m_Path;
+        uint64_t m_MaxSize;
+        int m_BackupCount;
+        std::wofstream m_File;
+        uint64_t m_Size;
+
+        std::string GetBackupPath(int index) const
+        {
+            return m_Path + "." + std::to_string(index);
+        }
+
+        void Rotate()
+        {
+            m_File.close();
+
+            std::remove(GetBackupPath(m_BackupCount).c_str());
+
+            for (int i = m_BackupCount - 1; i >= 1; --i)
+            {
+                std::rename(GetBackupPath(i).c_str(), GetBackupPath(i + 1).c_str());
+            }
+
+            if (m_BackupCount > 0)
+            {
+                std::rename(m_Path.c_str(), GetBackupPath(1).c_str());
+            }
+            else
+            {
+                std::remove(m_Path.c_str());
+            }
+        }
+
+        bool Open()
+        {
+            if (m_File.is_open())
+                return true;
+
+            std::ifstream existing(m_Path, std::ios::binary | std::ios::ate);
+            m_Size = (existing.is_open()) ? (uint64_t)std::max((std::streamoff)existing.tellg(), (std::streamoff)0) : 0;
+            existing.close();
+
+            m_File.open(m_Path, std::ios::app | std::ios::binary); //btw. the resulting file is in local encoding, not utf-16, but that's good enough
+            return m_File.is_open();
+        }
+
+    public:
+        LogFileWriter(const std::string& path, uint64_t max_size, int backup_count) : m_Path(path), m_MaxSize(max_size), m_BackupCount(backup_count), m_Size(0) {}
+
+        //Non-error messages get their severity put in front
+        void Write(LogSeverity severity, int64_t time, const wchar_t* str)
+        {
+            if (!Open())
+                return;
+
+            const std::time_t t = (std::time_t)time;
+            std::tm tm = *std::localtime(&t);
+
+            m_File << std::put_time(&tm, L"[%Y-%m-%d %H:%M] ");
+
+            const wchar_t* prefix = L"";
+            switch (severity)
+            {
+                case log_severity_debug:   prefix = L"Debug: ";   break;
+                case log_severity_info:    prefix = L"Info: ";    break;
+                case log_severity_warning: prefix = L"Warning: "; break;
+                default: break;
+            }
+
+            m_File << prefix << str << L"\n";
+
+            //Close enough without knowing how the local encoding turns out
+            m_Size += 19 + wcslen(prefix) + wcslen(str) + 1;
+
+            //A failed conversion leaves the stream unusable, so clear it for the next message
+            m_File.clear();
+
+            if (m_Size >= m_MaxSize)
+            {
+                Rotate();
+            }
+        }
+
+        void Close()
+        {
+            m_File.close();
+        }
+};
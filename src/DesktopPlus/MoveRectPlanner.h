@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+//Plans the texture copies for desktop duplication move rects (see DISPLAYMANAGER::CopyMove())
+//Moves are applied in order, each one reading the surface as left by the previous ones, same as the move rects reported by DXGI
+//- Moves whose source and destination don't overlap are a single copy within the surface
+//- Overlapping moves are split into strips no larger than the move distance along one axis, copied in the order that never reads an already written strip,
+//  as long as that's cheaper than going through the scratch surface, which is sized for the largest move needing it instead of the full desktop
+//Kept free of Windows headers so it can be tested anywhere
+
+struct MovePlanRect
+{
+    int Left;
+    int Top;
+    int Right;
+    int Bottom;
+
+    int GetWidth()  const { return Right - Left; }
+    int GetHeight() const { return Bottom - Top; }
+    bool IsEmpty()  const { return ( (Right <= Left) || (Bottom <= Top) ); }
+    bool Overlaps(const MovePlanRect& r) const { return ( (r.Top < Bottom) && (r.Bottom > Top) && (r.Left < Right) && (r.Right > Left) ); }
+};
+
+struct MovePlanMove
+{
+    MovePlanRect Source;
+    int DestX;                                  //Top-left of the destination, which is the same size as the source
+    int DestY;
+};
+
+enum MovePlanCopyType
+{
+    moveplan_copy_direct,                       //Surface to surface
+    moveplan_copy_to_scratch,                   //Surface to scratch surface
+    moveplan_copy_from_scratch                  //Scratch surface to surface
+};
+
+struct MovePlanCopy
+{
+    MovePlanCopyType Type;
+    MovePlanRect Source;                        //In the coordinates of the surface copied from
+    int DestX;                                  //In the coordinates of the surface copied to
+    int DestY;
+};
+
+struct MovePlan
+{
+    std::vector<MovePlanCopy> Copies;           //In the order they have to be executed
+    std::vector<MovePlanRect> DirtyRects;       //Destination of each non-empty move, in order
+    int ScratchWidth  = 0;                      //Minimum scratch surface size for the planned copies, 0 if none go through it
+    int ScratchHeight = 0;
+};
+
+//Estimated cost of a copy call on top of the copied pixels, in pixels. Strips win while their extra calls cost less than copying the move twice
+static const int64_t g_MovePlanCopyCallCost = 16384;
+
+//Splits an overlapping move along one axis into strips of distance height/width, starting from the side the move is heading to
+inline void MovePlanAddStrips(const MovePlanMove& move, bool vertical, int distance, std::vector<MovePlanCopy>& copies)
+{
+    const MovePlanRect& src = move.Source;
+    const int length     = (vertical) ? src.GetHeight() : src.GetWidth();
+    const int delta      = (vertical) ? move.DestY - src.Top : move.DestX - src.Left;
+    const int step_count = (length + distance - 1) / distance;
+
+    for (int i = 0; i < step_count; ++i)
+    {
+        //Moving towards negative coordinates, start at the low end. Otherwise start at the high end
+        const int strip_index = (delta < 0) ? i : step_count - 1 - i;
+        const int strip_start = strip_index * distance;
+        const int strip_end   = std::min(strip_start + distance, length);
+
+        MovePlanCopy copy;
+        copy.Type   = moveplan_copy_direct;
+        copy.Source = src;
+
+        if (vertical)
+        {
+            copy.Source.Top    = src.Top + strip_start;
+            copy.Source.Bottom = src.Top + strip_end;
+            copy.DestX = move.DestX;
+            copy.DestY = move.DestY + strip_start;
+        }
+        else
+        {
+            copy.Source.Left  = src.Left + strip_start;
+            copy.Source.Right = src.Left + strip_end;
+            copy.DestX = move.DestX + strip_start;
+            copy.DestY = move.DestY;
+        }
+
+        copies.push_back(copy);
+    }
+}
+
+//Replaces the contents of plan_out, reusing its allocations
+inline void PlanMoveRects(const MovePlanMove* moves, size_t move_count, MovePlan& plan_out)
+{
+    plan_out.Copies.clear();
+    plan_out.DirtyRects.clear();
+    plan_out.ScratchWidth  = 0;
+    plan_out.ScratchHeight = 0;
+
+    for (size_t i = 0; i < move_count; ++i)
+    {
+        const MovePlanMove& move = moves[i];
+        const MovePlanRect& src  = move.Source;
+
+        if (src.IsEmpty())
+            continue;
+
+        const MovePlanRect dest = {move.DestX, move.DestY, move.DestX + src.GetWidth(), move.DestY + src.GetHeight()};
+        plan_out.DirtyRects.push_back(dest);
+
+        if ( (dest.Left == src.Left) && (dest.Top == src.Top) )
+            continue;
+
+        if (!src.Overlaps(dest))
+        {
+            plan_out.Copies.push_back({moveplan_copy_direct, src, dest.Left, dest.Top});
+            continue;
+        }
+
+        //Strip along the axis with the larger move distance, as that needs fewer strips
+        const int distance_x = std::abs(dest.Left - src.Left);
+        const int distance_y = std::abs(dest.Top  - src.Top);
+        const bool vertical  = (distance_y >= distance_x);
+        const int distance   = (vertical) ? distance_y : distance_x;
+        const int length     = (vertical) ? src.GetHeight() : src.GetWidth();
+        const int64_t strip_count = (length + distance - 1) / distance;
+
+        const int64_t area          = (int64_t)src.GetWidth() * src.GetHeight();
+        const int64_t cost_strips   = (strip_count * g_MovePlanCopyCallCost) + area;
+        const int64_t cost_scratch  = 2 * (g_MovePlanCopyCallCost + area);
+
+        if (cost_strips <= cost_scratch)
+        {
+            MovePlanAddStrips(move, vertical, distance, plan_out.Copies);
+        }
+        else
+        {
+            plan_out.Copies.push_back({moveplan_copy_to_scratch,   src, 0, 0});
+            plan_out.Copies.push_back({moveplan_copy_from_scratch, {0, 0, src.GetWidth(), src.GetHeight()}, dest.Left, dest.Top});
+
+            plan_out.ScratchWidth  = std::max(plan_out.ScratchWidth,  src.GetWidth());
+            plan_out.ScratchHeight = std::max(plan_out.ScratchHeight, src.GetHeight());
+        }
+    }
+}
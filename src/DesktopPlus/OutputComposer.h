@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//Keeps track of the per-output surfaces the desktop duplication threads write into (see CaptureThreadEntry() and OutputManager::ComposeOutputs())
+//Each output has its own surface, keyed mutex and dirty rect. A duplication thread writes into its surface while holding it with key 0, releases it with key 1 and marks the frame ready
+//The main thread only acquires (key 1) the surfaces of outputs with a ready frame, copies their dirty rect into the compose texture and releases them with key 0
+//The duplication thread can't get its surface back before that, so an output's dirty rect is only ever accessed by one side at a time
+//A busy or stalled output only holds up its own updates. Kept free of Windows headers so it can be tested anywhere
+
+struct ComposeRect
+{
+    int Left;
+    int Top;
+    int Right;
+    int Bottom;
+
+    bool IsEmpty() const { return ( (Left >= Right) || (Top >= Bottom) ); }
+
+    void Add(const ComposeRect& r)
+    {
+        if (r.IsEmpty())
+            return;
+
+        if (IsEmpty())
+        {
+            *this = r;
+            return;
+        }
+
+        Left   = std::min(Left,   r.Left);
+        Top    = std::min(Top,    r.Top);
+        Right  = std::max(Right,  r.Right);
+        Bottom = std::max(Bottom, r.Bottom);
+    }
+
+    void ClipWith(const ComposeRect& r)
+    {
+        Left   = std::min(std::max(Left,   r.Left), r.Right);
+        Top    = std::min(std::max(Top,    r.Top),  r.Bottom);
+        Right  = std::min(std::max(Right,  r.Left), r.Right);
+        Bottom = std::min(std::max(Bottom, r.Top),  r.Bottom);
+    }
+};
+
+class ComposeOutput
+{
+    friend class OutputComposer;
+
+    private:
+        ComposeRect m_Rect;                     //Position and size in the compose texture
+        ComposeRect m_DirtyRect;                //Output-local region written since the output was last composed
+        std::atomic<bool> m_IsFrameReady;
+
+    public:
+        ComposeOutput(const ComposeRect& rect) : m_Rect(rect), m_DirtyRect{0, 0, 0, 0}, m_IsFrameReady(false) {}
+
+        const ComposeRect& GetRect() const { return m_Rect; }
+
+        //- Duplication thread
+        //Only while holding the output surface
+        void AddDirtyRect(const ComposeRect& rect) { m_DirtyRect.Add(rect); }
+        //After releasing the output surface to the main thread
+        void SetFrameReady() { m_IsFrameReady.store(true, std::memory_order_release); }
+};
+
+class OutputComposer
+{
+    private:
+        std::vector<std::unique_ptr<ComposeOutput>> m_Outputs;
+
+    public:
+        //Replaces all outputs. No duplication thread may be running during this
+        void SetOutputs(const std::vector<ComposeRect>& output_rects)
+        {
+            m_Outputs.clear();
+
+            for (const ComposeRect& rect : output_rects)
+            {
+                m_Outputs.push_back(std::unique_ptr<ComposeOutput>(new ComposeOutput(rect)));
+            }
+        }
+
+        size_t GetOutputCount() const                { return m_Outputs.size(); }
+        ComposeOutput& GetOutput(size_t output_id)   { return *m_Outputs[output_id]; }
+
+        //- Main thread
+        bool HasReadyFrames() const
+        {
+            return std::any_of(m_Outputs.begin(), m_Outputs.end(), [](const std::unique_ptr<ComposeOutput>& output){ return output->m_IsFrameReady.load(std::memory_order_relaxed); });
+        }
+
+        //Calls compose(output_id, dirty_rect_local, dest_x, dest_y) for every output with a ready frame, which has to acquire the output surface, copy the dirty rect and release it again
+        //If compose() returns false, the frame is kept for the next call. Returns the region of the compose texture that was updated
+        template<typename F> ComposeRect ComposeReadyOutputs(F compose)
+        {
+            ComposeRect dirty_total = {0, 0, 0, 0};
+
+            for (size_t i = 0; i < m_Outputs.size(); ++i)
+            {
+                ComposeOutput& output = *m_Outputs[i];
+
+                if (!output.m_IsFrameReady.exchange(false, std::memory_order_acquire))
+                    continue;
+
+                //Safe to access without holding the surface, as the duplication thread can't take it back until compose() released it
+                ComposeRect dirty_rect = output.m_DirtyRect;
+                dirty_rect.ClipWith({0, 0, output.m_Rect.Right - output.m_Rect.Left, output.m_Rect.Bottom - output.m_Rect.Top});
+                output.m_DirtyRect = {0, 0, 0, 0};
+
+                if (!compose(i, dirty_rect, output.m_Rect.Left, output.m_Rect.Top))
+                {
+                    output.m_DirtyRect = dirty_rect;
+                    output.m_IsFrameReady.store(true, std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (!dirty_rect.IsEmpty())
+                {
+                    dirty_total.Add({dirty_rect.Left + output.m_Rect.Left, dirty_rect.Top + output.m_Rect.Top, dirty_rect.Right + output.m_Rect.Left, dirty_rect.Bottom + output.m_Rect.Top});
+                }
+            }
+
+            return dirty_total;
+        }
+};
@@ -12,6 +12,9 @@ using namespace DirectX;
 #include "OverlayManager.h"
 #include "WindowManager.h"
 #include "Util.h"
+#include "PerformanceTrace.h"
+#include "OverlayTransformCache.h"
+#include "ErrorLog.h"
 
 #include "DesktopPlusWinRT.h"
 
@@ -42,10 +45,9 @@ OutputManager::OutputManager(HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicat
     m_PixelShader(nullptr),
     m_PixelShaderCursor(nullptr),
     m_InputLayout(nullptr),
-    m_SharedSurf(nullptr),
+    m_ComposeTex(nullptr),
     m_VertexBuffer(nullptr),
     m_ShaderResource(nullptr),
-    m_KeyMutex(nullptr),
     m_WindowHandle(nullptr),
     m_PauseDuplicationEvent(PauseDuplicationEvent),
     m_ResumeDuplicationEvent(ResumeDuplicationEvent),
@@ -101,8 +103,15 @@ OutputManager::OutputManager(HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicat
     m_PerformanceFrameCount(0),
     m_PerformanceFrameCountStartTick(0),
     m_PerformanceUpdateLimiterDelay{0},
-    m_IsAnyHotkeyActive(false),
-    m_IsHotkeyDown{0}
+    m_PerformanceDuplicationWakeupCountLast(0),
+    m_CaptureWorkerRebalanceTick(0),
+    m_PerformanceWindowCacheHitCountLast(0),
+    m_PerformanceWindowCacheFallbackCountLast(0),
+    m_PerformanceTransformSubmittedCountLast(0),
+    m_PerformanceTransformSkippedCountLast(0),
+    m_PerformanceCursorMetricsLast{},
+    m_HotkeyEngineStateIDRegistered(0),
+    m_IsAnyHotkeyActive(false)
 {
     m_MouseLastInfo = {0};
     m_MouseLastInfo.ShapeInfo.Type = DXGI_OUTDUPL_POINTER_SHAPE_TYPE_COLOR;
@@ -110,6 +119,9 @@ OutputManager::OutputManager(HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicat
     //Initialize ConfigManager and set first launch state based on existence of config file (used to detect first launch in Steam version)
     m_IsFirstLaunch = !ConfigManager::Get().LoadConfigFromFile();
 
+    //Create the input channel to the elevated mode process up front. It has to be created by this unelevated process so both sides can access it
+    m_InputSim.CreateElevatedModeInputChannel();
+
     g_OutputManager = this;
 }
 
@@ -133,6 +145,8 @@ OutputManager::~OutputManager()
 //
 void OutputManager::CleanRefs()
 {
+    m_OUtoSBSConverterCache.Clear();
+
     if (m_VertexShader)
     {
         m_VertexShader->Release();
@@ -187,11 +201,17 @@ void OutputManager::CleanRefs()
         m_Device = nullptr;
     }
 
-    if (m_SharedSurf)
+    if (m_ComposeTex)
+    {
+        m_ComposeTex->Release();
+        m_ComposeTex = nullptr;
+    }
+
+    for (ID3D11Texture2D* surf : m_OutputSurfs)
     {
-        m_SharedSurf->Release();
-        m_SharedSurf = nullptr;
+        surf->Release();
     }
+    m_OutputSurfs.clear();
 
     if (m_VertexBuffer)
     {
@@ -245,11 +265,13 @@ void OutputManager::CleanRefs()
     m_MouseDefaultHotspotX = 0;
     m_MouseDefaultHotspotY = 0;
 
-    if (m_KeyMutex)
+    for (IDXGIKeyedMutex* key_mutex : m_OutputKeyMutexes)
     {
-        m_KeyMutex->Release();
-        m_KeyMutex = nullptr;
+        key_mutex->Release();
     }
+    m_OutputKeyMutexes.clear();
+
+    m_OutputComposer.SetOutputs({});
 
     if (m_ComInitDone)
     {
@@ -769,58 +791,53 @@ std::tuple<vr::EVRInitError, vr::EVROverlayError, bool> OutputManager::InitOverl
 //
 // Update Overlay and handle events
 //
-DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect& DirtyRectTotal, bool NewFrame, bool SkipFrame)
+DUPL_RETURN_UPD OutputManager::Update(_Inout_ PTR_INFO* PointerInfo, bool NewFrame, bool SkipFrame)
 {
+    PerformanceTraceScope trace_scope(perftrace_update);
+
     if (HandleOpenVREvents())   //If quit event received, quit.
     {
         return DUPL_RETURN_UPD_QUIT;
     }
 
-    UINT64 sync_key = 1; //Key used by duplication threads to lock for this function (duplication threads lock with 1, Update() with 0 and unlock vice versa)
+    UpdateDuplicationWaitPolicy();
 
-    //If we previously skipped a frame, we want to actually process a new one at the next valid opportunity
+    //If we previously skipped a frame, we want to actually process it at the next valid opportunity
     if ( (m_OutputPendingSkippedFrame) && (!SkipFrame) )
     {
-        //If there isn't new frame yet, we have to unlock the keyed mutex with the one we locked it with ourselves before
-        //However, if the laser pointer was used since the last update, we simply use the key for new frame data to wait for the new mouse position or frame
+        //If the laser pointer was used since the last update, wait for the new mouse position or frame first
         //Not waiting for it reduces latency usually, but laser pointer mouse movements are weirdly not picked up without doing this or enabling the rapid laser pointer update setting
-        if ( (!NewFrame) && (!m_MouseLaserPointerUsedLastUpdate) )
+        if ( (!NewFrame) && (m_MouseLaserPointerUsedLastUpdate) && (!m_OutputComposer.HasReadyFrames()) )
         {
-            sync_key = 0;
+            m_MouseLaserPointerUsedLastUpdate = false;
+            return DUPL_RETURN_UPD_RETRY;
         }
 
         NewFrame = true; //Treat this as a new frame now
         m_MouseLaserPointerUsedLastUpdate = false;
     }
 
-    //If frame skipped and no new frame, do nothing (if there's a new frame, we have to at least re-lock the keyed mutex so the duplication threads can access it again)
+    //If frame skipped and no new frame, do nothing (if there's a new frame, we have to at least compose it so the duplication threads get their surfaces back)
     if ( (SkipFrame) && (!NewFrame) )
     {
         m_OutputPendingSkippedFrame = true; //Process the frame next time we can
         return DUPL_RETURN_UPD_SUCCESS;
     }
 
-    //When invalid output is set, key mutex can be null, so just do nothing
-    if (m_KeyMutex == nullptr)
+    //When invalid output is set, the compose texture can be null, so just do nothing
+    if (m_ComposeTex == nullptr)
     {
         return DUPL_RETURN_UPD_SUCCESS;
     }
 
-    // Try and acquire sync on common display buffer (needed to safely access the PointerInfo)
-    HRESULT hr = m_KeyMutex->AcquireSync(sync_key, m_MaxActiveRefreshDelay);
-    if (hr == static_cast<HRESULT>(WAIT_TIMEOUT))
-    {
-        // Another thread has the keyed mutex so try again later
-        return DUPL_RETURN_UPD_RETRY;
-    }
-    else if (FAILED(hr))
+    //Copy new frames into the compose texture. Only outputs that have one are waited on, so a busy output doesn't hold up the others
+    DPRect DirtyRectTotal(-1, -1, -1, -1);
+    DUPL_RETURN_UPD ret = ComposeOutputs(DirtyRectTotal);
+    if (ret != DUPL_RETURN_UPD_SUCCESS)
     {
-        return (DUPL_RETURN_UPD)ProcessFailure(m_Device, L"Failed to acquire keyed mutex", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+        return ret;
     }
 
-    DUPL_RETURN_UPD ret = DUPL_RETURN_UPD_SUCCESS;
-
-    //Got mutex, so we can access pointer info and shared surface
     DPRect mouse_rect = {PointerInfo->Position.x, PointerInfo->Position.y, int(PointerInfo->Position.x + PointerInfo->ShapeInfo.Width),
                          int(PointerInfo->Position.y + PointerInfo->ShapeInfo.Height)};
 
@@ -847,7 +864,7 @@ DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect&
     }
 
 
-    //If frame is skipped, skip all GPU work
+    //If frame is skipped, skip all GPU work other than composing
     if (SkipFrame)
     {
         //Collect dirty rects for the next time we render
@@ -857,10 +874,10 @@ DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect&
         if (PointerInfo->CursorShapeChanged)
         {
             m_MouseCursorNeedsUpdate = true;
+            PointerInfo->CursorShapeChanged = false;
         }
 
         m_OutputPendingSkippedFrame = true;
-        hr = m_KeyMutex->ReleaseSync(0);
 
         return DUPL_RETURN_UPD_SUCCESS;
     }
@@ -943,16 +960,7 @@ DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect&
     m_MouseLastInfo = *PointerInfo;
     m_MouseLastInfo.PtrShapeBuffer = nullptr; //Not used or copied properly so remove info to avoid confusion
     m_MouseLastInfo.BufferSize = 0;
-
-    //Reset dirty rect
-    DirtyRectTotal = DPRect(-1, -1, -1, -1);
-
-    // Release keyed mutex
-    hr = m_KeyMutex->ReleaseSync(0);
-    if (FAILED(hr))
-    {
-        return (DUPL_RETURN_UPD)ProcessFailure(m_Device, L"Failed to Release keyed mutex", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
-    }
+    PointerInfo->CursorShapeChanged = false; //Handled, stays set otherwise until the next update is processed
 
     //Count frames if performance stats are active
     if ( (has_updated_overlay) && (ConfigManager::Get().GetConfigBool(configid_bool_state_performance_stats_active)) )
@@ -968,7 +976,7 @@ DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect&
 
 bool OutputManager::HandleIPCMessage(const MSG& msg)
 {
-    //Config strings come as WM_COPYDATA
+    //Config strings and binary data come as WM_COPYDATA
     if (msg.message == WM_COPYDATA)
     {
         COPYDATASTRUCT* pcds = (COPYDATASTRUCT*)msg.lParam;
@@ -980,28 +988,11 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
 
             ConfigID_String str_id = (ConfigID_String)pcds->dwData;
             ConfigManager::Get().SetConfigString(str_id, copystr);
-
-            switch (str_id)
-            {
-                case configid_str_state_action_value_string:
-                {
-                    std::vector<CustomAction>& actions = ConfigManager::Get().GetCustomActions();
-                    const int id = ConfigManager::Get().GetConfigInt(configid_int_state_action_current);
-
-                    //Unnecessary, but let's save us from the near endless loop in case of a coding error
-                    if ( (id < 0) || (id > 10000) )
-                        break;
-
-                    while (id >= actions.size())
-                    {
-                        actions.push_back(CustomAction());
-                    }
-
-                    actions[id].ApplyStringFromConfig();
-                    break;
-                }
-                default: break;
-            }
+        }
+        else if ( (pcds->dwData == ipcbin_custom_actions) && (pcds->cbData > 0) && (pcds->cbData <= 1024 * 1024) )
+        {
+            //The data is fully validated while applying, malformed updates are dropped as a whole
+            ActionManager::Get().ApplySerializedCustomActions(pcds->lpData, pcds->cbData);
         }
 
         return false;
@@ -1047,6 +1038,8 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     if (actions.size() > msg.lParam)
                     {
                         ActionManager::Get().EraseCustomAction(msg.lParam);
+                        //Hotkey bindings of the deleted action were unbound and the others' IDs changed
+                        RegisterHotkeys();
                     }
 
                     break;
@@ -1096,6 +1089,8 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     OverlayManager::Get().RemoveOverlay((unsigned int)msg.lParam);
                     //RemoveOverlay() may have changed active ID, keep in sync
                     ConfigManager::Get().SetConfigInt(configid_int_interface_overlay_current_id, OverlayManager::Get().GetCurrentOverlayID());
+                    //Overlay-scoped hotkey bindings were dropped or had their IDs changed
+                    RegisterHotkeys();
                     break;
                 }
                 case ipcact_overlay_position_sync:
@@ -1106,6 +1101,7 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                 case ipcact_overlay_swap:
                 {
                     OverlayManager::Get().SwapOverlays(OverlayManager::Get().GetCurrentOverlayID(), (unsigned int)msg.lParam);
+                    RegisterHotkeys();
                     break;
                 }
                 case ipcact_overlay_gaze_fade_auto:
@@ -1187,6 +1183,13 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     WindowManager::Get().RaiseAndFocusWindow((HWND)msg.lParam, &m_InputSim);
                     break;
                 }
+                case ipcact_performance_trace_dump:
+                {
+                    //Pick up events from the last partial second as well. They're still counted in the next stats update
+                    PerformanceTrace::Get().Drain();
+                    PerformanceTrace::Get().DumpChromeTrace((ConfigManager::Get().GetApplicationPath() + "performance_trace.json").c_str());
+                    break;
+                }
             }
             break;
         }
@@ -1256,6 +1259,8 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     }
                     case configid_bool_state_performance_stats_active:
                     {
+                        PerformanceTrace::Get().SetEnabled(msg.lParam);
+
                         if (msg.lParam) //Update GPU Copy state
                         {
                             ConfigManager::Get().SetConfigBool(configid_bool_state_performance_gpu_copy_active, (m_MultiGPUTargetDevice != nullptr));
@@ -1349,6 +1354,7 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     case configid_int_input_hotkey01_action_id:
                     case configid_int_input_hotkey02_action_id:
                     case configid_int_input_hotkey03_action_id:
+                    case configid_int_input_hotkey_sequence_timeout_ms:
                     {
                         //*_keycode always follows after *_modifiers, so we only catch the keycode ones
                         RegisterHotkeys();
@@ -1372,23 +1378,6 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                         ApplySettingUpdateLimiter();
                         break;
                     }
-                    case configid_int_state_action_value_int:
-                    {
-                        std::vector<CustomAction>& actions = ConfigManager::Get().GetCustomActions();
-                        const int id = ConfigManager::Get().GetConfigInt(configid_int_state_action_current);
-
-                        //Unnecessary, but let's save us from the near endless loop in case of a coding error
-                        if (id > 10000)
-                            break;
-
-                        while (id >= actions.size())
-                        {
-                            actions.push_back(CustomAction());
-                        }
-
-                        actions[id].ApplyIntFromConfig();
-                        break;
-                    }
                     default: break;
                 }
             }
@@ -1421,6 +1410,11 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                         ApplySettingUpdateLimiter();
                         break;
                     }
+                    case configid_float_performance_transform_epsilon:
+                    {
+                        OverlayTransformCache::Get().SetEpsilon(ConfigManager::Get().GetConfigFloat(configid_float_performance_transform_epsilon));
+                        break;
+                    }
                     default: break;
                 }
 
@@ -1616,6 +1610,15 @@ void OutputManager::HandleWinRTMessage(const MSG& msg)
 
             break;
         }
+        case WM_DPLUSWINRT_CAPTURE_WINDOWS:
+        {
+            //Let the WindowManager hook location changes of the captured windows to feed the capture window state cache. Captures only change on this thread
+            std::vector<HWND> capture_windows(DPWinRT_GetCaptureWindows(nullptr, 0));
+            DPWinRT_GetCaptureWindows(capture_windows.data(), (unsigned int)capture_windows.size());
+
+            WindowManager::Get().SetCaptureWindows(capture_windows);
+            break;
+        }
         case WM_DPLUSWINRT_THREAD_ERROR:
         {
             //We get capture lost messages for each affected overlay, so just forward the error to the UI so a warning can be displayed for now
@@ -1627,17 +1630,9 @@ void OutputManager::HandleWinRTMessage(const MSG& msg)
 
 void OutputManager::HandleHotkeyMessage(const MSG& msg)
 {
-    //m_IsHotkeyDown blocks HandleHotkeys() and the hotkey messages from triggering hotkey actions twice. It's reset in HandleHotkeys when the key is no longer pressed
-    if ((msg.wParam <= 2) && (!m_IsHotkeyDown[msg.wParam]))
+    if (msg.wParam < m_HotkeyStrokesRegistered.size())
     {
-        switch (msg.wParam)
-        {
-            case 0: DoAction((ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_action_id)); break;
-            case 1: DoAction((ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_action_id)); break;
-            case 2: DoAction((ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_action_id)); break;
-        }
-
-        m_IsHotkeyDown[msg.wParam] = true;
+        HandleHotkeyStroke(m_HotkeyStrokesRegistered[msg.wParam]);
     }
 }
 
@@ -1649,22 +1644,39 @@ HWND OutputManager::GetWindowHandle()
 //
 // Returns shared handle
 //
-HANDLE OutputManager::GetSharedHandle()
+std::vector<HANDLE> OutputManager::GetOutputSharedHandles()
 {
-    HANDLE Hnd = nullptr;
+    std::vector<HANDLE> handles;
 
-    // QI IDXGIResource interface to synchronized shared surface.
-    IDXGIResource* DXGIResource = nullptr;
-    HRESULT hr = m_SharedSurf->QueryInterface(__uuidof(IDXGIResource), reinterpret_cast<void**>(&DXGIResource));
-    if (SUCCEEDED(hr))
+    for (ID3D11Texture2D* surf : m_OutputSurfs)
     {
-        // Obtain handle to IDXGIResource object.
-        DXGIResource->GetSharedHandle(&Hnd);
-        DXGIResource->Release();
-        DXGIResource = nullptr;
+        HANDLE Hnd = nullptr;
+
+        // QI IDXGIResource interface to synchronized shared surface.
+        IDXGIResource* DXGIResource = nullptr;
+        HRESULT hr = surf->QueryInterface(__uuidof(IDXGIResource), reinterpret_cast<void**>(&DXGIResource));
+        if (SUCCEEDED(hr))
+        {
+            // Obtain handle to IDXGIResource object.
+            DXGIResource->GetSharedHandle(&Hnd);
+            DXGIResource->Release();
+            DXGIResource = nullptr;
+        }
+
+        if (Hnd == nullptr)
+        {
+            return {};
+        }
+
+        handles.push_back(Hnd);
     }
 
-    return Hnd;
+    return handles;
+}
+
+OutputComposer& OutputManager::GetOutputComposer()
+{
+    return m_OutputComposer;
 }
 
 IDXGIAdapter* OutputManager::GetDXGIAdapter()
@@ -1977,6 +1989,30 @@ void OutputManager::ResetOverlayActiveCount()
     WindowManager::Get().SetActive( (m_OvrlActiveCount > 0) );
 }
 
+void OutputManager::UpdateDuplicationWaitPolicy()
+{
+    //Single desktop mirroring only has the one thread for the desktop all overlays show
+    bool all_visible = ConfigManager::Get().GetConfigBool(configid_bool_performance_single_desktop_mirroring);
+    m_DuplicationVisibleRects.clear();
+
+    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+    {
+        const Overlay& overlay = OverlayManager::Get().GetOverlay(i);
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+
+        if ( (!overlay.IsVisible()) || (data.ConfigInt[configid_int_overlay_capture_source] != ovrl_capsource_desktop_duplication) )
+            continue;
+
+        //The crop rect is relative to the duplicated desktop area, while the threads know their output in desktop coordinates
+        DPRect crop_rect = overlay.GetValidatedCropRect();
+        crop_rect.Translate({m_DesktopX, m_DesktopY});
+
+        m_DuplicationVisibleRects.push_back({crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetBR().x, crop_rect.GetBR().y});
+    }
+
+    m_DuplicationWaitPolicy.SetVisibleRects(m_DuplicationVisibleRects, all_visible);
+}
+
 bool OutputManager::HasDashboardBeenActivatedOnce() const
 {
     return m_DashboardActivatedOnce;
@@ -2071,19 +2107,18 @@ void OutputManager::DoAction(ActionID action_id)
                 {
                     if (OverlayManager::Get().GetOverlayCount() > (unsigned int)action.IntID)
                     {
-                        OverlayConfigData& data = OverlayManager::Get().GetConfigData((unsigned int)action.IntID);
-                        data.ConfigBool[configid_bool_overlay_enabled] = !data.ConfigBool[configid_bool_overlay_enabled];
-
-                        unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-                        OverlayManager::Get().SetCurrentOverlayID((unsigned int)action.IntID);
-                        ApplySettingTransform();
-                        OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+                        const OverlayConfigData& data = OverlayManager::Get().GetConfigData((unsigned int)action.IntID);
 
-                        //Sync change
-                        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)action.IntID);
-                        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_overlay_enabled), data.ConfigBool[configid_bool_overlay_enabled]);
-                        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
+                        OverlayConfigBatch batch;
+                        batch.Set((unsigned int)action.IntID, ConfigManager::GetWParamForConfigID(configid_bool_overlay_enabled), !data.ConfigBool[configid_bool_overlay_enabled]);
+                        CommitOverlayConfigBatch(batch);
                     }
+                    break;
+                }
+                case caction_toggle_overlay_group_enabled_state:
+                {
+                    ToggleOverlayGroupEnabled(action.IntID);
+                    break;
                 }
             }
             return;
@@ -2206,28 +2241,60 @@ void OutputManager::DoStopAction(ActionID action_id)
 
 void OutputManager::ToggleOverlayGroupEnabled(int group_id)
 {
+    OverlayConfigBatch batch;
+
     for (unsigned int i = k_ulOverlayID_Dashboard; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
 
         if ( (data.ConfigInt[configid_int_overlay_group_id] == group_id) )
         {
-            data.ConfigBool[configid_bool_overlay_enabled] = !data.ConfigBool[configid_bool_overlay_enabled];
+            batch.Set(i, ConfigManager::GetWParamForConfigID(configid_bool_overlay_enabled), !data.ConfigBool[configid_bool_overlay_enabled]);
+        }
+    }
 
-            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-            OverlayManager::Get().SetCurrentOverlayID(i);
-            ApplySettingTransform();
-            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+    CommitOverlayConfigBatch(batch);
+}
 
-            //Sync change
-            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), i);
-            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_bool_overlay_enabled), data.ConfigBool[configid_bool_overlay_enabled]);
-            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
+void OutputManager::CommitOverlayConfigBatch(OverlayConfigBatch& batch)
+{
+    const unsigned int overlay_count = OverlayManager::Get().GetOverlayCount();
+
+    //Only keep actual changes, also dropping any for overlays or config IDs that don't exist
+    batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out)
+               {
+                   return ( (overlay_id < overlay_count) && (OverlayManager::Get().GetConfigData(overlay_id).GetValueForWParam(config_key, value_out)) );
+               });
+
+    if (batch.IsEmpty())
+        return;
+
+    const std::vector<OverlayConfigChange>& changes = batch.GetChanges();
+    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
+
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        OverlayManager::Get().GetConfigData(changes[i].OverlayID).SetValueForWParam(changes[i].ConfigKey, changes[i].Value);
+
+        //Changes are sorted by overlay, so apply the overlay's state after its last change
+        if ( (i + 1 == changes.size()) || (changes[i + 1].OverlayID != changes[i].OverlayID) )
+        {
+            OverlayManager::Get().SetCurrentOverlayID(changes[i].OverlayID);
+            ApplySettingTransform();
         }
     }
+
+    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+
+    //Sync all changes in one message
+    BinaryWriter writer;
+    batch.Serialize(writer);
+    IPCManager::Get().SendBinaryToUIApp(ipcbin_overlay_config_batch, writer.GetBuffer(), m_WindowHandle);
+
+    batch.Clear();
 }
 
-void OutputManager::UpdatePerformanceStates()
+void OutputManager::UpdatePerformanceStates(const CursorStateMetrics& cursor_metrics)
 {
     //Frame counter, the frames themselves are counted in Update()
     if ( (ConfigManager::Get().GetConfigBool(configid_bool_state_performance_stats_active)) && (::GetTickCount64() >= m_PerformanceFrameCountStartTick + 1000) )
@@ -2238,6 +2305,167 @@ void OutputManager::UpdatePerformanceStates()
 
         m_PerformanceFrameCountStartTick = ::GetTickCount64();
         m_PerformanceFrameCount = 0;
+
+        //Duplication thread wakeups, fewer is better while nothing's happening
+        uint64_t wakeup_count = m_DuplicationWaitPolicy.GetWakeupCount();
+        int wakeups_per_second = int(wakeup_count - m_PerformanceDuplicationWakeupCountLast);
+        m_PerformanceDuplicationWakeupCountLast = wakeup_count;
+
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_duplication_wakeups, wakeups_per_second);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_duplication_wakeups), wakeups_per_second);
+
+        //Cursor updates from the duplication threads, coalesced ones were replaced by a newer update before the main thread got to them
+        int cursor_updates   = int(cursor_metrics.PublishCount   - m_PerformanceCursorMetricsLast.PublishCount);
+        int cursor_coalesced = int(cursor_metrics.CoalescedCount - m_PerformanceCursorMetricsLast.CoalescedCount);
+        m_PerformanceCursorMetricsLast = cursor_metrics;
+
+        if (cursor_updates == 0)
+        {
+            cursor_updates   = -1;
+            cursor_coalesced = -1;
+        }
+
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_cursor_updates,   cursor_updates);
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_cursor_coalesced, cursor_coalesced);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_cursor_updates),   cursor_updates);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_cursor_coalesced), cursor_coalesced);
+
+        //Stage timings, sent as p50/p99 pairs in PerformanceTraceStage order
+        PerformanceTraceStageStats trace_stats[perftrace_MAX];
+        PerformanceTrace::Get().Collect(trace_stats);
+
+        for (int i = 0; i < perftrace_MAX; ++i)
+        {
+            ConfigID_Int config_id_p50 = (ConfigID_Int)(configid_int_state_performance_trace_update_p50 + (i * 2));
+            ConfigID_Int config_id_p99 = (ConfigID_Int)(config_id_p50 + 1);
+            int value_p50 = (trace_stats[i].Count != 0) ? (int)trace_stats[i].P50US : -1;
+            int value_p99 = (trace_stats[i].Count != 0) ? (int)trace_stats[i].P99US : -1;
+
+            ConfigManager::Get().SetConfigInt(config_id_p50, value_p50);
+            ConfigManager::Get().SetConfigInt(config_id_p99, value_p99);
+            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(config_id_p50), value_p50);
+            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(config_id_p99), value_p99);
+        }
+
+        //Graphics Capture frame metrics, per overlay
+        DPWinRT_SampleCaptureMetrics();
+
+        for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+        {
+            OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+            DPWinRTCaptureMetrics metrics;
+            const int value_count = configid_int_overlay_state_capture_latency_max_us - configid_int_overlay_state_capture_fps + 1;
+            int values[value_count] = {-1, -1, -1, -1, -1};
+
+            if ( (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_winrt_capture) && 
+                 (DPWinRT_GetOverlayCaptureMetrics(OverlayManager::Get().GetOverlay(i).GetHandle(), &metrics)) )
+            {
+                values[0] = (int)metrics.FrameRate;
+                values[1] = (int)metrics.DroppedFrameRate;
+                values[2] = (metrics.ConversionCount != 0) ? (int)metrics.ConversionAvgUS : -1;
+                values[3] = (metrics.LatencyCount    != 0) ? (int)metrics.LatencyAvgUS    : -1;
+                values[4] = (metrics.LatencyCount    != 0) ? (int)metrics.LatencyMaxUS    : -1;
+            }
+
+            //Only send what changed, most overlays don't use Graphics Capture
+            bool has_changed = false;
+            for (int value_id = 0; value_id < value_count; ++value_id)
+            {
+                has_changed |= (data.ConfigInt[configid_int_overlay_state_capture_fps + value_id] != values[value_id]);
+            }
+
+            if (!has_changed)
+                continue;
+
+            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)i);
+
+            for (int value_id = 0; value_id < value_count; ++value_id)
+            {
+                ConfigID_Int config_id = (ConfigID_Int)(configid_int_overlay_state_capture_fps + value_id);
+                data.ConfigInt[config_id] = values[value_id];
+                IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(config_id), values[value_id]);
+            }
+
+            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
+        }
+
+        //Graphics Capture teardown times, totals since launch
+        DPWinRTCaptureTeardownStats teardown_stats;
+        DPWinRT_GetCaptureTeardownStats(&teardown_stats);
+
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_capture_teardown_count,  (int)teardown_stats.Count);
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_capture_teardown_max_ms, (int)teardown_stats.MaxMS);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_capture_teardown_count),  (int)teardown_stats.Count);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_capture_teardown_max_ms), (int)teardown_stats.MaxMS);
+
+        //Graphics Capture worker thread command latency, combined for all commands
+        const UINT request_command_ids[] = {WM_DPLUSWINRT_UPDATE_DATA, WM_DPLUSWINRT_CAPTURE_PAUSE, WM_DPLUSWINRT_ENABLE_CURSOR, WM_DPLUSWINRT_CAPTURE_STOP, WM_DPLUSWINRT_CAPTURE_START};
+        unsigned long long request_count = 0, request_total_us = 0, request_max_us = 0, request_timeouts = 0;
+
+        for (UINT command_id : request_command_ids)
+        {
+            DPWinRTRequestLatencyStats request_stats;
+
+            if (DPWinRT_GetRequestLatencyStats(command_id, &request_stats))
+            {
+                request_count    += request_stats.Count;
+                request_total_us += request_stats.AverageUS * request_stats.Count;
+                request_max_us    = std::max(request_max_us, request_stats.MaxUS);
+                request_timeouts += request_stats.TimeoutCount;
+            }
+        }
+
+        const int request_values[] = {(request_count != 0) ? (int)(request_total_us / request_count) : -1, (request_count != 0) ? (int)request_max_us : -1, (int)request_timeouts};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ConfigID_Int config_id = (ConfigID_Int)(configid_int_state_performance_capture_request_avg_us + i);
+            ConfigManager::Get().SetConfigInt(config_id, request_values[i]);
+            IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(config_id), request_values[i]);
+        }
+
+        //Graphics Capture window state cache reads, only used by window captures
+        unsigned long long window_cache_hit_count = 0, window_cache_fallback_count = 0;
+        DPWinRT_GetWindowStateCacheStats(&window_cache_hit_count, &window_cache_fallback_count);
+
+        int window_cache_hits      = int(window_cache_hit_count      - m_PerformanceWindowCacheHitCountLast);
+        int window_cache_fallbacks = int(window_cache_fallback_count - m_PerformanceWindowCacheFallbackCountLast);
+        m_PerformanceWindowCacheHitCountLast      = window_cache_hit_count;
+        m_PerformanceWindowCacheFallbackCountLast = window_cache_fallback_count;
+
+        if ( (window_cache_hits == 0) && (window_cache_fallbacks == 0) )
+        {
+            window_cache_hits      = -1;
+            window_cache_fallbacks = -1;
+        }
+
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_capture_window_cache_hits,      window_cache_hits);
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_capture_window_cache_fallbacks, window_cache_fallbacks);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_capture_window_cache_hits),      window_cache_hits);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_capture_window_cache_fallbacks), window_cache_fallbacks);
+
+        //Overlay transforms of this process, skipped ones are calls into the VR runtime avoided
+        const uint64_t transform_submitted_count = OverlayTransformCache::Get().GetSubmittedCount();
+        const uint64_t transform_skipped_count   = OverlayTransformCache::Get().GetSkippedCount();
+        const int transform_submitted = int(transform_submitted_count - m_PerformanceTransformSubmittedCountLast);
+        const int transform_skipped   = int(transform_skipped_count   - m_PerformanceTransformSkippedCountLast);
+        m_PerformanceTransformSubmittedCountLast = transform_submitted_count;
+        m_PerformanceTransformSkippedCountLast   = transform_skipped_count;
+
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_transform_submitted, transform_submitted);
+        ConfigManager::Get().SetConfigInt(configid_int_state_performance_transform_skipped,   transform_skipped);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_transform_submitted), transform_submitted);
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_performance_transform_skipped),   transform_skipped);
+    }
+}
+
+void OutputManager::UpdateCaptureWorkerBalance()
+{
+    //Captures' processing cost is sampled on each call, so this needs a steady interval. Moves are handed over by the WinRT library without waiting on them
+    if (::GetTickCount64() >= m_CaptureWorkerRebalanceTick + 5000)
+    {
+        DPWinRT_RebalanceCaptureWorkers();
+        m_CaptureWorkerRebalanceTick = ::GetTickCount64();
     }
 }
 
@@ -2246,6 +2474,16 @@ const LARGE_INTEGER& OutputManager::GetUpdateLimiterDelay()
     return m_PerformanceUpdateLimiterDelay;
 }
 
+DuplicationWaitPolicy& OutputManager::GetDuplicationWaitPolicy()
+{
+    return m_DuplicationWaitPolicy;
+}
+
+bool OutputManager::StartVRStreamRecording(const char* path)
+{
+    return m_VRStreamRecorder.Start(path);
+}
+
 int OutputManager::EnumerateOutputs(int target_desktop_id, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_preferred, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_vr)
 {
     Microsoft::WRL::ComPtr<IDXGIFactory1> factory_ptr;
@@ -2343,26 +2581,44 @@ int OutputManager::EnumerateOutputs(int target_desktop_id, Microsoft::WRL::ComPt
     return output_id_adapter;
 }
 
-void OutputManager::ConvertOUtoSBS(Overlay& overlay, OUtoSBSConverter& converter)
+void OutputManager::ConvertOUtoSBS(Overlay& overlay, uint64_t& converter_entry_id)
 {
     //Convert()'s arguments are almost all stuff from OutputManager, so we take this roundabout way of calling it
     const DPRect& crop_rect = overlay.GetValidatedCropRect();
 
-    HRESULT hr = converter.Convert(m_Device, m_DeviceContext, m_MultiGPUTargetDevice, m_MultiGPUTargetDeviceContext, m_OvrlTex,
-                                   m_DesktopWidth, m_DesktopHeight, crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetWidth(), crop_rect.GetHeight());
+    //Overlays with the same crop share a single conversion
+    OUtoSBSConverterCache::Entry& cache_entry = m_OUtoSBSConverterCache.GetEntry(m_OvrlTex, OUtoSBSRect::FromCrop(crop_rect.GetTL().x, crop_rect.GetTL().y, 
+                                                                                                                     crop_rect.GetWidth(), crop_rect.GetHeight()));
+
+    if (m_OUtoSBSConverterCache.IsConversionNeeded(cache_entry))
+    {
+        HRESULT hr = cache_entry.Converter.Convert(m_Device, m_DeviceContext, m_MultiGPUTargetDevice, m_MultiGPUTargetDeviceContext, m_OvrlTex,
+                                                   m_DesktopWidth, m_DesktopHeight, crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetWidth(), crop_rect.GetHeight(),
+                                                   m_OUtoSBSConverterCache.GetFrameDirtyRect());
+
+        if (hr != S_OK)
+        {
+            if (m_OUtoSBSConverterCache.SetConversionFailed(cache_entry))
+            {
+                ProcessFailure(m_Device, L"Failed to convert OU texture to SBS", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+            }
+
+            return;
+        }
 
-    if (hr == S_OK)
+        m_OUtoSBSConverterCache.SetConverted(cache_entry);
+    }
+
+    //Only set the texture if its content changed or the overlay doesn't have it set yet
+    if ( (m_OUtoSBSConverterCache.IsConvertedThisFrame(cache_entry)) || (cache_entry.ID != converter_entry_id) )
     {
         vr::Texture_t vrtex;
         vrtex.eType = vr::TextureType_DirectX;
         vrtex.eColorSpace = vr::ColorSpace_Gamma;
-        vrtex.handle = converter.GetTexture(); //OUtoSBSConverter takes care of multi-gpu support automatically, so no further processing needed
+        vrtex.handle = cache_entry.Converter.GetTexture(); //OUtoSBSConverter takes care of multi-gpu support automatically, so no further processing needed
 
         vr::VROverlay()->SetOverlayTexture(overlay.GetHandle(), &vrtex);
-    }
-    else
-    {
-        ProcessFailure(m_Device, L"Failed to convert OU texture to SBS", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+        converter_entry_id = cache_entry.ID;
     }
 }
 
@@ -2378,7 +2634,7 @@ DUPL_RETURN OutputManager::ProcessMonoMask(bool IsMono, _Inout_ PTR_INFO* PtrInf
 
     // Desktop dimensions
     D3D11_TEXTURE2D_DESC FullDesc;
-    m_SharedSurf->GetDesc(&FullDesc);
+    m_ComposeTex->GetDesc(&FullDesc);
     INT DesktopWidth  = FullDesc.Width;
     INT DesktopHeight = FullDesc.Height;
 
@@ -2452,7 +2708,7 @@ DUPL_RETURN OutputManager::ProcessMonoMask(bool IsMono, _Inout_ PTR_INFO* PtrInf
     Box->top    = *PtrTop;
     Box->right  = *PtrLeft + *PtrWidth;
     Box->bottom = *PtrTop + *PtrHeight;
-    m_DeviceContext->CopySubresourceRegion(CopyBuffer, 0, 0, 0, 0, m_SharedSurf, 0, Box);
+    m_DeviceContext->CopySubresourceRegion(CopyBuffer, 0, 0, 0, 0, m_ComposeTex, 0, Box);
 
     // QI for IDXGISurface
     IDXGISurface* CopySurface = nullptr;
@@ -2521,7 +2777,7 @@ DUPL_RETURN OutputManager::ProcessMonoMask(bool IsMono, _Inout_ PTR_INFO* PtrInf
     }
     else
     {
-        UINT* Buffer32 = reinterpret_cast<UINT*>(PtrInfo->PtrShapeBuffer);
+        const UINT* Buffer32 = reinterpret_cast<const UINT*>(PtrInfo->PtrShapeBuffer);
 
         // Iterate through pixels
         for (INT Row = 0; Row < *PtrHeight; ++Row)
@@ -2648,6 +2904,7 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
 
     //Figure out right dimensions for full size desktop texture
     DPRect output_rect_total;
+    std::vector<DPRect> output_rects;
     if (SingleOutput < 0)
     {
         //Combined desktop, also count desktops on the used adapter
@@ -2676,12 +2933,13 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
                                    output_desc.DesktopCoordinates.right, output_desc.DesktopCoordinates.bottom);
 
                 (output_rect_total.GetWidth() == 0) ? output_rect_total = output_rect : output_rect_total.Add(output_rect);
+                output_rects.push_back(output_rect);
             }
 
             ++output_index_adapter;
         }
 
-        *OutCount = output_index_adapter - 1;
+        *OutCount = (UINT)output_rects.size();
     }
     else
     {
@@ -2689,6 +2947,7 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
         if (SingleOutput < desktop_count)
         {
             output_rect_total = m_DesktopRects[SingleOutput];
+            output_rects.push_back(output_rect_total);
             *OutCount = 1;
         }
     }
@@ -2710,7 +2969,7 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
     mouse_scale.v[1] = m_DesktopHeight;
     vr::VROverlay()->SetOverlayMouseScale(m_OvrlHandleDesktopTexture, &mouse_scale);
 
-    //Create shared texture for all duplication threads to draw into
+    //Create texture the output surfaces are composed into
     D3D11_TEXTURE2D_DESC TexD;
     RtlZeroMemory(&TexD, sizeof(D3D11_TEXTURE2D_DESC));
     TexD.Width            = m_DesktopWidth;
@@ -2722,13 +2981,12 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
     TexD.Usage            = D3D11_USAGE_DEFAULT;
     TexD.BindFlags        = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
     TexD.CPUAccessFlags   = 0;
-    TexD.MiscFlags        = D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+    TexD.MiscFlags        = 0;
 
-    hr = m_Device->CreateTexture2D(&TexD, nullptr, &m_SharedSurf);
+    hr = m_Device->CreateTexture2D(&TexD, nullptr, &m_ComposeTex);
 
     if (!FAILED(hr))
     {
-        TexD.MiscFlags = 0;
         hr = m_Device->CreateTexture2D(&TexD, nullptr, &m_OvrlTex);
     }
 
@@ -2740,25 +2998,53 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
             // complete desktop image and blit updates from the per output DDA interface.  The GPU can
             // always support a texture size of the maximum resolution of any single output but there is no
             // guarantee that it can support a texture size of the desktop.
-            return ProcessFailure(m_Device, L"Failed to create shared texture. Combined desktop texture size may be larger than the maximum supported supported size of the GPU", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+            return ProcessFailure(m_Device, L"Failed to create compose texture. Combined desktop texture size may be larger than the maximum supported supported size of the GPU", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
         }
         else
         {
-            return ProcessFailure(m_Device, L"Failed to create shared texture", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+            return ProcessFailure(m_Device, L"Failed to create compose texture", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
         }
     }
 
-    // Get keyed mutex
-    hr = m_SharedSurf->QueryInterface(__uuidof(IDXGIKeyedMutex), reinterpret_cast<void**>(&m_KeyMutex));
-
-    if (FAILED(hr))
+    //Create shared textures for each duplication thread to draw into, so they don't have to wait on each other or on outputs which haven't got a new frame
+    std::vector<ComposeRect> compose_rects;
+    for (const DPRect& output_rect : output_rects)
     {
-        return ProcessFailure(m_Device, L"Failed to query for keyed mutex", L"Desktop+ Error", hr);
+        D3D11_TEXTURE2D_DESC OutputTexD = TexD;
+        OutputTexD.Width     = output_rect.GetWidth();
+        OutputTexD.Height    = output_rect.GetHeight();
+        OutputTexD.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        OutputTexD.MiscFlags = D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+        ID3D11Texture2D* output_surf = nullptr;
+        hr = m_Device->CreateTexture2D(&OutputTexD, nullptr, &output_surf);
+
+        if (FAILED(hr))
+        {
+            return ProcessFailure(m_Device, L"Failed to create shared texture", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
+        }
+
+        m_OutputSurfs.push_back(output_surf);
+
+        // Get keyed mutex
+        IDXGIKeyedMutex* key_mutex = nullptr;
+        hr = output_surf->QueryInterface(__uuidof(IDXGIKeyedMutex), reinterpret_cast<void**>(&key_mutex));
+
+        if (FAILED(hr))
+        {
+            return ProcessFailure(m_Device, L"Failed to query for keyed mutex", L"Desktop+ Error", hr);
+        }
+
+        m_OutputKeyMutexes.push_back(key_mutex);
+
+        compose_rects.push_back({output_rect.GetTL().x - m_DesktopX, output_rect.GetTL().y - m_DesktopY, output_rect.GetBR().x - m_DesktopX, output_rect.GetBR().y - m_DesktopY});
     }
 
-    //Create shader resource for shared texture
+    m_OutputComposer.SetOutputs(compose_rects);
+
+    //Create shader resource for compose texture
     D3D11_TEXTURE2D_DESC FrameDesc;
-    m_SharedSurf->GetDesc(&FrameDesc);
+    m_ComposeTex->GetDesc(&FrameDesc);
 
     D3D11_SHADER_RESOURCE_VIEW_DESC ShaderDesc;
     ShaderDesc.Format = FrameDesc.Format;
@@ -2767,7 +3053,7 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
     ShaderDesc.Texture2D.MipLevels = FrameDesc.MipLevels;
 
     // Create new shader resource view
-    hr = m_Device->CreateShaderResourceView(m_SharedSurf, &ShaderDesc, &m_ShaderResource);
+    hr = m_Device->CreateShaderResourceView(m_ComposeTex, &ShaderDesc, &m_ShaderResource);
     if (FAILED(hr))
     {
         return ProcessFailure(m_Device, L"Failed to create shader resource", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
@@ -2808,10 +3094,12 @@ DUPL_RETURN OutputManager::CreateTextures(INT SingleOutput, _Out_ UINT* OutCount
 
 void OutputManager::DrawFrameToOverlayTex(bool clear_rtv)
 {
+    PerformanceTraceScope trace_scope(perftrace_draw_frame);
+
     //Do a straight copy if there are no issues with that or do the alpha check if it's still pending
     if ((!m_OutputAlphaCheckFailed) || (m_OutputAlphaChecksPending > 0))
     {
-        m_DeviceContext->CopyResource(m_OvrlTex, m_SharedSurf);
+        m_DeviceContext->CopyResource(m_OvrlTex, m_ComposeTex);
 
         if (m_OutputAlphaChecksPending > 0)
         {
@@ -2855,6 +3143,8 @@ void OutputManager::DrawFrameToOverlayTex(bool clear_rtv)
 //
 DUPL_RETURN OutputManager::DrawMouseToOverlayTex(_In_ PTR_INFO* PtrInfo)
 {
+    PerformanceTraceScope trace_scope(perftrace_draw_mouse);
+
     //Just return if we don't need to render it
     if ((!ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_render_cursor)) || (!PtrInfo->Visible))
     {
@@ -3069,8 +3359,66 @@ DUPL_RETURN OutputManager::DrawMouseToOverlayTex(_In_ PTR_INFO* PtrInfo)
     return DUPL_RETURN_SUCCESS;
 }
 
+DUPL_RETURN_UPD OutputManager::ComposeOutputs(DPRect& DirtyRectTotal)
+{
+    HRESULT hr_fail = S_OK;
+
+    ComposeRect dirty_rect = m_OutputComposer.ComposeReadyOutputs([&](size_t output_id, const ComposeRect& output_dirty_rect, int dest_x, int dest_y)
+    {
+        IDXGIKeyedMutex* key_mutex = m_OutputKeyMutexes[output_id];
+
+        //Duplication threads lock with 0 and unlock with 1, so this only succeeds once the frame has been released to us
+        HRESULT hr = key_mutex->AcquireSync(1, 0);
+        if (hr == static_cast<HRESULT>(WAIT_TIMEOUT))
+        {
+            //Frame not fully released yet, try again on the next update
+            return false;
+        }
+        else if (FAILED(hr))
+        {
+            hr_fail = hr;
+            return false;
+        }
+
+        if (!output_dirty_rect.IsEmpty())
+        {
+            D3D11_BOX box;
+            box.left   = output_dirty_rect.Left;
+            box.top    = output_dirty_rect.Top;
+            box.front  = 0;
+            box.right  = output_dirty_rect.Right;
+            box.bottom = output_dirty_rect.Bottom;
+            box.back   = 1;
+
+            m_DeviceContext->CopySubresourceRegion(m_ComposeTex, 0, dest_x + output_dirty_rect.Left, dest_y + output_dirty_rect.Top, 0, m_OutputSurfs[output_id], 0, &box);
+        }
+
+        hr = key_mutex->ReleaseSync(0);
+        if (FAILED(hr))
+        {
+            hr_fail = hr;
+        }
+
+        return true;
+    });
+
+    if (FAILED(hr_fail))
+    {
+        return (DUPL_RETURN_UPD)ProcessFailure(m_Device, L"Failed to acquire or release keyed mutex of output surface", L"Desktop+ Error", hr_fail, SystemTransitionsExpectedErrors);
+    }
+
+    if (!dirty_rect.IsEmpty())
+    {
+        DirtyRectTotal = DPRect(dirty_rect.Left, dirty_rect.Top, dirty_rect.Right, dirty_rect.Bottom);
+    }
+
+    return DUPL_RETURN_UPD_SUCCESS;
+}
+
 DUPL_RETURN_UPD OutputManager::RefreshOpenVROverlayTexture(DPRect& DirtyRectTotal, bool force_full_copy)
 {
+    PerformanceTraceScope trace_scope(perftrace_refresh_overlay_texture);
+
     if ((m_OvrlHandleDesktopTexture != vr::k_ulOverlayHandleInvalid) && (m_OvrlTex))
     {
         vr::Texture_t vrtex;
@@ -3081,29 +3429,9 @@ DUPL_RETURN_UPD OutputManager::RefreshOpenVROverlayTexture(DPRect& DirtyRectTota
         //The intermediate texture can be assumed to be not complete when a full copy is forced, so redraw that
         if (force_full_copy)
         {
-            //Try to acquire sync for shared surface needed by DrawFrameToOverlayTex()
-            HRESULT hr = m_KeyMutex->AcquireSync(0, m_MaxActiveRefreshDelay);
-            if (hr == static_cast<HRESULT>(WAIT_TIMEOUT))
-            {
-                //Another thread has the keyed mutex so there will be a new frame ready after this.
-                //Bail out and just set the pending dirty region to full so everything gets drawn over on the next update
-                m_OutputPendingDirtyRect = {0, 0, m_DesktopWidth, m_DesktopHeight};
-                return DUPL_RETURN_UPD_RETRY;
-            }
-            else if (FAILED(hr))
-            {
-                return (DUPL_RETURN_UPD)ProcessFailure(m_Device, L"Failed to acquire keyed mutex", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
-            }
-
+            //The compose texture is only used by this thread, so no need to sync with the duplication threads
             DrawFrameToOverlayTex(true);
 
-            //Release keyed mutex
-            hr = m_KeyMutex->ReleaseSync(0);
-            if (FAILED(hr))
-            {
-                return (DUPL_RETURN_UPD)ProcessFailure(m_Device, L"Failed to Release keyed mutex", L"Desktop+ Error", hr, SystemTransitionsExpectedErrors);
-            }
-
             //We don't draw the cursor here as this can lead to tons of issues for little gain. We might not even know what the cursor looks like if it was cropped out previously, etc.
             //We do mark where the cursor has last been seen as pending dirty region, however, so it gets updated at the next best moment even if it didn't move
 
@@ -3193,6 +3521,16 @@ DUPL_RETURN_UPD OutputManager::RefreshOpenVROverlayTexture(DPRect& DirtyRectTota
             }               
         }
 
+        //Start a new frame for the OU converter cache, conversions of crops outside of the changed region are skipped
+        if (force_full_copy)
+        {
+            m_OUtoSBSConverterCache.BeginFrame();
+        }
+        else
+        {
+            m_OUtoSBSConverterCache.BeginFrame(OUtoSBSRect(DirtyRectTotal.GetTL().x, DirtyRectTotal.GetTL().y, DirtyRectTotal.GetBR().x, DirtyRectTotal.GetBR().y));
+        }
+
         if (force_full_copy) //This is down here so a failed partial copy is picked up as well
         {
             vr::VROverlay()->SetOverlayTexture(m_OvrlHandleDesktopTexture, &vrtex);
@@ -3213,6 +3551,8 @@ DUPL_RETURN_UPD OutputManager::RefreshOpenVROverlayTexture(DPRect& DirtyRectTota
                 OverlayManager::Get().GetOverlay(i).OnDesktopDuplicationUpdate();
             }
         }
+
+        m_OUtoSBSConverterCache.EndFrame();
     }
 
     return DUPL_RETURN_UPD_SUCCESS_REFRESHED_OVERLAY;
@@ -3300,11 +3640,17 @@ bool OutputManager::DesktopTextureAlphaCheck()
 
 bool OutputManager::HandleOpenVREvents()
 {
+    PerformanceTraceScope trace_scope(perftrace_handle_vr_events);
+
     vr::VREvent_t vr_event;
 
+    m_VRStreamRecorder.RecordFrame();
+
     //Handle Dashboard dummy ones first
     while (vr::VROverlay()->PollNextOverlayEvent(m_OvrlHandleDashboardDummy, &vr_event, sizeof(vr_event)))
     {
+        m_VRStreamRecorder.RecordEvent(m_OvrlHandleDashboardDummy, vr_event);
+
         switch (vr_event.eventType)
         {
             case vr::VREvent_OverlayShown:
@@ -3488,6 +3834,8 @@ bool OutputManager::HandleOpenVREvents()
 
         while (vr::VROverlay()->PollNextOverlayEvent(ovrl_handle, &vr_event, sizeof(vr_event)))
         {
+            m_VRStreamRecorder.RecordEvent(ovrl_handle, vr_event);
+
             switch (vr_event.eventType)
             {
                 case vr::VREvent_MouseMove:
@@ -3708,6 +4056,7 @@ bool OutputManager::HandleOpenVREvents()
 
     OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 
+    DetachedOverlayGazeFadeAll();
     DetachedOverlayGlobalHMDPointerAll();
 
     return false;
@@ -4654,7 +5003,7 @@ void OutputManager::ApplySettingTransform()
         case ovrl_origin_room:
         {
             matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+            OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
             break;
         }
         case ovrl_origin_hmd_floor:
@@ -4668,7 +5017,7 @@ void OutputManager::ApplySettingTransform()
             matrix *= ConfigManager::Get().GetOverlayDetachedTransform();
 
             vr::HmdMatrix34_t matrix_ovr = matrix.toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &matrix_ovr);
+            OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &matrix_ovr);
             break;
         }
         case ovrl_origin_dashboard:
@@ -4688,13 +5037,13 @@ void OutputManager::ApplySettingTransform()
                                                 ConfigManager::Get().GetConfigFloat(configid_float_overlay_offset_forward));
             }
 
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+            OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
             break;
         }
         case ovrl_origin_hmd:
         {
             matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, vr::k_unTrackedDeviceIndex_Hmd, &matrix);
+            OverlayTransformCache::Get().SetOverlayTransformTrackedDeviceRelative(ovrl_handle, vr::k_unTrackedDeviceIndex_Hmd, &matrix);
             break;
         }
         case ovrl_origin_right_hand:
@@ -4704,11 +5053,11 @@ void OutputManager::ApplySettingTransform()
             if (device_index != vr::k_unTrackedDeviceIndexInvalid)
             {
                 matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
             }
             else //No controller connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
             }
             break;
         }
@@ -4719,11 +5068,11 @@ void OutputManager::ApplySettingTransform()
             if (device_index != vr::k_unTrackedDeviceIndexInvalid)
             {
                 matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
             }
             else //No controller connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
             }
             break;
         }
@@ -4734,11 +5083,11 @@ void OutputManager::ApplySettingTransform()
             if (index_tracker != vr::k_unTrackedDeviceIndexInvalid)
             {
                 matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, index_tracker, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformTrackedDeviceRelative(ovrl_handle, index_tracker, &matrix);
             }
             else //Not connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
             }
 
             break;
@@ -5043,7 +5392,9 @@ void OutputManager::ApplySettingKeyboardScale()
 
             hmd_mat = mat.toOpenVR34();
 
+            //SteamVR moves and rescales the keyboard on its own, so a cached transform of it can't be trusted. Submit directly and drop any cache entry for the handle
             vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle_keyboard, universe_origin, &hmd_mat);
+            OverlayTransformCache::Get().Invalidate(ovrl_handle_keyboard);
         }
     }
 }
@@ -5141,6 +5492,7 @@ void OutputManager::ApplySettingUpdateLimiter()
     }
     
     m_PerformanceUpdateLimiterDelay.QuadPart = 1000.0f * limit_ms;
+    m_DuplicationWaitPolicy.SetLimiterInterval((uint32_t)limit_ms);
 }
 
 void OutputManager::DragStart(bool is_gesture_drag)
@@ -5224,7 +5576,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
             {
                 if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking);
+                    OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5234,7 +5586,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_right_hand != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_right_hand].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_right_hand].mDeviceToAbsoluteTracking);
+                    OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_right_hand].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5244,7 +5596,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_left_hand != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_left_hand].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_left_hand].mDeviceToAbsoluteTracking);
+                    OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_left_hand].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5254,7 +5606,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_tracker != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_tracker].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_tracker].mDeviceToAbsoluteTracking);
+                    OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_tracker].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5287,7 +5639,7 @@ void OutputManager::DragUpdate()
         matrix_source_current = matrix_target_new;
 
         vr::HmdMatrix34_t vrmat = matrix_source_current.toOpenVR34();
-        vr::VROverlay()->SetOverlayTransformAbsolute(OverlayManager::Get().GetOverlay(m_DragModeOverlayID).GetHandle(), vr::TrackingUniverseStanding, &vrmat);
+        OverlayTransformCache::Get().SetOverlayTransformAbsolute(OverlayManager::Get().GetOverlay(m_DragModeOverlayID).GetHandle(), vr::TrackingUniverseStanding, &vrmat);
     }
 }
 
@@ -5575,7 +5927,7 @@ void OutputManager::DragGestureUpdate()
                 mat_overlay.setTranslation(pos);
 
                 vr::HmdMatrix34_t vrmat = mat_overlay.toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &vrmat);
+                OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &vrmat);
             }
 
             m_DragGestureRotateMatLast = matrix_rotate_current;
@@ -5880,7 +6232,7 @@ void OutputManager::DetachedTransformUpdateHMDFloor()
     matrix *= ConfigManager::Get().GetOverlayDetachedTransform();
 
     vr::HmdMatrix34_t matrix_ovr = matrix.toOpenVR34();
-    vr::VROverlay()->SetOverlayTransformAbsolute(OverlayManager::Get().GetCurrentOverlay().GetHandle(), vr::TrackingUniverseStanding, &matrix_ovr);
+    OverlayTransformCache::Get().SetOverlayTransformAbsolute(OverlayManager::Get().GetCurrentOverlay().GetHandle(), vr::TrackingUniverseStanding, &matrix_ovr);
 }
 
 void OutputManager::DetachedTransformUpdateSeatedPosition()
@@ -5988,75 +6340,57 @@ void OutputManager::DetachedInteractionAutoToggle()
 
 void OutputManager::DetachedOverlayGazeFade()
 {
+    //Only collects the current overlay, fading is done for all of them at once in DetachedOverlayGazeFadeAll()
     if (  (ConfigManager::Get().GetConfigBool(configid_bool_overlay_gazefade_enabled)) && (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) && 
          (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode)) )
     {
-        vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-        vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
-
-        if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
-        {
-            //Distance the gaze point is offset from HMD (useful range 0.25 - 1.0)
-            float gaze_distance = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_distance);
-            //Rate the fading gets applied when looking off the gaze point (useful range 4.0 - 30, depends on overlay size) 
-            float fade_rate = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_rate) * 10.0f; 
-
-            Matrix4 mat_pose = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
-
-            Matrix4 mat_overlay = DragGetBaseOffsetMatrix();
-            mat_overlay *= ConfigManager::Get().GetOverlayDetachedTransform();
-
-            //Infinite/Auto distance mode
-            if (gaze_distance == 0.0f) 
-            {
-                gaze_distance = mat_overlay.getTranslation().distance(mat_pose.getTranslation()); //Match gaze distance to distance between HMD and overlay
-            }
-            else
-            {
-                gaze_distance += 0.20f; //Useful range starts at ~0.20 - 0.25 (lower is in HMD or culled away), so offset the settings value
-            }
-
-            OffsetTransformFromSelf(mat_pose, 0.0f, 0.0f, -gaze_distance);
-
-            Vector3 pos_gaze = mat_pose.getTranslation();
-            float distance = mat_overlay.getTranslation().distance(pos_gaze);
-
-            gaze_distance = std::min(gaze_distance, 1.0f); //To get useful fading past 1m distance we'll have to limit the value to 1m here for the math below
-
-            float alpha = clamp((distance * -fade_rate) + ((gaze_distance - 0.1f) * 10.0f), 0.0f, 1.0f); //There's nothing smart behind this, just trial and error
+        Matrix4 mat_overlay = DragGetBaseOffsetMatrix();
+        mat_overlay *= ConfigManager::Get().GetOverlayDetachedTransform();
+        const Vector3 pos_overlay = mat_overlay.getTranslation();
+
+        Overlay& current_overlay = OverlayManager::Get().GetCurrentOverlay();
+
+        GazeFadeOverlay gazefade_overlay;
+        gazefade_overlay.OverlayID      = current_overlay.GetID();
+        gazefade_overlay.PosX           = pos_overlay.x;
+        gazefade_overlay.PosY           = pos_overlay.y;
+        gazefade_overlay.PosZ           = pos_overlay.z;
+        gazefade_overlay.GazeDistance   = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_distance);
+        gazefade_overlay.FadeRate       = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_rate);
+        gazefade_overlay.OpacityMax     = ConfigManager::Get().GetConfigFloat(configid_float_overlay_opacity);
+        gazefade_overlay.OpacityMin     = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_opacity);
+        gazefade_overlay.OpacityCurrent = current_overlay.GetOpacity();
+        //Use max alpha when the overlay or the Floating UI targeting the overlay is being pointed at
+        gazefade_overlay.IsHovered      = ( (vr::VROverlay()->IsHoverTargetOverlay(current_overlay.GetHandle())) || 
+                                            ((unsigned int)ConfigManager::Get().GetConfigInt(configid_int_state_interface_floating_ui_hovered_id) == current_overlay.GetID()) );
+
+        m_GazeFadeEvaluator.Add(gazefade_overlay);
+    }
+}
 
-            const float max_alpha = ConfigManager::Get().GetConfigFloat(configid_float_overlay_opacity);
-            const float min_alpha = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_opacity);
-            Overlay& current_overlay = OverlayManager::Get().GetCurrentOverlay();
+void OutputManager::DetachedOverlayGazeFadeAll()
+{
+    if (m_GazeFadeEvaluator.GetOverlayCount() == 0)
+        return;
 
-            //Use max alpha when the overlay or the Floating UI targeting the overlay is being pointed at
-            if ((vr::VROverlay()->IsHoverTargetOverlay(current_overlay.GetHandle())) || 
-                ((unsigned int)ConfigManager::Get().GetConfigInt(configid_int_state_interface_floating_ui_hovered_id) == current_overlay.GetID()))
-            {
-                alpha = std::max(min_alpha, max_alpha); //Take whatever's more visible as the user probably wants to be able to see the overlay
-            }
-            else //Adapt alpha result from a 0.0 - 1.0 range to gazefade_opacity - overlay_opacity and invert if necessary
-            {
-                const float range_length = max_alpha - min_alpha;
+    vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
+    vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
+    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
 
-                if (range_length >= 0.0f)
-                {
-                    alpha = (alpha * range_length) + min_alpha;
-                }
-                else //Gaze Fade target opacity higher than overlay opcacity, invert behavior
-                {
-                    alpha = ((alpha - 1.0f) * range_length) + max_alpha;
-                }
-            }
+    if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
+    {
+        Matrix4 mat_pose = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
+        const GazeFadeHMDPose hmd_pose = {mat_pose[12], mat_pose[13], mat_pose[14], mat_pose[8], mat_pose[9], mat_pose[10]};
 
-            //Limit alpha change per frame to smooth out things when abrupt changes happen (i.e. overlay capture took a bit to re-enable or laser pointer forces full alpha)
-            const float prev_alpha = current_overlay.GetOpacity();
-            const float diff = alpha - prev_alpha;
+        m_GazeFadeEvaluator.Evaluate(hmd_pose, m_GazeFadeResults);
 
-            current_overlay.SetOpacity(prev_alpha + clamp(diff, -0.1f, 0.1f));
+        for (const GazeFadeResult& result : m_GazeFadeResults)
+        {
+            OverlayManager::Get().GetOverlay(result.OverlayID).SetOpacity(result.Opacity);
         }
     }
+
+    m_GazeFadeEvaluator.Clear();
 }
 
 void OutputManager::DetachedOverlayGazeFadeAutoConfigure()
@@ -6273,38 +6607,89 @@ bool OutputManager::IsAnyOverlayUsingGazeFade() const
 
 void OutputManager::RegisterHotkeys()
 {
-    //Just unregister all we have when updating any
-    ::UnregisterHotKey(nullptr, 0);
-    ::UnregisterHotKey(nullptr, 1);
-    ::UnregisterHotKey(nullptr, 2);
-    m_IsAnyHotkeyActive = false;
+    //The three hotkeys from the settings are global single-stroke bindings, followed by any additional bindings
+    std::vector<HotkeyBinding> bindings;
+
+    const ConfigID_Int hotkey_config_ids[3][3] = {{configid_int_input_hotkey01_modifiers, configid_int_input_hotkey01_keycode, configid_int_input_hotkey01_action_id},
+                                                  {configid_int_input_hotkey02_modifiers, configid_int_input_hotkey02_keycode, configid_int_input_hotkey02_action_id},
+                                                  {configid_int_input_hotkey03_modifiers, configid_int_input_hotkey03_keycode, configid_int_input_hotkey03_action_id}};
+
+    for (const auto& config_ids : hotkey_config_ids)
+    {
+        HotkeyBinding binding;
+        HotkeyStroke stroke;
+        stroke.Modifiers = (uint8_t)(ConfigManager::Get().GetConfigInt(config_ids[0]) & hotkey_mod_mask);
+        stroke.KeyCode   = (uint8_t)ConfigManager::Get().GetConfigInt(config_ids[1]);
+        binding.Strokes.push_back(stroke);
+        binding.ActionID = ConfigManager::Get().GetConfigInt(config_ids[2]);
+
+        bindings.push_back(binding);
+    }
+
+    const auto& hotkey_bindings = ActionManager::Get().GetHotkeyBindings();
+    bindings.insert(bindings.end(), hotkey_bindings.begin(), hotkey_bindings.end());
+
+    //Unassigned ones would only block the keys
+    bindings.erase(std::remove_if(bindings.begin(), bindings.end(), [](const HotkeyBinding& binding){ return (binding.ActionID == action_none); }), bindings.end());
+
+    m_HotkeyEngine.SetBindings(bindings);
+    m_HotkeyEngine.SetSequenceTimeout((uint32_t)std::max(ConfigManager::Get().GetConfigInt(configid_int_input_hotkey_sequence_timeout_ms), 0));
+    m_HotkeyStrokesDown.clear();
+    m_IsAnyHotkeyActive = !m_HotkeyEngine.GetBindings().empty();
+
+    //Log conflicts so they can be figured out when hotkeys don't behave as expected. Shadowed ones are intended as overrides, so they're not logged
+    for (const HotkeyConflict& conflict : m_HotkeyEngine.FindConflicts())
+    {
+        if (conflict.Type == hotkey_conflict_shadowed)
+            continue;
+
+        const HotkeyBinding& binding_a = m_HotkeyEngine.GetBindings()[conflict.BindingA];
+        const HotkeyBinding& binding_b = m_HotkeyEngine.GetBindings()[conflict.BindingB];
+
+        std::wstringstream ss;
+        ss << L"Hotkey for \"" << WStringConvertFromUTF8(ActionManager::Get().GetActionName((ActionID)binding_a.ActionID)) << L"\" "
+           << ((conflict.Type == hotkey_conflict_duplicate) ? L"is also bound to" : L"is delayed by the longer sequence for")
+           << L" \"" << WStringConvertFromUTF8(ActionManager::Get().GetActionName((ActionID)binding_b.ActionID)) << L"\"";
+
+        ErrorLog::Get().Write(log_severity_warning, ss.str().c_str());
+    }
 
-    //...and register them again if there's an action assigned
-    UINT flags   = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_modifiers);
-    UINT keycode = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_keycode);
+    UpdateRegisteredHotkeys();
+}
 
-    if (ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_action_id) != action_none)
+void OutputManager::UpdateRegisteredHotkeys()
+{
+    //Just unregister all we have when updating any...
+    for (int i = 0; i < (int)m_HotkeyStrokesRegistered.size(); ++i)
     {
-        ::RegisterHotKey(nullptr, 0, flags | MOD_NOREPEAT, keycode);
-        m_IsAnyHotkeyActive = true;
+        ::UnregisterHotKey(nullptr, i);
     }
 
-    flags   = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_modifiers);
-    keycode = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_keycode);
+    //...and register the ones that are expected now. IDs that fail to register are kept so the indices still match, the stroke can still be picked up by HandleHotkeys()
+    m_HotkeyEngine.GetExpectedStrokes(m_HotkeyStrokesRegistered);
+    m_HotkeyEngineStateIDRegistered = m_HotkeyEngine.GetStateID();
 
-    if (ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_action_id) != action_none)
+    for (int i = 0; i < (int)m_HotkeyStrokesRegistered.size(); ++i)
     {
-        ::RegisterHotKey(nullptr, 1, flags | MOD_NOREPEAT, keycode);
-        m_IsAnyHotkeyActive = true;
+        ::RegisterHotKey(nullptr, i, m_HotkeyStrokesRegistered[i].Modifiers | MOD_NOREPEAT, m_HotkeyStrokesRegistered[i].KeyCode);
     }
+}
 
-    flags   = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_modifiers);
-    keycode = ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_keycode);
+void OutputManager::HandleHotkeyStroke(HotkeyStroke stroke)
+{
+    //Only handle the stroke once until it's released. It's removed from the list in HandleHotkeys() when no longer pressed
+    if (std::find(m_HotkeyStrokesDown.begin(), m_HotkeyStrokesDown.end(), stroke) != m_HotkeyStrokesDown.end())
+        return;
 
-    if (ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_action_id) != action_none)
+    m_HotkeyStrokesDown.push_back(stroke);
+
+    m_HotkeyEngine.OnStroke(stroke, ::GetTickCount64(), m_HotkeyTriggered);
+    DoHotkeyActions();
+
+    //Entering or leaving a sequence changes which strokes should be registered
+    if (m_HotkeyEngine.GetStateID() != m_HotkeyEngineStateIDRegistered)
     {
-        ::RegisterHotKey(nullptr, 2, flags | MOD_NOREPEAT, keycode);
-        m_IsAnyHotkeyActive = true;
+        UpdateRegisteredHotkeys();
     }
 }
 
@@ -6317,41 +6702,84 @@ void OutputManager::HandleHotkeys()
     if (!m_IsAnyHotkeyActive)
         return;
 
-    const ActionID action_id[3] = {(ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_action_id),
-                                   (ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_action_id),
-                                   (ActionID)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_action_id)};
+    //Update which scoped bindings are active. Overlay-scoped ones are active while their overlay is enabled, group-scoped ones while any overlay of the group is
+    m_HotkeyActiveGroupIDs.clear();
+    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+    {
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+
+        if (data.ConfigBool[configid_bool_overlay_enabled])
+        {
+            m_HotkeyActiveGroupIDs.push_back(data.ConfigInt[configid_int_overlay_group_id]);
+        }
+    }
+
+    m_HotkeyEngine.UpdateActiveState([&](HotkeyScope scope, int scope_id)
+                                     {
+                                         if (scope == hotkey_scope_overlay)
+                                         {
+                                             return ( (OverlayManager::Get().GetOverlayCount() > (unsigned int)scope_id) && 
+                                                      (OverlayManager::Get().GetConfigData((unsigned int)scope_id).ConfigBool[configid_bool_overlay_enabled]) );
+                                         }
+
+                                         return (std::find(m_HotkeyActiveGroupIDs.begin(), m_HotkeyActiveGroupIDs.end(), scope_id) != m_HotkeyActiveGroupIDs.end());
+                                     });
+
+    //Finish sequences that timed out
+    m_HotkeyEngine.Update(::GetTickCount64(), m_HotkeyTriggered);
+    DoHotkeyActions();
+
+    if (m_HotkeyEngine.GetStateID() != m_HotkeyEngineStateIDRegistered)
+    {
+        UpdateRegisteredHotkeys();
+    }
 
-    const UINT flags[3]         = {(UINT)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_modifiers), 
-                                   (UINT)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_modifiers), 
-                                   (UINT)ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_modifiers)};
+    //Forget released strokes
+    m_HotkeyStrokesDown.erase(std::remove_if(m_HotkeyStrokesDown.begin(), m_HotkeyStrokesDown.end(), [&](HotkeyStroke stroke){ return !IsHotkeyStrokeDown(stroke); }), 
+                              m_HotkeyStrokesDown.end());
 
-    const int keycode[3]        = {ConfigManager::Get().GetConfigInt(configid_int_input_hotkey01_keycode),
-                                   ConfigManager::Get().GetConfigInt(configid_int_input_hotkey02_keycode),
-                                   ConfigManager::Get().GetConfigInt(configid_int_input_hotkey03_keycode)};
+    //Check expected strokes. Copied as handling a stroke can change them
+    m_HotkeyStrokesPoll = m_HotkeyStrokesRegistered;
 
-    for (int i = 0; i < 3; ++i)
+    for (HotkeyStroke stroke : m_HotkeyStrokesPoll)
     {
-        if (action_id[i] != action_none)
+        if (IsHotkeyStrokeDown(stroke))
         {
-            if ( (::GetAsyncKeyState(keycode[i]) < 0) && 
-                 ( ((flags[i] & MOD_SHIFT)   == 0) || (::GetAsyncKeyState(VK_SHIFT)   < 0) ) &&
-                 ( ((flags[i] & MOD_CONTROL) == 0) || (::GetAsyncKeyState(VK_CONTROL) < 0) ) &&
-                 ( ((flags[i] & MOD_ALT)     == 0) || (::GetAsyncKeyState(VK_MENU)    < 0) ) &&
-                 ( ((flags[i] & MOD_WIN)     == 0) || ((::GetAsyncKeyState(VK_LWIN)   < 0) || (::GetAsyncKeyState(VK_RWIN) < 0)) ) )
-            {
-                if (!m_IsHotkeyDown[i])
-                {
-                    m_IsHotkeyDown[i] = true;
+            HandleHotkeyStroke(stroke);
+        }
+    }
+}
 
-                    DoAction(action_id[i]);
-                }
-            }
-            else if (m_IsHotkeyDown[i])
-            {
-                m_IsHotkeyDown[i] = false;
-            }
+bool OutputManager::IsHotkeyStrokeDown(HotkeyStroke stroke) const
+{
+    return ( (::GetAsyncKeyState(stroke.KeyCode) < 0) && 
+             ( ((stroke.Modifiers & MOD_SHIFT)   == 0) || (::GetAsyncKeyState(VK_SHIFT)   < 0) ) &&
+             ( ((stroke.Modifiers & MOD_CONTROL) == 0) || (::GetAsyncKeyState(VK_CONTROL) < 0) ) &&
+             ( ((stroke.Modifiers & MOD_ALT)     == 0) || (::GetAsyncKeyState(VK_MENU)    < 0) ) &&
+             ( ((stroke.Modifiers & MOD_WIN)     == 0) || ((::GetAsyncKeyState(VK_LWIN)   < 0) || (::GetAsyncKeyState(VK_RWIN) < 0)) ) );
+}
+
+void OutputManager::DoHotkeyActions()
+{
+    for (size_t binding_id : m_HotkeyTriggered)
+    {
+        const HotkeyBinding& binding = m_HotkeyEngine.GetBindings()[binding_id];
+
+        //Overlay-scoped bindings do their action as if it was used from that overlay
+        if ( (binding.Scope == hotkey_scope_overlay) && (OverlayManager::Get().GetOverlayCount() > (unsigned int)binding.ScopeID) )
+        {
+            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
+            OverlayManager::Get().SetCurrentOverlayID((unsigned int)binding.ScopeID);
+            DoAction((ActionID)binding.ActionID);
+            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+        }
+        else
+        {
+            DoAction((ActionID)binding.ActionID);
         }
     }
+
+    m_HotkeyTriggered.clear();
 }
 
 void OutputManager::UpdateKeyboardHelperModifierState()
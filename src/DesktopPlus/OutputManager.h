@@ -16,6 +16,10 @@
 #include "BackgroundOverlay.h"
 #include "OUtoSBSConverter.h"
 #include "InterprocessMessaging.h"
+#include "VRStream.h"
+#include "GazeFadeEvaluator.h"
+#include "OverlayConfigBatch.h"
+#include "CursorState.h"
 
 class Overlay;
 //
@@ -33,13 +37,14 @@ class OutputManager
         void CleanRefs();
         DUPL_RETURN InitOutput(HWND Window, _Out_ INT& SingleOutput, _Out_ UINT* OutCount, _Out_ RECT* DeskBounds);
         std::tuple<vr::EVRInitError, vr::EVROverlayError, bool> InitOverlay();  //Returns error state <InitError, OverlayError, VRInputInitSuccess>
-        DUPL_RETURN_UPD Update(_In_ PTR_INFO* PointerInfo, _In_ DPRect& DirtyRegionTotal, bool NewFrame, bool SkipFrame);
+        DUPL_RETURN_UPD Update(_Inout_ PTR_INFO* PointerInfo, bool NewFrame, bool SkipFrame);
         bool HandleIPCMessage(const MSG& msg);    //Returns true if message caused a duplication reset (i.e. desktop switch)
         void HandleWinRTMessage(const MSG& msg);  //Messages sent by the Desktop+ WinRT library
         void HandleHotkeyMessage(const MSG& msg);
 
         HWND GetWindowHandle();
-        HANDLE GetSharedHandle();
+        std::vector<HANDLE> GetOutputSharedHandles();  //Handles of the output surfaces, in the same order as the outputs of GetOutputComposer(). Empty on failure
+        OutputComposer& GetOutputComposer();
         IDXGIAdapter* GetDXGIAdapter(); //Don't forget to call Release() on the returned pointer when done with it
 
         void ResetOverlays();
@@ -72,13 +77,17 @@ class OutputManager
         void DoStopAction(ActionID action_id);
 
         void ToggleOverlayGroupEnabled(int group_id);
+        void CommitOverlayConfigBatch(OverlayConfigBatch& batch);   //Applies and clears the batch. Changed overlays get ApplySettingTransform() once, the UI app a single update
 
-        void UpdatePerformanceStates();
+        void UpdatePerformanceStates(const CursorStateMetrics& cursor_metrics);
+        void UpdateCaptureWorkerBalance();                          //Periodically rebalances the Graphics Capture worker threads
         const LARGE_INTEGER& GetUpdateLimiterDelay();
+        DuplicationWaitPolicy& GetDuplicationWaitPolicy();
+        bool StartVRStreamRecording(const char* path);  //Records the OpenVR events and poses seen by HandleOpenVREvents() until exit, see VRStream.h
         //This updates the cached desktop rects and count and optionally chooses the adapters/desktop for desktop duplication (previously part of InitOutput())
         int EnumerateOutputs(int target_desktop_id = -1, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_preferred = nullptr, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_vr = nullptr);
 
-        void ConvertOUtoSBS(Overlay& overlay, OUtoSBSConverter& converter);
+        void ConvertOUtoSBS(Overlay& overlay, uint64_t& converter_entry_id);   //converter_entry_id is the overlay's last used OUtoSBSConverterCache entry ID, updated when the texture changes
 
     private:
     // Methods
@@ -86,12 +95,14 @@ class OutputManager
         DUPL_RETURN MakeRTV();
         DUPL_RETURN InitShaders();
         DUPL_RETURN CreateTextures(INT SingleOutput, _Out_ UINT* OutCount, _Out_ RECT* DeskBounds);
+        DUPL_RETURN_UPD ComposeOutputs(_Inout_ DPRect& DirtyRectTotal);   //Copies new frames of the output surfaces into m_ComposeTex
         void DrawFrameToOverlayTex(bool clear_rtv = true);
         DUPL_RETURN DrawMouseToOverlayTex(_In_ PTR_INFO* PtrInfo);
         DUPL_RETURN_UPD RefreshOpenVROverlayTexture(DPRect& DirtyRectTotal, bool force_full_copy = false); //Refreshes the overlay texture of the VR runtime with content of the m_OvrlTex backing texture
         bool DesktopTextureAlphaCheck();
 
         bool HandleOpenVREvents();  //Returns true if quit event happened
+        void UpdateDuplicationWaitPolicy(); //Passes the desktop areas shown by visible overlays on to the duplication threads
         void OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned int& current_overlay_old);
         void OnKeyboardClosed();
         void HandleKeyboardHelperMessage(LPARAM lparam);
@@ -134,6 +145,7 @@ class OutputManager
 
         void DetachedInteractionAutoToggle();
         void DetachedOverlayGazeFade();
+        void DetachedOverlayGazeFadeAll();
         void DetachedOverlayGazeFadeAutoConfigure();
         void DetachedOverlayGlobalHMDPointerAll();
 
@@ -142,8 +154,12 @@ class OutputManager
         void DimDashboard(bool do_dim);
         bool IsAnyOverlayUsingGazeFade() const;
 
-        void RegisterHotkeys();
+        void RegisterHotkeys();                             //Rebuilds the hotkey bindings from the config
+        void UpdateRegisteredHotkeys();                     //Registers the strokes the hotkey engine currently expects as system hotkeys
+        void HandleHotkeyStroke(HotkeyStroke stroke);
         void HandleHotkeys();
+        bool IsHotkeyStrokeDown(HotkeyStroke stroke) const;
+        void DoHotkeyActions();                             //Does the actions of the bindings in m_HotkeyTriggered
 
         void UpdateKeyboardHelperModifierState();
 
@@ -163,10 +179,12 @@ class OutputManager
         ID3D11PixelShader* m_PixelShader;
         ID3D11PixelShader* m_PixelShaderCursor;
         ID3D11InputLayout* m_InputLayout;
-        ID3D11Texture2D* m_SharedSurf;
+        ID3D11Texture2D* m_ComposeTex;          //Combined desktop image, only used by the main thread
         ID3D11Buffer* m_VertexBuffer;
         ID3D11ShaderResourceView* m_ShaderResource;
-        IDXGIKeyedMutex* m_KeyMutex;
+        std::vector<ID3D11Texture2D*> m_OutputSurfs;         //Shared with the duplication thread of each output
+        std::vector<IDXGIKeyedMutex*> m_OutputKeyMutexes;
+        OutputComposer m_OutputComposer;
         HWND m_WindowHandle;
         //These handles are not created or closed by this class, they're valid for the entire runtime though
         HANDLE m_PauseDuplicationEvent;
@@ -240,12 +258,34 @@ class OutputManager
         ID3D11Texture2D* m_MultiGPUTexStaging;  //Staging texture, owned by m_Device
         ID3D11Texture2D* m_MultiGPUTexTarget;   //Target texture to copy to, owned by m_MultiGPUTargetDevice
 
+        OUtoSBSConverterCache m_OUtoSBSConverterCache; //Conversions of m_OvrlTex for overlays using ovrl_texsource_desktop_duplication_3dou_converted
+        VRStreamRecorder m_VRStreamRecorder;
+
         int m_PerformanceFrameCount;
         ULONGLONG m_PerformanceFrameCountStartTick;
         LARGE_INTEGER m_PerformanceUpdateLimiterDelay;
-
+        uint64_t m_PerformanceDuplicationWakeupCountLast;
+        ULONGLONG m_CaptureWorkerRebalanceTick;
+        unsigned long long m_PerformanceWindowCacheHitCountLast;
+        unsigned long long m_PerformanceWindowCacheFallbackCountLast;
+        uint64_t m_PerformanceTransformSubmittedCountLast;
+        uint64_t m_PerformanceTransformSkippedCountLast;
+        CursorStateMetrics m_PerformanceCursorMetricsLast;
+
+        DuplicationWaitPolicy m_DuplicationWaitPolicy;
+        std::vector<DuplicationWaitRect> m_DuplicationVisibleRects;
+
+        GazeFadeEvaluator m_GazeFadeEvaluator;
+        std::vector<GazeFadeResult> m_GazeFadeResults;
+
+        HotkeyEngine m_HotkeyEngine;
+        uint32_t m_HotkeyEngineStateIDRegistered;
+        std::vector<HotkeyStroke> m_HotkeyStrokesRegistered;  //Index is the system hotkey ID
+        std::vector<HotkeyStroke> m_HotkeyStrokesDown;        //Blocks HandleHotkeys() and the hotkey messages from handling the same stroke twice
+        std::vector<HotkeyStroke> m_HotkeyStrokesPoll;
+        std::vector<size_t> m_HotkeyTriggered;
+        std::vector<int> m_HotkeyActiveGroupIDs;
         bool m_IsAnyHotkeyActive;
-        bool m_IsHotkeyDown[3];
 };
 
 #endif
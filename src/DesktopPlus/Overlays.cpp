@@ -5,6 +5,7 @@
 #include "CommonTypes.h"
 #include "OverlayManager.h"
 #include "OutputManager.h"
+#include "OverlayTransformCache.h"
 #include "DesktopPlusWinRT.h"
 
 Overlay::Overlay(unsigned int id) : m_ID(id),
@@ -12,7 +13,8 @@ Overlay::Overlay(unsigned int id) : m_ID(id),
                                     m_Visible(false),
                                     m_Opacity(1.0f),
                                     m_GlobalInteractive(false),
-                                    m_TextureSource(ovrl_texsource_desktop_duplication)
+                                    m_TextureSource(ovrl_texsource_desktop_duplication),
+                                    m_OUtoSBSConverterEntryID(0)
 {
     //Don't call InitOverlay when OpenVR isn't loaded yet. This happens during startup when loading the config and will be fixed up by OutputManager::InitOverlay() afterwards
     if (vr::VROverlay() != nullptr)
@@ -39,6 +41,7 @@ Overlay& Overlay::operator=(Overlay&& b)
             }
 
             vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
+            OverlayTransformCache::Get().Invalidate(m_OvrlHandle);
         }
 
         m_ID = b.m_ID;
@@ -48,7 +51,7 @@ Overlay& Overlay::operator=(Overlay&& b)
         m_ValidatedCropRect = b.m_ValidatedCropRect;
         m_GlobalInteractive = b.m_GlobalInteractive;
         m_TextureSource = b.m_TextureSource;
-        //m_OUtoSBSConverter should just be left alone, it only holds cached state anyways
+        m_OUtoSBSConverterEntryID = b.m_OUtoSBSConverterEntryID; //Belongs to the overlay handle, so it moves along with it
 
         b.m_OvrlHandle = vr::k_ulOverlayHandleInvalid;
     }
@@ -66,6 +69,7 @@ Overlay::~Overlay()
         }
 
         vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
+        OverlayTransformCache::Get().Invalidate(m_OvrlHandle);
     }
 }
 
@@ -301,7 +305,7 @@ void Overlay::SetTextureSource(OverlayTextureSource tex_source)
     //Cleanup old sources if needed
     switch (m_TextureSource)
     {
-        case ovrl_texsource_desktop_duplication_3dou_converted: m_OUtoSBSConverter.CleanRefs();    break;
+        case ovrl_texsource_desktop_duplication_3dou_converted: m_OUtoSBSConverterEntryID = 0;     break; //Cache entry is dropped by OutputManager once unused
         case ovrl_texsource_winrt_capture:                      DPWinRT_StopCapture(m_OvrlHandle); break;
         case ovrl_texsource_ui:
         {
@@ -343,6 +347,6 @@ void Overlay::OnDesktopDuplicationUpdate()
 {
     if ( (m_Visible) && (m_TextureSource == ovrl_texsource_desktop_duplication_3dou_converted) )
     {
-        OutputManager::Get()->ConvertOUtoSBS(*this, m_OUtoSBSConverter);
+        OutputManager::Get()->ConvertOUtoSBS(*this, m_OUtoSBSConverterEntryID);
     }
 }
@@ -2,7 +2,6 @@
 
 #include "openvr.h"
 #include "DPRect.h"
-#include "OUtoSBSConverter.h"
 
 //About the Overlay class:
 //Overlay 0 (k_ulOverlayID_Dashboard) is the dashboard overlay. It always exists and is safe to access/returned when trying to access an invalid overlay id.
@@ -33,7 +32,7 @@ class Overlay
         bool m_GlobalInteractive;             //True if VROverlayFlags_MakeOverlaysInteractiveIfVisible is set for this overlay
         DPRect m_ValidatedCropRect;           //Validated cropping rectangle used in OutputManager::Update() to check against dirty update regions
         OverlayTextureSource m_TextureSource;
-        OUtoSBSConverter m_OUtoSBSConverter;
+        uint64_t m_OUtoSBSConverterEntryID;   //ID of the shared OUtoSBSConverterCache entry whose texture is currently set on the overlay, 0 if none
 
     public:
         Overlay(unsigned int id);
@@ -0,0 +1,208 @@
+#include "PerformanceTrace.h"
+
+#include <algorithm>
+#include <fstream>
+
+static PerformanceTrace g_PerformanceTrace;
+
+//Returns the thread's ring to the pool when the thread exits, so short-lived threads don't accumulate rings
+class PerformanceTraceThreadRingHolder
+{
+    public:
+        PerformanceTraceRing* Ring = nullptr;
+
+        ~PerformanceTraceThreadRingHolder()
+        {
+            if (Ring != nullptr)
+            {
+                Ring->IsInUse.store(false, std::memory_order_release);
+            }
+        }
+};
+
+static thread_local PerformanceTraceThreadRingHolder t_RingHolder;
+
+PerformanceTrace& PerformanceTrace::Get()
+{
+    return g_PerformanceTrace;
+}
+
+PerformanceTrace::PerformanceTrace() : m_IsEnabled(false), m_StartTime(std::chrono::steady_clock::now()), m_HistoryOffset(0)
+{
+}
+
+PerformanceTraceRing* PerformanceTrace::AcquireRing()
+{
+    std::lock_guard<std::mutex> lock(m_RingsMutex);
+
+    //Reuse ring of a thread that has exited
+    for (auto& ring : m_Rings)
+    {
+        bool in_use = false;
+        if (ring->IsInUse.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+        {
+            return ring.get();
+        }
+    }
+
+    m_Rings.push_back(std::make_unique<PerformanceTraceRing>());
+    PerformanceTraceRing* ring = m_Rings.back().get();
+    ring->ThreadID = (uint16_t)m_Rings.size();
+    ring->IsInUse  = true;
+
+    return ring;
+}
+
+void PerformanceTrace::SetEnabled(bool is_enabled)
+{
+    m_IsEnabled.store(is_enabled, std::memory_order_relaxed);
+}
+
+uint64_t PerformanceTrace::GetTimestampUS() const
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_StartTime).count();
+}
+
+void PerformanceTrace::AddEvent(PerformanceTraceStage stage, uint64_t start_us, uint64_t end_us)
+{
+    PerformanceTraceRing* ring = t_RingHolder.Ring;
+
+    if (ring == nullptr)
+    {
+        ring = AcquireRing();
+        t_RingHolder.Ring = ring;
+    }
+
+    //Only this thread writes, so a relaxed load of our own index is enough
+    uint32_t write_index = ring->WriteIndex.load(std::memory_order_relaxed);
+
+    //Mark the slot as being written before touching the event, then publish its sequence number once it's complete
+    PerformanceTraceRingSlot& slot = ring->Slots[write_index & (PerformanceTraceRing::Size - 1)];
+    slot.Sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.StartUS.store(start_us, std::memory_order_relaxed);
+    slot.DurationUS.store((uint32_t)std::min<uint64_t>(end_us - start_us, UINT32_MAX), std::memory_order_relaxed);
+    slot.Stage.store((uint16_t)stage, std::memory_order_relaxed);
+
+    slot.Sequence.store(write_index + 1, std::memory_order_release);
+    ring->WriteIndex.store(write_index + 1, std::memory_order_release);
+}
+
+void PerformanceTrace::Drain()
+{
+    std::lock_guard<std::mutex> lock(m_RingsMutex);
+
+    for (auto& ring : m_Rings)
+    {
+        uint32_t write_index = ring->WriteIndex.load(std::memory_order_acquire);
+
+        //Skip events that have already been overwritten
+        if (write_index - ring->ReadIndex > PerformanceTraceRing::Size)
+        {
+            ring->ReadIndex = write_index - PerformanceTraceRing::Size;
+        }
+
+        for (; ring->ReadIndex != write_index; ++ring->ReadIndex)
+        {
+            const PerformanceTraceRingSlot& slot = ring->Slots[ring->ReadIndex & (PerformanceTraceRing::Size - 1)];
+
+            //The owning thread may be overwriting the slot while it's copied. Drop the event if the sequence number isn't the expected one before and after
+            const uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+
+            if (sequence != ring->ReadIndex + 1)
+                continue;
+
+            PerformanceTraceEvent trace_event;
+            trace_event.StartUS    = slot.StartUS.load(std::memory_order_relaxed);
+            trace_event.DurationUS = slot.DurationUS.load(std::memory_order_relaxed);
+            trace_event.Stage      = slot.Stage.load(std::memory_order_relaxed);
+            trace_event.ThreadID   = ring->ThreadID;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if ( (slot.Sequence.load(std::memory_order_relaxed) != sequence) || (trace_event.Stage >= perftrace_MAX) )
+                continue;
+
+            m_Durations[trace_event.Stage].push_back(trace_event.DurationUS);
+
+            if (m_History.size() < MaxHistorySize)
+            {
+                m_History.push_back(trace_event);
+            }
+            else
+            {
+                m_History[m_HistoryOffset] = trace_event;
+                m_HistoryOffset = (m_HistoryOffset + 1) % MaxHistorySize;
+            }
+        }
+    }
+}
+
+void PerformanceTrace::Collect(PerformanceTraceStageStats (&stats_out)[perftrace_MAX])
+{
+    Drain();
+
+    for (int i = 0; i < perftrace_MAX; ++i)
+    {
+        std::vector<uint32_t>& durations = m_Durations[i];
+        PerformanceTraceStageStats& stats = stats_out[i];
+
+        stats.Count = (uint32_t)durations.size();
+        stats.P50US = 0;
+        stats.P99US = 0;
+
+        if (durations.empty())
+            continue;
+
+        //nth_element() partitions around the element, so the p99 search only has to look at the upper half afterwards
+        auto it_p50 = durations.begin() + (durations.size() / 2);
+        auto it_p99 = durations.begin() + std::min((durations.size() * 99) / 100, durations.size() - 1);
+
+        std::nth_element(durations.begin(), it_p50, durations.end());
+        stats.P50US = *it_p50;
+
+        std::nth_element(it_p50, it_p99, durations.end());
+        stats.P99US = *it_p99;
+
+        durations.clear();
+    }
+}
+
+bool PerformanceTrace::DumpChromeTrace(const char* path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+
+    if (!file.good())
+        return false;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (size_t i = 0; i < m_History.size(); ++i)
+    {
+        const PerformanceTraceEvent& trace_event = m_History[(m_HistoryOffset + i) % m_History.size()];
+
+        //Complete events ("ph":"X") with timestamps and durations in microseconds
+        file << ((i != 0) ? ",\n" : "\n") << "{\"name\":\"" << GetStageName((PerformanceTraceStage)trace_event.Stage) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace_event.ThreadID
+             << ",\"ts\":" << trace_event.StartUS << ",\"dur\":" << trace_event.DurationUS << "}";
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+const char* PerformanceTrace::GetStageName(PerformanceTraceStage stage)
+{
+    switch (stage)
+    {
+        case perftrace_update:                  return "Update";
+        case perftrace_handle_vr_events:        return "HandleOpenVREvents";
+        case perftrace_draw_frame:              return "DrawFrameToOverlayTex";
+        case perftrace_draw_mouse:              return "DrawMouseToOverlayTex";
+        case perftrace_refresh_overlay_texture: return "RefreshOpenVROverlayTexture";
+        case perftrace_dupl_get_frame:          return "DuplicationGetFrame";
+        case perftrace_dupl_process_frame:      return "DuplicationProcessFrame";
+        default:                                return "Unknown";
+    }
+}
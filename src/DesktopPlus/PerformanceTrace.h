@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Lightweight timing of hot code paths in the dashboard process
+//Stages are recorded into per-thread rings by PerformanceTraceScope and aggregated on the main thread by PerformanceTrace::Collect()
+//Kept free of Windows headers so it can be used and tested anywhere
+
+enum PerformanceTraceStage
+{
+    perftrace_update,                   //OutputManager::Update()
+    perftrace_handle_vr_events,         //OutputManager::HandleOpenVREvents()
+    perftrace_draw_frame,               //OutputManager::DrawFrameToOverlayTex()
+    perftrace_draw_mouse,               //OutputManager::DrawMouseToOverlayTex()
+    perftrace_refresh_overlay_texture,  //OutputManager::RefreshOpenVROverlayTexture()
+    perftrace_dupl_get_frame,           //DUPLICATIONMANAGER::GetFrame() on a duplication thread, after AcquireNextFrame() returned a frame
+    perftrace_dupl_process_frame,       //DISPLAYMANAGER::ProcessFrame() on a duplication thread
+    perftrace_MAX
+};
+
+struct PerformanceTraceEvent
+{
+    uint64_t StartUS    = 0;            //Microseconds since PerformanceTrace was created
+    uint32_t DurationUS = 0;
+    uint16_t Stage      = perftrace_MAX;
+    uint16_t ThreadID   = 0;            //Small sequential ID of the recording ring, not the OS thread ID
+};
+
+struct PerformanceTraceStageStats
+{
+    uint32_t Count = 0;                 //Events since the last Collect() call
+    uint32_t P50US = 0;
+    uint32_t P99US = 0;
+};
+
+//Event storage in the ring. The fields are atomics so the collector can read a slot the owning thread is overwriting at the same time
+//Relaxed atomic loads and stores compile to plain moves on x86, so this doesn't cost anything over plain fields
+struct PerformanceTraceRingSlot
+{
+    std::atomic<uint32_t> Sequence{0};  //Ring write index + 1 of the event in the slot, 0 while it's being written
+    std::atomic<uint64_t> StartUS{0};
+    std::atomic<uint32_t> DurationUS{0};
+    std::atomic<uint16_t> Stage{perftrace_MAX};
+};
+
+//Single-producer single-consumer ring owned by one thread while it's in use
+//Events older than the ring size are dropped if the collector falls behind
+//Each slot carries a sequence number which the collector checks before and after copying an event, dropping it if it was overwritten in the meantime
+struct PerformanceTraceRing
+{
+    static const uint32_t Size = 4096;  //Must be a power of 2
+
+    PerformanceTraceRingSlot Slots[Size];
+    std::atomic<uint32_t> WriteIndex{0};
+    uint32_t ReadIndex  = 0;            //Only accessed by the collector
+    uint16_t ThreadID   = 0;
+    std::atomic<bool> IsInUse{false};
+};
+
+class PerformanceTrace
+{
+    private:
+        std::atomic<bool> m_IsEnabled;
+        std::chrono::steady_clock::time_point m_StartTime;
+
+        std::mutex m_RingsMutex;                                    //Protects m_Rings vector, not the ring contents
+        std::vector< std::unique_ptr<PerformanceTraceRing> > m_Rings;
+
+        //- Only accessed by the collector thread
+        std::vector<uint32_t> m_Durations[perftrace_MAX];                   //Durations drained since the last Collect() call
+        std::vector<PerformanceTraceEvent> m_History;               //Most recent events for DumpChromeTrace(), oldest first
+        size_t m_HistoryOffset;                                     //Index of the oldest element once m_History is full
+
+        PerformanceTraceRing* AcquireRing();
+
+    public:
+        static const size_t MaxHistorySize = 32768;
+
+        static PerformanceTrace& Get();
+        PerformanceTrace();
+
+        void SetEnabled(bool is_enabled);
+        bool IsEnabled() const { return m_IsEnabled.load(std::memory_order_relaxed); }
+
+        uint64_t GetTimestampUS() const;
+        void AddEvent(PerformanceTraceStage stage, uint64_t start_us, uint64_t end_us);   //Any thread
+
+        //- Collector thread (main thread in practice)
+        void Drain();                                                                   //Moves events from all rings into the history and the pending stats
+        void Collect(PerformanceTraceStageStats (&stats_out)[perftrace_MAX]);            //Drains all rings and computes stats for the events since the last call
+        bool DumpChromeTrace(const char* path) const;                                   //Writes the event history in Chrome's trace event JSON format (chrome://tracing, Perfetto)
+        static const char* GetStageName(PerformanceTraceStage stage);
+};
+
+//Records the time between construction and destruction as one event of the given stage
+//Costs a single relaxed atomic load while tracing is disabled
+class PerformanceTraceScope
+{
+    private:
+        PerformanceTraceStage m_Stage;
+        uint64_t m_StartUS;
+        bool m_IsActive;
+
+    public:
+        PerformanceTraceScope(PerformanceTraceStage stage) : m_Stage(stage), m_StartUS(0), m_IsActive(PerformanceTrace::Get().IsEnabled())
+        {
+            if (m_IsActive)
+                m_StartUS = PerformanceTrace::Get().GetTimestampUS();
+        }
+
+        ~PerformanceTraceScope()
+        {
+            if (m_IsActive)
+                PerformanceTrace::Get().AddEvent(m_Stage, m_StartUS, PerformanceTrace::Get().GetTimestampUS());
+        }
+
+        void Cancel() { m_IsActive = false; }   //Discard the event, e.g. when the traced call turned out to be a no-op
+
+        PerformanceTraceScope(const PerformanceTraceScope&) = delete;
+        PerformanceTraceScope& operator=(const PerformanceTraceScope&) = delete;
+};
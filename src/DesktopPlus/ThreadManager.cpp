@@ -2,7 +2,9 @@
 
 DWORD WINAPI CaptureThreadEntry(_In_ void* Param);
 
-THREADMANAGER::THREADMANAGER() : m_ThreadCount(0),
+THREADMANAGER::THREADMANAGER() : m_PtrInfoShapeID(0),
+                                 m_WaitPolicy(nullptr),
+                                 m_ThreadCount(0),
                                  m_ThreadHandles(nullptr),
                                  m_ThreadData(nullptr)
 {
@@ -19,12 +21,10 @@ THREADMANAGER::~THREADMANAGER()
 //
 void THREADMANAGER::Clean()
 {
-    if (m_PtrInfo.PtrShapeBuffer)
-    {
-        delete [] m_PtrInfo.PtrShapeBuffer;
-        m_PtrInfo.PtrShapeBuffer = nullptr;
-    }
+    //Threads are terminated at this point, so nothing is accessing the cursor state
+    m_CursorState.Reset();
     RtlZeroMemory(&m_PtrInfo, sizeof(m_PtrInfo));
+    m_PtrInfoShapeID = 0;
 
     if (m_ThreadHandles)
     {
@@ -99,8 +99,19 @@ void THREADMANAGER::CleanDx(_Inout_ DX_RESOURCES* Data)
 //
 DUPL_RETURN THREADMANAGER::Initialize(INT SingleOutput, UINT OutputCount, HANDLE UnexpectedErrorEvent, HANDLE ExpectedErrorEvent, HANDLE NewFrameProcessedEvent,
                                       HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicationEvent, HANDLE TerminateThreadsEvent,
-                                      HANDLE SharedHandle, _In_ RECT* DesktopDim, IDXGIAdapter* DXGIAdapter, bool WMRIgnoreVScreens)
+                                      const std::vector<HANDLE>& SharedHandles, OutputComposer& Composer, _In_ RECT* DesktopDim, IDXGIAdapter* DXGIAdapter,
+                                      bool WMRIgnoreVScreens, DuplicationWaitPolicy* WaitPolicy)
 {
+    //Each thread writes into the surface of its own output
+    if ( (SharedHandles.size() < OutputCount) || (Composer.GetOutputCount() < OutputCount) )
+    {
+        if (DXGIAdapter != nullptr)
+            DXGIAdapter->Release();
+
+        return ProcessFailure(nullptr, L"Output surface count doesn't match output count", L"Desktop+ Error", E_FAIL);
+    }
+
+    m_WaitPolicy = WaitPolicy;
     m_ThreadCount = OutputCount;
     m_ThreadHandles = new (std::nothrow) HANDLE[m_ThreadCount];
     m_ThreadData = new (std::nothrow) THREAD_DATA[m_ThreadCount];
@@ -120,12 +131,13 @@ DUPL_RETURN THREADMANAGER::Initialize(INT SingleOutput, UINT OutputCount, HANDLE
         m_ThreadData[i].ResumeDuplicationEvent = ResumeDuplicationEvent;
         m_ThreadData[i].TerminateThreadsEvent = TerminateThreadsEvent;
         m_ThreadData[i].Output = (SingleOutput < 0) ? i : SingleOutput;
-        m_ThreadData[i].TexSharedHandle = SharedHandle;
+        m_ThreadData[i].TexSharedHandle = SharedHandles[i];
         m_ThreadData[i].OffsetX = DesktopDim->left;
         m_ThreadData[i].OffsetY = DesktopDim->top;
-        m_ThreadData[i].PtrInfo = &m_PtrInfo;
-        m_ThreadData[i].DirtyRegionTotal = &m_DirtyRegionTotal;
+        m_ThreadData[i].Cursor = &m_CursorState;
+        m_ThreadData[i].Compose = &Composer.GetOutput(i);
         m_ThreadData[i].WMRIgnoreVScreens = WMRIgnoreVScreens;
+        m_ThreadData[i].WaitPolicy = WaitPolicy;
 
         RtlZeroMemory(&m_ThreadData[i].DxRes, sizeof(DX_RESOURCES));
         Ret = InitializeDx(&m_ThreadData[i].DxRes, DXGIAdapter);
@@ -241,16 +253,34 @@ DUPL_RETURN THREADMANAGER::InitializeDx(_Out_ DX_RESOURCES* Data, IDXGIAdapter*
 }
 
 //
-// Getter for the PTR_INFO structure
+// Reads the latest cursor state into the PTR_INFO structure
 //
 PTR_INFO* THREADMANAGER::GetPointerInfo()
 {
+    const BYTE* ShapeBuffer;
+    const CursorStateData& Cursor = m_CursorState.Read(ShapeBuffer);
+
+    m_PtrInfo.PtrShapeBuffer = (Cursor.ShapeSize != 0) ? ShapeBuffer : nullptr;
+    m_PtrInfo.BufferSize     = Cursor.ShapeSize;
+    m_PtrInfo.ShapeInfo      = {Cursor.ShapeInfo.Type, Cursor.ShapeInfo.Width, Cursor.ShapeInfo.Height, Cursor.ShapeInfo.Pitch, {Cursor.ShapeInfo.HotSpotX, Cursor.ShapeInfo.HotSpotY}};
+    m_PtrInfo.Position       = {Cursor.PositionX, Cursor.PositionY};
+    m_PtrInfo.Visible        = Cursor.Visible;
+    m_PtrInfo.WhoUpdatedPositionLast = Cursor.WhoUpdatedPositionLast;
+    m_PtrInfo.LastTimeStamp.QuadPart = Cursor.LastTimeStamp;
+
+    //Shape changes are kept flagged until the reader resets it, as it may skip processing the update this time
+    if (Cursor.ShapeID != m_PtrInfoShapeID)
+    {
+        m_PtrInfo.CursorShapeChanged = true;
+        m_PtrInfoShapeID = Cursor.ShapeID;
+    }
+
     return &m_PtrInfo;
 }
 
-DPRect& THREADMANAGER::GetDirtyRegionTotal()
+CursorStateMetrics THREADMANAGER::GetCursorStateMetrics() const
 {
-    return m_DirtyRegionTotal;
+    return m_CursorState.GetMetrics();
 }
 
 //
@@ -260,6 +290,12 @@ void THREADMANAGER::WaitForThreadTermination()
 {
     if (m_ThreadCount != 0)
     {
+        //End idle waits so the threads see the terminate event
+        if (m_WaitPolicy)
+        {
+            m_WaitPolicy->Wake();
+        }
+
         WaitForMultipleObjectsEx(m_ThreadCount, m_ThreadHandles, TRUE, INFINITE, FALSE);
     }
 }
@@ -11,17 +11,20 @@ class THREADMANAGER
         void Clean();
         DUPL_RETURN Initialize(INT SingleOutput, UINT OutputCount, HANDLE UnexpectedErrorEvent, HANDLE ExpectedErrorEvent, HANDLE NewFrameProcessedEvent,
                                HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicationEvent, HANDLE TerminateThreadsEvent,
-                               HANDLE SharedHandle, _In_ RECT* DesktopDim, IDXGIAdapter* DXGIAdapter, bool WMRIgnoreVScreens);
-        PTR_INFO* GetPointerInfo();         //Should only be called when shared surface mutex has be aquired
-        DPRect& GetDirtyRegionTotal();      //Should only be called when shared surface mutex has be aquired
+                               const std::vector<HANDLE>& SharedHandles, OutputComposer& Composer, _In_ RECT* DesktopDim, IDXGIAdapter* DXGIAdapter, bool WMRIgnoreVScreens,
+                               DuplicationWaitPolicy* WaitPolicy);
+        PTR_INFO* GetPointerInfo();         //Reads the latest cursor state. Main thread only, the returned info stays valid until the next call
+        CursorStateMetrics GetCursorStateMetrics() const;
         void WaitForThreadTermination();
 
     private:
         DUPL_RETURN InitializeDx(_Out_ DX_RESOURCES* Data, IDXGIAdapter* DXGIAdapter); //Doesn't Release() the DXGIAdapter
         void CleanDx(_Inout_ DX_RESOURCES* Data);
 
-        PTR_INFO m_PtrInfo;
-        DPRect m_DirtyRegionTotal;
+        CursorState m_CursorState;
+        PTR_INFO m_PtrInfo;                 //Main thread's copy of the last read cursor state
+        UINT m_PtrInfoShapeID;
+        DuplicationWaitPolicy* m_WaitPolicy;
         UINT m_ThreadCount;
         _Field_size_(m_ThreadCount) HANDLE* m_ThreadHandles;
         _Field_size_(m_ThreadCount) THREAD_DATA* m_ThreadData;
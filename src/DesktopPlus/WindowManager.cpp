@@ -9,6 +9,7 @@
 #include "InterprocessMessaging.h"
 #include "InputSimulator.h"
 #include "Util.h"
+#include "DesktopPlusWinRT.h"
 
 WindowManager g_WindowManager;
 
@@ -27,6 +28,7 @@ void WindowManager::UpdateConfigState()
 	thread_data_new.KeepOnScreen    = ConfigManager::Get().GetConfigBool(configid_bool_windows_winrt_keep_on_screen);
 	thread_data_new.TargetWindow    = m_TargetWindow;
 	thread_data_new.TargetOverlayID = m_TargetOverlayID;
+	thread_data_new.CaptureWindows  = m_CaptureWindows;
 
     if (m_IsActive)
     {
@@ -86,6 +88,12 @@ HWND WindowManager::GetTargetWindow() const
 	return m_TargetWindow;
 }
 
+void WindowManager::SetCaptureWindows(const std::vector<HWND>& windows)
+{
+	m_CaptureWindows = windows;
+	UpdateConfigState();
+}
+
 void WindowManager::SetActive(bool is_active)
 {
 	m_IsActive = is_active;
@@ -224,6 +232,24 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
 
 		return;
 	}
+	else if (win_event == EVENT_SYSTEM_FOREGROUND)
+	{
+		//Only used to feed the capture window state cache
+		DPWinRT_OnWindowForegroundChanged(hwnd);
+		return;
+	}
+	else if ( (win_event == EVENT_OBJECT_LOCATIONCHANGE) && (hwnd != nullptr) && (id_object == OBJID_WINDOW) && (id_child == CHILDID_SELF) )
+	{
+		//Feed the capture window state cache if it's a captured window. The hooks for those also get events from other windows of the same thread
+		//Skip the rest unless drag blocking needs it
+		if (std::find(m_ThreadLocalData.CaptureWindows.begin(), m_ThreadLocalData.CaptureWindows.end(), hwnd) != m_ThreadLocalData.CaptureWindows.end())
+		{
+			DPWinRT_OnWindowLocationChanged(hwnd);
+		}
+
+		if (!m_ThreadLocalData.BlockDrag)
+			return;
+	}
 
 	//Limit the rest to visible top-level window events
     if ( (hwnd == nullptr) || (id_object != OBJID_WINDOW) || (id_child != CHILDID_SELF) || (GetWindowTextLength(hwnd) == 0) || 
@@ -332,7 +358,8 @@ void WindowManager::WindowManager::WinEventProc(HWINEVENTHOOK /*event_hook_handl
     Get().HandleWinEvent(win_event, hwnd, id_object, id_child, event_thread, event_time);
 }
 
-void WindowManager::ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change)
+void WindowManager::ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change, 
+									 HWINEVENTHOOK& hook_handle_foreground_change, std::vector<WindowManagerThreadHook>& hooks_capture_location_change)
 {
 	if ( (m_ThreadLocalData.BlockDrag) && (hook_handle_move_size == nullptr) )
 	{
@@ -350,6 +377,76 @@ void WindowManager::ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINE
 		hook_handle_location_change = nullptr;
 	}
 
+	//Foreground and location changes of captured windows feed the capture window state cache, which is only needed while there are window captures
+	//The foreground hook doesn't skip our own process since the dashboard app's windows can be foreground windows too
+	const bool use_window_state_cache = !m_ThreadLocalData.CaptureWindows.empty();
+
+	if ( (use_window_state_cache) && (hook_handle_foreground_change == nullptr) )
+	{
+		hook_handle_foreground_change = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, WindowManager::WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+	}
+	else if ( (!use_window_state_cache) && (hook_handle_foreground_change != nullptr) )
+	{
+		UnhookWinEvent(hook_handle_foreground_change);
+		hook_handle_foreground_change = nullptr;
+	}
+
+	//Location changes are hooked per thread of the captured windows instead of system-wide, unless the drag blocking hook already covers every window
+	std::vector<WindowManagerThreadHook> hooks_capture_location_change_new;
+	std::vector<HWND> watched_windows;
+
+	if (use_window_state_cache)
+	{
+		for (HWND window : m_ThreadLocalData.CaptureWindows)
+		{
+			if (hook_handle_location_change != nullptr)
+			{
+				watched_windows.push_back(window);
+				continue;
+			}
+
+			DWORD process_id = 0;
+			DWORD thread_id  = ::GetWindowThreadProcessId(window, &process_id);
+
+			if (thread_id == 0) //Window is gone
+				continue;
+
+			auto find_thread = [&](const WindowManagerThreadHook& hook){ return (hook.ThreadID == thread_id); };
+			auto it = std::find_if(hooks_capture_location_change.begin(), hooks_capture_location_change.end(), find_thread);
+
+			if (it != hooks_capture_location_change.end()) //Keep existing hook
+			{
+				hooks_capture_location_change_new.push_back(*it);
+				hooks_capture_location_change.erase(it);
+			}
+			else if (std::find_if(hooks_capture_location_change_new.begin(), hooks_capture_location_change_new.end(), find_thread) == hooks_capture_location_change_new.end())
+			{
+				WindowManagerThreadHook hook;
+				hook.ThreadID   = thread_id;
+				hook.HookHandle = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, nullptr, WindowManager::WinEventProc, process_id, thread_id,
+												  WINEVENT_OUTOFCONTEXT);
+
+				if (hook.HookHandle == nullptr)
+					continue;
+
+				hooks_capture_location_change_new.push_back(hook);
+			}
+
+			watched_windows.push_back(window);
+		}
+	}
+
+	//Remove hooks for threads without captured windows
+	for (const WindowManagerThreadHook& hook : hooks_capture_location_change)
+	{
+		UnhookWinEvent(hook.HookHandle);
+	}
+
+	hooks_capture_location_change = hooks_capture_location_change_new;
+
+	DPWinRT_SetWindowStateCacheWatchedWindows(watched_windows.data(), (unsigned int)watched_windows.size());
+	DPWinRT_SetWindowStateCacheActive(hook_handle_foreground_change != nullptr);
+
 	if (hook_handle_focus_change == nullptr)
 	{
 		//Set initial elevated process focus state beforehand
@@ -390,8 +487,10 @@ DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 	HWINEVENTHOOK hook_handle_move_size		  = nullptr;
 	HWINEVENTHOOK hook_handle_location_change = nullptr;
 	HWINEVENTHOOK hook_handle_focus_change	  = nullptr;
+	HWINEVENTHOOK hook_handle_foreground_change = nullptr;
+	std::vector<WindowManagerThreadHook> hooks_capture_location_change;
 	
-	Get().ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
+	Get().ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change, hook_handle_foreground_change, hooks_capture_location_change);
 
 	//Wait for callbacks, update or quit message
 	MSG msg;
@@ -417,7 +516,7 @@ DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 				wman.m_ThreadLocalData = wman.m_ThreadData;
 			}
 
-			wman.ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
+			wman.ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change, hook_handle_foreground_change, hooks_capture_location_change);
 
 			//Notify main thread we're done
 			{
@@ -428,9 +527,18 @@ DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 		}
 	}
 
+	//Stop captures from relying on the cache before the hooks feeding it are gone
+	DPWinRT_SetWindowStateCacheActive(false);
+
 	UnhookWinEvent(hook_handle_move_size);
 	UnhookWinEvent(hook_handle_location_change);
 	UnhookWinEvent(hook_handle_focus_change);
+	UnhookWinEvent(hook_handle_foreground_change);
+
+	for (const WindowManagerThreadHook& hook : hooks_capture_location_change)
+	{
+		UnhookWinEvent(hook.HookHandle);
+	}
 
 	return 0;
 }
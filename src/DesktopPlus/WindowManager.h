@@ -4,6 +4,7 @@
 #include <windows.h>
 
 #include <mutex>
+#include <vector>
 
 #include "OverlayManager.h"
 
@@ -14,6 +15,7 @@ struct WindowManagerThreadData
     bool KeepOnScreen = false;
     HWND TargetWindow = nullptr;
     unsigned int TargetOverlayID = k_ulOverlayID_Dashboard;
+    std::vector<HWND> CaptureWindows;   //Source windows of WinRT captures, which location changes are hooked for to feed the capture window state cache
 
     bool operator==(const WindowManagerThreadData b)
     {
@@ -21,7 +23,8 @@ struct WindowManagerThreadData
                  (DoOverlayDrag == b.DoOverlayDrag) &&
                  (KeepOnScreen == b.KeepOnScreen) &&
                  (TargetWindow == b.TargetWindow) &&
-                 (TargetOverlayID == b.TargetOverlayID) );
+                 (TargetOverlayID == b.TargetOverlayID) &&
+                 (CaptureWindows == b.CaptureWindows) );
     }
     bool operator!=(const WindowManagerThreadData b)
     {
@@ -29,6 +32,13 @@ struct WindowManagerThreadData
     }
 };
 
+//Location change hook limited to the thread of a captured window
+struct WindowManagerThreadHook
+{
+    DWORD ThreadID = 0;
+    HWINEVENTHOOK HookHandle = nullptr;
+};
+
 class InputSimulator;
 
 //WindowManager uses a separate thread for win event hook callbacks in order to be able to react as soon as possible (needed for window drag blocking)
@@ -41,6 +51,7 @@ class WindowManager
         void UpdateConfigState();                                                              //Updates config state from ConfigManager for the WindowManager thread
         void SetTargetWindow(HWND window, unsigned int overlay_id = k_ulOverlayID_Dashboard);  //Sets target window and overlay id for the WindowManager thread
         HWND GetTargetWindow() const;
+        void SetCaptureWindows(const std::vector<HWND>& windows);                              //Sets the source windows of WinRT captures for the WindowManager thread
         void SetActive(bool is_active);                                                        //Set active state for the window manager. Threads are destroyed when it's inactive
 
         bool WouldDragMaximizedTitleBar(HWND window, int prev_cursor_x, int prev_cursor_y, int new_cursor_x, int new_cursor_y);
@@ -54,6 +65,7 @@ class WindowManager
         DWORD m_ThreadID = 0;
         HWND m_TargetWindow = nullptr;
         unsigned int m_TargetOverlayID = k_ulOverlayID_Dashboard;
+        std::vector<HWND> m_CaptureWindows;
 
         bool m_IsActive = false;
 
@@ -80,7 +92,8 @@ class WindowManager
         //- Only called by WindowManager thread
         void HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time);
         static void CALLBACK WinEventProc(HWINEVENTHOOK event_hook_handle, DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time);
-        void ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change);
+        void ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change, 
+                              HWINEVENTHOOK& hook_handle_foreground_change, std::vector<WindowManagerThreadHook>& hooks_capture_location_change);
 
         static DWORD WindowManagerThreadEntry(void* param);
 };
\ No newline at end of file
@@ -448,7 +448,7 @@ bool CreateDeviceD3D(HWND hWnd, bool desktop_mode)
             DXGI_ADAPTER_DESC adapter_desc;
             if (adapter_ptr_vr->GetDesc(&adapter_desc) == S_OK)
             {
-                UIManager::Get()->GetPerformanceWindow().GetPerformanceData().SetTargetGPU(adapter_desc.AdapterLuid, adapter_desc.DedicatedVideoMemory);
+                UIManager::Get()->GetPerformanceWindow().GetPerformanceSampler().SetTargetGPU(adapter_desc.AdapterLuid, adapter_desc.DedicatedVideoMemory);
             }
         }
     }
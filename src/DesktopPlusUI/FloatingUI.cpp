@@ -3,6 +3,7 @@
 #include "UIManager.h"
 #include "OverlayManager.h"
 #include "InterprocessMessaging.h"
+#include "OverlayTransformCache.h"
 #include "Util.h"
 
 FloatingUI::FloatingUI() : m_OvrlHandleCurrentUITarget(vr::k_ulOverlayHandleInvalid),
@@ -268,7 +269,7 @@ void FloatingUI::UpdateUITargetState()
         //Offset further to get the desired postion at the edge of the overlay
         OffsetTransformFromSelf(matrix, -m_Width * 0.449f, m_Width * 0.0487f, clamp(m_Width * 0.005f, 0.0025f, 0.025f));
 
-        vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle_floating_ui, origin, &matrix);
+        OverlayTransformCache::Get().SetOverlayTransformAbsolute(ovrl_handle_floating_ui, origin, &matrix);
 
         m_IsTargetCurved = (curvature > 0.0f);
     }
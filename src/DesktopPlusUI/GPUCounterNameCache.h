@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <cwchar>
+#include <cstdlib>
+#include <vector>
+
+//Info parsed from a PDH GPU counter instance name such as "pid_1234_luid_0x00000000_0x0000D1E5_phys_0_eng_0_engtype_3D"
+//"GPU Adapter Memory" instance names only contain the LUID part ("luid_0x00000000_0x0000D1E5_phys_0")
+struct GPUCounterInstanceInfo
+{
+    uint64_t NameHash     = 0;
+    int32_t  LUIDHighPart = 0;
+    uint32_t LUIDLowPart  = 0;
+    bool     IsEngine3D   = false;
+};
+
+//FNV-1a over the name characters
+inline uint64_t HashGPUCounterInstanceName(const wchar_t* name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (; *name != L'\0'; ++name)
+    {
+        hash ^= (uint64_t)*name;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+//Parses the instance name without any allocations. LUID parts stay 0 if they can't be found
+inline GPUCounterInstanceInfo ParseGPUCounterInstanceName(const wchar_t* name)
+{
+    GPUCounterInstanceInfo info;
+    info.NameHash = HashGPUCounterInstanceName(name);
+
+    //Find and extract LUID parts
+    const wchar_t* pos_high = wcsstr(name, L"_0x");
+    if (pos_high != nullptr)
+    {
+        const wchar_t* pos_low = wcsstr(pos_high + 1, L"_0x");
+        if (pos_low != nullptr)
+        {
+            //Parsing stops at the next '_', the "0x" prefix is accepted by wcstoul() with base 16
+            info.LUIDHighPart = (int32_t)wcstoul(pos_high + 1, nullptr, 16);
+            info.LUIDLowPart  = (uint32_t)wcstoul(pos_low + 1, nullptr, 16);
+        }
+    }
+
+    //Only count engine type "3D"
+    info.IsEngine3D = (wcsstr(name, L"_engtype_3D") != nullptr);
+
+    return info;
+}
+
+//Caches parsed instance names by their position in the counter array
+//Every name is hashed on each update and only parsed again if its hash differs from the cached one. Hashing is cheap next to parsing
+//Names can't be trusted by pointer or by the instance set's item count and buffer size, as PDH reuses the same buffer and processes with PIDs of the same length
+//can replace each other without changing either
+class GPUCounterNameCache
+{
+    private:
+        struct Entry
+        {
+            GPUCounterInstanceInfo Info;
+            bool IsValid = false;
+        };
+
+        std::vector<Entry> m_Entries;
+        uint64_t m_HashCount  = 0;
+        uint64_t m_ParseCount = 0;
+
+    public:
+        const GPUCounterInstanceInfo& Get(size_t index, const wchar_t* name)
+        {
+            if (index >= m_Entries.size())
+            {
+                m_Entries.resize(index + 1);
+            }
+
+            Entry& entry = m_Entries[index];
+
+            const uint64_t hash = HashGPUCounterInstanceName(name);
+            m_HashCount++;
+
+            if ( (!entry.IsValid) || (entry.Info.NameHash != hash) )
+            {
+                entry.Info = ParseGPUCounterInstanceName(name);
+                entry.IsValid = true;
+                m_ParseCount++;
+            }
+
+            return entry.Info;
+        }
+
+        //Drops entries past item_count after an update, so a shrinking instance set doesn't leave stale entries behind
+        void Trim(size_t item_count)
+        {
+            if (m_Entries.size() > item_count)
+            {
+                m_Entries.resize(item_count);
+            }
+        }
+
+        void Clear()
+        {
+            m_Entries.clear();
+        }
+
+        uint64_t GetHashCount() const
+        {
+            return m_HashCount;
+        }
+
+        uint64_t GetParseCount() const
+        {
+            return m_ParseCount;
+        }
+};
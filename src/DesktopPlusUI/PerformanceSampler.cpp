@@ -0,0 +1,177 @@
+#include "PerformanceSampler.h"
+
+//Sampling interval in ms. Frame timings are collected for every frame since the last sample, so this only affects how fast the displayed values react
+#define PERFORMANCE_SAMPLER_INTERVAL 33
+
+PerformanceSampler::PerformanceSampler() :
+    m_ThreadHandle(nullptr),
+    m_StopEvent(nullptr),
+    m_IsOpenVRLoaded(false),
+    m_IsGPUCountersEnabled(true),
+    m_IsViveWirelessEnabled(false),
+    m_IsTrackerListRefreshPending(false),
+    m_IsTargetGPUPending(false),
+    m_TargetGPULUID{0, 0},
+    m_TargetGPUVRAMTotal(0)
+{
+    m_StopEvent = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+    //Have the RAM values available right away
+    m_Snapshot.RAMTotalGB = m_PerfData.GetRAMTotalGB();
+    m_Snapshot.RAMUsedGB  = m_PerfData.GetRAMUsedGB();
+    m_SnapshotBuffer.Write(m_Snapshot);
+}
+
+PerformanceSampler::~PerformanceSampler()
+{
+    Stop();
+
+    if (m_StopEvent != nullptr)
+    {
+        ::CloseHandle(m_StopEvent);
+    }
+}
+
+void PerformanceSampler::Sample()
+{
+    //Apply pending target GPU change
+    {
+        std::lock_guard<std::mutex> lock(m_TargetGPUMutex);
+
+        if (m_IsTargetGPUPending)
+        {
+            m_PerfData.SetTargetGPU(m_TargetGPULUID, m_TargetGPUVRAMTotal);
+            m_IsTargetGPUPending = false;
+        }
+    }
+
+    m_PerfData.Update();
+
+    m_Snapshot.CPULoad     = m_PerfData.GetCPULoadPrecentage();
+    m_Snapshot.GPULoad     = m_PerfData.GetGPULoadPrecentage();
+    m_Snapshot.RAMTotalGB  = m_PerfData.GetRAMTotalGB();
+    m_Snapshot.RAMUsedGB   = m_PerfData.GetRAMUsedGB();
+    m_Snapshot.VRAMTotalGB = m_PerfData.GetVRAMTotalGB();
+    m_Snapshot.VRAMUsedGB  = m_PerfData.GetVRAMUsedGB();
+
+    if (m_IsOpenVRLoaded)
+    {
+        if (m_IsTrackerListRefreshPending.exchange(false))
+        {
+            m_PerfDataOpenVR.RefreshTrackerList();
+        }
+
+        m_PerfDataOpenVR.Update(m_Snapshot);
+    }
+    else
+    {
+        m_Snapshot.IsOpenVRDataValid = false;
+    }
+
+    if (m_IsViveWirelessEnabled)
+    {
+        m_PerfDataViveWireless.Update(m_Snapshot);
+    }
+
+    m_Snapshot.SampleCount++;
+    m_Snapshot.SampleTick = ::GetTickCount64();
+
+    m_SnapshotBuffer.Write(m_Snapshot);
+}
+
+DWORD WINAPI PerformanceSampler::SamplerThreadEntry(void* param)
+{
+    PerformanceSampler& sampler = *(PerformanceSampler*)param;
+
+    bool gpu_counters_enabled = sampler.m_IsGPUCountersEnabled;
+    sampler.m_PerfData.EnableCounters(gpu_counters_enabled);
+
+    do
+    {
+        //Apply GPU counter state changes
+        if (sampler.m_IsGPUCountersEnabled != gpu_counters_enabled)
+        {
+            gpu_counters_enabled = sampler.m_IsGPUCountersEnabled;
+
+            if (gpu_counters_enabled)
+            {
+                sampler.m_PerfData.EnableCounters(true);
+            }
+            else
+            {
+                sampler.m_PerfData.DisableGPUCounters();
+            }
+        }
+
+        sampler.Sample();
+    }
+    while (::WaitForSingleObject(sampler.m_StopEvent, PERFORMANCE_SAMPLER_INTERVAL) == WAIT_TIMEOUT);
+
+    sampler.m_PerfData.DisableCounters();
+
+    return 0;
+}
+
+void PerformanceSampler::Start()
+{
+    if ( (m_ThreadHandle != nullptr) || (m_StopEvent == nullptr) )
+        return;
+
+    ::ResetEvent(m_StopEvent);
+    m_ThreadHandle = ::CreateThread(nullptr, 0, SamplerThreadEntry, this, 0, nullptr);
+}
+
+void PerformanceSampler::Stop()
+{
+    if (m_ThreadHandle == nullptr)
+        return;
+
+    ::SetEvent(m_StopEvent);
+    ::WaitForSingleObject(m_ThreadHandle, INFINITE);
+    ::CloseHandle(m_ThreadHandle);
+    m_ThreadHandle = nullptr;
+}
+
+bool PerformanceSampler::IsRunning() const
+{
+    return (m_ThreadHandle != nullptr);
+}
+
+void PerformanceSampler::SetOpenVRLoaded(bool is_loaded)
+{
+    m_IsOpenVRLoaded = is_loaded;
+}
+
+void PerformanceSampler::SetGPUCountersEnabled(bool is_enabled)
+{
+    m_IsGPUCountersEnabled = is_enabled;
+}
+
+void PerformanceSampler::SetViveWirelessEnabled(bool is_enabled)
+{
+    m_IsViveWirelessEnabled = is_enabled;
+}
+
+void PerformanceSampler::SetTargetGPU(LUID gpu_luid, DWORDLONG vram_total_bytes)
+{
+    std::lock_guard<std::mutex> lock(m_TargetGPUMutex);
+
+    m_TargetGPULUID      = gpu_luid;
+    m_TargetGPUVRAMTotal = vram_total_bytes;
+    m_IsTargetGPUPending = true;
+}
+
+void PerformanceSampler::RefreshTrackerList()
+{
+    m_IsTrackerListRefreshPending = true;
+}
+
+bool PerformanceSampler::GetSnapshot(PerformanceSnapshot& snapshot_out)
+{
+    return m_SnapshotBuffer.Read(snapshot_out);
+}
+
+bool PerformanceSampler::IsViveWirelessInstalled() const
+{
+    return m_PerfDataViveWireless.IsInstalled();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "Win32PerformanceData.h"
+#include "PerformanceSnapshot.h"
+
+//Collects Performance Monitor data on a separate thread so the UI thread doesn't have to wait on PDH or OpenVR queries
+//The UI thread only ever copies out the newest snapshot via GetSnapshot()
+class PerformanceSampler
+{
+    private:
+        //- Only accessed in main thread
+        HANDLE m_ThreadHandle;
+        HANDLE m_StopEvent;
+
+        //- Written by main thread, read by sampler thread
+        std::atomic<bool> m_IsOpenVRLoaded;
+        std::atomic<bool> m_IsGPUCountersEnabled;
+        std::atomic<bool> m_IsViveWirelessEnabled;
+        std::atomic<bool> m_IsTrackerListRefreshPending;
+
+        //- Protected by m_TargetGPUMutex
+        std::mutex m_TargetGPUMutex;
+        bool m_IsTargetGPUPending;
+        LUID m_TargetGPULUID;
+        DWORDLONG m_TargetGPUVRAMTotal;
+
+        //- Only accessed in sampler thread while it's running
+        Win32PerformanceData m_PerfData;
+        PerformanceDataOpenVR m_PerfDataOpenVR;
+        PerformanceDataViveWireless m_PerfDataViveWireless;
+        PerformanceSnapshot m_Snapshot;
+
+        PerformanceSnapshotBuffer m_SnapshotBuffer;
+
+        void Sample();
+        static DWORD WINAPI SamplerThreadEntry(void* param);
+
+    public:
+        PerformanceSampler();
+        ~PerformanceSampler();
+
+        //- Only called by main thread
+        void Start();
+        void Stop();
+        bool IsRunning() const;
+
+        void SetOpenVRLoaded(bool is_loaded);
+        void SetGPUCountersEnabled(bool is_enabled);
+        void SetViveWirelessEnabled(bool is_enabled);
+        void SetTargetGPU(LUID gpu_luid, DWORDLONG vram_total_bytes);
+        void RefreshTrackerList();                              //Refresh is done on the sampler thread's next sample
+
+        bool GetSnapshot(PerformanceSnapshot& snapshot_out);    //Returns false and leaves snapshot_out untouched if there's no new snapshot since the last call
+        bool IsViveWirelessInstalled() const;
+};
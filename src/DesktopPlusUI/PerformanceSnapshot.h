@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//Plain data types shared between the performance sampler thread and the UI thread
+//Kept free of Windows and OpenVR headers so they can be used and tested anywhere
+
+struct PerformanceFrameTiming
+{
+    uint32_t FrameIndex   = 0;
+    float    FrameTimeCPU = 0.0f;
+    float    FrameTimeGPU = 0.0f;
+    bool     IsValid      = false;  //Invalid timings are kept to leave a gap in the history
+};
+
+//Fixed-size ring of the most recent frame timings, oldest first
+class PerformanceFrameTimingRing
+{
+    public:
+        static const int MaxSize = 150;
+
+    private:
+        PerformanceFrameTiming m_Data[MaxSize];
+        int m_Size   = 0;
+        int m_Offset = 0;    //Index of the oldest element once the ring is full
+
+    public:
+        void Push(const PerformanceFrameTiming& timing)
+        {
+            if (m_Size < MaxSize)
+            {
+                m_Data[m_Size] = timing;
+                m_Size++;
+            }
+            else
+            {
+                m_Data[m_Offset] = timing;
+                m_Offset = (m_Offset + 1) % MaxSize;
+            }
+        }
+
+        void Clear()
+        {
+            m_Size   = 0;
+            m_Offset = 0;
+        }
+
+        int GetSize() const
+        {
+            return m_Size;
+        }
+
+        //0 is the oldest element, GetSize() - 1 the newest
+        const PerformanceFrameTiming& Get(int index) const
+        {
+            return m_Data[(m_Offset + index) % MaxSize];
+        }
+
+        const PerformanceFrameTiming& GetNewest() const
+        {
+            return Get(m_Size - 1);
+        }
+};
+
+struct PerformanceTrackerBattery
+{
+    uint32_t DeviceIndex = 0;
+    float    Battery     = -1.0f;
+};
+
+struct PerformanceSnapshot
+{
+    static const int MaxTrackerCount = 64;   //Same as vr::k_unMaxTrackedDeviceCount
+
+    uint32_t SampleCount = 0;                //Incremented on every sample, 0 means no sample was taken yet
+    uint64_t SampleTick  = 0;                //GetTickCount64() at the time of the sample
+
+    //Win32
+    float CPULoad     = 0.0f;
+    float GPULoad     = 0.0f;
+    float RAMTotalGB  = 0.0f;
+    float RAMUsedGB   = 0.0f;
+    float VRAMTotalGB = 0.0f;
+    float VRAMUsedGB  = 0.0f;
+
+    //SteamVR, only valid if IsOpenVRDataValid is true
+    bool IsOpenVRDataValid = false;
+    bool IsFrameTimingValid = false;
+    uint32_t FrameIndex     = 0;
+    float FrameTimeCPU      = 0.0f;
+    float FrameTimeGPU      = 0.0f;
+    PerformanceFrameTimingRing FrameTimingHistory;
+
+    uint32_t StatsPID                = 0;    //Process the cumulative stats below are for
+    uint32_t ScenePID                = 0;    //Current scene application process
+    uint32_t NumFramePresents        = 0;
+    uint32_t NumReprojectedFrames    = 0;
+    uint32_t NumDroppedFrames        = 0;
+    bool IsHMDInStandby              = false;
+
+    float BatteryHMD   = -1.0f;
+    float BatteryLeft  = -1.0f;
+    float BatteryRight = -1.0f;
+    int BatteryTrackerCount = 0;
+    PerformanceTrackerBattery BatteryTrackers[MaxTrackerCount];
+
+    //Vive Wireless
+    int ViveWirelessTemp = -1;
+};
+
+//Lock-free exchange of the newest snapshot between a single writer and a single reader thread
+//Both sides own one buffer each and swap it with the shared middle slot, so neither ever waits on the other or sees a partially written snapshot
+class PerformanceSnapshotBuffer
+{
+    private:
+        static const uint8_t s_NewDataBit = 0x4;
+
+        PerformanceSnapshot m_Buffers[3];
+        std::atomic<uint8_t> m_MiddleState;  //Index of the middle buffer, with s_NewDataBit set if it's newer than what the reader has
+        uint8_t m_WriterIndex;               //Only accessed by the writer thread
+        uint8_t m_ReaderIndex;               //Only accessed by the reader thread
+
+    public:
+        PerformanceSnapshotBuffer() : m_MiddleState(2), m_WriterIndex(0), m_ReaderIndex(1) {}
+
+        //- Writer thread
+        void Write(const PerformanceSnapshot& snapshot)
+        {
+            m_Buffers[m_WriterIndex] = snapshot;
+            m_WriterIndex = m_MiddleState.exchange(m_WriterIndex | s_NewDataBit, std::memory_order_acq_rel) & ~s_NewDataBit;
+        }
+
+        //- Reader thread
+        //Copies the newest snapshot into snapshot_out and returns true if there was a new one since the last call
+        bool Read(PerformanceSnapshot& snapshot_out)
+        {
+            if ((m_MiddleState.load(std::memory_order_relaxed) & s_NewDataBit) == 0)
+                return false;
+
+            m_ReaderIndex = m_MiddleState.exchange(m_ReaderIndex, std::memory_order_acq_rel) & ~s_NewDataBit;
+            snapshot_out = m_Buffers[m_ReaderIndex];
+
+            return true;
+        }
+};
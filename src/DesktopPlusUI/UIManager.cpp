@@ -8,6 +8,8 @@
 #include "InterprocessMessaging.h"
 #include "ConfigManager.h"
 #include "OverlayManager.h"
+#include "OverlayConfigBatch.h"
+#include "OverlayTransformCache.h"
 #include "Util.h"
 #include "WindowList.h"
 
@@ -222,7 +224,7 @@ vr::EVRInitError UIManager::InitOverlay()
 
 void UIManager::HandleIPCMessage(const MSG& msg)
 {
-    //Config strings come as WM_COPYDATA
+    //Config strings and binary data come as WM_COPYDATA
     if (msg.message == WM_COPYDATA)
     {
         COPYDATASTRUCT* pcds = (COPYDATASTRUCT*)msg.lParam;
@@ -269,6 +271,21 @@ void UIManager::HandleIPCMessage(const MSG& msg)
                 OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
             }
         }
+        else if ( (pcds->dwData == ipcbin_overlay_config_batch) && (pcds->cbData > 0) && (pcds->cbData <= 1024 * 1024) )
+        {
+            OverlayConfigBatch batch;
+
+            if (batch.Deserialize(pcds->lpData, pcds->cbData))
+            {
+                for (const OverlayConfigChange& change : batch.GetChanges())
+                {
+                    if (change.OverlayID < OverlayManager::Get().GetOverlayCount())
+                    {
+                        OverlayManager::Get().GetConfigData(change.OverlayID).SetValueForWParam(change.ConfigKey, change.Value);
+                    }
+                }
+            }
+        }
 
         return;
     }
@@ -879,7 +896,7 @@ void UIManager::PositionOverlay(WindowKeyboardHelper& window_kdbhelper)
         //Same goes for the curvature
         if ( (anti_flicker_can_move) && (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) )
         {
-            vr::VROverlay()->SetOverlayTransformAbsolute(m_OvrlHandle, origin, &matrix);
+            OverlayTransformCache::Get().SetOverlayTransformAbsolute(m_OvrlHandle, origin, &matrix);
             vr::VROverlay()->SetOverlayCurvature(m_OvrlHandle, curve);
         }
 
@@ -943,7 +960,7 @@ void UIManager::PositionOverlay(WindowKeyboardHelper& window_kdbhelper)
                 //Slighty lift it so input goes here (minimal mode SteamVR keyboard has a larger overlay than used for the keys)
                 OffsetTransformFromSelf(matrix, 0.0f, 0.0f, 0.00001f); 
 
-                vr::VROverlay()->SetOverlayTransformAbsolute(m_OvrlHandleKeyboardHelper, origin, &matrix);
+                OverlayTransformCache::Get().SetOverlayTransformAbsolute(m_OvrlHandleKeyboardHelper, origin, &matrix);
 
                 vr::VROverlay()->ShowOverlay(m_OvrlHandleKeyboardHelper);
                 m_OvrlVisibleKeyboardHelper = true;
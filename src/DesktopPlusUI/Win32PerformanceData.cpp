@@ -1,31 +1,41 @@
 #include "Win32PerformanceData.h"
 
-#include <memory>
+#include <algorithm>
+#include <fstream>
+#include <codecvt>
 
 #include <PdhMsg.h>
 
-LUID Win32PerformanceData::GetLUIDFromFormattedCounterNameString(const std::wstring& str)
+#include "Util.h"
+
+static LPCWSTR const g_ViveWirelessLogPathBase = L"%ProgramData%\\VIVE Wireless\\ConnectionUtility\\Log\\";
+
+PDH_FMT_COUNTERVALUE_ITEM* Win32PerformanceData::GetFormattedCounterArray(PDH_HCOUNTER counter, std::vector<uint8_t>& item_buffer, DWORD& item_count, DWORD& buffer_size)
 {
-    LUID parsed_luid = {0, 0};
+    buffer_size = 0;
+    item_count = 0;
 
-    //Find and extract LUID parts
-    size_t pos = str.find(L"_0x");
-    if (pos != std::string::npos)
-    {
-        std::wstring str_high_part = str.substr(pos + 1, 10);
+    PDH_STATUS pdh_status = PdhGetFormattedCounterArray(counter, PDH_FMT_DOUBLE, &buffer_size, &item_count, nullptr);
 
-        pos = str.find(L"_0x", pos + 1);
-        if (pos != std::string::npos)
-        {
-            std::wstring str_low_part = str.substr(pos + 1, 10);
+    if (pdh_status != PDH_MORE_DATA)
+        return nullptr;
 
-            //Convert from string
-            parsed_luid.HighPart = stol(str_high_part, 0, 16);
-            parsed_luid.LowPart  = stoul(str_low_part, 0, 16);
-        }
+    //Buffer only ever grows, so there are no allocations once the instance count settled
+    if (item_buffer.size() < buffer_size)
+    {
+        item_buffer.resize(buffer_size);
     }
 
-    return parsed_luid;
+    PDH_FMT_COUNTERVALUE_ITEM* items = (PDH_FMT_COUNTERVALUE_ITEM*)item_buffer.data();
+
+    pdh_status = PdhGetFormattedCounterArray(counter, PDH_FMT_DOUBLE, &buffer_size, &item_count, items);
+
+    return (pdh_status == ERROR_SUCCESS) ? items : nullptr;
+}
+
+bool Win32PerformanceData::IsTargetGPU(const GPUCounterInstanceInfo& info) const
+{
+    return ( (info.LUIDLowPart == m_GPUTargetLUID.LowPart) && (info.LUIDHighPart == m_GPUTargetLUID.HighPart) );
 }
 
 Win32PerformanceData::Win32PerformanceData() : 
@@ -193,42 +203,25 @@ bool Win32PerformanceData::Update()
 
         if (pdh_status == ERROR_SUCCESS)
         {
-            PDH_FMT_COUNTERVALUE counter_value = {0};
-            DWORD buffer_size = 0;
-            DWORD item_count = 0;
-
-            pdh_status = PdhGetFormattedCounterArray(m_CounterGPU, PDH_FMT_DOUBLE, &buffer_size, &item_count, nullptr);
+            DWORD item_count = 0, buffer_size = 0;
+            PDH_FMT_COUNTERVALUE_ITEM* items = GetFormattedCounterArray(m_CounterGPU, m_ItemBufferGPU, item_count, buffer_size);
 
-            if (pdh_status == PDH_MORE_DATA)
+            if (items != nullptr)
             {
-                std::unique_ptr<uint8_t[]> item_buffer = std::unique_ptr<uint8_t[]>{new uint8_t[buffer_size]};
-                PDH_FMT_COUNTERVALUE_ITEM* items = (PDH_FMT_COUNTERVALUE_ITEM*)item_buffer.get();
-
-                pdh_status = PdhGetFormattedCounterArray(m_CounterGPU, PDH_FMT_DOUBLE, &buffer_size, &item_count, items);
-
-                if (pdh_status == ERROR_SUCCESS)
+                double total_load = 0.0;
+                for (DWORD i = 0; i < item_count; i++)
                 {
-                    double total_load = 0.0;
+                    const GPUCounterInstanceInfo& item_info = m_NameCacheGPU.Get(i, items[i].szName);
 
-                    for (DWORD i = 0; i < item_count; i++)
+                    //Only count engine type "3D" and make sure it's from the right GPU
+                    if ( (item_info.IsEngine3D) && (IsTargetGPU(item_info)) )
                     {
-                        std::wstring item_name(items[i].szName);
-
-                        //Only count engine type "3D"
-                        if (item_name.find(L"_engtype_3D") != std::string::npos)
-                        {
-                            //Make sure it's from the right GPU
-                            LUID item_luid = GetLUIDFromFormattedCounterNameString(item_name);
-
-                            if ( (item_luid.LowPart == m_GPUTargetLUID.LowPart) && (item_luid.HighPart == m_GPUTargetLUID.HighPart) )
-                            {
-                                total_load += items[i].FmtValue.doubleValue;
-                            }
-                        }
+                        total_load += items[i].FmtValue.doubleValue;
                     }
-
-                    m_GPULoad = std::min((float)total_load, 100.0f);
                 }
+
+                m_NameCacheGPU.Trim(item_count);
+                m_GPULoad = std::min((float)total_load, 100.0f);
             }
         }
     }
@@ -240,36 +233,23 @@ bool Win32PerformanceData::Update()
 
         if (pdh_status == ERROR_SUCCESS)
         {
-            PDH_FMT_COUNTERVALUE counter_value = {0};
-            DWORD buffer_size = 0;
-            DWORD item_count = 0;
+            DWORD item_count = 0, buffer_size = 0;
+            PDH_FMT_COUNTERVALUE_ITEM* items = GetFormattedCounterArray(m_CounterVRAM, m_ItemBufferVRAM, item_count, buffer_size);
 
-            pdh_status = PdhGetFormattedCounterArray(m_CounterVRAM, PDH_FMT_DOUBLE, &buffer_size, &item_count, nullptr);
-
-            if (pdh_status == PDH_MORE_DATA)
+            if (items != nullptr)
             {
-                std::unique_ptr<uint8_t[]> item_buffer = std::unique_ptr<uint8_t[]>{new uint8_t[buffer_size]};
-                PDH_FMT_COUNTERVALUE_ITEM* items = (PDH_FMT_COUNTERVALUE_ITEM*)item_buffer.get();
-
-                pdh_status = PdhGetFormattedCounterArray(m_CounterVRAM, PDH_FMT_DOUBLE, &buffer_size, &item_count, items);
-
-                if (pdh_status == ERROR_SUCCESS)
+                for (DWORD i = 0; i < item_count; i++)
                 {
-                    for (DWORD i = 0; i < item_count; i++)
+                    //Make sure it's from the right GPU
+                    if (IsTargetGPU(m_NameCacheVRAM.Get(i, items[i].szName)))
                     {
-                        std::wstring item_name(items[i].szName);
-
-                        //Make sure it's from the right GPU
-                        LUID item_luid = GetLUIDFromFormattedCounterNameString(item_name);
-
-                        if ( (item_luid.LowPart == m_GPUTargetLUID.LowPart) && (item_luid.HighPart == m_GPUTargetLUID.HighPart) )
-                        {
-                            m_VRAMUsedGB = float(items[i].FmtValue.doubleValue / (1024.0 * 1024.0 * 1024.0));
-                            m_VRAMUsedGB = std::min(m_VRAMUsedGB, m_VRAMTotalGB);
-                            break;
-                        }
+                        m_VRAMUsedGB = float(items[i].FmtValue.doubleValue / (1024.0 * 1024.0 * 1024.0));
+                        m_VRAMUsedGB = std::min(m_VRAMUsedGB, m_VRAMTotalGB);
+                        break;
                     }
                 }
+
+                m_NameCacheVRAM.Trim(item_count);
             }
         }
     }
@@ -319,3 +299,249 @@ float Win32PerformanceData::GetVRAMUsedGB() const
 {
     return m_VRAMUsedGB;
 }
+
+
+PerformanceDataOpenVR::PerformanceDataOpenVR() : m_FrameTimeLastIndex(0), m_BatteryTickLast(0)
+{
+
+}
+
+void PerformanceDataOpenVR::Update(PerformanceSnapshot& snapshot)
+{
+    snapshot.IsOpenVRDataValid = true;
+
+    //Get compositor timing from OpenVR
+    vr::Compositor_FrameTiming frame_timing_current;
+    frame_timing_current.m_nSize = sizeof(vr::Compositor_FrameTiming);
+    snapshot.IsFrameTimingValid  = vr::VRCompositor()->GetFrameTiming(&frame_timing_current, 0);
+
+    if (snapshot.IsFrameTimingValid)
+    {
+        //Set current timings
+        snapshot.FrameIndex   = frame_timing_current.m_nFrameIndex;
+        snapshot.FrameTimeCPU = frame_timing_current.m_flClientFrameIntervalMs + frame_timing_current.m_flCompositorRenderCpuMs;
+        snapshot.FrameTimeGPU = frame_timing_current.m_flTotalRenderGpuMs;
+
+        //Update frame time history
+        vr::Compositor_FrameTiming frame_timing_prev;
+        frame_timing_prev.m_nSize = sizeof(vr::Compositor_FrameTiming);
+
+        //Sanity check
+        if (frame_timing_current.m_nFrameIndex < m_FrameTimeLastIndex)
+        {
+            m_FrameTimeLastIndex = 0;
+            snapshot.FrameTimingHistory.Clear();
+        }
+
+        //Get all frame timings since the last time we updated (but not more than max history size)
+        for (uint32_t frames_ago = std::min(frame_timing_current.m_nFrameIndex - m_FrameTimeLastIndex, (uint32_t)PerformanceFrameTimingRing::MaxSize); frames_ago != 0; --frames_ago)
+        {
+            PerformanceFrameTiming timing;
+            //Calculate our own frame index as we get duplicates if SteamVR runs out of history
+            timing.FrameIndex = frame_timing_current.m_nFrameIndex - frames_ago;
+            timing.IsValid    = vr::VRCompositor()->GetFrameTiming(&frame_timing_prev, frames_ago);
+
+            if (timing.IsValid)
+            {
+                timing.FrameTimeCPU = frame_timing_prev.m_flClientFrameIntervalMs + frame_timing_prev.m_flCompositorRenderCpuMs;
+                timing.FrameTimeGPU = frame_timing_prev.m_flTotalRenderGpuMs;
+            }
+
+            snapshot.FrameTimingHistory.Push(timing);
+        }
+
+        m_FrameTimeLastIndex = frame_timing_current.m_nFrameIndex;
+    }
+    else
+    {
+        snapshot.FrameTimeCPU = 0.0f;
+        snapshot.FrameTimeGPU = 0.0f;
+    }
+
+    //Cumulative stats
+    vr::Compositor_CumulativeStats frame_stats = {0};
+    vr::VRCompositor()->GetCumulativeStats(&frame_stats, sizeof(vr::Compositor_CumulativeStats));
+
+    snapshot.StatsPID             = frame_stats.m_nPid;
+    snapshot.ScenePID             = vr::VRApplications()->GetCurrentSceneProcessId();
+    snapshot.NumFramePresents     = frame_stats.m_nNumFramePresents;
+    snapshot.NumReprojectedFrames = frame_stats.m_nNumReprojectedFrames;
+    snapshot.NumDroppedFrames     = frame_stats.m_nNumDroppedFrames;
+    snapshot.IsHMDInStandby       = (vr::VRSystem()->GetTrackedDeviceActivityLevel(vr::k_unTrackedDeviceIndex_Hmd) == vr::k_EDeviceActivityLevel_Standby);
+
+    //Battery values don't change quickly, only query them once a second
+    if (m_BatteryTickLast + 1000 > ::GetTickCount64())
+        return;
+
+    m_BatteryTickLast = ::GetTickCount64();
+
+    //Battery Left
+    vr::TrackedDeviceIndex_t device_index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand);
+
+    if (device_index != vr::k_unTrackedDeviceIndexInvalid)
+    {
+        snapshot.BatteryLeft = vr::VRSystem()->GetFloatTrackedDeviceProperty(device_index, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
+    }
+    else
+    {
+        snapshot.BatteryLeft = -1.0f;
+    }
+
+    //Battery Right
+    device_index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
+
+    if (device_index != vr::k_unTrackedDeviceIndexInvalid)
+    {
+        snapshot.BatteryRight = vr::VRSystem()->GetFloatTrackedDeviceProperty(device_index, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
+    }
+    else
+    {
+        snapshot.BatteryRight = -1.0f;
+    }
+
+    //Battery HMD
+    if (vr::VRSystem()->GetBoolTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DeviceProvidesBatteryStatus_Bool))
+    {
+        snapshot.BatteryHMD = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
+    }
+    else
+    {
+        snapshot.BatteryHMD = -1.0f;
+    }
+
+    //Battery Trackers
+    snapshot.BatteryTrackerCount = 0;
+    for (vr::TrackedDeviceIndex_t tracker_index : m_Trackers)
+    {
+        PerformanceTrackerBattery& tracker = snapshot.BatteryTrackers[snapshot.BatteryTrackerCount];
+        tracker.DeviceIndex = tracker_index;
+        tracker.Battery     = vr::VRSystem()->GetFloatTrackedDeviceProperty(tracker_index, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
+
+        snapshot.BatteryTrackerCount++;
+    }
+}
+
+void PerformanceDataOpenVR::RefreshTrackerList()
+{
+    m_Trackers.clear();
+
+    for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
+    {
+        if ( (vr::VRSystem()->GetTrackedDeviceClass(i) == vr::TrackedDeviceClass_GenericTracker) && (vr::VRSystem()->IsTrackedDeviceConnected(i)) )
+        {
+            m_Trackers.push_back(i);
+        }
+    }
+
+    //Have the battery values refreshed on the next update
+    m_BatteryTickLast = 0;
+}
+
+PerformanceDataViveWireless::PerformanceDataViveWireless() : m_TickLast(0), m_LogFileLastLine(0)
+{
+    //Expand path for Vive Wireless log files
+    wchar_t wpath[MAX_PATH] = L"\0";
+    ::ExpandEnvironmentStrings(g_ViveWirelessLogPathBase, wpath, MAX_PATH);
+    m_LogPath = wpath;
+    m_LogPathExists = DirectoryExists(wpath);
+}
+
+void PerformanceDataViveWireless::Update(PerformanceSnapshot& snapshot)
+{
+    //This doesn't seem terribly efficient, but it's better than nothing
+    //Reading is done every 5 seconds
+
+    //Don't update if the path doesn't exist
+    if (!m_LogPathExists)
+        return;
+
+    if (m_TickLast + 5000 <= ::GetTickCount64())
+    {
+        m_TickLast = ::GetTickCount64();
+        snapshot.ViveWirelessTemp = -1;
+
+        //Find the newest log file
+        std::wstring path_str = m_LogPath;
+        path_str += L"*.txt";
+        std::vector< std::pair<std::wstring, ULARGE_INTEGER> > file_list;   //std::pair<filename, last_modified_time>
+        WIN32_FIND_DATA find_data;
+        HANDLE handle_find = ::FindFirstFileW(path_str.c_str(), &find_data);
+
+        if (handle_find != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                //Add filename and last modified time in list
+                file_list.emplace_back(find_data.cFileName, ULARGE_INTEGER{find_data.ftLastWriteTime.dwLowDateTime, find_data.ftLastWriteTime.dwHighDateTime});
+            }
+            while (::FindNextFileW(handle_find, &find_data) != 0);
+
+            ::FindClose(handle_find);
+        }
+
+        auto it = std::max_element(file_list.begin(), file_list.end(), [](const auto& data_a, const auto& data_b){ return (data_a.second.QuadPart < data_b.second.QuadPart); });
+
+        if (it == file_list.end())
+            return;
+
+        //Check if the newest file is older than 2 minutes, in which case we don't use it to read a temperature at all
+        FILETIME ftime_current;
+        ::GetSystemTimeAsFileTime(&ftime_current);
+        ULARGE_INTEGER time_current{ftime_current.dwLowDateTime, ftime_current.dwHighDateTime};
+
+        if (it->second.QuadPart + 1200000000 <= time_current.QuadPart) //+ 2 minutes in 100 ns intervals
+        {
+            return;
+        }
+
+        //If the newest file is not the same as last time, reset the last used line number
+        if (it->first != m_LogFileLast)
+        {
+            m_LogFileLast     = it->first;
+            m_LogFileLastLine = 0;
+        }
+
+        //Read log file
+        {
+            path_str = m_LogPath + m_LogFileLast;
+
+            std::wifstream log_file(path_str);
+
+            if (log_file.good())
+            {
+                //Imbue with utf16-le locale, as are the files Vive Wireless writes (codecvt_utf16 is deprecated starting C++17, but this is the most straight forward way to deal with this)
+                log_file.imbue(std::locale(log_file.getloc(), new std::codecvt_utf16<wchar_t, 0x10ffff, std::little_endian>()));
+
+                //Read lines and see if the M_Temperature can be found (R_Temperature isn't interesting in our case)
+                int line_count = 0;
+                std::wstring line_str;
+                std::string temp_str;
+                size_t mtemp_pos;
+
+                while (log_file.good())
+                {
+                    std::getline(log_file, line_str);
+                    line_count++;
+
+                    //Only check for the temperature value if this line is the same or greater than last time (0 if it's a new file)
+                    if (line_count >= m_LogFileLastLine)
+                    {
+                        mtemp_pos = line_str.find(L"M_Temperature=");
+
+                        if (mtemp_pos != std::wstring::npos)
+                        {
+                            temp_str = StringConvertFromUTF16(line_str.substr(mtemp_pos + 14).c_str());
+                            snapshot.ViveWirelessTemp = atoi(temp_str.c_str());
+                            m_LogFileLastLine = line_count;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool PerformanceDataViveWireless::IsInstalled() const
+{
+    return m_LogPathExists;
+}
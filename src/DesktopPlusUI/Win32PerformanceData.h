@@ -1,10 +1,15 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #define NOMINMAX
 #include <pdh.h>
 
+#include "openvr.h"
+#include "PerformanceSnapshot.h"
+#include "GPUCounterNameCache.h"
+
 class Win32PerformanceData
 {
     private:
@@ -26,7 +31,14 @@ class Win32PerformanceData
 
         ULONGLONG m_LastUpdateTick;
 
-        static LUID GetLUIDFromFormattedCounterNameString(const std::wstring& str);
+        //Counter array buffers and parsed instance names are kept between updates
+        std::vector<uint8_t> m_ItemBufferGPU;
+        std::vector<uint8_t> m_ItemBufferVRAM;
+        GPUCounterNameCache m_NameCacheGPU;
+        GPUCounterNameCache m_NameCacheVRAM;
+
+        static PDH_FMT_COUNTERVALUE_ITEM* GetFormattedCounterArray(PDH_HCOUNTER counter, std::vector<uint8_t>& item_buffer, DWORD& item_count, DWORD& buffer_size);
+        bool IsTargetGPU(const GPUCounterInstanceInfo& info) const;
 
     public:
         Win32PerformanceData();
@@ -47,12 +59,35 @@ class Win32PerformanceData
         float GetVRAMUsedGB()        const;
 };
 
+//Called from the performance sampler thread only
 class PerformanceDataOpenVR
 {
+    private:
+        uint32_t m_FrameTimeLastIndex;
+        ULONGLONG m_BatteryTickLast;
+        std::vector<vr::TrackedDeviceIndex_t> m_Trackers;   //List updated in RefreshTrackerList(), requested on devices connect/disconnect
+
+    public:
+        PerformanceDataOpenVR();
 
+        void Update(PerformanceSnapshot& snapshot);
+        void RefreshTrackerList();
 };
 
+//Vive Wireless Temperatures can seemingly only be read from the log file it's constantly writing too
+//Update() is called from the performance sampler thread only
 class PerformanceDataViveWireless
 {
+    private:
+        ULONGLONG m_TickLast;
+        std::wstring m_LogPath;
+        bool m_LogPathExists;
+        std::wstring m_LogFileLast;
+        int m_LogFileLastLine;
+
+    public:
+        PerformanceDataViveWireless();
 
-};
\ No newline at end of file
+        void Update(PerformanceSnapshot& snapshot);
+        bool IsInstalled() const;
+};
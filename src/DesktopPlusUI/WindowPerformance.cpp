@@ -1,8 +1,5 @@
 #include "WindowPerformance.h"
 
-#include <fstream>
-#include <codecvt>
-
 #include "implot.h"
 #include "ImGuiExt.h"
 #include "TextureManager.h"
@@ -12,27 +9,21 @@
 #include "UIManager.h"
 #include "OverlayManager.h"
 
-static LPCWSTR const g_ViveWirelessLogPathBase = L"%ProgramData%\\VIVE Wireless\\ConnectionUtility\\Log\\";
-
 WindowPerformance::WindowPerformance() : 
     m_Visible(false),
     m_VisibleTickLast(0),
     m_IsPopupOpen(false),
+    m_IsSettingsStatsVisible(false),
     m_PIDLast(0),
+    m_IsCumulativeResetPending(false),
     m_OffsetFrameIndex(0),
     m_OffsetFramesPresents(0),
     m_OffsetReprojectedFrames(0),
     m_OffsetDroppedFrames(0),
-    m_FrameTimeCPU(0.0f),
-    m_FrameTimeGPU(0.0f),
     m_ReprojectionRatio(0.0f),
     m_DroppedFrames(0),
-    m_BatteryHMD(-1.0f),
-    m_BatteryLeft(-1.0f),
-    m_BatteryRight(-1.0f),
     m_FrameTimeLastIndex(0),
-    m_ViveWirelessTemp(-1),
-    m_ViveWirelessLogFileLastLine(0),
+    m_FrameTimeVsyncLimit(1000.0f / 90.0f),
     m_IsOverlaySharedTextureUpdateNeeded(false)
 {
     ResetCumulativeValues();
@@ -42,11 +33,8 @@ WindowPerformance::WindowPerformance() :
     m_TimeLast.wHour   = 99;
     m_TimeLast.wMinute = 99;
 
-    //Expand path for Vive Wireless log files
-    wchar_t wpath[MAX_PATH] = L"\0";
-    ::ExpandEnvironmentStrings(g_ViveWirelessLogPathBase, wpath, MAX_PATH);
-    m_ViveWirelessLogPath = wpath;
-    m_ViveWirelessLogPathExists = DirectoryExists(wpath);
+    //Have RAM values available right away
+    m_Sampler.GetSnapshot(m_Snapshot);
 }
 
 void WindowPerformance::Update(bool show_as_popup)
@@ -162,9 +150,13 @@ void WindowPerformance::UpdateVisibleState()
 
     if (m_Visible)
     {
+        m_Sampler.SetOpenVRLoaded(UIManager::Get()->IsOpenVRLoaded());
+        m_Sampler.SetViveWirelessEnabled(ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless));
+
         if (!was_visible)
         {
-            m_PerfData.EnableCounters(!ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_disable_gpu_counters));
+            m_Sampler.SetGPUCountersEnabled(!ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_disable_gpu_counters));
+            m_Sampler.Start();
         }
     }
     else
@@ -173,11 +165,22 @@ void WindowPerformance::UpdateVisibleState()
         {
             m_VisibleTickLast = ::GetTickCount64();
         }
-        else if (m_VisibleTickLast + 3000 <= ::GetTickCount64())    //Only actually disable counters after at least 3 seconds of being hidden
+        else if ( (m_Sampler.IsRunning()) && (m_VisibleTickLast + 3000 <= ::GetTickCount64()) ) //Only actually stop sampling after at least 3 seconds of being hidden
         {
-            m_PerfData.DisableCounters();
+            m_Sampler.Stop();
         }
     }
+
+    //Toggle dashboard app performance stats, which are only counted while something displays them
+    const bool stats_needed = ( (m_IsSettingsStatsVisible) || ( (m_Visible) && (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_large_style)) && 
+                                                                (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_capture_stats)) ) );
+
+    bool& performance_stats_active = ConfigManager::Get().GetConfigBoolRef(configid_bool_state_performance_stats_active);
+    if (performance_stats_active != stats_needed)
+    {
+        performance_stats_active = stats_needed;
+        IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_bool_state_performance_stats_active), stats_needed);
+    }
 }
 
 void WindowPerformance::DisplayStatsLarge()
@@ -259,14 +262,14 @@ void WindowPerformance::DisplayStatsLarge()
         ImGui::NextColumn();
 
         //Warning color when frame time above 95% vsync time
-        if (m_FrameTimeCPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeCPU > frame_time_warning_limit)
             ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-        ImGui::TextRight(text_ms_width, "%.2f", m_FrameTimeCPU);
+        ImGui::TextRight(text_ms_width, "%.2f", m_Snapshot.FrameTimeCPU);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted(" ms");
 
-        if (m_FrameTimeCPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeCPU > frame_time_warning_limit)
             ImGui::PopStyleColor();
 
         ImGui::NextColumn();
@@ -278,7 +281,7 @@ void WindowPerformance::DisplayStatsLarge()
         ImGui::Text("Load:");
         ImGui::NextColumn();
 
-        ImGui::TextRight(text_percent_width, "%.2f", m_PerfData.GetCPULoadPrecentage());
+        ImGui::TextRight(text_percent_width, "%.2f", m_Snapshot.CPULoad);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted("%");
 
@@ -290,7 +293,7 @@ void WindowPerformance::DisplayStatsLarge()
         ImGui::NextColumn();
 
         //Right align
-        ImGui::TextRight(right_border_offset - 1.0f, "%.2f/%.2f GB", m_PerfData.GetRAMUsedGB(), m_PerfData.GetRAMTotalGB());
+        ImGui::TextRight(right_border_offset - 1.0f, "%.2f/%.2f GB", m_Snapshot.RAMUsedGB, m_Snapshot.RAMTotalGB);
         ImGui::NextColumn();
     }
 
@@ -308,15 +311,15 @@ void WindowPerformance::DisplayStatsLarge()
         ImGui::Text("Frame Time:");
         ImGui::NextColumn();
 
-        if (m_FrameTimeGPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeGPU > frame_time_warning_limit)
             ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-        ImGui::TextRight(text_ms_width, "%.2f", m_FrameTimeGPU);
+        ImGui::TextRight(text_ms_width, "%.2f", m_Snapshot.FrameTimeGPU);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted(" ms");
         ImGui::NextColumn();
 
-        if (m_FrameTimeGPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeGPU > frame_time_warning_limit)
             ImGui::PopStyleColor();
 
         ImGui::NextColumn();
@@ -328,7 +331,7 @@ void WindowPerformance::DisplayStatsLarge()
             ImGui::Text("Load:");
             ImGui::NextColumn();
 
-            ImGui::TextRight(text_percent_width, "%.2f", m_PerfData.GetGPULoadPrecentage());
+            ImGui::TextRight(text_percent_width, "%.2f", m_Snapshot.GPULoad);
             ImGui::SameLine(0.0f, 0.0f);
             ImGui::TextUnformatted("%");
             ImGui::NextColumn();
@@ -337,7 +340,7 @@ void WindowPerformance::DisplayStatsLarge()
             ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);  //Reduce horizontal spacing
             ImGui::Text("VRAM:");
             ImGui::NextColumn();
-            ImGui::TextRight(right_border_offset - 1.0f, "%.2f/%.2f GB", m_PerfData.GetVRAMUsedGB(), m_PerfData.GetVRAMTotalGB());
+            ImGui::TextRight(right_border_offset - 1.0f, "%.2f/%.2f GB", m_Snapshot.VRAMUsedGB, m_Snapshot.VRAMTotalGB);
             ImGui::NextColumn();
         }
     }
@@ -403,18 +406,18 @@ void WindowPerformance::DisplayStatsLarge()
             ImGui::Text("Left Controller:");
             ImGui::NextColumn();
 
-            if (m_BatteryLeft != -1.0f)
+            if (m_Snapshot.BatteryLeft != -1.0f)
             {
                 //15% warning color (Same percentage the SteamVR dashboard battery icon goes red at)
-                if (m_BatteryLeft < 15.0f)
+                if (m_Snapshot.BatteryLeft < 15.0f)
                     ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                ImGui::TextRight(text_percent_width, "%.0f", m_BatteryLeft);
+                ImGui::TextRight(text_percent_width, "%.0f", m_Snapshot.BatteryLeft);
                 ImGui::SameLine(0.0f, 0.0f);
                 ImGui::TextUnformatted("%");
                 ImGui::NextColumn();
 
-                if (m_BatteryLeft < 15.0f)
+                if (m_Snapshot.BatteryLeft < 15.0f)
                     ImGui::PopStyleColor();
             }
             else
@@ -430,18 +433,18 @@ void WindowPerformance::DisplayStatsLarge()
             ImGui::Text("Right Controller:");
             ImGui::NextColumn();
 
-            if (m_BatteryRight != -1.0f)
+            if (m_Snapshot.BatteryRight != -1.0f)
             {
                 //15% warning color
-                if (m_BatteryRight < 15.0f)
+                if (m_Snapshot.BatteryRight < 15.0f)
                     ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                ImGui::TextRight(text_percent_width + right_border_offset, "%.0f", m_BatteryRight);
+                ImGui::TextRight(text_percent_width + right_border_offset, "%.0f", m_Snapshot.BatteryRight);
                 ImGui::SameLine(0.0f, 0.0f);
                 ImGui::TextUnformatted("%");
                 ImGui::NextColumn();
 
-                if (m_BatteryRight < 15.0f)
+                if (m_Snapshot.BatteryRight < 15.0f)
                     ImGui::PopStyleColor();
             }
             else
@@ -453,20 +456,20 @@ void WindowPerformance::DisplayStatsLarge()
             }
 
             //-Battery HMD (only shown if available)
-            if (m_BatteryHMD != -1.0f)
+            if (m_Snapshot.BatteryHMD != -1.0f)
             {
                 ImGui::Text("Headset:");
                 ImGui::NextColumn();
                 //15% warning color (Same percentage the SteamVR dashboard battery icon goes red at)
-                if (m_BatteryHMD < 15.0f)
+                if (m_Snapshot.BatteryHMD < 15.0f)
                     ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                ImGui::TextRight(text_percent_width, "%.0f", m_BatteryHMD);
+                ImGui::TextRight(text_percent_width, "%.0f", m_Snapshot.BatteryHMD);
                 ImGui::SameLine(0.0f, 0.0f);
                 ImGui::TextUnformatted("%");
                 ImGui::NextColumn();
 
-                if (m_BatteryHMD < 15.0f)
+                if (m_Snapshot.BatteryHMD < 15.0f)
                     ImGui::PopStyleColor();
             }
 
@@ -476,8 +479,10 @@ void WindowPerformance::DisplayStatsLarge()
             if (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_trackers))
             {
                 unsigned int tracker_number = 1;
-                for (const auto& tracker_pair : m_BatteryTrackers)
+                for (int i = 0; i < m_Snapshot.BatteryTrackerCount; ++i)
                 {
+                    const float battery = m_Snapshot.BatteryTrackers[i].Battery;
+
                     //Reduce horizontal spacing on the right column
                     if (ImGui::GetColumnIndex() == 2)
                     {
@@ -493,15 +498,15 @@ void WindowPerformance::DisplayStatsLarge()
                     ImGui::NextColumn();
 
                     //15% warning color
-                    if (tracker_pair.second < 15.0f)
+                    if (battery < 15.0f)
                         ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                    ImGui::TextRight(right_offset, "%.0f", tracker_pair.second);
+                    ImGui::TextRight(right_offset, "%.0f", battery);
                     ImGui::SameLine(0.0f, 0.0f);
                     ImGui::TextUnformatted("%");
                     ImGui::NextColumn();
 
-                    if (tracker_pair.second < 15.0f)
+                    if (battery < 15.0f)
                         ImGui::PopStyleColor();
 
                     tracker_number++;
@@ -509,7 +514,7 @@ void WindowPerformance::DisplayStatsLarge()
             }
 
             //-Vive Wireless
-            if ( (m_ViveWirelessLogPathExists) && (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless)) )
+            if ( (m_Sampler.IsViveWirelessInstalled()) && (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless)) )
             {
                 //Reduce horizontal spacing on the right column
                 if (ImGui::GetColumnIndex() == 2)
@@ -525,15 +530,15 @@ void WindowPerformance::DisplayStatsLarge()
                 ImGui::Text("Vive Wireless:");
                 ImGui::NextColumn();
 
-                if (m_ViveWirelessTemp != -1)
+                if (m_Snapshot.ViveWirelessTemp != -1)
                 {
                     //90 degrees celsius warning color (arbitrarily chosen, but that's not a temp it should be at constantly)
-                    if (m_ViveWirelessTemp > 90)
+                    if (m_Snapshot.ViveWirelessTemp > 90)
                         ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                    ImGui::TextRight(right_offset, "%d\xC2\xB0""C", m_ViveWirelessTemp);
+                    ImGui::TextRight(right_offset, "%d\xC2\xB0""C", m_Snapshot.ViveWirelessTemp);
 
-                    if (m_ViveWirelessTemp > 90)
+                    if (m_Snapshot.ViveWirelessTemp > 90)
                         ImGui::PopStyleColor();
                 }
                 else
@@ -546,6 +551,12 @@ void WindowPerformance::DisplayStatsLarge()
         }
     }
 
+    //-Table Capture
+    if (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_capture_stats))
+    {
+        DisplayStatsLargeCapture(right_border_offset, item_spacing_half);
+    }
+
     //Last item rect height is the padding dummy == empty window
     if (ImGui::GetItemRectSize().y == 0.0f)
     {
@@ -554,6 +565,203 @@ void WindowPerformance::DisplayStatsLarge()
     }
 }
 
+void WindowPerformance::DisplayStatsLargeCapture(float right_border_offset, float item_spacing_half)
+{
+    //Values are sent by the dashboard app once a second while performance stats are active, see OutputManager::UpdatePerformanceStates()
+
+    //The previous table can end in the middle of a row
+    while (ImGui::GetColumnIndex() != 0)
+    {
+        ImGui::NextColumn();
+    }
+
+    ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered), "Capture");
+    ImGui::NextColumn();
+    ImGui::NextColumn();
+    ImGui::NextColumn();
+    ImGui::NextColumn();
+
+    //-Desktop Duplication
+    ImGui::Text("Duplication:");
+    ImGui::NextColumn();
+    ImGui::TextRight(0.0f, "%d fps", ConfigManager::Get().GetConfigInt(configid_int_state_performance_duplication_fps));
+    ImGui::NextColumn();
+
+    ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);  //Reduce horizontal spacing
+    ImGui::Text("Wakeups:");
+    ImGui::NextColumn();
+    ImGui::TextRight(right_border_offset, "%d/s", ConfigManager::Get().GetConfigInt(configid_int_state_performance_duplication_wakeups));
+    ImGui::NextColumn();
+
+    //-Cursor updates from Desktop Duplication, only shown while there are any
+    const int cursor_updates = ConfigManager::Get().GetConfigInt(configid_int_state_performance_cursor_updates);
+
+    if (cursor_updates != -1)
+    {
+        ImGui::Text("Cursor:");
+        ImGui::NextColumn();
+        ImGui::TextRight(0.0f, "%d/s", cursor_updates);
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Coalesced:");
+        ImGui::NextColumn();
+        ImGui::TextRight(right_border_offset, "%d/s", ConfigManager::Get().GetConfigInt(configid_int_state_performance_cursor_coalesced));
+        ImGui::NextColumn();
+    }
+
+    //-Overlay transforms of the dashboard app, only shown once there's data
+    const int transform_submitted = ConfigManager::Get().GetConfigInt(configid_int_state_performance_transform_submitted);
+
+    if (transform_submitted != -1)
+    {
+        ImGui::Text("Transforms:");
+        ImGui::NextColumn();
+        ImGui::TextRight(0.0f, "%d/s", transform_submitted);
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Skipped:");
+        ImGui::NextColumn();
+        ImGui::TextRight(right_border_offset, "%d/s", ConfigManager::Get().GetConfigInt(configid_int_state_performance_transform_skipped));
+        ImGui::NextColumn();
+    }
+
+    //-Graphics Capture, a few rows for each overlay using it
+    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+    {
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+
+        if (data.ConfigInt[configid_int_overlay_capture_source] != ovrl_capsource_winrt_capture)
+            continue;
+
+        const bool has_metrics = (data.ConfigInt[configid_int_overlay_state_capture_fps] != -1);
+
+        if (!has_metrics)
+            ImGui::PushItemDisabled();
+
+        ImGui::Text("%s:", data.ConfigNameStr.c_str());
+        ImGui::NextColumn();
+
+        if (has_metrics)
+            ImGui::TextRight(0.0f, "%d fps", data.ConfigInt[configid_int_overlay_state_capture_fps]);
+        else
+            ImGui::TextRight(0.0f, "N/A");
+
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Dropped:");
+        ImGui::NextColumn();
+
+        if (has_metrics)
+            ImGui::TextRight(right_border_offset, "%d fps", data.ConfigInt[configid_int_overlay_state_capture_dropped_fps]);
+        else
+            ImGui::TextRight(right_border_offset, "N/A");
+
+        ImGui::NextColumn();
+
+        //-Latency and Over-Under 3D conversion time, if there's any
+        const int latency_us     = data.ConfigInt[configid_int_overlay_state_capture_latency_us];
+        const int latency_max_us = data.ConfigInt[configid_int_overlay_state_capture_latency_max_us];
+        const int conversion_us  = data.ConfigInt[configid_int_overlay_state_capture_conversion_us];
+
+        ImGui::Text("Latency:");
+        ImGui::NextColumn();
+
+        if (latency_us != -1)
+            ImGui::TextRight(0.0f, "%.2f ms", latency_us / 1000.0f);
+        else
+            ImGui::TextRight(0.0f, "N/A");
+
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Max Latency:");
+        ImGui::NextColumn();
+
+        if (latency_max_us != -1)
+            ImGui::TextRight(right_border_offset, "%.2f ms", latency_max_us / 1000.0f);
+        else
+            ImGui::TextRight(right_border_offset, "N/A");
+
+        ImGui::NextColumn();
+
+        if (conversion_us != -1)
+        {
+            ImGui::Text("3D Conversion:");
+            ImGui::NextColumn();
+            ImGui::TextRight(0.0f, "%.2f ms", conversion_us / 1000.0f);
+            ImGui::NextColumn();
+            ImGui::NextColumn();
+            ImGui::NextColumn();
+        }
+
+        if (!has_metrics)
+            ImGui::PopItemDisabled();
+    }
+
+    //-Graphics Capture worker thread command latency, only shown once there were any
+    const int request_avg_us = ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_request_avg_us);
+
+    if (request_avg_us != -1)
+    {
+        const int request_timeouts = ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_request_timeouts);
+
+        ImGui::Text("Requests:");
+        ImGui::NextColumn();
+        ImGui::TextRight(0.0f, "%.2f ms", request_avg_us / 1000.0f);
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Max Request:");
+        ImGui::NextColumn();
+
+        //Warning color if the main thread ever stopped waiting on a request
+        if (request_timeouts > 0)
+            ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
+
+        ImGui::TextRight(right_border_offset, "%.2f ms", ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_request_max_us) / 1000.0f);
+
+        if (request_timeouts > 0)
+            ImGui::PopStyleColor();
+
+        ImGui::NextColumn();
+    }
+
+    //-Graphics Capture window state cache, only shown while window captures are running
+    const int window_cache_hits = ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_window_cache_hits);
+
+    if (window_cache_hits != -1)
+    {
+        ImGui::Text("Window Cache:");
+        ImGui::NextColumn();
+        ImGui::TextRight(0.0f, "%d/s", window_cache_hits);
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Fallbacks:");
+        ImGui::NextColumn();
+        ImGui::TextRight(right_border_offset, "%d/s", ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_window_cache_fallbacks));
+        ImGui::NextColumn();
+    }
+
+    //-Graphics Capture teardowns, only shown once there were any
+    if (ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_teardown_count) > 0)
+    {
+        ImGui::Text("Teardowns:");
+        ImGui::NextColumn();
+        ImGui::TextRight(0.0f, "%d", ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_teardown_count));
+        ImGui::NextColumn();
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() - item_spacing_half);
+        ImGui::Text("Max Teardown:");
+        ImGui::NextColumn();
+        ImGui::TextRight(right_border_offset, "%d ms", ConfigManager::Get().GetConfigInt(configid_int_state_performance_capture_teardown_max_ms));
+        ImGui::NextColumn();
+    }
+}
+
 void WindowPerformance::DisplayStatsCompact()
 {
     const float item_spacing_prev = ImGui::GetStyle().ItemSpacing.x;
@@ -651,27 +859,27 @@ void WindowPerformance::DisplayStatsCompact()
 
         //-CPU Frame Time
         //Warning color when frame time above 95% vsync time
-        if (m_FrameTimeCPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeCPU > frame_time_warning_limit)
             ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-        ImGui::TextRight(text_ms_width, "%.2f", m_FrameTimeCPU);
+        ImGui::TextRight(text_ms_width, "%.2f", m_Snapshot.FrameTimeCPU);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted(" ms");
         ImGui::NextColumn();
 
-        if (m_FrameTimeCPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeCPU > frame_time_warning_limit)
             ImGui::PopStyleColor();
 
         //-CPU Load
-        ImGui::TextRight(text_percent_width, "%.2f", m_PerfData.GetCPULoadPrecentage());
+        ImGui::TextRight(text_percent_width, "%.2f", m_Snapshot.CPULoad);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted("%");
         ImGui::NextColumn();
 
         //-RAM
-        ImGui::TextRight(text_ram_padding, "%.2f GB/", m_PerfData.GetRAMUsedGB());
+        ImGui::TextRight(text_ram_padding, "%.2f GB/", m_Snapshot.RAMUsedGB);
         ImGui::SameLine(0.0f, 0.0f);
-        ImGui::TextRight(0.0f, "%.2f GB", m_PerfData.GetRAMTotalGB());
+        ImGui::TextRight(0.0f, "%.2f GB", m_Snapshot.RAMTotalGB);
         text_ram_total_width = ImGui::GetItemRectSize().x;
         ImGui::NextColumn();
     }
@@ -683,29 +891,29 @@ void WindowPerformance::DisplayStatsCompact()
         ImGui::NextColumn();
 
         //-GPU Frame Time
-        if (m_FrameTimeGPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeGPU > frame_time_warning_limit)
             ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-        ImGui::TextRight(text_ms_width, "%.2f", m_FrameTimeGPU);
+        ImGui::TextRight(text_ms_width, "%.2f", m_Snapshot.FrameTimeGPU);
         ImGui::SameLine(0.0f, 0.0f);
         ImGui::TextUnformatted(" ms");
         ImGui::NextColumn();
 
-        if (m_FrameTimeGPU > frame_time_warning_limit)
+        if (m_Snapshot.FrameTimeGPU > frame_time_warning_limit)
             ImGui::PopStyleColor();
 
         if (!ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_disable_gpu_counters)) //No point in showing it all if it's not updating
         {
             //-GPU Load
-            ImGui::TextRight(text_percent_width, "%.2f", m_PerfData.GetGPULoadPrecentage());
+            ImGui::TextRight(text_percent_width, "%.2f", m_Snapshot.GPULoad);
             ImGui::SameLine(0.0f, 0.0f);
             ImGui::TextUnformatted("%");
             ImGui::NextColumn();
 
             //-VRAM
-            ImGui::TextRight(text_ram_padding, "%.2f GB/", m_PerfData.GetVRAMUsedGB());
+            ImGui::TextRight(text_ram_padding, "%.2f GB/", m_Snapshot.VRAMUsedGB);
             ImGui::SameLine(0.0f, 0.0f);
-            ImGui::TextRight(0.0f, "%.2f GB", m_PerfData.GetVRAMTotalGB());
+            ImGui::TextRight(0.0f, "%.2f GB", m_Snapshot.VRAMTotalGB);
             text_vram_total_width = ImGui::GetItemRectSize().x;
             ImGui::NextColumn();
         }
@@ -772,15 +980,15 @@ void WindowPerformance::DisplayStatsCompact()
         ImGui::TextRight(text_percentage_cwidth, "L");
         ImGui::SameLine(0.0f, 0.0f);
 
-        if (m_BatteryLeft != -1.0f)
+        if (m_Snapshot.BatteryLeft != -1.0f)
         {
             //15% warning color
-            if (m_BatteryLeft < 15.0f)
+            if (m_Snapshot.BatteryLeft < 15.0f)
                 ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-            ImGui::TextRight(0.0f, "%.0f%%", m_BatteryLeft);
+            ImGui::TextRight(0.0f, "%.0f%%", m_Snapshot.BatteryLeft);
 
-            if (m_BatteryLeft < 15.0f)
+            if (m_Snapshot.BatteryLeft < 15.0f)
                 ImGui::PopStyleColor();
         }
         else
@@ -796,15 +1004,15 @@ void WindowPerformance::DisplayStatsCompact()
         ImGui::TextRight(text_percentage_cwidth, "R");
         ImGui::SameLine(0.0f, 0.0f);
 
-        if (m_BatteryRight != -1.0f)
+        if (m_Snapshot.BatteryRight != -1.0f)
         {
             //15% warning color
-            if (m_BatteryRight < 15.0f)
+            if (m_Snapshot.BatteryRight < 15.0f)
                 ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-            ImGui::TextRight(0.0f, "%.0f%%", m_BatteryRight);
+            ImGui::TextRight(0.0f, "%.0f%%", m_Snapshot.BatteryRight);
 
-            if (m_BatteryRight < 15.0f)
+            if (m_Snapshot.BatteryRight < 15.0f)
                 ImGui::PopStyleColor();
         }
         else
@@ -817,18 +1025,18 @@ void WindowPerformance::DisplayStatsCompact()
         ImGui::NextColumn();
 
         //-Battery HMD (only shown if available)
-        if (m_BatteryHMD != -1.0f)
+        if (m_Snapshot.BatteryHMD != -1.0f)
         {
             ImGui::TextRight(text_percentage_cwidth, "H");
             ImGui::SameLine(0.0f, 0.0f);
 
             //15% warning color
-            if (m_BatteryHMD < 15.0f)
+            if (m_Snapshot.BatteryHMD < 15.0f)
                 ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-            ImGui::TextRight(0.0f, "%.0f%%", m_BatteryHMD);
+            ImGui::TextRight(0.0f, "%.0f%%", m_Snapshot.BatteryHMD);
 
-            if (m_BatteryHMD < 15.0f)
+            if (m_Snapshot.BatteryHMD < 15.0f)
                 ImGui::PopStyleColor();
         }
 
@@ -838,8 +1046,10 @@ void WindowPerformance::DisplayStatsCompact()
         if (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_trackers))
         {
             unsigned int tracker_number = 1;
-            for (const auto& tracker_pair : m_BatteryTrackers)
+            for (int i = 0; i < m_Snapshot.BatteryTrackerCount; ++i)
             {
+                const float battery = m_Snapshot.BatteryTrackers[i].Battery;
+
                 //Skip first column
                 if (ImGui::GetColumnIndex() == 0)
                 {
@@ -850,12 +1060,12 @@ void WindowPerformance::DisplayStatsCompact()
                 ImGui::SameLine(0.0f, 0.0f);
 
                 //15% warning color
-                if (tracker_pair.second < 15.0f)
+                if (battery < 15.0f)
                     ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                ImGui::TextRight(0.0f, "%.0f%%", tracker_pair.second);
+                ImGui::TextRight(0.0f, "%.0f%%", battery);
 
-                if (tracker_pair.second < 15.0f)
+                if (battery < 15.0f)
                     ImGui::PopStyleColor();
 
                 ImGui::NextColumn();
@@ -865,7 +1075,7 @@ void WindowPerformance::DisplayStatsCompact()
         }
 
         //-Vive Wireless
-        if ( (m_ViveWirelessLogPathExists) && (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless)) )
+        if ( (m_Sampler.IsViveWirelessInstalled()) && (ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless)) )
         {
             //Skip first column
             if (ImGui::GetColumnIndex() == 0)
@@ -876,15 +1086,15 @@ void WindowPerformance::DisplayStatsCompact()
             ImGui::TextRight(text_percentage_cwidth, "VW");
             ImGui::SameLine(0.0f, 0.0f);
 
-            if (m_ViveWirelessTemp != -1)
+            if (m_Snapshot.ViveWirelessTemp != -1)
             {
                 //90 degrees celsius warning color
-                if (m_ViveWirelessTemp > 90)
+                if (m_Snapshot.ViveWirelessTemp > 90)
                     ImGui::PushStyleColor(ImGuiCol_Text, Style_ImGuiCol_TextWarning);
 
-                ImGui::TextRight(0.0f, "%d\xC2\xB0""C", m_ViveWirelessTemp);
+                ImGui::TextRight(0.0f, "%d\xC2\xB0""C", m_Snapshot.ViveWirelessTemp);
 
-                if (m_ViveWirelessTemp > 90)
+                if (m_Snapshot.ViveWirelessTemp > 90)
                     ImGui::PopStyleColor();
             }
             else
@@ -908,8 +1118,6 @@ void WindowPerformance::DisplayStatsCompact()
 
 void WindowPerformance::UpdateStatValues()
 {
-    m_PerfData.Update();
-
     //Localized time string
     SYSTEMTIME system_time;
     ::GetSystemTime(&system_time);
@@ -926,54 +1134,46 @@ void WindowPerformance::UpdateStatValues()
         m_TimeLast = system_time;
     }
 
+    //Everything else comes from the sampler thread, nothing to do if it didn't produce a new snapshot yet
+    if (!m_Sampler.GetSnapshot(m_Snapshot))
+        return;
+
     UpdateStatValuesSteamVR();
-    UpdateStatValuesViveWireless();
 }
 
 void WindowPerformance::UpdateStatValuesSteamVR()
 {
     //No OpenVR, no frame data
-    if (!UIManager::Get()->IsOpenVRLoaded())
+    if (!m_Snapshot.IsOpenVRDataValid)
         return;
 
-    //Get compositor timing from OpenVR
-    vr::Compositor_FrameTiming frame_timing_current;
-    frame_timing_current.m_nSize    = sizeof(vr::Compositor_FrameTiming);
-    bool frame_timing_current_valid = vr::VRCompositor()->GetFrameTiming(&frame_timing_current, 0);
-
-    if (frame_timing_current_valid)
+    if (m_Snapshot.IsFrameTimingValid)
     {
-        //Set current timings
-        m_FrameTimeCPU = frame_timing_current.m_flClientFrameIntervalMs + frame_timing_current.m_flCompositorRenderCpuMs;
-        m_FrameTimeGPU = frame_timing_current.m_flTotalRenderGpuMs;
-
-        //Update frame time history
-        vr::Compositor_FrameTiming frame_timing_prev;
-        frame_timing_prev.m_nSize    = sizeof(vr::Compositor_FrameTiming);
-        bool frame_timing_prev_valid = false;
+        const PerformanceFrameTimingRing& history = m_Snapshot.FrameTimingHistory;
 
         //Sanity check
-        if (frame_timing_current.m_nFrameIndex < m_FrameTimeLastIndex)
+        if ( (history.GetSize() != 0) && (history.GetNewest().FrameIndex < m_FrameTimeLastIndex) )
         {
             m_FrameTimeLastIndex = 0;
         }
 
-        //Get all frame timings since the last time we updated (but not more than max history size)
-        for (uint32_t frames_ago = std::min(frame_timing_current.m_nFrameIndex - m_FrameTimeLastIndex, (uint32_t)m_FrameTimeCPUHistory.MaxSize); frames_ago != 0; --frames_ago)
+        //Add all frame timings the sampler collected since the last time we updated
+        for (int i = 0; i < history.GetSize(); ++i)
         {
-            frame_timing_prev_valid = vr::VRCompositor()->GetFrameTiming(&frame_timing_prev, frames_ago);
-            //Calculate our own frame index as we get duplicates if SteamVR runs out of history
-            float frame_index = float(frame_timing_current.m_nFrameIndex - frames_ago);
+            const PerformanceFrameTiming& timing = history.Get(i);
 
-            if (frame_timing_prev_valid)
-            {
-                float frame_time_cpu = frame_timing_prev.m_flClientFrameIntervalMs + frame_timing_prev.m_flCompositorRenderCpuMs;
+            if (timing.FrameIndex < m_FrameTimeLastIndex)
+                continue;
+
+            float frame_index = float(timing.FrameIndex);
 
-                m_FrameTimeCPUHistory.AddFrame(frame_index, frame_time_cpu);
-                m_FrameTimeCPUHistoryWarning.AddFrame(frame_index, (frame_time_cpu > m_FrameTimeVsyncLimit) ? frame_time_cpu : 0.0f);
+            if (timing.IsValid)
+            {
+                m_FrameTimeCPUHistory.AddFrame(frame_index, timing.FrameTimeCPU);
+                m_FrameTimeCPUHistoryWarning.AddFrame(frame_index, (timing.FrameTimeCPU > m_FrameTimeVsyncLimit) ? timing.FrameTimeCPU : 0.0f);
 
-                m_FrameTimeGPUHistory.AddFrame(frame_index, frame_timing_prev.m_flTotalRenderGpuMs);
-                m_FrameTimeGPUHistoryWarning.AddFrame(frame_index, (frame_timing_prev.m_flTotalRenderGpuMs > m_FrameTimeVsyncLimit) ? frame_timing_prev.m_flTotalRenderGpuMs : 0.0f);
+                m_FrameTimeGPUHistory.AddFrame(frame_index, timing.FrameTimeGPU);
+                m_FrameTimeGPUHistoryWarning.AddFrame(frame_index, (timing.FrameTimeGPU > m_FrameTimeVsyncLimit) ? timing.FrameTimeGPU : 0.0f);
             }
             else //No valid data, leave gap in history
             {
@@ -985,49 +1185,51 @@ void WindowPerformance::UpdateStatValuesSteamVR()
             }
         }
 
-        m_FrameTimeLastIndex = frame_timing_current.m_nFrameIndex;
-    }
-    else
-    {
-        m_FrameTimeCPU = 0.0f;
-        m_FrameTimeGPU = 0.0f;
+        m_FrameTimeLastIndex = m_Snapshot.FrameIndex;
     }
 
-    //Update cumulative stats
-    vr::Compositor_CumulativeStats frame_stats = {0};
-    vr::VRCompositor()->GetCumulativeStats(&frame_stats, sizeof(vr::Compositor_CumulativeStats));
-
     //Reset when process changed
-    if (frame_stats.m_nPid != m_PIDLast)
+    if (m_Snapshot.StatsPID != m_PIDLast)
     {
         //Additionally check if it's actually the running application and not just some past app's stats
-        if (frame_stats.m_nPid == vr::VRApplications()->GetCurrentSceneProcessId())
+        if (m_Snapshot.StatsPID == m_Snapshot.ScenePID)
         {
-            m_PIDLast = frame_stats.m_nPid;
+            m_PIDLast = m_Snapshot.StatsPID;
             ResetCumulativeValues();
         }
     }
-    else if ( (frame_stats.m_nPid != vr::VRApplications()->GetCurrentSceneProcessId()) && (m_PIDLast != 0) ) //Not actually the running application, set last pid to 0 instead if it isn't yet
+    else if ( (m_Snapshot.StatsPID != m_Snapshot.ScenePID) && (m_PIDLast != 0) ) //Not actually the running application, set last pid to 0 instead if it isn't yet
     {
         m_PIDLast = 0;
         ResetCumulativeValues();
     }
 
+    //Update cumulative offset values if a reset is pending
+    if (m_IsCumulativeResetPending)
+    {
+        m_OffsetFramesPresents    = m_Snapshot.NumFramePresents;
+        m_OffsetReprojectedFrames = m_Snapshot.NumReprojectedFrames;
+        m_OffsetDroppedFrames     = m_Snapshot.NumDroppedFrames;
+        m_OffsetFrameIndex        = (m_Snapshot.IsFrameTimingValid) ? m_Snapshot.FrameIndex : 0;
+
+        m_IsCumulativeResetPending = false;
+    }
+
     //Apply offsets to stat values
-    uint32_t frame_presents               = frame_stats.m_nNumFramePresents             - m_OffsetFramesPresents;
-    uint32_t reprojected_frames           = frame_stats.m_nNumReprojectedFrames         - m_OffsetReprojectedFrames;
+    uint32_t frame_presents               = m_Snapshot.NumFramePresents     - m_OffsetFramesPresents;
+    uint32_t reprojected_frames           = m_Snapshot.NumReprojectedFrames - m_OffsetReprojectedFrames;
 
     //Update frame count if at least a second passed since the last time
-    if (m_FPS_TickLast + 1000 <= ::GetTickCount64())
+    if (m_FPS_TickLast + 1000 <= m_Snapshot.SampleTick)
     {
-        uint32_t frame_count = frame_timing_current.m_nFrameIndex - m_OffsetFrameIndex;
+        uint32_t frame_count = m_Snapshot.FrameIndex - m_OffsetFrameIndex;
 
-        if (vr::VRSystem()->GetTrackedDeviceActivityLevel(vr::k_unTrackedDeviceIndex_Hmd) != vr::k_EDeviceActivityLevel_Standby) //Don't count frames when entering standby
+        if (!m_Snapshot.IsHMDInStandby) //Don't count frames when entering standby
         {
             if (m_FrameCountLast != 0)
             {
-                m_FPS = frame_count - m_FrameCountLast;                                   //Total unreprojected frames rendered since last time
-                m_FPS = int(m_FPS / ((::GetTickCount64() - m_FPS_TickLast) / 1000.0f));   //Divided by seconds passed in case it has been more than just 1
+                m_FPS = frame_count - m_FrameCountLast;                                          //Total unreprojected frames rendered since last time
+                m_FPS = int(m_FPS / ((m_Snapshot.SampleTick - m_FPS_TickLast) / 1000.0f));       //Divided by seconds passed in case it has been more than just 1
 
                 m_FrameCountTotal += m_FPS;     //This means m_FrameCountTotal may not be the total frames rendered but the sum of whatever we displayed as FPS before
                 m_FrameCountTotalCount++;
@@ -1045,149 +1247,13 @@ void WindowPerformance::UpdateStatValuesSteamVR()
             }
         }
 
-        m_FPS_TickLast   = ::GetTickCount64();
+        m_FPS_TickLast   = m_Snapshot.SampleTick;
         m_FrameCountLast = frame_count;
     }
 
     //Reprojection ratio and dropped frames
     m_ReprojectionRatio = (frame_presents != 0) ? ((float)reprojected_frames / frame_presents) * 100.f : 0.0f;
-    m_DroppedFrames     = frame_stats.m_nNumDroppedFrames - m_OffsetDroppedFrames;
-
-    //Battery Left
-    vr::TrackedDeviceIndex_t device_index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand);
-
-    if (device_index != vr::k_unTrackedDeviceIndexInvalid)
-    {
-        m_BatteryLeft = vr::VRSystem()->GetFloatTrackedDeviceProperty(device_index, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
-    }
-    else
-    {
-        m_BatteryRight = -1.0f;
-    }
-
-    //Battery Right
-    device_index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
-
-    if (device_index != vr::k_unTrackedDeviceIndexInvalid)
-    {
-        m_BatteryRight = vr::VRSystem()->GetFloatTrackedDeviceProperty(device_index, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
-    }
-    else
-    {
-        m_BatteryRight = -1.0f;
-    }
-
-    //Battery HMD
-    if (vr::VRSystem()->GetBoolTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DeviceProvidesBatteryStatus_Bool))
-    {
-        m_BatteryHMD = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
-    }
-    else
-    {
-        m_BatteryHMD = -1.0f;
-    }
-
-    //Battery Trackers
-    for (auto& tracker_pair : m_BatteryTrackers)
-    {
-        tracker_pair.second = vr::VRSystem()->GetFloatTrackedDeviceProperty(tracker_pair.first, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f;
-    }
-}
-
-void WindowPerformance::UpdateStatValuesViveWireless()
-{
-    //Vive Wireless Temperatures can seemingly only be read from the log file it's constantly writing too
-    //This doesn't seem terribly efficient, but it's better than nothing
-    //Reading is done every 5 seconds
-
-    //Don't update if the path doesn't exist or it's not even enabled
-    if ( (!m_ViveWirelessLogPathExists) || (!ConfigManager::Get().GetConfigBool(configid_bool_performance_monitor_show_vive_wireless)) )
-        return;
-
-    if (m_ViveWirelessTickLast + 5000 <= ::GetTickCount64())
-    {
-        m_ViveWirelessTickLast = ::GetTickCount64();
-        m_ViveWirelessTemp = -1;
-
-        //Find the newest log file
-        std::wstring path_str = m_ViveWirelessLogPath;
-        path_str += L"*.txt";
-        std::vector< std::pair<std::wstring, ULARGE_INTEGER> > file_list;   //std::pair<filename, last_modified_time>
-        WIN32_FIND_DATA find_data;
-        HANDLE handle_find = ::FindFirstFileW(path_str.c_str(), &find_data);
-
-        if (handle_find != INVALID_HANDLE_VALUE)
-        {
-            do
-            {
-                //Add filename and last modified time in list
-                file_list.emplace_back(find_data.cFileName, ULARGE_INTEGER{find_data.ftLastWriteTime.dwLowDateTime, find_data.ftLastWriteTime.dwHighDateTime});
-            }
-            while (::FindNextFileW(handle_find, &find_data) != 0);
-
-            ::FindClose(handle_find);
-        }
-
-        auto it = std::max_element(file_list.begin(), file_list.end(), [](const auto& data_a, const auto& data_b){ return (data_a.second.QuadPart < data_b.second.QuadPart); });
-
-        if (it == file_list.end())
-            return;
-
-        //Check if the newest file is older than 2 minutes, in which case we don't use it to read a temperature at all
-        FILETIME ftime_current;
-        ::GetSystemTimeAsFileTime(&ftime_current);
-        ULARGE_INTEGER time_current{ftime_current.dwLowDateTime, ftime_current.dwHighDateTime};
-
-        if (it->second.QuadPart + 1200000000 <= time_current.QuadPart) //+ 2 minutes in 100 ns intervals
-        {
-            return;
-        }
-
-        //If the newest file is not the same as last time, reset the last used line number
-        if (it->first != m_ViveWirelessLogFileLast)
-        {
-            m_ViveWirelessLogFileLast     = it->first;
-            m_ViveWirelessLogFileLastLine = 0;
-        }
-
-        //Read log file
-        {
-            path_str = m_ViveWirelessLogPath + m_ViveWirelessLogFileLast;
-
-            std::wifstream log_file(path_str);
-
-            if (log_file.good())
-            {
-                //Imbue with utf16-le locale, as are the files Vive Wireless writes (codecvt_utf16 is deprecated starting C++17, but this is the most straight forward way to deal with this)
-                log_file.imbue(std::locale(log_file.getloc(), new std::codecvt_utf16<wchar_t, 0x10ffff, std::little_endian>()));
-
-                //Read lines and see if the M_Temperature can be found (R_Temperature isn't interesting in our case)
-                int line_count = 0;
-                std::wstring line_str;
-                std::string temp_str;
-                size_t mtemp_pos;
-
-                while (log_file.good())
-                {
-                    std::getline(log_file, line_str);
-                    line_count++;
-
-                    //Only check for the temperature value if this line is the same or greater than last time (0 if it's a new file)
-                    if (line_count >= m_ViveWirelessLogFileLastLine)
-                    {
-                        mtemp_pos = line_str.find(L"M_Temperature=");
-
-                        if (mtemp_pos != std::wstring::npos)
-                        {
-                            temp_str = StringConvertFromUTF16(line_str.substr(mtemp_pos + 14).c_str());
-                            m_ViveWirelessTemp = atoi(temp_str.c_str());
-                            m_ViveWirelessLogFileLastLine = line_count;
-                        }
-                    }
-                }
-            }
-        }
-    }
+    m_DroppedFrames     = m_Snapshot.NumDroppedFrames - m_OffsetDroppedFrames;
 }
 
 void WindowPerformance::DrawFrameTimeGraphCPU(const ImVec2& graph_size, double plot_xmin, double plot_xmax, double plot_ymax)
@@ -1382,15 +1448,7 @@ void WindowPerformance::OnWindowBoundsChanged()
 
 void WindowPerformance::RefreshTrackerBatteryList()
 {
-    m_BatteryTrackers.clear();
-
-    for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
-    {
-        if ( (vr::VRSystem()->GetTrackedDeviceClass(i) == vr::TrackedDeviceClass_GenericTracker) && (vr::VRSystem()->IsTrackedDeviceConnected(i)) )
-        {
-            m_BatteryTrackers.emplace_back(i, vr::VRSystem()->GetFloatTrackedDeviceProperty(i, vr::Prop_DeviceBatteryPercentage_Float) * 100.0f);
-        }
-    }
+    m_Sampler.RefreshTrackerList();
 }
 
 void WindowPerformance::ResetCumulativeValues()
@@ -1403,30 +1461,13 @@ void WindowPerformance::ResetCumulativeValues()
     m_FrameCountTotalCount = 0;
     m_FPS_TickLast         = 0;
 
-    m_ViveWirelessTickLast = 0;
+    //Offsets are taken from the next snapshot so they're consistent with the values they're applied to
+    m_IsCumulativeResetPending = true;
 
     //This is also called from the constructor when UIManager does not exist yet
     if ((UIManager::Get() != nullptr) && (UIManager::Get()->IsOpenVRLoaded()))
     {
         m_FrameTimeVsyncLimit = 1000.f / vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
-
-        //Update cumulative offset values
-        vr::Compositor_CumulativeStats frame_stats = {0};
-        vr::VRCompositor()->GetCumulativeStats(&frame_stats, sizeof(vr::Compositor_CumulativeStats));
-
-        m_OffsetFramesPresents              = frame_stats.m_nNumFramePresents;
-        m_OffsetReprojectedFrames           = frame_stats.m_nNumReprojectedFrames;
-        m_OffsetDroppedFrames               = frame_stats.m_nNumDroppedFrames;
-
-        //Update frame index offset
-        vr::Compositor_FrameTiming frame_timing_current;
-        frame_timing_current.m_nSize = sizeof(vr::Compositor_FrameTiming);
-        m_OffsetFrameIndex = 0;
-
-        if (vr::VRCompositor()->GetFrameTiming(&frame_timing_current, 0))
-        {
-            m_OffsetFrameIndex = frame_timing_current.m_nFrameIndex;
-        }
     }
 }
 
@@ -1438,14 +1479,14 @@ void WindowPerformance::ScheduleOverlaySharedTextureUpdate()
     m_IsOverlaySharedTextureUpdateNeeded = true;
 }
 
-Win32PerformanceData& WindowPerformance::GetPerformanceData()
+PerformanceSampler& WindowPerformance::GetPerformanceSampler()
 {
-    return m_PerfData;
+    return m_Sampler;
 }
 
 bool WindowPerformance::IsViveWirelessInstalled()
 {
-    return m_ViveWirelessLogPathExists;
+    return m_Sampler.IsViveWirelessInstalled();
 }
 
 const ImVec2 & WindowPerformance::GetPos() const
@@ -1468,6 +1509,11 @@ void WindowPerformance::SetPopupOpen(bool is_open)
     m_IsPopupOpen = is_open;
 }
 
+void WindowPerformance::SetSettingsStatsVisible(bool is_visible)
+{
+    m_IsSettingsStatsVisible = is_visible;
+}
+
 bool WindowPerformance::IsAnyOverlayUsingPerformanceMonitor()
 {
     if (!UIManager::Get()->IsOpenVRLoaded())
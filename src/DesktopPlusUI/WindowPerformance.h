@@ -5,7 +5,7 @@
 #include "imgui.h"
 #include "openvr.h"
 
-#include "Win32PerformanceData.h"
+#include "PerformanceSampler.h"
 
 //Taken from ImPlot
 struct ScrollingBufferFrameTime
@@ -52,8 +52,10 @@ class WindowPerformance
         bool m_Visible;
         ULONGLONG m_VisibleTickLast; //Valid when m_Visible is false
         bool m_IsPopupOpen;
+        bool m_IsSettingsStatsVisible;
 
-        Win32PerformanceData m_PerfData;
+        PerformanceSampler m_Sampler;
+        PerformanceSnapshot m_Snapshot;     //Copy of the newest sampler snapshot, updated in UpdateStatValues()
 
         uint32_t m_PIDLast;
 
@@ -66,28 +68,22 @@ class WindowPerformance
         uint32_t m_FrameCountTotalCount;
         ULONGLONG m_FPS_TickLast;
 
-        //Offset values for cumulative counters
+        //Offset values for cumulative counters, applied on the next snapshot after ResetCumulativeValues() was called
+        bool m_IsCumulativeResetPending;
         uint32_t m_OffsetFrameIndex;
         uint32_t m_OffsetFramesPresents;
         uint32_t m_OffsetReprojectedFrames;
         uint32_t m_OffsetDroppedFrames;
 
-        //Updated every frame
-        float m_FrameTimeCPU;
+        //Updated with every new snapshot
         ScrollingBufferFrameTime m_FrameTimeCPUHistory;
         ScrollingBufferFrameTime m_FrameTimeCPUHistoryWarning;
-        float m_FrameTimeGPU;
         ScrollingBufferFrameTime m_FrameTimeGPUHistory;
         ScrollingBufferFrameTime m_FrameTimeGPUHistoryWarning;
 
         float m_ReprojectionRatio;
         uint32_t m_DroppedFrames;
 
-        float m_BatteryHMD;
-        float m_BatteryLeft;
-        float m_BatteryRight;
-        std::vector< std::pair<vr::TrackedDeviceIndex_t, float> > m_BatteryTrackers; //List updated in RefreshTrackerBatteryList(), called on devices connect/disconnect
-
         uint32_t m_FrameTimeLastIndex;
         float m_FrameTimeVsyncLimit;
 
@@ -95,22 +91,14 @@ class WindowPerformance
         SYSTEMTIME m_TimeLast;
         std::string m_TimeStr;
 
-        //Vive Wireless
-        int m_ViveWirelessTemp;
-        ULONGLONG m_ViveWirelessTickLast;
-        std::wstring m_ViveWirelessLogPath;
-        bool m_ViveWirelessLogPathExists;
-        std::wstring m_ViveWirelessLogFileLast;
-        int m_ViveWirelessLogFileLastLine;
-
         //Overlay state
         bool m_IsOverlaySharedTextureUpdateNeeded;
 
         void DisplayStatsLarge();
         void DisplayStatsCompact();
+        void DisplayStatsLargeCapture(float right_border_offset, float item_spacing_half);
         void UpdateStatValues();
         void UpdateStatValuesSteamVR();
-        void UpdateStatValuesViveWireless();
         void DrawFrameTimeGraphCPU(const ImVec2& graph_size, double plot_xmin, double plot_xmax, double plot_ymax);
         void DrawFrameTimeGraphGPU(const ImVec2& graph_size, double plot_xmin, double plot_xmax, double plot_ymax);
 
@@ -126,13 +114,14 @@ class WindowPerformance
         void ResetCumulativeValues();
         void ScheduleOverlaySharedTextureUpdate();
 
-        Win32PerformanceData& GetPerformanceData();
+        PerformanceSampler& GetPerformanceSampler();
         bool IsViveWirelessInstalled();
 
         const ImVec2& GetPos() const;
         const ImVec2& GetSize() const;
         bool IsVisible() const;
         void SetPopupOpen(bool is_open);
+        void SetSettingsStatsVisible(bool is_visible);      //Dashboard app performance stats are active while either they or the capture stats are visible
 
         static bool IsAnyOverlayUsingPerformanceMonitor();
 };
\ No newline at end of file
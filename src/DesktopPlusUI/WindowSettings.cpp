@@ -1801,14 +1801,58 @@ void WindowSettings::UpdateCatOverlayTabAdvanced()
         ImGui::NextColumn();
 
         ImGui::SetNextItemWidth(-1);
-        const char* items[] = { "None", "Group 1", "Group 2", "Group 3" };
-        int group_id = clamp(ConfigManager::Get().GetConfigIntRef(configid_int_overlay_group_id), 0, IM_ARRAYSIZE(items) - 1);
-        if (ImGui::Combo("##ComboGroupID", &group_id, items, IM_ARRAYSIZE(items)))
+        const std::vector<std::string>& group_names = ConfigManager::Get().GetOverlayGroupNames();
+        int group_id = clamp(ConfigManager::Get().GetConfigIntRef(configid_int_overlay_group_id), 0, (int)group_names.size());
+        int do_open_group_popup = 0;    //1 = new, 2 = rename
+        if (ImGui::BeginCombo("##ComboGroupID", (group_id == 0) ? "None" : group_names[group_id - 1].c_str()))
         {
-            ConfigManager::Get().SetConfigInt(configid_int_overlay_group_id, group_id);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_group_id), group_id);
+            int group_id_old = group_id;
+
+            if (ImGui::Selectable("None", (group_id == 0)))
+                group_id = 0;
+
+            for (int i = 0; i < (int)group_names.size(); ++i)
+            {
+                ImGui::PushID(i);
+
+                if (ImGui::Selectable(group_names[i].c_str(), (group_id == i + 1)))
+                    group_id = i + 1;
+
+                ImGui::PopID();
+            }
+
+            ImGui::Separator();
+
+            //Popups are opened after the combo is closed, as they'd be closed with it otherwise
+            if (ImGui::Selectable("New Group..."))
+                do_open_group_popup = 1;
+
+            if (group_id == 0)
+                ImGui::PushItemDisabled();
+
+            if (ImGui::Selectable("Rename Group..."))
+                do_open_group_popup = 2;
+
+            if (group_id == 0)
+                ImGui::PopItemDisabled();
+
+            if (group_id != group_id_old)
+            {
+                ConfigManager::Get().SetConfigInt(configid_int_overlay_group_id, group_id);
+                IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_group_id), group_id);
+            }
+
+            ImGui::EndCombo();
+        }
+
+        if (do_open_group_popup != 0)
+        {
+            m_OverlayGroupEditID = (do_open_group_popup == 1) ? 0 : group_id;
+            ImGui::OpenPopup("OverlayGroupNamePopup");
         }
 
+        PopupOverlayGroupName();
+
         ImGui::Columns(1);
     }
 
@@ -2411,9 +2455,7 @@ void WindowSettings::UpdateCatActions()
             act.Name = "New Action";
 
             actions.push_back(act);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current), actions.size() - 1);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 1);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), (int)act.FunctionType);
+            act.SendUpdateToDashboardApp((int)actions.size() - 1, UIManager::Get()->GetWindowHandle());
 
             ConfigManager::Get().GetActionMainBarOrder().push_back({ (ActionID)(actions.size() - 1 + action_custom), false });
 
@@ -2872,12 +2914,14 @@ void WindowSettings::UpdateCatPerformance()
         bool& show_trackers        = ConfigManager::Get().GetConfigBoolRef(configid_bool_performance_monitor_show_trackers);
         bool& show_vive_wireless   = ConfigManager::Get().GetConfigBoolRef(configid_bool_performance_monitor_show_vive_wireless);
         bool& disable_gpu_counters = ConfigManager::Get().GetConfigBoolRef(configid_bool_performance_monitor_disable_gpu_counters);
+        bool& show_capture_stats   = ConfigManager::Get().GetConfigBoolRef(configid_bool_performance_monitor_show_capture_stats);
 
         //Keep unavailable options as enabled but show the check boxes as unticked to avoid confusion
         bool show_graphs_visual        = ( (use_large_style) && ((!show_cpu) && (!show_gpu)) ) ? false : show_graphs;
         bool show_time_visual          = ( ((!show_fps) && (!show_battery)) || (!use_large_style) ) ? false : show_time;
         bool show_trackers_visual      = (!show_battery) ? false : show_trackers;
         bool show_vive_wireless_visual = (!show_battery) ? false : show_vive_wireless;
+        bool show_capture_stats_visual = (!use_large_style) ? false : show_capture_stats;
 
         if (ImGui::Checkbox("Show CPU Stats", &show_cpu))
         {
@@ -2965,24 +3009,31 @@ void WindowSettings::UpdateCatPerformance()
 
         if (ImGui::Checkbox("Disable GPU Performance Counters", &disable_gpu_counters))
         {
-            //Update active performance counter state if the window is currently visible
-            if (UIManager::Get()->GetPerformanceWindow().IsVisible())
-            {
-                if (disable_gpu_counters)
-                {
-                    UIManager::Get()->GetPerformanceWindow().GetPerformanceData().DisableGPUCounters();
-                }
-                else
-                {
-                    UIManager::Get()->GetPerformanceWindow().GetPerformanceData().EnableCounters(true);
-                }
-            }
+            //Update active performance counter state, applied by the sampler thread if it's currently running
+            UIManager::Get()->GetPerformanceWindow().GetPerformanceSampler().SetGPUCountersEnabled(!disable_gpu_counters);
 
             UIManager::Get()->RepeatFrame();
         }
         ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
         ImGui::FixedHelpMarker("Disables display of GPU load % and VRAM usage.\nThis prevents GPU hardware monitoring related stutter with recent NVIDIA drivers.");
 
+        ImGui::NextColumn();
+
+        if (!use_large_style)
+            ImGui::PushItemDisabled();
+
+        if (ImGui::Checkbox("Show Capture Stats", &show_capture_stats_visual))
+        {
+            show_capture_stats = show_capture_stats_visual;
+            UIManager::Get()->RepeatFrame();
+        }
+
+        if (!use_large_style)
+            ImGui::PopItemDisabled();
+
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::FixedHelpMarker("Shows the Desktop Duplication update rate and frame stats of overlays using Graphics Capture.");
+
         ImGui::Columns(1);
         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetStyle().ItemSpacing.x);
 
@@ -3071,11 +3122,46 @@ void WindowSettings::UpdateCatPerformance()
         ImGui::Text("%d fps", ConfigManager::Get().GetConfigInt(configid_int_state_performance_duplication_fps));
         ImGui::NextColumn();
 
+        ImGui::Text("Desktop Duplication Thread Wakeups: ");
+        ImGui::NextColumn();
+
+        ImGui::Text("%d/s", ConfigManager::Get().GetConfigInt(configid_int_state_performance_duplication_wakeups));
+        ImGui::NextColumn();
+
         ImGui::Text("Cross-GPU Copy Active: ");
         ImGui::NextColumn();
 
         ImGui::Text((ConfigManager::Get().GetConfigBool(configid_bool_state_performance_gpu_copy_active)) ? "Yes" : "No");
         ImGui::NextColumn();
+
+        //Stage timings, in the same order as the p50/p99 config pairs
+        static const char* trace_stage_labels[] = {"Update", "Handle VR Events", "Draw Frame", "Draw Cursor", "Refresh Overlay Texture", "Duplication Get Frame", "Duplication Process Frame"};
+
+        for (int i = 0; i < IM_ARRAYSIZE(trace_stage_labels); ++i)
+        {
+            int value_p50 = ConfigManager::Get().GetConfigInt((ConfigID_Int)(configid_int_state_performance_trace_update_p50 + (i * 2)));
+            int value_p99 = ConfigManager::Get().GetConfigInt((ConfigID_Int)(configid_int_state_performance_trace_update_p50 + (i * 2) + 1));
+
+            ImGui::Text("%s (p50 / p99): ", trace_stage_labels[i]);
+            ImGui::NextColumn();
+
+            if (value_p50 != -1)
+                ImGui::Text("%.2f / %.2f ms", value_p50 / 1000.0f, value_p99 / 1000.0f);
+            else
+                ImGui::Text("-");
+
+            ImGui::NextColumn();
+        }
+
+        ImGui::Columns(1);
+
+        if (ImGui::Button("Write Trace File"))
+        {
+            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_action, ipcact_performance_trace_dump);
+        }
+
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::FixedHelpMarker("Writes the most recent stage timings to performance_trace.json in the Desktop+ directory.\nThe file can be viewed in chrome://tracing or Perfetto.");
     }
 
     ImGui::EndChild();
@@ -4695,6 +4781,115 @@ bool WindowSettings::PopupCurrentOverlayRename()
     return ret;
 }
 
+void WindowSettings::PopupOverlayGroupName()
+{
+    ImGui::SetNextWindowPos({ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f}, ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    if (ImGui::BeginPopupModal("OverlayGroupNamePopup", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar))
+    {
+        ImGui::SetWindowSize(ImVec2(GetSize().x * 0.45f, -1.0f));
+
+        std::vector<std::string>& group_names = ConfigManager::Get().GetOverlayGroupNames();
+        const bool is_new_group = ( (m_OverlayGroupEditID <= 0) || (m_OverlayGroupEditID > (int)group_names.size()) );
+
+        static char buf_name[1024] = "";
+        static int popup_framecount = 0;
+
+        if (ImGui::IsWindowAppearing())
+        {
+            popup_framecount = ImGui::GetFrameCount();
+
+            const std::string name = (is_new_group) ? "Group " + std::to_string(group_names.size() + 1) : group_names[m_OverlayGroupEditID - 1];
+            size_t copied_length = name.copy(buf_name, 1023);
+            buf_name[copied_length] = '\0';
+        }
+
+        ImGui::Text((is_new_group) ? "Enter Name for the new Overlay Group" : "Enter new Overlay Group Name");
+
+        bool do_save = false;
+        bool buffer_changed = false;
+
+        ImGui::SetNextItemWidth(-1.0f);
+        //The idea is to have ImGui treat this as a new widget every time the popup is open, so the cursor position isn't remembered between popups
+        ImGui::PushID(popup_framecount);
+        if (ImGui::InputText("", buf_name, 1024, ImGuiInputTextFlags_EnterReturnsTrue))
+        {
+            do_save = true;
+        }
+        ImGui::PopID();
+
+        //Focus text input when the window is appearing
+        if (ImGui::IsWindowAppearing())
+        {
+            ImGui::SetKeyboardFocusHere();
+        }
+
+        if (ImGui::IsItemEdited())
+        {
+            buffer_changed = true;
+        }
+
+        if (ImGui::PopupContextMenuInputText(nullptr, buf_name, 1024))
+        {
+            buffer_changed = true;
+        }
+
+        if (buffer_changed)
+        {
+            if (ImGui::StringContainsUnmappedCharacter(buf_name))
+            {
+                if (TextureManager::Get().AddFontBuilderString(buf_name))
+                {
+                    TextureManager::Get().ReloadAllTexturesLater();
+                }
+            }
+        }
+
+        ImGui::Separator();
+
+        //Groups are only referenced by ID, so names can be anything but empty
+        const bool is_name_empty = (buf_name[0] == '\0');
+
+        if (is_name_empty)
+            ImGui::PushItemDisabled();
+
+        if (ImGui::Button("Ok")) 
+        {
+            do_save = true;
+        }
+
+        if (is_name_empty)
+            ImGui::PopItemDisabled();
+
+        if ( (do_save) && (!is_name_empty) )
+        {
+            if (is_new_group)
+            {
+                //New groups are assigned to the current overlay right away
+                group_names.push_back(buf_name);
+
+                const int group_id = (int)group_names.size();
+                ConfigManager::Get().SetConfigInt(configid_int_overlay_group_id, group_id);
+                IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_group_id), group_id);
+            }
+            else
+            {
+                group_names[m_OverlayGroupEditID - 1] = buf_name;
+            }
+
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::SameLine();
+
+        if (ImGui::Button("Cancel")) 
+        {
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+}
+
 void WindowSettings::PopupNewOverlayProfile(std::vector<std::string>& overlay_profile_list, int& overlay_profile_selected_id, bool multi_overlay)
 {
     ImGui::SetNextWindowPos({ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f}, ImGuiCond_Always, ImVec2(0.5f, 0.5f));
@@ -4913,6 +5108,7 @@ void WindowSettings::PopupActionEdit(CustomAction& action, int id)
                     break;
                 }
                 case caction_toggle_overlay_enabled_state:
+                case caction_toggle_overlay_group_enabled_state:
                 {
                     int_id = action.IntID;
                     break;
@@ -5019,7 +5215,7 @@ void WindowSettings::PopupActionEdit(CustomAction& action, int id)
 
         ImGui::SetNextItemWidth(-1.0f);
 
-        const char* f_items[] = {"Press Keys", "Type String", "Launch Application", "Toggle Overlay Enabled State"};
+        const char* f_items[] = {"Press Keys", "Type String", "Launch Application", "Toggle Overlay Enabled State", "Toggle Overlay Group Enabled State"};
         ImGui::Combo("##ComboFunction", &action_function, f_items, IM_ARRAYSIZE(f_items));
 
         ImGui::Columns(1);
@@ -5125,6 +5321,32 @@ void WindowSettings::PopupActionEdit(CustomAction& action, int id)
                 do_save = true;
             }
         }
+        else if (action_function == caction_toggle_overlay_group_enabled_state)
+        {
+            ImGui::AlignTextToFramePadding();
+            ImGui::Text("Overlay Group");
+            ImGui::NextColumn();
+
+            ImGui::SetNextItemWidth(-1.0f);
+
+            const std::vector<std::string>& group_names = ConfigManager::Get().GetOverlayGroupNames();
+            int_id = clamp(int_id, 1, std::max((int)group_names.size(), 1));
+
+            if (ImGui::BeginCombo("##ComboGroupID", (int_id <= (int)group_names.size()) ? group_names[int_id - 1].c_str() : ""))
+            {
+                for (int i = 0; i < (int)group_names.size(); ++i)
+                {
+                    ImGui::PushID(i);
+
+                    if (ImGui::Selectable(group_names[i].c_str(), (int_id == i + 1)))
+                        int_id = i + 1;
+
+                    ImGui::PopID();
+                }
+
+                ImGui::EndCombo();
+            }
+        }
 
         ImGui::Columns(1);
 
@@ -5166,6 +5388,7 @@ void WindowSettings::PopupActionEdit(CustomAction& action, int id)
                     break;
                 }
                 case caction_toggle_overlay_enabled_state:
+                case caction_toggle_overlay_group_enabled_state:
                 {
                     action.IntID = int_id;
                     break;
@@ -5899,7 +6122,8 @@ void WindowSettings::DuplicateCurrentOverlay()
     UIManager::Get()->RepeatFrame();
 }
 
-WindowSettings::WindowSettings() : m_Visible(false), m_Alpha(0.0f), m_ActionEditIsNew(false), m_OverlayNameBufferNeedsUpdate(true), m_IsStyleScaled(false)
+WindowSettings::WindowSettings() : m_Visible(false), m_Alpha(0.0f), m_ActionEditIsNew(false), m_OverlayNameBufferNeedsUpdate(true), m_OverlayGroupEditID(0),
+                                   m_IsStyleScaled(false)
 {
 
 }
@@ -6068,18 +6292,8 @@ void WindowSettings::Update()
 
     PopInterfaceScale();
 
-    //Toggle performance stats based on the active page
-    bool& performance_stats_active = ConfigManager::Get().GetConfigBoolRef(configid_bool_state_performance_stats_active);
-    if ((selected == 5) && (m_Visible) && (!performance_stats_active))
-    {
-        performance_stats_active = true;
-        IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_bool_state_performance_stats_active), true);
-    }
-    else if (( (selected != 5) || (!m_Visible) ) && (performance_stats_active))
-    {
-        performance_stats_active = false;
-        IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_bool_state_performance_stats_active), false);
-    }
+    //Performance stats are needed while the page is visible, the Performance Monitor toggles them (see WindowPerformance::UpdateVisibleState())
+    UIManager::Get()->GetPerformanceWindow().SetSettingsStatsVisible( (selected == 5) && (m_Visible) );
 }
 
 bool WindowSettings::IsShown() const
@@ -19,6 +19,7 @@ class WindowSettings
 
         bool m_ActionEditIsNew;
         bool m_OverlayNameBufferNeedsUpdate;
+        int m_OverlayGroupEditID;                   //Group being renamed in PopupOverlayGroupName(), 0 when creating a new one
         std::vector<WindowInfo> m_CaptureWindowList;
         ImGuiStyle m_StyleOrig;
         bool m_IsStyleScaled;
@@ -51,6 +52,7 @@ class WindowSettings
         void PopupQuickStartGuide();
         bool PopupCurrentOverlayManage();
         bool PopupCurrentOverlayRename();
+        void PopupOverlayGroupName();
         void PopupNewOverlayProfile(std::vector<std::string>& overlay_profile_list, int& overlay_profile_selected_id, bool multi_overlay);
         void PopupActionEdit(CustomAction& action, int id);
         void PopupOverlayDetachedPositionChange();
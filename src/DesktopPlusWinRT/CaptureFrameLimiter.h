@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+//Deadline-based frame limiter for Graphics Capture frames
+//Frames are scheduled against absolute target times derived from the frame timestamps instead of the time processing finished, so the delivered rate doesn't drift below the target
+//Time is passed in by the caller (frame's SystemRelativeTime in practice), which keeps this free of any clock or Windows dependency
+class CaptureFrameLimiter
+{
+    private:
+        int64_t m_IntervalUS     = 0;       //0 = unlimited
+        int64_t m_NextDeadlineUS = 0;
+        bool m_HasDeadline       = false;
+
+        uint64_t m_FramesDelivered = 0;
+        uint64_t m_FramesDropped   = 0;
+        uint64_t m_FramesLate      = 0;     //Delivered frames that arrived after their slot had already passed completely
+
+    public:
+        //Changing the interval drops the current schedule, the next frame is always delivered
+        void SetInterval(int64_t interval_us)
+        {
+            if (interval_us != m_IntervalUS)
+            {
+                m_IntervalUS  = interval_us;
+                m_HasDeadline = false;
+            }
+        }
+
+        int64_t GetInterval() const
+        {
+            return m_IntervalUS;
+        }
+
+        //Returns true if the frame with the given timestamp should be processed, false if it should be dropped
+        bool OnFrame(int64_t frame_time_us)
+        {
+            if (m_IntervalUS <= 0)
+            {
+                m_FramesDelivered++;
+                return true;
+            }
+
+            if (m_HasDeadline)
+            {
+                //Frames arrive in the source's refresh cadence with some jitter, so accept them slightly ahead of the deadline
+                //Otherwise a frame arriving just before it would push delivery out by a whole source frame
+                if (frame_time_us < m_NextDeadlineUS - (m_IntervalUS / 4))
+                {
+                    m_FramesDropped++;
+                    return false;
+                }
+
+                if (frame_time_us >= m_NextDeadlineUS + m_IntervalUS)
+                {
+                    m_FramesLate++;
+                }
+
+                m_NextDeadlineUS += m_IntervalUS;
+
+                //Resync instead of delivering a burst of frames to catch up if we fell behind by more than a slot (source paused, no window changes, etc.)
+                if (m_NextDeadlineUS <= frame_time_us)
+                {
+                    m_NextDeadlineUS = frame_time_us + m_IntervalUS;
+                }
+            }
+            else
+            {
+                m_NextDeadlineUS = frame_time_us + m_IntervalUS;
+                m_HasDeadline    = true;
+            }
+
+            m_FramesDelivered++;
+            return true;
+        }
+
+        void ResetCounters()
+        {
+            m_FramesDelivered = 0;
+            m_FramesDropped   = 0;
+            m_FramesLate      = 0;
+        }
+
+        uint64_t GetFramesDelivered() const { return m_FramesDelivered; }
+        uint64_t GetFramesDropped()   const { return m_FramesDropped;   }
+        uint64_t GetFramesLate()      const { return m_FramesLate;      }
+};
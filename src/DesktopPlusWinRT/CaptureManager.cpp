@@ -18,6 +18,7 @@ namespace winrt
     using namespace Windows::UI::Popups;
     using namespace Windows::Graphics::Capture;
     using namespace Windows::Graphics::DirectX;
+    using namespace Windows::Graphics::DirectX::Direct3D11;
 }
 
 namespace util
@@ -25,12 +26,16 @@ namespace util
     using namespace desktop;
 }
 
-CaptureManager::CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main_thread_id) : m_ThreadData(thread_data)
+CaptureManager::CaptureManager(DPWinRTCaptureData& capture_data, winrt::IDirect3DDevice const& device, DWORD global_main_thread_id) : m_CaptureData(capture_data)
 {
     m_CaptureMainThread = winrt::DispatcherQueue::GetForCurrentThread();
     m_GlobalMainThreadID = global_main_thread_id;
+    m_Device = device;
     WINRT_VERIFY(m_CaptureMainThread != nullptr);
+}
 
+winrt::IDirect3DDevice CaptureManager::CreateCaptureDevice()
+{
     //Get the adapter recommended by OpenVR
     winrt::com_ptr<ID3D11Device> d3d_device;
     winrt::com_ptr<IDXGIFactory1> factory_ptr;
@@ -73,7 +78,7 @@ CaptureManager::CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main
 
     //Get it as WinRT D3D11 device
     auto dxgi_device = d3d_device.try_as<IDXGIDevice>();
-    m_Device = CreateDirect3DDevice(dxgi_device.get());
+    return CreateDirect3DDevice(dxgi_device.get());
 }
 
 winrt::GraphicsCaptureItem CaptureManager::StartCaptureFromWindowHandle(HWND hwnd)
@@ -118,16 +123,16 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
 
         if (window_handle != nullptr)
         {
-            m_ThreadData.SourceWindow = window_handle;
+            m_CaptureData.SourceWindow = window_handle;
 
-            for (const auto& overlay : m_ThreadData.Overlays)
+            for (const auto& overlay : m_CaptureData.Overlays)
             {
                 ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_SET_HWND, overlay.Handle, (LPARAM)window_handle);
             }
         }
         else if (desktop_id != -2)
         {
-            for (const auto& overlay : m_ThreadData.Overlays)
+            for (const auto& overlay : m_CaptureData.Overlays)
             {
                 ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_SET_DESKTOP, overlay.Handle, desktop_id);
             }
@@ -138,7 +143,7 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
     else //Picker was canceled, send status updates for overlays
     {
         co_await m_CaptureMainThread;
-        for (const auto& overlay : m_ThreadData.Overlays)
+        for (const auto& overlay : m_CaptureData.Overlays)
         {
             ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
         }
@@ -149,14 +154,15 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
 
 void CaptureManager::StartCaptureFromItem(winrt::GraphicsCaptureItem item)
 {
-    m_Capture = std::make_unique<OverlayCapture>(m_Device, item, m_PixelFormat, m_GlobalMainThreadID, m_ThreadData.Overlays, m_ThreadData.SourceWindow);
+    m_Capture = std::make_unique<OverlayCapture>(m_Device, item, m_PixelFormat, m_GlobalMainThreadID, m_CaptureData.Overlays, m_CaptureData.SourceWindow, m_CaptureData.ProcessingTimeUS.get(),
+                                                 m_CaptureData.Metrics.get());
 
     m_Capture->StartCapture();
     m_ItemClosedRevoker = item.Closed(winrt::auto_revoke, { this, &CaptureManager::OnCaptureItemClosed });
 
     //Check if all overlays of this capture are already paused and pause the capture as well then
     bool all_paused = true;
-    for (DPWinRTOverlayData& overlay_data : m_ThreadData.Overlays)
+    for (DPWinRTOverlayData& overlay_data : m_CaptureData.Overlays)
     {
         if (!overlay_data.IsPaused)
         {
@@ -176,7 +182,7 @@ void CaptureManager::OnCaptureItemClosed(winrt::GraphicsCaptureItem const&, winr
     StopCapture();
 
     //Send overlay status updates
-    for (const auto& overlay : m_ThreadData.Overlays)
+    for (const auto& overlay : m_CaptureData.Overlays)
     {
         ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
     }
@@ -4,9 +4,12 @@
 class CaptureManager
 {
     public:
-        CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main_thread_id);
+        CaptureManager(DPWinRTCaptureData& capture_data, winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice const& device, DWORD global_main_thread_id);
         ~CaptureManager() {}
 
+        //Creates a device on the adapter used by OpenVR. Captures on the same thread share the device
+        static winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice CreateCaptureDevice();
+
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem StartCaptureFromWindowHandle(HWND hwnd);
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem StartCaptureFromMonitorHandle(HMONITOR hmon);
         winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Graphics::Capture::GraphicsCaptureItem> StartCaptureWithPickerAsync();
@@ -35,6 +38,6 @@ class CaptureManager
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem::Closed_revoker m_ItemClosedRevoker;
         winrt::Windows::Graphics::DirectX::DirectXPixelFormat m_PixelFormat = winrt::Windows::Graphics::DirectX::DirectXPixelFormat::B8G8R8A8UIntNormalized;
 
-        DPWinRTThreadData& m_ThreadData;
+        DPWinRTCaptureData& m_CaptureData;
         DWORD m_GlobalMainThreadID;
 };
\ No newline at end of file
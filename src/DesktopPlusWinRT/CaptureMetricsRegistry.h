@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+//Frame metrics of Graphics Capture captures, recorded by the capture worker threads and sampled periodically by the main thread
+//Each capture records into its own CaptureMetrics without locking. The registry keeps track of them, which overlays display each capture and the last sampled values
+//Kept free of Windows/WinRT dependencies so it can be tested anywhere. Overlay handles are passed as plain integers for the same reason
+
+struct CaptureMetricsSnapshot
+{
+    uint64_t FrameRate        = 0;      //Frames delivered to overlays per second
+    uint64_t DroppedFrameRate = 0;      //Frames skipped by the update limiter per second
+    uint64_t ConversionCount  = 0;      //Over-Under 3D conversions in the sampled period, conversion times are 0 if there were none
+    uint64_t ConversionAvgUS  = 0;
+    uint64_t ConversionMaxUS  = 0;
+    uint64_t LatencyCount     = 0;      //Frames with a latency sample in the sampled period, latencies are 0 if there were none
+    uint64_t LatencyAvgUS     = 0;      //Time from the frame being captured to the overlay textures being set
+    uint64_t LatencyMaxUS     = 0;
+};
+
+class CaptureMetrics
+{
+    private:
+        std::atomic<uint64_t> m_FramesDelivered{0};
+        std::atomic<uint64_t> m_FramesDropped{0};
+        std::atomic<uint64_t> m_ConversionCount{0};
+        std::atomic<uint64_t> m_ConversionTotalUS{0};
+        std::atomic<uint64_t> m_ConversionMaxUS{0};
+        std::atomic<uint64_t> m_LatencyCount{0};
+        std::atomic<uint64_t> m_LatencyTotalUS{0};
+        std::atomic<uint64_t> m_LatencyMaxUS{0};
+
+        static void UpdateMax(std::atomic<uint64_t>& max_value, uint64_t value)
+        {
+            uint64_t current = max_value.load(std::memory_order_relaxed);
+            while ( (value > current) && (!max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) );
+        }
+
+        static uint64_t PerSecond(uint64_t count, uint64_t elapsed_us)
+        {
+            return (elapsed_us != 0) ? (count * 1000000 + elapsed_us / 2) / elapsed_us : 0;
+        }
+
+    public:
+        //- Capture thread
+        void RecordFrameDelivered()
+        {
+            m_FramesDelivered.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void RecordFrameDropped()
+        {
+            m_FramesDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void RecordConversion(uint64_t time_us)
+        {
+            m_ConversionCount.fetch_add(1, std::memory_order_relaxed);
+            m_ConversionTotalUS.fetch_add(time_us, std::memory_order_relaxed);
+            UpdateMax(m_ConversionMaxUS, time_us);
+        }
+
+        void RecordLatency(uint64_t latency_us)
+        {
+            m_LatencyCount.fetch_add(1, std::memory_order_relaxed);
+            m_LatencyTotalUS.fetch_add(latency_us, std::memory_order_relaxed);
+            UpdateMax(m_LatencyMaxUS, latency_us);
+        }
+
+        //- Sampling thread
+        //Returns the values recorded since the last call and resets them. elapsed_us is the time since the last call, used to derive the rates
+        //Counters are taken individually, so a frame recorded during the call may be split between this and the next sample
+        CaptureMetricsSnapshot Sample(uint64_t elapsed_us)
+        {
+            CaptureMetricsSnapshot snapshot;
+
+            snapshot.FrameRate        = PerSecond(m_FramesDelivered.exchange(0, std::memory_order_relaxed), elapsed_us);
+            snapshot.DroppedFrameRate = PerSecond(m_FramesDropped.exchange(0, std::memory_order_relaxed),   elapsed_us);
+
+            snapshot.ConversionCount  = m_ConversionCount.exchange(0, std::memory_order_relaxed);
+            const uint64_t conversion_total_us = m_ConversionTotalUS.exchange(0, std::memory_order_relaxed);
+            snapshot.ConversionMaxUS  = m_ConversionMaxUS.exchange(0, std::memory_order_relaxed);
+            snapshot.ConversionAvgUS  = (snapshot.ConversionCount != 0) ? conversion_total_us / snapshot.ConversionCount : 0;
+
+            snapshot.LatencyCount     = m_LatencyCount.exchange(0, std::memory_order_relaxed);
+            const uint64_t latency_total_us = m_LatencyTotalUS.exchange(0, std::memory_order_relaxed);
+            snapshot.LatencyMaxUS     = m_LatencyMaxUS.exchange(0, std::memory_order_relaxed);
+            snapshot.LatencyAvgUS     = (snapshot.LatencyCount != 0) ? latency_total_us / snapshot.LatencyCount : 0;
+
+            return snapshot;
+        }
+};
+
+class CaptureMetricsRegistry
+{
+    private:
+        struct CaptureEntry
+        {
+            unsigned int CaptureID;
+            std::shared_ptr<CaptureMetrics> Metrics;
+            std::vector<uint64_t> OverlayHandles;
+            CaptureMetricsSnapshot LastSnapshot;
+            bool HasSnapshot;
+            uint64_t LastSampleTimeUS;
+        };
+
+        mutable std::mutex m_Mutex;
+        std::vector<CaptureEntry> m_Captures;
+
+        CaptureEntry* FindCapture(unsigned int capture_id)
+        {
+            auto it = std::find_if(m_Captures.begin(), m_Captures.end(), [&](const CaptureEntry& entry){ return (entry.CaptureID == capture_id); });
+            return (it != m_Captures.end()) ? &*it : nullptr;
+        }
+
+    public:
+        //Returns the metrics the capture should record into. They stay valid for as long as the capture holds on to them, even after RemoveCapture()
+        //now_us is the start of the first sampled period
+        std::shared_ptr<CaptureMetrics> AddCapture(unsigned int capture_id, uint64_t now_us)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            CaptureEntry* entry = FindCapture(capture_id);
+
+            if (entry == nullptr)
+            {
+                m_Captures.push_back({capture_id, std::make_shared<CaptureMetrics>(), {}, CaptureMetricsSnapshot(), false, now_us});
+                entry = &m_Captures.back();
+            }
+
+            return entry->Metrics;
+        }
+
+        void RemoveCapture(unsigned int capture_id)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Captures.erase(std::remove_if(m_Captures.begin(), m_Captures.end(), [&](const CaptureEntry& entry){ return (entry.CaptureID == capture_id); }), m_Captures.end());
+        }
+
+        //Replaces the list of overlays displaying the capture
+        void SetCaptureOverlays(unsigned int capture_id, const std::vector<uint64_t>& overlay_handles)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (CaptureEntry* entry = FindCapture(capture_id))
+            {
+                entry->OverlayHandles = overlay_handles;
+            }
+        }
+
+        //Samples all captures. Periods shorter than min_period_us are skipped so calling this more often than intended doesn't produce noisy rates
+        void Sample(uint64_t now_us, uint64_t min_period_us = 500000)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (CaptureEntry& entry : m_Captures)
+            {
+                if ( (now_us <= entry.LastSampleTimeUS) || (now_us - entry.LastSampleTimeUS < min_period_us) )
+                    continue;
+
+                entry.LastSnapshot     = entry.Metrics->Sample(now_us - entry.LastSampleTimeUS);
+                entry.HasSnapshot      = true;
+                entry.LastSampleTimeUS = now_us;
+            }
+        }
+
+        //Returns false if no capture displayed on the overlay has been sampled yet
+        bool GetOverlaySnapshot(uint64_t overlay_handle, CaptureMetricsSnapshot& snapshot_out) const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (const CaptureEntry& entry : m_Captures)
+            {
+                if ( (entry.HasSnapshot) && (std::find(entry.OverlayHandles.begin(), entry.OverlayHandles.end(), overlay_handle) != entry.OverlayHandles.end()) )
+                {
+                    snapshot_out = entry.LastSnapshot;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        size_t GetCaptureCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Captures.size();
+        }
+};
@@ -0,0 +1,112 @@
+#ifndef DPLUSWINRT_STUB
+
+#include "CommonHeaders.h"
+#include "CaptureReaper.h"
+
+#include "DesktopPlusWinRT.h"
+
+//Grace periods before closing a frame pool. A few ms are actually enough on 1809, but do 500 just to be safe
+#define CAPTURE_REAPER_GRACE_PERIOD_1809 500
+#define CAPTURE_REAPER_GRACE_PERIOD      20
+
+CaptureReaper::CaptureReaper()
+{
+    //The crash is only known to happen on 1809, which is also the only supported build without capture from handle support (1903)
+    m_GracePeriodMS = (DPWinRT_IsCaptureFromHandleSupported()) ? CAPTURE_REAPER_GRACE_PERIOD : CAPTURE_REAPER_GRACE_PERIOD_1809;
+}
+
+CaptureReaper& CaptureReaper::Get()
+{
+    //Intentionally never destroyed, as the reaper thread may still be waiting on the members during process exit
+    static CaptureReaper* reaper = new CaptureReaper();
+    return *reaper;
+}
+
+uint64_t CaptureReaper::GetTimeMS()
+{
+    return ::GetTickCount64();
+}
+
+void CaptureReaper::Add(winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool&& frame_pool)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        //Thread is only started on first use and kept around afterwards, it's just waiting when there's nothing to do
+        if (m_ThreadHandle == nullptr)
+        {
+            m_ThreadHandle = ::CreateThread(nullptr, 0, ReaperThreadEntry, this, 0, nullptr);
+        }
+
+        if (m_ThreadHandle != nullptr)
+        {
+            m_Queue.Push(std::move(frame_pool), GetTimeMS(), m_GracePeriodMS);
+            m_QueueCondition.notify_one();
+            return;
+        }
+    }
+
+    //Thread couldn't be created, fall back to waiting it out on the calling thread
+    ::Sleep((DWORD)m_GracePeriodMS);
+    frame_pool.Close();
+}
+
+TeardownLatencyHistogram CaptureReaper::GetLatencyHistogram()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Queue.GetLatencyHistogram();
+}
+
+DWORD WINAPI CaptureReaper::ReaperThreadEntry(void* param)
+{
+    winrt::init_apartment(winrt::apartment_type::multi_threaded);
+
+    ((CaptureReaper*)param)->ReaperThreadLoop();
+
+    return 0;
+}
+
+void CaptureReaper::ReaperThreadLoop()
+{
+    winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool frame_pool{ nullptr };
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            uint64_t wait_ms;
+            while ((wait_ms = m_Queue.GetTimeUntilNextDue(GetTimeMS())) != 0)
+            {
+                if (wait_ms == UINT64_MAX)
+                {
+                    m_QueueCondition.wait(lock);
+                }
+                else
+                {
+                    m_QueueCondition.wait_for(lock, std::chrono::milliseconds(wait_ms));
+                }
+            }
+
+            m_Queue.PopDue(GetTimeMS(), frame_pool);
+        }
+
+        //Close outside of the lock so new captures can be queued in the meantime
+        #ifndef _DEBUG
+        try
+        #endif
+        {
+            frame_pool.Close();
+        }
+        #ifndef _DEBUG
+        catch (const winrt::hresult_error&)
+        {
+            //Nothing left to do with it either way
+        }
+        #endif
+
+        frame_pool = nullptr;
+    }
+}
+
+#endif //DPLUSWINRT_STUB
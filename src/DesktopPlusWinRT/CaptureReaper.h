@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+
+#include "CaptureTeardownQueue.h"
+
+//Disposes of closed Graphics Capture frame pools on a dedicated thread after a grace period
+//Closing a frame pool right after its session can crash in GraphicsCapture.dll on Windows 10 1809 (see OverlayCapture::Close()),
+//so this keeps the wait off of the capture threads and allows several captures to be torn down at the same time
+class CaptureReaper
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_QueueCondition;
+        CaptureTeardownQueue<winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool> m_Queue;  //Protected by m_Mutex
+        HANDLE m_ThreadHandle = nullptr;                                                               //Protected by m_Mutex
+        uint64_t m_GracePeriodMS;                                                                      //Not modified after construction
+
+        CaptureReaper();
+
+        static uint64_t GetTimeMS();
+        static DWORD WINAPI ReaperThreadEntry(void* param);
+        void ReaperThreadLoop();
+
+    public:
+        static CaptureReaper& Get();
+
+        //Takes over the frame pool. The session using it should already be closed and its event handlers revoked
+        void Add(winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool&& frame_pool);
+
+        TeardownLatencyHistogram GetLatencyHistogram();
+};
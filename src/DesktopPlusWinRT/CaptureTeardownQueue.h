@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+//Latency histogram with fixed millisecond buckets
+class TeardownLatencyHistogram
+{
+    public:
+        static const int BucketCount = 10;
+
+    private:
+        uint64_t m_Buckets[BucketCount] = {0};
+        uint64_t m_Count = 0;
+        uint64_t m_MaxMS = 0;
+
+    public:
+        //Upper bound of the bucket in ms (exclusive). The last bucket has no upper bound and returns UINT64_MAX
+        static uint64_t GetBucketUpperBound(int bucket)
+        {
+            static const uint64_t bounds[BucketCount] = {1, 5, 10, 25, 50, 100, 250, 500, 1000, UINT64_MAX};
+            return bounds[bucket];
+        }
+
+        void Record(uint64_t latency_ms)
+        {
+            int bucket = 0;
+            while (latency_ms >= GetBucketUpperBound(bucket))
+            {
+                bucket++;
+            }
+
+            m_Buckets[bucket]++;
+            m_Count++;
+
+            if (latency_ms > m_MaxMS)
+            {
+                m_MaxMS = latency_ms;
+            }
+        }
+
+        uint64_t GetBucket(int bucket) const { return m_Buckets[bucket]; }
+        uint64_t GetCount() const            { return m_Count; }
+        uint64_t GetMaxMS() const            { return m_MaxMS; }
+};
+
+//Holds objects until their grace period has passed, in the order they were added
+//Time is passed in by the caller in milliseconds, so the queue works with any clock
+//Not thread-safe by itself, CaptureReaper protects it with a mutex
+template<class T>
+class CaptureTeardownQueue
+{
+    private:
+        struct Item
+        {
+            T Object;
+            uint64_t AddedMS;
+            uint64_t DueMS;
+        };
+
+        std::deque<Item> m_Items;
+
+        //- Latency between adding an object and it being popped
+        TeardownLatencyHistogram m_LatencyHistogram;
+
+    public:
+        void Push(T&& object, uint64_t now_ms, uint64_t grace_period_ms)
+        {
+            //Grace periods can differ, keep the queue ordered by due time. Due times are almost always increasing, so search from the back
+            uint64_t due_ms = now_ms + grace_period_ms;
+            auto it = m_Items.end();
+
+            while ( (it != m_Items.begin()) && ((it - 1)->DueMS > due_ms) )
+            {
+                --it;
+            }
+
+            m_Items.insert(it, Item{std::move(object), now_ms, due_ms});
+        }
+
+        //Moves the oldest due object to object_out and returns true, or returns false if nothing is due yet
+        bool PopDue(uint64_t now_ms, T& object_out)
+        {
+            if ( (m_Items.empty()) || (m_Items.front().DueMS > now_ms) )
+                return false;
+
+            object_out = std::move(m_Items.front().Object);
+            m_LatencyHistogram.Record(now_ms - m_Items.front().AddedMS);
+            m_Items.pop_front();
+
+            return true;
+        }
+
+        //Returns ms until the next object is due, 0 if one is due already or UINT64_MAX if the queue is empty
+        uint64_t GetTimeUntilNextDue(uint64_t now_ms) const
+        {
+            if (m_Items.empty())
+                return UINT64_MAX;
+
+            return (m_Items.front().DueMS > now_ms) ? m_Items.front().DueMS - now_ms : 0;
+        }
+
+        size_t GetSize() const
+        {
+            return m_Items.size();
+        }
+
+        const TeardownLatencyHistogram& GetLatencyHistogram() const
+        {
+            return m_LatencyHistogram;
+        }
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+//Assigns captures to a fixed number of worker threads and balances them by observed frame processing cost
+//Load is measured in microseconds of frame processing per second. Captures without observations yet are estimated
+//Only does the bookkeeping, moving captures between threads is up to the caller. Kept free of Windows/WinRT dependencies so it can be tested anywhere
+//Not thread-safe by itself, DesktopPlusWinRT protects it with g_CapturesMutex
+
+struct CaptureWorkerMove
+{
+    unsigned int CaptureID;
+    int WorkerFrom;
+    int WorkerTo;
+};
+
+class CaptureWorkerScheduler
+{
+    public:
+        static const uint64_t DefaultCaptureLoad = 1000;    //Assumed load for captures when no other capture has been observed either
+        static const uint64_t MinImbalance       = 5000;    //Difference in load between workers below which no moves are made to avoid shuffling captures around for nothing
+
+    private:
+        struct CaptureEntry
+        {
+            unsigned int CaptureID;
+            int WorkerID;
+            bool IsMovable;
+            bool HasLoad;                   //False until two processing time samples were taken
+            uint64_t Load;
+            uint64_t LastProcessingTimeUS;
+            uint64_t LastSampleTimeUS;
+            bool HasSample;
+        };
+
+        std::vector<CaptureEntry> m_Captures;
+        int m_WorkerCount = 1;
+
+        CaptureEntry* FindCapture(unsigned int capture_id)
+        {
+            auto it = std::find_if(m_Captures.begin(), m_Captures.end(), [&](const CaptureEntry& entry){ return (entry.CaptureID == capture_id); });
+            return (it != m_Captures.end()) ? &*it : nullptr;
+        }
+
+        uint64_t GetEstimatedLoad() const
+        {
+            uint64_t load_total = 0;
+            uint64_t load_count = 0;
+
+            for (const CaptureEntry& entry : m_Captures)
+            {
+                if (entry.HasLoad)
+                {
+                    load_total += entry.Load;
+                    load_count++;
+                }
+            }
+
+            return (load_count != 0) ? std::max<uint64_t>(load_total / load_count, 1) : DefaultCaptureLoad;
+        }
+
+        uint64_t GetCaptureLoad(const CaptureEntry& entry, uint64_t estimated_load) const
+        {
+            return (entry.HasLoad) ? entry.Load : estimated_load;
+        }
+
+        void GetWorkerLoads(std::vector<uint64_t>& loads, std::vector<int>& capture_counts) const
+        {
+            loads.assign(m_WorkerCount, 0);
+            capture_counts.assign(m_WorkerCount, 0);
+            const uint64_t estimated_load = GetEstimatedLoad();
+
+            for (const CaptureEntry& entry : m_Captures)
+            {
+                loads[entry.WorkerID] += GetCaptureLoad(entry, estimated_load);
+                capture_counts[entry.WorkerID]++;
+            }
+        }
+
+    public:
+        //Should only be called while no captures are assigned
+        void SetWorkerCount(int worker_count)
+        {
+            m_WorkerCount = std::max(worker_count, 1);
+        }
+
+        int GetWorkerCount() const
+        {
+            return m_WorkerCount;
+        }
+
+        //Returns the worker the capture was assigned to. Captures that are not movable are never touched by Rebalance()
+        int AddCapture(unsigned int capture_id, bool is_movable)
+        {
+            std::vector<uint64_t> loads;
+            std::vector<int> capture_counts;
+            GetWorkerLoads(loads, capture_counts);
+
+            //Least loaded worker, fewest captures on ties
+            int worker_id = 0;
+            for (int i = 1; i < m_WorkerCount; ++i)
+            {
+                if ( (loads[i] < loads[worker_id]) || ( (loads[i] == loads[worker_id]) && (capture_counts[i] < capture_counts[worker_id]) ) )
+                {
+                    worker_id = i;
+                }
+            }
+
+            m_Captures.push_back({capture_id, worker_id, is_movable, false, 0, 0, 0, false});
+
+            return worker_id;
+        }
+
+        void RemoveCapture(unsigned int capture_id)
+        {
+            m_Captures.erase(std::remove_if(m_Captures.begin(), m_Captures.end(), [&](const CaptureEntry& entry){ return (entry.CaptureID == capture_id); }), m_Captures.end());
+        }
+
+        //Returns -1 if the capture doesn't exist
+        int GetCaptureWorker(unsigned int capture_id)
+        {
+            CaptureEntry* entry = FindCapture(capture_id);
+            return (entry != nullptr) ? entry->WorkerID : -1;
+        }
+
+        //Feeds the total frame processing time of a capture, sampled at the given time. The load is derived from the difference to the previous sample
+        void UpdateCaptureProcessingTime(unsigned int capture_id, uint64_t processing_time_total_us, uint64_t now_us)
+        {
+            CaptureEntry* entry = FindCapture(capture_id);
+
+            if (entry == nullptr)
+                return;
+
+            if ( (entry->HasSample) && (now_us > entry->LastSampleTimeUS) && (processing_time_total_us >= entry->LastProcessingTimeUS) )
+            {
+                uint64_t load = ((processing_time_total_us - entry->LastProcessingTimeUS) * 1000000) / (now_us - entry->LastSampleTimeUS);
+
+                //Smooth with the previous value so a single busy or idle period doesn't cause a bunch of moves
+                entry->Load    = (entry->HasLoad) ? (entry->Load + load) / 2 : load;
+                entry->HasLoad = true;
+            }
+
+            entry->LastProcessingTimeUS = processing_time_total_us;
+            entry->LastSampleTimeUS     = now_us;
+            entry->HasSample            = true;
+        }
+
+        uint64_t GetWorkerLoad(int worker_id) const
+        {
+            std::vector<uint64_t> loads;
+            std::vector<int> capture_counts;
+            GetWorkerLoads(loads, capture_counts);
+
+            return ( (worker_id >= 0) && (worker_id < m_WorkerCount) ) ? loads[worker_id] : 0;
+        }
+
+        //Moves captures from the most to the least loaded worker while that lowers the load of the busiest worker. Returns the moves made, at most max_moves
+        std::vector<CaptureWorkerMove> Rebalance(size_t max_moves = 4)
+        {
+            std::vector<CaptureWorkerMove> moves;
+            std::vector<uint64_t> loads;
+            std::vector<int> capture_counts;
+            const uint64_t estimated_load = GetEstimatedLoad();
+
+            while (moves.size() < max_moves)
+            {
+                GetWorkerLoads(loads, capture_counts);
+
+                auto it_max = std::max_element(loads.begin(), loads.end());
+                auto it_min = std::min_element(loads.begin(), loads.end());
+                const int worker_max = (int)(it_max - loads.begin());
+                const int worker_min = (int)(it_min - loads.begin());
+                const uint64_t imbalance = *it_max - *it_min;
+
+                if (imbalance < MinImbalance)
+                    break;
+
+                //Pick the capture which gets both workers closest to half of the imbalance. Anything lighter than the imbalance lowers the maximum
+                CaptureEntry* best_entry = nullptr;
+                uint64_t best_distance = UINT64_MAX;
+
+                for (CaptureEntry& entry : m_Captures)
+                {
+                    if ( (entry.WorkerID != worker_max) || (!entry.IsMovable) )
+                        continue;
+
+                    const uint64_t load = GetCaptureLoad(entry, estimated_load);
+
+                    if ( (load == 0) || (load >= imbalance) )
+                        continue;
+
+                    const uint64_t distance = (load * 2 > imbalance) ? load * 2 - imbalance : imbalance - load * 2;
+
+                    if (distance < best_distance)
+                    {
+                        best_entry    = &entry;
+                        best_distance = distance;
+                    }
+                }
+
+                if (best_entry == nullptr)
+                    break;
+
+                best_entry->WorkerID = worker_min;
+                moves.push_back({best_entry->CaptureID, worker_max, worker_min});
+            }
+
+            return moves;
+        }
+
+        size_t GetCaptureCount() const
+        {
+            return m_Captures.size();
+        }
+};
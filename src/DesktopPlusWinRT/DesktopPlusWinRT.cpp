@@ -13,6 +13,11 @@
 #include "PickerDummyWindow.h"
 
 #include "ThreadData.h"
+#include "ThreadRequest.h"
+#include "CaptureWorkerScheduler.h"
+#include "WindowStateCache.h"
+#include "CaptureMetricsRegistry.h"
+#include "CaptureReaper.h"
 
 #include "Util.h"
 
@@ -21,24 +26,34 @@
 //Globals
 //- Not modified after DPWinRT_Init()
 static DWORD g_MainThreadID;
+static UINT  g_WorkerRequestMessageID;                      //Registered message used to post all capture worker thread commands
 static bool g_IsCaptureSupported;
 static int  g_APIContractPresent;
 
-//- Protected by g_ThreadsMutex
-static std::mutex g_ThreadsMutex;
-static std::vector<DPWinRTThreadData> g_Threads;
-
-//- Only accessed by main thread
-static bool g_IsCursorEnabled;
+//- Protected by g_CapturesMutex
+static std::mutex g_CapturesMutex;
+static std::vector<DPWinRTCaptureData> g_Captures;
+static std::vector<DPWinRTWorkerData> g_Workers;           //Sized to the worker count in DPWinRT_Init(), threads are started on first use
+static CaptureWorkerScheduler g_WorkerScheduler;
+static std::vector<DPWinRTPendingRequest> g_PendingRequests;    //Requests for captures that are being moved to another worker, in the order they were made
+static unsigned int g_CaptureIDNext = 1;
+static bool g_IsCursorEnabled;                                  //Only modified by main thread
 
 //- Rarely accessed atomics
 static std::atomic<bool> g_DesktopEnumFlagIgnoreWMRScreens;
 
+//- Atomic counters, indexed by command ID offset from WM_DPLUSWINRT
+static ThreadRequestLatencyCounter g_RequestLatencyCounters[WM_DPLUSWINRT_MESSAGE_MAX - WM_DPLUSWINRT];
+
+//- Internally synchronized. Entries are added and removed together with g_Captures, when both are locked g_CapturesMutex is locked first
+static CaptureMetricsRegistry g_CaptureMetricsRegistry;
+
 namespace winrt
 {
     using namespace Windows::Foundation;
     using namespace Windows::Foundation::Metadata;
     using namespace Windows::Graphics::Capture;
+    using namespace Windows::Graphics::DirectX::Direct3D11;
 }
 
 namespace util
@@ -63,44 +78,233 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD  ul_reason_for_call, LPVOID lpReser
 
 #ifndef DPLUSWINRT_STUB
 
-DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param);
+DWORD WINAPI WinRTCaptureWorkerEntry(_In_ void* Param);
 
-bool DPWinRT_Internal_StartCapture(vr::VROverlayHandle_t overlay_handle, const DPWinRTThreadData& data)
+struct DPWinRTWorkerStartData
 {
-    //Make sure this overlay handle is not already used by a thread
-    DPWinRT_StopCapture(overlay_handle);
+    int WorkerID;
+    HANDLE ReadyEvent;
+};
+
+ThreadRequestHandle DPWinRT_Internal_CreateThreadRequest(UINT command_id, intptr_t request_param)
+{
+    return ThreadRequestHandle::Create(command_id, &g_RequestLatencyCounters[command_id - WM_DPLUSWINRT], request_param);
+}
+
+//Posts the request to a capture worker thread in lParam. Returns false and cancels the request if it couldn't be posted
+bool DPWinRT_Internal_PostRequest(DWORD thread_id, WPARAM wparam, const ThreadRequestHandle& request)
+{
+    ThreadRequest* request_receiver = request.ShareWithReceiver();
+
+    if (!::PostThreadMessage(thread_id, g_WorkerRequestMessageID, wparam, (LPARAM)request_receiver))
+    {
+        //Thread is gone or its queue is full, nobody is going to complete this
+        request_receiver->Release();
+        request->Cancel();
+
+        return false;
+    }
+
+    return true;
+}
+
+//Posts a command to a capture worker thread. The returned handle can be used to wait on the thread processing it, or just be dropped
+ThreadRequestHandle DPWinRT_Internal_PostThreadRequest(DWORD thread_id, UINT command_id, WPARAM wparam, intptr_t request_param = 0)
+{
+    ThreadRequestHandle request = DPWinRT_Internal_CreateThreadRequest(command_id, request_param);
+    DPWinRT_Internal_PostRequest(thread_id, wparam, request);
+
+    return request;
+}
+
+//Posts a command to the worker hosting the capture. If the capture is being moved, the request is queued and posted to the new worker once it has the capture
+//g_CapturesMutex must be locked
+ThreadRequestHandle DPWinRT_Internal_PostCaptureRequest(const DPWinRTCaptureData& capture, UINT command_id, WPARAM wparam, intptr_t request_param = 0)
+{
+    if (!capture.IsMoving)
+        return DPWinRT_Internal_PostThreadRequest(capture.ThreadID, command_id, wparam, request_param);
+
+    DPWinRTPendingRequest pending;
+    pending.CaptureID = capture.CaptureID;
+    pending.WParam    = wparam;
+    pending.Request   = DPWinRT_Internal_CreateThreadRequest(command_id, request_param);
+
+    ThreadRequestHandle request(pending.Request.ShareWithReceiver());
+    g_PendingRequests.push_back(std::move(pending));
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    return request;
+}
+
+//Returns the thread ID of the worker, starting its thread first if it's not running. g_CapturesMutex must be locked
+DWORD DPWinRT_Internal_GetWorkerThreadID(int worker_id)
+{
+    DPWinRTWorkerData& worker = g_Workers[worker_id];
 
-    DPWinRTOverlayData overlay_data;
-    overlay_data.Handle = overlay_handle;
+    //Worker threads only exit after an unexpected error, in which case a new one is started on the next use
+    if ( (worker.ThreadHandle != nullptr) && (::WaitForSingleObject(worker.ThreadHandle, 0) == WAIT_OBJECT_0) )
+    {
+        ::CloseHandle(worker.ThreadHandle);
+        worker.ThreadHandle = nullptr;
+        worker.ThreadID     = 0;
+    }
 
-    //If not using picker, try to find a thread already capturing this item
-    if (!data.UsePicker)
+    if (worker.ThreadHandle == nullptr)
     {
-        for (auto& thread : g_Threads)
+        DPWinRTWorkerStartData start_data;
+        start_data.WorkerID   = worker_id;
+        start_data.ReadyEvent = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+        if (start_data.ReadyEvent == nullptr)
+            return 0;
+
+        worker.ThreadHandle = ::CreateThread(nullptr, 0, WinRTCaptureWorkerEntry, &start_data, 0, &worker.ThreadID);
+
+        if (worker.ThreadHandle != nullptr)
+        {
+            //Wait until the thread has a message queue so messages can be posted to it right away (or until it exited if something went wrong)
+            HANDLE wait_handles[2] = {start_data.ReadyEvent, worker.ThreadHandle};
+            ::WaitForMultipleObjects(2, wait_handles, FALSE, INFINITE);
+        }
+        else
         {
-            if ( (thread.DesktopID == data.DesktopID) && (thread.SourceWindow == data.SourceWindow) )
+            worker.ThreadID = 0;
+        }
+
+        ::CloseHandle(start_data.ReadyEvent);
+    }
+
+    return worker.ThreadID;
+}
+
+//Sends the capture to the worker it was assigned to. g_CapturesMutex must be locked
+void DPWinRT_Internal_StartCaptureOnWorker(DPWinRTCaptureData& capture)
+{
+    capture.ThreadID = DPWinRT_Internal_GetWorkerThreadID(capture.WorkerID);
+    DPWinRT_Internal_PostThreadRequest(capture.ThreadID, WM_DPLUSWINRT_CAPTURE_START, capture.CaptureID, g_IsCursorEnabled);
+}
+
+void DPWinRT_Internal_NotifyCaptureWindowsChanged()
+{
+    ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_WINDOWS, 0, 0);
+}
+
+//Called once the worker a capture was moved away from has let go of it. Starts the capture on its new worker and posts the requests queued in the meantime
+//g_CapturesMutex must be locked
+void DPWinRT_Internal_FinishCaptureMove(unsigned int capture_id)
+{
+    auto it = std::find_if(g_Captures.begin(), g_Captures.end(), [&](const auto& capture){ return (capture.CaptureID == capture_id); });
+    const bool is_capture_started = ( (it != g_Captures.end()) && (it->IsMoving) );
+
+    if (is_capture_started)
+    {
+        it->IsMoving = false;
+        DPWinRT_Internal_StartCaptureOnWorker(*it);   //New worker gets the latest data on start
+    }
+
+    for (auto pending_it = g_PendingRequests.begin(); pending_it != g_PendingRequests.end();)
+    {
+        if (pending_it->CaptureID != capture_id)
+        {
+            ++pending_it;
+            continue;
+        }
+
+        if (is_capture_started)
+        {
+            DPWinRT_Internal_PostRequest(it->ThreadID, pending_it->WParam, pending_it->Request);
+        }
+        else
+        {
+            //Capture was stopped during the move. The old worker already let go of it, so there's nothing left to do for these
+            pending_it->Request->Complete();
+        }
+
+        pending_it = g_PendingRequests.erase(pending_it);
+    }
+}
+
+//Samples capture processing times and moves captures to other workers if the load is unbalanced
+//Doesn't wait on the moves. The old worker stops the capture and calls DPWinRT_Internal_FinishCaptureMove(), requests made in the meantime are queued
+void DPWinRT_Internal_RebalanceCaptureWorkers()
+{
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+    const uint64_t now_us = ::GetTickCount64() * 1000;
+    for (const auto& capture : g_Captures)
+    {
+        g_WorkerScheduler.UpdateCaptureProcessingTime(capture.CaptureID, capture.ProcessingTimeUS->load(std::memory_order_relaxed), now_us);
+    }
+
+    //Let previous moves finish first
+    if (std::any_of(g_Captures.begin(), g_Captures.end(), [](const auto& capture){ return capture.IsMoving; }))
+        return;
+
+    for (const CaptureWorkerMove& move : g_WorkerScheduler.Rebalance())
+    {
+        auto it = std::find_if(g_Captures.begin(), g_Captures.end(), [&](const auto& capture){ return (capture.CaptureID == move.CaptureID); });
+
+        if (it == g_Captures.end())
+            continue;
+
+        ThreadRequestHandle request = DPWinRT_Internal_CreateThreadRequest(WM_DPLUSWINRT_CAPTURE_STOP, true);
+        const DWORD thread_id_old = it->ThreadID;
+
+        it->WorkerID = move.WorkerTo;
+        it->ThreadID = 0;
+        it->IsMoving = true;
+
+        //If the old worker is gone, there's nothing to wait for
+        if (!DPWinRT_Internal_PostRequest(thread_id_old, it->CaptureID, request))
+        {
+            DPWinRT_Internal_FinishCaptureMove(it->CaptureID);
+        }
+    }
+}
+
+bool DPWinRT_Internal_StartCapture(vr::VROverlayHandle_t overlay_handle, const DPWinRTCaptureData& data)
+{
+    //Make sure this overlay handle is not already used by a capture
+    DPWinRT_StopCapture(overlay_handle);
+
+    {
+        std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+        DPWinRTOverlayData overlay_data;
+        overlay_data.Handle = overlay_handle;
+
+        //If not using picker, try to find a capture of the same item
+        if (!data.UsePicker)
+        {
+            for (auto& capture : g_Captures)
             {
-                thread.Overlays.push_back(overlay_data);
+                if ( (capture.DesktopID == data.DesktopID) && (capture.SourceWindow == data.SourceWindow) )
+                {
+                    capture.Overlays.push_back(overlay_data);
                 
-                ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-                return true;
+                    DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID);
+                    return true;
+                }
             }
         }
-    }
 
-    //Create new thread if no existing one was found or using picker
-    g_Threads.push_back(data);
-    g_Threads.back().Overlays.push_back(overlay_data);
+        //Create new capture if no existing one was found or using picker
+        g_Captures.push_back(data);
+        DPWinRTCaptureData& capture = g_Captures.back();
 
-    //Thread may run before CreateThread() returns, but the thread will have to wait on the mutex so it's fine
-    g_Threads.back().ThreadHandle = ::CreateThread(nullptr, 0, WinRTCaptureThreadEntry, &g_Threads.back(), 0, &g_Threads.back().ThreadID);
+        capture.Overlays.push_back(overlay_data);
+        capture.CaptureID = g_CaptureIDNext++;
+        capture.ProcessingTimeUS = std::make_shared< std::atomic<uint64_t> >(0);
+        capture.Metrics = g_CaptureMetricsRegistry.AddCapture(capture.CaptureID, ::GetTickCount64() * 1000);
 
-    //If the cursor is disabled, send a message to disable it right away (non-default state)
-    if (!g_IsCursorEnabled)
-    {
-        ::PostThreadMessage(g_Threads.back().ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, g_IsCursorEnabled, 0);
+        //Picker captures can't be recreated on a different thread without asking the user again, so they stay where they are
+        capture.WorkerID = g_WorkerScheduler.AddCapture(capture.CaptureID, !capture.UsePicker);
+
+        DPWinRT_Internal_StartCaptureOnWorker(capture);
+
+        if (capture.SourceWindow != nullptr)
+        {
+            DPWinRT_Internal_NotifyCaptureWindowsChanged();
+        }
     }
 
     return true;
@@ -113,9 +317,21 @@ void DPWinRT_Init()
     #ifndef DPLUSWINRT_STUB
 
     g_MainThreadID = ::GetCurrentThreadId();
-    //Reserve thread data vector size to avoid potential race condition between resize and thread creation when many overlays are created back-to-back (while also avoiding explicit syncing there).
-    //100 should be pretty safe as a limit, considering k_unMaxOverlayCount (128) with system overlays and Desktop+ UI overlays... also 100 captures are insane either way
-    g_Threads.reserve(100);
+
+    //Registered message IDs are unique for the session. Should this somehow fail, use an ID from the app range that's not used by any other message
+    g_WorkerRequestMessageID = ::RegisterWindowMessage(L"DesktopPlusWinRT_WorkerRequest");
+
+    if (g_WorkerRequestMessageID == 0)
+    {
+        g_WorkerRequestMessageID = WM_DPLUSWINRT_MESSAGE_MAX;
+    }
+
+    //One capture worker per logical processor. Most captures are idle most of the time, so there's not much use in more
+    SYSTEM_INFO system_info;
+    ::GetSystemInfo(&system_info);
+
+    g_WorkerScheduler.SetWorkerCount((int)system_info.dwNumberOfProcessors);
+    g_Workers.resize(g_WorkerScheduler.GetWorkerCount());
 
     //Init results of capability query functions so we don't need an apartment on the main thread
     winrt::init_apartment(winrt::apartment_type::multi_threaded);
@@ -196,7 +412,7 @@ bool DPWinRT_IsCaptureCursorEnabledPropertySupported()
 bool DPWinRT_StartCaptureFromPicker(vr::VROverlayHandle_t overlay_handle)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.UsePicker = true;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -208,7 +424,7 @@ bool DPWinRT_StartCaptureFromPicker(vr::VROverlayHandle_t overlay_handle)
 bool DPWinRT_StartCaptureFromHWND(vr::VROverlayHandle_t overlay_handle, HWND handle)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.SourceWindow = handle;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -220,7 +436,7 @@ bool DPWinRT_StartCaptureFromHWND(vr::VROverlayHandle_t overlay_handle, HWND han
 bool DPWinRT_StartCaptureFromDesktop(vr::VROverlayHandle_t overlay_handle, int desktop_id)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.DesktopID = desktop_id;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -233,22 +449,22 @@ bool DPWinRT_StartCaptureFromOverlay(vr::VROverlayHandle_t overlay_handle, vr::V
 {
     #ifndef DPLUSWINRT_STUB
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-    //Find thread with the source overlay assigned and add the other overlay to it with duplicated state
+    //Find capture with the source overlay assigned and add the other overlay to it with duplicated state
     //This means this function is only good for adding capture after an overlay was duplicated, otherwise some state needs to be adjusted right after
-    for (auto& thread : g_Threads)
+    for (auto& capture : g_Captures)
     {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle_source); });
+        auto it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle_source); });
 
-        if (it != thread.Overlays.end())
+        if (it != capture.Overlays.end())
         {
             DPWinRTOverlayData overlay_data = *it;
             overlay_data.Handle = overlay_handle;
 
-            thread.Overlays.push_back(overlay_data);
+            capture.Overlays.push_back(overlay_data);
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID);
             return true;
         }
     }
@@ -262,17 +478,17 @@ bool DPWinRT_PauseCapture(vr::VROverlayHandle_t overlay_handle, bool pause)
 {
     #ifndef DPLUSWINRT_STUB
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-    //Find thread with the overlay assigned and tell it to set pause state
-    for (auto& thread : g_Threads)
+    //Find capture with the overlay assigned and tell its worker to set pause state
+    for (auto& capture : g_Captures)
     {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+        auto it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
 
-        if (it != thread.Overlays.end())
+        if (it != capture.Overlays.end())
         {
             it->IsPaused = pause;
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_CAPTURE_PAUSE, overlay_handle, pause);
+            DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_CAPTURE_PAUSE, overlay_handle, pause);
             return true;
         }
     }
@@ -286,52 +502,49 @@ bool DPWinRT_StopCapture(vr::VROverlayHandle_t overlay_handle)
 {
     #ifndef DPLUSWINRT_STUB
 
-    bool wait_for_ack = false;
-    //Clear out existing WM_DPLUSWINRT_THREAD_ACK messages first just in case
-    MSG msg;
-    while (PeekMessage(&msg, nullptr, WM_DPLUSWINRT_THREAD_ACK, WM_DPLUSWINRT_THREAD_ACK, PM_REMOVE));
+    ThreadRequestHandle request;
 
-    //Find thread with overlay and remove overlay from it
+    //Find capture with overlay and remove overlay from it
     {
-        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+        std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-        for (auto thread_it = g_Threads.begin(); thread_it != g_Threads.end(); ++thread_it)
+        for (auto capture_it = g_Captures.begin(); capture_it != g_Captures.end(); ++capture_it)
         {
-            auto& thread = *thread_it;
-            auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
+            auto& capture = *capture_it;
+            auto it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
 
-            if (it != thread.Overlays.end())
+            if (it != capture.Overlays.end())
             {
-                thread.Overlays.erase(it);
+                capture.Overlays.erase(it);
 
-                if (thread.Overlays.empty()) //Quit and remove thread when no overlays left
+                if (capture.Overlays.empty()) //Stop and remove capture when no overlays left
                 {
-                    ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_THREAD_QUIT, 0, 0);
+                    request = DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_CAPTURE_STOP, capture.CaptureID);
 
-                    ::CloseHandle(thread.ThreadHandle);
-                    g_Threads.erase(thread_it);
+                    if (capture.SourceWindow != nullptr)
+                    {
+                        DPWinRT_Internal_NotifyCaptureWindowsChanged();
+                    }
+
+                    g_WorkerScheduler.RemoveCapture(capture.CaptureID);
+                    g_CaptureMetricsRegistry.RemoveCapture(capture.CaptureID);
+                    g_Captures.erase(capture_it);
                 }
                 else //otherwise, update data
                 {
-                    ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+                    request = DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID);
                 }
 
-                wait_for_ack = true;
                 break;
             }
         }
     }
 
-    //Wait for WM_DPLUSWINRT_THREAD_ACK so we can be sure there won't be any additional overlay updates after this function returns
-    ULONGLONG start_tick = ::GetTickCount64();
-    while (wait_for_ack)
+    //Wait for the worker to process the request so we can be sure there won't be any additional overlay updates after this function returns
+    if (request)
     {
-        if ( (PeekMessage(&msg, nullptr, WM_DPLUSWINRT_THREAD_ACK, WM_DPLUSWINRT_THREAD_ACK, PM_REMOVE)) || (::GetTickCount64() >= start_tick + 500) ) //On message or 500ms timeout
-        {
-            return true;
-        }
-
-        ::Sleep(0);
+        request->Wait(500);
+        return true;
     }
 
     #endif //DPLUSWINRT_STUB
@@ -343,51 +556,50 @@ void DPWinRT_SwapCaptureTargetOverlays(vr::VROverlayHandle_t overlay_handle, vr:
 {
     #ifndef DPLUSWINRT_STUB
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
     //Find overlay data for the given overlay handles
     std::vector<DPWinRTOverlayData>::iterator ovrl_data_it, ovrl_data_it_2;
-    DWORD ovrl_data_thread_id = 0, ovrl_data_thread_id_2 = 0;
+    DPWinRTCaptureData* ovrl_data_capture = nullptr;
+    DPWinRTCaptureData* ovrl_data_capture_2 = nullptr;
 
-    for (auto thread_it = g_Threads.begin(); thread_it != g_Threads.end(); ++thread_it)
+    for (auto& capture : g_Captures)
     {
-        auto& thread = *thread_it;
-
         //Look for first handle
-        if (ovrl_data_thread_id == 0)
+        if (ovrl_data_capture == nullptr)
         {
-            ovrl_data_it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
+            ovrl_data_it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
             
-            if (ovrl_data_it != thread.Overlays.end())
+            if (ovrl_data_it != capture.Overlays.end())
             {
-                ovrl_data_thread_id = thread.ThreadID;
+                ovrl_data_capture = &capture;
             }
         }
         //Look for second handle
-        if (ovrl_data_thread_id_2 == 0)
+        if (ovrl_data_capture_2 == nullptr)
         {
-            ovrl_data_it_2 = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle_2); });
+            ovrl_data_it_2 = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle_2); });
 
-            if (ovrl_data_it_2 != thread.Overlays.end())
+            if (ovrl_data_it_2 != capture.Overlays.end())
             {
-                ovrl_data_thread_id_2 = thread.ThreadID;
+                ovrl_data_capture_2 = &capture;
             }
         }
     }
 
-    //Swap overlay handles if we can and send update messages to affected threads (unless same thread, which would be no-op)
-    if (ovrl_data_thread_id != ovrl_data_thread_id_2)
+    //Swap overlay handles if we can and send update messages for affected captures (unless same capture, which would be no-op)
+    if (ovrl_data_capture != ovrl_data_capture_2)
     {
-        if (ovrl_data_thread_id != 0)
+        if (ovrl_data_capture != nullptr)
         {
             ovrl_data_it->Handle = overlay_handle_2;
-            ::PostThreadMessage(ovrl_data_thread_id, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            DPWinRT_Internal_PostCaptureRequest(*ovrl_data_capture, WM_DPLUSWINRT_UPDATE_DATA, ovrl_data_capture->CaptureID);
         }
 
-        if (ovrl_data_thread_id_2 != 0)
+        if (ovrl_data_capture_2 != nullptr)
         {
             ovrl_data_it_2->Handle = overlay_handle;
-            ::PostThreadMessage(ovrl_data_thread_id_2, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            DPWinRT_Internal_PostCaptureRequest(*ovrl_data_capture_2, WM_DPLUSWINRT_UPDATE_DATA, ovrl_data_capture_2->CaptureID);
         }
     }
 
@@ -398,14 +610,14 @@ bool DPWinRT_SetOverlayUpdateLimitDelay(vr::VROverlayHandle_t overlay_handle, LO
 {
     #ifndef DPLUSWINRT_STUB
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-    //Find thread with the overlay assigned and update the thread data
-    for (auto& thread : g_Threads)
+    //Find capture with the overlay assigned and update the capture data
+    for (auto& capture : g_Captures)
     {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+        auto it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
 
-        if (it != thread.Overlays.end())
+        if (it != capture.Overlays.end())
         {
             //If no change, back out
             if (it->UpdateLimiterDelay.QuadPart == delay_quadpart)
@@ -413,7 +625,7 @@ bool DPWinRT_SetOverlayUpdateLimitDelay(vr::VROverlayHandle_t overlay_handle, LO
 
             it->UpdateLimiterDelay.QuadPart = delay_quadpart;
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID);
             return true;
         }
     }
@@ -427,14 +639,14 @@ bool DPWinRT_SetOverlayOverUnder3D(vr::VROverlayHandle_t overlay_handle, bool is
 {
     #ifndef DPLUSWINRT_STUB
 
-    std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-    //Find thread with the overlay assigned and update the thread data
-    for (auto& thread : g_Threads)
+    //Find capture with the overlay assigned and update the capture data
+    for (auto& capture : g_Captures)
     {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+        auto it = std::find_if(capture.Overlays.begin(), capture.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
 
-        if (it != thread.Overlays.end())
+        if (it != capture.Overlays.end())
         {
             //If no change, back out
             if (it->IsOverUnder3D == is_over_under_3D)
@@ -452,7 +664,7 @@ bool DPWinRT_SetOverlayOverUnder3D(vr::VROverlayHandle_t overlay_handle, bool is
             it->OU3D_crop_width  = crop_width;
             it->OU3D_crop_height = crop_height;
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            DPWinRT_Internal_PostCaptureRequest(capture, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID);
             return true;
         }
     }
@@ -466,14 +678,17 @@ void DPWinRT_SetCaptureCursorEnabled(bool is_cursor_enabled)
 {
     #ifndef DPLUSWINRT_STUB
 
-    //Send enable cursor message to all threads if the value changed
+    //Send enable cursor message to all running workers if the value changed. Workers started later get the state with their first capture
     if (g_IsCursorEnabled != is_cursor_enabled)
     {
-        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+        std::lock_guard<std::mutex> lock(g_CapturesMutex);
 
-        for (const auto& thread : g_Threads)
+        for (const auto& worker : g_Workers)
         {
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, is_cursor_enabled, 0);
+            if (worker.ThreadHandle != nullptr)
+            {
+                DPWinRT_Internal_PostThreadRequest(worker.ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, is_cursor_enabled);
+            }
         }
 
         g_IsCursorEnabled = is_cursor_enabled;
@@ -487,158 +702,403 @@ void DPWinRT_SetDesktopEnumerationFlags(bool ignore_wmr_screens)
     g_DesktopEnumFlagIgnoreWMRScreens = ignore_wmr_screens;
 }
 
-#undef _DEBUG
+bool DPWinRT_GetRequestLatencyStats(UINT command_id, DPWinRTRequestLatencyStats* stats)
+{
+    #ifndef DPLUSWINRT_STUB
 
-#ifndef DPLUSWINRT_STUB
+    switch (command_id)
+    {
+        case WM_DPLUSWINRT_UPDATE_DATA:
+        case WM_DPLUSWINRT_CAPTURE_PAUSE:
+        case WM_DPLUSWINRT_ENABLE_CURSOR:
+        case WM_DPLUSWINRT_CAPTURE_STOP:
+        case WM_DPLUSWINRT_CAPTURE_START:
+        {
+            ThreadRequestLatencyStats request_stats = g_RequestLatencyCounters[command_id - WM_DPLUSWINRT].GetStats();
+
+            stats->Count        = request_stats.Count;
+            stats->TimeoutCount = request_stats.TimeoutCount;
+            stats->AverageUS    = request_stats.AverageUS;
+            stats->MaxUS        = request_stats.MaxUS;
+
+            return true;
+        }
+        default: break;
+    }
+
+    #endif //DPLUSWINRT_STUB
+
+    return false;
+}
 
-DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param)
+void DPWinRT_RebalanceCaptureWorkers()
 {
-    //The thread shouldn't have been created in the first place then, but exit if it really happens
-    if (!DPWinRT_IsCaptureSupported())
+    #ifndef DPLUSWINRT_STUB
+        DPWinRT_Internal_RebalanceCaptureWorkers();
+    #endif
+}
+
+void DPWinRT_SampleCaptureMetrics()
+{
+    #ifndef DPLUSWINRT_STUB
+
+    std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+    //Overlays of a capture change in many places, so the registry's list is simply refreshed before every sample
+    std::vector<uint64_t> overlay_handles;
+    for (const auto& capture : g_Captures)
     {
-        return 0;
+        overlay_handles.clear();
+
+        for (const auto& overlay : capture.Overlays)
+        {
+            overlay_handles.push_back(overlay.Handle);
+        }
+
+        g_CaptureMetricsRegistry.SetCaptureOverlays(capture.CaptureID, overlay_handles);
     }
 
-    //Keep own copy of thread data
-    DPWinRTThreadData data;
+    g_CaptureMetricsRegistry.Sample(::GetTickCount64() * 1000);
 
+    #endif //DPLUSWINRT_STUB
+}
+
+bool DPWinRT_GetOverlayCaptureMetrics(vr::VROverlayHandle_t overlay_handle, DPWinRTCaptureMetrics* metrics)
+{
+    #ifndef DPLUSWINRT_STUB
+
+    CaptureMetricsSnapshot snapshot;
+
+    if (g_CaptureMetricsRegistry.GetOverlaySnapshot(overlay_handle, snapshot))
     {
-        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
-        data = *(DPWinRTThreadData*)Param;
+        metrics->FrameRate        = snapshot.FrameRate;
+        metrics->DroppedFrameRate = snapshot.DroppedFrameRate;
+        metrics->ConversionCount  = snapshot.ConversionCount;
+        metrics->ConversionAvgUS  = snapshot.ConversionAvgUS;
+        metrics->ConversionMaxUS  = snapshot.ConversionMaxUS;
+        metrics->LatencyCount     = snapshot.LatencyCount;
+        metrics->LatencyAvgUS     = snapshot.LatencyAvgUS;
+        metrics->LatencyMaxUS     = snapshot.LatencyMaxUS;
+
+        return true;
     }
 
-    // Initialize WinRT and scope the rest of the code so it's cleaned up before unloading WinRT again
-    winrt::init_apartment(winrt::apartment_type::multi_threaded);
+    #endif //DPLUSWINRT_STUB
 
-    //Catch all unhandled WinRT exceptions in release builds so we can get rid of the thread instead of crashing the entire app
-    //This assumes that doing so is alright (i.e. no process-irrecoverable exceptions occur)
-    #ifndef _DEBUG
-    try
+    return false;
+}
+
+void DPWinRT_GetCaptureTeardownStats(DPWinRTCaptureTeardownStats* stats)
+{
+    #ifndef DPLUSWINRT_STUB
+        TeardownLatencyHistogram histogram = CaptureReaper::Get().GetLatencyHistogram();
+
+        stats->Count = histogram.GetCount();
+        stats->MaxMS = histogram.GetMaxMS();
+    #else
+        stats->Count = 0;
+        stats->MaxMS = 0;
     #endif
-    {
-        // Create the DispatcherQueue that the compositor needs to run
-        auto controller = util::CreateDispatcherQueueControllerForCurrentThread();
+}
 
-        // Create the capture manager
-        auto capture_manager = std::make_unique<CaptureManager>(data, g_MainThreadID);
+void DPWinRT_SetWindowStateCacheActive(bool is_active)
+{
+    #ifndef DPLUSWINRT_STUB
+        WindowStateCache::Get().SetActive(is_active, (uintptr_t)::GetForegroundWindow());
+    #endif
+}
 
-        //Start capture
-        winrt::IAsyncOperation<winrt::GraphicsCaptureItem> picker_operation = nullptr;
-        if (data.UsePicker)
-        {
-            picker_operation = capture_manager->StartCaptureWithPickerAsync();
-        }
-        else if (DPWinRT_IsCaptureFromHandleSupported())
+void DPWinRT_SetWindowStateCacheWatchedWindows(const HWND* windows, unsigned int window_count)
+{
+    #ifndef DPLUSWINRT_STUB
+        std::vector<uintptr_t> window_values(windows, windows + window_count);
+        WindowStateCache::Get().SetWatchedWindows(window_values.data(), window_values.size());
+    #endif
+}
+
+void DPWinRT_OnWindowForegroundChanged(HWND window)
+{
+    #ifndef DPLUSWINRT_STUB
+        WindowStateCache::Get().OnForegroundChanged((uintptr_t)window);
+    #endif
+}
+
+void DPWinRT_OnWindowLocationChanged(HWND window)
+{
+    #ifndef DPLUSWINRT_STUB
+        WindowStateCache::Get().OnLocationChanged((uintptr_t)window);
+    #endif
+}
+
+unsigned int DPWinRT_GetCaptureWindows(HWND* windows, unsigned int window_count_max)
+{
+    unsigned int window_count = 0;
+
+    #ifndef DPLUSWINRT_STUB
+        std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+        for (const auto& capture : g_Captures)
         {
-            if (data.SourceWindow != nullptr)
+            if (capture.SourceWindow == nullptr)
+                continue;
+
+            if (window_count < window_count_max)
             {
-                capture_manager->StartCaptureFromWindowHandle(data.SourceWindow);
+                windows[window_count] = capture.SourceWindow;
             }
-            else if (data.DesktopID != -2)
+
+            window_count++;
+        }
+    #endif
+
+    return window_count;
+}
+
+void DPWinRT_GetWindowStateCacheStats(unsigned long long* hit_count, unsigned long long* fallback_count)
+{
+    #ifndef DPLUSWINRT_STUB
+        *hit_count      = WindowStateCache::Get().GetHitCount();
+        *fallback_count = WindowStateCache::Get().GetFallbackCount();
+    #else
+        *hit_count      = 0;
+        *fallback_count = 0;
+    #endif
+}
+
+#undef _DEBUG
+
+#ifndef DPLUSWINRT_STUB
+
+//Capture as hosted by a worker thread
+struct DPWinRTWorkerCapture
+{
+    DPWinRTCaptureData Data;                  //Local copy, CaptureManager and OverlayCapture keep references to it
+    std::unique_ptr<CaptureManager> Manager;
+    winrt::IAsyncOperation<winrt::GraphicsCaptureItem> PickerOperation = nullptr;
+};
+
+void DPWinRT_Internal_WorkerStartCapture(DPWinRTWorkerCapture& capture, winrt::IDirect3DDevice const& device, bool is_cursor_enabled)
+{
+    const DPWinRTCaptureData& data = capture.Data;
+    capture.Manager = std::make_unique<CaptureManager>(capture.Data, device, g_MainThreadID);
+
+    //Start capture
+    if (data.UsePicker)
+    {
+        capture.PickerOperation = capture.Manager->StartCaptureWithPickerAsync();
+    }
+    else if (DPWinRT_IsCaptureFromHandleSupported())
+    {
+        if (data.SourceWindow != nullptr)
+        {
+            capture.Manager->StartCaptureFromWindowHandle(data.SourceWindow);
+        }
+        else if (data.DesktopID != -2)
+        {
+            if (data.DesktopID != -1)
             {
-                if (data.DesktopID != -1)
-                {
-                    HMONITOR monitor_handle = nullptr;
-                    GetDevmodeForDisplayID(data.DesktopID, g_DesktopEnumFlagIgnoreWMRScreens, &monitor_handle);
+                HMONITOR monitor_handle = nullptr;
+                GetDevmodeForDisplayID(data.DesktopID, g_DesktopEnumFlagIgnoreWMRScreens, &monitor_handle);
 
-                    if (monitor_handle != nullptr)
-                    {
-                        capture_manager->StartCaptureFromMonitorHandle(monitor_handle);
-                    }
-                    else
-                    {
-                        //Failed to get monitor handle, drop the capture
-                        for (const auto& overlay : data.Overlays)
-                        {
-                            ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
-                            //Thread will be quit by the response to the capture lost message
-                        }
-                    }
+                if (monitor_handle != nullptr)
+                {
+                    capture.Manager->StartCaptureFromMonitorHandle(monitor_handle);
                 }
-                else if (DPWinRT_IsCaptureFromCombinedDesktopSupported())
+                else
                 {
-                    capture_manager->StartCaptureFromMonitorHandle(nullptr);
+                    //Failed to get monitor handle, drop the capture
+                    for (const auto& overlay : data.Overlays)
+                    {
+                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+                        //Capture will be stopped by the response to the capture lost message
+                    }
                 }
             }
+            else if (DPWinRT_IsCaptureFromCombinedDesktopSupported())
+            {
+                capture.Manager->StartCaptureFromMonitorHandle(nullptr);
+            }
         }
+    }
+
+    //Ideally, capabilities are checked by before starting the capture, but if not and no capture starts, there will just be an idle capture until StopCapture is called
+
+    //Cursor is on by default, so only set it when it's not
+    if (!is_cursor_enabled)
+    {
+        capture.Manager->IsCursorEnabled(false);
+    }
+}
+
+void DPWinRT_Internal_WorkerStopCapture(DPWinRTWorkerCapture& capture)
+{
+    //If there's still a pending picker operation, cancel it
+    if ( (capture.PickerOperation != nullptr) && (capture.PickerOperation.Status() == winrt::AsyncStatus::Started) )
+    {
+        capture.PickerOperation.Cancel();
+    }
+
+    //Clear overlays here so they won't receive any more updates in case anything is still pending
+    capture.Data.Overlays.clear();
+    capture.Manager = nullptr;
+}
+
+DWORD WINAPI WinRTCaptureWorkerEntry(_In_ void* Param)
+{
+    //The thread shouldn't have been created in the first place then, but exit if it really happens
+    if (!DPWinRT_IsCaptureSupported())
+    {
+        return 0;
+    }
+
+    //Make sure the thread has a message queue before letting the creating thread continue. Param is not valid after signaling
+    MSG msg;
+    ::PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    ::SetEvent(((DPWinRTWorkerStartData*)Param)->ReadyEvent);
+
+    // Initialize WinRT and scope the rest of the code so it's cleaned up before unloading WinRT again
+    winrt::init_apartment(winrt::apartment_type::multi_threaded);
 
-        //Ideally, capabilities are checked by before creating the thread, but if not and no capture starts, there will just be an idling thread until StopCapture is called
+    winrt::Windows::System::DispatcherQueueController controller{ nullptr };
+    winrt::IDirect3DDevice device{ nullptr };
+    std::vector< std::unique_ptr<DPWinRTWorkerCapture> > captures;   //Pointers as the captures' data addresses need to be stable
+    bool is_cursor_enabled = true;
+
+    auto find_capture = [&](unsigned int capture_id)
+    {
+        return std::find_if(captures.begin(), captures.end(), [&](const auto& capture){ return (capture->Data.CaptureID == capture_id); });
+    };
+
+    //Catch all unhandled WinRT exceptions in release builds so we can get rid of the thread instead of crashing the entire app
+    //This assumes that doing so is alright (i.e. no process-irrecoverable exceptions occur)
+    #ifndef _DEBUG
+    try
+    #endif
+    {
+        // Create the DispatcherQueue that the compositor needs to run
+        controller = util::CreateDispatcherQueueControllerForCurrentThread();
+
+        //All captures of this worker share one device
+        device = CaptureManager::CreateCaptureDevice();
 
         // Message pump
-        MSG msg;
         while (GetMessageW(&msg, nullptr, 0, 0))
         {
-            if ((msg.message >= WM_DPLUSWINRT) && (msg.message <= 0xBFFF))
+            if ( (msg.message == g_WorkerRequestMessageID) && (msg.hwnd == nullptr) )
             {
-                switch (msg.message)
+                //Take over the request passed by DPWinRT_Internal_PostThreadRequest(), it's completed after the command was handled
+                ThreadRequestHandle request((ThreadRequest*)msg.lParam);
+
+                switch (request->GetCommand())
                 {
-                    case WM_DPLUSWINRT_UPDATE_DATA:
+                    case WM_DPLUSWINRT_CAPTURE_START:
                     {
-                        //Look for thread data and update local copy
-                        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+                        is_cursor_enabled = request->GetParam();
 
-                        for (const auto& thread : g_Threads)
+                        auto capture = std::make_unique<DPWinRTWorkerCapture>();
+                        bool capture_found = false;
+
+                        //Get a copy of the capture data
                         {
-                            if (thread.ThreadID == data.ThreadID)
+                            std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+                            auto it = std::find_if(g_Captures.begin(), g_Captures.end(), [&](const auto& capture_data){ return (capture_data.CaptureID == msg.wParam); });
+
+                            if (it != g_Captures.end())
                             {
-                                data = thread;
-                                capture_manager->OnOverlayDataRefresh();
-                                break;
+                                capture->Data = *it;
+                                capture_found = true;
                             }
                         }
 
-                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
+                        //Capture may have been stopped again before this message arrived
+                        if ( (capture_found) && (find_capture((unsigned int)msg.wParam) == captures.end()) )
+                        {
+                            captures.push_back(std::move(capture));
+                            DPWinRT_Internal_WorkerStartCapture(*captures.back(), device, is_cursor_enabled);
+                        }
 
                         break;
                     }
-                    case WM_DPLUSWINRT_CAPTURE_PAUSE:
+                    case WM_DPLUSWINRT_UPDATE_DATA:
                     {
-                        const bool do_pause = msg.lParam;
+                        auto capture_it = find_capture((unsigned int)msg.wParam);
 
-                        bool is_unchanged = false;
-                        bool all_paused = true;
-                        for (DPWinRTOverlayData& overlay_data : data.Overlays)
-                        {
-                            if (overlay_data.Handle == msg.wParam)
-                            {
-                                //No change, back out
-                                if (overlay_data.IsPaused == do_pause)
-                                {
-                                    is_unchanged = true;
-                                    break;
-                                }
-
-                                overlay_data.IsPaused = do_pause;
-                            }
+                        if (capture_it == captures.end())
+                            break;
 
-                            if (!overlay_data.IsPaused)
+                        //Look for capture data and update local copy
+                        std::lock_guard<std::mutex> lock(g_CapturesMutex);
+
+                        for (const auto& capture_data : g_Captures)
+                        {
+                            if (capture_data.CaptureID == msg.wParam)
                             {
-                                all_paused = false;
+                                (*capture_it)->Data = capture_data;
+                                (*capture_it)->Manager->OnOverlayDataRefresh();
+                                break;
                             }
                         }
 
-                        if (!is_unchanged)
+                        break;
+                    }
+                    case WM_DPLUSWINRT_CAPTURE_PAUSE:
+                    {
+                        const bool do_pause = request->GetParam();
+
+                        for (auto& capture : captures)
                         {
-                            capture_manager->PauseCapture(all_paused);
+                            DPWinRTCaptureData& data = capture->Data;
+                            auto it = std::find_if(data.Overlays.begin(), data.Overlays.end(), [&](const auto& overlay_data){ return (overlay_data.Handle == msg.wParam); });
+
+                            if (it == data.Overlays.end())
+                                continue;
+
+                            //No change, back out
+                            if (it->IsPaused == do_pause)
+                                break;
+
+                            it->IsPaused = do_pause;
+
+                            bool all_paused = std::all_of(data.Overlays.begin(), data.Overlays.end(), [](const auto& overlay_data){ return overlay_data.IsPaused; });
+                            capture->Manager->PauseCapture(all_paused);
+                            break;
                         }
+
                         break;
                     }
                     case WM_DPLUSWINRT_ENABLE_CURSOR:
                     {
-                        capture_manager->IsCursorEnabled(msg.wParam);
+                        is_cursor_enabled = msg.wParam;
+
+                        for (auto& capture : captures)
+                        {
+                            capture->Manager->IsCursorEnabled(is_cursor_enabled);
+                        }
                         break;
                     }
-                    case WM_DPLUSWINRT_THREAD_QUIT:
+                    case WM_DPLUSWINRT_CAPTURE_STOP:
                     {
-                        //Clear overlays here so they won't receive any more updates before the actually thread exits
-                        data.Overlays.clear();
-                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
+                        auto capture_it = find_capture((unsigned int)msg.wParam);
+
+                        if (capture_it != captures.end())
+                        {
+                            DPWinRT_Internal_WorkerStopCapture(**capture_it);
+                            captures.erase(capture_it);
+                        }
 
-                        ::PostQuitMessage(0);
+                        //Hand the capture over if it's being moved to another worker
+                        if (request->GetParam())
+                        {
+                            std::lock_guard<std::mutex> lock(g_CapturesMutex);
+                            DPWinRT_Internal_FinishCaptureMove((unsigned int)msg.wParam);
+                        }
                         break;
                     }
 
                 }
+
+                request->Complete();
             }
             else
             {
@@ -647,14 +1107,10 @@ DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param)
             }
         }
 
-        //If there's still a pending picker operation, cancel it
-        if ( (picker_operation != nullptr) && (picker_operation.Status() == winrt::AsyncStatus::Started) )
+        for (auto& capture : captures)
         {
-            picker_operation.Cancel();
+            DPWinRT_Internal_WorkerStopCapture(*capture);
         }
-
-        capture_manager = nullptr;
-        controller = nullptr;
     }
     #ifndef _DEBUG
 
@@ -664,21 +1120,45 @@ DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param)
         //But we know things will go wrong when they can, let's be honest. What can go wrong isn't really well documented either, so if something
         //comes up, handle it somewhat gracefully
 
-        //Send capture lost messages for all overlays
-        //Resulting StopCapture() calls will cause cleanup of the thread book-keeping, even if this target thread is already gone
-        for (const auto& overlay : data.Overlays)
+        //We can't know which capture caused it, so send capture lost messages for all overlays of all captures on this worker
+        //Resulting StopCapture() calls will cause cleanup of the capture book-keeping, even if this worker thread is already gone
+        //A new thread is started for this worker the next time a capture is assigned to it
+        for (const auto& capture : captures)
         {
-            ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+            for (const auto& overlay : capture->Data.Overlays)
+            {
+                ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+            }
         }
 
         //Send thread error message
-        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ERROR, data.ThreadID, e.code());
+        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ERROR, ::GetCurrentThreadId(), e.code());
 
         //...and then get out of this thread
     }
 
     #endif
 
+    captures.clear();
+    device = nullptr;
+    controller = nullptr;
+
+    //Cancel requests that are still queued so the main thread isn't left waiting on them. (HWND)-1 only retrieves thread messages
+    MSG msg_pending;
+    while (::PeekMessage(&msg_pending, (HWND)-1, g_WorkerRequestMessageID, g_WorkerRequestMessageID, PM_REMOVE))
+    {
+        ThreadRequestHandle request((ThreadRequest*)msg_pending.lParam);
+
+        //This thread no longer has the capture either way, so moves can still be finished
+        if ( (request->GetCommand() == WM_DPLUSWINRT_CAPTURE_STOP) && (request->GetParam()) )
+        {
+            std::lock_guard<std::mutex> lock(g_CapturesMutex);
+            DPWinRT_Internal_FinishCaptureMove((unsigned int)msg_pending.wParam);
+        }
+
+        request->Cancel();
+    }
+
     winrt::clear_factory_cache();
     winrt::uninit_apartment();
 
@@ -32,13 +32,45 @@
 #define WM_DPLUSWINRT_SIZE          WM_DPLUSWINRT    //Sent to main thread on size change. wParam = overlay handle, lParam = width & height (in low/high word order, signed)
 #define WM_DPLUSWINRT_SET_HWND      WM_DPLUSWINRT+1  //Sent to main thread on HWND guess after picker use. wParam = overlay handle, lParam = HWND
 #define WM_DPLUSWINRT_SET_DESKTOP   WM_DPLUSWINRT+2  //Sent to main thread on desktop ID guess after picker use. wParam = overlay handle, lParam = desktop ID
-#define WM_DPLUSWINRT_UPDATE_DATA   WM_DPLUSWINRT+3  //Sent to capture thread to update its local data
-#define WM_DPLUSWINRT_CAPTURE_PAUSE WM_DPLUSWINRT+4  //Sent to capture thread to pause/resume capture. wParam = overlay handle, lParam = pause bool
+#define WM_DPLUSWINRT_UPDATE_DATA   WM_DPLUSWINRT+3  //Sent to capture worker thread to update its local data of a capture. wParam = capture ID
+#define WM_DPLUSWINRT_CAPTURE_PAUSE WM_DPLUSWINRT+4  //Sent to capture worker thread to pause/resume capture. wParam = overlay handle, request param = pause bool
 #define WM_DPLUSWINRT_CAPTURE_LOST  WM_DPLUSWINRT+5  //Sent to main thread when capture item was closed, should call StopCapture() in response. wParam = overlay handle
-#define WM_DPLUSWINRT_ENABLE_CURSOR WM_DPLUSWINRT+6  //Sent to capture thread to change cursor enabled state, wParam = cursor enabled bool
-#define WM_DPLUSWINRT_THREAD_QUIT   WM_DPLUSWINRT+7  //Sent to capture thread to quit when no overlays are left to capture
-#define WM_DPLUSWINRT_THREAD_ERROR  WM_DPLUSWINRT+8  //Sent to main thread when an unexpected error occured in the capture thread. wParam = thread ID, lParam = hresult
-#define WM_DPLUSWINRT_THREAD_ACK    WM_DPLUSWINRT+9  //Sent to main thread to acknowledge thread messages from StopCapture() (main thread is blocked until this is received)
+#define WM_DPLUSWINRT_ENABLE_CURSOR WM_DPLUSWINRT+6  //Sent to capture worker thread to change cursor enabled state of all its captures, wParam = cursor enabled bool
+#define WM_DPLUSWINRT_CAPTURE_STOP  WM_DPLUSWINRT+7  //Sent to capture worker thread to stop a capture when no overlays are left for it or it's moved to another worker. wParam = capture ID, request param = is move bool
+#define WM_DPLUSWINRT_THREAD_ERROR  WM_DPLUSWINRT+8  //Sent to main thread when an unexpected error occured in a capture worker thread. wParam = thread ID, lParam = hresult
+#define WM_DPLUSWINRT_CAPTURE_START WM_DPLUSWINRT+9  //Sent to capture worker thread to start a capture. wParam = capture ID, request param = cursor enabled bool
+#define WM_DPLUSWINRT_CAPTURE_WINDOWS WM_DPLUSWINRT+10 //Sent to main thread when the windows being captured changed, see DPWinRT_GetCaptureWindows()
+#define WM_DPLUSWINRT_MESSAGE_MAX   WM_DPLUSWINRT+11 //Not a message, just the end of the range
+//Captures are hosted by a fixed-size pool of capture worker threads, multiple captures may share one
+//Commands for capture worker threads aren't posted with their IDs directly. They're carried by a ThreadRequest (see ThreadRequest.h), which is completed once the thread processed it
+//All requests are posted as one message registered at runtime, so thread messages from other sources are never mistaken for a request
+//wParam is passed as documented above, any additional argument that doesn't fit into it is passed as the request's param
+
+struct DPWinRTRequestLatencyStats
+{
+    unsigned long long Count;           //Completed requests
+    unsigned long long TimeoutCount;    //Requests the main thread stopped waiting on before they were completed
+    unsigned long long AverageUS;
+    unsigned long long MaxUS;
+};
+
+struct DPWinRTCaptureMetrics
+{
+    unsigned long long FrameRate;           //Frames delivered to the overlay per second
+    unsigned long long DroppedFrameRate;    //Frames skipped by the update limiter per second
+    unsigned long long ConversionCount;     //Over-Under 3D conversions in the sampled period
+    unsigned long long ConversionAvgUS;
+    unsigned long long ConversionMaxUS;
+    unsigned long long LatencyCount;        //Frames with a latency sample in the sampled period
+    unsigned long long LatencyAvgUS;        //Time from the frame being captured to the overlay textures being set
+    unsigned long long LatencyMaxUS;
+};
+
+struct DPWinRTCaptureTeardownStats
+{
+    unsigned long long Count;           //Frame pools disposed of by the capture reaper
+    unsigned long long MaxMS;           //Longest time from a capture being closed to its frame pool being disposed of, including the grace period
+};
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +96,30 @@ DPLUSWINRT_API bool DPWinRT_SetOverlayOverUnder3D(vr::VROverlayHandle_t overlay_
 DPLUSWINRT_API void DPWinRT_SetCaptureCursorEnabled(bool is_cursor_enabled);
 DPLUSWINRT_API void DPWinRT_SetDesktopEnumerationFlags(bool ignore_wmr_screens);
 
+//Latency between sending a command to a capture worker thread and the thread having processed it. Returns false if the ID isn't one of a capture worker thread command
+DPLUSWINRT_API bool DPWinRT_GetRequestLatencyStats(UINT command_id, DPWinRTRequestLatencyStats* stats);
+//Samples the frame processing cost of captures and moves them between worker threads if it's unbalanced. Not done automatically, should be called every few seconds
+//Doesn't block. Moved captures are restarted on their new worker once the old one let go of them, commands for them are queued until then
+DPLUSWINRT_API void DPWinRT_RebalanceCaptureWorkers();
+
+//Window state cache, fed by the caller's WinEvent hooks so captures don't have to query the foreground window and window bounds on every frame
+//Cache is inactive by default. While inactive, captures query the state directly. Only needed while there are window captures, see DPWinRT_GetCaptureWindows()
+DPLUSWINRT_API void DPWinRT_SetWindowStateCacheActive(bool is_active);
+//Windows the caller reports location changes for. Location reads for other windows fall back to querying the window directly
+DPLUSWINRT_API void DPWinRT_SetWindowStateCacheWatchedWindows(const HWND* windows, unsigned int window_count);
+DPLUSWINRT_API void DPWinRT_OnWindowForegroundChanged(HWND window);                //EVENT_SYSTEM_FOREGROUND
+DPLUSWINRT_API void DPWinRT_OnWindowLocationChanged(HWND window);                  //EVENT_OBJECT_LOCATIONCHANGE of top-level windows
+//Copies the source windows of active captures to windows and returns the total count, which can be larger than window_count_max
+//WM_DPLUSWINRT_CAPTURE_WINDOWS is sent to the main thread when they changed
+DPLUSWINRT_API unsigned int DPWinRT_GetCaptureWindows(HWND* windows, unsigned int window_count_max);
+DPLUSWINRT_API void DPWinRT_GetWindowStateCacheStats(unsigned long long* hit_count, unsigned long long* fallback_count);
+
+//Frame metrics of captures, sampled by DPWinRT_SampleCaptureMetrics(). Rates are derived from the time between samples, so it should be called at a steady interval of about a second
+DPLUSWINRT_API void DPWinRT_SampleCaptureMetrics();
+//Returns false if the overlay has no capture or it hasn't been sampled yet. Metrics are per capture, so overlays sharing one report the same values
+DPLUSWINRT_API bool DPWinRT_GetOverlayCaptureMetrics(vr::VROverlayHandle_t overlay_handle, DPWinRTCaptureMetrics* metrics);
+DPLUSWINRT_API void DPWinRT_GetCaptureTeardownStats(DPWinRTCaptureTeardownStats* stats);
+
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,7 @@
 
 #include "CommonHeaders.h"
 #include "OverlayCapture.h"
+#include "CaptureReaper.h"
 
 #include "DesktopPlusWinRT.h"
 #include "Util.h"
@@ -17,10 +18,21 @@ namespace winrt
     using namespace Windows::Foundation::Numerics;
 }
 
+//Converts QPC ticks to microseconds without overflowing on large counter values
+static int64_t QPCToMicroseconds(int64_t qpc_ticks)
+{
+    static const int64_t frequency = []{ LARGE_INTEGER freq; ::QueryPerformanceFrequency(&freq); return freq.QuadPart; }();
+
+    return ((qpc_ticks / frequency) * 1000000) + (((qpc_ticks % frequency) * 1000000) / frequency);
+}
+
 OverlayCapture::OverlayCapture(winrt::IDirect3DDevice const& device, winrt::GraphicsCaptureItem const& item, winrt::DirectXPixelFormat pixel_format, DWORD global_main_thread_id,
-                               const std::vector<DPWinRTOverlayData>& overlays, HWND source_window) :
+                               const std::vector<DPWinRTOverlayData>& overlays, HWND source_window, std::atomic<uint64_t>* processing_time_us,
+                               CaptureMetrics* metrics) :
     m_Overlays(overlays),
-    m_SourceWindow(source_window)
+    m_SourceWindow(source_window),
+    m_ProcessingTimeUS(processing_time_us),
+    m_Metrics(metrics)
 {
     m_Item = item;
     m_Device = device;
@@ -38,7 +50,7 @@ OverlayCapture::OverlayCapture(winrt::IDirect3DDevice const& device, winrt::Grap
     m_FramePool = winrt::Direct3D11CaptureFramePool::Create(m_Device, m_PixelFormat, 2, m_Item.Size());
     m_LastContentSize = m_Item.Size();
     m_Session = m_FramePool.CreateCaptureSession(m_Item);
-    m_FramePool.FrameArrived({ this, &OverlayCapture::OnFrameArrived });
+    m_FrameArrivedRevoker = m_FramePool.FrameArrived(winrt::auto_revoke, { this, &OverlayCapture::OnFrameArrived });
 
     //Disable yellow capture border if possible (Windows SDK 10.0.20348.0 or newer + running on Windows 11)
     #if WINDOWS_FOUNDATION_UNIVERSALAPICONTRACT_VERSION >= 0xc0000
@@ -60,10 +72,6 @@ OverlayCapture::OverlayCapture(winrt::IDirect3DDevice const& device, winrt::Grap
         vr::VROverlay()->SetOverlayMouseScale(overlay.Handle, &mouse_scale);
     }
 
-    //Init update limiter variables
-    ::QueryPerformanceFrequency(&m_UpdateLimiterFrequency);
-    ::QueryPerformanceCounter(&m_UpdateLimiterStartingTime);
-
     OnOverlayDataRefresh();
 
     WINRT_ASSERT(m_Session != nullptr);
@@ -77,6 +85,7 @@ void OverlayCapture::StartCapture()
 
 void OverlayCapture::RestartCapture()
 {
+    m_FrameArrivedRevoker.revoke();
     m_Session.Close();
     m_FramePool.Close();
 
@@ -85,7 +94,7 @@ void OverlayCapture::RestartCapture()
 
     m_FramePool = m_FramePool.Create(m_Device, m_PixelFormat, 2, m_LastContentSize);
     m_Session = m_FramePool.CreateCaptureSession(m_Item);
-    m_FramePool.FrameArrived({this, &OverlayCapture::OnFrameArrived});
+    m_FrameArrivedRevoker = m_FramePool.FrameArrived(winrt::auto_revoke, {this, &OverlayCapture::OnFrameArrived});
 
     m_Session.StartCapture();
 
@@ -107,19 +116,19 @@ void OverlayCapture::IsCursorEnabled(bool value)
 
 void OverlayCapture::OnOverlayDataRefresh()
 {
-    //Find the smallest update limiter delay, count Over-Under & paused overlays
-    size_t ou_count = 0;
+    //Find the smallest update limiter delay, count paused overlays
     size_t pause_count = 0;
-    m_UpdateLimiterDelay.QuadPart = UINT_MAX;
+    LARGE_INTEGER update_limiter_delay;
+    update_limiter_delay.QuadPart = UINT_MAX;
     vr::HmdVector2_t mouse_scale = {(float)m_LastTextureSize.Width, (float)m_LastTextureSize.Height};
 
     for (const auto& overlay : m_Overlays)
     {
         if (!overlay.IsPaused)
         {
-            if (overlay.UpdateLimiterDelay.QuadPart < m_UpdateLimiterDelay.QuadPart)
+            if (overlay.UpdateLimiterDelay.QuadPart < update_limiter_delay.QuadPart)
             {
-                m_UpdateLimiterDelay = overlay.UpdateLimiterDelay;
+                update_limiter_delay = overlay.UpdateLimiterDelay;
             }
         }
         else
@@ -127,11 +136,6 @@ void OverlayCapture::OnOverlayDataRefresh()
             pause_count++;
         }
 
-        if (overlay.IsOverUnder3D)
-        {
-            ou_count++;
-        }
-
         //And also send size and set mouse scale again in case a fresh overlay was added
         if (m_InitialSizingDone)
         {
@@ -140,14 +144,17 @@ void OverlayCapture::OnOverlayDataRefresh()
         }
     }
 
-    //Adjust OUConverter cache size as needed
-    m_OUConverters.resize(ou_count);
-
     //Make sure the shared textures are set up again on the next update
     m_OverlaySharedTextureSetupsNeeded = 2;
 
     //Pause/unpause capture if all overlays are set to be paused
     m_Paused = (pause_count == m_Overlays.size()); //Don't call PauseCapture() since that calls this function
+
+    //Delay is in microseconds
+    if (!m_Paused)
+    {
+        m_FrameLimiter.SetInterval(update_limiter_delay.QuadPart);
+    }
 }
 
 void OverlayCapture::Close()
@@ -155,17 +162,16 @@ void OverlayCapture::Close()
     auto expected = false;
     if (m_Closed.compare_exchange_strong(expected, true))
     {
+        m_FrameArrivedRevoker.revoke();
         m_Session.Close();
 
-        //Wait for GraphicsCapture.dll thread to finish up
+        //Let the GraphicsCapture.dll thread finish up before closing the frame pool
         //
         //When multiple captures are active and one stops, a fail-fast crash can occur sometimes.
         //Always in internal frame pool cleanup code, as if there was a race condition somewhere...
         //This may be a bug in Graphics Capture and seems only to happen on Windows 10 1809
-        //Waiting it out works and this thread is only cleaning up so it doesn't really matter if we sleep a bit before doing so... eh
-        Sleep(500); //A few ms is actually enough, but do 500 just to be safe
-
-        m_FramePool.Close();
+        //Waiting it out works, so the frame pool is handed off to CaptureReaper, which closes it after a grace period without blocking this thread
+        CaptureReaper::Get().Add(std::move(m_FramePool));
 
         m_FramePool = nullptr;
         m_Session   = nullptr;
@@ -177,26 +183,24 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
 {
     auto frame = sender.TryGetNextFrame();
 
-    if ( (m_Paused) || (frame == nullptr) )
+    if (frame == nullptr)
         return;
 
-    //Update limiter/skipper
-    bool update_limiter_active = (m_UpdateLimiterDelay.QuadPart != 0);
-    
-    if (update_limiter_active)
+    //Update limiter/skipper, scheduled by the time the frame was captured (TimeSpan is in 100 ns units)
+    //Skipped frames are returned to the frame pool right away so capture can continue into the free buffer
+    if ( (m_Paused) || (!m_FrameLimiter.OnFrame(frame.SystemRelativeTime().count() / 10)) )
     {
-        LARGE_INTEGER UpdateLimiterEndingTime, UpdateLimiterElapsedMicroseconds;
-
-        QueryPerformanceCounter(&UpdateLimiterEndingTime);
-        UpdateLimiterElapsedMicroseconds.QuadPart = UpdateLimiterEndingTime.QuadPart - m_UpdateLimiterStartingTime.QuadPart;
-
-        UpdateLimiterElapsedMicroseconds.QuadPart *= 1000000;
-        UpdateLimiterElapsedMicroseconds.QuadPart /= m_UpdateLimiterFrequency.QuadPart;
+        if ( (!m_Paused) && (m_Metrics != nullptr) )
+        {
+            m_Metrics->RecordFrameDropped();
+        }
 
-        if (UpdateLimiterElapsedMicroseconds.QuadPart < m_UpdateLimiterDelay.QuadPart)
-            return; //Skip frame
+        frame.Close();
+        return;
     }
 
+    const auto processing_start = std::chrono::steady_clock::now();
+    const winrt::TimeSpan frame_time = frame.SystemRelativeTime();
     bool recreate_frame_pool = false;
 
     //Scope surface texture to release it earlier
@@ -252,28 +256,48 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
         vrtex.eColorSpace = vr::ColorSpace_Gamma;
         vrtex.handle = surface_texture.get();
 
-        size_t ou_count = 0;
+        //Every frame is a full update, so the cache only serves to convert overlays with identical crops once
+        //The frame pool texture changes between frames, so entries are keyed by crop alone instead
+        m_OUConverterCache.BeginFrame();
+
         vr::VROverlayHandle_t ovrl_shared_source = vr::k_ulOverlayHandleInvalid;
         for (const auto& overlay : m_Overlays)
         {
             if (overlay.IsOverUnder3D)
             {
-                if (ou_count < m_OUConverters.size())
+                OUtoSBSConverterCache::Entry& cache_entry = m_OUConverterCache.GetEntry(nullptr, OUtoSBSRect::FromCrop(overlay.OU3D_crop_x, overlay.OU3D_crop_y, 
+                                                                                                                       overlay.OU3D_crop_width, overlay.OU3D_crop_height));
+                HRESULT hr = S_OK;
+
+                if (m_OUConverterCache.IsConversionNeeded(cache_entry))
                 {
-                    HRESULT hr = m_OUConverters[ou_count].Convert(d3d_device.get(), m_D3DContext.get(), nullptr, nullptr, surface_texture.get(), texture_desc.Width, texture_desc.Height,
-                                                                  overlay.OU3D_crop_x, overlay.OU3D_crop_y, overlay.OU3D_crop_width, overlay.OU3D_crop_height);
+                    LARGE_INTEGER conversion_start;
+                    ::QueryPerformanceCounter(&conversion_start);
+
+                    hr = cache_entry.Converter.Convert(d3d_device.get(), m_D3DContext.get(), nullptr, nullptr, surface_texture.get(), texture_desc.Width, texture_desc.Height,
+                                                       overlay.OU3D_crop_x, overlay.OU3D_crop_y, overlay.OU3D_crop_width, overlay.OU3D_crop_height);
 
                     if (hr == S_OK)
                     {
-                        vr::Texture_t vrtex_ou;
-                        vrtex_ou.eType = vr::TextureType_DirectX;
-                        vrtex_ou.eColorSpace = vr::ColorSpace_Gamma;
-                        vrtex_ou.handle = m_OUConverters[ou_count].GetTexture();
-
-                        vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex_ou);
+                        m_OUConverterCache.SetConverted(cache_entry);
+
+                        if (m_Metrics != nullptr)
+                        {
+                            LARGE_INTEGER conversion_end;
+                            ::QueryPerformanceCounter(&conversion_end);
+                            m_Metrics->RecordConversion(QPCToMicroseconds(conversion_end.QuadPart - conversion_start.QuadPart));
+                        }
                     }
+                }
+
+                if (hr == S_OK)
+                {
+                    vr::Texture_t vrtex_ou;
+                    vrtex_ou.eType = vr::TextureType_DirectX;
+                    vrtex_ou.eColorSpace = vr::ColorSpace_Gamma;
+                    vrtex_ou.handle = cache_entry.Converter.GetTexture();
 
-                    ou_count++;
+                    vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex_ou);
                 }
             }
             else if (ovrl_shared_source == vr::k_ulOverlayHandleInvalid) //For the first non-OU3D overlay, set the texture as normal
@@ -286,6 +310,19 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
                 SetSharedOverlayTexture(ovrl_shared_source, overlay.Handle, surface_texture.get());
             }
         }
+
+        m_OUConverterCache.EndFrame();
+    }
+
+    //SystemRelativeTime is QPC time in 100 ns units, so the latency to now is the time from the frame being captured to all overlay textures being set
+    if (m_Metrics != nullptr)
+    {
+        LARGE_INTEGER submit_time;
+        ::QueryPerformanceCounter(&submit_time);
+        const int64_t latency_us = QPCToMicroseconds(submit_time.QuadPart) - (frame_time.count() / 10);
+
+        m_Metrics->RecordFrameDelivered();
+        m_Metrics->RecordLatency((latency_us > 0) ? (uint64_t)latency_us : 0);
     }
 
     //Release frame early
@@ -305,17 +342,26 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
     //Except sleeping doesn't help when restarting the capture, so we don't even try on versions older than 1903 (where capture from handle was added)
     if ( (DPWinRT_IsCaptureFromHandleSupported()) && (m_SourceWindow != nullptr) && (m_OverlaySharedTextureSetupsNeeded == 0) )
     {
-        RECT window_rect = {0};
-        if (::DwmGetWindowAttribute(m_SourceWindow, DWMWA_EXTENDED_FRAME_BOUNDS, &window_rect, sizeof(window_rect)) == S_OK)
+        //Only query the frame bounds again if the window may have moved or resized since the last time
+        if (!WindowStateCache::Get().IsLocationUnchanged((uintptr_t)m_SourceWindow, m_SourceWindowLocationToken))
         {
-            int dwm_w = window_rect.right  - window_rect.left;
-            int dwm_h = window_rect.bottom - window_rect.top;
-
-            if ((m_LastTextureSize.Width != dwm_w) || (m_LastTextureSize.Height != dwm_h))
+            RECT window_rect = {0};
+            if (::DwmGetWindowAttribute(m_SourceWindow, DWMWA_EXTENDED_FRAME_BOUNDS, &window_rect, sizeof(window_rect)) == S_OK)
+            {
+                m_SourceWindowFrameSize.Width  = window_rect.right  - window_rect.left;
+                m_SourceWindowFrameSize.Height = window_rect.bottom - window_rect.top;
+            }
+            else
             {
-                m_RestartPending = true;
+                m_SourceWindowFrameSize = {-1, -1};
             }
         }
+
+        if ( (m_SourceWindowFrameSize.Width != -1) && 
+             ((m_LastTextureSize.Width != m_SourceWindowFrameSize.Width) || (m_LastTextureSize.Height != m_SourceWindowFrameSize.Height)) )
+        {
+            m_RestartPending = true;
+        }
     }
 
     //We can only be sure about not needing to set the shared overlay texture after doing it at least twice after resize. Not entirely sure why, but it works.
@@ -327,7 +373,13 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
     //Hide cursor from capture if the window is not in front as it just adds more confusion when it's there
     if ( (m_CursorEnabled) && (m_SourceWindow != nullptr) && (DPWinRT_IsCaptureCursorEnabledPropertySupported()) )
     {
-        bool should_enable_cursor = (m_SourceWindow == ::GetForegroundWindow());
+        uintptr_t foreground_window = 0;
+        if (!WindowStateCache::Get().GetForegroundWindow(foreground_window))
+        {
+            foreground_window = (uintptr_t)::GetForegroundWindow();
+        }
+
+        bool should_enable_cursor = ((uintptr_t)m_SourceWindow == foreground_window);
 
         if (m_CursorEnabledInternal != should_enable_cursor)
         {
@@ -342,10 +394,11 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
         m_FramePool.Recreate(m_Device, m_PixelFormat, 2, m_LastContentSize);
     }
 
-    //Set frame limiter starting time after we're done with everything
-    if (update_limiter_active)
+    //Track processing time so the capture can be balanced between worker threads
+    if (m_ProcessingTimeUS != nullptr)
     {
-        ::QueryPerformanceCounter(&m_UpdateLimiterStartingTime);
+        auto processing_time = std::chrono::steady_clock::now() - processing_start;
+        m_ProcessingTimeUS->fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(processing_time).count(), std::memory_order_relaxed);
     }
 }
 
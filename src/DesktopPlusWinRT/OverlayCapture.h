@@ -1,15 +1,19 @@
 #pragma once
 
 #include <mutex>
+#include <chrono>
 
 #include "ThreadData.h"
 #include "OUtoSBSConverter.h"
+#include "CaptureFrameLimiter.h"
+#include "WindowStateCache.h"
 
 class OverlayCapture
 {
 public:
     OverlayCapture(winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice const& device, winrt::Windows::Graphics::Capture::GraphicsCaptureItem const& item,
-                  winrt::Windows::Graphics::DirectX::DirectXPixelFormat pixel_format, DWORD global_main_thread_id, const std::vector<DPWinRTOverlayData>& overlays, HWND source_window);
+                  winrt::Windows::Graphics::DirectX::DirectXPixelFormat pixel_format, DWORD global_main_thread_id, const std::vector<DPWinRTOverlayData>& overlays, HWND source_window,
+                  std::atomic<uint64_t>* processing_time_us = nullptr, CaptureMetrics* metrics = nullptr);
     ~OverlayCapture() { Close(); }
 
     void StartCapture();
@@ -41,6 +45,7 @@ private:
     winrt::Windows::Graphics::Capture::GraphicsCaptureItem m_Item { nullptr };
     winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool m_FramePool { nullptr };
     winrt::Windows::Graphics::Capture::GraphicsCaptureSession m_Session { nullptr };
+    winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::FrameArrived_revoker m_FrameArrivedRevoker;
     winrt::Windows::Graphics::SizeInt32 m_LastContentSize { 0, 0 };
 
     winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice m_Device { nullptr };
@@ -52,6 +57,8 @@ private:
     //Below are only accessed while on the capture's main thread
     const std::vector<DPWinRTOverlayData>& m_Overlays;
     const HWND m_SourceWindow;
+    std::atomic<uint64_t>* const m_ProcessingTimeUS;      //Optional, incremented by the time spent on each processed frame
+    CaptureMetrics* const m_Metrics;                      //Optional, frame metrics for the Performance Monitor
     DWORD m_GlobalMainThreadID = 0;
 
     bool m_Paused = false;
@@ -62,10 +69,10 @@ private:
     bool m_InitialSizingDone = false;
     winrt::Windows::Graphics::SizeInt32 m_LastTextureSize { 0, 0 };
     bool m_RestartPending = false;
+    winrt::Windows::Graphics::SizeInt32 m_SourceWindowFrameSize { -1, -1 };  //DWM frame bounds size of m_SourceWindow, -1 if unknown
+    WindowStateCache::LocationToken m_SourceWindowLocationToken;
 
-    LARGE_INTEGER m_UpdateLimiterStartingTime = {0, 0};
-    LARGE_INTEGER m_UpdateLimiterFrequency = {0, 0};
-    LARGE_INTEGER m_UpdateLimiterDelay = {0, 0};
+    CaptureFrameLimiter m_FrameLimiter;
 
-    std::vector<OUtoSBSConverter> m_OUConverters; //Rarely used, so the cache is kept here instead of directly as part of the overlay data
+    OUtoSBSConverterCache m_OUConverterCache;     //Rarely used, so the cache is kept here instead of directly as part of the overlay data
 };
\ No newline at end of file
@@ -5,7 +5,11 @@
 #include <windows.h>
 
 #include <vector>
+#include <memory>
+#include <atomic>
 #include "openvr.h"
+#include "CaptureMetricsRegistry.h"
+#include "ThreadRequest.h"
 
 struct DPWinRTOverlayData
 {
@@ -19,12 +23,31 @@ struct DPWinRTOverlayData
     int OU3D_crop_height = 1;
 };
 
-struct DPWinRTThreadData
+//A capture item and the overlays using it. Captures are hosted by capture worker threads, multiple captures can share a worker
+struct DPWinRTCaptureData
 {
-    HANDLE ThreadHandle = nullptr;
-    DWORD ThreadID = 0;
+    unsigned int CaptureID = 0;
+    int WorkerID = -1;
+    DWORD ThreadID = 0;                 //Thread ID of the worker hosting this capture, 0 while moving
+    bool IsMoving = false;              //True while the capture is handed over to another worker, requests for it are queued in the meantime
     std::vector<DPWinRTOverlayData> Overlays;
     HWND SourceWindow = nullptr;
     int DesktopID = -2;
     bool UsePicker = false;
-};
\ No newline at end of file
+    std::shared_ptr< std::atomic<uint64_t> > ProcessingTimeUS;  //Total time spent processing frames, shared between all copies. Sampled by the main thread for load balancing
+    std::shared_ptr<CaptureMetrics> Metrics;                    //Frame metrics, shared between all copies. Owned by g_CaptureMetricsRegistry
+};
+
+struct DPWinRTWorkerData
+{
+    HANDLE ThreadHandle = nullptr;
+    DWORD ThreadID = 0;
+};
+
+//Request for a capture that's being moved to another worker, posted to the new worker once the old one let go of the capture
+struct DPWinRTPendingRequest
+{
+    unsigned int CaptureID = 0;
+    WPARAM WParam = 0;
+    ThreadRequestHandle Request;
+};
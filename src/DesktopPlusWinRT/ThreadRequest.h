@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+//Request/acknowledge primitive for commands sent to capture threads
+//The sender creates a request and hands a reference of it to the receiving thread (as message parameter in practice), the receiver completes it once the command was processed
+//The request carries the command itself, so the message used to transport it can be the same for all commands
+//The sender can wait on completion with a timeout and drop its reference at any point, the request is freed when both sides are done with it
+//Kept free of Windows headers so it can be used and tested anywhere
+
+struct ThreadRequestLatencyStats
+{
+    uint64_t Count        = 0;      //Completed requests
+    uint64_t TimeoutCount = 0;      //Waits that timed out before the request was completed
+    uint64_t AverageUS    = 0;
+    uint64_t MaxUS        = 0;
+};
+
+//Latency between creating and completing requests, shared by all requests of the same command
+class ThreadRequestLatencyCounter
+{
+    private:
+        std::atomic<uint64_t> m_Count{0};
+        std::atomic<uint64_t> m_TimeoutCount{0};
+        std::atomic<uint64_t> m_TotalUS{0};
+        std::atomic<uint64_t> m_MaxUS{0};
+
+    public:
+        void Record(uint64_t latency_us)
+        {
+            m_Count.fetch_add(1, std::memory_order_relaxed);
+            m_TotalUS.fetch_add(latency_us, std::memory_order_relaxed);
+
+            uint64_t max_us = m_MaxUS.load(std::memory_order_relaxed);
+            while ( (latency_us > max_us) && (!m_MaxUS.compare_exchange_weak(max_us, latency_us, std::memory_order_relaxed)) );
+        }
+
+        void RecordTimeout()
+        {
+            m_TimeoutCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        //Counters are read individually, so the result may be slightly inconsistent while requests are being completed
+        ThreadRequestLatencyStats GetStats() const
+        {
+            ThreadRequestLatencyStats stats;
+            stats.Count        = m_Count.load(std::memory_order_relaxed);
+            stats.TimeoutCount = m_TimeoutCount.load(std::memory_order_relaxed);
+            stats.AverageUS    = (stats.Count != 0) ? m_TotalUS.load(std::memory_order_relaxed) / stats.Count : 0;
+            stats.MaxUS        = m_MaxUS.load(std::memory_order_relaxed);
+
+            return stats;
+        }
+};
+
+class ThreadRequest
+{
+    private:
+        std::atomic<int> m_RefCount;
+        std::mutex m_Mutex;
+        std::condition_variable m_CompletedCondition;
+        bool m_IsCompleted;                                 //Protected by m_Mutex
+        std::chrono::steady_clock::time_point m_CreationTime;
+        ThreadRequestLatencyCounter* m_LatencyCounter;      //Optional, must outlive the request
+        uint32_t m_Command;                                 //Identifies the command for the receiver, not modified after creation
+        intptr_t m_Param;                                   //Command-specific argument, not modified after creation
+
+        ThreadRequest(uint32_t command, ThreadRequestLatencyCounter* latency_counter, intptr_t param) : m_RefCount(1),
+                                                                                                        m_IsCompleted(false),
+                                                                                                        m_CreationTime(std::chrono::steady_clock::now()),
+                                                                                                        m_LatencyCounter(latency_counter),
+                                                                                                        m_Command(command),
+                                                                                                        m_Param(param)
+        {
+        }
+
+        void SetCompleted(bool record_latency)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                if (m_IsCompleted)
+                    return;
+
+                m_IsCompleted = true;
+            }
+
+            m_CompletedCondition.notify_all();
+
+            if ( (record_latency) && (m_LatencyCounter != nullptr) )
+            {
+                auto latency = std::chrono::steady_clock::now() - m_CreationTime;
+                m_LatencyCounter->Record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+            }
+        }
+
+    public:
+        //Returned request has a reference count of 1, owned by the caller
+        static ThreadRequest* Create(uint32_t command, ThreadRequestLatencyCounter* latency_counter = nullptr, intptr_t param = 0)
+        {
+            return new ThreadRequest(command, latency_counter, param);
+        }
+
+        void AddRef()
+        {
+            m_RefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Release()
+        {
+            if (m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        uint32_t GetCommand() const
+        {
+            return m_Command;
+        }
+
+        intptr_t GetParam() const
+        {
+            return m_Param;
+        }
+
+        //Called by the receiver when it's done processing the command. Only the first call has an effect
+        void Complete()
+        {
+            SetCompleted(true);
+        }
+
+        //Same as Complete(), but without recording latency. For requests that could not be delivered or were dropped without being processed
+        void Cancel()
+        {
+            SetCompleted(false);
+        }
+
+        bool IsCompleted()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_IsCompleted;
+        }
+
+        //Returns true if the request was completed within the timeout
+        bool Wait(uint32_t timeout_ms)
+        {
+            bool is_completed;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                is_completed = m_CompletedCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{ return m_IsCompleted; });
+            }
+
+            if ( (!is_completed) && (m_LatencyCounter != nullptr) )
+            {
+                m_LatencyCounter->RecordTimeout();
+            }
+
+            return is_completed;
+        }
+
+        ThreadRequest(const ThreadRequest&) = delete;
+        ThreadRequest& operator=(const ThreadRequest&) = delete;
+};
+
+//Owns one reference of a ThreadRequest, or nothing
+class ThreadRequestHandle
+{
+    private:
+        ThreadRequest* m_Request;
+
+    public:
+        ThreadRequestHandle() : m_Request(nullptr) {}
+        explicit ThreadRequestHandle(ThreadRequest* request) : m_Request(request) {}   //Takes over the reference, doesn't add one
+        ~ThreadRequestHandle() { Reset(); }
+
+        ThreadRequestHandle(ThreadRequestHandle&& other) noexcept : m_Request(other.m_Request)
+        {
+            other.m_Request = nullptr;
+        }
+
+        ThreadRequestHandle& operator=(ThreadRequestHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Request = other.m_Request;
+                other.m_Request = nullptr;
+            }
+
+            return *this;
+        }
+
+        ThreadRequestHandle(const ThreadRequestHandle&) = delete;
+        ThreadRequestHandle& operator=(const ThreadRequestHandle&) = delete;
+
+        static ThreadRequestHandle Create(uint32_t command, ThreadRequestLatencyCounter* latency_counter = nullptr, intptr_t param = 0)
+        {
+            return ThreadRequestHandle(ThreadRequest::Create(command, latency_counter, param));
+        }
+
+        //Returns the request with an added reference for the receiver, which is expected to take it over with the ThreadRequestHandle(ThreadRequest*) constructor
+        ThreadRequest* ShareWithReceiver() const
+        {
+            if (m_Request != nullptr)
+            {
+                m_Request->AddRef();
+            }
+
+            return m_Request;
+        }
+
+        void Reset()
+        {
+            if (m_Request != nullptr)
+            {
+                m_Request->Release();
+                m_Request = nullptr;
+            }
+        }
+
+        ThreadRequest* Get() const                { return m_Request; }
+        ThreadRequest* operator->() const         { return m_Request; }
+        explicit operator bool() const            { return (m_Request != nullptr); }
+};
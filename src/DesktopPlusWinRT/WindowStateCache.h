@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//Caches window state needed by captures on every frame so they don't have to query it every time
+//Fed by the dashboard's WinEvent hook thread (WindowManager) through the DPWinRT_*WindowStateCache* functions, read lock-free by any number of capture threads
+//
+//Window location isn't stored directly. Instead, location changes bump a serial of the window, which readers compare with the serial they saw when they last
+//queried the window themselves. Only windows the feeding thread has location change hooks for are watched, reads for other windows are fallbacks.
+//While the cache isn't active (no hook thread running or no window captures), all reads are reported as fallbacks and callers have to query the state directly
+//Window handles are passed as integers to keep this free of Windows headers
+class WindowStateCache
+{
+    public:
+        static const size_t WatchedWindowMax = 64;
+
+        //Per-reader state for IsLocationUnchanged()
+        struct LocationToken
+        {
+            size_t Slot     = 0;
+            uint32_t Serial = 0;
+            bool IsValid    = false;
+        };
+
+    private:
+        struct WatchedWindow
+        {
+            std::atomic<uintptr_t> Window{0};
+            std::atomic<uint32_t> Serial{0};    //Also bumped when the slot is (un)assigned, invalidating tokens from before
+        };
+
+        std::atomic<bool> m_IsActive{false};
+        std::atomic<uintptr_t> m_ForegroundWindow{0};
+        WatchedWindow m_WatchedWindows[WatchedWindowMax];
+
+        std::atomic<uint64_t> m_HitCount{0};
+        std::atomic<uint64_t> m_FallbackCount{0};
+
+        //Returns WatchedWindowMax if the window isn't watched
+        size_t FindSlot(uintptr_t window) const
+        {
+            if (window == 0)
+                return WatchedWindowMax;
+
+            for (size_t i = 0; i < WatchedWindowMax; ++i)
+            {
+                if (m_WatchedWindows[i].Window.load(std::memory_order_acquire) == window)
+                    return i;
+            }
+
+            return WatchedWindowMax;
+        }
+
+    public:
+        static WindowStateCache& Get()
+        {
+            static WindowStateCache cache;
+            return cache;
+        }
+
+        //- Feeding thread
+        //Deactivating also stops watching all windows
+        void SetActive(bool is_active, uintptr_t foreground_window)
+        {
+            if (is_active)
+            {
+                m_ForegroundWindow.store(foreground_window, std::memory_order_relaxed);
+            }
+            else
+            {
+                SetWatchedWindows(nullptr, 0);
+            }
+
+            m_IsActive.store(is_active, std::memory_order_release);
+        }
+
+        //Replaces the windows location changes are reported for. Windows beyond WatchedWindowMax are not watched
+        void SetWatchedWindows(const uintptr_t* windows, size_t window_count)
+        {
+            auto is_in_list = [&](uintptr_t window)
+            {
+                for (size_t i = 0; i < window_count; ++i)
+                {
+                    if (windows[i] == window)
+                        return true;
+                }
+
+                return false;
+            };
+
+            //Free slots of windows no longer in the list
+            for (WatchedWindow& watched : m_WatchedWindows)
+            {
+                const uintptr_t window = watched.Window.load(std::memory_order_relaxed);
+
+                if ( (window != 0) && (!is_in_list(window)) )
+                {
+                    watched.Serial.fetch_add(1, std::memory_order_release);
+                    watched.Window.store(0, std::memory_order_release);
+                }
+            }
+
+            //Assign slots to new windows
+            for (size_t i = 0; i < window_count; ++i)
+            {
+                if ( (windows[i] == 0) || (FindSlot(windows[i]) != WatchedWindowMax) )
+                    continue;
+
+                for (WatchedWindow& watched : m_WatchedWindows)
+                {
+                    if (watched.Window.load(std::memory_order_relaxed) == 0)
+                    {
+                        watched.Serial.fetch_add(1, std::memory_order_release);
+                        watched.Window.store(windows[i], std::memory_order_release);
+                        break;
+                    }
+                }
+            }
+        }
+
+        void OnForegroundChanged(uintptr_t window)
+        {
+            m_ForegroundWindow.store(window, std::memory_order_relaxed);
+        }
+
+        void OnLocationChanged(uintptr_t window)
+        {
+            const size_t slot = FindSlot(window);
+
+            if (slot != WatchedWindowMax)
+            {
+                m_WatchedWindows[slot].Serial.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        //- Any thread
+        //Returns false if the cache isn't active and the foreground window needs to be queried directly
+        bool GetForegroundWindow(uintptr_t& window_out)
+        {
+            if (!m_IsActive.load(std::memory_order_acquire))
+            {
+                m_FallbackCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            window_out = m_ForegroundWindow.load(std::memory_order_relaxed);
+            m_HitCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        //Returns true if the window hasn't moved or resized since the last call with the same token
+        //Returns false if it may have or the window isn't watched, in which case the caller should query the window. The token is updated before returning
+        bool IsLocationUnchanged(uintptr_t window, LocationToken& token)
+        {
+            const size_t slot = (m_IsActive.load(std::memory_order_acquire)) ? FindSlot(window) : WatchedWindowMax;
+
+            if (slot == WatchedWindowMax)
+            {
+                token.IsValid = false;
+                m_FallbackCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            const uint32_t serial = m_WatchedWindows[slot].Serial.load(std::memory_order_acquire);
+
+            if ( (token.IsValid) && (token.Slot == slot) && (token.Serial == serial) )
+            {
+                m_HitCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            token.Slot    = slot;
+            token.Serial  = serial;
+            token.IsValid = true;
+
+            m_FallbackCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        uint64_t GetHitCount() const      { return m_HitCount.load(std::memory_order_relaxed);      }
+        uint64_t GetFallbackCount() const { return m_FallbackCount.load(std::memory_order_relaxed); }
+};
@@ -3,6 +3,7 @@
 #include "ConfigManager.h"
 #include "OverlayManager.h"
 #include "InterprocessMessaging.h"
+#include "CustomActionSerialization.h"
 
 const char* g_ActionNames[] =
 {
@@ -30,122 +31,13 @@ const char* g_ActionButtonLabel[] =
 };
 
 
-void CustomAction::ApplyIntFromConfig()
-{
-    const int sub = ConfigManager::Get().GetConfigInt(configid_int_state_action_current_sub);
-    const int value = ConfigManager::Get().GetConfigInt(configid_int_state_action_value_int);
-
-    if (sub == 1)
-    {
-        FunctionType = (CustomActionFunctionID)value;
-    }
-    else if (sub != 0)
-    {
-        switch (FunctionType)
-        {
-            case caction_press_keys:
-            {
-                if (sub < 5)
-                {
-                    KeyCodes[sub - 2] = (unsigned char)value;
-                }
-                else if (sub == 5)
-                {
-                    IntID = value;
-                }
-                break;
-            }
-            case caction_toggle_overlay_enabled_state:
-            {
-                IntID = value;
-                break;
-            }
-            default: break;
-        }
-    }
-}
-
-void CustomAction::ApplyStringFromConfig()
-{
-    const int sub = ConfigManager::Get().GetConfigInt(configid_int_state_action_current_sub);
-    const std::string& value = ConfigManager::Get().GetConfigString(configid_str_state_action_value_string);
-
-    if (sub == 0)
-    {
-        Name = value;
-    }
-    else if (sub != 1)
-    {
-        switch (FunctionType)
-        {
-            case caction_type_string:
-            {
-                StrMain = value;
-                break;
-            }
-            case caction_launch_application:
-            {
-                if (sub == 2)
-                    StrMain = value;
-                else
-                    StrArg = value;
-
-                break;
-            }
-            default: break;
-        }
-    }
-}
-
 void CustomAction::SendUpdateToDashboardApp(int id, HWND window_handle) const
 {
-    //Send changes over to dashboard application
-    IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current), id);
-    //Sendings strings stalls the application and the dashboard app doesn't use the name, so don't send it
-    /*IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 0);
-    IPCManager::Get().SendStringToDashboardApp(configid_str_state_action_value_string, Name, window_handle);*/
-    IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 1);
-    IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), FunctionType);
-
-    switch (FunctionType)
-    {
-        case caction_press_keys:
-        {
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 2);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), KeyCodes[0]);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 3);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), KeyCodes[1]);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 4);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), KeyCodes[2]);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 5);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), IntID);
-
-            break;
-        }
-        case caction_type_string:
-        {
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 2);
-            IPCManager::Get().SendStringToDashboardApp(configid_str_state_action_value_string, StrMain, window_handle);
-
-            break;
-        }
-        case caction_launch_application:
-        {
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 2);
-            IPCManager::Get().SendStringToDashboardApp(configid_str_state_action_value_string, StrMain, window_handle);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 3);
-            IPCManager::Get().SendStringToDashboardApp(configid_str_state_action_value_string, StrArg, window_handle);
-
-            break;
-        }
-        case caction_toggle_overlay_enabled_state:
-        {
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_current_sub), 2);
-            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_state_action_value_int), IntID);
-        }
-        default: break;
-    }
+    //Send changes over to dashboard application, all in one message
+    BinaryWriter writer;
+    CustomActionSerialization::Write(writer, id, this, 1, id + 1);
 
+    IPCManager::Get().SendBinaryToDashboardApp(ipcbin_custom_actions, writer.GetBuffer(), window_handle);
 }
 
 std::vector<CustomAction>& ActionManager::GetCustomActions()
@@ -158,6 +50,11 @@ std::vector<ActionMainBarOrderData>& ActionManager::GetActionMainBarOrder()
     return m_ActionMainBarOrder;
 }
 
+std::vector<HotkeyBinding>& ActionManager::GetHotkeyBindings()
+{
+    return m_HotkeyBindings;
+}
+
 bool ActionManager::IsActionIDValid(ActionID action_id) const
 {
     if (action_id >= action_custom)
@@ -276,9 +173,60 @@ void ActionManager::EraseCustomAction(int custom_action_id)
         {
             ConfigManager::Get().SetConfigInt(configid_int_input_go_back_action_id, action_none);
         }
+
+        //Fixup IDs of hotkey bindings and unbind the deleted action
+        for (HotkeyBinding& binding : m_HotkeyBindings)
+        {
+            if (binding.ActionID > action_id)
+            {
+                binding.ActionID--;
+            }
+            else if (binding.ActionID == action_id)
+            {
+                binding.ActionID = action_none;
+            }
+        }
+    }
+}
+
+void ActionManager::HotkeyBindingsOverlayRemoved(unsigned int overlay_id)
+{
+    m_HotkeyBindings.erase(std::remove_if(m_HotkeyBindings.begin(), m_HotkeyBindings.end(), 
+                                          [&](const HotkeyBinding& binding){ return ( (binding.Scope == hotkey_scope_overlay) && (binding.ScopeID == (int)overlay_id) ); }),
+                           m_HotkeyBindings.end());
+
+    for (HotkeyBinding& binding : m_HotkeyBindings)
+    {
+        if ( (binding.Scope == hotkey_scope_overlay) && (binding.ScopeID > (int)overlay_id) )
+        {
+            binding.ScopeID--;
+        }
+    }
+}
+
+void ActionManager::HotkeyBindingsOverlaysSwapped(unsigned int overlay_id, unsigned int overlay_id2)
+{
+    for (HotkeyBinding& binding : m_HotkeyBindings)
+    {
+        if (binding.Scope != hotkey_scope_overlay)
+            continue;
+
+        if (binding.ScopeID == (int)overlay_id)
+        {
+            binding.ScopeID = (int)overlay_id2;
+        }
+        else if (binding.ScopeID == (int)overlay_id2)
+        {
+            binding.ScopeID = (int)overlay_id;
+        }
     }
 }
 
+bool ActionManager::ApplySerializedCustomActions(const void* data, size_t size)
+{
+    return CustomActionSerialization::Apply(m_CustomActions, data, size, caction_toggle_overlay_group_enabled_state);
+}
+
 CustomActionFunctionID ActionManager::ParseCustomActionFunctionString(const std::string& str)
 {
     if (str == "PressKeys")
@@ -289,6 +237,8 @@ CustomActionFunctionID ActionManager::ParseCustomActionFunctionString(const std:
         return caction_launch_application;
     else if (str == "ToggleOverlayEnabledState")
         return caction_toggle_overlay_enabled_state;
+    else if (str == "ToggleOverlayGroupEnabledState")
+        return caction_toggle_overlay_group_enabled_state;
 
     return caction_press_keys;
 }
@@ -297,11 +247,33 @@ const char* ActionManager::CustomActionFunctionToString(CustomActionFunctionID f
 {
     switch (function_id)
     {
-        case caction_press_keys:                   return "PressKeys";
-        case caction_type_string:                  return "TypeString";
-        case caction_launch_application:           return "LaunchApplication";
-        case caction_toggle_overlay_enabled_state: return "ToggleOverlayEnabledState";
-        default:                                   return "UnknownFunction";
+        case caction_press_keys:                         return "PressKeys";
+        case caction_type_string:                        return "TypeString";
+        case caction_launch_application:                 return "LaunchApplication";
+        case caction_toggle_overlay_enabled_state:       return "ToggleOverlayEnabledState";
+        case caction_toggle_overlay_group_enabled_state: return "ToggleOverlayGroupEnabledState";
+        default:                                         return "UnknownFunction";
+    }
+}
+
+HotkeyScope ActionManager::ParseHotkeyScopeString(const std::string& str)
+{
+    if (str == "OverlayGroup")
+        return hotkey_scope_overlay_group;
+    else if (str == "Overlay")
+        return hotkey_scope_overlay;
+
+    return hotkey_scope_global;
+}
+
+const char* ActionManager::HotkeyScopeToString(HotkeyScope scope)
+{
+    switch (scope)
+    {
+        case hotkey_scope_global:        return "Global";
+        case hotkey_scope_overlay_group: return "OverlayGroup";
+        case hotkey_scope_overlay:       return "Overlay";
+        default:                         return "Global";
     }
 }
 
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "HotkeyEngine.h"
+
 #ifdef DPLUS_UI
     #include "imgui.h" //Don't include ImGui stuff for dashboard application
 #endif
@@ -29,7 +31,8 @@ enum CustomActionFunctionID
 	caction_press_keys,
 	caction_type_string,
 	caction_launch_application,
-    caction_toggle_overlay_enabled_state
+    caction_toggle_overlay_enabled_state,
+    caction_toggle_overlay_group_enabled_state
 };
 
 struct ActionMainBarOrderData
@@ -45,7 +48,7 @@ struct CustomAction
     unsigned char KeyCodes[3] = { 0 };
     std::string StrMain;     //Type String / Executable Path
     std::string StrArg;
-    int IntID = 0;           //Overlay ID / Key Toggle bool
+    int IntID = 0;           //Overlay ID / Overlay Group ID / Key Toggle bool
 
     #ifdef DPLUS_UI
         std::string IconFilename;
@@ -54,8 +57,6 @@ struct CustomAction
         ImVec4 IconAtlasUV   = {0.0f, 0.0f, 0.0f, 0.0f};
     #endif
 
-    void ApplyIntFromConfig();
-    void ApplyStringFromConfig();
     void SendUpdateToDashboardApp(int id, HWND window_handle) const;
 };
 
@@ -64,18 +65,27 @@ class ActionManager
     private:
         std::vector<CustomAction> m_CustomActions;
         std::vector<ActionMainBarOrderData> m_ActionMainBarOrder;
+        std::vector<HotkeyBinding> m_HotkeyBindings;
 
     public:
         static ActionManager& Get();
 
         std::vector<CustomAction>& GetCustomActions();
         std::vector<ActionMainBarOrderData>& GetActionMainBarOrder();
+        std::vector<HotkeyBinding>& GetHotkeyBindings();            //Additional hotkeys, can be sequences and scoped to overlays (see HotkeyEngine)
 
         bool IsActionIDValid(ActionID action_id) const;
         const char* GetActionName(ActionID action_id) const;
         const char* GetActionButtonLabel(ActionID action_id) const;
         void EraseCustomAction(int custom_action_id);
+        void HotkeyBindingsOverlayRemoved(unsigned int overlay_id);         //Drops bindings scoped to the overlay and fixes up the IDs of the ones past it
+        void HotkeyBindingsOverlaysSwapped(unsigned int overlay_id, unsigned int overlay_id2);
+
+        //Custom action updates are synced between processes as a single binary blob (see CustomActionSerialization.h for the layout)
+        bool ApplySerializedCustomActions(const void* data, size_t size);   //Returns false and leaves the custom actions untouched if the data is invalid
 
         static CustomActionFunctionID ParseCustomActionFunctionString(const std::string& str);
         static const char* CustomActionFunctionToString(CustomActionFunctionID function_id);
+        static HotkeyScope ParseHotkeyScopeString(const std::string& str);
+        static const char* HotkeyScopeToString(HotkeyScope scope);
 };
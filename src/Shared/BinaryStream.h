@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+//Minimal helpers for the compact binary formats used in IPC
+//Values are stored in native byte order (both ends always run on the same machine), strings as uint32 length followed by the raw bytes without NUL
+//The reader never reads past the end of the data. Once a read fails, the reader stays failed and all further reads return zero values
+
+class BinaryWriter
+{
+    private:
+        std::string m_Buffer;
+
+    public:
+        template<typename T>
+        void Write(T value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "BinaryWriter::Write() only supports trivially copyable types");
+            m_Buffer.append((const char*)&value, sizeof(T));
+        }
+
+        void WriteString(const std::string& str)
+        {
+            Write<uint32_t>((uint32_t)str.size());
+            m_Buffer.append(str);
+        }
+
+        void Reserve(size_t size)
+        {
+            m_Buffer.reserve(size);
+        }
+
+        void Clear()
+        {
+            m_Buffer.clear();
+        }
+
+        const std::string& GetBuffer() const
+        {
+            return m_Buffer;
+        }
+};
+
+class BinaryReader
+{
+    private:
+        const unsigned char* m_Data;
+        size_t m_Size;
+        size_t m_Pos = 0;
+        bool m_HasFailed = false;
+
+    public:
+        BinaryReader(const void* data, size_t size) : m_Data((const unsigned char*)data), m_Size((data != nullptr) ? size : 0) {}
+
+        template<typename T>
+        T Read()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "BinaryReader::Read() only supports trivially copyable types");
+
+            T value = T();
+
+            if ( (m_HasFailed) || (m_Size - m_Pos < sizeof(T)) )
+            {
+                m_HasFailed = true;
+                return value;
+            }
+
+            memcpy(&value, m_Data + m_Pos, sizeof(T));
+            m_Pos += sizeof(T);
+
+            return value;
+        }
+
+        //Strings longer than max_length fail the read
+        std::string ReadString(uint32_t max_length)
+        {
+            const uint32_t length = Read<uint32_t>();
+
+            if ( (m_HasFailed) || (length > max_length) || (m_Size - m_Pos < length) )
+            {
+                m_HasFailed = true;
+                return std::string();
+            }
+
+            std::string str((const char*)m_Data + m_Pos, length);
+            m_Pos += length;
+
+            return str;
+        }
+
+        bool HasFailed() const
+        {
+            return m_HasFailed;
+        }
+
+        bool IsAtEnd() const
+        {
+            return (m_Pos == m_Size);
+        }
+};
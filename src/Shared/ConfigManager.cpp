@@ -6,6 +6,7 @@
 
 #include "Util.h"
 #include "OverlayManager.h"
+#include "OverlayTransformCache.h"
 #include "InterprocessMessaging.h"
 #include "WindowList.h"
 #include "DesktopPlusWinRT.h"
@@ -31,6 +32,38 @@ OverlayConfigData::OverlayConfigData()
     std::fill(std::begin(ConfigDetachedTransform), std::end(ConfigDetachedTransform), matrix_zero);
 }
 
+bool OverlayConfigData::GetValueForWParam(WPARAM wparam, int& value) const
+{
+    if (wparam < configid_bool_overlay_MAX)
+    {
+        value = ConfigBool[wparam];
+        return true;
+    }
+    else if ( (wparam >= configid_bool_MAX) && (wparam < configid_bool_MAX + configid_int_overlay_MAX) )
+    {
+        value = ConfigInt[wparam - configid_bool_MAX];
+        return true;
+    }
+
+    return false;
+}
+
+bool OverlayConfigData::SetValueForWParam(WPARAM wparam, int value)
+{
+    if (wparam < configid_bool_overlay_MAX)
+    {
+        ConfigBool[wparam] = (value != 0);
+        return true;
+    }
+    else if ( (wparam >= configid_bool_MAX) && (wparam < configid_bool_MAX + configid_int_overlay_MAX) )
+    {
+        ConfigInt[wparam - configid_bool_MAX] = value;
+        return true;
+    }
+
+    return false;
+}
+
 ConfigManager::ConfigManager() : m_IsSteamInstall(false)
 {
     std::fill(std::begin(m_ConfigBool),  std::end(m_ConfigBool),  false);
@@ -519,6 +552,7 @@ bool ConfigManager::LoadConfigFromFile()
 	m_ConfigInt[configid_int_input_hotkey03_modifiers]                      = config.ReadInt( "Input", "GlobalHotkey03Modifiers", 0);
 	m_ConfigInt[configid_int_input_hotkey03_keycode]                        = config.ReadInt( "Input", "GlobalHotkey03KeyCode",   0);
 	m_ConfigInt[configid_int_input_hotkey03_action_id]                      = config.ReadInt( "Input", "GlobalHotkey03ActionID",  0);
+	m_ConfigInt[configid_int_input_hotkey_sequence_timeout_ms]              = config.ReadInt( "Input", "GlobalHotkeySequenceTimeout", HotkeyEngine::DefaultSequenceTimeout);
 
     m_ConfigFloat[configid_float_input_detached_interaction_max_distance]   = config.ReadInt( "Input", "DetachedInteractionMaxDistance", 30) / 100.0f;
     m_ConfigBool[configid_bool_input_global_hmd_pointer]                    = config.ReadBool("Input", "GlobalHMDPointer", false);
@@ -542,6 +576,7 @@ bool ConfigManager::LoadConfigFromFile()
     m_ConfigInt[configid_int_performance_update_limit_mode]              = config.ReadInt( "Performance", "UpdateLimitMode", update_limit_mode_off);
     m_ConfigFloat[configid_float_performance_update_limit_ms]            = config.ReadInt( "Performance", "UpdateLimitMS", 0) / 100.0f;
     m_ConfigInt[configid_int_performance_update_limit_fps]               = config.ReadInt( "Performance", "UpdateLimitFPS", update_limit_fps_30);
+    m_ConfigFloat[configid_float_performance_transform_epsilon]          = config.ReadInt( "Performance", "TransformEpsilon", 10) / 1000000.0f;
     m_ConfigBool[configid_bool_performance_rapid_laser_pointer_updates]  = config.ReadBool("Performance", "RapidLaserPointerUpdates", false);
     m_ConfigBool[configid_bool_performance_single_desktop_mirroring]     = config.ReadBool("Performance", "SingleDesktopMirroring", false);
     m_ConfigBool[configid_bool_performance_monitor_large_style]          = config.ReadBool("Performance", "PerformanceMonitorStyleLarge", true);
@@ -553,8 +588,12 @@ bool ConfigManager::LoadConfigFromFile()
     m_ConfigBool[configid_bool_performance_monitor_show_battery]         = config.ReadBool("Performance", "PerformanceMonitorShowBattery", true);
     m_ConfigBool[configid_bool_performance_monitor_show_trackers]        = config.ReadBool("Performance", "PerformanceMonitorShowTrackers", true);
     m_ConfigBool[configid_bool_performance_monitor_show_vive_wireless]   = config.ReadBool("Performance", "PerformanceMonitorShowViveWireless", false);
+    m_ConfigBool[configid_bool_performance_monitor_show_capture_stats]   = config.ReadBool("Performance", "PerformanceMonitorShowCaptureStats", false);
     m_ConfigBool[configid_bool_performance_monitor_disable_gpu_counters] = config.ReadBool("Performance", "PerformanceMonitorDisableGPUCounters", false);
 
+    //Both processes submit overlay transforms through the cache, so it's applied right here
+    OverlayTransformCache::Get().SetEpsilon(m_ConfigFloat[configid_float_performance_transform_epsilon]);
+
     m_ConfigBool[configid_bool_misc_no_steam]                        = config.ReadBool("Misc", "NoSteam", false);
     m_ConfigBool[configid_bool_misc_uiaccess_was_enabled]            = config.ReadBool("Misc", "UIAccessWasEnabled", false);
     m_ConfigBool[configid_bool_misc_apply_steamvr2_dashboard_offset] = config.ReadBool("Misc", "ApplySteamVR2DashboardOffset", true);
@@ -597,6 +636,11 @@ bool ConfigManager::LoadConfigFromFile()
                 action.IntID = config.ReadInt("CustomActions", (action_ini_name + "OverlayID").c_str(), 0);
                 break;
             }
+            case caction_toggle_overlay_group_enabled_state:
+            {
+                action.IntID = config.ReadInt("CustomActions", (action_ini_name + "OverlayGroupID").c_str(), 1);
+                break;
+            }
         }
         
         #ifdef DPLUS_UI
@@ -606,6 +650,55 @@ bool ConfigManager::LoadConfigFromFile()
         custom_actions.push_back(action);
     }
 
+    //Load overlay group names. Without the section, the three groups from before groups were named are used
+    m_OverlayGroupNames.clear();
+    int overlay_group_count = config.ReadInt("OverlayGroups", "Count", -1);
+
+    if (overlay_group_count == -1)
+    {
+        m_OverlayGroupNames = {"Group 1", "Group 2", "Group 3"};
+    }
+
+    for (int i = 1; i <= overlay_group_count; ++i)
+    {
+        std::string group_ini_name = "Group" + std::to_string(i);
+        m_OverlayGroupNames.push_back(config.ReadString("OverlayGroups", (group_ini_name + "Name").c_str(), group_ini_name.c_str()));
+    }
+
+    //Load hotkey bindings. These are in addition to the three global hotkeys in the Input section, which are what the settings UI edits
+    auto& hotkey_bindings = m_ActionManager.GetHotkeyBindings();
+    hotkey_bindings.clear();
+    int hotkey_count = config.ReadInt("Hotkeys", "Count", 0);
+
+    for (int i = 0; i < hotkey_count; ++i)
+    {
+        std::string hotkey_ini_name = "Hotkey" + std::to_string(i);
+        HotkeyBinding binding;
+
+        std::stringstream ss_strokes(config.ReadString("Hotkeys", (hotkey_ini_name + "Strokes").c_str()));
+        int modifiers, keycode;
+        char sep;
+
+        for (;;)
+        {
+            ss_strokes >> modifiers >> keycode >> sep;
+
+            if (ss_strokes.fail())
+                break;
+
+            HotkeyStroke stroke;
+            stroke.Modifiers = (uint8_t)(modifiers & hotkey_mod_mask);
+            stroke.KeyCode   = (uint8_t)keycode;
+            binding.Strokes.push_back(stroke);
+        }
+
+        binding.ActionID = config.ReadInt("Hotkeys", (hotkey_ini_name + "ActionID").c_str(), action_none);
+        binding.Scope    = ActionManager::ParseHotkeyScopeString( config.ReadString("Hotkeys", (hotkey_ini_name + "Scope").c_str()) );
+        binding.ScopeID  = config.ReadInt("Hotkeys", (hotkey_ini_name + "ScopeID").c_str(), -1);
+
+        hotkey_bindings.push_back(binding);
+    }
+
     //Provide default for empty order list
     if (action_order.empty()) 
     {
@@ -891,6 +984,7 @@ void ConfigManager::SaveConfigToFile()
     config.WriteInt( "Input",  "GlobalHotkey03Modifiers",            m_ConfigInt[configid_int_input_hotkey03_modifiers]);
     config.WriteInt( "Input",  "GlobalHotkey03KeyCode",              m_ConfigInt[configid_int_input_hotkey03_keycode]);
     config.WriteInt( "Input",  "GlobalHotkey03ActionID",             m_ConfigInt[configid_int_input_hotkey03_action_id]);
+    config.WriteInt( "Input",  "GlobalHotkeySequenceTimeout",        m_ConfigInt[configid_int_input_hotkey_sequence_timeout_ms]);
 
     config.WriteInt( "Input",  "DetachedInteractionMaxDistance", int(m_ConfigFloat[configid_float_input_detached_interaction_max_distance] * 100.0f));
     config.WriteBool("Input",  "GlobalHMDPointer",                   m_ConfigBool[configid_bool_input_global_hmd_pointer]);
@@ -914,6 +1008,7 @@ void ConfigManager::SaveConfigToFile()
     config.WriteInt( "Performance", "UpdateLimitMode",                      m_ConfigInt[configid_int_performance_update_limit_mode]);
     config.WriteInt( "Performance", "UpdateLimitMS",                    int(m_ConfigFloat[configid_float_performance_update_limit_ms] * 100.0f));
     config.WriteInt( "Performance", "UpdateLimitFPS",                       m_ConfigInt[configid_int_performance_update_limit_fps]);
+    config.WriteInt( "Performance", "TransformEpsilon",                 int(m_ConfigFloat[configid_float_performance_transform_epsilon] * 1000000.0f + 0.5f));
     config.WriteBool("Performance", "RapidLaserPointerUpdates",             m_ConfigBool[configid_bool_performance_rapid_laser_pointer_updates]);
     config.WriteBool("Performance", "SingleDesktopMirroring",               m_ConfigBool[configid_bool_performance_single_desktop_mirroring]);
     config.WriteBool("Performance", "PerformanceMonitorStyleLarge",         m_ConfigBool[configid_bool_performance_monitor_large_style]);
@@ -925,6 +1020,7 @@ void ConfigManager::SaveConfigToFile()
     config.WriteBool("Performance", "PerformanceMonitorShowBattery",        m_ConfigBool[configid_bool_performance_monitor_show_battery]);
     config.WriteBool("Performance", "PerformanceMonitorShowTrackers",       m_ConfigBool[configid_bool_performance_monitor_show_trackers]);
     config.WriteBool("Performance", "PerformanceMonitorShowViveWireless",   m_ConfigBool[configid_bool_performance_monitor_show_vive_wireless]);
+    config.WriteBool("Performance", "PerformanceMonitorShowCaptureStats",   m_ConfigBool[configid_bool_performance_monitor_show_capture_stats]);
     config.WriteBool("Performance", "PerformanceMonitorDisableGPUCounters", m_ConfigBool[configid_bool_performance_monitor_disable_gpu_counters]);
 
     config.WriteBool("Misc", "NoSteam",            m_ConfigBool[configid_bool_misc_no_steam]);
@@ -972,6 +1068,11 @@ void ConfigManager::SaveConfigToFile()
                 config.WriteInt("CustomActions", (action_ini_name + "OverlayID").c_str(), action.IntID);
                 break;
             }
+            case caction_toggle_overlay_group_enabled_state:
+            {
+                config.WriteInt("CustomActions", (action_ini_name + "OverlayGroupID").c_str(), action.IntID);
+                break;
+            }
         }
 
         #ifdef DPLUS_UI
@@ -979,6 +1080,41 @@ void ConfigManager::SaveConfigToFile()
         #endif
     }
 
+    //Save overlay group names
+    config.RemoveSection("OverlayGroups");
+
+    int overlay_group_count = (int)m_OverlayGroupNames.size();
+    config.WriteInt("OverlayGroups", "Count", overlay_group_count);
+
+    for (int i = 1; i <= overlay_group_count; ++i)
+    {
+        config.WriteString("OverlayGroups", ("Group" + std::to_string(i) + "Name").c_str(), m_OverlayGroupNames[i - 1].c_str());
+    }
+
+    //Save hotkey bindings
+    config.RemoveSection("Hotkeys");
+
+    const auto& hotkey_bindings = m_ActionManager.GetHotkeyBindings();
+    int hotkey_count = (int)hotkey_bindings.size();
+    config.WriteInt("Hotkeys", "Count", hotkey_count);
+
+    for (int i = 0; i < hotkey_count; ++i)
+    {
+        const HotkeyBinding& binding = hotkey_bindings[i];
+        std::string hotkey_ini_name = "Hotkey" + std::to_string(i);
+
+        std::stringstream ss_strokes;
+        for (const HotkeyStroke& stroke : binding.Strokes)
+        {
+            ss_strokes << (int)stroke.Modifiers << ' ' << (int)stroke.KeyCode << ";";
+        }
+
+        config.WriteString("Hotkeys", (hotkey_ini_name + "Strokes").c_str(),  ss_strokes.str().c_str());
+        config.WriteInt(   "Hotkeys", (hotkey_ini_name + "ActionID").c_str(), binding.ActionID);
+        config.WriteString("Hotkeys", (hotkey_ini_name + "Scope").c_str(),    ActionManager::HotkeyScopeToString(binding.Scope));
+        config.WriteInt(   "Hotkeys", (hotkey_ini_name + "ScopeID").c_str(),  binding.ScopeID);
+    }
+
     config.Save();
 }
 
@@ -1216,6 +1352,11 @@ std::vector<ActionMainBarOrderData>& ConfigManager::GetActionMainBarOrder()
     return m_ActionManager.GetActionMainBarOrder();
 }
 
+std::vector<std::string>& ConfigManager::GetOverlayGroupNames()
+{
+    return m_OverlayGroupNames;
+}
+
 Matrix4& ConfigManager::GetOverlayDetachedTransform()
 {
     int origin = GetConfigInt(configid_int_overlay_detached_origin);
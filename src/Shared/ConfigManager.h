@@ -54,6 +54,7 @@ enum ConfigID_Bool
     configid_bool_performance_monitor_show_battery,
     configid_bool_performance_monitor_show_trackers,
     configid_bool_performance_monitor_show_vive_wireless,
+    configid_bool_performance_monitor_show_capture_stats,     //Desktop Duplication and Graphics Capture stats, large style only
     configid_bool_performance_monitor_disable_gpu_counters,
     configid_bool_input_global_hmd_pointer,
     configid_bool_input_mouse_render_cursor,
@@ -98,6 +99,11 @@ enum ConfigID_Int
     configid_int_overlay_group_id,
     configid_int_overlay_state_content_width,
     configid_int_overlay_state_content_height,
+    configid_int_overlay_state_capture_fps,                 //Graphics Capture frame metrics, updated once a second while stats are active. -1 = no data
+    configid_int_overlay_state_capture_dropped_fps,
+    configid_int_overlay_state_capture_conversion_us,       //Average Over-Under 3D conversion time
+    configid_int_overlay_state_capture_latency_us,          //Average time from the frame being captured to the overlay texture being set
+    configid_int_overlay_state_capture_latency_max_us,
     configid_int_overlay_MAX,
     configid_int_interface_overlay_current_id,
     configid_int_interface_mainbar_desktop_listing,
@@ -118,18 +124,42 @@ enum ConfigID_Int
     configid_int_input_hotkey03_modifiers,
     configid_int_input_hotkey03_keycode,
     configid_int_input_hotkey03_action_id,
+    configid_int_input_hotkey_sequence_timeout_ms,          //Time to wait for the next key of a hotkey sequence (see HotkeyEngine)
     configid_int_input_mouse_dbl_click_assist_duration_ms,
     configid_int_windows_winrt_dragging_mode,
     configid_int_performance_update_limit_mode,
     configid_int_performance_update_limit_fps,              //This is the enum ID, not the actual number. See ApplySettingUpdateLimiter() code for more info
     configid_int_state_overlay_current_id_override,         //This is used to send config changes to overlays which aren't the current, mainly to avoid the UI switching around (-1 is disabled)
-    configid_int_state_action_current,                      //Action changes are synced through a series of individually sent state settings. This one sets the target custom action (ID start 0)
-    configid_int_state_action_current_sub,                  //Target variable. 0 = Name, 1 = Function Type. Remaining values depend on the function. Not the cleanest way but easier
-    configid_int_state_action_value_int,                    //to set up with existing IPC stuff
     configid_int_state_mouse_dbl_click_assist_duration_ms,  //Internally used value, which will replace -1 with the current double-click delay automatically
     configid_int_state_keyboard_visible_for_overlay_id,     //-1 = None
     configid_int_state_keyboard_modifiers,                  //Keyboard modifier state when keyboard helper is enabled and visible (allows UI seeing state while elevated app is in focus)
     configid_int_state_performance_duplication_fps,
+    configid_int_state_performance_duplication_wakeups,     //Times the duplication threads returned from waiting in the last second, see DuplicationWaitPolicy
+    configid_int_state_performance_cursor_updates,          //Cursor updates published by the duplication threads in the last second, see CursorState. -1 = no data
+    configid_int_state_performance_cursor_coalesced,        //Of those, updates replaced by a newer one before they were read
+    configid_int_state_performance_trace_update_p50,        //Stage timing percentiles from PerformanceTrace in microseconds, updated once a second while stats are active.
+    configid_int_state_performance_trace_update_p99,        //Stored as p50/p99 pairs in PerformanceTraceStage order. -1 = no data
+    configid_int_state_performance_trace_vr_events_p50,
+    configid_int_state_performance_trace_vr_events_p99,
+    configid_int_state_performance_trace_draw_frame_p50,
+    configid_int_state_performance_trace_draw_frame_p99,
+    configid_int_state_performance_trace_draw_mouse_p50,
+    configid_int_state_performance_trace_draw_mouse_p99,
+    configid_int_state_performance_trace_refresh_texture_p50,
+    configid_int_state_performance_trace_refresh_texture_p99,
+    configid_int_state_performance_trace_dupl_get_frame_p50,
+    configid_int_state_performance_trace_dupl_get_frame_p99,
+    configid_int_state_performance_trace_dupl_process_frame_p50,
+    configid_int_state_performance_trace_dupl_process_frame_p99,
+    configid_int_state_performance_capture_teardown_count,  //Graphics Capture frame pools disposed of since launch, see DPWinRT_GetCaptureTeardownStats()
+    configid_int_state_performance_capture_teardown_max_ms,
+    configid_int_state_performance_capture_request_avg_us,  //Capture worker thread command latency since launch, see DPWinRT_GetRequestLatencyStats(). -1 = no data
+    configid_int_state_performance_capture_request_max_us,
+    configid_int_state_performance_capture_request_timeouts,
+    configid_int_state_performance_capture_window_cache_hits,       //Capture window state cache reads in the last second, see DPWinRT_GetWindowStateCacheStats(). -1 = no data
+    configid_int_state_performance_capture_window_cache_fallbacks,
+    configid_int_state_performance_transform_submitted,     //Overlay transforms submitted and skipped in the last second, see OverlayTransformCache. -1 = no data
+    configid_int_state_performance_transform_skipped,
     configid_int_state_interface_desktop_count,             //Count of desktops after optionally filtering virtual WMR displays
     configid_int_state_interface_floating_ui_hovered_id,    //Floating UI target overlay ID set only while the laser pointer is pointing at the Floating UI overlay. -1 = None
     configid_int_MAX
@@ -154,6 +184,7 @@ enum ConfigID_Float
     configid_float_input_global_hmd_pointer_max_distance,
     configid_float_interface_last_vr_ui_scale,
     configid_float_performance_update_limit_ms,
+    configid_float_performance_transform_epsilon,           //See OverlayTransformCache::SetEpsilon(), stored in millionths
     configid_float_MAX
 };
 
@@ -170,7 +201,6 @@ enum ConfigID_String
     configid_str_overlay_winrt_last_window_exe_name,
     configid_str_overlay_MAX,
     configid_str_state_detached_transform_current,
-    configid_str_state_action_value_string,
     configid_str_state_ui_keyboard_string,           //SteamVR keyboard input for the UI application
     configid_str_state_dashboard_error_string,       //Error messages are displayed in VR through the UI app
     configid_str_state_profile_name_load,            //Name of the profile to load 
@@ -270,6 +300,10 @@ class OverlayConfigData
         std::vector<ActionMainBarOrderData> ConfigActionBarOrder;
 
         OverlayConfigData();
+
+        //Access by WParam of an overlay bool or int config ID, as used by OverlayConfigBatch. Return false for any other ID
+        bool GetValueForWParam(WPARAM wparam, int& value) const;
+        bool SetValueForWParam(WPARAM wparam, int value);
 };
 
 class ConfigManager
@@ -282,6 +316,7 @@ class ConfigManager
 		std::string m_ConfigString[configid_str_MAX];
 
         ActionManager m_ActionManager;
+        std::vector<std::string> m_OverlayGroupNames;
 
         std::string m_ApplicationPath;
         std::string m_ExecutableName;
@@ -336,6 +371,7 @@ class ConfigManager
         ActionManager& GetActionManager();
         std::vector<CustomAction>& GetCustomActions();
         std::vector<ActionMainBarOrderData>& GetActionMainBarOrder();
+        std::vector<std::string>& GetOverlayGroupNames();     //Group ID is index + 1, 0 is no group
         Matrix4& GetOverlayDetachedTransform();
 
 		const std::string& GetApplicationPath() const;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BinaryStream.h"
+
+//Serialized custom actions layout:
+//Header: uint16 version, uint16 record count, int32 first custom action ID, uint32 minimum list size
+//Record: uint8 function type, uint8[3] key codes, int32 IntID, string name, string StrMain, string StrArg
+//The receiving list grows to the minimum list size if needed, but never shrinks (deletions are sent separately)
+//
+//Templated on the action type to keep this free of the Windows-dependent CustomAction definition. The type needs the members
+//Name, FunctionType (enum), KeyCodes[3], StrMain, StrArg and IntID, anything else is left untouched when applying
+class CustomActionSerialization
+{
+    public:
+        static const uint16_t Version         = 1;
+        static const uint32_t MaxCount        = 10000;
+        static const uint32_t MaxStringLength = 4096;
+
+        template<typename T>
+        static void Write(BinaryWriter& writer, int first_id, const T* actions, int count, size_t list_size)
+        {
+            //Header and fixed part of each record plus the strings
+            size_t size = 12;
+            for (int i = 0; i < count; ++i)
+            {
+                size += 20 + actions[i].Name.size() + actions[i].StrMain.size() + actions[i].StrArg.size();
+            }
+
+            writer.Reserve(size);
+
+            writer.Write<uint16_t>(Version);
+            writer.Write<uint16_t>((uint16_t)count);
+            writer.Write<int32_t>(first_id);
+            writer.Write<uint32_t>((uint32_t)list_size);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const T& action = actions[i];
+
+                writer.Write<uint8_t>((uint8_t)action.FunctionType);
+                writer.Write<uint8_t>(action.KeyCodes[0]);
+                writer.Write<uint8_t>(action.KeyCodes[1]);
+                writer.Write<uint8_t>(action.KeyCodes[2]);
+                writer.Write<int32_t>(action.IntID);
+                writer.WriteString(action.Name);
+                writer.WriteString(action.StrMain);
+                writer.WriteString(action.StrArg);
+            }
+        }
+
+        //Function types above function_type_max are read as 0. Returns false and leaves the actions untouched if the data is invalid
+        template<typename T>
+        static bool Apply(std::vector<T>& actions, const void* data, size_t size, int function_type_max)
+        {
+            BinaryReader reader(data, size);
+
+            const uint16_t version   = reader.Read<uint16_t>();
+            const uint16_t count     = reader.Read<uint16_t>();
+            const int32_t first_id   = reader.Read<int32_t>();
+            const uint32_t list_size = reader.Read<uint32_t>();
+
+            if ( (reader.HasFailed()) || (version != Version) || (first_id < 0) || (list_size > MaxCount) || ((uint32_t)first_id + count > list_size) )
+            {
+                return false;
+            }
+
+            //Read everything before touching the actual list, so the update is applied either completely or not at all
+            std::vector<T> actions_new(count);
+
+            for (T& action : actions_new)
+            {
+                const uint8_t function_type = reader.Read<uint8_t>();
+                action.FunctionType = (decltype(action.FunctionType))((function_type <= function_type_max) ? function_type : 0);
+                action.KeyCodes[0]  = reader.Read<uint8_t>();
+                action.KeyCodes[1]  = reader.Read<uint8_t>();
+                action.KeyCodes[2]  = reader.Read<uint8_t>();
+                action.IntID        = reader.Read<int32_t>();
+                action.Name         = reader.ReadString(MaxStringLength);
+                action.StrMain      = reader.ReadString(MaxStringLength);
+                action.StrArg       = reader.ReadString(MaxStringLength);
+            }
+
+            if ( (reader.HasFailed()) || (!reader.IsAtEnd()) )
+                return false;
+
+            if (actions.size() < list_size)
+            {
+                actions.resize(list_size);
+            }
+
+            //Assign members individually to keep any process-specific state of existing actions
+            for (int i = 0; i < count; ++i)
+            {
+                T& action = actions[first_id + i];
+                T& action_new = actions_new[i];
+
+                action.Name         = std::move(action_new.Name);
+                action.FunctionType = action_new.FunctionType;
+                memcpy(action.KeyCodes, action_new.KeyCodes, sizeof(action.KeyCodes));
+                action.StrMain      = std::move(action_new.StrMain);
+                action.StrArg       = std::move(action_new.StrArg);
+                action.IntID        = action_new.IntID;
+            }
+
+            return true;
+        }
+};
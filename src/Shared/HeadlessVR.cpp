@@ -0,0 +1,2723 @@
+#include "HeadlessVR.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+
+using namespace HeadlessVR;
+
+namespace
+{
+    struct DeviceState
+    {
+        vr::ETrackedDeviceClass Class          = vr::TrackedDeviceClass_Invalid;
+        vr::ETrackedControllerRole Role        = vr::TrackedControllerRole_Invalid;
+        vr::EDeviceActivityLevel ActivityLevel = vr::k_EDeviceActivityLevel_UserInteraction;
+        vr::TrackedDevicePose_t Pose           = {};
+    };
+
+    struct PropertyValue
+    {
+        vr::PropertyTypeTag_t Type = vr::k_unInvalidPropertyTag;
+        bool ValueBool             = false;
+        float ValueFloat           = 0.0f;
+        int32_t ValueInt32         = 0;
+        uint64_t ValueUint64       = 0;
+        std::string ValueString;
+    };
+
+    struct ActionState
+    {
+        bool IsAnalog       = false;
+        //Scripted state, applied on UpdateActionState()
+        bool PendingState   = false;
+        float PendingX      = 0.0f;
+        float PendingY      = 0.0f;
+        float PendingZ      = 0.0f;
+        //State returned to the application
+        bool State          = false;
+        bool HasChanged     = false;
+        float X             = 0.0f;
+        float Y             = 0.0f;
+        float Z             = 0.0f;
+        float DeltaX        = 0.0f;
+        float DeltaY        = 0.0f;
+        float DeltaZ        = 0.0f;
+    };
+
+    struct RuntimeState
+    {
+        std::vector<OverlayState> Overlays;
+        DeviceState Devices[vr::k_unMaxTrackedDeviceCount];
+        std::map<std::pair<vr::TrackedDeviceIndex_t, vr::ETrackedDeviceProperty>, PropertyValue> Properties;
+        vr::HmdMatrix34_t SeatedZeroPose;
+        std::deque<vr::VREvent_t> SystemEvents;
+        std::deque< std::pair<vr::VROverlayHandle_t, vr::VREvent_t> > OverlayEvents;
+        bool IsDashboardVisible                         = false;
+        vr::VROverlayHandle_t ActiveDashboardOverlay    = vr::k_ulOverlayHandleInvalid;
+        vr::TrackedDeviceIndex_t PrimaryDashboardDevice = vr::k_unTrackedDeviceIndex_Hmd;
+        vr::VROverlayHandle_t HoverTargetOverlay        = vr::k_ulOverlayHandleInvalid;
+        uint32_t SceneFocusProcess                      = 0;
+        vr::Compositor_FrameTiming FrameTiming          = {};
+        vr::ETrackingUniverseOrigin TrackingSpace       = vr::TrackingUniverseStanding;
+        KeyboardState Keyboard;
+        std::string ActionManifestPath;
+        std::map<uint64_t, ActionState> Actions;        //Keyed by action handle
+        vr::ETrackedControllerRole DominantHand         = vr::TrackedControllerRole_RightHand;
+        uint64_t HapticPulseCount                       = 0;
+
+        RuntimeState();
+    };
+
+    struct CallCounter
+    {
+        std::string Function;
+        std::atomic<uint64_t> Count{0};
+
+        CallCounter(std::string function) : Function(std::move(function)) {}
+    };
+
+    //Globals
+    //- Protected by g_Mutex
+    std::mutex g_Mutex;
+    RuntimeState g_State;
+    vr::VROverlayHandle_t g_OverlayHandleNext = 1;      //Not reset by Reset() so stale handles from before stay invalid
+    std::vector<std::string> g_InputHandleNames;        //Action set, action and input source handles are the index + 1 of their lower-case name
+
+    //- Protected by g_CallCountersMutex, counters are never removed so references to them stay valid
+    std::mutex g_CallCountersMutex;
+    std::deque<CallCounter> g_CallCounters;
+
+    //- Atomic
+    std::atomic<bool> g_IsInitialized{false};
+    std::atomic<uint32_t> g_InitToken{0};
+
+
+    std::atomic<uint64_t>& RegisterCallCounter(const char* interface_name, const char* function_name)
+    {
+        std::lock_guard<std::mutex> lock(g_CallCountersMutex);
+
+        g_CallCounters.emplace_back(std::string(interface_name) + "::" + function_name);
+        return g_CallCounters.back().Count;
+    }
+
+    //Counts the call of the function it's used in. The counter is looked up once per function
+    #define HEADLESSVR_COUNT_CALL(interface_name) \
+        static std::atomic<uint64_t>& headlessvr_call_count = RegisterCallCounter(interface_name, __func__); \
+        headlessvr_call_count.fetch_add(1, std::memory_order_relaxed)
+
+    //- Math helpers, transforms are treated as rigid
+    vr::HmdMatrix34_t MatrixIdentity()
+    {
+        return {{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}}};
+    }
+
+    vr::HmdMatrix34_t MatrixMultiply(const vr::HmdMatrix34_t& a, const vr::HmdMatrix34_t& b)
+    {
+        vr::HmdMatrix34_t result;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 4; ++col)
+            {
+                result.m[row][col] = (a.m[row][0] * b.m[0][col]) + (a.m[row][1] * b.m[1][col]) + (a.m[row][2] * b.m[2][col]) + ((col == 3) ? a.m[row][3] : 0.0f);
+            }
+        }
+
+        return result;
+    }
+
+    vr::HmdMatrix34_t MatrixInverseRigid(const vr::HmdMatrix34_t& mat)
+    {
+        vr::HmdMatrix34_t result;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 3; ++col)
+            {
+                result.m[row][col] = mat.m[col][row];
+            }
+
+            result.m[row][3] = -( (mat.m[0][row] * mat.m[0][3]) + (mat.m[1][row] * mat.m[1][3]) + (mat.m[2][row] * mat.m[2][3]) );
+        }
+
+        return result;
+    }
+
+    vr::HmdVector3_t TransformPoint(const vr::HmdMatrix34_t& mat, const vr::HmdVector3_t& point)
+    {
+        vr::HmdVector3_t result;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            result.v[row] = (mat.m[row][0] * point.v[0]) + (mat.m[row][1] * point.v[1]) + (mat.m[row][2] * point.v[2]) + mat.m[row][3];
+        }
+
+        return result;
+    }
+
+    vr::HmdVector3_t TransformDirection(const vr::HmdMatrix34_t& mat, const vr::HmdVector3_t& direction)
+    {
+        vr::HmdVector3_t result;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            result.v[row] = (mat.m[row][0] * direction.v[0]) + (mat.m[row][1] * direction.v[1]) + (mat.m[row][2] * direction.v[2]);
+        }
+
+        return result;
+    }
+
+    vr::HmdMatrix34_t MatrixTranslation(float x, float y, float z)
+    {
+        vr::HmdMatrix34_t result = MatrixIdentity();
+        result.m[0][3] = x;
+        result.m[1][3] = y;
+        result.m[2][3] = z;
+
+        return result;
+    }
+
+    //All state is stored in standing space. Raw and standing space are the same here
+    vr::HmdMatrix34_t ToStandingSpace(vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& mat)
+    {
+        return (origin == vr::TrackingUniverseSeated) ? MatrixMultiply(g_State.SeatedZeroPose, mat) : mat;
+    }
+
+    vr::HmdMatrix34_t FromStandingSpace(vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& mat)
+    {
+        return (origin == vr::TrackingUniverseSeated) ? MatrixMultiply(MatrixInverseRigid(g_State.SeatedZeroPose), mat) : mat;
+    }
+
+    RuntimeState::RuntimeState()
+    {
+        SeatedZeroPose = MatrixIdentity();
+
+        DeviceState& hmd = Devices[vr::k_unTrackedDeviceIndex_Hmd];
+        hmd.Class = vr::TrackedDeviceClass_HMD;
+        hmd.Pose.mDeviceToAbsoluteTracking = MatrixIdentity();
+        hmd.Pose.eTrackingResult     = vr::TrackingResult_Running_OK;
+        hmd.Pose.bPoseIsValid        = true;
+        hmd.Pose.bDeviceIsConnected  = true;
+
+        FrameTiming.m_nSize = sizeof(vr::Compositor_FrameTiming);
+    }
+
+    //- State access, g_Mutex must be locked
+    OverlayState* FindOverlayState(vr::VROverlayHandle_t overlay_handle)
+    {
+        auto it = std::find_if(g_State.Overlays.begin(), g_State.Overlays.end(), [&](const OverlayState& overlay){ return (overlay.Handle == overlay_handle); });
+        return (it != g_State.Overlays.end()) ? &*it : nullptr;
+    }
+
+    OverlayState* FindOverlayStateByKey(const char* key)
+    {
+        auto it = std::find_if(g_State.Overlays.begin(), g_State.Overlays.end(), [&](const OverlayState& overlay){ return (overlay.Key == key); });
+        return (it != g_State.Overlays.end()) ? &*it : nullptr;
+    }
+
+    bool IsDeviceIndexValid(vr::TrackedDeviceIndex_t device_index)
+    {
+        return (device_index < vr::k_unMaxTrackedDeviceCount);
+    }
+
+    vr::TrackedDevicePose_t GetDevicePose(vr::TrackedDeviceIndex_t device_index, vr::ETrackingUniverseOrigin origin)
+    {
+        vr::TrackedDevicePose_t pose = g_State.Devices[device_index].Pose;
+
+        if (g_State.Devices[device_index].Class != vr::TrackedDeviceClass_Invalid)
+        {
+            pose.mDeviceToAbsoluteTracking = FromStandingSpace(origin, pose.mDeviceToAbsoluteTracking);
+        }
+
+        return pose;
+    }
+
+    void GetDevicePoses(vr::ETrackingUniverseOrigin origin, vr::TrackedDevicePose_t* poses, uint32_t pose_count)
+    {
+        if (poses == nullptr)
+            return;
+
+        for (uint32_t i = 0; i < pose_count; ++i)
+        {
+            poses[i] = (IsDeviceIndexValid(i)) ? GetDevicePose(i, origin) : vr::TrackedDevicePose_t();
+        }
+    }
+
+    //Overlay transform in standing space. Overlay-relative transforms are resolved up to a few levels deep
+    vr::HmdMatrix34_t GetOverlayWorldTransform(const OverlayState& overlay, int depth = 0)
+    {
+        if (overlay.TransformType == OverlayTransform_OverlayRelative)
+        {
+            const OverlayState* parent = FindOverlayState(overlay.TransformParentOverlay);
+            return ( (parent != nullptr) && (depth < 8) ) ? MatrixMultiply(GetOverlayWorldTransform(*parent, depth + 1), overlay.Transform) : overlay.Transform;
+        }
+
+        switch (overlay.TransformType)
+        {
+            case vr::VROverlayTransform_Absolute:
+            case vr::VROverlayTransform_Projection:
+            {
+                return ToStandingSpace(overlay.TransformOrigin, overlay.Transform);
+            }
+            case vr::VROverlayTransform_TrackedDeviceRelative:
+            case vr::VROverlayTransform_TrackedComponent:
+            {
+                if (IsDeviceIndexValid(overlay.TransformDeviceIndex))
+                {
+                    return MatrixMultiply(g_State.Devices[overlay.TransformDeviceIndex].Pose.mDeviceToAbsoluteTracking, overlay.Transform);
+                }
+
+                return overlay.Transform;
+            }
+            default: return overlay.Transform;
+        }
+    }
+
+    //Overlay height follows the mouse scale, which is expected to match the texture size
+    float GetOverlayHeightInMeters(const OverlayState& overlay)
+    {
+        if ( (overlay.MouseScale.v[0] <= 0.0f) || (overlay.TexelAspect <= 0.0f) )
+            return overlay.WidthInMeters;
+
+        return overlay.WidthInMeters * (overlay.MouseScale.v[1] / overlay.MouseScale.v[0]) / overlay.TexelAspect;
+    }
+
+    uint64_t GetInputHandle(const char* name)
+    {
+        if (name == nullptr)
+            return vr::k_ulInvalidInputValueHandle;
+
+        std::string name_lower(name);
+        std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(), [](unsigned char c){ return (char)std::tolower(c); });
+
+        auto it = std::find(g_InputHandleNames.begin(), g_InputHandleNames.end(), name_lower);
+
+        if (it != g_InputHandleNames.end())
+            return (uint64_t)(it - g_InputHandleNames.begin()) + 1;
+
+        g_InputHandleNames.push_back(name_lower);
+        return g_InputHandleNames.size();
+    }
+
+    //Returns the length including the NUL terminator. Copies nothing and sets buffer_too_small if the buffer isn't large enough
+    uint32_t CopyString(const std::string& str, char* buffer, uint32_t buffer_size, bool& buffer_too_small)
+    {
+        const uint32_t length = (uint32_t)str.size() + 1;
+        buffer_too_small = (length > buffer_size);
+
+        if ( (buffer != nullptr) && (!buffer_too_small) )
+        {
+            memcpy(buffer, str.c_str(), length);
+        }
+
+        return length;
+    }
+
+    //Runs the function on the overlay's state. Returns VROverlayError_UnknownOverlay if there's no overlay with the handle
+    template<typename Function>
+    vr::EVROverlayError AccessOverlay(vr::VROverlayHandle_t overlay_handle, Function function)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        OverlayState* overlay = FindOverlayState(overlay_handle);
+
+        if (overlay == nullptr)
+            return vr::VROverlayError_UnknownOverlay;
+
+        function(*overlay);
+        return vr::VROverlayError_None;
+    }
+
+    //Looks up a device property of the given type. Returns nullptr and sets the error if it isn't available
+    const PropertyValue* GetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t type, vr::ETrackedPropertyError* error_out)
+    {
+        vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+        const PropertyValue* value = nullptr;
+
+        if ( (!IsDeviceIndexValid(device_index)) || (g_State.Devices[device_index].Class == vr::TrackedDeviceClass_Invalid) )
+        {
+            error = vr::TrackedProp_InvalidDevice;
+        }
+        else
+        {
+            auto it = g_State.Properties.find({device_index, prop});
+
+            if (it == g_State.Properties.end())
+            {
+                error = vr::TrackedProp_UnknownProperty;
+            }
+            else if (it->second.Type != type)
+            {
+                error = vr::TrackedProp_WrongDataType;
+            }
+            else
+            {
+                value = &it->second;
+            }
+        }
+
+        if (error_out != nullptr)
+        {
+            *error_out = error;
+        }
+
+        return value;
+    }
+
+    void SetDevicePropertyValue(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, const PropertyValue& value)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.Properties[{device_index, prop}] = value;
+    }
+}
+
+
+//- Interfaces
+class HeadlessVRSystem : public vr::IVRSystem
+{
+    public:
+        void GetRecommendedRenderTargetSize(uint32_t* pnWidth, uint32_t* pnHeight) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            *pnWidth  = 1024;
+            *pnHeight = 1024;
+        }
+
+        vr::HmdMatrix44_t GetProjectionMatrix(vr::EVREye eEye, float fNearZ, float fFarZ) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return {{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}}};
+        }
+
+        void GetProjectionRaw(vr::EVREye eEye, float* pfLeft, float* pfRight, float* pfTop, float* pfBottom) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            *pfLeft   = -1.0f;
+            *pfRight  =  1.0f;
+            *pfTop    = -1.0f;
+            *pfBottom =  1.0f;
+        }
+
+        bool ComputeDistortion(vr::EVREye eEye, float fU, float fV, vr::DistortionCoordinates_t* pDistortionCoordinates) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        vr::HmdMatrix34_t GetEyeToHeadTransform(vr::EVREye eEye) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return MatrixIdentity();
+        }
+
+        bool GetTimeSinceLastVsync(float* pfSecondsSinceLastVsync, uint64_t* pulFrameCounter) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (pfSecondsSinceLastVsync != nullptr)
+                *pfSecondsSinceLastVsync = 0.0f;
+            if (pulFrameCounter != nullptr)
+                *pulFrameCounter = g_State.FrameTiming.m_nFrameIndex;
+
+            return true;
+        }
+
+        int32_t GetD3D9AdapterIndex() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return 0;
+        }
+
+        void GetDXGIOutputInfo(int32_t* pnAdapterIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            *pnAdapterIndex = 0;
+        }
+
+        void GetOutputDevice(uint64_t* pnDevice, vr::ETextureType textureType, VkInstance_T* pInstance) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            *pnDevice = 0;
+        }
+
+        bool IsDisplayOnDesktop() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        bool SetDisplayVisibility(bool bIsVisibleOnDesktop) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        void GetDeviceToAbsoluteTrackingPose(vr::ETrackingUniverseOrigin eOrigin, float fPredictedSecondsToPhotonsFromNow, vr::TrackedDevicePose_t* pTrackedDevicePoseArray,
+                                             uint32_t unTrackedDevicePoseArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            GetDevicePoses(eOrigin, pTrackedDevicePoseArray, unTrackedDevicePoseArrayCount);
+        }
+
+        vr::HmdMatrix34_t GetSeatedZeroPoseToStandingAbsoluteTrackingPose() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.SeatedZeroPose;
+        }
+
+        vr::HmdMatrix34_t GetRawZeroPoseToStandingAbsoluteTrackingPose() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return MatrixIdentity();
+        }
+
+        //Devices are returned in index order, not sorted by position
+        uint32_t GetSortedTrackedDeviceIndicesOfClass(vr::ETrackedDeviceClass eTrackedDeviceClass, vr::TrackedDeviceIndex_t* punTrackedDeviceIndexArray, uint32_t unTrackedDeviceIndexArrayCount,
+                                                      vr::TrackedDeviceIndex_t unRelativeToTrackedDeviceIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            uint32_t count = 0;
+            for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
+            {
+                if (g_State.Devices[i].Class == eTrackedDeviceClass)
+                {
+                    if ( (punTrackedDeviceIndexArray != nullptr) && (count < unTrackedDeviceIndexArrayCount) )
+                    {
+                        punTrackedDeviceIndexArray[count] = i;
+                    }
+
+                    count++;
+                }
+            }
+
+            return count;
+        }
+
+        vr::EDeviceActivityLevel GetTrackedDeviceActivityLevel(vr::TrackedDeviceIndex_t unDeviceId) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return (IsDeviceIndexValid(unDeviceId)) ? g_State.Devices[unDeviceId].ActivityLevel : vr::k_EDeviceActivityLevel_Unknown;
+        }
+
+        void ApplyTransform(vr::TrackedDevicePose_t* pOutputPose, const vr::TrackedDevicePose_t* pTrackedDevicePose, const vr::HmdMatrix34_t* pTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            *pOutputPose = *pTrackedDevicePose;
+            pOutputPose->mDeviceToAbsoluteTracking = MatrixMultiply(*pTransform, pTrackedDevicePose->mDeviceToAbsoluteTracking);
+        }
+
+        vr::TrackedDeviceIndex_t GetTrackedDeviceIndexForControllerRole(vr::ETrackedControllerRole unDeviceType) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
+            {
+                if ( (g_State.Devices[i].Class != vr::TrackedDeviceClass_Invalid) && (g_State.Devices[i].Role == unDeviceType) )
+                    return i;
+            }
+
+            return vr::k_unTrackedDeviceIndexInvalid;
+        }
+
+        vr::ETrackedControllerRole GetControllerRoleForTrackedDeviceIndex(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return (IsDeviceIndexValid(unDeviceIndex)) ? g_State.Devices[unDeviceIndex].Role : vr::TrackedControllerRole_Invalid;
+        }
+
+        vr::ETrackedDeviceClass GetTrackedDeviceClass(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return (IsDeviceIndexValid(unDeviceIndex)) ? g_State.Devices[unDeviceIndex].Class : vr::TrackedDeviceClass_Invalid;
+        }
+
+        bool IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return ( (IsDeviceIndexValid(unDeviceIndex)) && (g_State.Devices[unDeviceIndex].Class != vr::TrackedDeviceClass_Invalid) );
+        }
+
+        bool GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            const PropertyValue* value = GetDeviceProperty(unDeviceIndex, prop, vr::k_unBoolPropertyTag, pError);
+            return (value != nullptr) ? value->ValueBool : false;
+        }
+
+        float GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            const PropertyValue* value = GetDeviceProperty(unDeviceIndex, prop, vr::k_unFloatPropertyTag, pError);
+            return (value != nullptr) ? value->ValueFloat : 0.0f;
+        }
+
+        int32_t GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            const PropertyValue* value = GetDeviceProperty(unDeviceIndex, prop, vr::k_unInt32PropertyTag, pError);
+            return (value != nullptr) ? value->ValueInt32 : 0;
+        }
+
+        uint64_t GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            const PropertyValue* value = GetDeviceProperty(unDeviceIndex, prop, vr::k_unUint64PropertyTag, pError);
+            return (value != nullptr) ? value->ValueUint64 : 0;
+        }
+
+        vr::HmdMatrix34_t GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            GetDeviceProperty(unDeviceIndex, prop, vr::k_unHmdMatrix34PropertyTag, pError);     //Not scriptable, only sets the error
+            return MatrixIdentity();
+        }
+
+        uint32_t GetArrayTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t propType, void* pBuffer, uint32_t unBufferSize,
+                                               vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            GetDeviceProperty(unDeviceIndex, prop, propType, pError);                           //Not scriptable, only sets the error
+            return 0;
+        }
+
+        uint32_t GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, char* pchValue, uint32_t unBufferSize,
+                                                vr::ETrackedPropertyError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            vr::ETrackedPropertyError error;
+            const PropertyValue* value = GetDeviceProperty(unDeviceIndex, prop, vr::k_unStringPropertyTag, &error);
+            uint32_t length = 0;
+
+            if (value != nullptr)
+            {
+                bool buffer_too_small;
+                length = CopyString(value->ValueString, pchValue, unBufferSize, buffer_too_small);
+
+                if (buffer_too_small)
+                {
+                    error = vr::TrackedProp_BufferTooSmall;
+                }
+            }
+
+            if (pError != nullptr)
+            {
+                *pError = error;
+            }
+
+            return length;
+        }
+
+        const char* GetPropErrorNameFromEnum(vr::ETrackedPropertyError error) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+
+            switch (error)
+            {
+                case vr::TrackedProp_Success:           return "TrackedProp_Success";
+                case vr::TrackedProp_WrongDataType:     return "TrackedProp_WrongDataType";
+                case vr::TrackedProp_BufferTooSmall:    return "TrackedProp_BufferTooSmall";
+                case vr::TrackedProp_UnknownProperty:   return "TrackedProp_UnknownProperty";
+                case vr::TrackedProp_InvalidDevice:     return "TrackedProp_InvalidDevice";
+                default:                                return "TrackedProp_Unknown";
+            }
+        }
+
+        bool PollNextEvent(vr::VREvent_t* pEvent, uint32_t uncbVREvent) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (g_State.SystemEvents.empty())
+                return false;
+
+            memcpy(pEvent, &g_State.SystemEvents.front(), std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            g_State.SystemEvents.pop_front();
+
+            return true;
+        }
+
+        bool PollNextEventWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::VREvent_t* pEvent, uint32_t uncbVREvent, vr::TrackedDevicePose_t* pTrackedDevicePose) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (g_State.SystemEvents.empty())
+                return false;
+
+            const vr::VREvent_t& vr_event = g_State.SystemEvents.front();
+
+            if (pTrackedDevicePose != nullptr)
+            {
+                *pTrackedDevicePose = (IsDeviceIndexValid(vr_event.trackedDeviceIndex)) ? GetDevicePose(vr_event.trackedDeviceIndex, eOrigin) : vr::TrackedDevicePose_t();
+            }
+
+            memcpy(pEvent, &vr_event, std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            g_State.SystemEvents.pop_front();
+
+            return true;
+        }
+
+        const char* GetEventTypeNameFromEnum(vr::EVREventType eType) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return "VREvent_Unknown";
+        }
+
+        vr::HiddenAreaMesh_t GetHiddenAreaMesh(vr::EVREye eEye, vr::EHiddenAreaMeshType type) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return {nullptr, 0};
+        }
+
+        bool GetControllerState(vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t* pControllerState, uint32_t unControllerStateSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            memset(pControllerState, 0, std::min<size_t>(unControllerStateSize, sizeof(vr::VRControllerState_t)));
+            return ( (IsDeviceIndexValid(unControllerDeviceIndex)) && (g_State.Devices[unControllerDeviceIndex].Class == vr::TrackedDeviceClass_Controller) );
+        }
+
+        bool GetControllerStateWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t* pControllerState,
+                                        uint32_t unControllerStateSize, vr::TrackedDevicePose_t* pTrackedDevicePose) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            memset(pControllerState, 0, std::min<size_t>(unControllerStateSize, sizeof(vr::VRControllerState_t)));
+
+            if ( (!IsDeviceIndexValid(unControllerDeviceIndex)) || (g_State.Devices[unControllerDeviceIndex].Class != vr::TrackedDeviceClass_Controller) )
+                return false;
+
+            if (pTrackedDevicePose != nullptr)
+            {
+                *pTrackedDevicePose = GetDevicePose(unControllerDeviceIndex, eOrigin);
+            }
+
+            return true;
+        }
+
+        void TriggerHapticPulse(vr::TrackedDeviceIndex_t unControllerDeviceIndex, uint32_t unAxisId, unsigned short usDurationMicroSec) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_State.HapticPulseCount++;
+        }
+
+        const char* GetButtonIdNameFromEnum(vr::EVRButtonId eButtonId) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return "k_EButton_Unknown";
+        }
+
+        const char* GetControllerAxisTypeNameFromEnum(vr::EVRControllerAxisType eAxisType) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return "k_eControllerAxis_Unknown";
+        }
+
+        bool IsInputAvailable() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return true;
+        }
+
+        bool IsSteamVRDrawingControllers() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        bool ShouldApplicationPause() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        bool ShouldApplicationReduceRenderingWork() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return false;
+        }
+
+        vr::EVRFirmwareError PerformFirmwareUpdate(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return vr::VRFirmwareError_None;
+        }
+
+        void AcknowledgeQuit_Exiting() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+        }
+
+        uint32_t GetAppContainerFilePaths(char* pchBuffer, uint32_t unBufferSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            bool buffer_too_small;
+            return CopyString("", pchBuffer, unBufferSize, buffer_too_small);
+        }
+
+        const char* GetRuntimeVersion() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRSystem");
+            return "HeadlessVR";
+        }
+};
+
+class HeadlessVROverlay : public vr::IVROverlay
+{
+    private:
+        vr::EVROverlayError CreateOverlayInternal(const char* key, const char* name, vr::VROverlayHandle_t* handle_out, OverlayState** state_out = nullptr)
+        {
+            if ( (key == nullptr) || (name == nullptr) || (handle_out == nullptr) )
+                return vr::VROverlayError_InvalidParameter;
+            if (strlen(key) >= vr::k_unVROverlayMaxKeyLength)
+                return vr::VROverlayError_KeyTooLong;
+            if (strlen(name) >= vr::k_unVROverlayMaxNameLength)
+                return vr::VROverlayError_NameTooLong;
+            if (FindOverlayStateByKey(key) != nullptr)
+                return vr::VROverlayError_KeyInUse;
+
+            OverlayState overlay;
+            overlay.Handle = g_OverlayHandleNext++;
+            overlay.Key    = key;
+            overlay.Name   = name;
+
+            g_State.Overlays.push_back(overlay);
+            *handle_out = overlay.Handle;
+
+            if (state_out != nullptr)
+            {
+                *state_out = &g_State.Overlays.back();
+            }
+
+            return vr::VROverlayError_None;
+        }
+
+    public:
+        vr::EVROverlayError FindOverlay(const char* pchOverlayKey, vr::VROverlayHandle_t* pOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            const OverlayState* overlay = (pchOverlayKey != nullptr) ? FindOverlayStateByKey(pchOverlayKey) : nullptr;
+            *pOverlayHandle = (overlay != nullptr) ? overlay->Handle : vr::k_ulOverlayHandleInvalid;
+
+            return (overlay != nullptr) ? vr::VROverlayError_None : vr::VROverlayError_UnknownOverlay;
+        }
+
+        vr::EVROverlayError CreateOverlay(const char* pchOverlayKey, const char* pchOverlayName, vr::VROverlayHandle_t* pOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return CreateOverlayInternal(pchOverlayKey, pchOverlayName, pOverlayHandle);
+        }
+
+        vr::EVROverlayError DestroyOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            auto it = std::find_if(g_State.Overlays.begin(), g_State.Overlays.end(), [&](const OverlayState& overlay){ return (overlay.Handle == ulOverlayHandle); });
+
+            if (it == g_State.Overlays.end())
+                return vr::VROverlayError_UnknownOverlay;
+
+            g_State.Overlays.erase(it);
+
+            //Drop anything still referencing the overlay
+            g_State.OverlayEvents.erase(std::remove_if(g_State.OverlayEvents.begin(), g_State.OverlayEvents.end(), [&](const auto& overlay_event){ return (overlay_event.first == ulOverlayHandle); }),
+                                        g_State.OverlayEvents.end());
+
+            if (g_State.HoverTargetOverlay == ulOverlayHandle)
+                g_State.HoverTargetOverlay = vr::k_ulOverlayHandleInvalid;
+            if (g_State.ActiveDashboardOverlay == ulOverlayHandle)
+                g_State.ActiveDashboardOverlay = vr::k_ulOverlayHandleInvalid;
+
+            return vr::VROverlayError_None;
+        }
+
+        uint32_t GetOverlayKey(vr::VROverlayHandle_t ulOverlayHandle, char* pchValue, uint32_t unBufferSize, vr::EVROverlayError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            uint32_t length = 0;
+            bool buffer_too_small = false;
+
+            vr::EVROverlayError error = AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ length = CopyString(overlay.Key, pchValue, unBufferSize, buffer_too_small); });
+
+            if (pError != nullptr)
+            {
+                *pError = (buffer_too_small) ? vr::VROverlayError_ArrayTooSmall : error;
+            }
+
+            return length;
+        }
+
+        uint32_t GetOverlayName(vr::VROverlayHandle_t ulOverlayHandle, char* pchValue, uint32_t unBufferSize, vr::EVROverlayError* pError) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            uint32_t length = 0;
+            bool buffer_too_small = false;
+
+            vr::EVROverlayError error = AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ length = CopyString(overlay.Name, pchValue, unBufferSize, buffer_too_small); });
+
+            if (pError != nullptr)
+            {
+                *pError = (buffer_too_small) ? vr::VROverlayError_ArrayTooSmall : error;
+            }
+
+            return length;
+        }
+
+        vr::EVROverlayError SetOverlayName(vr::VROverlayHandle_t ulOverlayHandle, const char* pchName) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            if (pchName == nullptr)
+                return vr::VROverlayError_InvalidParameter;
+            if (strlen(pchName) >= vr::k_unVROverlayMaxNameLength)
+                return vr::VROverlayError_NameTooLong;
+
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.Name = pchName; });
+        }
+
+        //Only returns data set with SetOverlayRaw()
+        vr::EVROverlayError GetOverlayImageData(vr::VROverlayHandle_t ulOverlayHandle, void* pvBuffer, uint32_t unBufferSize, uint32_t* punWidth, uint32_t* punHeight) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            vr::EVROverlayError error_data = vr::VROverlayError_None;
+
+            vr::EVROverlayError error = AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                *punWidth  = overlay.RawWidth;
+                *punHeight = overlay.RawHeight;
+
+                if (overlay.RawData.empty())
+                    error_data = vr::VROverlayError_InvalidTexture;
+                else if (unBufferSize < overlay.RawData.size())
+                    error_data = vr::VROverlayError_ArrayTooSmall;
+                else
+                    memcpy(pvBuffer, overlay.RawData.data(), overlay.RawData.size());
+            });
+
+            return (error != vr::VROverlayError_None) ? error : error_data;
+        }
+
+        const char* GetOverlayErrorNameFromEnum(vr::EVROverlayError error) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            switch (error)
+            {
+                case vr::VROverlayError_None:               return "VROverlayError_None";
+                case vr::VROverlayError_UnknownOverlay:     return "VROverlayError_UnknownOverlay";
+                case vr::VROverlayError_InvalidHandle:      return "VROverlayError_InvalidHandle";
+                case vr::VROverlayError_KeyTooLong:         return "VROverlayError_KeyTooLong";
+                case vr::VROverlayError_NameTooLong:        return "VROverlayError_NameTooLong";
+                case vr::VROverlayError_KeyInUse:           return "VROverlayError_KeyInUse";
+                case vr::VROverlayError_InvalidParameter:   return "VROverlayError_InvalidParameter";
+                case vr::VROverlayError_ArrayTooSmall:      return "VROverlayError_ArrayTooSmall";
+                case vr::VROverlayError_RequestFailed:      return "VROverlayError_RequestFailed";
+                case vr::VROverlayError_InvalidTexture:     return "VROverlayError_InvalidTexture";
+                default:                                    return "VROverlayError_Unknown";
+            }
+        }
+
+        vr::EVROverlayError SetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unPID) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.RenderingPid = unPID; });
+        }
+
+        uint32_t GetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            uint32_t pid = 0;
+            AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ pid = overlay.RenderingPid; });
+            return pid;
+        }
+
+        vr::EVROverlayError SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool bEnabled) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.Flags = (bEnabled) ? (overlay.Flags | eOverlayFlag) : (overlay.Flags & ~(uint32_t)eOverlayFlag); });
+        }
+
+        vr::EVROverlayError GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool* pbEnabled) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pbEnabled = ((overlay.Flags & eOverlayFlag) != 0); });
+        }
+
+        vr::EVROverlayError GetOverlayFlags(vr::VROverlayHandle_t ulOverlayHandle, uint32_t* pFlags) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pFlags = overlay.Flags; });
+        }
+
+        vr::EVROverlayError SetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float fRed, float fGreen, float fBlue) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.ColorR = fRed; overlay.ColorG = fGreen; overlay.ColorB = fBlue; });
+        }
+
+        vr::EVROverlayError GetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float* pfRed, float* pfGreen, float* pfBlue) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfRed = overlay.ColorR; *pfGreen = overlay.ColorG; *pfBlue = overlay.ColorB; });
+        }
+
+        vr::EVROverlayError SetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float fAlpha) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.Alpha = fAlpha; });
+        }
+
+        vr::EVROverlayError GetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float* pfAlpha) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfAlpha = overlay.Alpha; });
+        }
+
+        vr::EVROverlayError SetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float fTexelAspect) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.TexelAspect = fTexelAspect; });
+        }
+
+        vr::EVROverlayError GetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float* pfTexelAspect) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfTexelAspect = overlay.TexelAspect; });
+        }
+
+        vr::EVROverlayError SetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unSortOrder) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.SortOrder = unSortOrder; });
+        }
+
+        vr::EVROverlayError GetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t* punSortOrder) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *punSortOrder = overlay.SortOrder; });
+        }
+
+        vr::EVROverlayError SetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float fWidthInMeters) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            if (fWidthInMeters < 0.0f)
+                return vr::VROverlayError_InvalidParameter;
+
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.WidthInMeters = fWidthInMeters; });
+        }
+
+        vr::EVROverlayError GetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float* pfWidthInMeters) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfWidthInMeters = overlay.WidthInMeters; });
+        }
+
+        vr::EVROverlayError SetOverlayCurvature(vr::VROverlayHandle_t ulOverlayHandle, float fCurvature) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.Curvature = fCurvature; });
+        }
+
+        vr::EVROverlayError GetOverlayCurvature(vr::VROverlayHandle_t ulOverlayHandle, float* pfCurvature) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfCurvature = overlay.Curvature; });
+        }
+
+        vr::EVROverlayError SetOverlayPreCurvePitch(vr::VROverlayHandle_t ulOverlayHandle, float fRadians) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.PreCurvePitch = fRadians; });
+        }
+
+        vr::EVROverlayError GetOverlayPreCurvePitch(vr::VROverlayHandle_t ulOverlayHandle, float* pfRadians) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pfRadians = overlay.PreCurvePitch; });
+        }
+
+        vr::EVROverlayError SetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace eTextureColorSpace) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.TextureColorSpace = eTextureColorSpace; });
+        }
+
+        vr::EVROverlayError GetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace* peTextureColorSpace) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *peTextureColorSpace = overlay.TextureColorSpace; });
+        }
+
+        vr::EVROverlayError SetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, const vr::VRTextureBounds_t* pOverlayTextureBounds) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.TextureBounds = *pOverlayTextureBounds; });
+        }
+
+        vr::EVROverlayError GetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, vr::VRTextureBounds_t* pOverlayTextureBounds) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pOverlayTextureBounds = overlay.TextureBounds; });
+        }
+
+        vr::EVROverlayError GetOverlayTransformType(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayTransformType* peTransformType) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *peTransformType = overlay.TransformType; });
+        }
+
+        vr::EVROverlayError SetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin,
+                                                        const vr::HmdMatrix34_t* pmatTrackingOriginToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType   = vr::VROverlayTransform_Absolute;
+                overlay.TransformOrigin = eTrackingOrigin;
+                overlay.Transform       = *pmatTrackingOriginToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin* peTrackingOrigin,
+                                                        vr::HmdMatrix34_t* pmatTrackingOriginToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                *peTrackingOrigin = overlay.TransformOrigin;
+                *pmatTrackingOriginToOverlayTransform = overlay.Transform;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unTrackedDevice,
+                                                                     const vr::HmdMatrix34_t* pmatTrackedDeviceToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType        = vr::VROverlayTransform_TrackedDeviceRelative;
+                overlay.TransformDeviceIndex = unTrackedDevice;
+                overlay.Transform            = *pmatTrackedDeviceToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t* punTrackedDevice,
+                                                                     vr::HmdMatrix34_t* pmatTrackedDeviceToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                *punTrackedDevice = overlay.TransformDeviceIndex;
+                *pmatTrackedDeviceToOverlayTransform = overlay.Transform;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unDeviceIndex, const char* pchComponentName) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType        = vr::VROverlayTransform_TrackedComponent;
+                overlay.TransformDeviceIndex = unDeviceIndex;
+                overlay.Transform            = MatrixIdentity();
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t* punDeviceIndex, char* pchComponentName,
+                                                                      uint32_t unComponentNameSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                *punDeviceIndex = overlay.TransformDeviceIndex;
+
+                if ( (pchComponentName != nullptr) && (unComponentNameSize != 0) )
+                    pchComponentName[0] = '\0';
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformOverlayRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t* ulOverlayHandleParent,
+                                                               vr::HmdMatrix34_t* pmatParentOverlayToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                *ulOverlayHandleParent = overlay.TransformParentOverlay;
+                *pmatParentOverlayToOverlayTransform = overlay.Transform;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformOverlayRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulOverlayHandleParent,
+                                                               const vr::HmdMatrix34_t* pmatParentOverlayToOverlayTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType          = OverlayTransform_OverlayRelative;
+                overlay.TransformParentOverlay = ulOverlayHandleParent;
+                overlay.Transform              = *pmatParentOverlayToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformCursor(vr::VROverlayHandle_t ulCursorOverlayHandle, const vr::HmdVector2_t* pvHotspot) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulCursorOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType = vr::VROverlayTransform_Cursor;
+                overlay.CursorHotspot = *pvHotspot;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformCursor(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdVector2_t* pvHotspot) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pvHotspot = overlay.CursorHotspot; });
+        }
+
+        vr::EVROverlayError SetOverlayTransformProjection(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin,
+                                                          const vr::HmdMatrix34_t* pmatTrackingOriginToOverlayTransform, const vr::VROverlayProjection_t* pProjection, vr::EVREye eEye) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TransformType   = vr::VROverlayTransform_Projection;
+                overlay.TransformOrigin = eTrackingOrigin;
+                overlay.Transform       = *pmatTrackingOriginToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError ShowOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.IsVisible = true; });
+        }
+
+        vr::EVROverlayError HideOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.IsVisible = false; });
+        }
+
+        bool IsOverlayVisible(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            bool is_visible = false;
+            AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ is_visible = overlay.IsVisible; });
+            return is_visible;
+        }
+
+        //Overlay coordinates are in mouse scale units with the origin at the bottom left, like the mouse events from the runtime
+        vr::EVROverlayError GetTransformForOverlayCoordinates(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, vr::HmdVector2_t coordinatesInOverlay,
+                                                              vr::HmdMatrix34_t* pmatTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                const float u = (overlay.MouseScale.v[0] != 0.0f) ? coordinatesInOverlay.v[0] / overlay.MouseScale.v[0] : 0.0f;
+                const float v = (overlay.MouseScale.v[1] != 0.0f) ? coordinatesInOverlay.v[1] / overlay.MouseScale.v[1] : 0.0f;
+                const vr::HmdMatrix34_t offset = MatrixTranslation((u - 0.5f) * overlay.WidthInMeters, (v - 0.5f) * GetOverlayHeightInMeters(overlay), 0.0f);
+
+                *pmatTransform = FromStandingSpace(eTrackingOrigin, MatrixMultiply(GetOverlayWorldTransform(overlay), offset));
+            });
+        }
+
+        vr::EVROverlayError WaitFrameSync(uint32_t nTimeoutMs) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return vr::VROverlayError_None;
+        }
+
+        bool PollNextOverlayEvent(vr::VROverlayHandle_t ulOverlayHandle, vr::VREvent_t* pEvent, uint32_t uncbVREvent) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            auto it = std::find_if(g_State.OverlayEvents.begin(), g_State.OverlayEvents.end(), [&](const auto& overlay_event){ return (overlay_event.first == ulOverlayHandle); });
+
+            if (it == g_State.OverlayEvents.end())
+                return false;
+
+            memcpy(pEvent, &it->second, std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            g_State.OverlayEvents.erase(it);
+
+            return true;
+        }
+
+        vr::EVROverlayError GetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod* peInputMethod) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *peInputMethod = overlay.InputMethod; });
+        }
+
+        vr::EVROverlayError SetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod eInputMethod) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.InputMethod = eInputMethod; });
+        }
+
+        vr::EVROverlayError GetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdVector2_t* pvecMouseScale) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pvecMouseScale = overlay.MouseScale; });
+        }
+
+        vr::EVROverlayError SetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, const vr::HmdVector2_t* pvecMouseScale) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.MouseScale = *pvecMouseScale; });
+        }
+
+        //Intersects with the flat overlay quad, curvature is ignored. UVs have their origin at the bottom left
+        bool ComputeOverlayIntersection(vr::VROverlayHandle_t ulOverlayHandle, const vr::VROverlayIntersectionParams_t* pParams, vr::VROverlayIntersectionResults_t* pResults) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            bool is_hit = false;
+
+            AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                const vr::HmdMatrix34_t overlay_to_origin = FromStandingSpace(pParams->eOrigin, GetOverlayWorldTransform(overlay));
+                const vr::HmdMatrix34_t origin_to_overlay = MatrixInverseRigid(overlay_to_origin);
+                const vr::HmdVector3_t source    = TransformPoint(origin_to_overlay, pParams->vSource);
+                const vr::HmdVector3_t direction = TransformDirection(origin_to_overlay, pParams->vDirection);
+
+                if (std::fabs(direction.v[2]) < 1e-6f)
+                    return;
+
+                const float distance = -source.v[2] / direction.v[2];
+
+                if (distance < 0.0f)
+                    return;
+
+                const float height = GetOverlayHeightInMeters(overlay);
+                const float u = ((source.v[0] + direction.v[0] * distance) / overlay.WidthInMeters) + 0.5f;
+                const float v = ((source.v[1] + direction.v[1] * distance) / height) + 0.5f;
+
+                if ( (u < 0.0f) || (u > 1.0f) || (v < 0.0f) || (v > 1.0f) )
+                    return;
+
+                const vr::HmdVector3_t point_local  = {(u - 0.5f) * overlay.WidthInMeters, (v - 0.5f) * height, 0.0f};
+                const vr::HmdVector3_t normal_local = {0.0f, 0.0f, 1.0f};
+
+                pResults->vPoint    = TransformPoint(overlay_to_origin, point_local);
+                pResults->vNormal   = TransformDirection(overlay_to_origin, normal_local);
+                pResults->vUVs.v[0] = u;
+                pResults->vUVs.v[1] = v;
+                pResults->fDistance = distance * std::sqrt( (pParams->vDirection.v[0] * pParams->vDirection.v[0]) + (pParams->vDirection.v[1] * pParams->vDirection.v[1]) +
+                                                            (pParams->vDirection.v[2] * pParams->vDirection.v[2]) );
+                is_hit = true;
+            });
+
+            return is_hit;
+        }
+
+        bool IsHoverTargetOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return ( (ulOverlayHandle != vr::k_ulOverlayHandleInvalid) && (g_State.HoverTargetOverlay == ulOverlayHandle) );
+        }
+
+        vr::EVROverlayError SetOverlayIntersectionMask(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayIntersectionMaskPrimitive_t* pMaskPrimitives, uint32_t unNumMaskPrimitives,
+                                                       uint32_t unPrimitiveSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.IntersectionMaskPrimitiveCount = unNumMaskPrimitives; });
+        }
+
+        vr::EVROverlayError TriggerLaserMouseHapticVibration(vr::VROverlayHandle_t ulOverlayHandle, float fDurationSeconds, float fFrequency, float fAmplitude) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ g_State.HapticPulseCount++; });
+        }
+
+        vr::EVROverlayError SetOverlayCursor(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulCursorHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){});
+        }
+
+        vr::EVROverlayError SetOverlayCursorPositionOverride(vr::VROverlayHandle_t ulOverlayHandle, const vr::HmdVector2_t* pvCursor) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){});
+        }
+
+        vr::EVROverlayError ClearOverlayCursorPositionOverride(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){});
+        }
+
+        vr::EVROverlayError SetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, const vr::Texture_t* pTexture) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            if (pTexture == nullptr)
+                return vr::VROverlayError_InvalidParameter;
+
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TextureType       = pTexture->eType;
+                overlay.TextureHandle     = pTexture->handle;
+                overlay.TextureColorSpace = pTexture->eColorSpace;
+                overlay.TextureFilePath.clear();
+                overlay.RawData.clear();
+                overlay.RawWidth = overlay.RawHeight = overlay.RawBytesPerPixel = 0;
+                overlay.TextureSetCount++;
+            });
+        }
+
+        vr::EVROverlayError ClearOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TextureType   = vr::TextureType_Invalid;
+                overlay.TextureHandle = nullptr;
+                overlay.TextureFilePath.clear();
+                overlay.RawData.clear();
+                overlay.RawWidth = overlay.RawHeight = overlay.RawBytesPerPixel = 0;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayRaw(vr::VROverlayHandle_t ulOverlayHandle, void* pvBuffer, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            if ( (pvBuffer == nullptr) || (unBytesPerPixel == 0) || (unBytesPerPixel > 4) )
+                return vr::VROverlayError_InvalidParameter;
+
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                const uint8_t* data = (const uint8_t*)pvBuffer;
+
+                overlay.TextureType   = vr::TextureType_Invalid;
+                overlay.TextureHandle = nullptr;
+                overlay.TextureFilePath.clear();
+                overlay.RawData.assign(data, data + ((size_t)unWidth * unHeight * unBytesPerPixel));
+                overlay.RawWidth         = unWidth;
+                overlay.RawHeight        = unHeight;
+                overlay.RawBytesPerPixel = unBytesPerPixel;
+                overlay.TextureSetCount++;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayFromFile(vr::VROverlayHandle_t ulOverlayHandle, const char* pchFilePath) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+
+            if (pchFilePath == nullptr)
+                return vr::VROverlayError_InvalidParameter;
+
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                overlay.TextureType     = vr::TextureType_Invalid;
+                overlay.TextureHandle   = nullptr;
+                overlay.TextureFilePath = pchFilePath;
+                overlay.RawData.clear();
+                overlay.RawWidth = overlay.RawHeight = overlay.RawBytesPerPixel = 0;
+                overlay.TextureSetCount++;
+            });
+        }
+
+        //Returns the handle that was passed to SetOverlayTexture() instead of a new one, since there's no graphics API behind this
+        vr::EVROverlayError GetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, void** pNativeTextureHandle, void* pNativeTextureRef, uint32_t* pWidth, uint32_t* pHeight,
+                                              uint32_t* pNativeFormat, vr::ETextureType* pAPIType, vr::EColorSpace* pColorSpace, vr::VRTextureBounds_t* pTextureBounds) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            bool has_texture = false;
+
+            vr::EVROverlayError error = AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay)
+            {
+                has_texture = (overlay.TextureHandle != nullptr);
+
+                *pNativeTextureHandle = overlay.TextureHandle;
+                *pWidth               = 0;
+                *pHeight              = 0;
+                *pNativeFormat        = 0;
+                *pAPIType             = overlay.TextureType;
+                *pColorSpace          = overlay.TextureColorSpace;
+                *pTextureBounds       = overlay.TextureBounds;
+            });
+
+            return ( (error == vr::VROverlayError_None) && (!has_texture) ) ? vr::VROverlayError_InvalidTexture : error;
+        }
+
+        vr::EVROverlayError ReleaseNativeOverlayHandle(vr::VROverlayHandle_t ulOverlayHandle, void* pNativeTextureHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){});
+        }
+
+        //Size is only known for raw textures
+        vr::EVROverlayError GetOverlayTextureSize(vr::VROverlayHandle_t ulOverlayHandle, uint32_t* pWidth, uint32_t* pHeight) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *pWidth = overlay.RawWidth; *pHeight = overlay.RawHeight; });
+        }
+
+        vr::EVROverlayError CreateDashboardOverlay(const char* pchOverlayKey, const char* pchOverlayFriendlyName, vr::VROverlayHandle_t* pMainHandle,
+                                                   vr::VROverlayHandle_t* pThumbnailHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if ( (pchOverlayKey == nullptr) || (pThumbnailHandle == nullptr) )
+                return vr::VROverlayError_InvalidParameter;
+
+            //The thumbnail gets its own key here so it can be found by FindOverlay() like any other overlay
+            const std::string thumbnail_key = std::string(pchOverlayKey) + ".thumbnail";
+
+            if (FindOverlayStateByKey(thumbnail_key.c_str()) != nullptr)
+                return vr::VROverlayError_KeyInUse;
+
+            OverlayState* overlay_main = nullptr;
+            vr::EVROverlayError error = CreateOverlayInternal(pchOverlayKey, pchOverlayFriendlyName, pMainHandle, &overlay_main);
+
+            if (error != vr::VROverlayError_None)
+                return error;
+
+            overlay_main->IsDashboardOverlay = true;
+
+            OverlayState* overlay_thumbnail = nullptr;
+            error = CreateOverlayInternal(thumbnail_key.c_str(), pchOverlayFriendlyName, pThumbnailHandle, &overlay_thumbnail);
+
+            if (error != vr::VROverlayError_None)
+                return error;
+
+            overlay_thumbnail->IsDashboardThumbnail = true;
+            overlay_thumbnail->TransformType        = vr::VROverlayTransform_DashboardThumb;
+
+            return vr::VROverlayError_None;
+        }
+
+        bool IsDashboardVisible() override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.IsDashboardVisible;
+        }
+
+        bool IsActiveDashboardOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return ( (g_State.IsDashboardVisible) && (ulOverlayHandle != vr::k_ulOverlayHandleInvalid) && (g_State.ActiveDashboardOverlay == ulOverlayHandle) );
+        }
+
+        vr::EVROverlayError SetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unProcessId) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ overlay.SceneProcessID = unProcessId; });
+        }
+
+        vr::EVROverlayError GetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t* punProcessId) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return AccessOverlay(ulOverlayHandle, [&](OverlayState& overlay){ *punProcessId = overlay.SceneProcessID; });
+        }
+
+        void ShowDashboard(const char* pchOverlayToShow) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            const OverlayState* overlay = (pchOverlayToShow != nullptr) ? FindOverlayStateByKey(pchOverlayToShow) : nullptr;
+
+            g_State.IsDashboardVisible = true;
+
+            if ( (overlay != nullptr) && (overlay->IsDashboardOverlay) )
+            {
+                g_State.ActiveDashboardOverlay = overlay->Handle;
+            }
+        }
+
+        vr::TrackedDeviceIndex_t GetPrimaryDashboardDevice() override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.PrimaryDashboardDevice;
+        }
+
+        vr::EVROverlayError ShowKeyboard(vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, uint32_t unFlags, const char* pchDescription,
+                                         uint32_t unCharMax, const char* pchExistingText, uint64_t uUserValue) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            g_State.Keyboard.IsVisible = true;
+            g_State.Keyboard.Overlay   = vr::k_ulOverlayHandleInvalid;
+            g_State.Keyboard.Text      = (pchExistingText != nullptr) ? pchExistingText : "";
+            g_State.Keyboard.UserValue = uUserValue;
+
+            return vr::VROverlayError_None;
+        }
+
+        vr::EVROverlayError ShowKeyboardForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, uint32_t unFlags,
+                                                   const char* pchDescription, uint32_t unCharMax, const char* pchExistingText, uint64_t uUserValue) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (FindOverlayState(ulOverlayHandle) == nullptr)
+                return vr::VROverlayError_UnknownOverlay;
+
+            g_State.Keyboard.IsVisible = true;
+            g_State.Keyboard.Overlay   = ulOverlayHandle;
+            g_State.Keyboard.Text      = (pchExistingText != nullptr) ? pchExistingText : "";
+            g_State.Keyboard.UserValue = uUserValue;
+
+            return vr::VROverlayError_None;
+        }
+
+        uint32_t GetKeyboardText(char* pchText, uint32_t cchText) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            bool buffer_too_small;
+            return CopyString(g_State.Keyboard.Text, pchText, cchText, buffer_too_small);
+        }
+
+        void HideKeyboard() override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            g_State.Keyboard.IsVisible = false;
+            g_State.Keyboard.Overlay   = vr::k_ulOverlayHandleInvalid;
+        }
+
+        void SetKeyboardTransformAbsolute(vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t* pmatTrackingOriginToKeyboardTransform) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+        }
+
+        void SetKeyboardPositionForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdRect2_t avoidRect) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+        }
+
+        vr::VRMessageOverlayResponse ShowMessageOverlay(const char* pchText, const char* pchCaption, const char* pchButton0Text, const char* pchButton1Text, const char* pchButton2Text,
+                                                        const char* pchButton3Text) override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+            return vr::VRMessageOverlayResponse_ButtonPress_0;
+        }
+
+        void CloseMessageOverlay() override
+        {
+            HEADLESSVR_COUNT_CALL("IVROverlay");
+        }
+};
+
+class HeadlessVRCompositor : public vr::IVRCompositor
+{
+    public:
+        void SetTrackingSpace(vr::ETrackingUniverseOrigin eOrigin) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_State.TrackingSpace = eOrigin;
+        }
+
+        vr::ETrackingUniverseOrigin GetTrackingSpace() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.TrackingSpace;
+        }
+
+        vr::EVRCompositorError WaitGetPoses(vr::TrackedDevicePose_t* pRenderPoseArray, uint32_t unRenderPoseArrayCount, vr::TrackedDevicePose_t* pGamePoseArray,
+                                            uint32_t unGamePoseArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return GetLastPoses(pRenderPoseArray, unRenderPoseArrayCount, pGamePoseArray, unGamePoseArrayCount);
+        }
+
+        vr::EVRCompositorError GetLastPoses(vr::TrackedDevicePose_t* pRenderPoseArray, uint32_t unRenderPoseArrayCount, vr::TrackedDevicePose_t* pGamePoseArray,
+                                            uint32_t unGamePoseArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            GetDevicePoses(g_State.TrackingSpace, pRenderPoseArray, unRenderPoseArrayCount);
+            GetDevicePoses(g_State.TrackingSpace, pGamePoseArray,   unGamePoseArrayCount);
+
+            return vr::VRCompositorError_None;
+        }
+
+        vr::EVRCompositorError GetLastPoseForTrackedDeviceIndex(vr::TrackedDeviceIndex_t unDeviceIndex, vr::TrackedDevicePose_t* pOutputPose, vr::TrackedDevicePose_t* pOutputGamePose) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (!IsDeviceIndexValid(unDeviceIndex))
+                return vr::VRCompositorError_IndexOutOfRange;
+
+            if (pOutputPose != nullptr)
+                *pOutputPose = GetDevicePose(unDeviceIndex, g_State.TrackingSpace);
+            if (pOutputGamePose != nullptr)
+                *pOutputGamePose = GetDevicePose(unDeviceIndex, g_State.TrackingSpace);
+
+            return vr::VRCompositorError_None;
+        }
+
+        vr::EVRCompositorError Submit(vr::EVREye eEye, const vr::Texture_t* pTexture, const vr::VRTextureBounds_t* pBounds, vr::EVRSubmitFlags nSubmitFlags) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_None;
+        }
+
+        void ClearLastSubmittedFrame() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void PostPresentHandoff() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        //Every frame has the same timing, as scripted with SetFrameTiming()
+        bool GetFrameTiming(vr::Compositor_FrameTiming* pTiming, uint32_t unFramesAgo) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (pTiming->m_nSize != sizeof(vr::Compositor_FrameTiming))
+                return false;
+
+            *pTiming = g_State.FrameTiming;
+            pTiming->m_nSize = sizeof(vr::Compositor_FrameTiming);
+
+            return true;
+        }
+
+        uint32_t GetFrameTimings(vr::Compositor_FrameTiming* pTiming, uint32_t nFrames) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            for (uint32_t i = 0; i < nFrames; ++i)
+            {
+                pTiming[i] = g_State.FrameTiming;
+                pTiming[i].m_nSize = sizeof(vr::Compositor_FrameTiming);
+            }
+
+            return nFrames;
+        }
+
+        float GetFrameTimeRemaining() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return 0.0f;
+        }
+
+        void GetCumulativeStats(vr::Compositor_CumulativeStats* pStats, uint32_t nStatsSizeInBytes) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            memset(pStats, 0, std::min<size_t>(nStatsSizeInBytes, sizeof(vr::Compositor_CumulativeStats)));
+        }
+
+        void FadeToColor(float fSeconds, float fRed, float fGreen, float fBlue, float fAlpha, bool bBackground) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        vr::HmdColor_t GetCurrentFadeColor(bool bBackground) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return {0.0f, 0.0f, 0.0f, 0.0f};
+        }
+
+        void FadeGrid(float fSeconds, bool bFadeGridIn) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        float GetCurrentGridAlpha() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return 0.0f;
+        }
+
+        vr::EVRCompositorError SetSkyboxOverride(const vr::Texture_t* pTextures, uint32_t unTextureCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_None;
+        }
+
+        void ClearSkyboxOverride() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void CompositorBringToFront() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void CompositorGoToBack() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void CompositorQuit() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        bool IsFullscreen() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        uint32_t GetCurrentSceneFocusProcess() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.SceneFocusProcess;
+        }
+
+        uint32_t GetLastFrameRenderer() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            return g_State.SceneFocusProcess;
+        }
+
+        bool CanRenderScene() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return true;
+        }
+
+        void ShowMirrorWindow() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void HideMirrorWindow() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        bool IsMirrorWindowVisible() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        void CompositorDumpImages() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        bool ShouldAppRenderWithLowResources() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        void ForceInterleavedReprojectionOn(bool bOverride) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void ForceReconnectProcess() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void SuspendRendering(bool bSuspend) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        vr::EVRCompositorError GetMirrorTextureD3D11(vr::EVREye eEye, void* pD3D11DeviceOrResource, void** ppD3D11ShaderResourceView) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_RequestFailed;
+        }
+
+        void ReleaseMirrorTextureD3D11(void* pD3D11ShaderResourceView) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        vr::EVRCompositorError GetMirrorTextureGL(vr::EVREye eEye, vr::glUInt_t* pglTextureId, vr::glSharedTextureHandle_t* pglSharedTextureHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_RequestFailed;
+        }
+
+        bool ReleaseSharedGLTexture(vr::glUInt_t glTextureId, vr::glSharedTextureHandle_t glSharedTextureHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        void LockGLSharedTextureForAccess(vr::glSharedTextureHandle_t glSharedTextureHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        void UnlockGLSharedTextureForAccess(vr::glSharedTextureHandle_t glSharedTextureHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        uint32_t GetVulkanInstanceExtensionsRequired(char* pchValue, uint32_t unBufferSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            bool buffer_too_small;
+            return CopyString("", pchValue, unBufferSize, buffer_too_small);
+        }
+
+        uint32_t GetVulkanDeviceExtensionsRequired(VkPhysicalDevice_T* pPhysicalDevice, char* pchValue, uint32_t unBufferSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            bool buffer_too_small;
+            return CopyString("", pchValue, unBufferSize, buffer_too_small);
+        }
+
+        void SetExplicitTimingMode(vr::EVRCompositorTimingMode eTimingMode) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        vr::EVRCompositorError SubmitExplicitTimingData() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_RequestFailed;
+        }
+
+        bool IsMotionSmoothingEnabled() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        bool IsMotionSmoothingSupported() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        bool IsCurrentSceneFocusAppLoading() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        vr::EVRCompositorError SetStageOverride_Async(const char* pchRenderModelPath, const vr::HmdMatrix34_t* pTransform, const vr::Compositor_StageRenderSettings* pRenderSettings,
+                                                      uint32_t nSizeOfRenderSettings) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return vr::VRCompositorError_None;
+        }
+
+        void ClearStageOverride() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+        }
+
+        bool GetCompositorBenchmarkResults(vr::Compositor_BenchmarkResults* pBenchmarkResults, uint32_t nSizeOfBenchmarkResults) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            return false;
+        }
+
+        vr::EVRCompositorError GetLastPosePredictionIDs(uint32_t* pRenderPosePredictionID, uint32_t* pGamePosePredictionID) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            *pRenderPosePredictionID = 0;
+            *pGamePosePredictionID   = 0;
+            return vr::VRCompositorError_None;
+        }
+
+        vr::EVRCompositorError GetPosesForFrame(uint32_t unPosePredictionID, vr::TrackedDevicePose_t* pPoseArray, uint32_t unPoseArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRCompositor");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            GetDevicePoses(g_State.TrackingSpace, pPoseArray, unPoseArrayCount);
+            return vr::VRCompositorError_None;
+        }
+};
+
+class HeadlessVRInput : public vr::IVRInput
+{
+    private:
+        //Returns nullptr if the action has no scripted state. Unknown handles are reported with VRInputError_InvalidHandle
+        static ActionState* FindAction(vr::VRActionHandle_t action, vr::EVRInputError& error)
+        {
+            error = vr::VRInputError_None;
+
+            if ( (action == vr::k_ulInvalidActionHandle) || (action > g_InputHandleNames.size()) )
+            {
+                error = vr::VRInputError_InvalidHandle;
+                return nullptr;
+            }
+
+            auto it = g_State.Actions.find(action);
+            return (it != g_State.Actions.end()) ? &it->second : nullptr;
+        }
+
+    public:
+        vr::EVRInputError SetActionManifestPath(const char* pchActionManifestPath) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (pchActionManifestPath == nullptr)
+                return vr::VRInputError_InvalidParam;
+
+            g_State.ActionManifestPath = pchActionManifestPath;
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetActionSetHandle(const char* pchActionSetName, vr::VRActionSetHandle_t* pHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            *pHandle = GetInputHandle(pchActionSetName);
+            return (*pHandle != vr::k_ulInvalidActionSetHandle) ? vr::VRInputError_None : vr::VRInputError_NameNotFound;
+        }
+
+        vr::EVRInputError GetActionHandle(const char* pchActionName, vr::VRActionHandle_t* pHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            *pHandle = GetInputHandle(pchActionName);
+            return (*pHandle != vr::k_ulInvalidActionHandle) ? vr::VRInputError_None : vr::VRInputError_NameNotFound;
+        }
+
+        vr::EVRInputError GetInputSourceHandle(const char* pchInputSourcePath, vr::VRInputValueHandle_t* pHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            *pHandle = GetInputHandle(pchInputSourcePath);
+            return (*pHandle != vr::k_ulInvalidInputValueHandle) ? vr::VRInputError_None : vr::VRInputError_NameNotFound;
+        }
+
+        //Applies the scripted action states. Action sets are not tracked, all scripted actions are active
+        vr::EVRInputError UpdateActionState(vr::VRActiveActionSet_t* pSets, uint32_t unSizeOfVRSelectedActionSet_t, uint32_t unSetCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            for (auto& action_pair : g_State.Actions)
+            {
+                ActionState& action = action_pair.second;
+
+                action.HasChanged = (action.State != action.PendingState);
+                action.State      = action.PendingState;
+                action.DeltaX     = action.PendingX - action.X;
+                action.DeltaY     = action.PendingY - action.Y;
+                action.DeltaZ     = action.PendingZ - action.Z;
+                action.X          = action.PendingX;
+                action.Y          = action.PendingY;
+                action.Z          = action.PendingZ;
+            }
+
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetDigitalActionData(vr::VRActionHandle_t action, vr::InputDigitalActionData_t* pActionData, uint32_t unActionDataSize,
+                                               vr::VRInputValueHandle_t ulRestrictToDevice) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (unActionDataSize != sizeof(vr::InputDigitalActionData_t))
+                return vr::VRInputError_InvalidParam;
+
+            vr::EVRInputError error;
+            const ActionState* action_state = FindAction(action, error);
+
+            if ( (action_state != nullptr) && (action_state->IsAnalog) )
+                return vr::VRInputError_WrongType;
+
+            *pActionData = {};
+            pActionData->activeOrigin = vr::k_ulInvalidInputValueHandle;
+
+            if (action_state != nullptr)
+            {
+                pActionData->bActive  = true;
+                pActionData->bState   = action_state->State;
+                pActionData->bChanged = action_state->HasChanged;
+            }
+
+            return error;
+        }
+
+        vr::EVRInputError GetAnalogActionData(vr::VRActionHandle_t action, vr::InputAnalogActionData_t* pActionData, uint32_t unActionDataSize,
+                                              vr::VRInputValueHandle_t ulRestrictToDevice) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+
+            if (unActionDataSize != sizeof(vr::InputAnalogActionData_t))
+                return vr::VRInputError_InvalidParam;
+
+            vr::EVRInputError error;
+            const ActionState* action_state = FindAction(action, error);
+
+            if ( (action_state != nullptr) && (!action_state->IsAnalog) )
+                return vr::VRInputError_WrongType;
+
+            *pActionData = {};
+            pActionData->activeOrigin = vr::k_ulInvalidInputValueHandle;
+
+            if (action_state != nullptr)
+            {
+                pActionData->bActive = true;
+                pActionData->x       = action_state->X;
+                pActionData->y       = action_state->Y;
+                pActionData->z       = action_state->Z;
+                pActionData->deltaX  = action_state->DeltaX;
+                pActionData->deltaY  = action_state->DeltaY;
+                pActionData->deltaZ  = action_state->DeltaZ;
+            }
+
+            return error;
+        }
+
+        vr::EVRInputError GetPoseActionDataRelativeToNow(vr::VRActionHandle_t action, vr::ETrackingUniverseOrigin eOrigin, float fPredictedSecondsFromNow, vr::InputPoseActionData_t* pActionData,
+                                                         uint32_t unActionDataSize, vr::VRInputValueHandle_t ulRestrictToDevice) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            memset(pActionData, 0, std::min<size_t>(unActionDataSize, sizeof(vr::InputPoseActionData_t)));
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetPoseActionDataForNextFrame(vr::VRActionHandle_t action, vr::ETrackingUniverseOrigin eOrigin, vr::InputPoseActionData_t* pActionData, uint32_t unActionDataSize,
+                                                        vr::VRInputValueHandle_t ulRestrictToDevice) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            memset(pActionData, 0, std::min<size_t>(unActionDataSize, sizeof(vr::InputPoseActionData_t)));
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetSkeletalActionData(vr::VRActionHandle_t action, vr::InputSkeletalActionData_t* pActionData, uint32_t unActionDataSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            memset(pActionData, 0, std::min<size_t>(unActionDataSize, sizeof(vr::InputSkeletalActionData_t)));
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetDominantHand(vr::ETrackedControllerRole* peDominantHand) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            *peDominantHand = g_State.DominantHand;
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError SetDominantHand(vr::ETrackedControllerRole eDominantHand) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_State.DominantHand = eDominantHand;
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetBoneCount(vr::VRActionHandle_t action, uint32_t* pBoneCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            *pBoneCount = 0;
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetBoneHierarchy(vr::VRActionHandle_t action, vr::BoneIndex_t* pParentIndices, uint32_t unIndexArayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetBoneName(vr::VRActionHandle_t action, vr::BoneIndex_t nBoneIndex, char* pchBoneName, uint32_t unNameBufferSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetSkeletalReferenceTransforms(vr::VRActionHandle_t action, vr::EVRSkeletalTransformSpace eTransformSpace, vr::EVRSkeletalReferencePose eReferencePose,
+                                                         vr::VRBoneTransform_t* pTransformArray, uint32_t unTransformArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetSkeletalTrackingLevel(vr::VRActionHandle_t action, vr::EVRSkeletalTrackingLevel* pSkeletalTrackingLevel) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetSkeletalBoneData(vr::VRActionHandle_t action, vr::EVRSkeletalTransformSpace eTransformSpace, vr::EVRSkeletalMotionRange eMotionRange,
+                                              vr::VRBoneTransform_t* pTransformArray, uint32_t unTransformArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetSkeletalSummaryData(vr::VRActionHandle_t action, vr::EVRSummaryType eSummaryType, vr::VRSkeletalSummaryData_t* pSkeletalSummaryData) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError GetSkeletalBoneDataCompressed(vr::VRActionHandle_t action, vr::EVRSkeletalMotionRange eMotionRange, void* pvCompressedData, uint32_t unCompressedSize,
+                                                        uint32_t* punRequiredCompressedSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        vr::EVRInputError DecompressSkeletalBoneData(const void* pvCompressedBuffer, uint32_t unCompressedBufferSize, vr::EVRSkeletalTransformSpace eTransformSpace,
+                                                     vr::VRBoneTransform_t* pTransformArray, uint32_t unTransformArrayCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_InvalidCompressedData;
+        }
+
+        vr::EVRInputError TriggerHapticVibrationAction(vr::VRActionHandle_t action, float fStartSecondsFromNow, float fDurationSeconds, float fFrequency, float fAmplitude,
+                                                       vr::VRInputValueHandle_t ulRestrictToDevice) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_State.HapticPulseCount++;
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetActionOrigins(vr::VRActionSetHandle_t actionSetHandle, vr::VRActionHandle_t digitalActionHandle, vr::VRInputValueHandle_t* originsOut,
+                                           uint32_t originOutCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            std::fill(originsOut, originsOut + originOutCount, vr::k_ulInvalidInputValueHandle);
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetOriginLocalizedName(vr::VRInputValueHandle_t origin, char* pchNameArray, uint32_t unNameArraySize, int32_t unStringSectionsToInclude) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+
+            if ( (pchNameArray != nullptr) && (unNameArraySize != 0) )
+                pchNameArray[0] = '\0';
+
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetOriginTrackedDeviceInfo(vr::VRInputValueHandle_t origin, vr::InputOriginInfo_t* pOriginInfo, uint32_t unOriginInfoSize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+
+            if (unOriginInfoSize != sizeof(vr::InputOriginInfo_t))
+                return vr::VRInputError_InvalidParam;
+
+            *pOriginInfo = {};
+            pOriginInfo->devicePath         = vr::k_ulInvalidInputValueHandle;
+            pOriginInfo->trackedDeviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetActionBindingInfo(vr::VRActionHandle_t action, vr::InputBindingInfo_t* pOriginInfo, uint32_t unBindingInfoSize, uint32_t unBindingInfoCount,
+                                               uint32_t* punReturnedBindingInfoCount) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            *punReturnedBindingInfoCount = 0;
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError ShowActionOrigins(vr::VRActionSetHandle_t actionSetHandle, vr::VRActionHandle_t ulActionHandle) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError ShowBindingsForActionSet(vr::VRActiveActionSet_t* pSets, uint32_t unSizeOfVRSelectedActionSet_t, uint32_t unSetCount, vr::VRInputValueHandle_t originToHighlight) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetComponentStateForBinding(const char* pchRenderModelName, const char* pchComponentName, const vr::InputBindingInfo_t* pOriginInfo, uint32_t unBindingInfoSize,
+                                                      uint32_t unBindingInfoCount, vr::RenderModel_ComponentState_t* pComponentState) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_NoData;
+        }
+
+        bool IsUsingLegacyInput() override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return false;
+        }
+
+        vr::EVRInputError OpenBindingUI(const char* pchAppKey, vr::VRActionSetHandle_t ulActionSetHandle, vr::VRInputValueHandle_t ulDeviceHandle, bool bShowOnDesktop) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+            return vr::VRInputError_None;
+        }
+
+        vr::EVRInputError GetBindingVariant(vr::VRInputValueHandle_t ulDevicePath, char* pchVariantArray, uint32_t unVariantArraySize) override
+        {
+            HEADLESSVR_COUNT_CALL("IVRInput");
+
+            if ( (pchVariantArray != nullptr) && (unVariantArraySize != 0) )
+                pchVariantArray[0] = '\0';
+
+            return vr::VRInputError_None;
+        }
+};
+
+static HeadlessVRSystem     g_InterfaceSystem;
+static HeadlessVROverlay    g_InterfaceOverlay;
+static HeadlessVRCompositor g_InterfaceCompositor;
+static HeadlessVRInput      g_InterfaceInput;
+
+
+//- openvr_api entry points
+namespace vr
+{
+    uint32_t VR_CALLTYPE VR_InitInternal2(EVRInitError* peError, EVRApplicationType eApplicationType, const char* pStartupInfo)
+    {
+        g_IsInitialized = true;
+
+        if (peError != nullptr)
+        {
+            *peError = VRInitError_None;
+        }
+
+        //New token on every init so interface pointers cached by COpenVRContext are fetched again
+        return ++g_InitToken;
+    }
+
+    void VR_CALLTYPE VR_ShutdownInternal()
+    {
+        g_IsInitialized = false;
+    }
+
+    bool VR_CALLTYPE VR_IsHmdPresent()
+    {
+        return true;
+    }
+
+    bool VR_CALLTYPE VR_IsRuntimeInstalled()
+    {
+        return true;
+    }
+
+    bool VR_GetRuntimePath(char* pchPathBuffer, uint32_t unBufferSize, uint32_t* punRequiredBufferSize)
+    {
+        bool buffer_too_small;
+        const uint32_t length = CopyString("", pchPathBuffer, unBufferSize, buffer_too_small);
+
+        if (punRequiredBufferSize != nullptr)
+        {
+            *punRequiredBufferSize = length;
+        }
+
+        return !buffer_too_small;
+    }
+
+    const char* VR_CALLTYPE VR_GetVRInitErrorAsSymbol(EVRInitError error)
+    {
+        switch (error)
+        {
+            case VRInitError_None:                      return "VRInitError_None";
+            case VRInitError_Init_InterfaceNotFound:    return "VRInitError_Init_InterfaceNotFound";
+            case VRInitError_Init_NotInitialized:       return "VRInitError_Init_NotInitialized";
+            default:                                    return "VRInitError_Unknown";
+        }
+    }
+
+    const char* VR_CALLTYPE VR_GetVRInitErrorAsEnglishDescription(EVRInitError error)
+    {
+        switch (error)
+        {
+            case VRInitError_None:                      return "No Error (0)";
+            case VRInitError_Init_InterfaceNotFound:    return "Interface not provided by the headless runtime (105)";
+            case VRInitError_Init_NotInitialized:       return "Headless runtime not initialized (109)";
+            default:                                    return "Unknown error";
+        }
+    }
+
+    void* VR_CALLTYPE VR_GetGenericInterface(const char* pchInterfaceVersion, EVRInitError* peError)
+    {
+        void* vr_interface = nullptr;
+        EVRInitError error = VRInitError_None;
+
+        if (!g_IsInitialized)
+        {
+            error = VRInitError_Init_NotInitialized;
+        }
+        else if (strcmp(pchInterfaceVersion, IVRSystem_Version) == 0)
+        {
+            vr_interface = static_cast<IVRSystem*>(&g_InterfaceSystem);
+        }
+        else if (strcmp(pchInterfaceVersion, IVROverlay_Version) == 0)
+        {
+            vr_interface = static_cast<IVROverlay*>(&g_InterfaceOverlay);
+        }
+        else if (strcmp(pchInterfaceVersion, IVRCompositor_Version) == 0)
+        {
+            vr_interface = static_cast<IVRCompositor*>(&g_InterfaceCompositor);
+        }
+        else if (strcmp(pchInterfaceVersion, IVRInput_Version) == 0)
+        {
+            vr_interface = static_cast<IVRInput*>(&g_InterfaceInput);
+        }
+        else
+        {
+            error = VRInitError_Init_InterfaceNotFound;
+        }
+
+        if (peError != nullptr)
+        {
+            *peError = error;
+        }
+
+        return vr_interface;
+    }
+
+    bool VR_CALLTYPE VR_IsInterfaceVersionValid(const char* pchInterfaceVersion)
+    {
+        return ( (strcmp(pchInterfaceVersion, IVRSystem_Version) == 0) || (strcmp(pchInterfaceVersion, IVROverlay_Version) == 0) ||
+                 (strcmp(pchInterfaceVersion, IVRCompositor_Version) == 0) || (strcmp(pchInterfaceVersion, IVRInput_Version) == 0) );
+    }
+
+    uint32_t VR_CALLTYPE VR_GetInitToken()
+    {
+        return g_InitToken;
+    }
+}
+
+
+//- Scripting and inspection
+namespace HeadlessVR
+{
+    void Reset()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_State = RuntimeState();
+        }
+
+        ResetCallCounts();
+    }
+
+    void SetDevice(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceClass device_class, vr::ETrackedControllerRole role)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        if (!IsDeviceIndexValid(device_index))
+            return;
+
+        DeviceState& device = g_State.Devices[device_index];
+        device.Class = device_class;
+        device.Role  = role;
+        device.Pose.bDeviceIsConnected = (device_class != vr::TrackedDeviceClass_Invalid);
+
+        //Newly connected devices start out with an identity pose
+        if ( (device.Pose.bDeviceIsConnected) && (!device.Pose.bPoseIsValid) )
+        {
+            device.Pose.mDeviceToAbsoluteTracking = MatrixIdentity();
+            device.Pose.eTrackingResult = vr::TrackingResult_Running_OK;
+            device.Pose.bPoseIsValid    = true;
+        }
+    }
+
+    void RemoveDevice(vr::TrackedDeviceIndex_t device_index)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        if (IsDeviceIndexValid(device_index))
+        {
+            g_State.Devices[device_index] = DeviceState();
+        }
+    }
+
+    void SetDevicePose(vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& pose, bool is_valid)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        if (!IsDeviceIndexValid(device_index))
+            return;
+
+        vr::TrackedDevicePose_t& device_pose = g_State.Devices[device_index].Pose;
+        device_pose.mDeviceToAbsoluteTracking = pose;
+        device_pose.bPoseIsValid    = is_valid;
+        device_pose.eTrackingResult = (is_valid) ? vr::TrackingResult_Running_OK : vr::TrackingResult_Running_OutOfRange;
+    }
+
+    void SetDeviceActivityLevel(vr::TrackedDeviceIndex_t device_index, vr::EDeviceActivityLevel activity_level)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        if (IsDeviceIndexValid(device_index))
+        {
+            g_State.Devices[device_index].ActivityLevel = activity_level;
+        }
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, bool value)
+    {
+        PropertyValue property_value;
+        property_value.Type      = vr::k_unBoolPropertyTag;
+        property_value.ValueBool = value;
+        SetDevicePropertyValue(device_index, prop, property_value);
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, float value)
+    {
+        PropertyValue property_value;
+        property_value.Type       = vr::k_unFloatPropertyTag;
+        property_value.ValueFloat = value;
+        SetDevicePropertyValue(device_index, prop, property_value);
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, int32_t value)
+    {
+        PropertyValue property_value;
+        property_value.Type       = vr::k_unInt32PropertyTag;
+        property_value.ValueInt32 = value;
+        SetDevicePropertyValue(device_index, prop, property_value);
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, uint64_t value)
+    {
+        PropertyValue property_value;
+        property_value.Type        = vr::k_unUint64PropertyTag;
+        property_value.ValueUint64 = value;
+        SetDevicePropertyValue(device_index, prop, property_value);
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, const std::string& value)
+    {
+        PropertyValue property_value;
+        property_value.Type        = vr::k_unStringPropertyTag;
+        property_value.ValueString = value;
+        SetDevicePropertyValue(device_index, prop, property_value);
+    }
+
+    void SetSeatedZeroPose(const vr::HmdMatrix34_t& pose)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.SeatedZeroPose = pose;
+    }
+
+    void QueueSystemEvent(const vr::VREvent_t& vr_event)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.SystemEvents.push_back(vr_event);
+    }
+
+    void QueueOverlayEvent(vr::VROverlayHandle_t overlay_handle, const vr::VREvent_t& vr_event)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.OverlayEvents.emplace_back(overlay_handle, vr_event);
+    }
+
+    size_t GetPendingEventCount()
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        return g_State.SystemEvents.size() + g_State.OverlayEvents.size();
+    }
+
+    void SetDashboardVisible(bool is_visible, vr::VROverlayHandle_t active_dashboard_overlay)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.IsDashboardVisible     = is_visible;
+        g_State.ActiveDashboardOverlay = active_dashboard_overlay;
+    }
+
+    void SetPrimaryDashboardDevice(vr::TrackedDeviceIndex_t device_index)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.PrimaryDashboardDevice = device_index;
+    }
+
+    void SetHoverTargetOverlay(vr::VROverlayHandle_t overlay_handle)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.HoverTargetOverlay = overlay_handle;
+    }
+
+    void SetSceneFocusProcess(uint32_t process_id)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.SceneFocusProcess = process_id;
+    }
+
+    void SetFrameTiming(const vr::Compositor_FrameTiming& frame_timing)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.FrameTiming = frame_timing;
+    }
+
+    void SetKeyboardText(const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_State.Keyboard.Text = text;
+    }
+
+    void SetDigitalActionState(const char* action_name, bool state)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        ActionState& action = g_State.Actions[GetInputHandle(action_name)];
+        action.IsAnalog     = false;
+        action.PendingState = state;
+    }
+
+    void SetAnalogActionState(const char* action_name, float x, float y, float z)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        ActionState& action = g_State.Actions[GetInputHandle(action_name)];
+        action.IsAnalog = true;
+        action.PendingX = x;
+        action.PendingY = y;
+        action.PendingZ = z;
+    }
+
+    bool GetOverlayState(vr::VROverlayHandle_t overlay_handle, OverlayState& state_out)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        const OverlayState* overlay = FindOverlayState(overlay_handle);
+
+        if (overlay == nullptr)
+            return false;
+
+        state_out = *overlay;
+        return true;
+    }
+
+    std::vector<vr::VROverlayHandle_t> GetOverlayHandles()
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+
+        std::vector<vr::VROverlayHandle_t> handles;
+        for (const OverlayState& overlay : g_State.Overlays)
+        {
+            handles.push_back(overlay.Handle);
+        }
+
+        return handles;
+    }
+
+    KeyboardState GetKeyboardState()
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        return g_State.Keyboard;
+    }
+
+    std::string GetActionManifestPath()
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        return g_State.ActionManifestPath;
+    }
+
+    uint64_t GetHapticPulseCount()
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        return g_State.HapticPulseCount;
+    }
+
+    uint64_t GetCallCount(const char* function_name)
+    {
+        std::lock_guard<std::mutex> lock(g_CallCountersMutex);
+
+        for (const CallCounter& counter : g_CallCounters)
+        {
+            if (counter.Function == function_name)
+                return counter.Count.load(std::memory_order_relaxed);
+        }
+
+        return 0;
+    }
+
+    uint64_t GetTotalCallCount()
+    {
+        std::lock_guard<std::mutex> lock(g_CallCountersMutex);
+
+        uint64_t total = 0;
+        for (const CallCounter& counter : g_CallCounters)
+        {
+            total += counter.Count.load(std::memory_order_relaxed);
+        }
+
+        return total;
+    }
+
+    std::vector<CallCount> GetCallCounts()
+    {
+        std::vector<CallCount> counts;
+
+        {
+            std::lock_guard<std::mutex> lock(g_CallCountersMutex);
+
+            for (const CallCounter& counter : g_CallCounters)
+            {
+                const uint64_t count = counter.Count.load(std::memory_order_relaxed);
+
+                if (count != 0)
+                {
+                    counts.push_back({counter.Function, count});
+                }
+            }
+        }
+
+        std::sort(counts.begin(), counts.end(), [](const CallCount& a, const CallCount& b){ return (a.Function < b.Function); });
+
+        return counts;
+    }
+
+    void ResetCallCounts()
+    {
+        std::lock_guard<std::mutex> lock(g_CallCountersMutex);
+
+        for (CallCounter& counter : g_CallCounters)
+        {
+            counter.Count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "openvr.h"
+
+//Headless stand-in for the OpenVR runtime, to run code calling into vr::VROverlay() and friends without SteamVR, on any platform
+//HeadlessVR.cpp implements the VR_* entry points of openvr_api, so it's built in place of openvr_api (linking it directly or as libopenvr_api) and calling code stays unchanged
+//On Windows this requires OPENVR_BUILD_STATIC to be defined for everything including openvr.h, as the stand-in isn't a DLL
+//The portable tests build it as the HeadlessVR library (see Tests/CMakeLists.txt), TestHeadlessVR covers the stand-in itself
+//
+//Only IVRSystem, IVROverlay, IVRCompositor and IVRInput are provided, VR_GetGenericInterface() reports all other interfaces as not found
+//Overlay state is kept in memory, device poses, input and events are scripted with the functions below and every interface call is counted
+//Functions the project doesn't use are implemented as well, but don't do anything beyond returning an error or default values
+//All functions are thread-safe
+
+namespace HeadlessVR
+{
+    //Transform type reported for overlays set with SetOverlayTransformOverlayRelative(), which has no value in VROverlayTransformType of this SDK version
+    const vr::VROverlayTransformType OverlayTransform_OverlayRelative = (vr::VROverlayTransformType)(vr::VROverlayTransform_Projection + 1);
+
+    struct OverlayState
+    {
+        vr::VROverlayHandle_t Handle = vr::k_ulOverlayHandleInvalid;
+        std::string Key;
+        std::string Name;
+        bool IsDashboardOverlay   = false;
+        bool IsDashboardThumbnail = false;
+        bool IsVisible            = false;
+        uint32_t Flags            = 0;              //Bit mask of VROverlayFlags values
+        float ColorR              = 1.0f;
+        float ColorG              = 1.0f;
+        float ColorB              = 1.0f;
+        float Alpha               = 1.0f;
+        float TexelAspect         = 1.0f;
+        float WidthInMeters       = 1.0f;
+        float Curvature           = 0.0f;
+        float PreCurvePitch       = 0.0f;
+        uint32_t SortOrder        = 0;
+        uint32_t RenderingPid     = 0;
+        uint32_t SceneProcessID   = 0;
+        vr::VRTextureBounds_t TextureBounds     = {0.0f, 0.0f, 1.0f, 1.0f};
+        vr::EColorSpace TextureColorSpace       = vr::ColorSpace_Auto;
+        vr::VROverlayTransformType TransformType        = vr::VROverlayTransform_Absolute;
+        vr::ETrackingUniverseOrigin TransformOrigin     = vr::TrackingUniverseStanding;
+        vr::TrackedDeviceIndex_t TransformDeviceIndex   = vr::k_unTrackedDeviceIndexInvalid;
+        vr::HmdMatrix34_t Transform             = {{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}}};
+        vr::VROverlayHandle_t TransformParentOverlay    = vr::k_ulOverlayHandleInvalid;
+        vr::HmdVector2_t CursorHotspot          = {0.0f, 0.0f};
+        vr::VROverlayInputMethod InputMethod    = vr::VROverlayInputMethod_None;
+        vr::HmdVector2_t MouseScale             = {1.0f, 1.0f};
+        uint32_t IntersectionMaskPrimitiveCount = 0;
+        //Texture
+        vr::ETextureType TextureType            = vr::TextureType_Invalid;
+        void* TextureHandle                     = nullptr;          //Handle passed to SetOverlayTexture(), never accessed
+        std::string TextureFilePath;                                //Path passed to SetOverlayFromFile()
+        std::vector<uint8_t> RawData;                               //Copy of the data passed to SetOverlayRaw()
+        uint32_t RawWidth         = 0;
+        uint32_t RawHeight        = 0;
+        uint32_t RawBytesPerPixel = 0;
+        uint64_t TextureSetCount  = 0;                              //Calls to any of the functions setting the overlay texture
+    };
+
+    struct KeyboardState
+    {
+        bool IsVisible = false;
+        vr::VROverlayHandle_t Overlay = vr::k_ulOverlayHandleInvalid;   //Invalid if not shown for an overlay
+        std::string Text;
+        uint64_t UserValue = 0;
+    };
+
+    struct CallCount
+    {
+        std::string Function;               //"Interface::Function", e.g. "IVROverlay::SetOverlayTexture"
+        uint64_t Count;
+    };
+
+    //Destroys all overlays and clears all scripted state and call counts. Handles are not reused after a reset
+    void Reset();
+
+    //- Scripting
+    //Devices. The HMD is always connected at k_unTrackedDeviceIndex_Hmd with an identity pose unless changed
+    void SetDevice(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceClass device_class, vr::ETrackedControllerRole role = vr::TrackedControllerRole_Invalid);
+    void RemoveDevice(vr::TrackedDeviceIndex_t device_index);
+    void SetDevicePose(vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& pose, bool is_valid = true);
+    void SetDeviceActivityLevel(vr::TrackedDeviceIndex_t device_index, vr::EDeviceActivityLevel activity_level);
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, bool value);
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, float value);
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, int32_t value);
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, uint64_t value);
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t device_index, vr::ETrackedDeviceProperty prop, const std::string& value);
+    void SetSeatedZeroPose(const vr::HmdMatrix34_t& pose);          //Returned by GetSeatedZeroPoseToStandingAbsoluteTrackingPose()
+
+    //Events. Overlay events are returned by PollNextOverlayEvent() for the given overlay, system events by PollNextEvent(). Both in the order they were queued
+    void QueueSystemEvent(const vr::VREvent_t& vr_event);
+    void QueueOverlayEvent(vr::VROverlayHandle_t overlay_handle, const vr::VREvent_t& vr_event);
+    size_t GetPendingEventCount();
+
+    //Dashboard and scene state
+    void SetDashboardVisible(bool is_visible, vr::VROverlayHandle_t active_dashboard_overlay = vr::k_ulOverlayHandleInvalid);
+    void SetPrimaryDashboardDevice(vr::TrackedDeviceIndex_t device_index);
+    void SetHoverTargetOverlay(vr::VROverlayHandle_t overlay_handle);
+    void SetSceneFocusProcess(uint32_t process_id);
+    void SetFrameTiming(const vr::Compositor_FrameTiming& frame_timing);
+    void SetKeyboardText(const std::string& text);
+
+    //Input. Action states take effect on the next IVRInput::UpdateActionState() call, like they would with the real runtime
+    void SetDigitalActionState(const char* action_name, bool state);
+    void SetAnalogActionState(const char* action_name, float x, float y, float z = 0.0f);
+
+    //- Inspection
+    bool GetOverlayState(vr::VROverlayHandle_t overlay_handle, OverlayState& state_out);
+    std::vector<vr::VROverlayHandle_t> GetOverlayHandles();         //In order of creation
+    KeyboardState GetKeyboardState();
+    std::string GetActionManifestPath();
+    uint64_t GetHapticPulseCount();                                 //Laser mouse haptics, legacy pulses and haptic actions combined
+
+    //Call counts. Functions that were never called are not listed
+    uint64_t GetCallCount(const char* function_name);               //"Interface::Function", e.g. "IVROverlay::SetOverlayTexture"
+    uint64_t GetTotalCallCount();
+    std::vector<CallCount> GetCallCounts();                         //Sorted by name
+    void ResetCallCounts();
+}
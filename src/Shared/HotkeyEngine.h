@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//Matches keystrokes against hotkey bindings, which can be single chords (modifiers + key) or sequences of them (e.g. Ctrl+K, Ctrl+O)
+//Bindings are kept in a prefix tree, so dispatching a keystroke only looks at the children of the current sequence position
+//Where a binding's sequence is the start of another one, it's triggered once the sequence times out or continues with a key that doesn't match
+//Bindings can be scoped to an overlay or overlay group and are only matched while the scope is active. If several active bindings match, only the most specific scope's are triggered
+//The engine doesn't read any input itself (see OutputManager::HandleHotkeys()). Kept free of Windows headers so it can be tested anywhere
+
+enum HotkeyModifier                     //Same values as the MOD_* flags of RegisterHotKey()
+{
+    hotkey_mod_alt     = 0x1,
+    hotkey_mod_control = 0x2,
+    hotkey_mod_shift   = 0x4,
+    hotkey_mod_win     = 0x8,
+    hotkey_mod_mask    = 0xF
+};
+
+enum HotkeyScope                        //In order of precedence
+{
+    hotkey_scope_global,
+    hotkey_scope_overlay_group,         //ScopeID is the group ID
+    hotkey_scope_overlay,               //ScopeID is the overlay ID
+    hotkey_scope_MAX
+};
+
+enum HotkeyConflictType
+{
+    hotkey_conflict_duplicate,          //Same sequence and scope, both get triggered
+    hotkey_conflict_shadowed,           //Same sequence in different scopes, the more specific one wins while both are active
+    hotkey_conflict_prefix              //Sequence of the first binding starts the second one's, so it's delayed until the sequence times out
+};
+
+struct HotkeyStroke
+{
+    uint8_t KeyCode   = 0;
+    uint8_t Modifiers = 0;
+
+    uint16_t GetKey() const { return (uint16_t)((Modifiers << 8) | KeyCode); }
+
+    bool operator==(const HotkeyStroke& other) const { return (GetKey() == other.GetKey()); }
+    bool operator!=(const HotkeyStroke& other) const { return (GetKey() != other.GetKey()); }
+};
+
+struct HotkeyBinding
+{
+    std::vector<HotkeyStroke> Strokes;
+    int ActionID = 0;
+    HotkeyScope Scope = hotkey_scope_global;
+    int ScopeID = -1;
+};
+
+struct HotkeyConflict
+{
+    HotkeyConflictType Type;
+    size_t BindingA;                    //Indices into the bindings passed to SetBindings()
+    size_t BindingB;
+};
+
+class HotkeyEngine
+{
+    public:
+        static const uint32_t DefaultSequenceTimeout = 1000;   //ms
+
+    private:
+        struct Node
+        {
+            uint16_t StrokeKey;
+            uint32_t ChildrenBegin;         //Children are stored next to each other, sorted by StrokeKey
+            uint32_t ChildrenEnd;
+            uint32_t BindingsBegin;         //Range in m_NodeBindings of bindings ending at this node
+            uint32_t BindingsEnd;
+            bool HasActiveBindings;
+            bool HasActiveChildren;
+        };
+
+        std::vector<HotkeyBinding> m_Bindings;
+        std::vector<bool> m_BindingActive;
+        std::vector<Node> m_Nodes;          //m_Nodes[0] is the root
+        std::vector<uint32_t> m_NodeBindings;
+        bool m_HasScopedBindings;
+
+        uint32_t m_CurrentNode;
+        uint64_t m_LastStrokeTime;
+        uint32_t m_SequenceTimeout;
+        uint32_t m_StateID;
+
+        //Builds the node for the strokes at depth of the sorted bindings in [begin, end), which all share the strokes before depth
+        void BuildNode(uint32_t node_id, const std::vector<uint32_t>& sorted, size_t begin, size_t end, size_t depth)
+        {
+            //Bindings ending here come first in sorted order
+            size_t child_begin = begin;
+            while ( (child_begin < end) && (m_Bindings[sorted[child_begin]].Strokes.size() == depth) )
+            {
+                ++child_begin;
+            }
+
+            m_Nodes[node_id].BindingsBegin = (uint32_t)m_NodeBindings.size();
+            m_NodeBindings.insert(m_NodeBindings.end(), sorted.begin() + begin, sorted.begin() + child_begin);
+            m_Nodes[node_id].BindingsEnd   = (uint32_t)m_NodeBindings.size();
+
+            //Group the rest by their stroke at this depth, allocating the children next to each other first
+            std::vector<std::pair<size_t, size_t>> child_ranges;
+            for (size_t i = child_begin; i < end;)
+            {
+                const uint16_t key = m_Bindings[sorted[i]].Strokes[depth].GetKey();
+                size_t j = i + 1;
+                while ( (j < end) && (m_Bindings[sorted[j]].Strokes[depth].GetKey() == key) )
+                {
+                    ++j;
+                }
+
+                child_ranges.push_back({i, j});
+                i = j;
+            }
+
+            const uint32_t first_child = (uint32_t)m_Nodes.size();
+            m_Nodes[node_id].ChildrenBegin = first_child;
+            m_Nodes[node_id].ChildrenEnd   = first_child + (uint32_t)child_ranges.size();
+
+            for (const auto& range : child_ranges)
+            {
+                m_Nodes.push_back({m_Bindings[sorted[range.first]].Strokes[depth].GetKey(), 0, 0, 0, 0, false, false});
+            }
+
+            for (size_t i = 0; i < child_ranges.size(); ++i)
+            {
+                BuildNode(first_child + (uint32_t)i, sorted, child_ranges[i].first, child_ranges[i].second, depth + 1);
+            }
+        }
+
+        //Updates the active flags of the node's subtree, returns true if anything in it is active
+        bool UpdateNodeActiveState(uint32_t node_id)
+        {
+            bool has_active_bindings = false;
+            for (uint32_t i = m_Nodes[node_id].BindingsBegin; i < m_Nodes[node_id].BindingsEnd; ++i)
+            {
+                has_active_bindings |= m_BindingActive[m_NodeBindings[i]];
+            }
+
+            bool has_active_children = false;
+            for (uint32_t i = m_Nodes[node_id].ChildrenBegin; i < m_Nodes[node_id].ChildrenEnd; ++i)
+            {
+                has_active_children |= UpdateNodeActiveState(i);
+            }
+
+            Node& node = m_Nodes[node_id];
+            if ( (node.HasActiveBindings != has_active_bindings) || (node.HasActiveChildren != has_active_children) )
+            {
+                node.HasActiveBindings = has_active_bindings;
+                node.HasActiveChildren = has_active_children;
+                ++m_StateID;
+            }
+
+            return (has_active_bindings || has_active_children);
+        }
+
+        const Node* FindActiveChild(const Node& node, uint16_t stroke_key) const
+        {
+            auto it = std::lower_bound(m_Nodes.begin() + node.ChildrenBegin, m_Nodes.begin() + node.ChildrenEnd, stroke_key,
+                                       [](const Node& n, uint16_t key){ return (n.StrokeKey < key); });
+
+            if ( (it != m_Nodes.begin() + node.ChildrenEnd) && (it->StrokeKey == stroke_key) && ((it->HasActiveBindings) || (it->HasActiveChildren)) )
+            {
+                return &*it;
+            }
+
+            return nullptr;
+        }
+
+        //Adds the active bindings of the node with the most specific scope to triggered_out
+        void TriggerNode(const Node& node, std::vector<size_t>& triggered_out) const
+        {
+            int scope_max = -1;
+            for (uint32_t i = node.BindingsBegin; i < node.BindingsEnd; ++i)
+            {
+                if (m_BindingActive[m_NodeBindings[i]])
+                {
+                    scope_max = std::max(scope_max, (int)m_Bindings[m_NodeBindings[i]].Scope);
+                }
+            }
+
+            for (uint32_t i = node.BindingsBegin; i < node.BindingsEnd; ++i)
+            {
+                const uint32_t binding_id = m_NodeBindings[i];
+                if ( (m_BindingActive[binding_id]) && ((int)m_Bindings[binding_id].Scope == scope_max) )
+                {
+                    triggered_out.push_back(binding_id);
+                }
+            }
+        }
+
+        void ResetSequence()
+        {
+            if (m_CurrentNode != 0)
+            {
+                m_CurrentNode = 0;
+                ++m_StateID;
+            }
+        }
+
+    public:
+        HotkeyEngine() : m_HasScopedBindings(false), m_CurrentNode(0), m_LastStrokeTime(0), m_SequenceTimeout(DefaultSequenceTimeout), m_StateID(0)
+        {
+            SetBindings({});
+        }
+
+        //Replaces all bindings and resets the sequence state. Bindings without strokes or with a stroke without key code are ignored
+        //All bindings are active until UpdateActiveState() is called
+        void SetBindings(const std::vector<HotkeyBinding>& bindings)
+        {
+            m_Bindings = bindings;
+            m_BindingActive.assign(m_Bindings.size(), true);
+            m_Nodes.clear();
+            m_NodeBindings.clear();
+            m_HasScopedBindings = false;
+
+            std::vector<uint32_t> sorted;
+            for (uint32_t i = 0; i < (uint32_t)m_Bindings.size(); ++i)
+            {
+                const auto& strokes = m_Bindings[i].Strokes;
+                if ( (!strokes.empty()) && (std::none_of(strokes.begin(), strokes.end(), [](const HotkeyStroke& stroke){ return (stroke.KeyCode == 0); })) )
+                {
+                    sorted.push_back(i);
+                    m_HasScopedBindings |= (m_Bindings[i].Scope != hotkey_scope_global);
+                }
+            }
+
+            //Lexicographical order puts bindings sharing a prefix next to each other, shorter ones first. Stable to keep the binding order for bindings on the same node
+            std::stable_sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b)
+                             {
+                                 const auto& strokes_a = m_Bindings[a].Strokes;
+                                 const auto& strokes_b = m_Bindings[b].Strokes;
+                                 return std::lexicographical_compare(strokes_a.begin(), strokes_a.end(), strokes_b.begin(), strokes_b.end(),
+                                                                     [](const HotkeyStroke& sa, const HotkeyStroke& sb){ return (sa.GetKey() < sb.GetKey()); });
+                             });
+
+            m_Nodes.push_back({0, 0, 0, 0, 0, false, false});
+            BuildNode(0, sorted, 0, sorted.size(), 0);
+            UpdateNodeActiveState(0);
+
+            m_CurrentNode = 0;
+            ++m_StateID;
+        }
+
+        const std::vector<HotkeyBinding>& GetBindings() const { return m_Bindings; }
+
+        void SetSequenceTimeout(uint32_t timeout_ms) { m_SequenceTimeout = timeout_ms; }
+
+        //Sets which bindings are active by calling is_scope_active(scope, scope_id) for every scoped binding
+        //Cheap enough to be called every frame. Does nothing if there are no scoped bindings
+        template<typename F> void UpdateActiveState(F is_scope_active)
+        {
+            if (!m_HasScopedBindings)
+                return;
+
+            for (size_t i = 0; i < m_Bindings.size(); ++i)
+            {
+                m_BindingActive[i] = ( (m_Bindings[i].Scope == hotkey_scope_global) || (is_scope_active(m_Bindings[i].Scope, m_Bindings[i].ScopeID)) );
+            }
+
+            UpdateNodeActiveState(0);
+
+            //Drop a pending sequence that can't be completed anymore
+            if ( (m_CurrentNode != 0) && (!m_Nodes[m_CurrentNode].HasActiveBindings) && (!m_Nodes[m_CurrentNode].HasActiveChildren) )
+            {
+                ResetSequence();
+            }
+        }
+
+        //Processes a key press and adds the indices of bindings to trigger to triggered_out. Returns false if the stroke isn't used by any active binding
+        bool OnStroke(HotkeyStroke stroke, uint64_t time_ms, std::vector<size_t>& triggered_out)
+        {
+            Update(time_ms, triggered_out);
+
+            const uint16_t stroke_key = stroke.GetKey();
+            const Node* child = FindActiveChild(m_Nodes[m_CurrentNode], stroke_key);
+
+            if ( (child == nullptr) && (m_CurrentNode != 0) )
+            {
+                //Sequence broken, trigger what's complete so far and see if this starts a new one
+                TriggerNode(m_Nodes[m_CurrentNode], triggered_out);
+                ResetSequence();
+
+                child = FindActiveChild(m_Nodes[0], stroke_key);
+            }
+
+            if (child == nullptr)
+                return false;
+
+            if (child->HasActiveChildren)
+            {
+                //Wait for the next stroke
+                m_CurrentNode = (uint32_t)(child - m_Nodes.data());
+                m_LastStrokeTime = time_ms;
+                ++m_StateID;
+            }
+            else
+            {
+                TriggerNode(*child, triggered_out);
+                ResetSequence();
+            }
+
+            return true;
+        }
+
+        //Ends a pending sequence if it timed out, adding the indices of bindings to trigger to triggered_out
+        void Update(uint64_t time_ms, std::vector<size_t>& triggered_out)
+        {
+            if ( (m_CurrentNode != 0) && (time_ms - m_LastStrokeTime >= m_SequenceTimeout) )
+            {
+                TriggerNode(m_Nodes[m_CurrentNode], triggered_out);
+                ResetSequence();
+            }
+        }
+
+        void CancelSequence() { ResetSequence(); }
+
+        bool IsSequencePending() const { return (m_CurrentNode != 0); }
+
+        //Strokes that would currently be handled by OnStroke(), e.g. to register them as system hotkeys
+        //While a sequence is pending, these are the strokes continuing it and the ones starting a new sequence
+        void GetExpectedStrokes(std::vector<HotkeyStroke>& strokes_out) const
+        {
+            strokes_out.clear();
+
+            const auto add_children = [&](const Node& node)
+            {
+                for (uint32_t i = node.ChildrenBegin; i < node.ChildrenEnd; ++i)
+                {
+                    if ( ((m_Nodes[i].HasActiveBindings) || (m_Nodes[i].HasActiveChildren)) &&
+                         (std::find_if(strokes_out.begin(), strokes_out.end(), [&](const HotkeyStroke& s){ return (s.GetKey() == m_Nodes[i].StrokeKey); }) == strokes_out.end()) )
+                    {
+                        HotkeyStroke stroke;
+                        stroke.KeyCode   = (uint8_t)(m_Nodes[i].StrokeKey & 0xFF);
+                        stroke.Modifiers = (uint8_t)(m_Nodes[i].StrokeKey >> 8);
+                        strokes_out.push_back(stroke);
+                    }
+                }
+            };
+
+            if (m_CurrentNode != 0)
+            {
+                add_children(m_Nodes[m_CurrentNode]);
+            }
+
+            add_children(m_Nodes[0]);
+        }
+
+        //Changes whenever the result of GetExpectedStrokes() may have changed
+        uint32_t GetStateID() const { return m_StateID; }
+
+        //Checks all bindings against each other, ignoring whether they're active
+        std::vector<HotkeyConflict> FindConflicts() const
+        {
+            std::vector<HotkeyConflict> conflicts;
+
+            for (const Node& node : m_Nodes)
+            {
+                for (uint32_t i = node.BindingsBegin; i < node.BindingsEnd; ++i)
+                {
+                    const HotkeyBinding& binding_a = m_Bindings[m_NodeBindings[i]];
+
+                    //Same sequence
+                    for (uint32_t j = i + 1; j < node.BindingsEnd; ++j)
+                    {
+                        const HotkeyBinding& binding_b = m_Bindings[m_NodeBindings[j]];
+                        const bool is_same_scope = ( (binding_a.Scope == binding_b.Scope) && ((binding_a.Scope == hotkey_scope_global) || (binding_a.ScopeID == binding_b.ScopeID)) );
+
+                        conflicts.push_back({(is_same_scope) ? hotkey_conflict_duplicate : hotkey_conflict_shadowed, m_NodeBindings[i], m_NodeBindings[j]});
+                    }
+
+                    //Longer sequences starting with this one, found by walking the subtree
+                    std::vector<uint32_t> stack;
+                    for (uint32_t c = node.ChildrenBegin; c < node.ChildrenEnd; ++c)
+                    {
+                        stack.push_back(c);
+                    }
+
+                    while (!stack.empty())
+                    {
+                        const Node& sub = m_Nodes[stack.back()];
+                        stack.pop_back();
+
+                        for (uint32_t j = sub.BindingsBegin; j < sub.BindingsEnd; ++j)
+                        {
+                            conflicts.push_back({hotkey_conflict_prefix, m_NodeBindings[i], m_NodeBindings[j]});
+                        }
+
+                        for (uint32_t c = sub.ChildrenBegin; c < sub.ChildrenEnd; ++c)
+                        {
+                            stack.push_back(c);
+                        }
+                    }
+                }
+            }
+
+            return conflicts;
+        }
+};
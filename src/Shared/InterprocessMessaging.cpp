@@ -157,3 +157,27 @@ void IPCManager::SendStringToElevatedModeProcess(IPCElevatedStringID elevated_st
         ::SendMessage(window, WM_COPYDATA, (WPARAM)source_window, (LPARAM)(LPVOID)&cds);
     }
 }
+
+void IPCManager::SendBinaryToDashboardApp(IPCBinaryDataID binary_id, const std::string& data, HWND source_window) const
+{
+    if (HWND window = ::FindWindow(g_WindowClassNameDashboardApp, nullptr))
+    {
+        COPYDATASTRUCT cds;
+        cds.dwData = binary_id;
+        cds.cbData = (DWORD)data.size();
+        cds.lpData = (void*)data.data();
+        ::SendMessage(window, WM_COPYDATA, (WPARAM)source_window, (LPARAM)(LPVOID)&cds);
+    }
+}
+
+void IPCManager::SendBinaryToUIApp(IPCBinaryDataID binary_id, const std::string& data, HWND source_window) const
+{
+    if (HWND window = ::FindWindow(g_WindowClassNameUIApp, nullptr))
+    {
+        COPYDATASTRUCT cds;
+        cds.dwData = binary_id;
+        cds.cbData = (DWORD)data.size();
+        cds.lpData = (void*)data.data();
+        ::SendMessage(window, WM_COPYDATA, (WPARAM)source_window, (LPARAM)(LPVOID)&cds);
+    }
+}
@@ -54,6 +54,7 @@ enum IPCActionID
     ipcact_winmanager_drag_start,   //Sent by dashboard application's WindowManager thread to main thread to start an overlay drag. lParam is ID of overlay to drag
     ipcact_sync_config_state,       //Sent by the UI application to request overlay and config state variables after a restart
     ipcact_focus_window,            //Sent by the UI application to focus a window. lParam is HWND
+    ipcact_performance_trace_dump,  //Sent by the UI application to write the recent performance trace events to performance_trace.json. No data in lParam
     ipcact_MAX
 };
 
@@ -99,6 +100,13 @@ enum IPCElevatedStringID
     ipcestrid_launch_application_arg
 };
 
+//COPYDATASTRUCT::dwData values for binary data. Kept out of the ConfigID_String range, which shares dwData for config strings
+enum IPCBinaryDataID
+{
+    ipcbin_custom_actions = 0x10000,   //Serialized custom action update, see ActionManager::ApplySerializedCustomActions()
+    ipcbin_overlay_config_batch,       //Serialized OverlayConfigBatch, sent to the UI app after committing it
+};
+
 class IPCManager
 {
 	private:
@@ -123,4 +131,6 @@ class IPCManager
         void SendStringToDashboardApp(ConfigID_String config_id, const std::string& str, HWND source_window) const;
         void SendStringToUIApp(ConfigID_String config_id, const std::string& str, HWND source_window) const;
         void SendStringToElevatedModeProcess(IPCElevatedStringID elevated_str_id, const std::string& str, HWND source_window) const;
+        void SendBinaryToDashboardApp(IPCBinaryDataID binary_id, const std::string& data, HWND source_window) const;
+        void SendBinaryToUIApp(IPCBinaryDataID binary_id, const std::string& data, HWND source_window) const;
 };
\ No newline at end of file
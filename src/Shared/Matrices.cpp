@@ -272,20 +272,8 @@ Matrix4& Matrix4::invertEuclidean()
 ///////////////////////////////////////////////////////////////////////////////
 Matrix4& Matrix4::invertAffine()
 {
-    // R^-1
-    Matrix3 r(m[0],m[1],m[2], m[4],m[5],m[6], m[8],m[9],m[10]);
-    r.invert();
-    m[0] = r[0];  m[1] = r[1];  m[2] = r[2];
-    m[4] = r[3];  m[5] = r[4];  m[6] = r[5];
-    m[8] = r[6];  m[9] = r[7];  m[10]= r[8];
-
-    // -R^-1 * T
-    float x = m[12];
-    float y = m[13];
-    float z = m[14];
-    m[12] = -(r[0] * x + r[3] * y + r[6] * z);
-    m[13] = -(r[1] * x + r[4] * y + r[7] * z);
-    m[14] = -(r[2] * x + r[5] * y + r[8] * z);
+    // R^-1 and -R^-1 * T, see matrix4InvertAffineScalar() in MatricesSIMD.h for the plain version
+    matrix4InvertAffine(m);
 
     // last row should be unchanged (0,0,0,1)
     //m[3] = m[7] = m[11] = 0.0f;
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <iomanip>
 #include "Vectors.h"
+#include "MatricesSIMD.h"
 #include "openvr.h"
 
 ///////////////////////////////////////////////////////////////////////////
@@ -198,6 +199,8 @@ public:
     Matrix4&    scale(float scale);                     // uniform scale
     Matrix4&    scale(float sx, float sy, float sz);    // scale by (sx, sy, sz) on each axis
 
+    void        transformPoints(const Vector3* points, Vector3* points_out, size_t count) const; // points_out[i] = M * (points[i], 1), in-place allowed
+
     // operators
     Matrix4     operator+(const Matrix4& rhs) const;    // add rhs
     Matrix4     operator-(const Matrix4& rhs) const;    // subtract rhs
@@ -848,29 +851,34 @@ inline Matrix4& Matrix4::operator-=(const Matrix4& rhs)
 
 inline Vector4 Matrix4::operator*(const Vector4& rhs) const
 {
-    return Vector4(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z  + m[12]*rhs.w,
-                   m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z  + m[13]*rhs.w,
-                   m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z + m[14]*rhs.w,
-                   m[3]*rhs.x + m[7]*rhs.y + m[11]*rhs.z + m[15]*rhs.w);
+    Vector4 v;
+    matrix4TransformVector4(m, &rhs.x, &v.x);   // see MatricesSIMD.h
+    return v;
 }
 
 
 
 inline Vector3 Matrix4::operator*(const Vector3& rhs) const
 {
-    return Vector3(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z,
-                   m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z,
-                   m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z);
+    Vector3 v;
+    matrix4TransformVector3(m, &rhs.x, &v.x);
+    return v;
 }
 
 
 
 inline Matrix4 Matrix4::operator*(const Matrix4& n) const
 {
-    return Matrix4(m[0]*n[0]  + m[4]*n[1]  + m[8]*n[2]  + m[12]*n[3],   m[1]*n[0]  + m[5]*n[1]  + m[9]*n[2]  + m[13]*n[3],   m[2]*n[0]  + m[6]*n[1]  + m[10]*n[2]  + m[14]*n[3],   m[3]*n[0]  + m[7]*n[1]  + m[11]*n[2]  + m[15]*n[3],
-                   m[0]*n[4]  + m[4]*n[5]  + m[8]*n[6]  + m[12]*n[7],   m[1]*n[4]  + m[5]*n[5]  + m[9]*n[6]  + m[13]*n[7],   m[2]*n[4]  + m[6]*n[5]  + m[10]*n[6]  + m[14]*n[7],   m[3]*n[4]  + m[7]*n[5]  + m[11]*n[6]  + m[15]*n[7],
-                   m[0]*n[8]  + m[4]*n[9]  + m[8]*n[10] + m[12]*n[11],  m[1]*n[8]  + m[5]*n[9]  + m[9]*n[10] + m[13]*n[11],  m[2]*n[8]  + m[6]*n[9]  + m[10]*n[10] + m[14]*n[11],  m[3]*n[8]  + m[7]*n[9]  + m[11]*n[10] + m[15]*n[11],
-                   m[0]*n[12] + m[4]*n[13] + m[8]*n[14] + m[12]*n[15],  m[1]*n[12] + m[5]*n[13] + m[9]*n[14] + m[13]*n[15],  m[2]*n[12] + m[6]*n[13] + m[10]*n[14] + m[14]*n[15],  m[3]*n[12] + m[7]*n[13] + m[11]*n[14] + m[15]*n[15]);
+    float r[16];
+    matrix4Multiply(m, n.m, r);
+    return Matrix4(r);
+}
+
+
+
+inline void Matrix4::transformPoints(const Vector3* points, Vector3* points_out, size_t count) const
+{
+    matrix4TransformPoints(m, &points->x, &points_out->x, count);
 }
 
 
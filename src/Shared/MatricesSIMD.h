@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// MatricesSIMD.h
+// ==============
+// SSE2 implementations of the Matrix4 operations used per frame (multiply,
+// vector transform, affine inverse, batched point transform), with scalar
+// fallbacks for other targets.
+//
+// Operations are done in the same order as the scalar code in Matrices.h/.cpp,
+// so results are bit-identical as long as the compiler doesn't contract the
+// scalar code into FMAs.
+//
+// Matrices are column major float[16], same as Matrix4. Define
+// DPLUS_MATH_NO_SIMD to use the scalar versions everywhere.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATH_MATRICES_SIMD_H
+#define MATH_MATRICES_SIMD_H
+
+#include <cmath>
+#include <cstddef>
+
+#if !defined(DPLUS_MATH_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) )
+    #define DPLUS_MATH_SSE2
+    #include <emmintrin.h>
+#endif
+
+const float MATRIX_SIMD_INVERT_EPSILON = 0.00001f;  // same as EPSILON in Matrices.cpp
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// scalar versions, also used as reference for the SIMD ones
+///////////////////////////////////////////////////////////////////////////////
+// out = a * b, out must not alias a or b
+inline void matrix4MultiplyScalar(const float* a, const float* b, float* out)
+{
+    for(int col = 0; col < 4; ++col)
+    {
+        const float* n = b + (col * 4);
+        for(int row = 0; row < 4; ++row)
+        {
+            out[col * 4 + row] = a[row]*n[0] + a[4 + row]*n[1] + a[8 + row]*n[2] + a[12 + row]*n[3];
+        }
+    }
+}
+
+// out = M * (v, 0), ignoring translation like Matrix4 * Vector3
+inline void matrix4TransformVector3Scalar(const float* m, const float* v, float* out)
+{
+    const float x = v[0], y = v[1], z = v[2];
+    out[0] = m[0]*x + m[4]*y + m[8]*z;
+    out[1] = m[1]*x + m[5]*y + m[9]*z;
+    out[2] = m[2]*x + m[6]*y + m[10]*z;
+}
+
+inline void matrix4TransformVector4Scalar(const float* m, const float* v, float* out)
+{
+    const float x = v[0], y = v[1], z = v[2], w = v[3];
+    out[0] = m[0]*x + m[4]*y + m[8]*z  + m[12]*w;
+    out[1] = m[1]*x + m[5]*y + m[9]*z  + m[13]*w;
+    out[2] = m[2]*x + m[6]*y + m[10]*z + m[14]*w;
+    out[3] = m[3]*x + m[7]*y + m[11]*z + m[15]*w;
+}
+
+// points_out[i] = M * (points[i], 1), packed xyz triplets. points_out may be the same as points
+inline void matrix4TransformPointsScalar(const float* m, const float* points, float* points_out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float x = points[i * 3], y = points[i * 3 + 1], z = points[i * 3 + 2];
+        points_out[i * 3]     = m[0]*x + m[4]*y + m[8]*z  + m[12];
+        points_out[i * 3 + 1] = m[1]*x + m[5]*y + m[9]*z  + m[13];
+        points_out[i * 3 + 2] = m[2]*x + m[6]*y + m[10]*z + m[14];
+    }
+}
+
+// inverse of the affine matrix m in place, see Matrix4::invertAffine()
+// Turns the 3x3 part into identity if it can't be inverted, same as Matrix3::invert()
+// A NaN determinant doesn't count as that there either, so NaN input stays NaN
+inline void matrix4InvertAffineScalar(float* m)
+{
+    float tmp[9];
+    tmp[0] = m[5] * m[10] - m[6] * m[9];
+    tmp[1] = m[2] * m[9]  - m[1] * m[10];
+    tmp[2] = m[1] * m[6]  - m[2] * m[5];
+    tmp[3] = m[6] * m[8]  - m[4] * m[10];
+    tmp[4] = m[0] * m[10] - m[2] * m[8];
+    tmp[5] = m[2] * m[4]  - m[0] * m[6];
+    tmp[6] = m[4] * m[9]  - m[5] * m[8];
+    tmp[7] = m[1] * m[8]  - m[0] * m[9];
+    tmp[8] = m[0] * m[5]  - m[1] * m[4];
+
+    float r[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    const float determinant = m[0] * tmp[0] + m[1] * tmp[3] + m[2] * tmp[6];
+    if(!(std::fabs(determinant) <= MATRIX_SIMD_INVERT_EPSILON))
+    {
+        const float invDeterminant = 1.0f / determinant;
+        for(int i = 0; i < 9; ++i)
+            r[i] = invDeterminant * tmp[i];
+    }
+
+    m[0] = r[0];  m[1] = r[1];  m[2] = r[2];
+    m[4] = r[3];  m[5] = r[4];  m[6] = r[5];
+    m[8] = r[6];  m[9] = r[7];  m[10]= r[8];
+
+    const float x = m[12], y = m[13], z = m[14];
+    m[12] = -(r[0] * x + r[3] * y + r[6] * z);
+    m[13] = -(r[1] * x + r[4] * y + r[7] * z);
+    m[14] = -(r[2] * x + r[5] * y + r[8] * z);
+}
+
+
+
+#ifdef DPLUS_MATH_SSE2
+///////////////////////////////////////////////////////////////////////////////
+// SSE2 versions
+///////////////////////////////////////////////////////////////////////////////
+// col0 * x + col1 * y + col2 * z, added in the same order as the scalar code
+inline __m128 matrix4CombineColumnsSSE2(__m128 col0, __m128 col1, __m128 col2, float x, float y, float z)
+{
+    __m128 r = _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(x)), _mm_mul_ps(col1, _mm_set1_ps(y)));
+    return _mm_add_ps(r, _mm_mul_ps(col2, _mm_set1_ps(z)));
+}
+
+// stores x, y, z without touching the 4th float
+inline void storeVector3SSE2(float* out, __m128 v)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(out), v);
+    _mm_store_ss(out + 2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)));
+}
+
+// a x b in the x, y, z lanes
+inline __m128 crossSSE2(__m128 a, __m128 b)
+{
+    __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+    return _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx));
+}
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// dispatching versions, used by Matrix4
+///////////////////////////////////////////////////////////////////////////////
+inline void matrix4Multiply(const float* a, const float* b, float* out)
+{
+#ifdef DPLUS_MATH_SSE2
+    const __m128 col0 = _mm_loadu_ps(a);
+    const __m128 col1 = _mm_loadu_ps(a + 4);
+    const __m128 col2 = _mm_loadu_ps(a + 8);
+    const __m128 col3 = _mm_loadu_ps(a + 12);
+
+    for(int col = 0; col < 4; ++col)
+    {
+        const float* n = b + (col * 4);
+        __m128 r = matrix4CombineColumnsSSE2(col0, col1, col2, n[0], n[1], n[2]);
+        r = _mm_add_ps(r, _mm_mul_ps(col3, _mm_set1_ps(n[3])));
+        _mm_storeu_ps(out + (col * 4), r);
+    }
+#else
+    matrix4MultiplyScalar(a, b, out);
+#endif
+}
+
+inline void matrix4TransformVector3(const float* m, const float* v, float* out)
+{
+#ifdef DPLUS_MATH_SSE2
+    __m128 r = matrix4CombineColumnsSSE2(_mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), v[0], v[1], v[2]);
+    storeVector3SSE2(out, r);
+#else
+    matrix4TransformVector3Scalar(m, v, out);
+#endif
+}
+
+inline void matrix4TransformVector4(const float* m, const float* v, float* out)
+{
+#ifdef DPLUS_MATH_SSE2
+    __m128 r = matrix4CombineColumnsSSE2(_mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), v[0], v[1], v[2]);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3])));
+    _mm_storeu_ps(out, r);
+#else
+    matrix4TransformVector4Scalar(m, v, out);
+#endif
+}
+
+inline void matrix4TransformPoints(const float* m, const float* points, float* points_out, size_t count)
+{
+#ifdef DPLUS_MATH_SSE2
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float* p = points + (i * 3);
+        __m128 r = matrix4CombineColumnsSSE2(col0, col1, col2, p[0], p[1], p[2]);
+        storeVector3SSE2(points_out + (i * 3), _mm_add_ps(r, col3));
+    }
+#else
+    matrix4TransformPointsScalar(m, points, points_out, count);
+#endif
+}
+
+inline void matrix4InvertAffine(float* m)
+{
+#ifdef DPLUS_MATH_SSE2
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+
+    // rows of the adjugate
+    __m128 row0 = crossSSE2(c1, c2);
+    __m128 row1 = crossSSE2(c2, c0);
+    __m128 row2 = crossSSE2(c0, c1);
+
+    float row0_f[4];
+    _mm_storeu_ps(row0_f, row0);
+    const float determinant = m[0] * row0_f[0] + m[1] * row0_f[1] + m[2] * row0_f[2];
+
+    if(!(std::fabs(determinant) <= MATRIX_SIMD_INVERT_EPSILON))
+    {
+        const __m128 invDeterminant = _mm_set1_ps(1.0f / determinant);
+        row0 = _mm_mul_ps(invDeterminant, row0);
+        row1 = _mm_mul_ps(invDeterminant, row1);
+        row2 = _mm_mul_ps(invDeterminant, row2);
+    }
+    else
+    {
+        row0 = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+        row1 = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+        row2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+    }
+
+    // transpose rows into the columns of the inverse, keeping the 4th row of the matrix
+    __m128 row3 = _mm_setr_ps(m[3], m[7], m[11], 0.0f);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    // -R^-1 * T
+    const float x = m[12], y = m[13], z = m[14];
+    const __m128 t = _mm_xor_ps(matrix4CombineColumnsSSE2(row0, row1, row2, x, y, z), _mm_set1_ps(-0.0f));  // flip sign like unary minus, 0 - v would turn -0 into +0
+
+    _mm_storeu_ps(m, row0);
+    _mm_storeu_ps(m + 4, row1);
+    _mm_storeu_ps(m + 8, row2);
+    storeVector3SSE2(m + 12, t);
+#else
+    matrix4InvertAffineScalar(m);
+#endif
+}
+
+#endif
@@ -3,7 +3,8 @@
 #include "Util.h"
 
 OUtoSBSConverter::OUtoSBSConverter() : m_TexSBSWidth(0),
-                                       m_TexSBSHeight(0)
+                                       m_TexSBSHeight(0),
+                                       m_IsFullConversionPending(true)
 {
 
 }
@@ -19,7 +20,8 @@ ID3D11Texture2D* OUtoSBSConverter::GetTexture() const
 }
 
 HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context, 
-                                  ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height)
+                                  ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height, 
+                                  const OUtoSBSRect& dirty_rect)
 {
     int sbs_width  = crop_width  * 2;
     int sbs_height = crop_height / 2;
@@ -63,13 +65,21 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
 
             hr = device->CreateTexture2D(&TexD, nullptr, &m_MultiGPUTexSBSStaging);
 
+            if (FAILED(hr))
+                return hr;
+
+            //Copy-target staging texture. Unlike a dynamic texture, this keeps its content when mapped, so only the changed parts need to be written
+            TexD.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+            hr = multi_gpu_device->CreateTexture2D(&TexD, nullptr, &m_MultiGPUTexSBSTargetStaging);
+
             if (FAILED(hr))
                 return hr;
 
             //Copy-target texture
-            TexD.Usage = D3D11_USAGE_DYNAMIC;
+            TexD.Usage = D3D11_USAGE_DEFAULT;
             TexD.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-            TexD.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            TexD.CPUAccessFlags = 0;
             TexD.MiscFlags = 0;
 
             hr = multi_gpu_device->CreateTexture2D(&TexD, nullptr, &m_MultiGPUTexSBSTarget);
@@ -79,46 +89,91 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
         }
     }
 
-    //Copy top and bottom half of the cropped region into the left and right halves of SBS texture
-    D3D11_BOX source_region;
-    source_region.left   = clamp(crop_x, 0, tex_source_width);
-    source_region.right  = clamp(crop_x + crop_width, 0, tex_source_width);
-    source_region.top    = clamp(crop_y, 0, tex_source_height);
-    source_region.bottom = clamp(crop_y + sbs_height, 0, tex_source_height);
-    source_region.front  = 0;
-    source_region.back   = 1;
-
-    device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, 0, 0, 0, tex_source, 0, &source_region);          //Top -> Left
-
-    source_region.top    = source_region.bottom;
-    source_region.bottom = clamp((int)source_region.top + sbs_height, 0, tex_source_height);
+    //Copy changed parts of the top and bottom half of the cropped region into the left and right halves of SBS texture
+    OUtoSBSCopyRegion regions[2];
+    int region_count = OUtoSBSMapDirtyRect(crop_x, crop_y, crop_width, crop_height, tex_source_width, tex_source_height, 
+                                           (m_IsFullConversionPending) ? OUtoSBSRect::Everything() : dirty_rect, regions);
 
-    device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, crop_width, 0, 0, tex_source, 0, &source_region); //Bottom -> Right
+    //Stays pending until everything went through, so a failure doesn't leave parts of the texture outdated
+    m_IsFullConversionPending = true;
 
-    //If set up for multi-gpu processing, copy the texture over
-    if (m_MultiGPUTexSBSTarget != nullptr)
+    for (int i = 0; i < region_count; ++i)
     {
-        //Same as in OutputManager::RefreshOpenVROverlayTexture
-        device_context->CopyResource(m_MultiGPUTexSBSStaging.Get(), m_TexSBS.Get());
+        D3D11_BOX source_region;
+        source_region.left   = regions[i].Source.Left;
+        source_region.right  = regions[i].Source.Right;
+        source_region.top    = regions[i].Source.Top;
+        source_region.bottom = regions[i].Source.Bottom;
+        source_region.front  = 0;
+        source_region.back   = 1;
+
+        device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, regions[i].DestX, regions[i].DestY, 0, tex_source, 0, &source_region);
+    }
 
-        D3D11_MAPPED_SUBRESOURCE mapped_resource_staging;
-        RtlZeroMemory(&mapped_resource_staging, sizeof(D3D11_MAPPED_SUBRESOURCE));
-        HRESULT hr = device_context->Map(m_MultiGPUTexSBSStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped_resource_staging);
+    //If set up for multi-gpu processing, copy the changed parts over
+    if ( (m_MultiGPUTexSBSTarget != nullptr) && (region_count != 0) )
+    {
+        HRESULT hr = CopyToMultiGPUTarget(device_context, multi_gpu_device_context, regions, region_count);
 
         if (FAILED(hr))
             return hr;
+    }
 
-        D3D11_MAPPED_SUBRESOURCE mapped_resource_target;
-        RtlZeroMemory(&mapped_resource_target, sizeof(D3D11_MAPPED_SUBRESOURCE));
-        hr = multi_gpu_device_context->Map(m_MultiGPUTexSBSTarget.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource_target);
+    m_IsFullConversionPending = false;
 
-        if (FAILED(hr))
-            return hr;
+    return S_OK;
+}
 
-        memcpy(mapped_resource_target.pData, mapped_resource_staging.pData, (size_t)sbs_height * mapped_resource_staging.RowPitch);
+HRESULT OUtoSBSConverter::CopyToMultiGPUTarget(ID3D11DeviceContext* device_context, ID3D11DeviceContext* multi_gpu_device_context, const OUtoSBSCopyRegion* regions, int region_count)
+{
+    //Similar to OutputManager::RefreshOpenVROverlayTexture, but restricted to the regions. Both staging textures keep their content between updates
+    for (int i = 0; i < region_count; ++i)
+    {
+        const OUtoSBSRect dest_rect = regions[i].GetDestRect();
+        const D3D11_BOX box = {(UINT)dest_rect.Left, (UINT)dest_rect.Top, 0, (UINT)dest_rect.Right, (UINT)dest_rect.Bottom, 1};
 
+        device_context->CopySubresourceRegion(m_MultiGPUTexSBSStaging.Get(), 0, box.left, box.top, 0, m_TexSBS.Get(), 0, &box);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped_resource_staging;
+    RtlZeroMemory(&mapped_resource_staging, sizeof(D3D11_MAPPED_SUBRESOURCE));
+    HRESULT hr = device_context->Map(m_MultiGPUTexSBSStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped_resource_staging);
+
+    if (FAILED(hr))
+        return hr;
+
+    D3D11_MAPPED_SUBRESOURCE mapped_resource_target;
+    RtlZeroMemory(&mapped_resource_target, sizeof(D3D11_MAPPED_SUBRESOURCE));
+    hr = multi_gpu_device_context->Map(m_MultiGPUTexSBSTargetStaging.Get(), 0, D3D11_MAP_WRITE, 0, &mapped_resource_target);
+
+    if (FAILED(hr))
+    {
         device_context->Unmap(m_MultiGPUTexSBSStaging.Get(), 0);
-        multi_gpu_device_context->Unmap(m_MultiGPUTexSBSTarget.Get(), 0);
+        return hr;
+    }
+
+    for (int i = 0; i < region_count; ++i)
+    {
+        const OUtoSBSRect dest_rect = regions[i].GetDestRect();
+        const size_t row_offset = (size_t)dest_rect.Left * 4; //4 bytes per pixel, DXGI_FORMAT_B8G8R8A8_UNORM
+        const size_t row_size   = (size_t)dest_rect.GetWidth() * 4;
+
+        for (int y = dest_rect.Top; y < dest_rect.Bottom; ++y)
+        {
+            memcpy((BYTE*)mapped_resource_target.pData + (y * (size_t)mapped_resource_target.RowPitch) + row_offset, 
+                   (BYTE*)mapped_resource_staging.pData + (y * (size_t)mapped_resource_staging.RowPitch) + row_offset, row_size);
+        }
+    }
+
+    device_context->Unmap(m_MultiGPUTexSBSStaging.Get(), 0);
+    multi_gpu_device_context->Unmap(m_MultiGPUTexSBSTargetStaging.Get(), 0);
+
+    for (int i = 0; i < region_count; ++i)
+    {
+        const OUtoSBSRect dest_rect = regions[i].GetDestRect();
+        const D3D11_BOX box = {(UINT)dest_rect.Left, (UINT)dest_rect.Top, 0, (UINT)dest_rect.Right, (UINT)dest_rect.Bottom, 1};
+
+        multi_gpu_device_context->CopySubresourceRegion(m_MultiGPUTexSBSTarget.Get(), 0, box.left, box.top, 0, m_MultiGPUTexSBSTargetStaging.Get(), 0, &box);
     }
 
     return S_OK;
@@ -128,5 +183,7 @@ void OUtoSBSConverter::CleanRefs()
 {
     m_TexSBS.Reset();
     m_MultiGPUTexSBSStaging.Reset();
+    m_MultiGPUTexSBSTargetStaging.Reset();
     m_MultiGPUTexSBSTarget.Reset();
+    m_IsFullConversionPending = true;
 }
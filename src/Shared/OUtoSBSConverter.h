@@ -4,23 +4,33 @@
 #include <d3d11.h>
 #include <wrl/client.h>
 
+#include "OUtoSBSConverterCache.h"
+
 //This class rearranges an OU 3D texture to a SBS 3D texture
 class OUtoSBSConverter
 {
     private:
         Microsoft::WRL::ComPtr<ID3D11Texture2D> m_TexSBS;                 //Owned by device
-        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_MultiGPUTexSBSStaging;  //Staging texture, owned by device
-        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_MultiGPUTexSBSTarget;   //Target texture to copy to, owned by multi_gpu_device
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_MultiGPUTexSBSStaging;        //Staging texture, owned by device
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_MultiGPUTexSBSTargetStaging;  //Staging texture to write to, owned by multi_gpu_device
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_MultiGPUTexSBSTarget;         //Target texture to copy to, owned by multi_gpu_device
         int m_TexSBSWidth;
         int m_TexSBSHeight;
+        bool m_IsFullConversionPending;                                         //Set when the SBS texture content can't be relied on, ignoring the dirty rect on the next conversion
+
+        HRESULT CopyToMultiGPUTarget(ID3D11DeviceContext* device_context, ID3D11DeviceContext* multi_gpu_device_context, const OUtoSBSCopyRegion* regions, int region_count);
 
     public:
         OUtoSBSConverter();
         ~OUtoSBSConverter();
 
         ID3D11Texture2D* GetTexture() const; //Does not add a reference
+        //Only the parts of the crop overlapping dirty_rect (in source texture coordinates) are copied, unless the SBS texture was just created
         HRESULT Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context, 
-                        ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height);
+                        ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height, 
+                        const OUtoSBSRect& dirty_rect = OUtoSBSRect::Everything());
         void CleanRefs();
 
-};
\ No newline at end of file
+};
+
+typedef OUtoSBSConverterCacheBase<OUtoSBSConverter> OUtoSBSConverterCache;
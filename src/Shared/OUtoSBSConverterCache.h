@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "OUtoSBSMapping.h"
+
+//Shares OU->SBS conversions between overlays using the same source texture and crop, and skips them when the source region didn't change
+//Usage per source update: BeginFrame(), then GetEntry() + IsConversionNeeded()/SetConverted() for every overlay, then EndFrame()
+//Entries not requested during a frame are dropped in EndFrame(), so hidden overlays don't keep their textures around
+//TConverter is OUtoSBSConverter in practice (see OUtoSBSConverterCache in OUtoSBSConverter.h), but any type works, which keeps the bookkeeping testable without D3D
+template<class TConverter>
+class OUtoSBSConverterCacheBase
+{
+    public:
+        struct Entry
+        {
+            const void* SourceTexture = nullptr;   //Only used as a key, never dereferenced
+            OUtoSBSRect CropRect;
+            TConverter Converter;
+            uint64_t ID = 0;                       //Unique for every created entry, lets users detect that they're now using a different texture
+            uint64_t LastUsedFrame = 0;
+            uint64_t LastConvertedFrame = 0;       //0 if never converted successfully
+            bool IsFailureReported = false;
+        };
+
+    private:
+        std::vector<Entry> m_Entries;
+        uint64_t m_FrameID     = 0;
+        uint64_t m_NextEntryID = 1;
+        OUtoSBSRect m_FrameDirtyRect;
+
+    public:
+        //Dirty rect is the region of the source texture that changed since the last frame
+        void BeginFrame(const OUtoSBSRect& dirty_rect = OUtoSBSRect::Everything())
+        {
+            m_FrameID++;
+            m_FrameDirtyRect = dirty_rect;
+        }
+
+        //Returned reference is only valid until the next GetEntry() or EndFrame() call
+        Entry& GetEntry(const void* source_texture, const OUtoSBSRect& crop_rect)
+        {
+            for (Entry& entry : m_Entries)
+            {
+                if ( (entry.SourceTexture == source_texture) && (entry.CropRect == crop_rect) )
+                {
+                    entry.LastUsedFrame = m_FrameID;
+                    return entry;
+                }
+            }
+
+            m_Entries.emplace_back();
+            Entry& entry = m_Entries.back();
+            entry.SourceTexture = source_texture;
+            entry.CropRect      = crop_rect;
+            entry.ID            = m_NextEntryID++;
+            entry.LastUsedFrame = m_FrameID;
+
+            return entry;
+        }
+
+        const OUtoSBSRect& GetFrameDirtyRect() const
+        {
+            return m_FrameDirtyRect;
+        }
+
+        bool IsConversionNeeded(const Entry& entry) const
+        {
+            if (entry.LastConvertedFrame == 0)         //Never converted
+                return true;
+            if (entry.LastConvertedFrame == m_FrameID) //Already converted for another overlay this frame
+                return false;
+
+            return m_FrameDirtyRect.Overlaps(entry.CropRect);
+        }
+
+        bool IsConvertedThisFrame(const Entry& entry) const
+        {
+            return (entry.LastConvertedFrame == m_FrameID);
+        }
+
+        void SetConverted(Entry& entry)
+        {
+            entry.LastConvertedFrame = m_FrameID;
+        }
+
+        //Returns true only for the first failed conversion of the entry, so a crop that can never be converted (e.g. 1 pixel high) isn't reported every frame
+        bool SetConversionFailed(Entry& entry)
+        {
+            if (entry.IsFailureReported)
+                return false;
+
+            entry.IsFailureReported = true;
+            return true;
+        }
+
+        void EndFrame()
+        {
+            for (auto it = m_Entries.begin(); it != m_Entries.end();)
+            {
+                it = (it->LastUsedFrame != m_FrameID) ? m_Entries.erase(it) : it + 1;
+            }
+        }
+
+        void Clear()
+        {
+            m_Entries.clear();
+        }
+
+        size_t GetEntryCount() const
+        {
+            return m_Entries.size();
+        }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+
+//Plain rectangle with exclusive right/bottom edges, same convention as D3D11_BOX and DPRect
+//Used instead of DPRect so the code below stays free of Windows and D3D headers
+struct OUtoSBSRect
+{
+    int Left   = 0;
+    int Top    = 0;
+    int Right  = 0;
+    int Bottom = 0;
+
+    OUtoSBSRect() {}
+    OUtoSBSRect(int left, int top, int right, int bottom) : Left(left), Top(top), Right(right), Bottom(bottom) {}
+
+    static OUtoSBSRect FromCrop(int x, int y, int width, int height) { return OUtoSBSRect(x, y, x + width, y + height); }
+    static OUtoSBSRect Everything()                                  { return OUtoSBSRect(INT_MIN, INT_MIN, INT_MAX, INT_MAX); }
+
+    int  GetWidth() const                      { return Right - Left; }
+    int  GetHeight() const                     { return Bottom - Top; }
+    bool IsEmpty() const                       { return ( (Right <= Left) || (Bottom <= Top) ); }
+    bool Overlaps(const OUtoSBSRect& r) const  { return ( (r.Top < Bottom) && (r.Bottom > Top) && (r.Left < Right) && (r.Right > Left) ); }
+    bool operator==(const OUtoSBSRect& r) const { return ( (Left == r.Left) && (Top == r.Top) && (Right == r.Right) && (Bottom == r.Bottom) ); }
+    bool operator!=(const OUtoSBSRect& r) const { return !(*this == r); }
+};
+
+//Source region and its destination in the SBS texture for one half of the conversion
+struct OUtoSBSCopyRegion
+{
+    OUtoSBSRect Source;
+    int DestX = 0;
+    int DestY = 0;
+
+    OUtoSBSRect GetDestRect() const { return OUtoSBSRect(DestX, DestY, DestX + Source.GetWidth(), DestY + Source.GetHeight()); }
+};
+
+//Maps the changed region of an OU source texture into the copies needed to update the SBS texture
+//The top half of the crop goes to the left half of the SBS texture, the bottom half to the right one. Source regions are clamped to the texture size
+//Returns the number of regions written to regions_out (0 to 2). Pass OUtoSBSRect::Everything() as dirty_rect to get the full conversion
+inline int OUtoSBSMapDirtyRect(int crop_x, int crop_y, int crop_width, int crop_height, int tex_source_width, int tex_source_height, const OUtoSBSRect& dirty_rect, 
+                               OUtoSBSCopyRegion (&regions_out)[2])
+{
+    const int sbs_height = crop_height / 2;
+    int region_count = 0;
+
+    OUtoSBSRect half;
+    half.Left   = std::max(0, std::min(crop_x, tex_source_width));
+    half.Right  = std::max(0, std::min(crop_x + crop_width, tex_source_width));
+    half.Top    = std::max(0, std::min(crop_y, tex_source_height));
+    half.Bottom = std::max(0, std::min(crop_y + sbs_height, tex_source_height));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        //Intersect with the dirty rect and offset the destination by the same amount the source got cut off
+        OUtoSBSRect source(std::max(half.Left, dirty_rect.Left), std::max(half.Top, dirty_rect.Top), std::min(half.Right, dirty_rect.Right), std::min(half.Bottom, dirty_rect.Bottom));
+
+        if (!source.IsEmpty())
+        {
+            OUtoSBSCopyRegion& region = regions_out[region_count++];
+            region.Source = source;
+            region.DestX  = (i * crop_width) + (source.Left - half.Left);
+            region.DestY  = source.Top - half.Top;
+        }
+
+        //Bottom half directly follows the top one
+        half.Top    = half.Bottom;
+        half.Bottom = std::max(0, std::min(half.Top + sbs_height, tex_source_height));
+    }
+
+    return region_count;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BinaryStream.h"
+
+//Collects config changes for any number of overlays so they can be applied in one go (see OutputManager::CommitOverlayConfigBatch())
+//Changes are identified by overlay ID and config key, which is the same value ConfigManager::GetWParamForConfigID() returns for overlay bool and int config IDs
+//Before committing, Diff() drops changes that are overridden by later ones or don't change the current value, so only actual changes cause any work or IPC traffic
+//The remaining changes are sent to the UI app as a single binary message. Kept free of Windows headers so it can be tested anywhere
+
+struct OverlayConfigChange
+{
+    uint32_t OverlayID;
+    uint32_t ConfigKey;
+    int32_t Value;                              //0 or 1 for bool config IDs
+};
+
+class OverlayConfigBatch
+{
+    public:
+        static const uint16_t SerializationVersion = 1;
+        static const uint32_t SerializationMaxCount = 65536;
+
+    private:
+        std::vector<OverlayConfigChange> m_Changes;
+
+    public:
+        //Later changes to the same value replace earlier ones
+        void Set(uint32_t overlay_id, uint32_t config_key, int32_t value)
+        {
+            m_Changes.push_back({overlay_id, config_key, value});
+        }
+
+        void Clear()                                            { m_Changes.clear(); }
+        bool IsEmpty() const                                    { return m_Changes.empty(); }
+        const std::vector<OverlayConfigChange>& GetChanges() const { return m_Changes; }
+
+        //Calls get_value(overlay_id, config_key, int& value_out) to drop changes that wouldn't change anything. Returns the number of remaining changes
+        //get_value() returns false if the value doesn't exist, which drops the change as well
+        //Changes end up sorted by overlay ID, so changes of the same overlay are next to each other
+        template<typename F> size_t Diff(F get_value)
+        {
+            //Stable, so the last change to the same value is the last one in its run
+            std::stable_sort(m_Changes.begin(), m_Changes.end(), [](const OverlayConfigChange& a, const OverlayConfigChange& b)
+                             {
+                                 return (a.OverlayID != b.OverlayID) ? (a.OverlayID < b.OverlayID) : (a.ConfigKey < b.ConfigKey);
+                             });
+
+            size_t count = 0;
+            for (size_t i = 0; i < m_Changes.size(); ++i)
+            {
+                const bool is_last_of_run = ( (i + 1 == m_Changes.size()) || (m_Changes[i + 1].OverlayID != m_Changes[i].OverlayID) ||
+                                              (m_Changes[i + 1].ConfigKey != m_Changes[i].ConfigKey) );
+
+                if (!is_last_of_run)
+                    continue;
+
+                int32_t value_current = 0;
+                if ( (get_value(m_Changes[i].OverlayID, m_Changes[i].ConfigKey, value_current)) && (value_current != m_Changes[i].Value) )
+                {
+                    m_Changes[count++] = m_Changes[i];
+                }
+            }
+
+            m_Changes.resize(count);
+            return count;
+        }
+
+        //Layout: uint16 version, uint32 change count, then per change uint32 overlay ID, uint32 config key, int32 value
+        void Serialize(BinaryWriter& writer) const
+        {
+            writer.Reserve(6 + (m_Changes.size() * 12));
+            writer.Write<uint16_t>(SerializationVersion);
+            writer.Write<uint32_t>((uint32_t)m_Changes.size());
+
+            for (const OverlayConfigChange& change : m_Changes)
+            {
+                writer.Write<uint32_t>(change.OverlayID);
+                writer.Write<uint32_t>(change.ConfigKey);
+                writer.Write<int32_t>(change.Value);
+            }
+        }
+
+        //Returns false and leaves the batch empty if the data is invalid
+        bool Deserialize(const void* data, size_t size)
+        {
+            m_Changes.clear();
+
+            BinaryReader reader(data, size);
+            const uint16_t version = reader.Read<uint16_t>();
+            const uint32_t count   = reader.Read<uint32_t>();
+
+            if ( (reader.HasFailed()) || (version != SerializationVersion) || (count > SerializationMaxCount) || (size != 6 + ((size_t)count * 12)) )
+                return false;
+
+            m_Changes.resize(count);
+            for (OverlayConfigChange& change : m_Changes)
+            {
+                change.OverlayID = reader.Read<uint32_t>();
+                change.ConfigKey = reader.Read<uint32_t>();
+                change.Value     = reader.Read<int32_t>();
+            }
+
+            if ( (reader.HasFailed()) || (!reader.IsAtEnd()) )
+            {
+                m_Changes.clear();
+                return false;
+            }
+
+            return true;
+        }
+};
@@ -8,6 +8,7 @@
 #endif
 
 #include "Util.h"
+#include "OverlayTransformCache.h"
 
 #include <sstream>
 
@@ -163,6 +164,7 @@ void OverlayManager::SwapOverlays(unsigned int id, unsigned int id2)
         return;
 
     std::iter_swap(m_OverlayConfigData.begin() + id, m_OverlayConfigData.begin() + id2);
+    ActionManager::Get().HotkeyBindingsOverlaysSwapped(id, id2);
 
     #ifndef DPLUS_UI
         Overlay& overlay   = GetOverlay(id);
@@ -218,6 +220,7 @@ void OverlayManager::RemoveOverlay(unsigned int id)
         #endif
 
         m_OverlayConfigData.erase(m_OverlayConfigData.begin() + id);
+        ActionManager::Get().HotkeyBindingsOverlayRemoved(id);
 
         #ifndef DPLUS_UI
             //If the overlay isn't the last one we set its handle to invalid so it won't get destroyed and can be reused below
@@ -262,7 +265,9 @@ void OverlayManager::RemoveOverlay(unsigned int id)
                 }
 
                 //After swapping around overlay handles, the previously highest ID has been abandonned, so get rid of it manually
-                vr::VROverlay()->DestroyOverlay(FindOverlayHandle(m_Overlays.size()));
+                vr::VROverlayHandle_t ovrl_handle_abandoned = FindOverlayHandle(m_Overlays.size());
+                vr::VROverlay()->DestroyOverlay(ovrl_handle_abandoned);
+                OverlayTransformCache::Get().Invalidate(ovrl_handle_abandoned);
 
                 //After swapping, the states also need to be applied again to the new handles
                 if (OutputManager* outmgr = OutputManager::Get())
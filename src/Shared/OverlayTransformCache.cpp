@@ -0,0 +1,139 @@
+#include "OverlayTransformCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+//About a hundredth of a millimeter at the translation and a similarly small rotation, well below anything visible
+const float OverlayTransformCache::DefaultEpsilon = 0.00001f;
+
+static OverlayTransformCache g_OverlayTransformCache;
+
+OverlayTransformCache& OverlayTransformCache::Get()
+{
+    return g_OverlayTransformCache;
+}
+
+OverlayTransformCache::OverlayTransformCache() : m_Epsilon(DefaultEpsilon), m_SubmittedCount(0), m_SkippedCount(0)
+{
+}
+
+OverlayTransformCacheEntry* OverlayTransformCache::FindEntry(vr::VROverlayHandle_t overlay_handle)
+{
+    auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [&](const OverlayTransformCacheEntry& entry){ return (entry.OverlayHandle == overlay_handle); });
+
+    return (it != m_Entries.end()) ? &*it : nullptr;
+}
+
+bool OverlayTransformCache::Update(vr::VROverlayHandle_t overlay_handle, vr::VROverlayTransformType transform_type, uint32_t transform_target,
+                                   const vr::HmdMatrix34_t& transform)
+{
+    OverlayTransformCacheEntry* entry = FindEntry(overlay_handle);
+
+    if ( (entry != nullptr) && (entry->TransformType == transform_type) && (entry->TransformTarget == transform_target) )
+    {
+        bool is_same = true;
+
+        for (int row = 0; (row < 3) && (is_same); ++row)
+        {
+            for (int col = 0; col < 4; ++col)
+            {
+                //Written so NaN never counts as the same
+                if (!(std::fabs(entry->Transform.m[row][col] - transform.m[row][col]) <= m_Epsilon))
+                {
+                    is_same = false;
+                    break;
+                }
+            }
+        }
+
+        if (is_same)
+        {
+            m_SkippedCount++;
+            return false;
+        }
+    }
+
+    if (entry == nullptr)
+    {
+        m_Entries.push_back({overlay_handle, transform_type, transform_target, transform});
+    }
+    else
+    {
+        entry->TransformType   = transform_type;
+        entry->TransformTarget = transform_target;
+        entry->Transform       = transform;
+    }
+
+    m_SubmittedCount++;
+    return true;
+}
+
+void OverlayTransformCache::Invalidate(vr::VROverlayHandle_t overlay_handle)
+{
+    m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [&](const OverlayTransformCacheEntry& entry){ return (entry.OverlayHandle == overlay_handle); }),
+                    m_Entries.end());
+}
+
+void OverlayTransformCache::InvalidateAll()
+{
+    m_Entries.clear();
+}
+
+vr::EVROverlayError OverlayTransformCache::SetOverlayTransformAbsolute(vr::VROverlayHandle_t overlay_handle, vr::ETrackingUniverseOrigin tracking_origin,
+                                                                       const vr::HmdMatrix34_t* transform)
+{
+    if (!Update(overlay_handle, vr::VROverlayTransform_Absolute, tracking_origin, *transform))
+        return vr::VROverlayError_None;
+
+    vr::EVROverlayError error = vr::VROverlay()->SetOverlayTransformAbsolute(overlay_handle, tracking_origin, transform);
+
+    //Don't skip the next try if this one didn't make it
+    if (error != vr::VROverlayError_None)
+    {
+        Invalidate(overlay_handle);
+    }
+
+    return error;
+}
+
+vr::EVROverlayError OverlayTransformCache::SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t overlay_handle, vr::TrackedDeviceIndex_t device_index,
+                                                                                    const vr::HmdMatrix34_t* transform)
+{
+    if (!Update(overlay_handle, vr::VROverlayTransform_TrackedDeviceRelative, device_index, *transform))
+        return vr::VROverlayError_None;
+
+    vr::EVROverlayError error = vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(overlay_handle, device_index, transform);
+
+    if (error != vr::VROverlayError_None)
+    {
+        Invalidate(overlay_handle);
+    }
+
+    return error;
+}
+
+void OverlayTransformCache::SetEpsilon(float epsilon)
+{
+    m_Epsilon = std::max(epsilon, 0.0f);
+}
+
+float OverlayTransformCache::GetEpsilon() const
+{
+    return m_Epsilon;
+}
+
+uint64_t OverlayTransformCache::GetSubmittedCount() const
+{
+    return m_SubmittedCount;
+}
+
+uint64_t OverlayTransformCache::GetSkippedCount() const
+{
+    return m_SkippedCount;
+}
+
+void OverlayTransformCache::ResetCounters()
+{
+    m_SubmittedCount = 0;
+    m_SkippedCount   = 0;
+}
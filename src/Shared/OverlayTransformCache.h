@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "openvr.h"
+
+//Skips overlay transform submissions matching the last one made for the same overlay
+//Some transforms are applied every frame while barely ever changing (drag updates, floating UI, UI overlay positioning), and each submission is a call into the VR runtime process
+//Transforms are compared element-wise against the last submitted one, so slow movement still goes through once it accumulates past the epsilon
+//Only submissions going through the cache are known to it. Call Invalidate() when the overlay is destroyed or its transform was changed some other way
+//Not thread-safe, meant to be used from the thread handling the overlays only
+
+struct OverlayTransformCacheEntry
+{
+    vr::VROverlayHandle_t OverlayHandle;
+    vr::VROverlayTransformType TransformType;   //vr::VROverlayTransform_Absolute or vr::VROverlayTransform_TrackedDeviceRelative
+    uint32_t TransformTarget;                   //vr::ETrackingUniverseOrigin for absolute transforms, device index for device relative ones
+    vr::HmdMatrix34_t Transform;
+};
+
+class OverlayTransformCache
+{
+    private:
+        std::vector<OverlayTransformCacheEntry> m_Entries;     //Only a handful of overlays, searched linearly
+        float m_Epsilon;
+        uint64_t m_SubmittedCount;
+        uint64_t m_SkippedCount;
+
+        OverlayTransformCacheEntry* FindEntry(vr::VROverlayHandle_t overlay_handle);
+
+    public:
+        static const float DefaultEpsilon;
+
+        static OverlayTransformCache& Get();
+        OverlayTransformCache();
+
+        //Returns true if the transform needs to be submitted and stores it as the last one, or false and counts it as skipped
+        bool Update(vr::VROverlayHandle_t overlay_handle, vr::VROverlayTransformType transform_type, uint32_t transform_target, const vr::HmdMatrix34_t& transform);
+        void Invalidate(vr::VROverlayHandle_t overlay_handle);
+        void InvalidateAll();
+
+        //Drop-in replacements for the IVROverlay functions of the same name
+        vr::EVROverlayError SetOverlayTransformAbsolute(vr::VROverlayHandle_t overlay_handle, vr::ETrackingUniverseOrigin tracking_origin, const vr::HmdMatrix34_t* transform);
+        vr::EVROverlayError SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t overlay_handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t* transform);
+
+        //Largest difference of any matrix element still treated as the same transform. 0 only skips exact matches
+        void SetEpsilon(float epsilon);
+        float GetEpsilon() const;
+
+        uint64_t GetSubmittedCount() const;
+        uint64_t GetSkippedCount() const;                           //Cross-process calls avoided
+        void ResetCounters();
+};
@@ -0,0 +1,251 @@
+#include "VRStream.h"
+
+#include <cstring>
+#include <iterator>
+
+static const char g_VRStreamMagic[8] = {'D', 'P', 'V', 'R', 'S', 'T', 'R', 'M'};
+static const uint32_t g_VRStreamVersion = 1;
+static const size_t g_VRStreamFlushSize = 64 * 1024;
+
+VRStreamRecorder::VRStreamRecorder() : m_IsRecording(false)
+{
+}
+
+VRStreamRecorder::~VRStreamRecorder()
+{
+    Stop();
+}
+
+uint32_t VRStreamRecorder::GetOverlayID(vr::VROverlayHandle_t overlay_handle)
+{
+    if (overlay_handle == vr::k_ulOverlayHandleInvalid)
+        return 0;
+
+    for (size_t i = 0; i < m_OverlayHandles.size(); ++i)
+    {
+        if (m_OverlayHandles[i] == overlay_handle)
+            return (uint32_t)i + 1;
+    }
+
+    //First event of this overlay, declare it with its key so the overlay can be identified in the recording
+    char key[vr::k_unVROverlayMaxKeyLength] = "";
+    vr::VROverlay()->GetOverlayKey(overlay_handle, key, vr::k_unVROverlayMaxKeyLength);
+
+    m_OverlayHandles.push_back(overlay_handle);
+    const uint32_t overlay_id = (uint32_t)m_OverlayHandles.size();
+
+    m_Writer.Write<uint8_t>(vrstream_record_overlay);
+    m_Writer.Write<uint32_t>(overlay_id);
+    m_Writer.WriteString(key);
+
+    return overlay_id;
+}
+
+void VRStreamRecorder::Flush()
+{
+    m_File.write(m_Writer.GetBuffer().data(), m_Writer.GetBuffer().size());
+    m_Writer.Clear();
+}
+
+bool VRStreamRecorder::Start(const char* path)
+{
+    Stop();
+
+    m_File.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!m_File.good())
+        return false;
+
+    m_OverlayHandles.clear();
+
+    //Devices start out as not connected, so only connected ones end up in the first frame
+    memset(m_LastPoses, 0, sizeof(m_LastPoses));
+    for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
+    {
+        m_LastPoses[i].DeviceIndex = (uint8_t)i;
+    }
+
+    m_Writer.Reserve(g_VRStreamFlushSize * 2);
+    m_StartTime = std::chrono::steady_clock::now();
+
+    for (char c : g_VRStreamMagic)
+    {
+        m_Writer.Write<char>(c);
+    }
+    m_Writer.Write<uint32_t>(g_VRStreamVersion);
+    m_Writer.Write<uint32_t>(sizeof(vr::VREvent_t));
+
+    m_IsRecording = true;
+
+    return true;
+}
+
+void VRStreamRecorder::Stop()
+{
+    if (!m_IsRecording)
+        return;
+
+    Flush();
+    m_File.close();
+    m_IsRecording = false;
+}
+
+bool VRStreamRecorder::IsRecording() const
+{
+    return m_IsRecording;
+}
+
+void VRStreamRecorder::RecordFrame()
+{
+    if (!m_IsRecording)
+        return;
+
+    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
+    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, 0.0f, poses, vr::k_unMaxTrackedDeviceCount);
+
+    VRStreamPose changed_poses[vr::k_unMaxTrackedDeviceCount];
+    uint8_t changed_count = 0;
+
+    for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; ++i)
+    {
+        VRStreamPose pose = {};
+        pose.DeviceIndex    = (uint8_t)i;
+        pose.DeviceClass    = (uint8_t)vr::VRSystem()->GetTrackedDeviceClass(i);
+        pose.ControllerRole = (uint8_t)vr::VRSystem()->GetControllerRoleForTrackedDeviceIndex(i);
+        pose.IsValid        = poses[i].bPoseIsValid;
+        pose.IsConnected    = poses[i].bDeviceIsConnected;
+        pose.DeviceToAbsoluteTracking = poses[i].mDeviceToAbsoluteTracking;
+
+        if (memcmp(&pose, &m_LastPoses[i], sizeof(VRStreamPose)) != 0)
+        {
+            changed_poses[changed_count++] = pose;
+            m_LastPoses[i] = pose;
+        }
+    }
+
+    const uint64_t timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_StartTime).count();
+
+    m_Writer.Write<uint8_t>(vrstream_record_frame);
+    m_Writer.Write<uint64_t>(timestamp_us);
+    m_Writer.Write<uint8_t>(changed_count);
+
+    for (uint8_t i = 0; i < changed_count; ++i)
+    {
+        m_Writer.Write(changed_poses[i]);
+    }
+
+    if (m_Writer.GetBuffer().size() >= g_VRStreamFlushSize)
+    {
+        Flush();
+    }
+}
+
+void VRStreamRecorder::RecordEvent(vr::VROverlayHandle_t overlay_handle, const vr::VREvent_t& vr_event)
+{
+    if (!m_IsRecording)
+        return;
+
+    const uint32_t overlay_id = GetOverlayID(overlay_handle);
+
+    m_Writer.Write<uint8_t>(vrstream_record_event);
+    m_Writer.Write<uint32_t>(overlay_id);
+    m_Writer.Write(vr_event);
+}
+
+bool VRStreamRecording::LoadFromFile(const char* path)
+{
+    OverlayKeys.clear();
+    Frames.clear();
+
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.good())
+        return false;
+
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    BinaryReader reader(data.data(), data.size());
+
+    char magic[sizeof(g_VRStreamMagic)];
+    for (char& c : magic)
+    {
+        c = reader.Read<char>();
+    }
+
+    const uint32_t version    = reader.Read<uint32_t>();
+    const uint32_t event_size = reader.Read<uint32_t>();
+
+    if ( (reader.HasFailed()) || (memcmp(magic, g_VRStreamMagic, sizeof(g_VRStreamMagic)) != 0) || (version != g_VRStreamVersion) || (event_size != sizeof(vr::VREvent_t)) )
+        return false;
+
+    while (!reader.IsAtEnd())
+    {
+        const uint8_t record_type = reader.Read<uint8_t>();
+
+        switch (record_type)
+        {
+            case vrstream_record_overlay:
+            {
+                const uint32_t overlay_id = reader.Read<uint32_t>();
+                std::string key = reader.ReadString(vr::k_unVROverlayMaxKeyLength);
+
+                //IDs are assigned sequentially by the recorder
+                if ( (!reader.HasFailed()) && (overlay_id != OverlayKeys.size() + 1) )
+                    return false;
+
+                OverlayKeys.push_back(std::move(key));
+                break;
+            }
+            case vrstream_record_frame:
+            {
+                VRStreamFrame frame;
+                frame.TimestampUS = reader.Read<uint64_t>();
+                const uint8_t pose_count = reader.Read<uint8_t>();
+
+                for (uint8_t i = 0; i < pose_count; ++i)
+                {
+                    frame.Poses.push_back(reader.Read<VRStreamPose>());
+                }
+
+                if (!reader.HasFailed())
+                {
+                    Frames.push_back(std::move(frame));
+                }
+                break;
+            }
+            case vrstream_record_event:
+            {
+                VRStreamEvent stream_event;
+                stream_event.OverlayID = reader.Read<uint32_t>();
+                stream_event.Event     = reader.Read<vr::VREvent_t>();
+
+                if ( (!reader.HasFailed()) && ( (Frames.empty()) || (stream_event.OverlayID > OverlayKeys.size()) ) )
+                    return false;
+
+                if (!reader.HasFailed())
+                {
+                    Frames.back().Events.push_back(stream_event);
+                }
+                break;
+            }
+            default: return false;
+        }
+
+        //Truncated record at the end, likely from the recording process not exiting cleanly
+        if (reader.HasFailed())
+            break;
+    }
+
+    return true;
+}
+
+size_t VRStreamRecording::GetEventCount() const
+{
+    size_t count = 0;
+
+    for (const VRStreamFrame& frame : Frames)
+    {
+        count += frame.Events.size();
+    }
+
+    return count;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "openvr.h"
+#include "BinaryStream.h"
+
+//Recording of the OpenVR event and pose stream seen by the dashboard process, to reproduce input-dependent issues
+//VRStreamRecorder writes one frame per event handling pass (device poses that changed since the previous frame) followed by the events polled in that pass
+//VRStreamRecording loads such a file again
+//
+//File layout (native byte order, BinaryStream conventions):
+//  Header:  char[8] magic, uint32 version, uint32 sizeof(vr::VREvent_t)
+//  Records: uint8 type followed by
+//           vrstream_record_overlay: uint32 overlay ID, string overlay key              (declares the overlay before its first event)
+//           vrstream_record_frame:   uint64 timestamp in microseconds since recording start, uint8 pose count, VRStreamPose[pose count]
+//           vrstream_record_event:   uint32 overlay ID (0 for system events), vr::VREvent_t
+
+enum VRStreamRecordType : uint8_t
+{
+    vrstream_record_overlay,
+    vrstream_record_frame,
+    vrstream_record_event
+};
+
+struct VRStreamPose
+{
+    uint8_t DeviceIndex;
+    uint8_t DeviceClass;                    //vr::ETrackedDeviceClass
+    uint8_t ControllerRole;                 //vr::ETrackedControllerRole
+    uint8_t IsValid;
+    uint8_t IsConnected;
+    uint8_t Padding[3];
+    vr::HmdMatrix34_t DeviceToAbsoluteTracking;
+};
+
+struct VRStreamEvent
+{
+    uint32_t OverlayID;                     //Index + 1 into VRStreamRecording::OverlayKeys, 0 for system events
+    vr::VREvent_t Event;
+};
+
+struct VRStreamFrame
+{
+    uint64_t TimestampUS = 0;
+    std::vector<VRStreamPose> Poses;        //Only devices that changed since the previous frame
+    std::vector<VRStreamEvent> Events;
+};
+
+class VRStreamRecorder
+{
+    private:
+        std::ofstream m_File;
+        BinaryWriter m_Writer;              //Pending data, flushed to the file in chunks
+        bool m_IsRecording;
+        std::chrono::steady_clock::time_point m_StartTime;
+        std::vector<uint64_t> m_OverlayHandles; //Handle of each recorded overlay ID - 1
+        VRStreamPose m_LastPoses[vr::k_unMaxTrackedDeviceCount];
+
+        uint32_t GetOverlayID(vr::VROverlayHandle_t overlay_handle);
+        void Flush();
+
+    public:
+        VRStreamRecorder();
+        ~VRStreamRecorder();
+
+        bool Start(const char* path);
+        void Stop();
+        bool IsRecording() const;
+
+        //Records the current device poses, starting a new frame. Called once before polling the events of a pass
+        void RecordFrame();
+        //Records an event polled for the overlay, or a system event if the handle is vr::k_ulOverlayHandleInvalid
+        void RecordEvent(vr::VROverlayHandle_t overlay_handle, const vr::VREvent_t& vr_event);
+};
+
+class VRStreamRecording
+{
+    public:
+        std::vector<std::string> OverlayKeys;
+        std::vector<VRStreamFrame> Frames;
+
+        //Returns false if the file can't be read or isn't a valid recording. Frames of a truncated recording are kept up to the last complete record
+        bool LoadFromFile(const char* path);
+        size_t GetEventCount() const;
+};
@@ -0,0 +1,187 @@
+#include "TestCommon.h"
+
+#include "CustomActionSerialization.h"
+
+#include <string>
+#include <vector>
+
+//Compares syncing a custom action update from the UI to the dashboard app as one binary message with the per-field message sequence used before
+//Messages go through an in-process queue here, so this only measures encoding and decoding. The actual cost in the applications is dominated by
+//delivering each message to the other process, with strings sent as blocking WM_COPYDATA, which makes the message count the more important number
+
+enum BenchActionFunctionID
+{
+    bench_caction_press_keys,
+    bench_caction_type_string,
+    bench_caction_launch_application,
+    bench_caction_toggle_overlay_enabled_state,
+    bench_caction_toggle_overlay_group_enabled_state
+};
+
+struct BenchAction
+{
+    std::string Name;
+    BenchActionFunctionID FunctionType = bench_caction_press_keys;
+    unsigned char KeyCodes[3] = { 0 };
+    std::string StrMain;
+    std::string StrArg;
+    int IntID = 0;
+};
+
+//Stand-in for posted config messages and WM_COPYDATA strings
+struct LegacyMessage
+{
+    enum Type { type_action_current, type_action_current_sub, type_action_value_int, type_action_value_string } MessageType;
+    int Value;
+    std::string Data;
+};
+
+//What CustomAction::SendUpdateToDashboardApp() did before, the name wasn't sent
+static void LegacySend(std::vector<LegacyMessage>& queue, int id, const BenchAction& action)
+{
+    auto post = [&](LegacyMessage::Type type, int value){ queue.push_back({type, value, std::string()}); };
+    auto send = [&](const std::string& str){ queue.push_back({LegacyMessage::type_action_value_string, 0, str}); };
+
+    post(LegacyMessage::type_action_current, id);
+    post(LegacyMessage::type_action_current_sub, 1);
+    post(LegacyMessage::type_action_value_int, action.FunctionType);
+
+    switch (action.FunctionType)
+    {
+        case bench_caction_press_keys:
+        {
+            post(LegacyMessage::type_action_current_sub, 2);
+            post(LegacyMessage::type_action_value_int, action.KeyCodes[0]);
+            post(LegacyMessage::type_action_current_sub, 3);
+            post(LegacyMessage::type_action_value_int, action.KeyCodes[1]);
+            post(LegacyMessage::type_action_current_sub, 4);
+            post(LegacyMessage::type_action_value_int, action.KeyCodes[2]);
+            post(LegacyMessage::type_action_current_sub, 5);
+            post(LegacyMessage::type_action_value_int, action.IntID);
+            break;
+        }
+        case bench_caction_type_string:
+        {
+            post(LegacyMessage::type_action_current_sub, 2);
+            send(action.StrMain);
+            break;
+        }
+        case bench_caction_launch_application:
+        {
+            post(LegacyMessage::type_action_current_sub, 2);
+            send(action.StrMain);
+            post(LegacyMessage::type_action_current_sub, 3);
+            send(action.StrArg);
+            break;
+        }
+        case bench_caction_toggle_overlay_enabled_state:
+        {
+            post(LegacyMessage::type_action_current_sub, 2);
+            post(LegacyMessage::type_action_value_int, action.IntID);
+            break;
+        }
+        default: break;
+    }
+}
+
+//What the dashboard's handlers and CustomAction::ApplyIntFromConfig()/ApplyStringFromConfig() did before
+static void LegacyReceive(const std::vector<LegacyMessage>& queue, std::vector<BenchAction>& actions)
+{
+    int current = 0;
+    int current_sub = 0;
+
+    for (const LegacyMessage& msg : queue)
+    {
+        switch (msg.MessageType)
+        {
+            case LegacyMessage::type_action_current:     current     = msg.Value; break;
+            case LegacyMessage::type_action_current_sub: current_sub = msg.Value; break;
+            case LegacyMessage::type_action_value_int:
+            case LegacyMessage::type_action_value_string:
+            {
+                while (current >= (int)actions.size())
+                {
+                    actions.push_back(BenchAction());
+                }
+
+                BenchAction& action = actions[current];
+
+                if (msg.MessageType == LegacyMessage::type_action_value_int)
+                {
+                    if (current_sub == 1)
+                        action.FunctionType = (BenchActionFunctionID)msg.Value;
+                    else if ( (action.FunctionType == bench_caction_press_keys) && (current_sub < 5) )
+                        action.KeyCodes[current_sub - 2] = (unsigned char)msg.Value;
+                    else
+                        action.IntID = msg.Value;
+                }
+                else
+                {
+                    if (current_sub == 0)
+                        action.Name = msg.Data;
+                    else if (current_sub == 2)
+                        action.StrMain = msg.Data;
+                    else
+                        action.StrArg = msg.Data;
+                }
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t updates = (quick) ? 100 : 1000000;
+
+    //One action of each function type, updated in turns
+    std::vector<BenchAction> actions_source(5);
+    for (int i = 0; i < 5; ++i)
+    {
+        BenchAction& action = actions_source[i];
+        action.Name         = "Custom Action " + std::to_string(i);
+        action.FunctionType = (BenchActionFunctionID)i;
+        action.KeyCodes[0]  = 0x11;
+        action.KeyCodes[1]  = 0x43;
+        action.IntID        = i;
+        action.StrMain      = (i == bench_caction_launch_application) ? "C:\\Program Files\\Some Application\\Application.exe" : "Text to type";
+        action.StrArg       = "--argument";
+    }
+
+    std::vector<BenchAction> actions_legacy, actions_binary;
+    std::vector<LegacyMessage> queue;
+    uint64_t legacy_message_count = 0;
+    uint64_t binary_bytes = 0;
+
+    const double ns_legacy = BenchmarkNanoseconds(updates, [&](uint64_t i)
+    {
+        const int id = (int)(i % actions_source.size());
+
+        queue.clear();
+        LegacySend(queue, id, actions_source[id]);
+        LegacyReceive(queue, actions_legacy);
+
+        legacy_message_count += queue.size();
+    });
+
+    const double ns_binary = BenchmarkNanoseconds(updates, [&](uint64_t i)
+    {
+        const int id = (int)(i % actions_source.size());
+
+        BinaryWriter writer;
+        CustomActionSerialization::Write(writer, id, &actions_source[id], 1, id + 1);
+
+        //WM_COPYDATA copies the data into the receiving process
+        const std::string data = writer.GetBuffer();
+        g_BenchmarkSink = g_BenchmarkSink + CustomActionSerialization::Apply(actions_binary, data.data(), data.size(), bench_caction_toggle_overlay_group_enabled_state);
+
+        binary_bytes += data.size();
+    });
+
+    std::printf("%-10s %16s %16s %16s\n", "Method", "Update (ns)", "Messages", "Bytes");
+    std::printf("%-10s %16.1f %16.2f %16s\n", "Legacy", ns_legacy, (double)legacy_message_count / updates, "-");
+    std::printf("%-10s %16.1f %16.2f %16.1f\n", "Binary", ns_binary, 1.0, (double)binary_bytes / updates);
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "TestCommon.h"
+
+#include "ElevatedInputRing.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//Measures event throughput from a producer thread to a consumer thread through ElevatedInputRing and its doorbell
+//Compared with a locked queue that wakes the consumer for every event, which is roughly what posting one window message per event amounts to
+//Both only run in-process here. Across processes the ring stays the same, while every window message additionally goes through the kernel
+
+//Auto-reset event stand-in
+class BenchDoorbell
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_IsSet = false;
+
+    public:
+        void Set()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsSet = true;
+            m_Condition.notify_one();
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [&](){ return m_IsSet; });
+            m_IsSet = false;
+        }
+};
+
+struct BenchResult
+{
+    double NanosecondsPerEvent;
+    double WakeUpsPerEvent;
+};
+
+template<typename F> static double MeasureNanoseconds(F func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static BenchResult BenchRing(uint64_t event_count)
+{
+    std::unique_ptr<ElevatedInputRing> ring(new ElevatedInputRing());
+    BenchDoorbell doorbell;
+    uint64_t doorbell_count = 0;
+
+    const double ns = MeasureNanoseconds([&]()
+    {
+        std::thread producer([&]()
+        {
+            for (uint64_t i = 0; i < event_count;)
+            {
+                ElevatedInputEvent input_event = {};
+                input_event.ActionID = 1;
+                input_event.Value    = (int64_t)i;
+
+                bool needs_doorbell = false;
+                if (ring->Push(&input_event, 1, needs_doorbell))
+                {
+                    ++i;
+
+                    if (needs_doorbell)
+                    {
+                        doorbell.Set();
+                        doorbell_count++;
+                    }
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        ElevatedInputEvent events[64];
+        uint64_t received = 0;
+
+        while (received < event_count)
+        {
+            uint32_t count;
+            while ((count = ring->Pop(events, 64)) != 0)
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)events[i].Value;
+                }
+
+                received += count;
+            }
+
+            if (received < event_count)
+            {
+                doorbell.Wait();
+            }
+        }
+
+        producer.join();
+    });
+
+    return {ns / event_count, (double)doorbell_count / event_count};
+}
+
+static BenchResult BenchLockedQueue(uint64_t event_count)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<ElevatedInputEvent> queue;
+    uint64_t wake_count = 0;
+
+    const double ns = MeasureNanoseconds([&]()
+    {
+        std::thread producer([&]()
+        {
+            for (uint64_t i = 0; i < event_count; ++i)
+            {
+                ElevatedInputEvent input_event = {};
+                input_event.ActionID = 1;
+                input_event.Value    = (int64_t)i;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(input_event);
+                condition.notify_one();
+                wake_count++;
+            }
+        });
+
+        uint64_t received = 0;
+
+        while (received < event_count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&](){ return !queue.empty(); });
+
+            //One message at a time, like a message loop
+            g_BenchmarkSink = g_BenchmarkSink + (uint64_t)queue.front().Value;
+            queue.pop_front();
+            received++;
+        }
+
+        producer.join();
+    });
+
+    return {ns / event_count, (double)wake_count / event_count};
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t event_count = (quick) ? 10000 : 5000000;
+
+    const BenchResult result_queue = BenchLockedQueue(event_count);
+    const BenchResult result_ring  = BenchRing(event_count);
+
+    std::printf("%-14s %16s %16s %16s\n", "Method", "Event (ns)", "Events/s (M)", "Wake-ups/event");
+    std::printf("%-14s %16.1f %16.2f %16.3f\n", "Locked queue", result_queue.NanosecondsPerEvent, 1000.0 / result_queue.NanosecondsPerEvent, result_queue.WakeUpsPerEvent);
+    std::printf("%-14s %16.1f %16.2f %16.3f\n", "Ring",         result_ring.NanosecondsPerEvent,  1000.0 / result_ring.NanosecondsPerEvent,  result_ring.WakeUpsPerEvent);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "TestCommon.h"
+#include "GPUCounterNameList.h"
+
+#include "GPUCounterNameCache.h"
+
+#include <string>
+
+//Compares the cost of classifying all "\GPU Engine(*)\Utilization Percentage" items of one update
+
+//What Win32PerformanceData::Update() did before the cache, minus the Windows types
+static bool LegacyClassify(const wchar_t* name, long target_high, unsigned long target_low)
+{
+    std::wstring item_name(name);
+
+    if (item_name.find(L"_engtype_3D") == std::string::npos)
+        return false;
+
+    long high = 0;
+    unsigned long low = 0;
+    size_t pos = item_name.find(L"_0x");
+    if (pos != std::string::npos)
+    {
+        std::wstring str_high_part = item_name.substr(pos + 1, 10);
+
+        pos = item_name.find(L"_0x", pos + 1);
+        if (pos != std::string::npos)
+        {
+            std::wstring str_low_part = item_name.substr(pos + 1, 10);
+            high = (long)std::stoll(str_high_part, 0, 16);
+            low  = std::stoul(str_low_part, 0, 16);
+        }
+    }
+
+    return ( (high == target_high) && (low == target_low) );
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t updates = (quick) ? 2 : 200;
+
+    std::printf("%-10s %-8s %16s %16s %16s\n", "Processes", "Items", "Legacy (us)", "Parse (us)", "Cached (us)");
+
+    for (int process_count : {50, 200, 500})
+    {
+        GPUCounterNameList list;
+        list.Build(MakeGPUEngineCounterNames(process_count));
+        const size_t count = list.Names.size();
+
+        const double ns_legacy = BenchmarkNanoseconds(updates, [&](uint64_t)
+        {
+            uint64_t matches = 0;
+            for (const wchar_t* name : list.Names)
+            {
+                matches += LegacyClassify(name, 0, 0xD1E5);
+            }
+            g_BenchmarkSink = g_BenchmarkSink + matches;
+        });
+
+        const double ns_parse = BenchmarkNanoseconds(updates, [&](uint64_t)
+        {
+            uint64_t matches = 0;
+            for (const wchar_t* name : list.Names)
+            {
+                const GPUCounterInstanceInfo info = ParseGPUCounterInstanceName(name);
+                matches += ( (info.IsEngine3D) && (info.LUIDHighPart == 0) && (info.LUIDLowPart == 0xD1E5) );
+            }
+            g_BenchmarkSink = g_BenchmarkSink + matches;
+        });
+
+        GPUCounterNameCache cache;
+        const double ns_cached = BenchmarkNanoseconds(updates, [&](uint64_t)
+        {
+            uint64_t matches = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const GPUCounterInstanceInfo& info = cache.Get(i, list.Names[i]);
+                matches += ( (info.IsEngine3D) && (info.LUIDHighPart == 0) && (info.LUIDLowPart == 0xD1E5) );
+            }
+            cache.Trim(count);
+            g_BenchmarkSink = g_BenchmarkSink + matches;
+        });
+
+        std::printf("%-10d %-8zu %16.2f %16.2f %16.2f\n", process_count, count, ns_legacy / 1000.0, ns_parse / 1000.0, ns_cached / 1000.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "TestCommon.h"
+
+#include "GazeFadeEvaluator.h"
+#include "GazeFadeLegacy.h"
+
+#include <vector>
+
+//Measures a frame's worth of Gaze Fade evaluation for 1, 16 and 64 overlays
+//Legacy runs the old per-overlay math (Matrix4 copies and offset, one overlay at a time), the evaluator does all of them in one batch
+//Both include collecting the results, but not the OpenVR and ConfigManager calls the old code made per overlay, so the actual difference is larger
+
+struct BenchResult
+{
+    double LegacyNS;
+    double EvaluatorNS;
+};
+
+static BenchResult BenchOverlays(unsigned int overlay_count, uint64_t frame_count)
+{
+    TestRandom rng(overlay_count);
+
+    Matrix4 hmd_pose;
+    hmd_pose.translate(0.0f, 1.6f, 0.0f);
+    const GazeFadeHMDPose hmd_pose_batch = GazeFadeLegacy::ToHMDPose(hmd_pose);
+
+    std::vector<GazeFadeOverlay> overlays;
+    GazeFadeEvaluator evaluator;
+    std::vector<GazeFadeResult> results;
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        overlays.push_back({i + 1, rng.RangeFloat(-3.0f, 3.0f), rng.RangeFloat(-1.0f, 3.0f), rng.RangeFloat(-3.0f, 3.0f), 0.5f, 1.0f, 1.0f, 0.2f, 0.5f, false});
+    }
+
+    BenchResult result;
+
+    result.LegacyNS = BenchmarkNanoseconds(frame_count, [&](uint64_t)
+    {
+        results.clear();
+
+        for (const GazeFadeOverlay& overlay : overlays)
+        {
+            const float opacity = GazeFadeLegacy::Evaluate(hmd_pose, overlay);
+
+            if (opacity != overlay.OpacityCurrent)
+            {
+                results.push_back({overlay.OverlayID, opacity});
+            }
+        }
+
+        g_BenchmarkSink = g_BenchmarkSink + results.size();
+    });
+
+    //Filled every frame like OutputManager::DetachedOverlayGazeFadeAll() does
+    result.EvaluatorNS = BenchmarkNanoseconds(frame_count, [&](uint64_t)
+    {
+        evaluator.Clear();
+
+        for (const GazeFadeOverlay& overlay : overlays)
+        {
+            evaluator.Add(overlay);
+        }
+
+        evaluator.Evaluate(hmd_pose_batch, results);
+        g_BenchmarkSink = g_BenchmarkSink + results.size();
+    });
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t frame_count = (quick) ? 100 : 200000;
+
+    std::printf("%-14s %16s %16s %16s\n", "Overlays", "Legacy (ns)", "Evaluator (ns)", "Speedup");
+
+    for (unsigned int overlay_count : {1u, 16u, 64u})
+    {
+        const BenchResult result = BenchOverlays(overlay_count, frame_count);
+        std::printf("%-14u %16.1f %16.1f %15.2fx\n", overlay_count, result.LegacyNS, result.EvaluatorNS, result.LegacyNS / result.EvaluatorNS);
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "TestCommon.h"
+
+#include "HotkeyEngine.h"
+#include "HotkeyReference.h"
+
+#include <vector>
+
+//Measures the cost of one keystroke for 3, 64 and 256 random bindings, a mix of chords and 2-3 stroke sequences with half the scopes active
+//Linear goes through all bindings on every stroke like the reference matcher, the engine only looks at the children of the current sequence position
+//Also measures the per-frame UpdateActiveState() call OutputManager::HandleHotkeys() makes
+
+struct BenchResult
+{
+    double LinearNS;
+    double EngineNS;
+    double UpdateActiveNS;
+};
+
+static BenchResult BenchBindings(size_t binding_count, uint64_t stroke_count)
+{
+    TestRandom rng((uint32_t)binding_count);
+    std::vector<HotkeyBinding> bindings;
+
+    for (size_t i = 0; i < binding_count; ++i)
+    {
+        std::vector<HotkeyStroke> strokes;
+        const int length = rng.Range(1, 3);
+
+        for (int stroke_id = 0; stroke_id < length; ++stroke_id)
+        {
+            strokes.push_back(HotkeyReference::MakeStroke((uint8_t)rng.Range(0x30, 0x57), (uint8_t)rng.Range(0, hotkey_mod_mask)));
+        }
+
+        bindings.push_back(HotkeyReference::MakeBinding(strokes, (int)i, (HotkeyScope)rng.Range(0, hotkey_scope_MAX - 1), rng.Range(0, 7)));
+    }
+
+    //Strokes taken from the bindings so sequences actually get going
+    std::vector<HotkeyStroke> strokes;
+    for (int i = 0; i < 4096; ++i)
+    {
+        const HotkeyBinding& binding = bindings[rng.Range(0, (int)binding_count - 1)];
+        strokes.push_back(binding.Strokes[rng.Range(0, (int)binding.Strokes.size() - 1)]);
+    }
+
+    auto is_scope_active = [](HotkeyScope, int scope_id) { return (scope_id % 2 == 0); };
+
+    HotkeyEngine engine;
+    engine.SetBindings(bindings);
+    engine.UpdateActiveState(is_scope_active);
+
+    HotkeyReference::Matcher reference(bindings, HotkeyEngine::DefaultSequenceTimeout);
+    reference.UpdateActiveState(is_scope_active);
+
+    std::vector<size_t> triggered;
+    triggered.reserve(64);
+
+    BenchResult result;
+
+    result.LinearNS = BenchmarkNanoseconds(stroke_count, [&](uint64_t i)
+    {
+        reference.OnStroke(strokes[i % strokes.size()], i, triggered);
+        g_BenchmarkSink = g_BenchmarkSink + triggered.size();
+        triggered.clear();
+    });
+
+    result.EngineNS = BenchmarkNanoseconds(stroke_count, [&](uint64_t i)
+    {
+        engine.OnStroke(strokes[i % strokes.size()], i, triggered);
+        g_BenchmarkSink = g_BenchmarkSink + triggered.size();
+        triggered.clear();
+    });
+
+    //Flip the active scopes every so often so the node states actually change
+    result.UpdateActiveNS = BenchmarkNanoseconds(stroke_count / 10 + 1, [&](uint64_t i)
+    {
+        engine.UpdateActiveState([i](HotkeyScope, int scope_id) { return ((scope_id + i / 64) % 2 == 0); });
+        g_BenchmarkSink = g_BenchmarkSink + engine.GetStateID();
+    });
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t stroke_count = (quick) ? 100 : 1000000;
+
+    std::printf("%-14s %16s %16s %16s %16s\n", "Bindings", "Linear (ns)", "Engine (ns)", "Speedup", "Update (ns)");
+
+    for (size_t binding_count : {3u, 64u, 256u})
+    {
+        const BenchResult result = BenchBindings(binding_count, stroke_count);
+        std::printf("%-14zu %16.1f %16.1f %15.2fx %16.1f\n", binding_count, result.LinearNS, result.EngineNS, result.LinearNS / result.EngineNS, result.UpdateActiveNS);
+    }
+
+    return 0;
+}
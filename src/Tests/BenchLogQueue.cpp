@@ -0,0 +1,92 @@
+#include "TestCommon.h"
+
+#include "LogQueue.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+//Compares the cost of logging one message on the calling thread for short, typical and truncated message lengths
+//Legacy is WriteMessageToLog() from before the queue: line break replacement, timestamp and opening, appending to and closing the file for every message
+//Queue is LogQueue::Push(), which is all a logging thread pays now. The queue is emptied whenever it's full, which is included in the time
+
+static const char* const g_LogPath = "BenchLogQueue.log";
+
+struct BenchResult
+{
+    double LegacyNS;
+    double QueueNS;
+};
+
+static void LegacyWriteMessageToLog(const wchar_t* str)
+{
+    std::wstring wstr(str);
+    std::wstring nline(L"\r\n");
+    size_t start_pos = 0;
+    while ((start_pos = wstr.find(nline, start_pos)) != std::string::npos)
+    {
+        wstr.replace(start_pos, nline.length(), L" ");
+    }
+
+    start_pos = 0;
+    nline = L"\n";
+    while ((start_pos = wstr.find(nline, start_pos)) != std::string::npos)
+    {
+        wstr.replace(start_pos, nline.length(), L" ");
+    }
+
+    std::time_t t = std::time(nullptr);
+    std::tm tm = *std::localtime(&t);
+
+    std::wofstream err_log(g_LogPath, std::ios::app | std::ios::binary);
+    err_log << std::put_time(&tm, L"[%Y-%m-%d %H:%M] ") << wstr << L"\n";
+}
+
+static BenchResult BenchMessages(size_t length, uint64_t message_count)
+{
+    //System error strings come with CRLF at the end
+    const std::wstring text = std::wstring(length - 2, L'x') + L"\r\n";
+
+    BenchResult result;
+
+    std::remove(g_LogPath);
+    result.LegacyNS = BenchmarkNanoseconds(message_count, [&](uint64_t)
+    {
+        LegacyWriteMessageToLog(text.c_str());
+    });
+    std::remove(g_LogPath);
+
+    std::unique_ptr<LogQueue> queue(new LogQueue());
+    std::unique_ptr<LogEntry> entry(new LogEntry());
+
+    result.QueueNS = BenchmarkNanoseconds(message_count, [&](uint64_t i)
+    {
+        if (!queue->Push(log_severity_error, (int64_t)i, text.c_str()))
+        {
+            while (queue->Pop(*entry))
+            {
+                g_BenchmarkSink = g_BenchmarkSink + entry->Length;
+            }
+        }
+    });
+
+    g_BenchmarkSink = g_BenchmarkSink + queue->GetDroppedCount();
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t message_count = (quick) ? 10 : 20000;
+
+    std::printf("%-14s %16s %16s %16s\n", "Length", "Legacy (ns)", "Queue (ns)", "Speedup");
+
+    for (size_t length : {40u, 120u, 1000u})
+    {
+        const BenchResult result = BenchMessages(length, message_count);
+        std::printf("%-14zu %16.1f %16.1f %15.2fx\n", length, result.LegacyNS, result.QueueNS, result.LegacyNS / result.QueueNS);
+    }
+
+    return 0;
+}
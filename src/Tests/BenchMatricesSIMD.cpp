@@ -0,0 +1,88 @@
+#include "TestCommon.h"
+
+#include "MatricesSIMD.h"
+
+#include <vector>
+
+//Measures the SSE2 versions in MatricesSIMD.h against their scalar counterparts, which are the same code Matrix4 used before
+//Matrices are cycled through a small working set so the loops aren't just redoing the same calculation on constant input
+//Points are transformed in batches of 4096 and reported per point
+
+static const int g_MatrixCount = 64;
+
+struct BenchRow
+{
+    const char* Name;
+    double ScalarNS;
+    double SIMDNS;
+};
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t iterations = (quick) ? 10000 : 20000000;
+    const uint64_t point_iterations = (quick) ? 2 : 2000;
+
+    TestRandom rng(44);
+    std::vector<float> matrices(g_MatrixCount * 16), matrices_out(g_MatrixCount * 16);
+
+    for (int i = 0; i < g_MatrixCount; ++i)
+    {
+        float* m = &matrices[i * 16];
+
+        for (int j = 0; j < 16; ++j)
+        {
+            m[j] = rng.RangeFloat(-10.0f, 10.0f);
+        }
+
+        m[3] = m[7] = m[11] = 0.0f;
+        m[15] = 1.0f;
+    }
+
+    const float* b = &matrices[0];
+    BenchRow rows[4];
+
+    rows[0] = {"Multiply",
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4MultiplyScalar(&matrices[(i % g_MatrixCount) * 16], b, &matrices_out[(i % g_MatrixCount) * 16]); }),
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4Multiply(      &matrices[(i % g_MatrixCount) * 16], b, &matrices_out[(i % g_MatrixCount) * 16]); })};
+    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)matrices_out[5];
+
+    //Inverting in place, so every other iteration gets the original matrix back
+    rows[1] = {"InvertAffine",
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4InvertAffineScalar(&matrices[(i % g_MatrixCount) * 16]); }),
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4InvertAffine(      &matrices[(i % g_MatrixCount) * 16]); })};
+    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)matrices[5];
+
+    float v[4] = {1.0f, 2.0f, 3.0f, 1.0f}, v_out[4];
+    rows[2] = {"Vector4",
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4TransformVector4Scalar(&matrices[(i % g_MatrixCount) * 16], v, v_out); v[0] = v_out[0] * 0.001f; }),
+               BenchmarkNanoseconds(iterations, [&](uint64_t i){ matrix4TransformVector4(      &matrices[(i % g_MatrixCount) * 16], v, v_out); v[0] = v_out[0] * 0.001f; })};
+    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)v_out[1];
+
+    std::vector<float> points(4096 * 3), points_out(4096 * 3);
+    for (float& value : points)
+    {
+        value = rng.RangeFloat(-4.0f, 4.0f);
+    }
+
+    //Per point rather than per batch
+    rows[3] = {"Points",
+               BenchmarkNanoseconds(point_iterations, [&](uint64_t i){ matrix4TransformPointsScalar(&matrices[(i % g_MatrixCount) * 16], points.data(), points_out.data(), 4096); }) / 4096.0,
+               BenchmarkNanoseconds(point_iterations, [&](uint64_t i){ matrix4TransformPoints(      &matrices[(i % g_MatrixCount) * 16], points.data(), points_out.data(), 4096); }) / 4096.0};
+    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)points_out[7];
+
+    #ifdef DPLUS_MATH_SSE2
+        const char* simd_name = "SSE2 (ns)";
+    #else
+        const char* simd_name = "Fallback (ns)";
+    #endif
+
+    std::printf("%-14s %16s %16s %16s\n", "Operation", "Scalar (ns)", simd_name, "Speedup");
+
+    for (const BenchRow& row : rows)
+    {
+        std::printf("%-14s %16.2f %16.2f %15.2fx\n", row.Name, row.ScalarNS, row.SIMDNS, row.ScalarNS / row.SIMDNS);
+    }
+
+    return 0;
+}
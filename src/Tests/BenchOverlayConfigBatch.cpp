@@ -0,0 +1,149 @@
+#include "TestCommon.h"
+
+#include "OverlayConfigBatch.h"
+
+#include <string>
+#include <vector>
+
+//Compares toggling an overlay group of 64, 256 and 1024 overlays through an OverlayConfigBatch with the three posted config messages per overlay used before
+//Every other overlay is in the group. Messages go through an in-process queue here, so this only measures encoding, diffing and applying. The actual cost
+//in the applications is dominated by delivering each message to the other process, which makes the message count the more important number
+
+static const uint32_t g_ConfigKeyEnabled  = 1;
+static const uint32_t g_ConfigKeyGroupID  = 2;
+static const int      g_ConfigKeyCount    = 8;
+
+//Stand-in for posted ipcmsg_set_config messages
+struct LegacyMessage
+{
+    enum Type { type_current_id_override, type_enabled } MessageType;
+    int Value;
+};
+
+struct BenchResult
+{
+    double LegacyNS;
+    double BatchNS;
+    uint64_t LegacyMessages;
+    size_t BatchBytes;
+};
+
+static BenchResult BenchOverlays(uint32_t overlay_count, uint64_t toggle_count)
+{
+    //Overlay config values on both ends, ConfigKey is the index
+    std::vector<int32_t> config_dashboard(overlay_count * g_ConfigKeyCount, 0);
+    for (uint32_t i = 0; i < overlay_count; ++i)
+    {
+        config_dashboard[i * g_ConfigKeyCount + g_ConfigKeyGroupID] = (i % 2 == 0) ? 1 : 0;
+    }
+
+    std::vector<int32_t> config_ui = config_dashboard;
+    std::vector<LegacyMessage> queue;
+
+    BenchResult result;
+    result.LegacyMessages = 0;
+    result.BatchBytes = 0;
+
+    //What OutputManager::ToggleOverlayGroupEnabled() did before, plus the UI app's handling of the messages
+    result.LegacyNS = BenchmarkNanoseconds(toggle_count, [&](uint64_t)
+    {
+        queue.clear();
+
+        for (uint32_t i = 0; i < overlay_count; ++i)
+        {
+            int32_t* values = &config_dashboard[i * g_ConfigKeyCount];
+
+            if (values[g_ConfigKeyGroupID] == 1)
+            {
+                values[g_ConfigKeyEnabled] = !values[g_ConfigKeyEnabled];
+
+                queue.push_back({LegacyMessage::type_current_id_override, (int)i});
+                queue.push_back({LegacyMessage::type_enabled, values[g_ConfigKeyEnabled]});
+                queue.push_back({LegacyMessage::type_current_id_override, -1});
+            }
+        }
+
+        int current_id = -1;
+        for (const LegacyMessage& msg : queue)
+        {
+            if (msg.MessageType == LegacyMessage::type_current_id_override)
+                current_id = msg.Value;
+            else if (current_id != -1)
+                config_ui[current_id * g_ConfigKeyCount + g_ConfigKeyEnabled] = msg.Value;
+        }
+
+        result.LegacyMessages += queue.size();
+    });
+
+    //OutputManager::ToggleOverlayGroupEnabled() and CommitOverlayConfigBatch() now, plus UIManager::HandleIPCMessage()
+    result.BatchNS = BenchmarkNanoseconds(toggle_count, [&](uint64_t)
+    {
+        OverlayConfigBatch batch;
+
+        for (uint32_t i = 0; i < overlay_count; ++i)
+        {
+            const int32_t* values = &config_dashboard[i * g_ConfigKeyCount];
+
+            if (values[g_ConfigKeyGroupID] == 1)
+            {
+                batch.Set(i, g_ConfigKeyEnabled, !values[g_ConfigKeyEnabled]);
+            }
+        }
+
+        batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out)
+                   {
+                       if ( (overlay_id >= overlay_count) || (config_key >= (uint32_t)g_ConfigKeyCount) )
+                           return false;
+
+                       value_out = config_dashboard[overlay_id * g_ConfigKeyCount + config_key];
+                       return true;
+                   });
+
+        for (const OverlayConfigChange& change : batch.GetChanges())
+        {
+            config_dashboard[change.OverlayID * g_ConfigKeyCount + change.ConfigKey] = change.Value;
+        }
+
+        BinaryWriter writer;
+        batch.Serialize(writer);
+
+        //WM_COPYDATA copies the data into the receiving process
+        const std::string data = writer.GetBuffer();
+        OverlayConfigBatch batch_received;
+
+        if (batch_received.Deserialize(data.data(), data.size()))
+        {
+            for (const OverlayConfigChange& change : batch_received.GetChanges())
+            {
+                if (change.OverlayID < overlay_count)
+                {
+                    config_ui[change.OverlayID * g_ConfigKeyCount + change.ConfigKey] = change.Value;
+                }
+            }
+        }
+
+        result.BatchBytes = data.size();
+    });
+
+    g_BenchmarkSink = g_BenchmarkSink + (uint64_t)(config_ui == config_dashboard);
+    result.LegacyMessages /= toggle_count;
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t toggle_count = (quick) ? 10 : 20000;
+
+    std::printf("%-10s %16s %16s %16s %16s %16s\n", "Overlays", "Legacy (ns)", "Batch (ns)", "Speedup", "Legacy Messages", "Batch Bytes");
+
+    for (uint32_t overlay_count : {64u, 256u, 1024u})
+    {
+        const BenchResult result = BenchOverlays(overlay_count, toggle_count);
+        std::printf("%-10u %16.1f %16.1f %15.2fx %16llu %16zu\n", overlay_count, result.LegacyNS, result.BatchNS, result.LegacyNS / result.BatchNS,
+                    (unsigned long long)result.LegacyMessages, result.BatchBytes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "TestCommon.h"
+
+#include "PerformanceTrace.h"
+
+//Measures the cost of one PerformanceTraceScope around an empty block with tracing disabled and enabled
+//Disabled is what every traced code path pays while the Performance Monitor isn't tracing. Enabled includes the two timestamps and writing the event to the ring
+//The rings are drained every 1024 scopes like the collector would, which is included in the enabled time
+
+struct BenchResult
+{
+    double DisabledNS;
+    double EnabledNS;
+    double AddEventNS;
+};
+
+static BenchResult BenchScope(uint64_t scope_count)
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    BenchResult result;
+
+    PerformanceTrace::Get().SetEnabled(false);
+    result.DisabledNS = BenchmarkNanoseconds(scope_count, [&](uint64_t i)
+    {
+        PerformanceTraceScope trace_scope(perftrace_draw_frame);
+        g_BenchmarkSink = g_BenchmarkSink + i;
+    });
+
+    PerformanceTrace::Get().SetEnabled(true);
+    result.EnabledNS = BenchmarkNanoseconds(scope_count, [&](uint64_t i)
+    {
+        {
+            PerformanceTraceScope trace_scope(perftrace_draw_frame);
+            g_BenchmarkSink = g_BenchmarkSink + i;
+        }
+
+        if (i % 1024 == 1023)
+        {
+            PerformanceTrace::Get().Drain();
+        }
+    });
+
+    //Just the ring write, without taking the timestamps
+    result.AddEventNS = BenchmarkNanoseconds(scope_count, [&](uint64_t i)
+    {
+        PerformanceTrace::Get().AddEvent(perftrace_draw_frame, i, i + 1);
+
+        if (i % 1024 == 1023)
+        {
+            PerformanceTrace::Get().Drain();
+        }
+    });
+
+    PerformanceTrace::Get().Collect(stats);
+    PerformanceTrace::Get().SetEnabled(false);
+
+    g_BenchmarkSink = g_BenchmarkSink + stats[perftrace_draw_frame].Count;
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = IsBenchmarkQuick(argc, argv);
+    const uint64_t scope_count = (quick) ? 2048 : 10000000;
+
+    const BenchResult result = BenchScope(scope_count);
+
+    std::printf("%-14s %16s\n", "Scope", "Cost (ns)");
+    std::printf("%-14s %16.2f\n", "Disabled", result.DisabledNS);
+    std::printf("%-14s %16.2f\n", "Enabled", result.EnabledNS);
+    std::printf("%-14s %16.2f\n", "AddEvent only", result.AddEventNS);
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//Builds PDH-style counter name lists for the GPUCounterNameCache test and benchmark
+//Names are stored back to back in one buffer like PdhGetFormattedCounterArray() does, with Names pointing into it
+
+struct GPUCounterNameList
+{
+    std::vector<wchar_t> Buffer;
+    std::vector<const wchar_t*> Names;
+
+    void Build(const std::vector<std::wstring>& names)
+    {
+        Buffer.clear();
+        Names.clear();
+
+        for (const std::wstring& name : names)
+        {
+            Buffer.insert(Buffer.end(), name.begin(), name.end());
+            Buffer.push_back(L'\0');
+        }
+
+        size_t offset = 0;
+        for (const std::wstring& name : names)
+        {
+            Names.push_back(Buffer.data() + offset);
+            offset += name.size() + 1;
+        }
+    }
+
+    size_t GetBufferSize() const { return Buffer.size() * sizeof(wchar_t); }
+};
+
+//Same layout as a capture of "\GPU Engine(*)\Utilization Percentage" on a single GPU system, with a second adapter for some processes
+//Each process has the engines the driver exposes, of which only the 3D ones are counted
+inline std::vector<std::wstring> MakeGPUEngineCounterNames(int process_count, int pid_base = 1000)
+{
+    static const wchar_t* const engine_types[] = {L"3D", L"Copy", L"VideoDecode", L"VideoEncode", L"Compute_0", L"Compute_1", L"Security", L"VideoProcessing"};
+    std::vector<std::wstring> names;
+    wchar_t buffer[256];
+
+    for (int i = 0; i < process_count; ++i)
+    {
+        const unsigned int luid_low = (i % 5 == 0) ? 0x0000F1A2 : 0x0000D1E5;
+
+        for (int eng = 0; eng < (int)(sizeof(engine_types) / sizeof(engine_types[0])); ++eng)
+        {
+            std::swprintf(buffer, 256, L"pid_%d_luid_0x00000000_0x%08X_phys_0_eng_%d_engtype_%ls", pid_base + i * 4, luid_low, eng, engine_types[eng]);
+            names.push_back(buffer);
+        }
+    }
+
+    return names;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Matrices.h"
+#include "GazeFadeEvaluator.h"
+
+//Gaze Fade math as OutputManager::DetachedOverlayGazeFade() did it for one overlay at a time, for the GazeFadeEvaluator test and benchmark
+//Config values and hover state come from the GazeFadeOverlay instead of ConfigManager and OpenVR, everything else is unchanged
+
+namespace GazeFadeLegacy
+{
+    template <typename T> T clamp(const T& value, const T& value_min, const T& value_max)
+    {
+        return std::max(value_min, std::min(value, value_max));
+    }
+
+    //Same as in Util.cpp, which can't be built here
+    inline void OffsetTransformFromSelf(Matrix4& matrix, float offset_right, float offset_up, float offset_forward)
+    {
+        matrix[12] += offset_right * matrix[0];
+        matrix[13] += offset_right * matrix[1];
+        matrix[14] += offset_right * matrix[2];
+
+        matrix[12] += offset_up * matrix[4];
+        matrix[13] += offset_up * matrix[5];
+        matrix[14] += offset_up * matrix[6];
+
+        matrix[12] += offset_forward * matrix[8];
+        matrix[13] += offset_forward * matrix[9];
+        matrix[14] += offset_forward * matrix[10];
+    }
+
+    //Returns the new opacity
+    inline float Evaluate(const Matrix4& hmd_pose, const GazeFadeOverlay& overlay)
+    {
+        float gaze_distance = overlay.GazeDistance;
+        float fade_rate = overlay.FadeRate * 10.0f;
+
+        Matrix4 mat_pose = hmd_pose;
+        Matrix4 mat_overlay;
+        mat_overlay.translate(overlay.PosX, overlay.PosY, overlay.PosZ);
+
+        if (gaze_distance == 0.0f)
+        {
+            gaze_distance = mat_overlay.getTranslation().distance(mat_pose.getTranslation());
+        }
+        else
+        {
+            gaze_distance += 0.20f;
+        }
+
+        OffsetTransformFromSelf(mat_pose, 0.0f, 0.0f, -gaze_distance);
+
+        Vector3 pos_gaze = mat_pose.getTranslation();
+        float distance = mat_overlay.getTranslation().distance(pos_gaze);
+
+        gaze_distance = std::min(gaze_distance, 1.0f);
+
+        float alpha = clamp((distance * -fade_rate) + ((gaze_distance - 0.1f) * 10.0f), 0.0f, 1.0f);
+
+        const float max_alpha = overlay.OpacityMax;
+        const float min_alpha = overlay.OpacityMin;
+
+        if (overlay.IsHovered)
+        {
+            alpha = std::max(min_alpha, max_alpha);
+        }
+        else
+        {
+            const float range_length = max_alpha - min_alpha;
+
+            if (range_length >= 0.0f)
+            {
+                alpha = (alpha * range_length) + min_alpha;
+            }
+            else
+            {
+                alpha = ((alpha - 1.0f) * range_length) + max_alpha;
+            }
+        }
+
+        const float prev_alpha = overlay.OpacityCurrent;
+        const float diff = alpha - prev_alpha;
+
+        return prev_alpha + clamp(diff, -0.1f, 0.1f);
+    }
+
+    inline GazeFadeHMDPose ToHMDPose(const Matrix4& hmd_pose)
+    {
+        return {hmd_pose[12], hmd_pose[13], hmd_pose[14], hmd_pose[8], hmd_pose[9], hmd_pose[10]};
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "HotkeyEngine.h"
+
+//Reference matcher for the HotkeyEngine test and benchmark, along with helpers for setting up bindings
+//Follows the rules described in HotkeyEngine.h without the prefix tree, so every stroke goes through all bindings
+
+namespace HotkeyReference
+{
+    inline HotkeyStroke MakeStroke(uint8_t keycode, uint8_t modifiers = 0)
+    {
+        HotkeyStroke stroke;
+        stroke.KeyCode   = keycode;
+        stroke.Modifiers = modifiers;
+
+        return stroke;
+    }
+
+    inline HotkeyBinding MakeBinding(const std::vector<HotkeyStroke>& strokes, int action_id, HotkeyScope scope = hotkey_scope_global, int scope_id = -1)
+    {
+        HotkeyBinding binding;
+        binding.Strokes  = strokes;
+        binding.ActionID = action_id;
+        binding.Scope    = scope;
+        binding.ScopeID  = scope_id;
+
+        return binding;
+    }
+
+    //Straightforward version of the matching rules, checking all bindings on every stroke
+    class Matcher
+    {
+        private:
+            const std::vector<HotkeyBinding>& m_Bindings;
+            std::vector<bool> m_BindingActive;
+            std::vector<HotkeyStroke> m_Pending;
+            uint64_t m_LastStrokeTime = 0;
+            uint64_t m_SequenceTimeout;
+
+            bool IsStartOf(const std::vector<HotkeyStroke>& strokes, const HotkeyBinding& binding) const
+            {
+                return ( (binding.Strokes.size() >= strokes.size()) && (std::equal(strokes.begin(), strokes.end(), binding.Strokes.begin())) );
+            }
+
+            bool HasActiveBinding(const std::vector<HotkeyStroke>& strokes, bool longer_only) const
+            {
+                for (size_t i = 0; i < m_Bindings.size(); ++i)
+                {
+                    if ( (m_BindingActive[i]) && (IsStartOf(strokes, m_Bindings[i])) && ((!longer_only) || (m_Bindings[i].Strokes.size() > strokes.size())) )
+                        return true;
+                }
+
+                return false;
+            }
+
+            void Trigger(const std::vector<HotkeyStroke>& strokes, std::vector<size_t>& triggered_out) const
+            {
+                int scope_max = -1;
+                for (size_t i = 0; i < m_Bindings.size(); ++i)
+                {
+                    if ( (m_BindingActive[i]) && (m_Bindings[i].Strokes == strokes) )
+                    {
+                        scope_max = std::max(scope_max, (int)m_Bindings[i].Scope);
+                    }
+                }
+
+                for (size_t i = 0; i < m_Bindings.size(); ++i)
+                {
+                    if ( (m_BindingActive[i]) && (m_Bindings[i].Strokes == strokes) && ((int)m_Bindings[i].Scope == scope_max) )
+                    {
+                        triggered_out.push_back(i);
+                    }
+                }
+            }
+
+        public:
+            Matcher(const std::vector<HotkeyBinding>& bindings, uint64_t sequence_timeout) : m_Bindings(bindings), m_BindingActive(bindings.size(), true), 
+                                                                                                    m_SequenceTimeout(sequence_timeout) {}
+
+            template<typename F> void UpdateActiveState(F is_scope_active)
+            {
+                for (size_t i = 0; i < m_Bindings.size(); ++i)
+                {
+                    m_BindingActive[i] = ( (m_Bindings[i].Scope == hotkey_scope_global) || (is_scope_active(m_Bindings[i].Scope, m_Bindings[i].ScopeID)) );
+                }
+
+                if ( (!m_Pending.empty()) && (!HasActiveBinding(m_Pending, false)) )
+                {
+                    m_Pending.clear();
+                }
+            }
+
+            bool IsTimedOut(uint64_t time_ms) const { return ( (!m_Pending.empty()) && (time_ms - m_LastStrokeTime >= m_SequenceTimeout) ); }
+
+            bool OnStroke(HotkeyStroke stroke, uint64_t time_ms, std::vector<size_t>& triggered_out)
+            {
+                if (IsTimedOut(time_ms))
+                {
+                    Trigger(m_Pending, triggered_out);
+                    m_Pending.clear();
+                }
+
+                for (;;)
+                {
+                    std::vector<HotkeyStroke> strokes = m_Pending;
+                    strokes.push_back(stroke);
+
+                    if (HasActiveBinding(strokes, true))
+                    {
+                        m_Pending = strokes;
+                        m_LastStrokeTime = time_ms;
+                        return true;
+                    }
+                    else if (HasActiveBinding(strokes, false))
+                    {
+                        Trigger(strokes, triggered_out);
+                        m_Pending.clear();
+                        return true;
+                    }
+                    else if (!m_Pending.empty())
+                    {
+                        //Sequence broken, try again from the start
+                        Trigger(m_Pending, triggered_out);
+                        m_Pending.clear();
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+            }
+    };
+}
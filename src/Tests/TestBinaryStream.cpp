@@ -0,0 +1,145 @@
+#include "TestCommon.h"
+
+#include "BinaryStream.h"
+
+#include <string>
+#include <vector>
+
+static void TestRoundTrip()
+{
+    BinaryWriter writer;
+    writer.Write<uint8_t>(0xAB);
+    writer.Write<uint16_t>(1);
+    writer.WriteString("hello");
+    writer.Write<int32_t>(-5);
+    writer.WriteString("");
+    writer.Write<double>(0.25);
+    writer.WriteString(std::string("a\0b", 3));  //Embedded NUL is kept
+    writer.Write<uint64_t>(UINT64_MAX);
+
+    const std::string& buffer = writer.GetBuffer();
+    TEST_CHECK(buffer.size() == 1 + 2 + (4 + 5) + 4 + 4 + 8 + (4 + 3) + 8);
+
+    BinaryReader reader(buffer.data(), buffer.size());
+    TEST_CHECK(reader.Read<uint8_t>()  == 0xAB);
+    TEST_CHECK(reader.Read<uint16_t>() == 1);
+    TEST_CHECK(reader.ReadString(100)  == "hello");
+    TEST_CHECK(reader.Read<int32_t>()  == -5);
+    TEST_CHECK(reader.ReadString(0)    == "");
+    TEST_CHECK(reader.Read<double>()   == 0.25);
+    TEST_CHECK(reader.ReadString(3)    == std::string("a\0b", 3));
+    TEST_CHECK(reader.Read<uint64_t>() == UINT64_MAX);
+    TEST_CHECK(reader.IsAtEnd());
+    TEST_CHECK(!reader.HasFailed());
+
+    writer.Clear();
+    TEST_CHECK(writer.GetBuffer().empty());
+}
+
+static void TestFailures()
+{
+    //Reading past the end fails and stays failed, even for reads that would fit
+    const uint8_t data[] = {1, 2, 3};
+    BinaryReader reader(data, sizeof(data));
+    TEST_CHECK(reader.Read<uint32_t>() == 0);
+    TEST_CHECK(reader.HasFailed());
+    TEST_CHECK(reader.Read<uint8_t>() == 0);
+    TEST_CHECK(!reader.IsAtEnd());
+
+    //Null data is treated as empty
+    BinaryReader reader_null(nullptr, 100);
+    TEST_CHECK(reader_null.IsAtEnd());
+    reader_null.Read<uint8_t>();
+    TEST_CHECK(reader_null.HasFailed());
+
+    //String longer than the maximum
+    BinaryWriter writer;
+    writer.WriteString("too long");
+    BinaryReader reader_long(writer.GetBuffer().data(), writer.GetBuffer().size());
+    TEST_CHECK(reader_long.ReadString(7).empty());
+    TEST_CHECK(reader_long.HasFailed());
+
+    //String length pointing past the end
+    BinaryWriter writer_trunc;
+    writer_trunc.Write<uint32_t>(0xFFFFFFFF);
+    writer_trunc.Write<uint32_t>(0);
+    BinaryReader reader_trunc(writer_trunc.GetBuffer().data(), writer_trunc.GetBuffer().size());
+    TEST_CHECK(reader_trunc.ReadString(UINT32_MAX).empty());
+    TEST_CHECK(reader_trunc.HasFailed());
+}
+
+//Every truncation of valid data fails somewhere without reading out of bounds
+static void TestTruncation()
+{
+    BinaryWriter writer;
+    writer.Write<uint16_t>(7);
+    writer.WriteString("some string");
+    writer.Write<int32_t>(42);
+    writer.WriteString("x");
+
+    const std::string& buffer = writer.GetBuffer();
+
+    for (size_t size = 0; size < buffer.size(); ++size)
+    {
+        //Copy to an exactly sized allocation so out of bounds reads are caught by sanitizers
+        std::vector<char> data(buffer.begin(), buffer.begin() + size);
+        BinaryReader reader(data.data(), data.size());
+
+        reader.Read<uint16_t>();
+        reader.ReadString(100);
+        reader.Read<int32_t>();
+        reader.ReadString(100);
+
+        TEST_CHECK(reader.HasFailed());
+    }
+}
+
+//Random data and random reads. Reads must stay in bounds and the position only ever advances
+static void TestFuzz()
+{
+    TestRandom rng(36);
+
+    for (int iteration = 0; iteration < 100000; ++iteration)
+    {
+        std::vector<char> data(rng.Range(0, 40));
+        for (char& c : data)
+        {
+            //Bias towards small values so string lengths are often in range
+            c = (char)((rng.Next() % 4 == 0) ? rng.Next() : rng.Range(0, 8));
+        }
+
+        BinaryReader reader(data.data(), data.size());
+        size_t bytes_read = 0;
+
+        while (!reader.HasFailed())
+        {
+            switch (rng.Range(0, 3))
+            {
+                case 0: reader.Read<uint8_t>();  if (!reader.HasFailed()) bytes_read += 1; break;
+                case 1: reader.Read<uint32_t>(); if (!reader.HasFailed()) bytes_read += 4; break;
+                case 2: reader.Read<uint64_t>(); if (!reader.HasFailed()) bytes_read += 8; break;
+                case 3:
+                {
+                    std::string str = reader.ReadString(8);
+                    TEST_CHECK(str.size() <= 8);
+
+                    if (!reader.HasFailed())
+                        bytes_read += 4 + str.size();
+                    break;
+                }
+            }
+
+            TEST_CHECK(bytes_read <= data.size());
+        }
+    }
+}
+
+int main()
+{
+    TEST_RUN(TestRoundTrip);
+    TEST_RUN(TestFailures);
+    TEST_RUN(TestTruncation);
+    TEST_RUN(TestFuzz);
+
+    return TestResult();
+}
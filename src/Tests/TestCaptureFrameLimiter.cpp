@@ -0,0 +1,126 @@
+#include "TestCommon.h"
+
+#include "CaptureFrameLimiter.h"
+
+#include <cmath>
+#include <initializer_list>
+
+//Frame times are simulated, so these run deterministically and without waiting
+
+static void TestUnlimited()
+{
+    CaptureFrameLimiter limiter;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        TEST_CHECK(limiter.OnFrame(i * 16667));
+    }
+
+    TEST_CHECK(limiter.GetFramesDelivered() == 100);
+    TEST_CHECK(limiter.GetFramesDropped() == 0);
+}
+
+//Delivered rate has to match the target over a long run instead of drifting below it, with the source's frame timing jittering
+static void TestRateDoesNotDrift()
+{
+    TestRandom rng(3);
+
+    for (int source_rate : {60, 90, 144})
+    {
+        for (int target_rate : {10, 24, 30, 45})
+        {
+            CaptureFrameLimiter limiter;
+            limiter.SetInterval(1000000 / target_rate);
+
+            const double source_interval_us = 1000000.0 / source_rate;
+            const int frame_count = source_rate * 60;
+            int64_t frame_time_us = 0;
+
+            for (int i = 0; i < frame_count; ++i)
+            {
+                frame_time_us = (int64_t)(i * source_interval_us) + rng.Range(-500, 500);
+                limiter.OnFrame(frame_time_us);
+            }
+
+            const double delivered_rate = limiter.GetFramesDelivered() / (frame_time_us / 1000000.0);
+            //Source frames that don't line up with the target interval still average out to the target rate
+            TEST_CHECK(std::fabs(delivered_rate - target_rate) < target_rate * 0.01);
+            TEST_CHECK(limiter.GetFramesDelivered() + limiter.GetFramesDropped() == (uint64_t)frame_count);
+        }
+    }
+}
+
+static void TestEarlyFrameTolerance()
+{
+    CaptureFrameLimiter limiter;
+    limiter.SetInterval(33333);
+
+    TEST_CHECK(limiter.OnFrame(0));
+    //Well before the deadline
+    TEST_CHECK(!limiter.OnFrame(16667));
+    //Slightly early, accepted instead of pushing delivery out by a whole source frame
+    TEST_CHECK(limiter.OnFrame(33000));
+    TEST_CHECK(!limiter.OnFrame(50000));
+    TEST_CHECK(limiter.OnFrame(66666));
+
+    TEST_CHECK(limiter.GetFramesDelivered() == 3);
+    TEST_CHECK(limiter.GetFramesDropped() == 2);
+    TEST_CHECK(limiter.GetFramesLate() == 0);
+}
+
+static void TestLateAndResync()
+{
+    CaptureFrameLimiter limiter;
+    limiter.SetInterval(10000);
+
+    TEST_CHECK(limiter.OnFrame(0));
+
+    //Source stalled for a while (e.g. nothing changed in the window). The next frame is late and delivered
+    TEST_CHECK(limiter.OnFrame(1000000));
+    TEST_CHECK(limiter.GetFramesLate() == 1);
+
+    //Schedule resynced to the late frame instead of delivering a burst to catch up
+    TEST_CHECK(!limiter.OnFrame(1001000));
+    TEST_CHECK(!limiter.OnFrame(1002000));
+    TEST_CHECK(limiter.OnFrame(1010000));
+    TEST_CHECK(limiter.GetFramesLate() == 1);
+
+    limiter.ResetCounters();
+    TEST_CHECK( (limiter.GetFramesDelivered() == 0) && (limiter.GetFramesDropped() == 0) && (limiter.GetFramesLate() == 0) );
+}
+
+static void TestSetInterval()
+{
+    CaptureFrameLimiter limiter;
+    limiter.SetInterval(100000);
+
+    TEST_CHECK(limiter.OnFrame(0));
+    TEST_CHECK(!limiter.OnFrame(10000));
+
+    //Same interval keeps the schedule
+    limiter.SetInterval(100000);
+    TEST_CHECK(!limiter.OnFrame(20000));
+
+    //Changed interval always lets the next frame through
+    limiter.SetInterval(50000);
+    TEST_CHECK(limiter.GetInterval() == 50000);
+    TEST_CHECK(limiter.OnFrame(30000));
+    TEST_CHECK(!limiter.OnFrame(40000));
+    TEST_CHECK(limiter.OnFrame(80000));
+
+    //Back to unlimited
+    limiter.SetInterval(0);
+    TEST_CHECK(limiter.OnFrame(80001));
+    TEST_CHECK(limiter.OnFrame(80002));
+}
+
+int main()
+{
+    TEST_RUN(TestUnlimited);
+    TEST_RUN(TestRateDoesNotDrift);
+    TEST_RUN(TestEarlyFrameTolerance);
+    TEST_RUN(TestLateAndResync);
+    TEST_RUN(TestSetInterval);
+
+    return TestResult();
+}
@@ -0,0 +1,156 @@
+#include "TestCommon.h"
+
+#include "CaptureMetricsRegistry.h"
+
+#include <thread>
+
+static void TestSampleValues()
+{
+    CaptureMetricsRegistry registry;
+    std::shared_ptr<CaptureMetrics> metrics = registry.AddCapture(1, 0);
+    registry.SetCaptureOverlays(1, {100, 101});
+
+    CaptureMetricsSnapshot snapshot;
+    TEST_CHECK(!registry.GetOverlaySnapshot(100, snapshot));
+
+    for (int i = 0; i < 90; ++i)
+    {
+        metrics->RecordFrameDelivered();
+    }
+
+    for (int i = 0; i < 30; ++i)
+    {
+        metrics->RecordFrameDropped();
+    }
+
+    metrics->RecordConversion(100);
+    metrics->RecordConversion(300);
+    metrics->RecordLatency(5000);
+    metrics->RecordLatency(7000);
+    metrics->RecordLatency(9000);
+
+    //Too short of a period, skipped
+    registry.Sample(100000);
+    TEST_CHECK(!registry.GetOverlaySnapshot(100, snapshot));
+
+    registry.Sample(1500000);
+    TEST_CHECK(registry.GetOverlaySnapshot(101, snapshot));
+    TEST_CHECK(snapshot.FrameRate        == 60);
+    TEST_CHECK(snapshot.DroppedFrameRate == 20);
+    TEST_CHECK(snapshot.ConversionCount  == 2);
+    TEST_CHECK(snapshot.ConversionAvgUS  == 200);
+    TEST_CHECK(snapshot.ConversionMaxUS  == 300);
+    TEST_CHECK(snapshot.LatencyCount     == 3);
+    TEST_CHECK(snapshot.LatencyAvgUS     == 7000);
+    TEST_CHECK(snapshot.LatencyMaxUS     == 9000);
+
+    TEST_CHECK(!registry.GetOverlaySnapshot(102, snapshot));
+
+    //Values are reset by sampling
+    registry.Sample(2500000);
+    TEST_CHECK(registry.GetOverlaySnapshot(100, snapshot));
+    TEST_CHECK(snapshot.FrameRate       == 0);
+    TEST_CHECK(snapshot.LatencyCount    == 0);
+    TEST_CHECK(snapshot.LatencyAvgUS    == 0);
+    TEST_CHECK(snapshot.ConversionMaxUS == 0);
+}
+
+static void TestOverlaysAndRemoval()
+{
+    CaptureMetricsRegistry registry;
+    std::shared_ptr<CaptureMetrics> metrics_1 = registry.AddCapture(1, 0);
+    std::shared_ptr<CaptureMetrics> metrics_2 = registry.AddCapture(2, 0);
+
+    //Adding the same capture again returns the existing metrics
+    TEST_CHECK(registry.AddCapture(1, 0) == metrics_1);
+    TEST_CHECK(registry.GetCaptureCount() == 2);
+
+    registry.SetCaptureOverlays(1, {100});
+    registry.SetCaptureOverlays(2, {200});
+
+    metrics_1->RecordFrameDelivered();
+    metrics_2->RecordFrameDelivered();
+    metrics_2->RecordFrameDelivered();
+    registry.Sample(1000000);
+
+    CaptureMetricsSnapshot snapshot;
+    TEST_CHECK( (registry.GetOverlaySnapshot(100, snapshot)) && (snapshot.FrameRate == 1) );
+    TEST_CHECK( (registry.GetOverlaySnapshot(200, snapshot)) && (snapshot.FrameRate == 2) );
+
+    //Overlay moved to the other capture
+    registry.SetCaptureOverlays(1, {});
+    registry.SetCaptureOverlays(2, {200, 100});
+    TEST_CHECK( (registry.GetOverlaySnapshot(100, snapshot)) && (snapshot.FrameRate == 2) );
+
+    //Metrics stay usable for the capture after removal, but aren't reported anymore
+    registry.RemoveCapture(2);
+    metrics_2->RecordFrameDelivered();
+    TEST_CHECK(!registry.GetOverlaySnapshot(200, snapshot));
+    TEST_CHECK(registry.GetCaptureCount() == 1);
+
+    //Unknown captures are ignored
+    registry.SetCaptureOverlays(3, {300});
+    registry.RemoveCapture(3);
+    TEST_CHECK(!registry.GetOverlaySnapshot(300, snapshot));
+}
+
+//Sampling while a capture thread records must not lose or duplicate frames
+static void TestConcurrentRecording()
+{
+    CaptureMetricsRegistry registry;
+    std::shared_ptr<CaptureMetrics> metrics = registry.AddCapture(1, 0);
+    registry.SetCaptureOverlays(1, {100});
+
+    const int frame_count = 200000;
+    std::atomic<bool> is_done{false};
+
+    std::thread capture_thread([&]()
+    {
+        for (int i = 0; i < frame_count; ++i)
+        {
+            metrics->RecordFrameDelivered();
+            metrics->RecordLatency(i % 100);
+        }
+
+        is_done = true;
+    });
+
+    //One second periods, so the frame rate is the frame count of each period
+    CaptureMetricsSnapshot snapshot;
+    uint64_t now_us = 0;
+    uint64_t total_frames = 0;
+    uint64_t total_latency_samples = 0;
+
+    auto sample = [&]()
+    {
+        now_us += 1000000;
+        registry.Sample(now_us);
+
+        if (registry.GetOverlaySnapshot(100, snapshot))
+        {
+            total_frames += snapshot.FrameRate;
+            total_latency_samples += snapshot.LatencyCount;
+            TEST_CHECK(snapshot.LatencyMaxUS < 100);
+        }
+    };
+
+    while (!is_done)
+    {
+        sample();
+    }
+
+    capture_thread.join();
+    sample();
+
+    TEST_CHECK(total_frames == (uint64_t)frame_count);
+    TEST_CHECK(total_latency_samples == (uint64_t)frame_count);
+}
+
+int main()
+{
+    TEST_RUN(TestSampleValues);
+    TEST_RUN(TestOverlaysAndRemoval);
+    TEST_RUN(TestConcurrentRecording);
+
+    return TestResult();
+}
@@ -0,0 +1,104 @@
+#include "TestCommon.h"
+
+#include "CaptureTeardownQueue.h"
+
+#include <memory>
+#include <string>
+
+//Time is passed in by the tests, so the grace periods don't have to be waited out
+
+static void TestDueOrder()
+{
+    CaptureTeardownQueue<std::string> queue;
+    std::string object;
+
+    TEST_CHECK(queue.GetTimeUntilNextDue(0) == UINT64_MAX);
+    TEST_CHECK(!queue.PopDue(1000, object));
+
+    //Shorter grace period added later is due first
+    queue.Push("a", 0, 500);
+    queue.Push("b", 10, 20);
+    queue.Push("c", 20, 500);
+    TEST_CHECK(queue.GetSize() == 3);
+
+    TEST_CHECK(queue.GetTimeUntilNextDue(0) == 30);
+    TEST_CHECK(!queue.PopDue(29, object));
+    TEST_CHECK( (queue.PopDue(30, object)) && (object == "b") );
+
+    TEST_CHECK(queue.GetTimeUntilNextDue(100) == 400);
+    TEST_CHECK( (queue.PopDue(600, object)) && (object == "a") );
+    TEST_CHECK( (queue.PopDue(600, object)) && (object == "c") );
+    TEST_CHECK(!queue.PopDue(600, object));
+
+    TEST_CHECK(queue.GetSize() == 0);
+    TEST_CHECK(queue.GetTimeUntilNextDue(600) == UINT64_MAX);
+}
+
+//Objects with the same due time come out in the order they were added
+static void TestStableOrder()
+{
+    CaptureTeardownQueue<int> queue;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        queue.Push(std::move(i), i * 10, 500 - i * 10);
+    }
+
+    int object = -1;
+    for (int i = 0; i < 16; ++i)
+    {
+        TEST_CHECK( (queue.PopDue(500, object)) && (object == i) );
+    }
+}
+
+//Move-only objects, like the frame pools the queue is used for
+static void TestMoveOnly()
+{
+    CaptureTeardownQueue< std::unique_ptr<int> > queue;
+    queue.Push(std::make_unique<int>(42), 0, 100);
+
+    std::unique_ptr<int> object;
+    TEST_CHECK( (queue.PopDue(100, object)) && (object) && (*object == 42) );
+}
+
+static void TestLatencyHistogram()
+{
+    CaptureTeardownQueue<int> queue;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        queue.Push(std::move(i), 0, 0);
+    }
+
+    int value;
+    queue.PopDue(0,    value);  //0 ms
+    queue.PopDue(7,    value);  //7 ms
+    queue.PopDue(499,  value);  //499 ms
+    queue.PopDue(5000, value);  //5000 ms
+
+    const TeardownLatencyHistogram& histogram = queue.GetLatencyHistogram();
+    TEST_CHECK(histogram.GetCount() == 4);
+    TEST_CHECK(histogram.GetMaxMS() == 5000);
+    TEST_CHECK(histogram.GetBucket(0) == 1);
+    TEST_CHECK(histogram.GetBucket(2) == 1);
+    TEST_CHECK(histogram.GetBucket(7) == 1);
+    TEST_CHECK(histogram.GetBucket(TeardownLatencyHistogram::BucketCount - 1) == 1);
+
+    //Bucket bounds are exclusive
+    TeardownLatencyHistogram histogram_bounds;
+    histogram_bounds.Record(1);
+    histogram_bounds.Record(500);
+    TEST_CHECK(histogram_bounds.GetBucket(0) == 0);
+    TEST_CHECK(histogram_bounds.GetBucket(1) == 1);
+    TEST_CHECK(histogram_bounds.GetBucket(8) == 1);
+}
+
+int main()
+{
+    TEST_RUN(TestDueOrder);
+    TEST_RUN(TestStableOrder);
+    TEST_RUN(TestMoveOnly);
+    TEST_RUN(TestLatencyHistogram);
+
+    return TestResult();
+}
@@ -0,0 +1,224 @@
+#include "TestCommon.h"
+
+#include "CaptureWorkerScheduler.h"
+
+#include <map>
+
+//Feeds one second worth of processing time for each capture, load being microseconds of processing per second
+static void FeedLoads(CaptureWorkerScheduler& scheduler, std::map<unsigned int, uint64_t>& processing_totals, const std::map<unsigned int, uint64_t>& loads, uint64_t& now_us)
+{
+    now_us += 1000000;
+
+    for (const auto& capture_load : loads)
+    {
+        processing_totals[capture_load.first] += capture_load.second;
+        scheduler.UpdateCaptureProcessingTime(capture_load.first, processing_totals[capture_load.first], now_us);
+    }
+}
+
+static uint64_t GetMaxWorkerLoad(const CaptureWorkerScheduler& scheduler)
+{
+    uint64_t load_max = 0;
+
+    for (int i = 0; i < scheduler.GetWorkerCount(); ++i)
+    {
+        load_max = std::max(load_max, scheduler.GetWorkerLoad(i));
+    }
+
+    return load_max;
+}
+
+//Without observed load, captures are spread evenly
+static void TestAddSpreadsCaptures()
+{
+    CaptureWorkerScheduler scheduler;
+    scheduler.SetWorkerCount(3);
+
+    int capture_counts[3] = {0};
+    for (unsigned int capture_id = 1; capture_id <= 9; ++capture_id)
+    {
+        int worker_id = scheduler.AddCapture(capture_id, true);
+        TEST_CHECK( (worker_id >= 0) && (worker_id < 3) );
+        TEST_CHECK(scheduler.GetCaptureWorker(capture_id) == worker_id);
+
+        capture_counts[worker_id]++;
+    }
+
+    TEST_CHECK( (capture_counts[0] == 3) && (capture_counts[1] == 3) && (capture_counts[2] == 3) );
+    TEST_CHECK(scheduler.Rebalance().empty());
+
+    scheduler.RemoveCapture(5);
+    TEST_CHECK(scheduler.GetCaptureCount() == 8);
+    TEST_CHECK(scheduler.GetCaptureWorker(5) == -1);
+
+    //Invalid worker count is clamped
+    CaptureWorkerScheduler scheduler_single;
+    scheduler_single.SetWorkerCount(0);
+    TEST_CHECK(scheduler_single.GetWorkerCount() == 1);
+    TEST_CHECK(scheduler_single.AddCapture(1, true) == 0);
+}
+
+//Load only counts after two samples
+static void TestLoadSampling()
+{
+    CaptureWorkerScheduler scheduler;
+    scheduler.SetWorkerCount(2);
+    scheduler.AddCapture(1, true);
+
+    scheduler.UpdateCaptureProcessingTime(1, 0, 1000000);
+    TEST_CHECK(scheduler.GetWorkerLoad(0) == CaptureWorkerScheduler::DefaultCaptureLoad);
+
+    scheduler.UpdateCaptureProcessingTime(1, 20000, 2000000);
+    TEST_CHECK(scheduler.GetWorkerLoad(0) == 20000);
+
+    //Smoothed with the previous value
+    scheduler.UpdateCaptureProcessingTime(1, 30000, 3000000);
+    TEST_CHECK(scheduler.GetWorkerLoad(0) == 15000);
+
+    //Samples at the same time or with a lower total (restarted capture) don't produce a load, but become the new base
+    scheduler.UpdateCaptureProcessingTime(1, 40000, 3000000);
+    scheduler.UpdateCaptureProcessingTime(1, 0, 4000000);
+    TEST_CHECK(scheduler.GetWorkerLoad(0) == 15000);
+
+    //Unknown captures are ignored
+    scheduler.UpdateCaptureProcessingTime(2, 0, 5000000);
+    TEST_CHECK(scheduler.GetCaptureWorker(2) == -1);
+}
+
+static void TestRebalanceHeavyCapture()
+{
+    CaptureWorkerScheduler scheduler;
+    scheduler.SetWorkerCount(3);
+
+    for (unsigned int capture_id = 1; capture_id <= 6; ++capture_id)
+    {
+        scheduler.AddCapture(capture_id, true);
+    }
+
+    //Capture 1 and 4 share worker 0 and are heavy
+    std::map<unsigned int, uint64_t> loads = {{1, 200000}, {2, 1000}, {3, 1000}, {4, 100000}, {5, 1000}, {6, 1000}};
+    std::map<unsigned int, uint64_t> processing_totals;
+    uint64_t now_us = 0;
+
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+
+    TEST_CHECK(scheduler.GetCaptureWorker(1) == scheduler.GetCaptureWorker(4));
+    const uint64_t load_max_before = GetMaxWorkerLoad(scheduler);
+
+    std::vector<CaptureWorkerMove> moves = scheduler.Rebalance();
+    TEST_CHECK(!moves.empty());
+    TEST_CHECK(GetMaxWorkerLoad(scheduler) < load_max_before);
+    TEST_CHECK(scheduler.GetCaptureWorker(1) != scheduler.GetCaptureWorker(4));
+
+    for (const CaptureWorkerMove& move : moves)
+    {
+        TEST_CHECK(move.WorkerFrom != move.WorkerTo);
+        TEST_CHECK(scheduler.GetCaptureWorker(move.CaptureID) == move.WorkerTo);
+    }
+
+    //Balanced now, another call does nothing
+    TEST_CHECK(scheduler.Rebalance().empty());
+}
+
+//Captures that aren't movable stay where they are, even if it leaves the load unbalanced
+static void TestRebalanceNotMovable()
+{
+    CaptureWorkerScheduler scheduler;
+    scheduler.SetWorkerCount(2);
+
+    scheduler.AddCapture(1, false);
+    scheduler.AddCapture(2, true);
+    scheduler.AddCapture(3, false);
+
+    std::map<unsigned int, uint64_t> loads = {{1, 50000}, {2, 1000}, {3, 50000}};
+    std::map<unsigned int, uint64_t> processing_totals;
+    uint64_t now_us = 0;
+
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+
+    for (const CaptureWorkerMove& move : scheduler.Rebalance())
+    {
+        TEST_CHECK(move.CaptureID == 2);
+    }
+
+    TEST_CHECK(scheduler.GetCaptureWorker(1) == 0);
+    TEST_CHECK(scheduler.GetCaptureWorker(3) == 0);
+}
+
+//Small differences aren't worth restarting captures for
+static void TestRebalanceMinImbalance()
+{
+    CaptureWorkerScheduler scheduler;
+    scheduler.SetWorkerCount(2);
+    scheduler.AddCapture(1, true);
+    scheduler.AddCapture(2, true);
+    scheduler.AddCapture(3, true);
+
+    std::map<unsigned int, uint64_t> loads = {{1, 3000}, {2, 1000}, {3, 2500}};
+    std::map<unsigned int, uint64_t> processing_totals;
+    uint64_t now_us = 0;
+
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+    FeedLoads(scheduler, processing_totals, loads, now_us);
+
+    TEST_CHECK(scheduler.GetWorkerLoad(0) - scheduler.GetWorkerLoad(1) < CaptureWorkerScheduler::MinImbalance);
+    TEST_CHECK(scheduler.Rebalance().empty());
+}
+
+//Randomized loads never make the busiest worker busier and respect the move limit
+static void TestRebalanceRandom()
+{
+    TestRandom rng(11);
+
+    for (int iteration = 0; iteration < 200; ++iteration)
+    {
+        CaptureWorkerScheduler scheduler;
+        scheduler.SetWorkerCount(rng.Range(1, 8));
+
+        std::map<unsigned int, uint64_t> loads;
+        std::map<unsigned int, uint64_t> processing_totals;
+        uint64_t now_us = 0;
+
+        const int capture_count = rng.Range(0, 24);
+        for (int i = 1; i <= capture_count; ++i)
+        {
+            scheduler.AddCapture(i, (rng.Range(0, 3) != 0));
+            loads[i] = (uint64_t)rng.Range(0, 100000);
+        }
+
+        FeedLoads(scheduler, processing_totals, loads, now_us);
+        FeedLoads(scheduler, processing_totals, loads, now_us);
+
+        for (int round = 0; round < 4; ++round)
+        {
+            const uint64_t load_max_before = GetMaxWorkerLoad(scheduler);
+            const size_t max_moves = (size_t)rng.Range(1, 4);
+
+            std::vector<CaptureWorkerMove> moves = scheduler.Rebalance(max_moves);
+
+            TEST_CHECK(moves.size() <= max_moves);
+            TEST_CHECK(GetMaxWorkerLoad(scheduler) <= load_max_before);
+
+            for (const CaptureWorkerMove& move : moves)
+            {
+                TEST_CHECK( (move.WorkerTo >= 0) && (move.WorkerTo < scheduler.GetWorkerCount()) );
+            }
+        }
+
+        TEST_CHECK(scheduler.GetCaptureCount() == (size_t)capture_count);
+    }
+}
+
+int main()
+{
+    TEST_RUN(TestAddSpreadsCaptures);
+    TEST_RUN(TestLoadSampling);
+    TEST_RUN(TestRebalanceHeavyCapture);
+    TEST_RUN(TestRebalanceNotMovable);
+    TEST_RUN(TestRebalanceMinImbalance);
+    TEST_RUN(TestRebalanceRandom);
+
+    return TestResult();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+//Minimal checks and timing for the portable tests and benchmarks, so they don't need a test framework
+//Each test executable runs its test functions with TEST_RUN() and returns TestResult() from main()
+
+static int g_TestFailCount = 0;
+
+#define TEST_CHECK(expr)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(expr))                                                                    \
+        {                                                                               \
+            std::printf("%s:%d: Check failed: %s\n", __FILE__, __LINE__, #expr);        \
+            ++g_TestFailCount;                                                          \
+        }                                                                               \
+    } while (false)
+
+#define TEST_RUN(func)                                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        std::printf("%s\n", #func);                                                     \
+        func();                                                                         \
+    } while (false)
+
+inline int TestResult()
+{
+    if (g_TestFailCount != 0)
+    {
+        std::printf("%d check(s) failed\n", g_TestFailCount);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
+
+//Small deterministic random generator, so failures can be reproduced
+class TestRandom
+{
+    private:
+        uint64_t m_State;
+
+    public:
+        TestRandom(uint64_t seed = 0x2545F4914F6CDD1DULL) : m_State(seed) {}
+
+        uint32_t Next()
+        {
+            //xorshift64*
+            m_State ^= m_State >> 12;
+            m_State ^= m_State << 25;
+            m_State ^= m_State >> 27;
+            return (uint32_t)((m_State * 0x2545F4914F6CDD1DULL) >> 32);
+        }
+
+        //Inclusive range
+        int Range(int min, int max)
+        {
+            return min + (int)(Next() % (uint32_t)(max - min + 1));
+        }
+
+        float RangeFloat(float min, float max)
+        {
+            return min + (max - min) * ((float)(Next() >> 8) / (float)(1 << 24));
+        }
+};
+
+//Benchmarks get "--quick" from ctest, which should only run a few iterations
+inline bool IsBenchmarkQuick(int argc, char** argv)
+{
+    return ( (argc > 1) && (std::strcmp(argv[1], "--quick") == 0) );
+}
+
+//Keeps results from being optimized out
+static volatile uint64_t g_BenchmarkSink = 0;
+
+//Returns nanoseconds per iteration of func(iteration)
+template<typename F> double BenchmarkNanoseconds(uint64_t iterations, F func)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        func(i);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double)iterations;
+}
@@ -0,0 +1,205 @@
+#include "TestCommon.h"
+
+#include "CursorState.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//CursorState is a few MB with the preallocated shape storage, so it's kept on the heap
+static std::unique_ptr<CursorState> CreateState()
+{
+    return std::unique_ptr<CursorState>(new CursorState());
+}
+
+static void TestReadWrite()
+{
+    std::unique_ptr<CursorState> state = CreateState();
+    const uint8_t* shape_buffer = nullptr;
+
+    //Nothing published yet
+    const CursorStateData& data_initial = state->Read(shape_buffer);
+    TEST_CHECK( (data_initial.Sequence == 0) && (data_initial.ShapeSize == 0) && (data_initial.ShapeID == 0) );
+
+    {
+        CursorStateWriter writer(*state);
+        writer.GetData().PositionX = 10;
+        writer.GetData().PositionY = 20;
+        writer.GetData().Visible   = true;
+
+        uint8_t* shape = writer.BeginNewShape(4);
+        shape[0] = 1; shape[1] = 2; shape[2] = 3; shape[3] = 4;
+    }
+
+    const CursorStateData& data = state->Read(shape_buffer);
+    TEST_CHECK( (data.PositionX == 10) && (data.PositionY == 20) && (data.Visible) && (data.Sequence == 1) );
+    TEST_CHECK( (data.ShapeSize == 4) && (data.ShapeID != 0) && (shape_buffer[0] == 1) && (shape_buffer[3] == 4) );
+
+    //Position only, the shape is carried over into the slot used for this update
+    const uint32_t shape_id = data.ShapeID;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        CursorStateWriter writer(*state);
+        TEST_CHECK(writer.GetData().PositionY == 20);
+        writer.GetData().PositionX = 100 + i;
+    }
+
+    const CursorStateData& data_moved = state->Read(shape_buffer);
+    TEST_CHECK( (data_moved.PositionX == 104) && (data_moved.PositionY == 20) && (data_moved.Sequence == 6) );
+    TEST_CHECK( (data_moved.ShapeID == shape_id) && (data_moved.ShapeSize == 4) && (shape_buffer[0] == 1) && (shape_buffer[3] == 4) );
+
+    //Reading again without an update returns the same
+    const CursorStateData& data_again = state->Read(shape_buffer);
+    TEST_CHECK(data_again.Sequence == 6);
+
+    //Two reads picked up updates, 4 of the 5 moves were replaced before being read
+    const CursorStateMetrics metrics = state->GetMetrics();
+    TEST_CHECK( (metrics.PublishCount == 6) && (metrics.ReadCount == 2) && (metrics.CoalescedCount == 4) );
+    TEST_CHECK( (metrics.WriterContentionCount == 0) && (metrics.ShapeGrowCount == 0) );
+
+    state->Reset();
+    const CursorStateData& data_reset = state->Read(shape_buffer);
+    TEST_CHECK( (data_reset.Sequence == 0) && (data_reset.ShapeSize == 0) && (data_reset.PositionX == 0) );
+}
+
+static void TestLargeShape()
+{
+    std::unique_ptr<CursorState> state = CreateState();
+    const uint8_t* shape_buffer = nullptr;
+    const uint32_t size = CursorState::ShapeReserveSize * 2;
+
+    {
+        CursorStateWriter writer(*state);
+        uint8_t* shape = writer.BeginNewShape(size);
+        shape[0] = 7;
+        shape[size - 1] = 9;
+    }
+
+    const CursorStateData& data = state->Read(shape_buffer);
+    TEST_CHECK( (data.ShapeSize == size) && (shape_buffer[0] == 7) && (shape_buffer[size - 1] == 9) );
+    TEST_CHECK(state->GetMetrics().ShapeGrowCount == 1);
+
+    //Each slot grows once as the shape is carried over into it
+    for (int i = 0; i < 4; ++i)
+    {
+        CursorStateWriter writer(*state);
+        writer.GetData().PositionX = i;
+    }
+
+    const CursorStateData& data_moved = state->Read(shape_buffer);
+    TEST_CHECK( (data_moved.ShapeSize == size) && (shape_buffer[0] == 7) && (shape_buffer[size - 1] == 9) );
+    TEST_CHECK(state->GetMetrics().ShapeGrowCount == 3);
+
+    //Back to no shape
+    {
+        CursorStateWriter writer(*state);
+        writer.BeginNewShape(0);
+    }
+
+    TEST_CHECK(state->Read(shape_buffer).ShapeSize == 0);
+}
+
+//Several writers like the duplication threads of multiple outputs, one reader like the main thread
+//Every published state has to be consistent: position, shape info and shape buffer all from the same update
+static void TestStress()
+{
+    std::unique_ptr<CursorState> state = CreateState();
+    const int writer_count = 4;
+    const int update_count = 20000;
+    std::atomic<int> writers_done{0};
+    std::vector<std::thread> threads;
+
+    for (int writer_id = 0; writer_id < writer_count; ++writer_id)
+    {
+        threads.emplace_back([&, writer_id]()
+        {
+            for (int i = 1; i <= update_count; ++i)
+            {
+                CursorStateWriter writer(*state);
+                CursorStateData& data = writer.GetData();
+
+                //Updates build on the previous state no matter which writer made it
+                data.LastTimeStamp++;
+
+                if (i % 16 == 0)
+                {
+                    const uint32_t size = 64 + (i % 7) * 1024 + ((i % 997 == 0) ? CursorState::ShapeReserveSize : 0);
+                    uint8_t* shape = writer.BeginNewShape(size);
+                    std::memset(shape, (uint8_t)data.ShapeID, size);
+
+                    data.ShapeInfo.Width = size;
+                    data.ShapeInfo.Pitch = (uint8_t)data.ShapeID;
+                }
+
+                //Tied to the shape so the reader can check they belong together
+                data.PositionX = (int32_t)data.ShapeID * 3;
+                data.PositionY = writer_id;
+                data.WhoUpdatedPositionLast = writer_id;
+
+                if (i % 64 == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            writers_done++;
+        });
+    }
+
+    bool is_consistent = true, is_ordered = true;
+    uint64_t sequence_last = 0, update_read_count = 0;
+    const uint8_t* shape_buffer = nullptr;
+
+    auto check_read = [&]()
+    {
+        const CursorStateData& data = state->Read(shape_buffer);
+
+        is_ordered &= (data.Sequence >= sequence_last);
+        update_read_count += (data.Sequence != sequence_last);
+        sequence_last = data.Sequence;
+
+        is_consistent &= ( (data.Sequence == 0) || ((uint64_t)data.LastTimeStamp == data.Sequence) );
+
+        if (data.ShapeID != 0)
+        {
+            const uint8_t fill = (uint8_t)data.ShapeID;
+
+            is_consistent &= ( (data.PositionX == (int32_t)data.ShapeID * 3) && (data.ShapeSize == data.ShapeInfo.Width) && (data.ShapeInfo.Pitch == fill) );
+            is_consistent &= ( (shape_buffer[0] == fill) && (shape_buffer[data.ShapeSize / 2] == fill) && (shape_buffer[data.ShapeSize - 1] == fill) );
+        }
+    };
+
+    while (writers_done.load() != writer_count)
+    {
+        check_read();
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    //Final state
+    check_read();
+
+    TEST_CHECK(is_consistent);
+    TEST_CHECK(is_ordered);
+    TEST_CHECK(sequence_last == (uint64_t)writer_count * update_count);
+
+    //Every update was either read or replaced by a newer one
+    const CursorStateMetrics metrics = state->GetMetrics();
+    TEST_CHECK(metrics.PublishCount == (uint64_t)writer_count * update_count);
+    TEST_CHECK(metrics.ReadCount + metrics.CoalescedCount == metrics.PublishCount);
+    TEST_CHECK(metrics.ReadCount == update_read_count);
+}
+
+int main()
+{
+    TEST_RUN(TestReadWrite);
+    TEST_RUN(TestLargeShape);
+    TEST_RUN(TestStress);
+
+    return TestResult();
+}
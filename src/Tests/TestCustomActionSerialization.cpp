@@ -0,0 +1,244 @@
+#include "TestCommon.h"
+
+#include "CustomActionSerialization.h"
+
+#include <string>
+#include <vector>
+
+//Stand-in for CustomAction, which can't be included without Windows headers. Same serialized members plus some process-specific state
+enum TestActionFunctionID
+{
+    test_caction_press_keys,
+    test_caction_type_string,
+    test_caction_launch_application,
+    test_caction_toggle_overlay_enabled_state,
+    test_caction_toggle_overlay_group_enabled_state
+};
+
+struct TestAction
+{
+    std::string Name;
+    TestActionFunctionID FunctionType = test_caction_press_keys;
+    unsigned char KeyCodes[3] = { 0 };
+    std::string StrMain;
+    std::string StrArg;
+    int IntID = 0;
+
+    int IconImGuiRectID = -1;
+
+    bool operator==(const TestAction& b) const
+    {
+        return ( (Name == b.Name) && (FunctionType == b.FunctionType) && (memcmp(KeyCodes, b.KeyCodes, sizeof(KeyCodes)) == 0) && (StrMain == b.StrMain) &&
+                 (StrArg == b.StrArg) && (IntID == b.IntID) && (IconImGuiRectID == b.IconImGuiRectID) );
+    }
+};
+
+static const int g_FunctionTypeMax = test_caction_toggle_overlay_group_enabled_state;
+
+static std::string RandomString(TestRandom& rng, int length_max)
+{
+    std::string str(rng.Range(0, length_max), '\0');
+
+    for (char& c : str)
+    {
+        c = (char)rng.Range(1, 255);
+    }
+
+    return str;
+}
+
+static TestAction RandomAction(TestRandom& rng)
+{
+    TestAction action;
+    action.Name         = RandomString(rng, 24);
+    action.FunctionType = (TestActionFunctionID)rng.Range(0, g_FunctionTypeMax);
+    action.KeyCodes[0]  = (unsigned char)rng.Range(0, 255);
+    action.KeyCodes[1]  = (unsigned char)rng.Range(0, 255);
+    action.KeyCodes[2]  = (unsigned char)rng.Range(0, 255);
+    action.StrMain      = RandomString(rng, 64);
+    action.StrArg       = RandomString(rng, 16);
+    action.IntID        = (int)rng.Next();
+
+    return action;
+}
+
+static std::string Serialize(int first_id, const std::vector<TestAction>& actions, size_t list_size)
+{
+    BinaryWriter writer;
+    CustomActionSerialization::Write(writer, first_id, actions.data(), (int)actions.size(), list_size);
+
+    return writer.GetBuffer();
+}
+
+static void TestRoundTrip()
+{
+    TestRandom rng(36);
+
+    for (int iteration = 0; iteration < 500; ++iteration)
+    {
+        std::vector<TestAction> actions_source(rng.Range(0, 8));
+        for (TestAction& action : actions_source)
+        {
+            action = RandomAction(rng);
+        }
+
+        const int first_id = rng.Range(0, 4);
+        const size_t list_size = first_id + actions_source.size() + rng.Range(0, 2);
+
+        std::vector<TestAction> actions(rng.Range(0, 12));
+        for (size_t i = 0; i < actions.size(); ++i)
+        {
+            actions[i].IconImGuiRectID = (int)i;
+        }
+
+        const std::vector<TestAction> actions_before = actions;
+        const std::string data = Serialize(first_id, actions_source, list_size);
+
+        TEST_CHECK(CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+        //Grows to the list size, but never shrinks
+        TEST_CHECK(actions.size() == std::max(actions_before.size(), list_size));
+
+        for (size_t i = 0; i < actions.size(); ++i)
+        {
+            const bool is_updated = ( (i >= (size_t)first_id) && (i < first_id + actions_source.size()) );
+
+            if (is_updated)
+            {
+                //Serialized members come from the update, the rest stays
+                TestAction action_expected = actions_source[i - first_id];
+                action_expected.IconImGuiRectID = (i < actions_before.size()) ? actions_before[i].IconImGuiRectID : -1;
+
+                TEST_CHECK(actions[i] == action_expected);
+            }
+            else if (i < actions_before.size())
+            {
+                TEST_CHECK(actions[i] == actions_before[i]);
+            }
+            else
+            {
+                TEST_CHECK(actions[i] == TestAction());
+            }
+        }
+    }
+}
+
+static void TestInvalidHeader()
+{
+    std::vector<TestAction> actions(2);
+    actions[0].Name = "Keep";
+    const std::vector<TestAction> actions_before = actions;
+
+    std::vector<TestAction> actions_source(1);
+    std::string data;
+
+    //Update past the list size
+    data = Serialize(2, actions_source, 2);
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //Negative ID
+    data = Serialize(-1, actions_source, 2);
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //List too large
+    data = Serialize(0, actions_source, CustomActionSerialization::MaxCount + 1);
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //Different version
+    data = Serialize(0, actions_source, 1);
+    data[0]++;
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //Trailing data
+    data = Serialize(0, actions_source, 1) + '\0';
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //String over the length limit
+    actions_source[0].StrMain.assign(CustomActionSerialization::MaxStringLength + 1, 'a');
+    data = Serialize(0, actions_source, 1);
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+
+    //Empty
+    TEST_CHECK(!CustomActionSerialization::Apply(actions, nullptr, 0, g_FunctionTypeMax));
+
+    TEST_CHECK(actions.size() == actions_before.size());
+    TEST_CHECK( (actions[0] == actions_before[0]) && (actions[1] == actions_before[1]) );
+}
+
+static void TestUnknownFunctionType()
+{
+    std::vector<TestAction> actions_source(1);
+    actions_source[0].FunctionType = (TestActionFunctionID)(g_FunctionTypeMax + 1);
+    actions_source[0].IntID = 5;
+
+    std::vector<TestAction> actions;
+    const std::string data = Serialize(0, actions_source, 1);
+
+    TEST_CHECK(CustomActionSerialization::Apply(actions, data.data(), data.size(), g_FunctionTypeMax));
+    TEST_CHECK(actions[0].FunctionType == test_caction_press_keys);
+    TEST_CHECK(actions[0].IntID == 5);
+}
+
+//Truncated and randomly corrupted updates are either applied completely or not at all
+static void TestFuzz()
+{
+    TestRandom rng(360);
+
+    for (int iteration = 0; iteration < 20000; ++iteration)
+    {
+        std::vector<TestAction> actions_source(rng.Range(1, 4));
+        for (TestAction& action : actions_source)
+        {
+            action = RandomAction(rng);
+        }
+
+        std::string data = Serialize(rng.Range(0, 2), actions_source, rng.Range(0, 8));
+
+        if (rng.Range(0, 1) == 0)
+        {
+            data.resize(rng.Range(0, (int)data.size()));
+        }
+
+        const int corrupt_count = rng.Range(0, 4);
+        for (int i = 0; (i < corrupt_count) && (!data.empty()); ++i)
+        {
+            data[rng.Range(0, (int)data.size() - 1)] = (char)rng.Range(0, 255);
+        }
+
+        std::vector<TestAction> actions(rng.Range(0, 4));
+        const std::vector<TestAction> actions_before = actions;
+
+        //Exactly sized copy so out of bounds reads are caught by sanitizers
+        std::vector<char> data_copy(data.begin(), data.end());
+
+        if (CustomActionSerialization::Apply(actions, data_copy.data(), data_copy.size(), g_FunctionTypeMax))
+        {
+            for (const TestAction& action : actions)
+            {
+                TEST_CHECK( (action.FunctionType >= 0) && (action.FunctionType <= g_FunctionTypeMax) );
+                TEST_CHECK(action.StrMain.size() <= CustomActionSerialization::MaxStringLength);
+            }
+
+            TEST_CHECK(actions.size() <= CustomActionSerialization::MaxCount);
+        }
+        else
+        {
+            TEST_CHECK(actions.size() == actions_before.size());
+
+            for (size_t i = 0; i < actions.size(); ++i)
+            {
+                TEST_CHECK(actions[i] == actions_before[i]);
+            }
+        }
+    }
+}
+
+int main()
+{
+    TEST_RUN(TestRoundTrip);
+    TEST_RUN(TestInvalidHeader);
+    TEST_RUN(TestUnknownFunctionType);
+    TEST_RUN(TestFuzz);
+
+    return TestResult();
+}
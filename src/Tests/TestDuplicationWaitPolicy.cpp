@@ -0,0 +1,277 @@
+#include "TestCommon.h"
+
+#include "DuplicationWaitPolicy.h"
+
+#include <thread>
+#include <vector>
+
+static const DuplicationWaitRect g_OutputLeft  = {0,    0, 1920, 1080};
+static const DuplicationWaitRect g_OutputRight = {1920, 0, 3840, 1080};
+
+static void TestAcquireTimeout()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state;
+    state.SetOutputRect(g_OutputLeft);
+
+    //Visible until told otherwise, fast timeout for a moment after the first evaluation
+    DuplicationWaitStep step = policy.GetNextStep(state, 1000);
+    TEST_CHECK(state.IsVisible());
+    TEST_CHECK( (step.IdleMS == 0) && (step.AcquireTimeoutMS == g_DuplWaitAcquireTimeoutFastMS) );
+
+    step = policy.GetNextStep(state, 1000 + g_DuplWaitFastDurationMS - 1);
+    TEST_CHECK(step.AcquireTimeoutMS == g_DuplWaitAcquireTimeoutFastMS);
+
+    step = policy.GetNextStep(state, 1000 + g_DuplWaitFastDurationMS);
+    TEST_CHECK(step.AcquireTimeoutMS == g_DuplWaitAcquireTimeoutMS);
+
+    //Any change starts the fast period again
+    policy.Wake();
+    step = policy.GetNextStep(state, 5000);
+    TEST_CHECK(step.AcquireTimeoutMS == g_DuplWaitAcquireTimeoutFastMS);
+}
+
+static void TestVisibility()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state_left, state_right;
+    state_left.SetOutputRect(g_OutputLeft);
+    state_right.SetOutputRect(g_OutputRight);
+
+    //Only actual changes count
+    TEST_CHECK(policy.SetVisibleRects({{100, 100, 500, 500}}, false));
+    TEST_CHECK(!policy.SetVisibleRects({{100, 100, 500, 500}}, false));
+
+    policy.GetNextStep(state_left, 0);
+    policy.GetNextStep(state_right, 0);
+    TEST_CHECK(state_left.IsVisible());
+    TEST_CHECK(!state_right.IsVisible());
+
+    //Touching edges don't overlap
+    policy.SetVisibleRects({{1000, 0, 1920, 1080}}, false);
+    policy.GetNextStep(state_right, 0);
+    TEST_CHECK(!state_right.IsVisible());
+
+    policy.SetVisibleRects({{1000, 0, 1921, 1080}}, false);
+    policy.GetNextStep(state_right, 0);
+    TEST_CHECK(state_right.IsVisible());
+
+    //Everything visible regardless of the rects
+    policy.SetVisibleRects({}, true);
+    policy.GetNextStep(state_left, 0);
+    policy.GetNextStep(state_right, 0);
+    TEST_CHECK( (state_left.IsVisible()) && (state_right.IsVisible()) );
+
+    policy.SetVisibleRects({}, false);
+    policy.GetNextStep(state_left, 0);
+    TEST_CHECK(!state_left.IsVisible());
+
+    //Moving the output is picked up without a policy change
+    policy.SetVisibleRects({{0, 2000, 10, 2010}}, false);
+    policy.GetNextStep(state_left, 0);
+    TEST_CHECK(!state_left.IsVisible());
+    state_left.SetOutputRect({0, 1080, 1920, 2160});
+    policy.GetNextStep(state_left, 0);
+    TEST_CHECK(state_left.IsVisible());
+}
+
+static void TestBackoff()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state;
+    state.SetOutputRect(g_OutputRight);
+    policy.SetVisibleRects({g_OutputLeft}, false);
+
+    //Idle wait, then a poll without timeout, doubling the wait after every poll up to the maximum
+    uint32_t backoff_expected = g_DuplWaitBackoffMinMS;
+    for (int i = 0; i < 10; ++i)
+    {
+        DuplicationWaitStep step = policy.GetNextStep(state, 0);
+        TEST_CHECK( (step.IdleMS == backoff_expected) && (step.AcquireTimeoutMS == 0) );
+
+        TEST_CHECK(!policy.WaitIdle(state, 0));
+
+        step = policy.GetNextStep(state, 0);
+        TEST_CHECK( (step.IdleMS == 0) && (step.AcquireTimeoutMS == 0) );
+
+        //Frames that happened to be there count as a poll too
+        if (i % 2 == 0)
+            policy.OnAcquireTimeout(state);
+        else
+            policy.OnFrame(state, 0);
+
+        backoff_expected = std::min(backoff_expected * 2, g_DuplWaitBackoffMaxMS);
+    }
+
+    TEST_CHECK(state.GetBackoffMS() == g_DuplWaitBackoffMaxMS);
+
+    //Any change resets the backoff
+    policy.SetLimiterInterval(20);
+    TEST_CHECK(policy.GetNextStep(state, 0).IdleMS == g_DuplWaitBackoffMinMS);
+}
+
+static void TestLimiter()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state;
+    state.SetOutputRect(g_OutputLeft);
+
+    TEST_CHECK(policy.SetLimiterInterval(50));
+    TEST_CHECK(!policy.SetLimiterInterval(50));
+
+    //Idle until the interval since the last frame has passed
+    policy.OnFrame(state, 2000);
+    DuplicationWaitStep step = policy.GetNextStep(state, 2010);
+    TEST_CHECK( (step.IdleMS == 40) && (step.AcquireTimeoutMS != 0) );
+
+    TEST_CHECK(!policy.WaitIdle(state, 0));
+    TEST_CHECK(policy.GetNextStep(state, 2011).IdleMS == 0);
+
+    //Frames arriving later than the interval are acquired right away
+    policy.OnFrame(state, 2060);
+    TEST_CHECK(policy.GetNextStep(state, 2200).IdleMS == 0);
+
+    //Not limited anymore
+    policy.OnFrame(state, 3000);
+    policy.SetLimiterInterval(0);
+    TEST_CHECK(policy.GetNextStep(state, 3001).IdleMS == 0);
+}
+
+static void TestWakeup()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state;
+    state.SetOutputRect(g_OutputRight);
+    policy.SetVisibleRects({g_OutputLeft}, false);
+
+    DuplicationWaitStep step = policy.GetNextStep(state, 0);
+    TEST_CHECK(step.IdleMS == g_DuplWaitBackoffMinMS);
+
+    //Becoming visible ends the idle wait early
+    std::thread thread_change([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        policy.SetVisibleRects({g_OutputLeft, g_OutputRight}, false);
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    TEST_CHECK(policy.WaitIdle(state, 60000));
+    TEST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+    thread_change.join();
+
+    policy.GetNextStep(state, 0);
+    TEST_CHECK(state.IsVisible());
+
+    //A change already made before waiting ends it right away
+    policy.Wake();
+    TEST_CHECK(policy.WaitIdle(state, 60000));
+
+    //Nothing changed since the last step, times out
+    policy.GetNextStep(state, 0);
+    TEST_CHECK(!policy.WaitIdle(state, 1));
+
+    TEST_CHECK(policy.GetSignaledWakeupCount() == 2);
+    TEST_CHECK(policy.GetIdleTimeoutCount() == 1);
+    TEST_CHECK(policy.GetWakeupCount() == 3);
+}
+
+//Minute of a hidden output's duplication thread loop in simulated time. The fixed 100 ms acquire timeout used before woke up 600 times
+static void TestHiddenOutputWakeups()
+{
+    DuplicationWaitPolicy policy;
+    DuplicationWaitState state;
+    state.SetOutputRect(g_OutputRight);
+    policy.SetVisibleRects({g_OutputLeft}, false);
+
+    uint64_t tick = 0;
+    int poll_count = 0;
+
+    while (tick < 60000)
+    {
+        const DuplicationWaitStep step = policy.GetNextStep(state, tick);
+
+        if (step.IdleMS != 0)
+        {
+            policy.WaitIdle(state, 0);
+            tick += step.IdleMS;
+        }
+        else
+        {
+            //Desktop changes all the time, so there's always a frame
+            policy.OnFrame(state, tick);
+            poll_count++;
+        }
+    }
+
+    //100 + 200 + ... + 3200 ms, then every 3200 ms
+    TEST_CHECK( (poll_count >= 20) && (poll_count <= 24) );
+    TEST_CHECK(policy.GetFrameCount() == (uint64_t)poll_count);
+}
+
+//Threads stepping through their loops while the visible rects keep changing. Every thread has to see the final state
+static void TestConcurrent()
+{
+    DuplicationWaitPolicy policy;
+    std::atomic<bool> is_done{false};
+    std::vector<std::thread> threads;
+    std::vector<int> visible_final(4, -1);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            DuplicationWaitState state;
+            state.SetOutputRect({i * 100, 0, i * 100 + 100, 100});
+            uint64_t tick = 0;
+
+            while (!is_done)
+            {
+                const DuplicationWaitStep step = policy.GetNextStep(state, tick++);
+
+                if (step.IdleMS != 0)
+                {
+                    policy.WaitIdle(state, 1);
+                }
+                else
+                {
+                    policy.OnAcquireTimeout(state);
+                }
+            }
+
+            policy.GetNextStep(state, tick);
+            visible_final[i] = state.IsVisible();
+        });
+    }
+
+    TestRandom rng(42);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const int left = rng.Range(0, 400);
+        policy.SetVisibleRects({{left, 0, left + rng.Range(1, 100), 100}}, false);
+        policy.SetLimiterInterval(rng.Range(0, 2) * 10);
+    }
+
+    //Only the third output stays visible
+    policy.SetVisibleRects({{250, 50, 260, 60}}, false);
+    is_done = true;
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    TEST_CHECK(visible_final == (std::vector<int>{0, 0, 1, 0}));
+}
+
+int main()
+{
+    TEST_RUN(TestAcquireTimeout);
+    TEST_RUN(TestVisibility);
+    TEST_RUN(TestBackoff);
+    TEST_RUN(TestLimiter);
+    TEST_RUN(TestWakeup);
+    TEST_RUN(TestHiddenOutputWakeups);
+    TEST_RUN(TestConcurrent);
+
+    return TestResult();
+}
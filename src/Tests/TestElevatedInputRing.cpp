@@ -0,0 +1,290 @@
+#include "TestCommon.h"
+
+#include "ElevatedInputRing.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//The ring normally lives in zero-initialized shared memory, value-initialization gives the same state
+static std::unique_ptr<ElevatedInputRing> CreateRing()
+{
+    return std::unique_ptr<ElevatedInputRing>(new ElevatedInputRing());
+}
+
+//Stand-in for the state left behind in shared memory by a previous producer. Relies on the indices being the first member of their cache line
+static void SetRingIndices(ElevatedInputRing& ring, uint32_t write_index, uint32_t read_index)
+{
+    unsigned char* mem = reinterpret_cast<unsigned char*>(&ring);
+    std::memcpy(mem,      &write_index, sizeof(uint32_t));
+    std::memcpy(mem + 64, &read_index,  sizeof(uint32_t));
+}
+
+static ElevatedInputEvent MakeEvent(uint32_t action_id, int64_t value)
+{
+    ElevatedInputEvent input_event = {};
+    input_event.ActionID = action_id;
+    input_event.Value    = value;
+
+    return input_event;
+}
+
+//Auto-reset event stand-in
+class TestDoorbell
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_IsSet = false;
+
+    public:
+        void Set()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsSet = true;
+            m_Condition.notify_one();
+        }
+
+        //Returns false on timeout
+        bool Wait(int timeout_ms)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            if (!m_Condition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&](){ return m_IsSet; }))
+                return false;
+
+            m_IsSet = false;
+            return true;
+        }
+};
+
+static void TestPushPop()
+{
+    auto ring = CreateRing();
+    ElevatedInputEvent events[8];
+    bool needs_doorbell = false;
+
+    TEST_CHECK(ring->Pop(events, 8) == 0);
+
+    //Only the push into an empty ring needs to wake up the consumer
+    const ElevatedInputEvent event_a = MakeEvent(1, -5);
+    TEST_CHECK(ring->Push(&event_a, 1, needs_doorbell));
+    TEST_CHECK(needs_doorbell);
+
+    const ElevatedInputEvent events_b[2] = {MakeEvent(2, 10), MakeEvent(3, INT64_MAX)};
+    TEST_CHECK(ring->Push(events_b, 2, needs_doorbell));
+    TEST_CHECK(!needs_doorbell);
+
+    TEST_CHECK(ring->Pop(events, 2) == 2);
+    TEST_CHECK( (events[0].ActionID == 1) && (events[0].Value == -5) );
+    TEST_CHECK( (events[1].ActionID == 2) && (events[1].Value == 10) );
+
+    TEST_CHECK(ring->Pop(events, 8) == 1);
+    TEST_CHECK( (events[0].ActionID == 3) && (events[0].Value == INT64_MAX) );
+    TEST_CHECK(ring->Pop(events, 8) == 0);
+
+    //Empty again, so the next push rings the doorbell
+    TEST_CHECK(ring->Push(&event_a, 1, needs_doorbell));
+    TEST_CHECK(needs_doorbell);
+}
+
+//Pushes fit completely or not at all, a full ring doesn't lose anything already in it
+static void TestFull()
+{
+    auto ring = CreateRing();
+    bool needs_doorbell = false;
+
+    std::vector<ElevatedInputEvent> events;
+    for (uint32_t i = 0; i < ElevatedInputRing::Capacity - 1; ++i)
+    {
+        events.push_back(MakeEvent(1, i));
+    }
+
+    TEST_CHECK(ring->Push(events.data(), (uint32_t)events.size(), needs_doorbell));
+
+    const ElevatedInputEvent events_extra[2] = {MakeEvent(2, -1), MakeEvent(2, -2)};
+    TEST_CHECK(!ring->Push(events_extra, 2, needs_doorbell));
+    TEST_CHECK(!needs_doorbell);
+    TEST_CHECK(ring->Push(events_extra, 1, needs_doorbell));
+    TEST_CHECK(!ring->Push(events_extra, 1, needs_doorbell));
+
+    std::vector<ElevatedInputEvent> events_out(ElevatedInputRing::Capacity + 1);
+    TEST_CHECK(ring->Pop(events_out.data(), (uint32_t)events_out.size()) == ElevatedInputRing::Capacity);
+
+    for (uint32_t i = 0; i < ElevatedInputRing::Capacity - 1; ++i)
+    {
+        TEST_CHECK(events_out[i].Value == i);
+    }
+
+    TEST_CHECK(events_out[ElevatedInputRing::Capacity - 1].Value == -1);
+}
+
+//Random batch sizes on both sides across the uint32 wrap of the indices
+static void TestWrapAround()
+{
+    auto ring = CreateRing();
+    SetRingIndices(*ring, UINT32_MAX - 3000, UINT32_MAX - 3000);
+
+    TestRandom rng(37);
+    int64_t value_push = 0, value_pop = 0;
+    ElevatedInputEvent events[64];
+    bool needs_doorbell = false;
+
+    for (int iteration = 0; iteration < 20000; ++iteration)
+    {
+        if (rng.Range(0, 1) == 0)
+        {
+            const uint32_t count = rng.Range(1, 64);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                events[i] = MakeEvent(1, value_push + i);
+            }
+
+            const bool has_space = (ElevatedInputRing::Capacity - (value_push - value_pop) >= count);
+            TEST_CHECK(ring->Push(events, count, needs_doorbell) == has_space);
+            TEST_CHECK( (!needs_doorbell) || (value_push == value_pop) );
+
+            if (has_space)
+            {
+                value_push += count;
+            }
+        }
+        else
+        {
+            const uint32_t count = ring->Pop(events, rng.Range(1, 64));
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                TEST_CHECK(events[i].Value == value_pop++);
+            }
+        }
+    }
+
+    TEST_CHECK(value_pop > 6000);
+}
+
+static void TestGarbageIndices()
+{
+    auto ring = CreateRing();
+    ElevatedInputEvent events[8];
+    bool needs_doorbell = false;
+
+    //More pending than the capacity can only come from a misbehaving producer. The consumer skips it all
+    SetRingIndices(*ring, 5000, 10);
+    TEST_CHECK(ring->Pop(events, 8) == 0);
+    TEST_CHECK(ring->Pop(events, 8) == 0);
+
+    const ElevatedInputEvent input_event = MakeEvent(4, 44);
+    TEST_CHECK(ring->Push(&input_event, 1, needs_doorbell));
+    TEST_CHECK(ring->Pop(events, 8) == 1);
+    TEST_CHECK(events[0].Value == 44);
+
+    //Left over events from a previous consumer process
+    TEST_CHECK(ring->Push(&input_event, 1, needs_doorbell));
+    ring->DiscardPending();
+    TEST_CHECK(ring->Pop(events, 8) == 0);
+}
+
+static void TestFallbackCounters()
+{
+    auto ring = CreateRing();
+    TEST_CHECK(!ring->IsFallbackPending());
+
+    ring->OnFallbackPosted();
+    ring->OnFallbackPosted();
+    TEST_CHECK(ring->IsFallbackPending());
+
+    ring->OnFallbackHandled();
+    TEST_CHECK(ring->IsFallbackPending());
+    ring->OnFallbackHandled();
+    TEST_CHECK(!ring->IsFallbackPending());
+
+    //Messages that never arrive because the consumer process went away must not keep the producer on messages forever
+    ring->OnFallbackPosted();
+    TEST_CHECK(ring->IsFallbackPending());
+    ring->DiscardPending();
+    TEST_CHECK(!ring->IsFallbackPending());
+}
+
+//Producer and consumer threads with the doorbell protocol. A lost wake-up shows up as a wait timing out while events are pending
+static void TestConcurrent()
+{
+    auto ring = CreateRing();
+    TestDoorbell doorbell;
+    const int64_t event_count = 500000;
+
+    std::thread producer([&]()
+    {
+        TestRandom rng(370);
+        ElevatedInputEvent events[16];
+        int64_t value = 0;
+
+        while (value < event_count)
+        {
+            const uint32_t count = (uint32_t)std::min<int64_t>(rng.Range(1, 16), event_count - value);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                events[i] = MakeEvent((uint32_t)(value + i) % 7, value + i);
+            }
+
+            bool needs_doorbell = false;
+            if (ring->Push(events, count, needs_doorbell))
+            {
+                value += count;
+
+                if (needs_doorbell)
+                {
+                    doorbell.Set();
+                }
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    ElevatedInputEvent events[64];
+    int64_t value_expected = 0;
+    bool is_in_order = true;
+    int timeout_count = 0;
+
+    while (value_expected < event_count)
+    {
+        uint32_t count;
+        while ((count = ring->Pop(events, 64)) != 0)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                is_in_order &= ( (events[i].Value == value_expected) && (events[i].ActionID == (uint32_t)value_expected % 7) );
+                value_expected++;
+            }
+        }
+
+        if ( (value_expected < event_count) && (!doorbell.Wait(2000)) )
+        {
+            timeout_count++;
+        }
+    }
+
+    producer.join();
+
+    TEST_CHECK(is_in_order);
+    TEST_CHECK(timeout_count == 0);
+}
+
+int main()
+{
+    TEST_RUN(TestPushPop);
+    TEST_RUN(TestFull);
+    TEST_RUN(TestWrapAround);
+    TEST_RUN(TestGarbageIndices);
+    TEST_RUN(TestFallbackCounters);
+    TEST_RUN(TestConcurrent);
+
+    return TestResult();
+}
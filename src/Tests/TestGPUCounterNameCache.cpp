@@ -0,0 +1,185 @@
+#include "TestCommon.h"
+#include "GPUCounterNameList.h"
+
+#include "GPUCounterNameCache.h"
+
+#include <algorithm>
+#include <cwchar>
+
+static void TestParse()
+{
+    GPUCounterInstanceInfo info = ParseGPUCounterInstanceName(L"pid_1234_luid_0x00000000_0x0000D1E5_phys_0_eng_0_engtype_3D");
+    TEST_CHECK(info.LUIDHighPart == 0);
+    TEST_CHECK(info.LUIDLowPart == 0xD1E5);
+    TEST_CHECK(info.IsEngine3D);
+    TEST_CHECK(info.NameHash == HashGPUCounterInstanceName(L"pid_1234_luid_0x00000000_0x0000D1E5_phys_0_eng_0_engtype_3D"));
+
+    info = ParseGPUCounterInstanceName(L"pid_1234_luid_0x00000001_0x8000D1E5_phys_0_eng_3_engtype_VideoDecode");
+    TEST_CHECK(info.LUIDHighPart == 1);
+    TEST_CHECK(info.LUIDLowPart == 0x8000D1E5);
+    TEST_CHECK(!info.IsEngine3D);
+
+    //"GPU Adapter Memory" names
+    info = ParseGPUCounterInstanceName(L"luid_0xFFFFFFFF_0x0000D1E5_phys_0");
+    TEST_CHECK(info.LUIDHighPart == -1);
+    TEST_CHECK(info.LUIDLowPart == 0xD1E5);
+    TEST_CHECK(!info.IsEngine3D);
+
+    //Engine types that only start with "3D" don't exist, but the legacy parser matched them too
+    info = ParseGPUCounterInstanceName(L"pid_1_luid_0x00000000_0x00000001_phys_0_eng_0_engtype_3D_Extra");
+    TEST_CHECK(info.IsEngine3D);
+
+    //Malformed names leave the LUID at 0
+    info = ParseGPUCounterInstanceName(L"");
+    TEST_CHECK( (info.LUIDHighPart == 0) && (info.LUIDLowPart == 0) && (!info.IsEngine3D) );
+    info = ParseGPUCounterInstanceName(L"pid_1_luid_0x00000005");
+    TEST_CHECK( (info.LUIDHighPart == 0) && (info.LUIDLowPart == 0) );
+}
+
+static void TestParseMatchesList()
+{
+    GPUCounterNameList list;
+    list.Build(MakeGPUEngineCounterNames(50));
+
+    int engine_3d_count = 0;
+    for (const wchar_t* name : list.Names)
+    {
+        GPUCounterInstanceInfo info = ParseGPUCounterInstanceName(name);
+        TEST_CHECK( (info.LUIDLowPart == 0xD1E5) || (info.LUIDLowPart == 0xF1A2) );
+
+        if (info.IsEngine3D)
+            engine_3d_count++;
+    }
+
+    TEST_CHECK(engine_3d_count == 50);
+}
+
+static void TestCacheSteadyState()
+{
+    GPUCounterNameList list;
+    list.Build(MakeGPUEngineCounterNames(20));
+    const size_t count = list.Names.size();
+
+    GPUCounterNameCache cache;
+
+    //First update parses everything
+    for (size_t i = 0; i < count; ++i)
+    {
+        TEST_CHECK(cache.Get(i, list.Names[i]).NameHash == HashGPUCounterInstanceName(list.Names[i]));
+    }
+    cache.Trim(count);
+    TEST_CHECK(cache.GetParseCount() == count);
+    TEST_CHECK(cache.GetHashCount() == count);
+
+    //Unchanged names are hashed on every update, but never parsed again
+    const uint32_t update_count = 30;
+    for (uint32_t update = 0; update < update_count; ++update)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            cache.Get(i, list.Names[i]);
+        }
+        cache.Trim(count);
+    }
+    TEST_CHECK(cache.GetHashCount() == count * (update_count + 1));
+    TEST_CHECK(cache.GetParseCount() == count);
+}
+
+static void TestCacheInstanceSetChange()
+{
+    GPUCounterNameList list;
+    list.Build(MakeGPUEngineCounterNames(10));
+
+    GPUCounterNameCache cache;
+    for (size_t i = 0; i < list.Names.size(); ++i)
+    {
+        cache.Get(i, list.Names[i]);
+    }
+    cache.Trim(list.Names.size());
+    const uint64_t parse_count_initial = cache.GetParseCount();
+
+    //A process exits, which shifts all following names to other indices and pointers
+    std::vector<std::wstring> names = MakeGPUEngineCounterNames(10);
+    names.erase(names.begin(), names.begin() + 8);
+    list.Build(names);
+
+    for (size_t i = 0; i < list.Names.size(); ++i)
+    {
+        const GPUCounterInstanceInfo& info = cache.Get(i, list.Names[i]);
+        const GPUCounterInstanceInfo expected = ParseGPUCounterInstanceName(list.Names[i]);
+
+        TEST_CHECK(info.NameHash     == expected.NameHash);
+        TEST_CHECK(info.LUIDLowPart  == expected.LUIDLowPart);
+        TEST_CHECK(info.IsEngine3D   == expected.IsEngine3D);
+    }
+    cache.Trim(list.Names.size());
+    TEST_CHECK(cache.GetParseCount() > parse_count_initial);
+
+    //Clearing forgets everything
+    cache.Clear();
+    const uint64_t parse_count_before_clear = cache.GetParseCount();
+    cache.Get(0, list.Names[0]);
+    TEST_CHECK(cache.GetParseCount() == parse_count_before_clear + 1);
+}
+
+//Processes replacing each other with PIDs of the same length keep the item count and buffer size, and PDH writes the names to the same pointers
+//The changed names have to be picked up on the very next update
+static void TestCacheNamesChangeInPlace()
+{
+    GPUCounterNameList list;
+    list.Build(MakeGPUEngineCounterNames(10, 1000));
+    const size_t count = list.Names.size();
+    const size_t buffer_size = list.GetBufferSize();
+
+    GPUCounterNameCache cache;
+    for (size_t i = 0; i < count; ++i)
+    {
+        cache.Get(i, list.Names[i]);
+    }
+    cache.Trim(count);
+
+    //Same count and lengths, different PIDs, written over the old names
+    std::vector<std::wstring> names = MakeGPUEngineCounterNames(10, 5000);
+    size_t offset = 0;
+    bool is_in_place = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        is_in_place &= ( (list.Buffer.data() + offset == list.Names[i]) && (names[i].size() == std::wcslen(list.Names[i])) );
+        std::copy(names[i].begin(), names[i].end(), list.Buffer.begin() + offset);
+        offset += names[i].size() + 1;
+    }
+    TEST_CHECK(is_in_place);
+    TEST_CHECK(list.GetBufferSize() == buffer_size);
+
+    //Change the LUID and engine type of the first 3D engine without changing its length either
+    const std::wstring replacement = L"pid_5000_luid_0x00000000_0x0000C0DE_phys_0_eng_0_engtype_CD";
+    TEST_CHECK( (ParseGPUCounterInstanceName(list.Names[0]).IsEngine3D) && (replacement.size() == std::wcslen(list.Names[0])) );
+    std::copy(replacement.begin(), replacement.end(), list.Buffer.begin());
+
+    const uint64_t parse_count_before = cache.GetParseCount();
+    bool is_matching = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const GPUCounterInstanceInfo& info = cache.Get(i, list.Names[i]);
+        const GPUCounterInstanceInfo expected = ParseGPUCounterInstanceName(list.Names[i]);
+
+        is_matching &= ( (info.NameHash == expected.NameHash) && (info.LUIDHighPart == expected.LUIDHighPart) && (info.LUIDLowPart == expected.LUIDLowPart) &&
+                         (info.IsEngine3D == expected.IsEngine3D) );
+    }
+    cache.Trim(count);
+
+    TEST_CHECK(is_matching);
+    TEST_CHECK(cache.GetParseCount() == parse_count_before + count);
+    TEST_CHECK( (!cache.Get(0, list.Names[0]).IsEngine3D) && (cache.Get(0, list.Names[0]).LUIDLowPart == 0xC0DE) );
+}
+
+int main()
+{
+    TEST_RUN(TestParse);
+    TEST_RUN(TestParseMatchesList);
+    TEST_RUN(TestCacheSteadyState);
+    TEST_RUN(TestCacheInstanceSetChange);
+    TEST_RUN(TestCacheNamesChangeInPlace);
+
+    return TestResult();
+}
@@ -0,0 +1,159 @@
+#include "TestCommon.h"
+
+#include "GazeFadeEvaluator.h"
+#include "GazeFadeLegacy.h"
+
+#include <cstring>
+#include <vector>
+
+static Matrix4 RandomHMDPose(TestRandom& rng)
+{
+    Matrix4 pose;
+    pose.rotate(rng.RangeFloat(-180.0f, 180.0f), rng.RangeFloat(-1.0f, 1.0f), rng.RangeFloat(-1.0f, 1.0f), rng.RangeFloat(-1.0f, 1.0f));
+    pose.translate(rng.RangeFloat(-2.0f, 2.0f), rng.RangeFloat(0.0f, 2.0f), rng.RangeFloat(-2.0f, 2.0f));
+
+    return pose;
+}
+
+static GazeFadeOverlay RandomOverlay(TestRandom& rng, unsigned int overlay_id)
+{
+    GazeFadeOverlay overlay;
+    overlay.OverlayID      = overlay_id;
+    overlay.PosX           = rng.RangeFloat(-3.0f, 3.0f);
+    overlay.PosY           = rng.RangeFloat(-1.0f, 3.0f);
+    overlay.PosZ           = rng.RangeFloat(-3.0f, 3.0f);
+    overlay.GazeDistance   = (rng.Range(0, 3) == 0) ? 0.0f : rng.RangeFloat(0.0f, 1.0f);
+    overlay.FadeRate       = rng.RangeFloat(0.1f, 3.0f);
+    overlay.OpacityMax     = rng.RangeFloat(0.0f, 1.0f);                //Either one can be larger, which inverts the fade
+    overlay.OpacityMin     = rng.RangeFloat(0.0f, 1.0f);
+    overlay.OpacityCurrent = (rng.Range(0, 7) == 0) ? rng.RangeFloat(0.0f, 1.0f) : 0.5f;
+    overlay.IsHovered      = (rng.Range(0, 4) == 0);
+
+    //Some already at their target opacity, which aren't part of the results
+    if ( (overlay.IsHovered) && (rng.Range(0, 1) == 0) )
+    {
+        overlay.OpacityCurrent = std::max(overlay.OpacityMin, overlay.OpacityMax);
+    }
+
+    return overlay;
+}
+
+//Compares the evaluator's results with the legacy math for every overlay. Results have to be bit-identical and only list changed overlays in order
+static bool IsMatchingLegacy(const Matrix4& hmd_pose, const std::vector<GazeFadeOverlay>& overlays, const std::vector<GazeFadeResult>& results)
+{
+    size_t result_index = 0;
+
+    for (const GazeFadeOverlay& overlay : overlays)
+    {
+        const float opacity = GazeFadeLegacy::Evaluate(hmd_pose, overlay);
+
+        if (opacity == overlay.OpacityCurrent)
+            continue;
+
+        if ( (result_index >= results.size()) || (results[result_index].OverlayID != overlay.OverlayID) ||
+             (std::memcmp(&results[result_index].Opacity, &opacity, sizeof(float)) != 0) )
+        {
+            return false;
+        }
+
+        result_index++;
+    }
+
+    return (result_index == results.size());
+}
+
+//Every overlay count from 1 to 64, so both the SSE2 batches and the scalar remainder are covered
+static void TestLegacyEquivalence()
+{
+    TestRandom rng(45);
+    GazeFadeEvaluator evaluator;
+    std::vector<GazeFadeOverlay> overlays;
+    std::vector<GazeFadeResult> results;
+    bool is_matching = true;
+    size_t changed_count = 0, unchanged_count = 0;
+
+    for (int iteration = 0; iteration < 20000; ++iteration)
+    {
+        const Matrix4 hmd_pose = RandomHMDPose(rng);
+        const unsigned int overlay_count = 1 + (iteration % 64);
+
+        overlays.clear();
+        evaluator.Clear();
+
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            overlays.push_back(RandomOverlay(rng, i + 1));
+            evaluator.Add(overlays.back());
+        }
+
+        TEST_CHECK(evaluator.GetOverlayCount() == overlay_count);
+
+        evaluator.Evaluate(GazeFadeLegacy::ToHMDPose(hmd_pose), results);
+        is_matching &= IsMatchingLegacy(hmd_pose, overlays, results);
+
+        changed_count   += results.size();
+        unchanged_count += overlay_count - results.size();
+    }
+
+    TEST_CHECK(is_matching);
+
+    //Make sure both cases actually came up
+    TEST_CHECK( (changed_count > 0) && (unchanged_count > 0) );
+}
+
+//Looking straight at an overlay fades it in, looking away fades it out, both limited to 0.1 per frame
+static void TestFading()
+{
+    Matrix4 hmd_pose;
+    hmd_pose.translate(0.0f, 1.6f, 0.0f);          //Looking down -Z
+
+    GazeFadeOverlay overlay_front  = {1, 0.0f, 1.6f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.5f, false};
+    GazeFadeOverlay overlay_behind = {2, 0.0f, 1.6f,  1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.5f, false};
+
+    GazeFadeEvaluator evaluator;
+    std::vector<GazeFadeResult> results;
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        evaluator.Clear();
+        evaluator.Add(overlay_front);
+        evaluator.Add(overlay_behind);
+        evaluator.Evaluate(GazeFadeLegacy::ToHMDPose(hmd_pose), results);
+
+        for (const GazeFadeResult& result : results)
+        {
+            GazeFadeOverlay& overlay = (result.OverlayID == 1) ? overlay_front : overlay_behind;
+            TEST_CHECK(std::fabs(result.Opacity - overlay.OpacityCurrent) <= 0.1f + 0.000001f);
+            overlay.OpacityCurrent = result.Opacity;
+        }
+    }
+
+    TEST_CHECK(overlay_front.OpacityCurrent == 1.0f);
+    TEST_CHECK(overlay_behind.OpacityCurrent == 0.0f);
+
+    //Settled, nothing changes anymore
+    evaluator.Clear();
+    evaluator.Add(overlay_front);
+    evaluator.Add(overlay_behind);
+    evaluator.Evaluate(GazeFadeLegacy::ToHMDPose(hmd_pose), results);
+    TEST_CHECK(results.empty());
+
+    //Hovered overlays go to whatever's more visible
+    overlay_behind.IsHovered = true;
+    evaluator.Clear();
+    evaluator.Add(overlay_behind);
+    evaluator.Evaluate(GazeFadeLegacy::ToHMDPose(hmd_pose), results);
+    TEST_CHECK( (results.size() == 1) && (std::fabs(results[0].Opacity - 0.1f) <= 0.000001f) );
+
+    evaluator.Clear();
+    evaluator.Evaluate(GazeFadeLegacy::ToHMDPose(hmd_pose), results);
+    TEST_CHECK(results.empty());
+}
+
+int main()
+{
+    TEST_RUN(TestLegacyEquivalence);
+    TEST_RUN(TestFading);
+
+    return TestResult();
+}
@@ -0,0 +1,377 @@
+#include "TestCommon.h"
+
+#include "HeadlessVR.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool IsNear(float a, float b)
+{
+    return (std::fabs(a - b) < 1e-4f);
+}
+
+static vr::HmdMatrix34_t MatrixTranslation(float x, float y, float z)
+{
+    return {{{1.0f, 0.0f, 0.0f, x}, {0.0f, 1.0f, 0.0f, y}, {0.0f, 0.0f, 1.0f, z}}};
+}
+
+//Each test starts from a fresh runtime
+static void InitRuntime()
+{
+    HeadlessVR::Reset();
+
+    vr::EVRInitError init_error = vr::VRInitError_Unknown;
+    vr::VR_Init(&init_error, vr::VRApplication_Overlay);
+    TEST_CHECK(init_error == vr::VRInitError_None);
+}
+
+static void TestInit()
+{
+    InitRuntime();
+
+    TEST_CHECK(vr::VRSystem()     != nullptr);
+    TEST_CHECK(vr::VROverlay()    != nullptr);
+    TEST_CHECK(vr::VRCompositor() != nullptr);
+    TEST_CHECK(vr::VRInput()      != nullptr);
+
+    //Everything else isn't provided
+    vr::EVRInitError init_error = vr::VRInitError_None;
+    TEST_CHECK(vr::VR_GetGenericInterface(vr::IVRChaperone_Version, &init_error) == nullptr);
+    TEST_CHECK(init_error == vr::VRInitError_Init_InterfaceNotFound);
+    TEST_CHECK(!vr::VR_IsInterfaceVersionValid(vr::IVRChaperone_Version));
+
+    vr::VR_Shutdown();
+    TEST_CHECK(vr::VR_GetGenericInterface(vr::IVROverlay_Version, &init_error) == nullptr);
+    TEST_CHECK(init_error == vr::VRInitError_Init_NotInitialized);
+}
+
+static void TestOverlays()
+{
+    InitRuntime();
+    vr::IVROverlay* overlay = vr::VROverlay();
+
+    vr::VROverlayHandle_t handle_a, handle_b, handle_dashboard, handle_thumbnail, handle_found;
+    TEST_CHECK(overlay->CreateOverlay("key.a", "A", &handle_a) == vr::VROverlayError_None);
+    TEST_CHECK(overlay->CreateOverlay("key.a", "A", &handle_b) == vr::VROverlayError_KeyInUse);
+    TEST_CHECK(overlay->CreateOverlay("key.b", "B", &handle_b) == vr::VROverlayError_None);
+    TEST_CHECK(handle_a != handle_b);
+
+    TEST_CHECK(overlay->CreateDashboardOverlay("key.dashboard", "Dashboard", &handle_dashboard, &handle_thumbnail) == vr::VROverlayError_None);
+    TEST_CHECK( (overlay->FindOverlay("key.dashboard.thumbnail", &handle_found) == vr::VROverlayError_None) && (handle_found == handle_thumbnail) );
+    TEST_CHECK( (overlay->FindOverlay("key.c", &handle_found) == vr::VROverlayError_UnknownOverlay) && (handle_found == vr::k_ulOverlayHandleInvalid) );
+
+    //Key and name reads report a too small buffer
+    char buffer[64];
+    vr::EVROverlayError overlay_error;
+    overlay->GetOverlayKey(handle_a, buffer, 3, &overlay_error);
+    TEST_CHECK(overlay_error == vr::VROverlayError_ArrayTooSmall);
+    overlay->GetOverlayName(handle_b, buffer, sizeof(buffer), &overlay_error);
+    TEST_CHECK( (overlay_error == vr::VROverlayError_None) && (std::string(buffer) == "B") );
+
+    //State set through the interface shows up in the inspection
+    overlay->SetOverlayWidthInMeters(handle_a, 2.5f);
+    overlay->SetOverlayFlag(handle_a, vr::VROverlayFlags_SendVRSmoothScrollEvents, true);
+    overlay->SetOverlayAlpha(handle_a, 0.5f);
+    overlay->ShowOverlay(handle_a);
+
+    const uint8_t pixels[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    overlay->SetOverlayRaw(handle_a, (void*)pixels, 2, 1, 4);
+
+    HeadlessVR::OverlayState state;
+    TEST_CHECK(HeadlessVR::GetOverlayState(handle_a, state));
+    TEST_CHECK( (state.Key == "key.a") && (state.IsVisible) && (state.WidthInMeters == 2.5f) && (state.Alpha == 0.5f) );
+    TEST_CHECK(state.Flags == (uint32_t)vr::VROverlayFlags_SendVRSmoothScrollEvents);
+    TEST_CHECK( (state.RawData.size() == 8) && (state.RawData[7] == 8) && (state.RawWidth == 2) && (state.TextureSetCount == 1) );
+
+    bool is_flag_set = false;
+    TEST_CHECK( (overlay->GetOverlayFlag(handle_a, vr::VROverlayFlags_SendVRSmoothScrollEvents, &is_flag_set) == vr::VROverlayError_None) && (is_flag_set) );
+
+    TEST_CHECK(HeadlessVR::GetOverlayState(handle_thumbnail, state));
+    TEST_CHECK(state.IsDashboardThumbnail);
+
+    //Creation order, destroyed overlays are gone and their handles are not reused
+    TEST_CHECK(HeadlessVR::GetOverlayHandles() == (std::vector<vr::VROverlayHandle_t>{handle_a, handle_b, handle_dashboard, handle_thumbnail}));
+    TEST_CHECK(overlay->DestroyOverlay(handle_b) == vr::VROverlayError_None);
+    TEST_CHECK(overlay->DestroyOverlay(handle_b) == vr::VROverlayError_UnknownOverlay);
+    TEST_CHECK(overlay->SetOverlayAlpha(handle_b, 1.0f) == vr::VROverlayError_UnknownOverlay);
+    TEST_CHECK(!HeadlessVR::GetOverlayState(handle_b, state));
+
+    vr::VROverlayHandle_t handle_c;
+    overlay->CreateOverlay("key.b", "B", &handle_c);
+    TEST_CHECK(handle_c != handle_b);
+
+    HeadlessVR::Reset();
+    TEST_CHECK(HeadlessVR::GetOverlayHandles().empty());
+    overlay->CreateOverlay("key.a", "A", &handle_b);
+    TEST_CHECK(handle_b > handle_c);
+}
+
+static void TestTransforms()
+{
+    InitRuntime();
+    vr::IVROverlay* overlay = vr::VROverlay();
+
+    //2x1 m overlay, 1 m up and 2 m in front of the standing origin
+    vr::VROverlayHandle_t handle, handle_child;
+    overlay->CreateOverlay("key", "Name", &handle);
+    overlay->CreateOverlay("key.child", "Child", &handle_child);
+
+    const vr::HmdMatrix34_t transform = MatrixTranslation(0.0f, 1.0f, -2.0f);
+    overlay->SetOverlayTransformAbsolute(handle, vr::TrackingUniverseStanding, &transform);
+    overlay->SetOverlayWidthInMeters(handle, 2.0f);
+
+    const vr::HmdVector2_t mouse_scale = {200.0f, 100.0f};
+    overlay->SetOverlayMouseScale(handle, &mouse_scale);
+
+    vr::VROverlayIntersectionParams_t params = {{0.5f, 1.25f, 0.0f}, {0.0f, 0.0f, -1.0f}, vr::TrackingUniverseStanding};
+    vr::VROverlayIntersectionResults_t results;
+    TEST_CHECK(overlay->ComputeOverlayIntersection(handle, &params, &results));
+    TEST_CHECK( (IsNear(results.vUVs.v[0], 0.75f)) && (IsNear(results.vUVs.v[1], 0.75f)) && (IsNear(results.fDistance, 2.0f)) );
+    TEST_CHECK( (IsNear(results.vPoint.v[0], 0.5f)) && (IsNear(results.vPoint.v[1], 1.25f)) && (IsNear(results.vPoint.v[2], -2.0f)) );
+
+    //Missing and pointing away
+    params.vSource.v[0] = 1.5f;
+    TEST_CHECK(!overlay->ComputeOverlayIntersection(handle, &params, &results));
+    params.vSource.v[0]    = 0.0f;
+    params.vDirection.v[2] = 1.0f;
+    TEST_CHECK(!overlay->ComputeOverlayIntersection(handle, &params, &results));
+
+    //Mouse coordinates map back to the same spot
+    vr::HmdMatrix34_t coordinates_transform;
+    overlay->GetTransformForOverlayCoordinates(handle, vr::TrackingUniverseStanding, {150.0f, 75.0f}, &coordinates_transform);
+    TEST_CHECK( (IsNear(coordinates_transform.m[0][3], 0.5f)) && (IsNear(coordinates_transform.m[1][3], 1.25f)) && (IsNear(coordinates_transform.m[2][3], -2.0f)) );
+
+    //Seated space is relative to the seated zero pose
+    HeadlessVR::SetSeatedZeroPose(MatrixTranslation(0.0f, 1.0f, 0.0f));
+    overlay->GetTransformForOverlayCoordinates(handle, vr::TrackingUniverseSeated, {100.0f, 50.0f}, &coordinates_transform);
+    TEST_CHECK( (IsNear(coordinates_transform.m[1][3], 0.0f)) && (IsNear(coordinates_transform.m[2][3], -2.0f)) );
+
+    //Overlay-relative follows the parent, device-relative follows the device
+    const vr::HmdMatrix34_t offset = MatrixTranslation(1.0f, 0.0f, 0.0f);
+    overlay->SetOverlayTransformOverlayRelative(handle_child, handle, &offset);
+    overlay->SetOverlayWidthInMeters(handle_child, 1.0f);
+    overlay->GetTransformForOverlayCoordinates(handle_child, vr::TrackingUniverseStanding, {0.5f, 0.5f}, &coordinates_transform);
+    TEST_CHECK( (IsNear(coordinates_transform.m[0][3], 1.0f)) && (IsNear(coordinates_transform.m[1][3], 1.0f)) );
+
+    vr::VROverlayTransformType transform_type;
+    overlay->GetOverlayTransformType(handle_child, &transform_type);
+    TEST_CHECK(transform_type == HeadlessVR::OverlayTransform_OverlayRelative);
+
+    HeadlessVR::SetDevice(3, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_RightHand);
+    HeadlessVR::SetDevicePose(3, MatrixTranslation(0.0f, 0.0f, 5.0f));
+    overlay->SetOverlayTransformTrackedDeviceRelative(handle_child, 3, &offset);
+    overlay->GetTransformForOverlayCoordinates(handle_child, vr::TrackingUniverseStanding, {0.5f, 0.5f}, &coordinates_transform);
+    TEST_CHECK( (IsNear(coordinates_transform.m[0][3], 1.0f)) && (IsNear(coordinates_transform.m[2][3], 5.0f)) );
+}
+
+static void TestDevices()
+{
+    InitRuntime();
+    vr::IVRSystem* system = vr::VRSystem();
+
+    TEST_CHECK(system->GetTrackedDeviceClass(vr::k_unTrackedDeviceIndex_Hmd) == vr::TrackedDeviceClass_HMD);
+    TEST_CHECK(!system->IsTrackedDeviceConnected(1));
+
+    HeadlessVR::SetDevice(1, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_LeftHand);
+    HeadlessVR::SetDevice(2, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_RightHand);
+    TEST_CHECK(system->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand) == 2);
+    TEST_CHECK(system->GetControllerRoleForTrackedDeviceIndex(1) == vr::TrackedControllerRole_LeftHand);
+
+    vr::TrackedDeviceIndex_t indices[4];
+    TEST_CHECK(system->GetSortedTrackedDeviceIndicesOfClass(vr::TrackedDeviceClass_Controller, indices, 4, vr::k_unTrackedDeviceIndex_Hmd) == 2);
+    TEST_CHECK( (indices[0] == 1) && (indices[1] == 2) );
+
+    //New devices start valid at the identity, invalid poses are reported as such
+    HeadlessVR::SetDevicePose(2, MatrixTranslation(1.0f, 2.0f, 3.0f), false);
+
+    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
+    system->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, 0.0f, poses, vr::k_unMaxTrackedDeviceCount);
+    TEST_CHECK( (poses[1].bPoseIsValid) && (poses[1].bDeviceIsConnected) && (poses[1].mDeviceToAbsoluteTracking.m[0][0] == 1.0f) );
+    TEST_CHECK( (!poses[2].bPoseIsValid) && (poses[2].mDeviceToAbsoluteTracking.m[2][3] == 3.0f) );
+    TEST_CHECK(!poses[3].bDeviceIsConnected);
+
+    HeadlessVR::RemoveDevice(1);
+    TEST_CHECK(!system->IsTrackedDeviceConnected(1));
+
+    //Properties with type checks and buffer sizes
+    vr::ETrackedPropertyError prop_error;
+    HeadlessVR::SetDeviceProperty(0, vr::Prop_TrackingSystemName_String, std::string("lighthouse"));
+    HeadlessVR::SetDeviceProperty(0, vr::Prop_DisplayFrequency_Float, 90.0f);
+
+    char buffer[64];
+    TEST_CHECK(system->GetStringTrackedDeviceProperty(0, vr::Prop_TrackingSystemName_String, buffer, 4, &prop_error) == 11);
+    TEST_CHECK(prop_error == vr::TrackedProp_BufferTooSmall);
+    system->GetStringTrackedDeviceProperty(0, vr::Prop_TrackingSystemName_String, buffer, sizeof(buffer), &prop_error);
+    TEST_CHECK( (prop_error == vr::TrackedProp_Success) && (std::string(buffer) == "lighthouse") );
+
+    TEST_CHECK( (system->GetFloatTrackedDeviceProperty(0, vr::Prop_DisplayFrequency_Float, &prop_error) == 90.0f) && (prop_error == vr::TrackedProp_Success) );
+    system->GetInt32TrackedDeviceProperty(0, vr::Prop_DisplayFrequency_Float, &prop_error);
+    TEST_CHECK(prop_error == vr::TrackedProp_WrongDataType);
+    system->GetFloatTrackedDeviceProperty(0, vr::Prop_UserIpdMeters_Float, &prop_error);
+    TEST_CHECK(prop_error == vr::TrackedProp_UnknownProperty);
+}
+
+static void TestEvents()
+{
+    InitRuntime();
+
+    vr::VROverlayHandle_t handle_a, handle_b;
+    vr::VROverlay()->CreateOverlay("key.a", "A", &handle_a);
+    vr::VROverlay()->CreateOverlay("key.b", "B", &handle_b);
+
+    vr::VREvent_t vr_event = {};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        vr_event.eventType = vr::VREvent_MouseMove;
+        vr_event.data.mouse.x = (float)i;
+        HeadlessVR::QueueOverlayEvent((i == 1) ? handle_b : handle_a, vr_event);
+    }
+
+    vr_event.eventType = vr::VREvent_Quit;
+    HeadlessVR::QueueSystemEvent(vr_event);
+    TEST_CHECK(HeadlessVR::GetPendingEventCount() == 4);
+
+    //Per overlay in queue order
+    vr::VREvent_t event_out;
+    TEST_CHECK( (vr::VROverlay()->PollNextOverlayEvent(handle_a, &event_out, sizeof(event_out))) && (event_out.data.mouse.x == 0.0f) );
+    TEST_CHECK( (vr::VROverlay()->PollNextOverlayEvent(handle_a, &event_out, sizeof(event_out))) && (event_out.data.mouse.x == 2.0f) );
+    TEST_CHECK(!vr::VROverlay()->PollNextOverlayEvent(handle_a, &event_out, sizeof(event_out)));
+
+    TEST_CHECK( (vr::VRSystem()->PollNextEvent(&event_out, sizeof(event_out))) && (event_out.eventType == vr::VREvent_Quit) );
+    TEST_CHECK(!vr::VRSystem()->PollNextEvent(&event_out, sizeof(event_out)));
+
+    //Destroying an overlay drops its events
+    vr::VROverlay()->DestroyOverlay(handle_b);
+    TEST_CHECK(HeadlessVR::GetPendingEventCount() == 0);
+}
+
+static void TestInput()
+{
+    InitRuntime();
+    vr::IVRInput* input = vr::VRInput();
+
+    //Names are case-insensitive, handles stay the same for the same name
+    vr::VRActionHandle_t action_digital, action_digital_same, action_analog;
+    input->GetActionHandle("/actions/main/in/Click", &action_digital);
+    input->GetActionHandle("/actions/main/in/click", &action_digital_same);
+    input->GetActionHandle("/actions/main/in/Scroll", &action_analog);
+    TEST_CHECK( (action_digital == action_digital_same) && (action_digital != action_analog) );
+
+    //Scripted states only take effect on UpdateActionState()
+    vr::InputDigitalActionData_t digital_data;
+    HeadlessVR::SetDigitalActionState("/actions/main/in/click", true);
+    TEST_CHECK(input->GetDigitalActionData(action_digital, &digital_data, sizeof(digital_data), vr::k_ulInvalidInputValueHandle) == vr::VRInputError_None);
+    TEST_CHECK(!digital_data.bState);
+
+    input->UpdateActionState(nullptr, sizeof(vr::VRActiveActionSet_t), 0);
+    input->GetDigitalActionData(action_digital, &digital_data, sizeof(digital_data), vr::k_ulInvalidInputValueHandle);
+    TEST_CHECK( (digital_data.bActive) && (digital_data.bState) && (digital_data.bChanged) );
+
+    input->UpdateActionState(nullptr, sizeof(vr::VRActiveActionSet_t), 0);
+    input->GetDigitalActionData(action_digital, &digital_data, sizeof(digital_data), vr::k_ulInvalidInputValueHandle);
+    TEST_CHECK( (digital_data.bState) && (!digital_data.bChanged) );
+
+    HeadlessVR::SetAnalogActionState("/actions/main/in/scroll", 0.5f, -1.0f);
+    input->UpdateActionState(nullptr, sizeof(vr::VRActiveActionSet_t), 0);
+
+    vr::InputAnalogActionData_t analog_data;
+    TEST_CHECK(input->GetAnalogActionData(action_analog, &analog_data, sizeof(analog_data), vr::k_ulInvalidInputValueHandle) == vr::VRInputError_None);
+    TEST_CHECK( (analog_data.x == 0.5f) && (analog_data.y == -1.0f) && (analog_data.deltaX == 0.5f) );
+
+    TEST_CHECK(input->GetDigitalActionData(action_analog, &digital_data, sizeof(digital_data), vr::k_ulInvalidInputValueHandle) == vr::VRInputError_WrongType);
+    TEST_CHECK(input->GetDigitalActionData(action_digital, &digital_data, 4, vr::k_ulInvalidInputValueHandle) == vr::VRInputError_InvalidParam);
+
+    input->TriggerHapticVibrationAction(action_digital, 0.0f, 0.1f, 1.0f, 1.0f, vr::k_ulInvalidInputValueHandle);
+    TEST_CHECK(HeadlessVR::GetHapticPulseCount() == 1);
+}
+
+static void TestCallCounts()
+{
+    InitRuntime();
+
+    vr::VROverlayHandle_t handle;
+    vr::VROverlay()->CreateOverlay("key", "Name", &handle);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        vr::VROverlay()->SetOverlayAlpha(handle, 1.0f);
+    }
+
+    TEST_CHECK(HeadlessVR::GetCallCount("IVROverlay::CreateOverlay") == 1);
+    TEST_CHECK(HeadlessVR::GetCallCount("IVROverlay::SetOverlayAlpha") == 5);
+    TEST_CHECK(HeadlessVR::GetCallCount("IVROverlay::DestroyOverlay") == 0);
+    TEST_CHECK(HeadlessVR::GetTotalCallCount() == 6);
+
+    //Sorted by name, only called functions
+    const std::vector<HeadlessVR::CallCount> call_counts = HeadlessVR::GetCallCounts();
+    TEST_CHECK(call_counts.size() == 2);
+    TEST_CHECK( (call_counts.size() == 2) && (call_counts[0].Function == "IVROverlay::CreateOverlay") && (call_counts[1].Count == 5) );
+
+    HeadlessVR::ResetCallCounts();
+    TEST_CHECK(HeadlessVR::GetTotalCallCount() == 0);
+    TEST_CHECK(HeadlessVR::GetCallCounts().empty());
+}
+
+//Overlays created and modified from several threads at once all end up in a consistent state
+static void TestConcurrent()
+{
+    InitRuntime();
+
+    const int thread_count = 4;
+    const int overlays_per_thread = 50;
+    std::vector<std::thread> threads;
+
+    for (int thread_id = 0; thread_id < thread_count; ++thread_id)
+    {
+        threads.emplace_back([=]()
+        {
+            for (int i = 0; i < overlays_per_thread; ++i)
+            {
+                const std::string key = "key." + std::to_string(thread_id) + "." + std::to_string(i);
+
+                vr::VROverlayHandle_t handle;
+                if (vr::VROverlay()->CreateOverlay(key.c_str(), key.c_str(), &handle) == vr::VROverlayError_None)
+                {
+                    vr::VROverlay()->SetOverlayWidthInMeters(handle, (float)(i + 1));
+                    vr::VROverlay()->ShowOverlay(handle);
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::vector<vr::VROverlayHandle_t> handles = HeadlessVR::GetOverlayHandles();
+    TEST_CHECK(handles.size() == thread_count * overlays_per_thread);
+
+    bool is_consistent = true;
+    for (vr::VROverlayHandle_t handle : handles)
+    {
+        HeadlessVR::OverlayState state;
+        is_consistent &= ( (HeadlessVR::GetOverlayState(handle, state)) && (state.IsVisible) );
+        is_consistent &= (state.WidthInMeters == (float)(std::stoi(state.Key.substr(state.Key.rfind('.') + 1)) + 1));
+    }
+
+    TEST_CHECK(is_consistent);
+    TEST_CHECK(HeadlessVR::GetCallCount("IVROverlay::CreateOverlay") == thread_count * overlays_per_thread);
+    TEST_CHECK(HeadlessVR::GetTotalCallCount() == thread_count * overlays_per_thread * 3);
+}
+
+int main()
+{
+    TEST_RUN(TestInit);
+    TEST_RUN(TestOverlays);
+    TEST_RUN(TestTransforms);
+    TEST_RUN(TestDevices);
+    TEST_RUN(TestEvents);
+    TEST_RUN(TestInput);
+    TEST_RUN(TestCallCounts);
+    TEST_RUN(TestConcurrent);
+
+    return TestResult();
+}
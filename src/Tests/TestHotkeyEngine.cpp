@@ -0,0 +1,288 @@
+#include "TestCommon.h"
+
+#include "HotkeyEngine.h"
+#include "HotkeyReference.h"
+
+#include <algorithm>
+#include <vector>
+
+using HotkeyReference::MakeStroke;
+using HotkeyReference::MakeBinding;
+
+static bool IsTriggered(const std::vector<size_t>& triggered, std::initializer_list<size_t> expected)
+{
+    return (triggered == std::vector<size_t>(expected));
+}
+
+static void TestSingleChord()
+{
+    HotkeyEngine engine;
+    std::vector<size_t> triggered;
+
+    engine.SetBindings({MakeBinding({MakeStroke('A', hotkey_mod_control)}, 1)});
+
+    TEST_CHECK(engine.OnStroke(MakeStroke('A', hotkey_mod_control), 0, triggered));
+    TEST_CHECK(IsTriggered(triggered, {0}));
+    TEST_CHECK(!engine.IsSequencePending());
+    triggered.clear();
+
+    //Modifiers have to match exactly
+    TEST_CHECK(!engine.OnStroke(MakeStroke('A'), 0, triggered));
+    TEST_CHECK(!engine.OnStroke(MakeStroke('A', hotkey_mod_control | hotkey_mod_shift), 0, triggered));
+    TEST_CHECK(triggered.empty());
+
+    //Bindings without strokes or key code are ignored
+    engine.SetBindings({MakeBinding({}, 1), MakeBinding({MakeStroke(0, hotkey_mod_alt)}, 2)});
+    std::vector<HotkeyStroke> expected;
+    engine.GetExpectedStrokes(expected);
+    TEST_CHECK(expected.empty());
+}
+
+//Ctrl+K, Ctrl+O and Ctrl+K, Ctrl+C sequences with Ctrl+K on its own as well
+static void TestSequences()
+{
+    const HotkeyStroke ctrl_k = MakeStroke('K', hotkey_mod_control);
+    const HotkeyStroke ctrl_o = MakeStroke('O', hotkey_mod_control);
+    const HotkeyStroke ctrl_c = MakeStroke('C', hotkey_mod_control);
+    const HotkeyStroke x      = MakeStroke('X');
+
+    HotkeyEngine engine;
+    std::vector<size_t> triggered;
+    std::vector<HotkeyStroke> expected;
+
+    engine.SetBindings({MakeBinding({ctrl_k, ctrl_o}, 10), MakeBinding({ctrl_k}, 11), MakeBinding({ctrl_k, ctrl_c}, 12), MakeBinding({x}, 13)});
+    engine.SetSequenceTimeout(1000);
+
+    engine.GetExpectedStrokes(expected);
+    TEST_CHECK(expected.size() == 2);
+
+    //Starting the sequence changes the expected strokes to the continuations and the ones starting a new sequence
+    const uint32_t state_id = engine.GetStateID();
+    TEST_CHECK(engine.OnStroke(ctrl_k, 100, triggered));
+    TEST_CHECK( (triggered.empty()) && (engine.IsSequencePending()) && (engine.GetStateID() != state_id) );
+
+    engine.GetExpectedStrokes(expected);
+    TEST_CHECK(expected.size() == 4);
+
+    TEST_CHECK(engine.OnStroke(ctrl_o, 200, triggered));
+    TEST_CHECK( (IsTriggered(triggered, {0})) && (!engine.IsSequencePending()) );
+    triggered.clear();
+
+    //Timing out triggers the binding of what was pressed so far
+    engine.OnStroke(ctrl_k, 1000, triggered);
+    engine.Update(1999, triggered);
+    TEST_CHECK(triggered.empty());
+    engine.Update(2000, triggered);
+    TEST_CHECK( (IsTriggered(triggered, {1})) && (!engine.IsSequencePending()) );
+    triggered.clear();
+
+    //Continuing with a key that doesn't match triggers it as well, the key then starts over
+    engine.OnStroke(ctrl_k, 3000, triggered);
+    TEST_CHECK(engine.OnStroke(x, 3100, triggered));
+    TEST_CHECK(IsTriggered(triggered, {1, 3}));
+    triggered.clear();
+
+    engine.OnStroke(ctrl_k, 4000, triggered);
+    TEST_CHECK(!engine.OnStroke(MakeStroke('Q'), 4100, triggered));
+    TEST_CHECK(IsTriggered(triggered, {1}));
+    triggered.clear();
+
+    //Continuation after the timeout doesn't complete the sequence
+    engine.OnStroke(ctrl_k, 5000, triggered);
+    TEST_CHECK(!engine.OnStroke(ctrl_o, 7000, triggered));
+    TEST_CHECK( (IsTriggered(triggered, {1})) && (!engine.IsSequencePending()) );
+    triggered.clear();
+
+    //Cancelled sequences trigger nothing
+    engine.OnStroke(ctrl_k, 8000, triggered);
+    engine.CancelSequence();
+    engine.Update(99999, triggered);
+    TEST_CHECK(triggered.empty());
+
+    //Ctrl+K delays both longer sequences
+    int prefix_count = 0;
+    for (const HotkeyConflict& conflict : engine.FindConflicts())
+    {
+        TEST_CHECK( (conflict.Type == hotkey_conflict_prefix) && (conflict.BindingA == 1) );
+        prefix_count++;
+    }
+
+    TEST_CHECK(prefix_count == 2);
+}
+
+static void TestScopes()
+{
+    const HotkeyStroke f = MakeStroke('F');
+    const HotkeyStroke g = MakeStroke('G');
+    const HotkeyStroke h = MakeStroke('H');
+    const HotkeyStroke j = MakeStroke('J');
+
+    HotkeyEngine engine;
+    std::vector<size_t> triggered;
+    std::vector<HotkeyStroke> expected;
+
+    engine.SetBindings({MakeBinding({f}, 20), MakeBinding({f}, 21, hotkey_scope_overlay, 3), MakeBinding({f}, 22, hotkey_scope_overlay_group, 1),
+                        MakeBinding({g}, 23, hotkey_scope_overlay, 4), MakeBinding({g}, 24, hotkey_scope_overlay, 4),
+                        MakeBinding({h}, 25, hotkey_scope_overlay, 5), MakeBinding({h, j}, 26)});
+
+    bool overlay_3_active = false, overlay_4_active = true, overlay_5_active = true, group_1_active = false;
+    auto is_scope_active = [&](HotkeyScope scope, int scope_id)
+    {
+        if (scope == hotkey_scope_overlay_group)
+            return group_1_active;
+
+        return (scope_id == 3) ? overlay_3_active : (scope_id == 4) ? overlay_4_active : overlay_5_active;
+    };
+
+    //Most specific active scope wins
+    engine.UpdateActiveState(is_scope_active);
+    engine.OnStroke(f, 0, triggered);
+    TEST_CHECK(IsTriggered(triggered, {0}));
+    triggered.clear();
+
+    group_1_active = true;
+    engine.UpdateActiveState(is_scope_active);
+    engine.OnStroke(f, 0, triggered);
+    TEST_CHECK(IsTriggered(triggered, {2}));
+    triggered.clear();
+
+    overlay_3_active = true;
+    engine.UpdateActiveState(is_scope_active);
+    engine.OnStroke(f, 0, triggered);
+    TEST_CHECK(IsTriggered(triggered, {1}));
+    triggered.clear();
+
+    //Duplicates in the same scope both trigger
+    engine.OnStroke(g, 0, triggered);
+    TEST_CHECK(IsTriggered(triggered, {3, 4}));
+    triggered.clear();
+
+    //Inactive ones don't use the stroke and aren't expected
+    overlay_4_active = false;
+    engine.UpdateActiveState(is_scope_active);
+    TEST_CHECK( (!engine.OnStroke(g, 0, triggered)) && (triggered.empty()) );
+
+    engine.GetExpectedStrokes(expected);
+    TEST_CHECK(expected.size() == 2);
+
+    //Scoped prefix of a global sequence
+    engine.OnStroke(h, 0, triggered);
+    TEST_CHECK( (triggered.empty()) && (engine.IsSequencePending()) );
+    engine.OnStroke(j, 10, triggered);
+    TEST_CHECK(IsTriggered(triggered, {6}));
+    triggered.clear();
+
+    engine.OnStroke(h, 0, triggered);
+    engine.Update(5000, triggered);
+    TEST_CHECK(IsTriggered(triggered, {5}));
+    triggered.clear();
+
+    int duplicate_count = 0, shadowed_count = 0, prefix_count = 0;
+    for (const HotkeyConflict& conflict : engine.FindConflicts())
+    {
+        duplicate_count += (conflict.Type == hotkey_conflict_duplicate);
+        shadowed_count  += (conflict.Type == hotkey_conflict_shadowed);
+        prefix_count    += (conflict.Type == hotkey_conflict_prefix);
+    }
+
+    TEST_CHECK( (duplicate_count == 1) && (shadowed_count == 3) && (prefix_count == 1) );
+
+    //A pending sequence is dropped when its continuation becomes inactive
+    engine.SetBindings({MakeBinding({h, j}, 26, hotkey_scope_overlay, 5)});
+    overlay_5_active = true;
+    engine.UpdateActiveState(is_scope_active);
+
+    engine.OnStroke(h, 0, triggered);
+    TEST_CHECK(engine.IsSequencePending());
+
+    overlay_5_active = false;
+    engine.UpdateActiveState(is_scope_active);
+    TEST_CHECK(!engine.IsSequencePending());
+    TEST_CHECK(triggered.empty());
+}
+
+//Random bindings, scope changes and keystrokes, compared with the reference on every stroke
+//Strokes are also checked against GetExpectedStrokes() as long as no sequence timed out before them
+static void TestRandomStrokes()
+{
+    const uint32_t sequence_timeout = 50;
+
+    TestRandom rng(49);
+    std::vector<HotkeyBinding> bindings;
+
+    for (int i = 0; i < 128; ++i)
+    {
+        std::vector<HotkeyStroke> strokes;
+        const int length = rng.Range(1, 3);
+
+        for (int stroke_id = 0; stroke_id < length; ++stroke_id)
+        {
+            strokes.push_back(MakeStroke((uint8_t)rng.Range('A', 'H'), (uint8_t)(rng.Range(0, 1) * hotkey_mod_control)));
+        }
+
+        bindings.push_back(MakeBinding(strokes, i, (HotkeyScope)rng.Range(0, hotkey_scope_MAX - 1), rng.Range(0, 3)));
+    }
+
+    HotkeyEngine engine;
+    engine.SetBindings(bindings);
+    engine.SetSequenceTimeout(sequence_timeout);
+
+    HotkeyReference::Matcher reference(bindings, sequence_timeout);
+
+    std::vector<HotkeyStroke> expected;
+    std::vector<size_t> triggered, triggered_reference;
+    bool is_matching = true, is_expected_matching = true;
+    uint64_t time_ms = 0;
+    size_t triggered_count = 0, pending_count = 0;
+
+    int active_mask = 0;
+    auto is_scope_active = [&](HotkeyScope scope, int scope_id) { return ( ((active_mask >> (scope * 4 + scope_id)) & 1) != 0 ); };
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i % 16 == 0)
+        {
+            active_mask = rng.Range(0, 0xFFF);
+            engine.UpdateActiveState(is_scope_active);
+            reference.UpdateActiveState(is_scope_active);
+        }
+
+        const HotkeyStroke stroke = MakeStroke((uint8_t)rng.Range('A', 'H'), (uint8_t)(rng.Range(0, 1) * hotkey_mod_control));
+        time_ms += rng.Range(1, 60);
+
+        engine.GetExpectedStrokes(expected);
+        const bool is_stroke_expected = (std::find(expected.begin(), expected.end(), stroke) != expected.end());
+        const bool is_timed_out = reference.IsTimedOut(time_ms);
+
+        triggered.clear();
+        triggered_reference.clear();
+        const bool is_used = engine.OnStroke(stroke, time_ms, triggered);
+
+        is_matching &= (is_used == reference.OnStroke(stroke, time_ms, triggered_reference));
+        is_matching &= (triggered == triggered_reference);
+
+        if (!is_timed_out)
+        {
+            is_expected_matching &= (is_used == is_stroke_expected);
+        }
+
+        triggered_count += triggered.size();
+        pending_count   += engine.IsSequencePending();
+    }
+
+    TEST_CHECK(is_matching);
+    TEST_CHECK(is_expected_matching);
+
+    //Make sure both came up a fair amount
+    TEST_CHECK( (triggered_count > 1000) && (pending_count > 1000) );
+}
+
+int main()
+{
+    TEST_RUN(TestSingleChord);
+    TEST_RUN(TestSequences);
+    TEST_RUN(TestScopes);
+    TEST_RUN(TestRandomStrokes);
+
+    return TestResult();
+}
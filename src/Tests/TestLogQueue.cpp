@@ -0,0 +1,410 @@
+#include "TestCommon.h"
+
+#include "LogQueue.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* const g_LogPath = "TestLogQueue.log";
+
+static std::wstring MakeText(size_t length, wchar_t c = L'x')
+{
+    return std::wstring(length, c);
+}
+
+static LogEntry MakeEntry(LogSeverity severity, int64_t time, const wchar_t* str)
+{
+    LogEntry entry;
+    entry.Severity = severity;
+    entry.Time     = time;
+    entry.Length   = (uint32_t)wcslen(str);
+    std::wcsncpy(entry.Text, str, LogEntry::MaxLength + 1);
+
+    return entry;
+}
+
+static void TestPushPop()
+{
+    std::unique_ptr<LogQueue> queue(new LogQueue());
+    std::unique_ptr<LogEntry> entry(new LogEntry());
+
+    TEST_CHECK(!queue->Pop(*entry));
+    TEST_CHECK(!queue->HasPending());
+
+    TEST_CHECK(queue->Push(log_severity_warning, 10, L"First"));
+    TEST_CHECK(queue->Push(log_severity_error,   20, L"Second"));
+    TEST_CHECK(queue->HasPending());
+
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Severity == log_severity_warning) && (entry->Time == 10) && (std::wstring(entry->Text) == L"First") && (entry->Length == 5) );
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Severity == log_severity_error)   && (entry->Time == 20) && (std::wstring(entry->Text) == L"Second") );
+    TEST_CHECK(!queue->Pop(*entry));
+    TEST_CHECK(!queue->HasPending());
+}
+
+//Line breaks become spaces, with CRLF folded into a single one
+static void TestTextFolding()
+{
+    std::unique_ptr<LogQueue> queue(new LogQueue());
+    std::unique_ptr<LogEntry> entry(new LogEntry());
+
+    queue->Push(log_severity_error, 0, L"Line 1\r\nLine 2\nLine 3\r\n");
+    TEST_CHECK( (queue->Pop(*entry)) && (std::wstring(entry->Text) == L"Line 1 Line 2 Line 3 ") && (entry->Length == 21) );
+
+    //Lone CR is kept
+    queue->Push(log_severity_error, 0, L"A\rB\n\nC");
+    TEST_CHECK( (queue->Pop(*entry)) && (std::wstring(entry->Text) == L"A\rB  C") );
+
+    queue->Push(log_severity_error, 0, L"");
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Length == 0) && (entry->Text[0] == L'\0') );
+
+    //Truncated to MaxLength
+    const std::wstring text_long = MakeText(LogEntry::MaxLength * 2);
+    queue->Push(log_severity_error, 0, text_long.c_str());
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Length == LogEntry::MaxLength) && (entry->Text[LogEntry::MaxLength] == L'\0') &&
+                (std::wstring(entry->Text) == text_long.substr(0, LogEntry::MaxLength)) );
+
+    const std::wstring text_exact = MakeText(LogEntry::MaxLength);
+    queue->Push(log_severity_error, 0, text_exact.c_str());
+    TEST_CHECK( (queue->Pop(*entry)) && (std::wstring(entry->Text) == text_exact) );
+
+    //CRLF right at the end of the space still counts as one character
+    const std::wstring text_crlf = MakeText(LogEntry::MaxLength - 1) + L"\r\nMore";
+    queue->Push(log_severity_error, 0, text_crlf.c_str());
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Length == LogEntry::MaxLength) && (entry->Text[LogEntry::MaxLength - 1] == L' ') );
+}
+
+static void TestFull()
+{
+    std::unique_ptr<LogQueue> queue(new LogQueue());
+    std::unique_ptr<LogEntry> entry(new LogEntry());
+
+    bool is_pushed = true;
+    for (uint32_t i = 0; i < LogQueue::Capacity; ++i)
+    {
+        is_pushed &= queue->Push(log_severity_info, i, L"Message");
+    }
+
+    TEST_CHECK(is_pushed);
+    TEST_CHECK(queue->GetDroppedCount() == 0);
+
+    //Full queue drops and counts every further message
+    TEST_CHECK(!queue->Push(log_severity_info, 1000, L"Dropped"));
+    TEST_CHECK(!queue->Push(log_severity_info, 1001, L"Dropped"));
+    TEST_CHECK(queue->GetDroppedCount() == 2);
+
+    //Reading one makes room for one
+    TEST_CHECK( (queue->Pop(*entry)) && (entry->Time == 0) );
+    TEST_CHECK(queue->Push(log_severity_info, 2000, L"Last"));
+    TEST_CHECK(!queue->Push(log_severity_info, 2001, L"Dropped"));
+    TEST_CHECK(queue->GetDroppedCount() == 3);
+
+    //Still in order, with none of the dropped ones in it
+    bool is_ordered = true;
+    uint32_t pop_count = 0;
+    int64_t time_last = 0;
+    while (queue->Pop(*entry))
+    {
+        is_ordered &= (entry->Time > time_last);
+        time_last = entry->Time;
+        pop_count++;
+    }
+
+    TEST_CHECK(is_ordered);
+    TEST_CHECK( (pop_count == LogQueue::Capacity) && (time_last == 2000) );
+}
+
+//Producers pushing as fast as they can while the consumer reads. Every message is either read intact and in order per producer or counted as dropped
+static void TestMultiProducerStress()
+{
+    const int producer_count = 4;
+    const uint32_t message_count = 50000;
+
+    std::unique_ptr<LogQueue> queue(new LogQueue());
+    std::vector<std::thread> producers;
+    std::vector<uint64_t> dropped_counts(producer_count, 0);
+
+    for (int producer_id = 0; producer_id < producer_count; ++producer_id)
+    {
+        producers.emplace_back([&, producer_id]()
+        {
+            wchar_t text[64];
+
+            for (uint32_t i = 0; i < message_count; ++i)
+            {
+                std::swprintf(text, 64, L"Producer %d message %u\r\n", producer_id, i);
+
+                if (!queue->Push((LogSeverity)(producer_id % 4), ((int64_t)producer_id << 32) | i, text))
+                {
+                    dropped_counts[producer_id]++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::unique_ptr<LogEntry> entry(new LogEntry());
+    std::vector<int64_t> index_last(producer_count, -1);
+    bool is_intact = true, is_ordered = true;
+    uint64_t pop_count = 0;
+    wchar_t text_expected[64];
+
+    auto pop_all = [&]()
+    {
+        while (queue->Pop(*entry))
+        {
+            const int producer_id = (int)(entry->Time >> 32);
+            const int64_t index   = entry->Time & 0xFFFFFFFF;
+
+            if ( (producer_id < 0) || (producer_id >= producer_count) )
+            {
+                is_intact = false;
+                continue;
+            }
+
+            //CRLF at the end folded into a space
+            std::swprintf(text_expected, 64, L"Producer %d message %u ", producer_id, (uint32_t)index);
+
+            is_intact  &= ( (entry->Severity == (LogSeverity)(producer_id % 4)) && (std::wstring(entry->Text) == text_expected) && (entry->Length == wcslen(text_expected)) );
+            is_ordered &= (index > index_last[producer_id]);
+            index_last[producer_id] = index;
+            pop_count++;
+        }
+    };
+
+    bool is_running = true;
+    while (is_running)
+    {
+        pop_all();
+
+        is_running = (pop_count + queue->GetDroppedCount() < (uint64_t)producer_count * message_count);
+        std::this_thread::yield();
+    }
+
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    pop_all();
+
+    uint64_t dropped_total = 0;
+    for (uint64_t dropped_count : dropped_counts)
+    {
+        dropped_total += dropped_count;
+    }
+
+    TEST_CHECK(is_intact);
+    TEST_CHECK(is_ordered);
+    TEST_CHECK(queue->GetDroppedCount() == dropped_total);
+    TEST_CHECK(pop_count + dropped_total == (uint64_t)producer_count * message_count);
+    TEST_CHECK(pop_count > 0);
+    TEST_CHECK(!queue->HasPending());
+}
+
+struct RateLimiterReport
+{
+    LogSeverity Severity;
+    std::wstring Text;
+    uint32_t SuppressedCount;
+};
+
+static void TestRateLimiter()
+{
+    LogRateLimiter limiter;
+    std::vector<RateLimiterReport> reports;
+    auto report = [&](LogSeverity severity, const std::wstring& text, uint32_t suppressed_count) { reports.push_back({severity, text, suppressed_count}); };
+
+    const LogEntry entry       = MakeEntry(log_severity_error,   100, L"Repeated");
+    const LogEntry entry_other = MakeEntry(log_severity_warning, 100, L"Repeated");
+
+    //Up to MaxPerWindow pass, the rest is suppressed
+    int pass_count = 0;
+    for (int i = 0; i < 12; ++i)
+    {
+        pass_count += limiter.Check(entry);
+    }
+    TEST_CHECK(pass_count == (int)LogRateLimiter::MaxPerWindow);
+
+    //Same text with a different severity is a different message
+    TEST_CHECK(limiter.Check(entry_other));
+
+    //Nothing reported before the window is over
+    limiter.Expire(100 + LogRateLimiter::WindowSeconds - 1, report);
+    TEST_CHECK(reports.empty());
+    TEST_CHECK(!limiter.Check(entry));
+
+    //Window over, suppressed count reported once. Messages that weren't suppressed aren't reported
+    limiter.Expire(100 + LogRateLimiter::WindowSeconds, report);
+    TEST_CHECK(reports.size() == 1);
+    TEST_CHECK( (reports[0].Severity == log_severity_error) && (reports[0].Text == L"Repeated") && (reports[0].SuppressedCount == 13 - LogRateLimiter::MaxPerWindow) );
+
+    limiter.Expire(INT64_MAX, report);
+    TEST_CHECK(reports.size() == 1);
+
+    //New window starts with the next message
+    reports.clear();
+    const LogEntry entry_later = MakeEntry(log_severity_error, 1000, L"Repeated");
+    pass_count = 0;
+    for (int i = 0; i < 7; ++i)
+    {
+        pass_count += limiter.Check(entry_later);
+    }
+    TEST_CHECK(pass_count == (int)LogRateLimiter::MaxPerWindow);
+
+    //Ending all windows reports the rest, e.g. on exit
+    limiter.Expire(INT64_MAX, report);
+    TEST_CHECK( (reports.size() == 1) && (reports[0].SuppressedCount == 2) );
+
+    //Only the most recent messages are tracked, the one with the oldest window is forgotten
+    reports.clear();
+    for (int i = 0; i < 8; ++i)
+    {
+        limiter.Check(entry);
+    }
+
+    for (size_t i = 0; i < LogRateLimiter::MaxTracked; ++i)
+    {
+        const std::wstring text = L"Other " + std::to_wstring(i);
+        limiter.Check(MakeEntry(log_severity_error, 200, text.c_str()));
+    }
+
+    TEST_CHECK(limiter.Check(entry));
+    limiter.Expire(INT64_MAX, report);
+    TEST_CHECK(reports.empty());
+}
+
+static std::vector<std::string> ReadLines(const std::string& path)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+static bool IsFileExisting(const std::string& path)
+{
+    return std::ifstream(path).is_open();
+}
+
+static void RemoveLogFiles()
+{
+    std::remove(g_LogPath);
+
+    for (int i = 1; i <= 3; ++i)
+    {
+        std::remove((std::string(g_LogPath) + "." + std::to_string(i)).c_str());
+    }
+}
+
+static void TestFileWriter()
+{
+    RemoveLogFiles();
+
+    {
+        LogFileWriter writer(g_LogPath, 1024 * 1024, 2);
+        writer.Write(log_severity_error,   std::time(nullptr), L"Error message");
+        writer.Write(log_severity_warning, std::time(nullptr), L"Warning message");
+        writer.Write(log_severity_info,    std::time(nullptr), L"Info message");
+        writer.Write(log_severity_debug,   std::time(nullptr), L"Debug message");
+        writer.Close();
+    }
+
+    //Timestamp in front, severity prefix for everything but errors
+    const std::vector<std::string> lines = ReadLines(g_LogPath);
+    TEST_CHECK(lines.size() == 4);
+
+    bool is_timestamped = true;
+    for (const std::string& line : lines)
+    {
+        is_timestamped &= ( (line.size() > 19) && (line[0] == '[') && (line[5] == '-') && (line[8] == '-') && (line[14] == ':') && (line[17] == ']') && (line[18] == ' ') );
+    }
+
+    TEST_CHECK(is_timestamped);
+    TEST_CHECK( (lines.size() == 4) && (lines[0].substr(19) == "Error message") && (lines[1].substr(19) == "Warning: Warning message") &&
+                (lines[2].substr(19) == "Info: Info message") && (lines[3].substr(19) == "Debug: Debug message") );
+
+    RemoveLogFiles();
+}
+
+//Every line written here is 50 bytes, so the 200 byte files rotate after 4 lines
+static void TestFileRotation()
+{
+    const uint64_t max_size = 200;
+    const std::string path  = g_LogPath;
+
+    RemoveLogFiles();
+
+    LogFileWriter writer(path, max_size, 2);
+
+    auto write_batch = [&](wchar_t c)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            writer.Write(log_severity_error, std::time(nullptr), MakeText(30, c).c_str());
+        }
+    };
+
+    write_batch(L'a');
+    TEST_CHECK( (!IsFileExisting(path)) && (ReadLines(path + ".1").size() == 4) );
+
+    write_batch(L'b');
+    write_batch(L'c');
+
+    //Oldest batch is gone, the others moved along
+    const std::vector<std::string> lines_1 = ReadLines(path + ".1");
+    const std::vector<std::string> lines_2 = ReadLines(path + ".2");
+
+    TEST_CHECK( (lines_1.size() == 4) && (lines_1[0].substr(19) == std::string(30, 'c')) );
+    TEST_CHECK( (lines_2.size() == 4) && (lines_2[0].substr(19) == std::string(30, 'b')) );
+    TEST_CHECK(!IsFileExisting(path + ".3"));
+
+    //Size of an existing file counts towards the limit when it's opened again
+    writer.Write(log_severity_error, std::time(nullptr), MakeText(30, L'd').c_str());
+    writer.Write(log_severity_error, std::time(nullptr), MakeText(30, L'd').c_str());
+    writer.Close();
+
+    LogFileWriter writer_reopened(path, max_size, 2);
+    writer_reopened.Write(log_severity_error, std::time(nullptr), MakeText(30, L'e').c_str());
+    writer_reopened.Close();
+    TEST_CHECK(ReadLines(path).size() == 3);
+    writer_reopened.Write(log_severity_error, std::time(nullptr), MakeText(30, L'e').c_str());
+
+    const std::vector<std::string> lines_reopened = ReadLines(path + ".1");
+    TEST_CHECK( (!IsFileExisting(path)) && (lines_reopened.size() == 4) && (lines_reopened[0].substr(19) == std::string(30, 'd')) &&
+                (lines_reopened[3].substr(19) == std::string(30, 'e')) );
+
+    //Without backups the file is just started over
+    RemoveLogFiles();
+    LogFileWriter writer_no_backup(path, max_size, 0);
+    for (int i = 0; i < 5; ++i)
+    {
+        writer_no_backup.Write(log_severity_error, std::time(nullptr), MakeText(30).c_str());
+    }
+    writer_no_backup.Close();
+
+    TEST_CHECK( (ReadLines(path).size() == 1) && (!IsFileExisting(path + ".1")) );
+
+    RemoveLogFiles();
+}
+
+int main()
+{
+    TEST_RUN(TestPushPop);
+    TEST_RUN(TestTextFolding);
+    TEST_RUN(TestFull);
+    TEST_RUN(TestMultiProducerStress);
+    TEST_RUN(TestRateLimiter);
+    TEST_RUN(TestFileWriter);
+    TEST_RUN(TestFileRotation);
+
+    return TestResult();
+}
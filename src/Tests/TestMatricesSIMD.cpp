@@ -0,0 +1,270 @@
+#include "TestCommon.h"
+
+#include "Matrices.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+//SIMD results are expected to be bit-identical to the scalar versions, see MatricesSIMD.h
+//Differences are measured in units in the last place so a failure shows how far off it is
+static const uint32_t g_MaxULPDistance = 0;
+
+static uint32_t ULPDistance(float a, float b)
+{
+    //NaN only matches NaN
+    if ( (std::isnan(a)) || (std::isnan(b)) )
+        return ( (std::isnan(a)) && (std::isnan(b)) ) ? 0 : std::numeric_limits<uint32_t>::max();
+
+    //Map to a continuous integer range, -0 and +0 being different is still picked up below
+    int32_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(float));
+    std::memcpy(&ib, &b, sizeof(float));
+    ia = (ia < 0) ? (INT32_MIN - ia) : ia;
+    ib = (ib < 0) ? (INT32_MIN - ib) : ib;
+
+    const int64_t distance = (int64_t)ia - (int64_t)ib;
+
+    //Sign of zero matters for what ends up in the OpenVR matrices later
+    if ( (distance == 0) && (std::signbit(a) != std::signbit(b)) )
+        return 1;
+
+    return (uint32_t)std::min<int64_t>(std::abs(distance), std::numeric_limits<uint32_t>::max());
+}
+
+static uint32_t MaxULPDistance(const float* a, const float* b, int count)
+{
+    uint32_t distance_max = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        distance_max = std::max(distance_max, ULPDistance(a[i], b[i]));
+    }
+
+    return distance_max;
+}
+
+static void RandomAffine(TestRandom& rng, float* m)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        m[i] = rng.RangeFloat(-10.0f, 10.0f);
+    }
+
+    m[3] = m[7] = m[11] = 0.0f;
+    m[15] = 1.0f;
+
+    //Zero translation, which has to stay -0 or +0 the same way as in the scalar code
+    if (rng.Range(0, 6) == 0)
+    {
+        m[12] = 0.0f;
+    }
+}
+
+static void TestMultiply()
+{
+    TestRandom rng(44);
+    uint32_t distance_max = 0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        float a[16], b[16], out_scalar[16], out[16];
+
+        for (int j = 0; j < 16; ++j)
+        {
+            a[j] = rng.RangeFloat(-100.0f, 100.0f);
+            b[j] = rng.RangeFloat(-100.0f, 100.0f);
+        }
+
+        matrix4MultiplyScalar(a, b, out_scalar);
+        matrix4Multiply(a, b, out);
+        distance_max = std::max(distance_max, MaxULPDistance(out_scalar, out, 16));
+
+        //Through Matrix4 as well
+        const Matrix4 product = Matrix4(a) * Matrix4(b);
+        distance_max = std::max(distance_max, MaxULPDistance(out_scalar, product.get(), 16));
+    }
+
+    TEST_CHECK(distance_max <= g_MaxULPDistance);
+}
+
+static void TestTransform()
+{
+    TestRandom rng(45);
+    uint32_t distance_max = 0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        float m[16], v[4], out_scalar[4], out[4];
+        RandomAffine(rng, m);
+
+        for (float& value : v)
+        {
+            value = rng.RangeFloat(-5.0f, 5.0f);
+        }
+
+        matrix4TransformVector4Scalar(m, v, out_scalar);
+        matrix4TransformVector4(m, v, out);
+        distance_max = std::max(distance_max, MaxULPDistance(out_scalar, out, 4));
+
+        //Only xyz written for Vector3
+        out[3] = 123.0f;
+        matrix4TransformVector3Scalar(m, v, out_scalar);
+        matrix4TransformVector3(m, v, out);
+        distance_max = std::max(distance_max, MaxULPDistance(out_scalar, out, 3));
+        TEST_CHECK(out[3] == 123.0f);
+    }
+
+    TEST_CHECK(distance_max <= g_MaxULPDistance);
+}
+
+static void TestTransformPoints()
+{
+    TestRandom rng(46);
+    uint32_t distance_max = 0;
+    bool is_single_matching = true;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        float m[16];
+        RandomAffine(rng, m);
+
+        //Odd counts and a guard value behind the last point, which must not be written
+        const size_t count = (size_t)rng.Range(0, 33);
+        std::vector<float> points(count * 3 + 1), points_scalar(count * 3 + 1, 0.0f), points_out(count * 3 + 1, 0.0f);
+
+        for (float& value : points)
+        {
+            value = rng.RangeFloat(-4.0f, 4.0f);
+        }
+
+        points_scalar.back() = points_out.back() = 7.0f;
+
+        matrix4TransformPointsScalar(m, points.data(), points_scalar.data(), count);
+        matrix4TransformPoints(m, points.data(), points_out.data(), count);
+        distance_max = std::max(distance_max, MaxULPDistance(points_scalar.data(), points_out.data(), (int)points.size()));
+
+        //Same as transforming each point on its own with w = 1
+        const Matrix4 matrix(m);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            const Vector4 point = matrix * Vector4(points[j * 3], points[j * 3 + 1], points[j * 3 + 2], 1.0f);
+            is_single_matching &= (MaxULPDistance(&point.x, &points_out[j * 3], 3) <= g_MaxULPDistance);
+        }
+
+        //In-place
+        matrix.transformPoints((const Vector3*)points.data(), (Vector3*)points.data(), count);
+        distance_max = std::max(distance_max, MaxULPDistance(points_scalar.data(), points.data(), (int)count * 3));
+    }
+
+    TEST_CHECK(distance_max <= g_MaxULPDistance);
+    TEST_CHECK(is_single_matching);
+}
+
+//Matrix3::invert() plus the translation part, which is what Matrix4::invertAffine() did before it used MatricesSIMD.h
+static void InvertAffineReference(float* m)
+{
+    Matrix3 r(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]);
+    r.invert();
+    m[0] = r[0];  m[1] = r[1];  m[2] = r[2];
+    m[4] = r[3];  m[5] = r[4];  m[6] = r[5];
+    m[8] = r[6];  m[9] = r[7];  m[10]= r[8];
+
+    const float x = m[12], y = m[13], z = m[14];
+    m[12] = -(r[0] * x + r[3] * y + r[6] * z);
+    m[13] = -(r[1] * x + r[4] * y + r[7] * z);
+    m[14] = -(r[2] * x + r[5] * y + r[8] * z);
+}
+
+static void TestInvertAffine()
+{
+    TestRandom rng(47);
+    uint32_t distance_max_scalar = 0, distance_max = 0;
+    int singular_count = 0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        float m[16];
+        RandomAffine(rng, m);
+
+        //Some that can't be inverted, third column a multiple of the second
+        if (i % 50 == 0)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                m[8 + j] = m[4 + j] * 2.0f;
+            }
+
+            singular_count++;
+        }
+
+        float m_reference[16], m_scalar[16], m_simd[16];
+        std::memcpy(m_reference, m, sizeof(m));
+        std::memcpy(m_scalar,    m, sizeof(m));
+        std::memcpy(m_simd,      m, sizeof(m));
+
+        InvertAffineReference(m_reference);
+        matrix4InvertAffineScalar(m_scalar);
+        matrix4InvertAffine(m_simd);
+
+        distance_max_scalar = std::max(distance_max_scalar, MaxULPDistance(m_reference, m_scalar, 16));
+        distance_max        = std::max(distance_max,        MaxULPDistance(m_reference, m_simd,   16));
+    }
+
+    TEST_CHECK(singular_count > 0);
+    TEST_CHECK(distance_max_scalar <= g_MaxULPDistance);
+    TEST_CHECK(distance_max <= g_MaxULPDistance);
+}
+
+//Singular and NaN matrices give the same result as Matrix3::invert() did: identity for the former, NaN for the latter
+static void TestInvertAffineSpecial()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+
+    const float m_zero[16]      = {0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f,  1.0f, 2.0f, 3.0f, 1.0f};
+    const float m_nan[16]       = {1.0f, 0.0f, 0.0f, 0.0f,  0.0f, nan,  0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  1.0f, 2.0f, 3.0f, 1.0f};
+    const float m_inf[16]       = {inf,  0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  1.0f, 2.0f, 3.0f, 1.0f};
+    const float m_nan_trans[16] = {2.0f, 0.0f, 0.0f, 0.0f,  0.0f, 2.0f, 0.0f, 0.0f,  0.0f, 0.0f, 2.0f, 0.0f,  nan,  2.0f, 3.0f, 1.0f};
+
+    for (const float* m : {m_zero, m_nan, m_inf, m_nan_trans})
+    {
+        float m_reference[16], m_scalar[16], m_simd[16];
+        std::memcpy(m_reference, m, sizeof(m_reference));
+        std::memcpy(m_scalar,    m, sizeof(m_scalar));
+        std::memcpy(m_simd,      m, sizeof(m_simd));
+
+        InvertAffineReference(m_reference);
+        matrix4InvertAffineScalar(m_scalar);
+        matrix4InvertAffine(m_simd);
+
+        TEST_CHECK(MaxULPDistance(m_reference, m_scalar, 16) == 0);
+        TEST_CHECK(MaxULPDistance(m_reference, m_simd,   16) == 0);
+    }
+
+    //Singular: identity rotation, translation negated
+    float m[16];
+    std::memcpy(m, m_zero, sizeof(m));
+    Matrix4 matrix(m);
+    matrix.invertAffine();
+    TEST_CHECK( (matrix[0] == 1.0f) && (matrix[5] == 1.0f) && (matrix[10] == 1.0f) && (matrix[4] == 0.0f) );
+    TEST_CHECK( (matrix[12] == -1.0f) && (matrix[13] == -2.0f) && (matrix[14] == -3.0f) );
+
+    //NaN determinant: NaN, not identity
+    std::memcpy(m, m_nan, sizeof(m));
+    matrix = Matrix4(m);
+    matrix.invertAffine();
+    TEST_CHECK( (std::isnan(matrix[0])) && (std::isnan(matrix[5])) && (std::isnan(matrix[12])) );
+}
+
+int main()
+{
+    TEST_RUN(TestMultiply);
+    TEST_RUN(TestTransform);
+    TEST_RUN(TestTransformPoints);
+    TEST_RUN(TestInvertAffine);
+    TEST_RUN(TestInvertAffineSpecial);
+
+    return TestResult();
+}
@@ -0,0 +1,248 @@
+#include "TestCommon.h"
+
+#include "MoveRectPlanner.h"
+
+#include <vector>
+
+//CPU pixel buffer standing in for the desktop texture, each pixel starting out with a unique value
+class TestSurface
+{
+    public:
+        int Width;
+        int Height;
+        std::vector<uint32_t> Pixels;
+
+        TestSurface(int width, int height) : Width(width), Height(height), Pixels((size_t)width * height)
+        {
+            for (size_t i = 0; i < Pixels.size(); ++i)
+            {
+                Pixels[i] = (uint32_t)i * 2654435761u;
+            }
+        }
+
+        uint32_t& At(int x, int y) { return Pixels[(size_t)y * Width + x]; }
+
+        bool Contains(const MovePlanRect& rect) const
+        {
+            return ( (rect.Left >= 0) && (rect.Top >= 0) && (rect.Right <= Width) && (rect.Bottom <= Height) );
+        }
+};
+
+//What DXGI move rects mean: each move reads the whole source as left by the previous moves, as if copied through a temporary
+static void ApplyMovesReference(TestSurface& surface, const std::vector<MovePlanMove>& moves)
+{
+    for (const MovePlanMove& move : moves)
+    {
+        const TestSurface snapshot = surface;
+        const MovePlanRect& src = move.Source;
+
+        for (int y = src.Top; y < src.Bottom; ++y)
+        {
+            for (int x = src.Left; x < src.Right; ++x)
+            {
+                surface.At(move.DestX + x - src.Left, move.DestY + y - src.Top) = snapshot.Pixels[(size_t)y * snapshot.Width + x];
+            }
+        }
+    }
+}
+
+//Executes the plan like DISPLAYMANAGER::CopyMove() does, checking each copy is valid for CopySubresourceRegion() on the way
+static bool ApplyPlan(TestSurface& surface, const MovePlan& plan)
+{
+    TestSurface scratch(std::max(plan.ScratchWidth, 1), std::max(plan.ScratchHeight, 1));
+    bool is_valid = true;
+
+    for (const MovePlanCopy& copy : plan.Copies)
+    {
+        const int width  = copy.Source.GetWidth();
+        const int height = copy.Source.GetHeight();
+        const MovePlanRect dest = {copy.DestX, copy.DestY, copy.DestX + width, copy.DestY + height};
+
+        is_valid &= (!copy.Source.IsEmpty());
+
+        TestSurface& surface_src  = (copy.Type == moveplan_copy_from_scratch) ? scratch : surface;
+        TestSurface& surface_dest = (copy.Type == moveplan_copy_to_scratch)   ? scratch : surface;
+
+        if (copy.Type != moveplan_copy_direct)
+        {
+            //Scratch copies stay within the planned scratch size
+            const MovePlanRect& scratch_rect = (copy.Type == moveplan_copy_to_scratch) ? dest : copy.Source;
+            is_valid &= ( (scratch_rect.Right <= plan.ScratchWidth) && (scratch_rect.Bottom <= plan.ScratchHeight) );
+        }
+        else
+        {
+            //Copies within the same surface must not overlap
+            is_valid &= (!copy.Source.Overlaps(dest));
+        }
+
+        is_valid &= ( (surface_src.Contains(copy.Source)) && (surface_dest.Contains(dest)) );
+
+        if (!is_valid)
+            return false;
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                surface_dest.At(dest.Left + x, dest.Top + y) = surface_src.At(copy.Source.Left + x, copy.Source.Top + y);
+            }
+        }
+    }
+
+    return is_valid;
+}
+
+static MovePlanMove RandomMove(TestRandom& rng, int width, int height)
+{
+    const int move_width  = rng.Range(0, width);
+    const int move_height = rng.Range(0, height);
+    const int src_x = rng.Range(0, width  - move_width);
+    const int src_y = rng.Range(0, height - move_height);
+
+    MovePlanMove move = {{src_x, src_y, src_x + move_width, src_y + move_height}, src_x, src_y};
+
+    //Mostly scrolling along one axis, like the moves reported for actual desktop content
+    switch (rng.Range(0, 3))
+    {
+        case 0: move.DestY = rng.Range(0, height - move_height); break;
+        case 1: move.DestX = rng.Range(0, width  - move_width);  break;
+        case 2:
+        {
+            move.DestX = rng.Range(0, width  - move_width);
+            move.DestY = rng.Range(0, height - move_height);
+            break;
+        }
+        default: break;                                             //Not moving at all
+    }
+
+    return move;
+}
+
+//Random move lists on small surfaces, where all copy types show up, give the same result as the reference
+static void TestAgainstReference()
+{
+    TestRandom rng(41);
+    MovePlan plan;
+    int copy_type_counts[3] = {0};
+    bool is_matching = true, is_valid = true;
+
+    for (int iteration = 0; iteration < 20000; ++iteration)
+    {
+        const int width  = rng.Range(1, 97);
+        const int height = rng.Range(1, 71);
+
+        std::vector<MovePlanMove> moves(rng.Range(1, 4));
+        for (MovePlanMove& move : moves)
+        {
+            move = RandomMove(rng, width, height);
+        }
+
+        TestSurface surface_reference(width, height);
+        TestSurface surface_planned(width, height);
+
+        ApplyMovesReference(surface_reference, moves);
+
+        //Reusing the plan from the previous iteration
+        PlanMoveRects(moves.data(), moves.size(), plan);
+        is_valid    &= ApplyPlan(surface_planned, plan);
+        is_matching &= (surface_planned.Pixels == surface_reference.Pixels);
+
+        for (const MovePlanCopy& copy : plan.Copies)
+        {
+            copy_type_counts[copy.Type]++;
+        }
+
+        //One dirty rect per non-empty move, at its destination
+        size_t dirty_index = 0;
+        for (const MovePlanMove& move : moves)
+        {
+            if (move.Source.IsEmpty())
+                continue;
+
+            const MovePlanRect& dirty = (dirty_index < plan.DirtyRects.size()) ? plan.DirtyRects[dirty_index] : move.Source;
+            is_valid &= ( (dirty.Left == move.DestX) && (dirty.Top == move.DestY) && (dirty.GetWidth() == move.Source.GetWidth()) && (dirty.GetHeight() == move.Source.GetHeight()) );
+            dirty_index++;
+        }
+
+        is_valid &= (dirty_index == plan.DirtyRects.size());
+    }
+
+    TEST_CHECK(is_matching);
+    TEST_CHECK(is_valid);
+
+    //Make sure the random moves actually covered every path
+    TEST_CHECK(copy_type_counts[moveplan_copy_direct] > 0);
+    TEST_CHECK(copy_type_counts[moveplan_copy_to_scratch] > 0);
+    TEST_CHECK(copy_type_counts[moveplan_copy_from_scratch] == copy_type_counts[moveplan_copy_to_scratch]);
+}
+
+//Desktop-sized scrolls, checked against the reference and for the expected strategy
+static void TestScrolling()
+{
+    const int width = 1920, height = 1080;
+    MovePlan plan;
+
+    struct ScrollCase
+    {
+        int Distance;
+        bool ExpectScratch;
+    };
+
+    //Scrolling by a few pixels would need hundreds of strips, larger distances only a few
+    for (const ScrollCase& scroll : {ScrollCase{1, true}, ScrollCase{3, true}, ScrollCase{50, false}, ScrollCase{-120, false}, ScrollCase{540, false}})
+    {
+        const int src_top = (scroll.Distance > 0) ? scroll.Distance : 0;
+        const MovePlanMove move = {{0, src_top, width, height - ((scroll.Distance > 0) ? 0 : -scroll.Distance)}, 0, src_top - scroll.Distance};
+
+        PlanMoveRects(&move, 1, plan);
+
+        TestSurface surface_reference(width, height);
+        TestSurface surface_planned(width, height);
+        ApplyMovesReference(surface_reference, {move});
+
+        TEST_CHECK(ApplyPlan(surface_planned, plan));
+        TEST_CHECK(surface_planned.Pixels == surface_reference.Pixels);
+
+        const bool uses_scratch = (plan.ScratchWidth != 0);
+        TEST_CHECK(uses_scratch == scroll.ExpectScratch);
+
+        if (uses_scratch)
+        {
+            TEST_CHECK( (plan.ScratchWidth == move.Source.GetWidth()) && (plan.ScratchHeight == move.Source.GetHeight()) && (plan.Copies.size() == 2) );
+        }
+        else
+        {
+            TEST_CHECK(plan.Copies.size() == (size_t)((move.Source.GetHeight() + std::abs(scroll.Distance) - 1) / std::abs(scroll.Distance)));
+        }
+    }
+}
+
+static void TestTrivialMoves()
+{
+    MovePlan plan;
+
+    //Empty moves are skipped entirely, moves onto themselves only mark the area dirty
+    const MovePlanMove moves[] = {{{5, 5, 5, 10}, 0, 0}, {{5, 5, 10, 4}, 0, 0}, {{1, 2, 3, 4}, 1, 2}};
+    PlanMoveRects(moves, 3, plan);
+
+    TEST_CHECK(plan.Copies.empty());
+    TEST_CHECK(plan.DirtyRects.size() == 1);
+    TEST_CHECK( (plan.ScratchWidth == 0) && (plan.ScratchHeight == 0) );
+
+    //Non-overlapping moves are a single direct copy
+    const MovePlanMove move_apart = {{0, 0, 10, 10}, 20, 0};
+    PlanMoveRects(&move_apart, 1, plan);
+    TEST_CHECK( (plan.Copies.size() == 1) && (plan.Copies[0].Type == moveplan_copy_direct) );
+
+    PlanMoveRects(nullptr, 0, plan);
+    TEST_CHECK( (plan.Copies.empty()) && (plan.DirtyRects.empty()) );
+}
+
+int main()
+{
+    TEST_RUN(TestAgainstReference);
+    TEST_RUN(TestScrolling);
+    TEST_RUN(TestTrivialMoves);
+
+    return TestResult();
+}
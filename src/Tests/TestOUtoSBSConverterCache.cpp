@@ -0,0 +1,240 @@
+#include "TestCommon.h"
+
+#include "OUtoSBSConverterCache.h"
+
+//Stand-in for OUtoSBSConverter, counting the conversions and failing for crops too small to produce an SBS texture like CreateTexture2D() would
+struct TestConverter
+{
+    int ConvertCount = 0;
+
+    bool Convert(const OUtoSBSRect& crop_rect)
+    {
+        ConvertCount++;
+        return (crop_rect.GetHeight() / 2 > 0);
+    }
+};
+
+typedef OUtoSBSConverterCacheBase<TestConverter> TestConverterCache;
+
+//Stand-in for an overlay's state in OutputManager::ConvertOUtoSBS()
+struct TestOverlay
+{
+    OUtoSBSRect CropRect;
+    uint64_t ConverterEntryID = 0;
+    int TextureSetCount = 0;
+    int FailureReportCount = 0;
+};
+
+//Same flow as OutputManager::ConvertOUtoSBS()
+static void ConvertForOverlay(TestConverterCache& cache, const void* source_texture, TestOverlay& overlay)
+{
+    TestConverterCache::Entry& entry = cache.GetEntry(source_texture, overlay.CropRect);
+
+    if (cache.IsConversionNeeded(entry))
+    {
+        if (!entry.Converter.Convert(overlay.CropRect))
+        {
+            if (cache.SetConversionFailed(entry))
+            {
+                overlay.FailureReportCount++;
+            }
+
+            return;
+        }
+
+        cache.SetConverted(entry);
+    }
+
+    if ( (cache.IsConvertedThisFrame(entry)) || (entry.ID != overlay.ConverterEntryID) )
+    {
+        overlay.TextureSetCount++;
+        overlay.ConverterEntryID = entry.ID;
+    }
+}
+
+static int g_SourceTexture = 0;
+static int g_SourceTextureOther = 0;
+
+static void TestSharedCrop()
+{
+    TestConverterCache cache;
+    TestOverlay overlay_a, overlay_b, overlay_c;
+    overlay_a.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 100);
+    overlay_b.CropRect = overlay_a.CropRect;
+    overlay_c.CropRect = OUtoSBSRect::FromCrop(100, 0, 100, 100);
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_c);
+    cache.EndFrame();
+
+    //Identical crops share one entry and conversion, but both get the texture set
+    TEST_CHECK(cache.GetEntryCount() == 2);
+    TEST_CHECK(cache.GetEntry(&g_SourceTexture, overlay_a.CropRect).Converter.ConvertCount == 1);
+    TEST_CHECK( (overlay_a.ConverterEntryID == overlay_b.ConverterEntryID) && (overlay_a.ConverterEntryID != overlay_c.ConverterEntryID) );
+    TEST_CHECK( (overlay_a.TextureSetCount == 1) && (overlay_b.TextureSetCount == 1) && (overlay_c.TextureSetCount == 1) );
+
+    //Same crop of a different source texture isn't shared
+    cache.BeginFrame();
+    TestOverlay overlay_other;
+    overlay_other.CropRect = overlay_a.CropRect;
+    ConvertForOverlay(cache, &g_SourceTextureOther, overlay_other);
+    TEST_CHECK(overlay_other.ConverterEntryID != overlay_a.ConverterEntryID);
+}
+
+static void TestDirtyRect()
+{
+    TestConverterCache cache;
+    TestOverlay overlay_a, overlay_b;
+    overlay_a.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 100);
+    overlay_b.CropRect = OUtoSBSRect::FromCrop(200, 0, 100, 100);
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    cache.EndFrame();
+
+    //Only the crop the dirty rect overlaps is converted again, the other keeps its texture without setting it again
+    cache.BeginFrame(OUtoSBSRect(50, 50, 60, 60));
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    TEST_CHECK(cache.IsConvertedThisFrame(cache.GetEntry(&g_SourceTexture, overlay_a.CropRect)));
+    TEST_CHECK(!cache.IsConvertedThisFrame(cache.GetEntry(&g_SourceTexture, overlay_b.CropRect)));
+    cache.EndFrame();
+
+    TEST_CHECK( (cache.GetEntry(&g_SourceTexture, overlay_a.CropRect).Converter.ConvertCount == 2) && (overlay_a.TextureSetCount == 2) );
+    TEST_CHECK( (cache.GetEntry(&g_SourceTexture, overlay_b.CropRect).Converter.ConvertCount == 1) && (overlay_b.TextureSetCount == 1) );
+
+    //Touching edges don't overlap
+    cache.BeginFrame(OUtoSBSRect(100, 0, 200, 100));
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    cache.EndFrame();
+
+    TEST_CHECK( (overlay_a.TextureSetCount == 2) && (overlay_b.TextureSetCount == 1) );
+}
+
+static void TestEntryIDChange()
+{
+    TestConverterCache cache;
+    TestOverlay overlay;
+    overlay.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 100);
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+    const uint64_t entry_id = overlay.ConverterEntryID;
+
+    //Changing the crop to one another overlay already converted this frame still sets the texture, as the entry ID differs
+    TestOverlay overlay_other;
+    overlay_other.CropRect = OUtoSBSRect::FromCrop(0, 0, 50, 50);
+
+    cache.BeginFrame(OUtoSBSRect());
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_other);
+    overlay.CropRect = overlay_other.CropRect;
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+
+    TEST_CHECK( (overlay.ConverterEntryID != entry_id) && (overlay.ConverterEntryID == overlay_other.ConverterEntryID) );
+    TEST_CHECK(overlay.TextureSetCount == 2);
+    TEST_CHECK(cache.GetEntry(&g_SourceTexture, overlay.CropRect).Converter.ConvertCount == 1);
+
+    //Nothing changed, nothing set
+    cache.BeginFrame(OUtoSBSRect());
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+    TEST_CHECK(overlay.TextureSetCount == 2);
+
+    //Overlay losing its entry ID (e.g. texture source changed) gets the texture set again without converting
+    overlay.ConverterEntryID = 0;
+    cache.BeginFrame(OUtoSBSRect());
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+    TEST_CHECK( (overlay.TextureSetCount == 3) && (overlay.ConverterEntryID == overlay_other.ConverterEntryID) );
+}
+
+static void TestEviction()
+{
+    TestConverterCache cache;
+    TestOverlay overlay_a, overlay_b;
+    overlay_a.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 100);
+    overlay_b.CropRect = OUtoSBSRect::FromCrop(0, 100, 100, 100);
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    cache.EndFrame();
+    TEST_CHECK(cache.GetEntryCount() == 2);
+
+    //Entries not requested during a frame are dropped
+    cache.BeginFrame(OUtoSBSRect());
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    cache.EndFrame();
+    TEST_CHECK(cache.GetEntryCount() == 1);
+
+    //Coming back creates a new entry with a new ID, which is converted and set again
+    const uint64_t entry_id_b = overlay_b.ConverterEntryID;
+    cache.BeginFrame(OUtoSBSRect());
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_b);
+    cache.EndFrame();
+
+    TEST_CHECK( (cache.GetEntryCount() == 2) && (overlay_b.ConverterEntryID != entry_id_b) );
+    TEST_CHECK( (overlay_a.TextureSetCount == 1) && (overlay_b.TextureSetCount == 2) );
+
+    cache.BeginFrame();
+    cache.EndFrame();
+    TEST_CHECK(cache.GetEntryCount() == 0);
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay_a);
+    cache.Clear();
+    TEST_CHECK(cache.GetEntryCount() == 0);
+}
+
+//A crop that can never be converted is attempted every frame, but only reported once
+static void TestConversionFailure()
+{
+    TestConverterCache cache;
+    TestOverlay overlay;
+    overlay.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 1);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        cache.BeginFrame();
+        ConvertForOverlay(cache, &g_SourceTexture, overlay);
+        cache.EndFrame();
+    }
+
+    TEST_CHECK(overlay.FailureReportCount == 1);
+    TEST_CHECK( (overlay.TextureSetCount == 0) && (overlay.ConverterEntryID == 0) );
+    TEST_CHECK(cache.GetEntry(&g_SourceTexture, overlay.CropRect).Converter.ConvertCount == 10);
+
+    //A new entry for the same crop reports again
+    cache.BeginFrame();
+    cache.EndFrame();
+
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+    TEST_CHECK(overlay.FailureReportCount == 2);
+
+    //Valid crop works as usual
+    overlay.CropRect = OUtoSBSRect::FromCrop(0, 0, 100, 2);
+    cache.BeginFrame();
+    ConvertForOverlay(cache, &g_SourceTexture, overlay);
+    cache.EndFrame();
+    TEST_CHECK( (overlay.FailureReportCount == 2) && (overlay.TextureSetCount == 1) );
+}
+
+int main()
+{
+    TEST_RUN(TestSharedCrop);
+    TEST_RUN(TestDirtyRect);
+    TEST_RUN(TestEntryIDChange);
+    TEST_RUN(TestEviction);
+    TEST_RUN(TestConversionFailure);
+
+    return TestResult();
+}
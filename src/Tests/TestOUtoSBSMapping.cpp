@@ -0,0 +1,197 @@
+#include "TestCommon.h"
+
+#include "OUtoSBSMapping.h"
+
+#include <vector>
+
+//Property tests of OUtoSBSMapDirtyRect() against a CPU reference of the full OU->SBS conversion
+//Textures are plain pixel buffers with one value per pixel
+
+struct TestTexture
+{
+    int Width  = 0;
+    int Height = 0;
+    std::vector<uint32_t> Pixels;
+
+    TestTexture(int width, int height) : Width(width), Height(height), Pixels((size_t)width * height, 0) {}
+
+    uint32_t& At(int x, int y) { return Pixels[(size_t)y * Width + x]; }
+};
+
+struct TestCrop
+{
+    int X, Y, Width, Height;
+};
+
+//Reference: Every SBS pixel defined on its own. Left half is the crop's top half, right half the bottom one. Pixels outside the source stay untouched
+static void ReferenceConvert(TestTexture& source, const TestCrop& crop, TestTexture& sbs)
+{
+    const int sbs_height = crop.Height / 2;
+
+    for (int y = 0; y < sbs_height; ++y)
+    {
+        for (int x = 0; x < crop.Width * 2; ++x)
+        {
+            const int source_x = crop.X + (x % crop.Width);
+            const int source_y = crop.Y + y + ((x >= crop.Width) ? sbs_height : 0);
+
+            if ( (source_x >= 0) && (source_x < source.Width) && (source_y >= 0) && (source_y < source.Height) )
+            {
+                sbs.At(x, y) = source.At(source_x, source_y);
+            }
+        }
+    }
+}
+
+//Copies the mapped regions like OUtoSBSConverter does with CopySubresourceRegion(). Returns false if a copy goes out of bounds
+static bool ApplyRegions(TestTexture& source, const TestCrop& crop, const OUtoSBSRect& dirty_rect, TestTexture& sbs, int* copied_pixels_out = nullptr)
+{
+    OUtoSBSCopyRegion regions[2];
+    const int region_count = OUtoSBSMapDirtyRect(crop.X, crop.Y, crop.Width, crop.Height, source.Width, source.Height, dirty_rect, regions);
+    int copied_pixels = 0;
+
+    for (int i = 0; i < region_count; ++i)
+    {
+        const OUtoSBSRect& src = regions[i].Source;
+        const OUtoSBSRect dest = regions[i].GetDestRect();
+
+        if ( (src.IsEmpty()) || (src.Left < 0) || (src.Top < 0) || (src.Right > source.Width) || (src.Bottom > source.Height) )
+            return false;
+
+        if ( (dest.Left < 0) || (dest.Top < 0) || (dest.Right > sbs.Width) || (dest.Bottom > sbs.Height) )
+            return false;
+
+        for (int y = src.Top; y < src.Bottom; ++y)
+        {
+            for (int x = src.Left; x < src.Right; ++x)
+            {
+                sbs.At(regions[i].DestX + (x - src.Left), regions[i].DestY + (y - src.Top)) = source.At(x, y);
+                copied_pixels++;
+            }
+        }
+    }
+
+    if (copied_pixels_out != nullptr)
+        *copied_pixels_out = copied_pixels;
+
+    return true;
+}
+
+static TestCrop RandomCrop(TestRandom& rng, int width, int height)
+{
+    //Crops may reach past the texture, e.g. after a resolution change
+    TestCrop crop;
+    crop.Width  = rng.Range(1, width + 4);
+    crop.Height = rng.Range(2, height + 4);
+    crop.X      = rng.Range(0, width  - 1);
+    crop.Y      = rng.Range(0, height - 1);
+
+    return crop;
+}
+
+static OUtoSBSRect RandomRect(TestRandom& rng, int width, int height)
+{
+    const int left = rng.Range(-2, width);
+    const int top  = rng.Range(-2, height);
+
+    return OUtoSBSRect(left, top, rng.Range(left, width + 2), rng.Range(top, height + 2));
+}
+
+static void TestFullConversionMatchesReference()
+{
+    TestRandom rng(1);
+
+    for (int iteration = 0; iteration < 3000; ++iteration)
+    {
+        TestTexture source(rng.Range(1, 48), rng.Range(2, 48));
+        for (uint32_t& pixel : source.Pixels)
+            pixel = rng.Next();
+
+        const TestCrop crop = RandomCrop(rng, source.Width, source.Height);
+        TestTexture sbs_reference(crop.Width * 2, crop.Height / 2);
+        TestTexture sbs(crop.Width * 2, crop.Height / 2);
+
+        ReferenceConvert(source, crop, sbs_reference);
+        TEST_CHECK(ApplyRegions(source, crop, OUtoSBSRect::Everything(), sbs));
+        TEST_CHECK(sbs.Pixels == sbs_reference.Pixels);
+    }
+}
+
+static void TestDirtyUpdatesMatchReference()
+{
+    TestRandom rng(2);
+
+    for (int iteration = 0; iteration < 3000; ++iteration)
+    {
+        TestTexture source(rng.Range(1, 48), rng.Range(2, 48));
+        for (uint32_t& pixel : source.Pixels)
+            pixel = rng.Next();
+
+        const TestCrop crop = RandomCrop(rng, source.Width, source.Height);
+        TestTexture sbs(crop.Width * 2, crop.Height / 2);
+        TEST_CHECK(ApplyRegions(source, crop, OUtoSBSRect::Everything(), sbs));
+
+        //Several frames with random changes, each only converting its dirty rect
+        for (int frame = 0; frame < 4; ++frame)
+        {
+            const OUtoSBSRect dirty_rect = RandomRect(rng, source.Width, source.Height);
+
+            for (int y = std::max(dirty_rect.Top, 0); y < std::min(dirty_rect.Bottom, source.Height); ++y)
+            {
+                for (int x = std::max(dirty_rect.Left, 0); x < std::min(dirty_rect.Right, source.Width); ++x)
+                {
+                    source.At(x, y) = rng.Next();
+                }
+            }
+
+            int copied_pixels = 0;
+            TEST_CHECK(ApplyRegions(source, crop, dirty_rect, sbs, &copied_pixels));
+
+            //Never copies more than the dirty part of the crop
+            const OUtoSBSRect crop_rect(std::max(crop.X, 0), std::max(crop.Y, 0), std::min(crop.X + crop.Width, source.Width), std::min(crop.Y + (crop.Height / 2) * 2, source.Height));
+            const OUtoSBSRect dirty_crop(std::max(crop_rect.Left, dirty_rect.Left), std::max(crop_rect.Top, dirty_rect.Top), 
+                                         std::min(crop_rect.Right, dirty_rect.Right), std::min(crop_rect.Bottom, dirty_rect.Bottom));
+            const int dirty_crop_pixels = (dirty_crop.IsEmpty()) ? 0 : dirty_crop.GetWidth() * dirty_crop.GetHeight();
+            TEST_CHECK(copied_pixels == dirty_crop_pixels);
+        }
+
+        TestTexture sbs_reference(crop.Width * 2, crop.Height / 2);
+        ReferenceConvert(source, crop, sbs_reference);
+        TEST_CHECK(sbs.Pixels == sbs_reference.Pixels);
+    }
+}
+
+static void TestRegionCases()
+{
+    OUtoSBSCopyRegion regions[2];
+
+    //Dirty rect outside of the crop needs no copies
+    TEST_CHECK(OUtoSBSMapDirtyRect(100, 100, 200, 200, 1920, 1080, OUtoSBSRect(0, 0, 50, 50), regions) == 0);
+    TEST_CHECK(OUtoSBSMapDirtyRect(100, 100, 200, 200, 1920, 1080, OUtoSBSRect(), regions) == 0);
+
+    //Only touching the top half only copies to the left
+    TEST_CHECK(OUtoSBSMapDirtyRect(100, 100, 200, 200, 1920, 1080, OUtoSBSRect(150, 110, 160, 120), regions) == 1);
+    TEST_CHECK(regions[0].Source == OUtoSBSRect(150, 110, 160, 120));
+    TEST_CHECK( (regions[0].DestX == 50) && (regions[0].DestY == 10) );
+
+    //Only touching the bottom half only copies to the right
+    TEST_CHECK(OUtoSBSMapDirtyRect(100, 100, 200, 200, 1920, 1080, OUtoSBSRect(150, 210, 160, 220), regions) == 1);
+    TEST_CHECK( (regions[0].DestX == 250) && (regions[0].DestY == 10) );
+
+    //Crossing the middle splits into both halves
+    TEST_CHECK(OUtoSBSMapDirtyRect(100, 100, 200, 200, 1920, 1080, OUtoSBSRect(100, 190, 300, 210), regions) == 2);
+    TEST_CHECK(regions[0].GetDestRect() == OUtoSBSRect(0,   90, 200, 100));
+    TEST_CHECK(regions[1].GetDestRect() == OUtoSBSRect(200, 0,  400, 10));
+
+    //Odd crop height drops the last row, same as the full conversion
+    TEST_CHECK(OUtoSBSMapDirtyRect(0, 0, 10, 11, 10, 11, OUtoSBSRect(0, 10, 10, 11), regions) == 0);
+}
+
+int main()
+{
+    TEST_RUN(TestFullConversionMatchesReference);
+    TEST_RUN(TestDirtyUpdatesMatchReference);
+    TEST_RUN(TestRegionCases);
+
+    return TestResult();
+}
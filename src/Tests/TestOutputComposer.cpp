@@ -0,0 +1,318 @@
+#include "TestCommon.h"
+
+#include "OutputComposer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//CPU stand-in for the duplication setup: each output has a pixel buffer and keyed mutex instead of a shared texture, the compose texture is another pixel buffer
+
+//Stand-in for IDXGIKeyedMutex. Acquire(key) only succeeds once the mutex was released with that key
+class TestKeyedMutex
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_IsOwned = false;
+        uint64_t m_Key = 0;
+
+    public:
+        bool Acquire(uint64_t key, int timeout_ms)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            if (!m_Condition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&](){ return ( (!m_IsOwned) && (m_Key == key) ); }))
+                return false;
+
+            m_IsOwned = true;
+            return true;
+        }
+
+        void Release(uint64_t key)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_IsOwned = false;
+                m_Key = key;
+            }
+
+            m_Condition.notify_all();
+        }
+};
+
+struct TestOutputSurface
+{
+    std::vector<uint32_t> Pixels;
+    TestKeyedMutex KeyedMutex;
+};
+
+static const int g_OutputWidth  = 64;
+static const int g_OutputHeight = 48;
+
+class TestComposeSetup
+{
+    public:
+        OutputComposer Composer;
+        std::vector<std::unique_ptr<TestOutputSurface>> Surfaces;
+        std::vector<ComposeRect> Rects;
+        std::vector<uint32_t> ComposePixels;
+        std::vector<uint64_t> ComposedCount;
+        int ComposeWidth;
+        int ComposeHeight;
+
+        //Outputs side by side, every other one offset downwards
+        TestComposeSetup(int output_count) : ComposeWidth(output_count * g_OutputWidth), ComposeHeight(g_OutputHeight + 10)
+        {
+            for (int i = 0; i < output_count; ++i)
+            {
+                const int top = (i % 2 == 1) ? 10 : 0;
+                Rects.push_back({i * g_OutputWidth, top, (i + 1) * g_OutputWidth, top + g_OutputHeight});
+
+                Surfaces.emplace_back(new TestOutputSurface());
+                Surfaces.back()->Pixels.assign(g_OutputWidth * g_OutputHeight, 0);
+            }
+
+            Composer.SetOutputs(Rects);
+            ComposePixels.assign(ComposeWidth * ComposeHeight, 0);
+            ComposedCount.assign(output_count, 0);
+        }
+
+        //What OutputManager::ComposeOutputs() does with the textures
+        bool Compose(size_t output_id, const ComposeRect& dirty_rect, int dest_x, int dest_y)
+        {
+            TestOutputSurface& surface = *Surfaces[output_id];
+
+            if (!surface.KeyedMutex.Acquire(1, 0))
+                return false;
+
+            for (int y = dirty_rect.Top; y < dirty_rect.Bottom; ++y)
+            {
+                std::memcpy(&ComposePixels[(y + dest_y) * ComposeWidth + dirty_rect.Left + dest_x], &surface.Pixels[y * g_OutputWidth + dirty_rect.Left],
+                            (dirty_rect.Right - dirty_rect.Left) * sizeof(uint32_t));
+            }
+
+            ComposedCount[output_id]++;
+            surface.KeyedMutex.Release(0);
+
+            return true;
+        }
+
+        ComposeRect ComposeReadyOutputs()
+        {
+            return Composer.ComposeReadyOutputs([&](size_t output_id, const ComposeRect& dirty_rect, int dest_x, int dest_y)
+                                                { return Compose(output_id, dirty_rect, dest_x, dest_y); });
+        }
+
+        //What a duplication thread does for one frame
+        void WriteFrame(size_t output_id, const ComposeRect& rect, uint32_t value)
+        {
+            TestOutputSurface& surface = *Surfaces[output_id];
+
+            for (int y = rect.Top; y < rect.Bottom; ++y)
+            {
+                for (int x = rect.Left; x < rect.Right; ++x)
+                {
+                    surface.Pixels[y * g_OutputWidth + x] = value;
+                }
+            }
+
+            Composer.GetOutput(output_id).AddDirtyRect(rect);
+        }
+
+        bool IsComposeMatching() const
+        {
+            for (size_t i = 0; i < Surfaces.size(); ++i)
+            {
+                for (int y = 0; y < g_OutputHeight; ++y)
+                {
+                    if (std::memcmp(&ComposePixels[(y + Rects[i].Top) * ComposeWidth + Rects[i].Left], &Surfaces[i]->Pixels[y * g_OutputWidth], g_OutputWidth * sizeof(uint32_t)) != 0)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+};
+
+static void TestComposeRect()
+{
+    ComposeRect rect = {0, 0, 0, 0};
+    TEST_CHECK(rect.IsEmpty());
+
+    rect.Add({10, 10, 20, 20});
+    TEST_CHECK( (rect.Left == 10) && (rect.Top == 10) && (rect.Right == 20) && (rect.Bottom == 20) );
+
+    //Empty rects don't extend it
+    rect.Add({0, 0, 0, 5});
+    rect.Add({5, 30, 15, 40});
+    TEST_CHECK( (rect.Left == 5) && (rect.Top == 10) && (rect.Right == 20) && (rect.Bottom == 40) );
+
+    rect.ClipWith({0, 0, 16, 16});
+    TEST_CHECK( (rect.Left == 5) && (rect.Top == 10) && (rect.Right == 16) && (rect.Bottom == 16) );
+
+    //Outside ends up empty
+    rect.ClipWith({50, 50, 60, 60});
+    TEST_CHECK(rect.IsEmpty());
+}
+
+static void TestComposeReady()
+{
+    TestComposeSetup setup(3);
+
+    //Nothing ready, no surfaces touched
+    TEST_CHECK(!setup.Composer.HasReadyFrames());
+    TEST_CHECK(setup.ComposeReadyOutputs().IsEmpty());
+
+    //Output 1 writes a frame, the dirty rect is moved to its place in the compose texture
+    TEST_CHECK(setup.Surfaces[1]->KeyedMutex.Acquire(0, 0));
+    setup.WriteFrame(1, {4, 4, 8, 6}, 0x11);
+    setup.Surfaces[1]->KeyedMutex.Release(1);
+    setup.Composer.GetOutput(1).SetFrameReady();
+
+    TEST_CHECK(setup.Composer.HasReadyFrames());
+    ComposeRect dirty = setup.ComposeReadyOutputs();
+    TEST_CHECK( (dirty.Left == g_OutputWidth + 4) && (dirty.Top == 10 + 4) && (dirty.Right == g_OutputWidth + 8) && (dirty.Bottom == 10 + 6) );
+    TEST_CHECK( (setup.ComposedCount[0] == 0) && (setup.ComposedCount[1] == 1) && (setup.ComposedCount[2] == 0) );
+    TEST_CHECK(!setup.Composer.HasReadyFrames());
+    TEST_CHECK(setup.IsComposeMatching());
+
+    //Dirty rects past the output are clipped
+    TEST_CHECK(setup.Surfaces[2]->KeyedMutex.Acquire(0, 0));
+    setup.WriteFrame(2, {60, 40, 64, 48}, 0x22);
+    setup.Composer.GetOutput(2).AddDirtyRect({60, 40, 100, 100});
+    setup.Surfaces[2]->KeyedMutex.Release(1);
+    setup.Composer.GetOutput(2).SetFrameReady();
+
+    dirty = setup.ComposeReadyOutputs();
+    TEST_CHECK( (dirty.Right == 3 * g_OutputWidth) && (dirty.Bottom == g_OutputHeight) );
+    TEST_CHECK(setup.IsComposeMatching());
+
+    //Surface still held elsewhere: compose fails, frame and dirty rect are kept for the next call
+    TEST_CHECK(setup.Surfaces[0]->KeyedMutex.Acquire(0, 0));
+    setup.WriteFrame(0, {0, 0, 2, 2}, 0x33);
+    setup.Composer.GetOutput(0).SetFrameReady();
+
+    TEST_CHECK(setup.ComposeReadyOutputs().IsEmpty());
+    TEST_CHECK( (setup.ComposedCount[0] == 0) && (setup.Composer.HasReadyFrames()) );
+
+    setup.Surfaces[0]->KeyedMutex.Release(1);
+    dirty = setup.ComposeReadyOutputs();
+    TEST_CHECK( (dirty.Left == 0) && (dirty.Top == 0) && (dirty.Right == 2) && (dirty.Bottom == 2) );
+    TEST_CHECK(setup.IsComposeMatching());
+}
+
+//Duplication threads writing random frames while the main thread composes. Output 0 stalls while holding its surface every now and then,
+//during which the others have to keep getting composed. The compose texture has to match all surfaces at the end
+static void TestConcurrent()
+{
+    const int output_count = 3;
+    const uint32_t frame_count = 3000;
+    const uint32_t stall_interval = 500;
+
+    TestComposeSetup setup(output_count);
+    std::vector<uint32_t> frames_written(output_count, 0);
+    std::atomic<int> writers_done{0};
+    std::atomic<bool> is_stalled_output_done{false};
+    std::atomic<bool> is_stalling{false};
+    std::atomic<uint64_t> composed_during_stall{0};
+    std::atomic<int> stall_ok_count{0};
+    std::vector<std::thread> threads;
+
+    for (int output_id = 0; output_id < output_count; ++output_id)
+    {
+        threads.emplace_back([&, output_id]()
+        {
+            TestRandom rng(48 + output_id);
+            TestOutputSurface& surface = *setup.Surfaces[output_id];
+            uint32_t frame = 1;
+
+            //The other outputs keep going until output 0 is done so there's always something to compose during its stalls
+            while ( (frame <= frame_count) || ( (output_id != 0) && (!is_stalled_output_done.load()) ) )
+            {
+                if (!surface.KeyedMutex.Acquire(0, 1000))
+                    continue;
+
+                const int left = rng.Range(0, g_OutputWidth - 1);
+                const int top  = rng.Range(0, g_OutputHeight - 1);
+                const ComposeRect rect = {left, top, rng.Range(left + 1, g_OutputWidth), rng.Range(top + 1, g_OutputHeight)};
+
+                setup.WriteFrame(output_id, rect, ((uint32_t)output_id << 24) | frame);
+
+                //Hold the surface until the other outputs got composed a few times
+                if ( (output_id == 0) && (frame % stall_interval == 0) )
+                {
+                    composed_during_stall = 0;
+                    is_stalling = true;
+
+                    const auto start = std::chrono::steady_clock::now();
+                    while ( (composed_during_stall.load() < 3) && (std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) )
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    stall_ok_count += (composed_during_stall.load() >= 3);
+                    is_stalling = false;
+                }
+
+                surface.KeyedMutex.Release(1);
+                setup.Composer.GetOutput(output_id).SetFrameReady();
+                frames_written[output_id] = frame++;
+            }
+
+            if (output_id == 0)
+            {
+                is_stalled_output_done = true;
+            }
+
+            writers_done++;
+        });
+    }
+
+    while (writers_done.load() != output_count)
+    {
+        const bool was_stalling = is_stalling.load();
+        const uint64_t composed_other_prev = setup.ComposedCount[1] + setup.ComposedCount[2];
+
+        setup.ComposeReadyOutputs();
+
+        if ( (was_stalling) && (setup.ComposedCount[1] + setup.ComposedCount[2] != composed_other_prev) )
+        {
+            composed_during_stall++;
+        }
+
+        std::this_thread::yield();
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    //Drain what was written after the last call
+    setup.ComposeReadyOutputs();
+
+    TEST_CHECK(!setup.Composer.HasReadyFrames());
+    TEST_CHECK(setup.IsComposeMatching());
+    TEST_CHECK(stall_ok_count.load() == (int)(frame_count / stall_interval));
+
+    //Frames may be combined into one compose, but never composed more often than written
+    for (int output_id = 0; output_id < output_count; ++output_id)
+    {
+        TEST_CHECK( (setup.ComposedCount[output_id] > 0) && (setup.ComposedCount[output_id] <= frames_written[output_id]) );
+    }
+}
+
+int main()
+{
+    TEST_RUN(TestComposeRect);
+    TEST_RUN(TestComposeReady);
+    TEST_RUN(TestConcurrent);
+
+    return TestResult();
+}
@@ -0,0 +1,244 @@
+#include "TestCommon.h"
+
+#include "OverlayConfigBatch.h"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+//Stand-in for the overlay config data, ConfigKey is used as index. Keys past the size don't exist like non-overlay config IDs
+struct TestOverlayConfig
+{
+    std::vector<std::vector<int32_t>> Values;
+
+    TestOverlayConfig(size_t overlay_count, size_t key_count) : Values(overlay_count, std::vector<int32_t>(key_count, 0)) {}
+
+    bool GetValue(uint32_t overlay_id, uint32_t config_key, int32_t& value_out) const
+    {
+        if ( (overlay_id >= Values.size()) || (config_key >= Values[overlay_id].size()) )
+            return false;
+
+        value_out = Values[overlay_id][config_key];
+        return true;
+    }
+};
+
+static bool IsChangeEqual(const OverlayConfigChange& change, uint32_t overlay_id, uint32_t config_key, int32_t value)
+{
+    return ( (change.OverlayID == overlay_id) && (change.ConfigKey == config_key) && (change.Value == value) );
+}
+
+static void TestDiff()
+{
+    TestOverlayConfig config(3, 4);
+    config.Values[1][2] = 1;
+
+    OverlayConfigBatch batch;
+    TEST_CHECK(batch.IsEmpty());
+
+    batch.Set(2, 2, 1);
+    batch.Set(0, 2, 1);         //Overridden back to the current value
+    batch.Set(0, 2, 0);
+    batch.Set(1, 2, 1);         //Unchanged
+    batch.Set(1, 0, 5);
+    batch.Set(1, 3, 7);         //Overridden by a different value
+    batch.Set(1, 3, 8);
+    batch.Set(9, 2, 1);         //Overlay doesn't exist
+    batch.Set(0, 9, 1);         //Config key doesn't exist
+
+    const size_t count = batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out) { return config.GetValue(overlay_id, config_key, value_out); });
+    const std::vector<OverlayConfigChange>& changes = batch.GetChanges();
+
+    //Sorted by overlay, then config key
+    TEST_CHECK( (count == 3) && (changes.size() == 3) );
+    TEST_CHECK(IsChangeEqual(changes[0], 1, 0, 5));
+    TEST_CHECK(IsChangeEqual(changes[1], 1, 3, 8));
+    TEST_CHECK(IsChangeEqual(changes[2], 2, 2, 1));
+
+    //Diffing again with nothing applied changes nothing
+    TEST_CHECK(batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out) { return config.GetValue(overlay_id, config_key, value_out); }) == 3);
+
+    //Once applied, everything's dropped
+    for (const OverlayConfigChange& change : changes)
+    {
+        config.Values[change.OverlayID][change.ConfigKey] = change.Value;
+    }
+
+    TEST_CHECK(batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out) { return config.GetValue(overlay_id, config_key, value_out); }) == 0);
+    TEST_CHECK(batch.IsEmpty());
+
+    batch.Set(0, 0, 1);
+    batch.Clear();
+    TEST_CHECK(batch.IsEmpty());
+}
+
+//Random changes compared with keeping the last value set per overlay and config key
+static void TestDiffRandom()
+{
+    TestRandom rng(50);
+    bool is_matching = true;
+
+    for (int iteration = 0; iteration < 2000; ++iteration)
+    {
+        TestOverlayConfig config(rng.Range(1, 64), 4);
+        for (auto& values : config.Values)
+        {
+            for (int32_t& value : values)
+            {
+                value = rng.Range(0, 2);
+            }
+        }
+
+        OverlayConfigBatch batch;
+        std::map<std::pair<uint32_t, uint32_t>, int32_t> values_final;
+        const int change_count = rng.Range(0, 200);
+
+        for (int i = 0; i < change_count; ++i)
+        {
+            const uint32_t overlay_id = rng.Range(0, (int)config.Values.size());        //Includes one past the last overlay
+            const uint32_t config_key = rng.Range(0, 4);
+            const int32_t value = rng.Range(0, 2);
+
+            batch.Set(overlay_id, config_key, value);
+            values_final[{overlay_id, config_key}] = value;
+        }
+
+        batch.Diff([&](uint32_t overlay_id, uint32_t config_key, int32_t& value_out) { return config.GetValue(overlay_id, config_key, value_out); });
+
+        //std::map is ordered the same way as the changes after Diff()
+        std::vector<OverlayConfigChange> changes_expected;
+        for (const auto& value_final : values_final)
+        {
+            int32_t value_current = 0;
+            if ( (config.GetValue(value_final.first.first, value_final.first.second, value_current)) && (value_current != value_final.second) )
+            {
+                changes_expected.push_back({value_final.first.first, value_final.first.second, value_final.second});
+            }
+        }
+
+        const std::vector<OverlayConfigChange>& changes = batch.GetChanges();
+        is_matching &= (changes.size() == changes_expected.size());
+
+        for (size_t i = 0; (is_matching) && (i < changes.size()); ++i)
+        {
+            is_matching &= IsChangeEqual(changes[i], changes_expected[i].OverlayID, changes_expected[i].ConfigKey, changes_expected[i].Value);
+        }
+    }
+
+    TEST_CHECK(is_matching);
+}
+
+static void TestSerialization()
+{
+    OverlayConfigBatch batch;
+    batch.Set(1, 2, 3);
+    batch.Set(4, 5, -6);
+    batch.Set(0xFFFFFFFF, 0, 0x7FFFFFFF);
+
+    BinaryWriter writer;
+    batch.Serialize(writer);
+    const std::string& data = writer.GetBuffer();
+    TEST_CHECK(data.size() == 6 + 3 * 12);
+
+    OverlayConfigBatch batch_read;
+    TEST_CHECK(batch_read.Deserialize(data.data(), data.size()));
+    TEST_CHECK(batch_read.GetChanges().size() == 3);
+    TEST_CHECK(IsChangeEqual(batch_read.GetChanges()[0], 1, 2, 3));
+    TEST_CHECK(IsChangeEqual(batch_read.GetChanges()[1], 4, 5, -6));
+    TEST_CHECK(IsChangeEqual(batch_read.GetChanges()[2], 0xFFFFFFFF, 0, 0x7FFFFFFF));
+
+    //Empty batches are valid
+    BinaryWriter writer_empty;
+    OverlayConfigBatch().Serialize(writer_empty);
+    TEST_CHECK(batch_read.Deserialize(writer_empty.GetBuffer().data(), writer_empty.GetBuffer().size()));
+    TEST_CHECK(batch_read.IsEmpty());
+}
+
+//Any invalid data has to be rejected, leaving the batch empty
+static void TestDeserializeInvalid()
+{
+    OverlayConfigBatch batch;
+    batch.Set(1, 2, 3);
+    batch.Set(4, 5, 6);
+
+    BinaryWriter writer;
+    batch.Serialize(writer);
+    const std::string data = writer.GetBuffer();
+
+    OverlayConfigBatch batch_read;
+
+    //Every truncation
+    bool is_rejected = true;
+    for (size_t size = 0; size < data.size(); ++size)
+    {
+        batch_read.Set(0, 0, 0);
+        is_rejected &= ( (!batch_read.Deserialize(data.data(), size)) && (batch_read.IsEmpty()) );
+    }
+
+    TEST_CHECK(is_rejected);
+
+    //Trailing data
+    const std::string data_long = data + '\0';
+    TEST_CHECK(!batch_read.Deserialize(data_long.data(), data_long.size()));
+
+    //Different version
+    std::string data_version = data;
+    data_version[0] = (char)(OverlayConfigBatch::SerializationVersion + 1);
+    TEST_CHECK(!batch_read.Deserialize(data_version.data(), data_version.size()));
+
+    //Count not matching the data or above the maximum
+    for (uint32_t count : {1u, 3u, OverlayConfigBatch::SerializationMaxCount + 1, 0xFFFFFFFFu})
+    {
+        std::string data_count = data;
+        std::memcpy(&data_count[2], &count, sizeof(count));
+        TEST_CHECK(!batch_read.Deserialize(data_count.data(), data_count.size()));
+    }
+
+    TEST_CHECK(!batch_read.Deserialize(nullptr, 42));
+
+    //Random data never crashes or reads out of bounds and only passes when it has the exact size for its count
+    TestRandom rng(5050);
+    bool is_consistent = true;
+    int accepted_count = 0;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string data_random(rng.Range(0, 64), '\0');
+        for (char& c : data_random)
+        {
+            c = (char)rng.Range(0, 255);
+        }
+
+        //Mostly valid headers with small counts so the size check actually comes into play
+        if ( (data_random.size() >= 6) && (rng.Range(0, 3) != 0) )
+        {
+            const uint16_t version = OverlayConfigBatch::SerializationVersion;
+            const uint32_t count   = rng.Range(0, 5);
+            std::memcpy(&data_random[0], &version, sizeof(version));
+            std::memcpy(&data_random[2], &count,   sizeof(count));
+        }
+
+        if (batch_read.Deserialize(data_random.data(), data_random.size()))
+        {
+            is_consistent &= (data_random.size() == 6 + batch_read.GetChanges().size() * 12);
+            accepted_count++;
+        }
+        else
+        {
+            is_consistent &= batch_read.IsEmpty();
+        }
+    }
+
+    TEST_CHECK(is_consistent);
+    TEST_CHECK(accepted_count > 0);
+}
+
+int main()
+{
+    TEST_RUN(TestDiff);
+    TEST_RUN(TestDiffRandom);
+    TEST_RUN(TestSerialization);
+    TEST_RUN(TestDeserializeInvalid);
+
+    return TestResult();
+}
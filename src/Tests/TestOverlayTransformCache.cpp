@@ -0,0 +1,144 @@
+#include "TestCommon.h"
+
+#include "OverlayTransformCache.h"
+#include "HeadlessVR.h"
+
+#include <cmath>
+
+static const vr::HmdMatrix34_t g_Transform = {{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, -2.0f}}};
+
+static uint64_t GetAbsoluteCallCount()
+{
+    return HeadlessVR::GetCallCount("IVROverlay::SetOverlayTransformAbsolute");
+}
+
+static uint64_t GetDeviceRelativeCallCount()
+{
+    return HeadlessVR::GetCallCount("IVROverlay::SetOverlayTransformTrackedDeviceRelative");
+}
+
+static void InitRuntime(vr::VROverlayHandle_t& handle_a, vr::VROverlayHandle_t& handle_b)
+{
+    HeadlessVR::Reset();
+
+    vr::EVRInitError init_error;
+    vr::VR_Init(&init_error, vr::VRApplication_Overlay);
+
+    vr::VROverlay()->CreateOverlay("dplus.a", "A", &handle_a);
+    vr::VROverlay()->CreateOverlay("dplus.b", "B", &handle_b);
+
+    OverlayTransformCache::Get().InvalidateAll();
+    OverlayTransformCache::Get().ResetCounters();
+    OverlayTransformCache::Get().SetEpsilon(OverlayTransformCache::DefaultEpsilon);
+    HeadlessVR::ResetCallCounts();
+}
+
+//Repeated transforms only make it to the runtime once, which is what the Performance Monitor shows as submitted and skipped
+static void TestSkipRepeated()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+    OverlayTransformCache& cache = OverlayTransformCache::Get();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        TEST_CHECK(cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &g_Transform) == vr::VROverlayError_None);
+    }
+
+    TEST_CHECK(GetAbsoluteCallCount() == 1);
+    TEST_CHECK( (cache.GetSubmittedCount() == 1) && (cache.GetSkippedCount() == 99) );
+
+    //Different origin, transform type or device are all new transforms
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseSeated, &g_Transform);
+    cache.SetOverlayTransformTrackedDeviceRelative(handle_a, vr::k_unTrackedDeviceIndex_Hmd, &g_Transform);
+    cache.SetOverlayTransformTrackedDeviceRelative(handle_a, vr::k_unTrackedDeviceIndex_Hmd, &g_Transform);
+    cache.SetOverlayTransformTrackedDeviceRelative(handle_a, 1, &g_Transform);
+
+    TEST_CHECK( (GetAbsoluteCallCount() == 2) && (GetDeviceRelativeCallCount() == 2) );
+    TEST_CHECK( (cache.GetSubmittedCount() == 4) && (cache.GetSkippedCount() == 100) );
+
+    //Overlays are tracked separately
+    cache.SetOverlayTransformTrackedDeviceRelative(handle_b, 1, &g_Transform);
+    TEST_CHECK(GetDeviceRelativeCallCount() == 3);
+
+    cache.ResetCounters();
+    TEST_CHECK( (cache.GetSubmittedCount() == 0) && (cache.GetSkippedCount() == 0) );
+}
+
+//Slow movement still goes through once it adds up past the epsilon, leaving the runtime no further off than that
+static void TestEpsilon()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+    OverlayTransformCache& cache = OverlayTransformCache::Get();
+
+    vr::HmdMatrix34_t transform = g_Transform;
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        transform.m[0][3] += 0.000004f;
+        cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform);
+    }
+
+    const uint64_t submit_count = GetAbsoluteCallCount();
+    TEST_CHECK( (submit_count >= 30) && (submit_count <= 40) );
+
+    HeadlessVR::OverlayState overlay_state;
+    TEST_CHECK(HeadlessVR::GetOverlayState(handle_a, overlay_state));
+    TEST_CHECK(std::fabs(overlay_state.Transform.m[0][3] - transform.m[0][3]) <= cache.GetEpsilon());
+
+    //Only exact matches skipped at 0, negative values are treated as such
+    cache.SetEpsilon(-1.0f);
+    TEST_CHECK(cache.GetEpsilon() == 0.0f);
+
+    transform.m[0][3] += 0.0000001f;
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform);
+    TEST_CHECK(GetAbsoluteCallCount() == submit_count + 1);
+
+    //Large epsilon as could be set in the config
+    cache.SetEpsilon(0.01f);
+    transform.m[1][3] += 0.005f;
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform);
+    TEST_CHECK(GetAbsoluteCallCount() == submit_count + 1);
+}
+
+static void TestInvalidation()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+    OverlayTransformCache& cache = OverlayTransformCache::Get();
+
+    //NaN never counts as the same
+    vr::HmdMatrix34_t transform_nan = g_Transform;
+    transform_nan.m[1][1] = NAN;
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform_nan);
+    cache.SetOverlayTransformAbsolute(handle_a, vr::TrackingUniverseStanding, &transform_nan);
+    TEST_CHECK(GetAbsoluteCallCount() == 2);
+
+    //Failed submissions aren't remembered
+    const vr::VROverlayHandle_t handle_invalid = 12345;
+    TEST_CHECK(cache.SetOverlayTransformAbsolute(handle_invalid, vr::TrackingUniverseStanding, &g_Transform) != vr::VROverlayError_None);
+    TEST_CHECK(cache.SetOverlayTransformAbsolute(handle_invalid, vr::TrackingUniverseStanding, &g_Transform) != vr::VROverlayError_None);
+    TEST_CHECK(GetAbsoluteCallCount() == 4);
+
+    cache.SetOverlayTransformAbsolute(handle_b, vr::TrackingUniverseStanding, &g_Transform);
+    cache.Invalidate(handle_b);
+    cache.SetOverlayTransformAbsolute(handle_b, vr::TrackingUniverseStanding, &g_Transform);
+    TEST_CHECK(GetAbsoluteCallCount() == 6);
+
+    cache.InvalidateAll();
+    cache.SetOverlayTransformAbsolute(handle_b, vr::TrackingUniverseStanding, &g_Transform);
+    TEST_CHECK(GetAbsoluteCallCount() == 7);
+
+    vr::VR_Shutdown();
+}
+
+int main()
+{
+    TEST_RUN(TestSkipRepeated);
+    TEST_RUN(TestEpsilon);
+    TEST_RUN(TestInvalidation);
+
+    return TestResult();
+}
@@ -0,0 +1,189 @@
+#include "TestCommon.h"
+
+#include "PerformanceSnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+static PerformanceFrameTiming MakeTiming(uint32_t frame_index)
+{
+    PerformanceFrameTiming timing;
+    timing.FrameIndex   = frame_index;
+    timing.FrameTimeCPU = (float)frame_index;
+    timing.FrameTimeGPU = (float)frame_index * 2.0f;
+    timing.IsValid      = (frame_index % 3 != 0);
+
+    return timing;
+}
+
+static void TestRing()
+{
+    PerformanceFrameTimingRing ring;
+    TEST_CHECK(ring.GetSize() == 0);
+
+    //Filling up
+    for (uint32_t i = 1; i <= 10; ++i)
+    {
+        ring.Push(MakeTiming(i));
+    }
+
+    TEST_CHECK( (ring.GetSize() == 10) && (ring.Get(0).FrameIndex == 1) && (ring.GetNewest().FrameIndex == 10) );
+
+    //Wrapping around several times, always oldest first
+    bool is_ordered = true;
+    for (uint32_t i = 11; i <= PerformanceFrameTimingRing::MaxSize * 3 + 7; ++i)
+    {
+        ring.Push(MakeTiming(i));
+
+        const int size = ring.GetSize();
+        is_ordered &= (size == std::min((int)i, PerformanceFrameTimingRing::MaxSize));
+        is_ordered &= (ring.GetNewest().FrameIndex == i);
+
+        for (int index = 0; index < size; ++index)
+        {
+            const PerformanceFrameTiming& timing = ring.Get(index);
+            is_ordered &= ( (timing.FrameIndex == i - (uint32_t)(size - 1 - index)) && (timing.FrameTimeGPU == (float)timing.FrameIndex * 2.0f) &&
+                            (timing.IsValid == (timing.FrameIndex % 3 != 0)) );
+        }
+    }
+
+    TEST_CHECK(is_ordered);
+
+    ring.Clear();
+    TEST_CHECK(ring.GetSize() == 0);
+
+    ring.Push(MakeTiming(42));
+    TEST_CHECK( (ring.GetSize() == 1) && (ring.Get(0).FrameIndex == 42) && (ring.GetNewest().FrameIndex == 42) );
+}
+
+//Every value of the snapshot is derived from the sample count so the reader can tell if it got pieces of different snapshots
+static void FillSnapshot(PerformanceSnapshot& snapshot, uint32_t sample_count)
+{
+    snapshot.SampleCount  = sample_count;
+    snapshot.SampleTick   = sample_count * 10ull;
+    snapshot.CPULoad      = (float)sample_count;
+    snapshot.VRAMUsedGB   = (float)sample_count;
+    snapshot.FrameIndex   = sample_count;
+    snapshot.FrameTimeGPU = (float)sample_count;
+    snapshot.StatsPID     = sample_count;
+    snapshot.FrameTimingHistory.Push(MakeTiming(sample_count));
+
+    snapshot.BatteryTrackerCount = PerformanceSnapshot::MaxTrackerCount;
+    for (PerformanceTrackerBattery& tracker : snapshot.BatteryTrackers)
+    {
+        tracker.DeviceIndex = sample_count;
+    }
+
+    snapshot.ViveWirelessTemp = (int)sample_count;
+}
+
+static bool IsSnapshotConsistent(const PerformanceSnapshot& snapshot)
+{
+    const uint32_t sample_count = snapshot.SampleCount;
+
+    bool is_consistent = ( (snapshot.SampleTick == sample_count * 10ull) && (snapshot.CPULoad == (float)sample_count) && (snapshot.VRAMUsedGB == (float)sample_count) &&
+                           (snapshot.FrameIndex == sample_count) && (snapshot.FrameTimeGPU == (float)sample_count) && (snapshot.StatsPID == sample_count) &&
+                           (snapshot.ViveWirelessTemp == (int)sample_count) );
+
+    is_consistent &= ( (snapshot.FrameTimingHistory.GetSize() > 0) && (snapshot.FrameTimingHistory.GetNewest().FrameIndex == sample_count) );
+
+    for (const PerformanceTrackerBattery& tracker : snapshot.BatteryTrackers)
+    {
+        is_consistent &= (tracker.DeviceIndex == sample_count);
+    }
+
+    return is_consistent;
+}
+
+static void TestBufferSingleThread()
+{
+    std::unique_ptr<PerformanceSnapshotBuffer> buffer(new PerformanceSnapshotBuffer());
+    PerformanceSnapshot snapshot, snapshot_read;
+
+    //Nothing written yet
+    TEST_CHECK(!buffer->Read(snapshot_read));
+
+    FillSnapshot(snapshot, 1);
+    buffer->Write(snapshot);
+    TEST_CHECK( (buffer->Read(snapshot_read)) && (snapshot_read.SampleCount == 1) && (IsSnapshotConsistent(snapshot_read)) );
+    TEST_CHECK(!buffer->Read(snapshot_read));
+
+    //Only the newest of several writes is read
+    for (uint32_t i = 2; i <= 5; ++i)
+    {
+        FillSnapshot(snapshot, i);
+        buffer->Write(snapshot);
+    }
+
+    TEST_CHECK( (buffer->Read(snapshot_read)) && (snapshot_read.SampleCount == 5) && (IsSnapshotConsistent(snapshot_read)) );
+    TEST_CHECK(!buffer->Read(snapshot_read));
+}
+
+//Sampler thread writing as fast as it can while the UI thread reads. The reader must never see a torn snapshot or one older than the previous read
+static void TestBufferStress()
+{
+    const uint32_t write_count = 200000;
+
+    std::unique_ptr<PerformanceSnapshotBuffer> buffer(new PerformanceSnapshotBuffer());
+    std::atomic<bool> is_writer_done{false};
+
+    std::thread writer([&]()
+    {
+        std::unique_ptr<PerformanceSnapshot> snapshot(new PerformanceSnapshot());
+
+        for (uint32_t i = 1; i <= write_count; ++i)
+        {
+            FillSnapshot(*snapshot, i);
+            buffer->Write(*snapshot);
+
+            if (i % 256 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        is_writer_done = true;
+    });
+
+    std::unique_ptr<PerformanceSnapshot> snapshot_read(new PerformanceSnapshot());
+    bool is_consistent = true, is_ordered = true;
+    uint32_t sample_count_last = 0;
+    uint64_t read_count = 0;
+
+    auto read = [&]()
+    {
+        if (buffer->Read(*snapshot_read))
+        {
+            is_consistent &= IsSnapshotConsistent(*snapshot_read);
+            is_ordered    &= (snapshot_read->SampleCount > sample_count_last);
+            sample_count_last = snapshot_read->SampleCount;
+            read_count++;
+        }
+    };
+
+    while (!is_writer_done.load())
+    {
+        read();
+    }
+
+    writer.join();
+
+    //Last write is always picked up
+    read();
+
+    TEST_CHECK(is_consistent);
+    TEST_CHECK(is_ordered);
+    TEST_CHECK(sample_count_last == write_count);
+    TEST_CHECK( (read_count > 0) && (read_count <= write_count) );
+}
+
+int main()
+{
+    TEST_RUN(TestRing);
+    TEST_RUN(TestBufferSingleThread);
+    TEST_RUN(TestBufferStress);
+
+    return TestResult();
+}
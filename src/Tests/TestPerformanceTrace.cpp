@@ -0,0 +1,168 @@
+#include "TestCommon.h"
+
+#include "PerformanceTrace.h"
+
+#include <atomic>
+#include <thread>
+
+static void TestDisabled()
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    PerformanceTrace::Get().SetEnabled(false);
+
+    {
+        PerformanceTraceScope trace_scope(perftrace_update);
+    }
+
+    PerformanceTrace::Get().Collect(stats);
+    TEST_CHECK(stats[perftrace_update].Count == 0);
+}
+
+static void TestCollect()
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    PerformanceTrace::Get().SetEnabled(true);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        PerformanceTrace::Get().AddEvent(perftrace_draw_frame, 1000, 1000 + i + 1);
+    }
+
+    std::thread thread([]()
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            PerformanceTraceScope trace_scope(perftrace_dupl_process_frame);
+        }
+    });
+    thread.join();
+
+    PerformanceTrace::Get().Collect(stats);
+    TEST_CHECK(stats[perftrace_draw_frame].Count == 100);
+    TEST_CHECK(stats[perftrace_draw_frame].P50US == 51);
+    TEST_CHECK(stats[perftrace_draw_frame].P99US == 100);
+    TEST_CHECK(stats[perftrace_dupl_process_frame].Count == 50);
+
+    //Events are only counted once
+    PerformanceTrace::Get().Collect(stats);
+    TEST_CHECK(stats[perftrace_draw_frame].Count == 0);
+    TEST_CHECK(stats[perftrace_dupl_process_frame].Count == 0);
+
+    PerformanceTrace::Get().SetEnabled(false);
+}
+
+static void TestDrainKeepsStats()
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    PerformanceTrace::Get().SetEnabled(true);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        PerformanceTrace::Get().AddEvent(perftrace_update, 0, 5);
+    }
+
+    //Draining for a dump mustn't lose the events for the next stats update
+    PerformanceTrace::Get().Drain();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        PerformanceTrace::Get().AddEvent(perftrace_update, 0, 7);
+    }
+
+    PerformanceTrace::Get().Collect(stats);
+    TEST_CHECK(stats[perftrace_update].Count == 20);
+    TEST_CHECK(stats[perftrace_update].P50US == 7);
+
+    PerformanceTrace::Get().SetEnabled(false);
+}
+
+static void TestRingOverflow()
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    PerformanceTrace::Get().SetEnabled(true);
+
+    //Collector falling behind drops the oldest events, but never more than the ring holds
+    for (uint32_t i = 0; i < PerformanceTraceRing::Size * 3; ++i)
+    {
+        PerformanceTrace::Get().AddEvent(perftrace_draw_mouse, i, i + 1);
+    }
+
+    PerformanceTrace::Get().Collect(stats);
+    TEST_CHECK(stats[perftrace_draw_mouse].Count > 0);
+    TEST_CHECK(stats[perftrace_draw_mouse].Count <= PerformanceTraceRing::Size);
+
+    PerformanceTrace::Get().SetEnabled(false);
+}
+
+//Thread writing far faster than the collector drains, so the collector keeps reading slots that are being overwritten
+//Each stage is only ever recorded with one duration, so any torn event shows up as a wrong percentile or an unexpected stage
+static void TestConcurrentDrain()
+{
+    PerformanceTraceStageStats stats[perftrace_MAX];
+    PerformanceTrace::Get().SetEnabled(true);
+    PerformanceTrace::Get().Collect(stats);
+
+    const uint32_t write_count = 2000000;
+    std::atomic<bool> is_writer_done{false};
+
+    std::thread writer([&]()
+    {
+        for (uint32_t i = 0; i < write_count; ++i)
+        {
+            if (i % 2 == 0)
+                PerformanceTrace::Get().AddEvent(perftrace_dupl_get_frame, i, i + 3);
+            else
+                PerformanceTrace::Get().AddEvent(perftrace_dupl_process_frame, (uint64_t)i << 32, ((uint64_t)i << 32) + 70000);
+        }
+
+        is_writer_done = true;
+    });
+
+    bool is_consistent = true;
+    uint64_t event_count = 0;
+
+    auto collect = [&]()
+    {
+        PerformanceTrace::Get().Collect(stats);
+
+        const PerformanceTraceStageStats& stats_get     = stats[perftrace_dupl_get_frame];
+        const PerformanceTraceStageStats& stats_process = stats[perftrace_dupl_process_frame];
+
+        is_consistent &= ( (stats_get.Count == 0)     || ((stats_get.P50US == 3)         && (stats_get.P99US == 3)) );
+        is_consistent &= ( (stats_process.Count == 0) || ((stats_process.P50US == 70000) && (stats_process.P99US == 70000)) );
+
+        for (int i = 0; i < perftrace_MAX; ++i)
+        {
+            if ( (i != perftrace_dupl_get_frame) && (i != perftrace_dupl_process_frame) )
+            {
+                is_consistent &= (stats[i].Count == 0);
+            }
+        }
+
+        event_count += stats_get.Count + stats_process.Count;
+    };
+
+    while (!is_writer_done.load())
+    {
+        collect();
+    }
+
+    writer.join();
+    collect();
+
+    TEST_CHECK(is_consistent);
+    TEST_CHECK( (event_count > 0) && (event_count <= write_count) );
+
+    PerformanceTrace::Get().SetEnabled(false);
+}
+
+int main()
+{
+    TEST_RUN(TestDisabled);
+    TEST_RUN(TestCollect);
+    TEST_RUN(TestDrainKeepsStats);
+    TEST_RUN(TestRingOverflow);
+    TEST_RUN(TestConcurrentDrain);
+
+    return TestResult();
+}
@@ -0,0 +1,170 @@
+#include "TestCommon.h"
+
+#include "ThreadRequest.h"
+
+#include <deque>
+#include <thread>
+#include <vector>
+
+//Stand-in for a thread message queue
+class RequestQueue
+{
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<ThreadRequest*> m_Requests;
+        bool m_IsQuitting = false;
+
+    public:
+        void Post(ThreadRequest* request)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Requests.push_back(request);
+            }
+
+            m_Condition.notify_one();
+        }
+
+        //Returns nullptr once quitting and the queue is empty
+        ThreadRequest* Get()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]{ return ( (m_IsQuitting) || (!m_Requests.empty()) ); });
+
+            if (m_Requests.empty())
+                return nullptr;
+
+            ThreadRequest* request = m_Requests.front();
+            m_Requests.pop_front();
+            return request;
+        }
+
+        void Quit()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_IsQuitting = true;
+            }
+
+            m_Condition.notify_all();
+        }
+};
+
+static void TestCompleteAndCancel()
+{
+    ThreadRequestLatencyCounter counter;
+
+    ThreadRequestHandle request = ThreadRequestHandle::Create(3, &counter, 42);
+    TEST_CHECK(request->GetCommand() == 3);
+    TEST_CHECK(request->GetParam() == 42);
+    TEST_CHECK(!request->IsCompleted());
+
+    //Receiver side
+    {
+        ThreadRequestHandle request_receiver(request.ShareWithReceiver());
+        request_receiver->Complete();
+        request_receiver->Complete();   //No effect
+    }
+
+    TEST_CHECK(request->IsCompleted());
+    TEST_CHECK(request->Wait(0));
+    TEST_CHECK(counter.GetStats().Count == 1);
+
+    //Cancelled requests are completed too, but don't count towards latency
+    ThreadRequestHandle request_cancelled = ThreadRequestHandle::Create(3, &counter);
+    request_cancelled->Cancel();
+    TEST_CHECK(request_cancelled->Wait(0));
+    TEST_CHECK(counter.GetStats().Count == 1);
+
+    //Timeouts are counted
+    ThreadRequestHandle request_pending = ThreadRequestHandle::Create(3, &counter);
+    TEST_CHECK(!request_pending->Wait(1));
+    TEST_CHECK(counter.GetStats().TimeoutCount == 1);
+
+    //Sender dropping its reference before the receiver is done
+    ThreadRequest* request_receiver = request_pending.ShareWithReceiver();
+    request_pending.Reset();
+    TEST_CHECK(!request_pending);
+    request_receiver->Complete();
+    request_receiver->Release();
+    TEST_CHECK(counter.GetStats().Count == 2);
+}
+
+//Several senders and receivers, with senders waiting on some requests and dropping the others right away
+static void TestStress()
+{
+    const int thread_count  = 4;
+    const int request_count = 20000;
+
+    ThreadRequestLatencyCounter counter;
+    RequestQueue queue;
+    std::atomic<int> wait_fail_count{0};
+    std::atomic<int> cancel_count{0};
+
+    std::vector<std::thread> receivers;
+    for (int i = 0; i < thread_count; ++i)
+    {
+        receivers.emplace_back([&]()
+        {
+            while (ThreadRequest* request_ptr = queue.Get())
+            {
+                ThreadRequestHandle request(request_ptr);
+
+                if (request->GetParam() % 7 == 0)
+                {
+                    request->Cancel();
+                    ++cancel_count;
+                }
+                else
+                {
+                    request->Complete();
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> senders;
+    for (int i = 0; i < thread_count; ++i)
+    {
+        senders.emplace_back([&]()
+        {
+            for (int request_id = 0; request_id < request_count; ++request_id)
+            {
+                ThreadRequestHandle request = ThreadRequestHandle::Create(0, &counter, request_id);
+                queue.Post(request.ShareWithReceiver());
+
+                if ( (request_id % 3 == 0) && (!request->Wait(10000)) )
+                {
+                    ++wait_fail_count;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : senders)
+    {
+        thread.join();
+    }
+
+    queue.Quit();
+
+    for (auto& thread : receivers)
+    {
+        thread.join();
+    }
+
+    ThreadRequestLatencyStats stats = counter.GetStats();
+    TEST_CHECK(wait_fail_count == 0);
+    TEST_CHECK(stats.TimeoutCount == 0);
+    TEST_CHECK(stats.Count + cancel_count == (uint64_t)(thread_count * request_count));
+    TEST_CHECK(stats.AverageUS <= stats.MaxUS);
+}
+
+int main()
+{
+    TEST_RUN(TestCompleteAndCancel);
+    TEST_RUN(TestStress);
+
+    return TestResult();
+}
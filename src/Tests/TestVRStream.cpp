@@ -0,0 +1,223 @@
+#include "TestCommon.h"
+
+#include "VRStream.h"
+#include "HeadlessVR.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static const char* const g_RecordingPath = "TestVRStream.dpvrs";
+
+static vr::HmdMatrix34_t MatrixTranslation(float x, float y, float z)
+{
+    return {{{1.0f, 0.0f, 0.0f, x}, {0.0f, 1.0f, 0.0f, y}, {0.0f, 0.0f, 1.0f, z}}};
+}
+
+static std::string ReadFile(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const char* path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+}
+
+static vr::VREvent_t MakeMouseEvent(float x)
+{
+    vr::VREvent_t vr_event = {};
+    vr_event.eventType    = vr::VREvent_MouseMove;
+    vr_event.data.mouse.x = x;
+
+    return vr_event;
+}
+
+//Records like OutputManager::HandleOpenVREvents() does, with scripted events and poses from HeadlessVR
+static void RecordStream(vr::VROverlayHandle_t handle_a, vr::VROverlayHandle_t handle_b, int frame_count)
+{
+    VRStreamRecorder recorder;
+    TEST_CHECK(recorder.Start(g_RecordingPath));
+    TEST_CHECK(recorder.IsRecording());
+
+    for (int i = 0; i < frame_count; ++i)
+    {
+        //Controller moves every other frame
+        if (i % 2 == 0)
+        {
+            HeadlessVR::SetDevicePose(1, MatrixTranslation((float)i, 0.0f, 0.0f));
+        }
+
+        HeadlessVR::QueueOverlayEvent(handle_a, MakeMouseEvent((float)i));
+
+        if (i % 3 == 0)
+        {
+            HeadlessVR::QueueOverlayEvent(handle_b, MakeMouseEvent((float)-i));
+        }
+
+        if (i == frame_count - 1)
+        {
+            vr::VREvent_t vr_event = {};
+            vr_event.eventType = vr::VREvent_Quit;
+            HeadlessVR::QueueSystemEvent(vr_event);
+        }
+
+        recorder.RecordFrame();
+
+        vr::VREvent_t vr_event;
+        for (vr::VROverlayHandle_t handle : {handle_a, handle_b})
+        {
+            while (vr::VROverlay()->PollNextOverlayEvent(handle, &vr_event, sizeof(vr_event)))
+            {
+                recorder.RecordEvent(handle, vr_event);
+            }
+        }
+
+        while (vr::VRSystem()->PollNextEvent(&vr_event, sizeof(vr_event)))
+        {
+            recorder.RecordEvent(vr::k_ulOverlayHandleInvalid, vr_event);
+        }
+    }
+
+    recorder.Stop();
+    TEST_CHECK(!recorder.IsRecording());
+}
+
+static void InitRuntime(vr::VROverlayHandle_t& handle_a, vr::VROverlayHandle_t& handle_b)
+{
+    HeadlessVR::Reset();
+
+    vr::EVRInitError init_error;
+    vr::VR_Init(&init_error, vr::VRApplication_Overlay);
+
+    vr::VROverlay()->CreateOverlay("dplus.a", "A", &handle_a);
+    vr::VROverlay()->CreateOverlay("dplus.b", "B", &handle_b);
+    HeadlessVR::SetDevice(1, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_RightHand);
+}
+
+static void TestRoundTrip()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+
+    const int frame_count = 30;
+    RecordStream(handle_a, handle_b, frame_count);
+
+    VRStreamRecording recording;
+    TEST_CHECK(recording.LoadFromFile(g_RecordingPath));
+    TEST_CHECK(recording.Frames.size() == frame_count);
+    TEST_CHECK( (recording.OverlayKeys.size() == 2) && (recording.OverlayKeys[0] == "dplus.a") && (recording.OverlayKeys[1] == "dplus.b") );
+    TEST_CHECK(recording.GetEventCount() == frame_count + (frame_count + 2) / 3 + 1);
+
+    //First frame has all connected devices, later ones only what changed
+    TEST_CHECK(recording.Frames[0].Poses.size() == 2);
+    TEST_CHECK( (recording.Frames[0].Poses[0].DeviceIndex == vr::k_unTrackedDeviceIndex_Hmd) && (recording.Frames[0].Poses[0].DeviceClass == vr::TrackedDeviceClass_HMD) );
+    TEST_CHECK( (recording.Frames[0].Poses[1].DeviceIndex == 1) && (recording.Frames[0].Poses[1].ControllerRole == vr::TrackedControllerRole_RightHand) );
+    TEST_CHECK(recording.Frames[1].Poses.empty());
+
+    bool is_stream_correct = true;
+    uint64_t timestamp_prev = 0;
+
+    for (int i = 0; i < frame_count; ++i)
+    {
+        const VRStreamFrame& frame = recording.Frames[i];
+
+        is_stream_correct &= (frame.TimestampUS >= timestamp_prev);
+        timestamp_prev = frame.TimestampUS;
+
+        if ( (i != 0) && (i % 2 == 0) )
+        {
+            is_stream_correct &= ( (frame.Poses.size() == 1) && (frame.Poses[0].DeviceToAbsoluteTracking.m[0][3] == (float)i) );
+        }
+
+        is_stream_correct &= ( (frame.Events.size() >= 1) && (frame.Events[0].OverlayID == 1) && (frame.Events[0].Event.data.mouse.x == (float)i) );
+
+        if (i % 3 == 0)
+        {
+            is_stream_correct &= ( (frame.Events.size() >= 2) && (frame.Events[1].OverlayID == 2) && (frame.Events[1].Event.data.mouse.x == (float)-i) );
+        }
+    }
+
+    TEST_CHECK(is_stream_correct);
+
+    //System events have no overlay
+    const VRStreamFrame& frame_last = recording.Frames.back();
+    TEST_CHECK( (frame_last.Events.back().OverlayID == 0) && (frame_last.Events.back().Event.eventType == vr::VREvent_Quit) );
+}
+
+//A recording cut off anywhere loads up to the last complete record, as long as the header is there
+static void TestTruncated()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+    RecordStream(handle_a, handle_b, 10);
+
+    const std::string data = ReadFile(g_RecordingPath);
+    const size_t header_size = 16;
+    TEST_CHECK(data.size() > header_size);
+
+    size_t frame_count_prev = 0;
+    bool is_monotonic = true;
+
+    for (size_t size = 0; size < data.size(); size += 7)
+    {
+        WriteFile(g_RecordingPath, data.substr(0, size));
+
+        VRStreamRecording recording;
+        const bool is_loaded = recording.LoadFromFile(g_RecordingPath);
+        TEST_CHECK(is_loaded == (size >= header_size));
+
+        is_monotonic &= (recording.Frames.size() >= frame_count_prev);
+        frame_count_prev = recording.Frames.size();
+    }
+
+    TEST_CHECK(is_monotonic);
+    TEST_CHECK(frame_count_prev <= 10);
+}
+
+static void TestInvalid()
+{
+    vr::VROverlayHandle_t handle_a, handle_b;
+    InitRuntime(handle_a, handle_b);
+    RecordStream(handle_a, handle_b, 3);
+
+    const std::string data = ReadFile(g_RecordingPath);
+    VRStreamRecording recording;
+
+    //Magic, version and event size
+    for (size_t pos : {0, 8, 12})
+    {
+        std::string data_broken = data;
+        data_broken[pos]++;
+        WriteFile(g_RecordingPath, data_broken);
+        TEST_CHECK(!recording.LoadFromFile(g_RecordingPath));
+    }
+
+    //Unknown record type
+    WriteFile(g_RecordingPath, data + '\x7F');
+    TEST_CHECK(!recording.LoadFromFile(g_RecordingPath));
+
+    //Event before any frame
+    BinaryWriter writer;
+    writer.Write<uint8_t>(vrstream_record_event);
+    writer.Write<uint32_t>(0);
+    writer.Write(vr::VREvent_t());
+    WriteFile(g_RecordingPath, data.substr(0, 16) + writer.GetBuffer());
+    TEST_CHECK(!recording.LoadFromFile(g_RecordingPath));
+
+    TEST_CHECK(!recording.LoadFromFile("TestVRStream.missing.dpvrs"));
+
+    std::remove(g_RecordingPath);
+}
+
+int main()
+{
+    TEST_RUN(TestRoundTrip);
+    TEST_RUN(TestTruncated);
+    TEST_RUN(TestInvalid);
+
+    return TestResult();
+}
@@ -0,0 +1,176 @@
+#include "TestCommon.h"
+
+#include "WindowStateCache.h"
+
+#include <thread>
+#include <vector>
+
+static void TestForegroundWindow()
+{
+    WindowStateCache cache;
+    uintptr_t window = 0;
+
+    TEST_CHECK(!cache.GetForegroundWindow(window));
+    TEST_CHECK(cache.GetFallbackCount() == 1);
+
+    cache.SetActive(true, 5);
+    TEST_CHECK( (cache.GetForegroundWindow(window)) && (window == 5) );
+
+    cache.OnForegroundChanged(7);
+    TEST_CHECK( (cache.GetForegroundWindow(window)) && (window == 7) );
+    TEST_CHECK(cache.GetHitCount() == 2);
+
+    cache.SetActive(false, 0);
+    TEST_CHECK(!cache.GetForegroundWindow(window));
+    TEST_CHECK(cache.GetFallbackCount() == 2);
+}
+
+//Only watched windows are cached, everything else has to be queried every time
+static void TestWatchedWindows()
+{
+    WindowStateCache cache;
+    WindowStateCache::LocationToken token, token_unwatched;
+    cache.SetActive(true, 0);
+
+    const uintptr_t windows[] = {9, 10};
+    cache.SetWatchedWindows(windows, 2);
+
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));   //First read always queries
+    TEST_CHECK(cache.IsLocationUnchanged(9, token));
+    TEST_CHECK(cache.IsLocationUnchanged(9, token));
+
+    //Changes of other windows don't matter
+    cache.OnLocationChanged(10);
+    cache.OnLocationChanged(11);
+    TEST_CHECK(cache.IsLocationUnchanged(9, token));
+
+    cache.OnLocationChanged(9);
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));
+    TEST_CHECK(cache.IsLocationUnchanged(9, token));
+
+    TEST_CHECK(!cache.IsLocationUnchanged(11, token_unwatched));
+    TEST_CHECK(!cache.IsLocationUnchanged(11, token_unwatched));
+
+    //Unwatching invalidates, even if the window is watched again right after
+    cache.SetWatchedWindows(windows + 1, 1);
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));
+    cache.SetWatchedWindows(windows, 2);
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));
+    TEST_CHECK(cache.IsLocationUnchanged(9, token));
+
+    //Deactivating unwatches everything
+    cache.SetActive(false, 0);
+    cache.SetActive(true, 0);
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));
+    TEST_CHECK(!cache.IsLocationUnchanged(9, token));
+}
+
+//A slot reused for another window must not validate tokens of the previous one
+static void TestSlotReuse()
+{
+    WindowStateCache cache;
+    WindowStateCache::LocationToken token_a, token_b;
+    cache.SetActive(true, 0);
+
+    const uintptr_t window_a = 1, window_b = 2;
+    cache.SetWatchedWindows(&window_a, 1);
+    TEST_CHECK(!cache.IsLocationUnchanged(window_a, token_a));
+    TEST_CHECK(cache.IsLocationUnchanged(window_a, token_a));
+
+    cache.SetWatchedWindows(&window_b, 1);
+    TEST_CHECK(!cache.IsLocationUnchanged(window_a, token_a));
+    TEST_CHECK(!cache.IsLocationUnchanged(window_b, token_b));
+    TEST_CHECK(cache.IsLocationUnchanged(window_b, token_b));
+
+    //Token of window B used for window A once it's back in the same slot
+    cache.SetWatchedWindows(&window_a, 1);
+    TEST_CHECK(!cache.IsLocationUnchanged(window_a, token_b));
+}
+
+static void TestWatchedWindowMax()
+{
+    WindowStateCache cache;
+    cache.SetActive(true, 0);
+
+    std::vector<uintptr_t> windows;
+    for (uintptr_t i = 1; i <= WindowStateCache::WatchedWindowMax + 8; ++i)
+    {
+        windows.push_back(i);
+    }
+
+    windows.push_back(0);   //Ignored
+    windows.push_back(3);   //Duplicate
+    cache.SetWatchedWindows(windows.data(), windows.size());
+
+    int watched_count = 0;
+    for (uintptr_t window : windows)
+    {
+        WindowStateCache::LocationToken token;
+        cache.IsLocationUnchanged(window, token);
+
+        if (cache.IsLocationUnchanged(window, token))
+        {
+            watched_count++;
+        }
+    }
+
+    //The duplicate is counted twice
+    TEST_CHECK(watched_count == (int)WindowStateCache::WatchedWindowMax + 1);
+}
+
+//Readers must never miss a location change that happened before their read
+static void TestConcurrentChanges()
+{
+    WindowStateCache cache;
+    cache.SetActive(true, 0);
+
+    const uintptr_t window = 42;
+    cache.SetWatchedWindows(&window, 1);
+
+    std::atomic<uint32_t> change_count{0};
+    std::atomic<bool> is_done{false};
+    const uint32_t change_count_target = 100000;
+
+    std::thread feeder([&]()
+    {
+        for (uint32_t i = 0; i < change_count_target; ++i)
+        {
+            cache.OnLocationChanged(window);
+            change_count.store(i + 1, std::memory_order_release);
+        }
+
+        is_done = true;
+    });
+
+    //Changes counted before a read that weren't counted yet after the previous read happened in between the two, so the read must not report no change
+    WindowStateCache::LocationToken token;
+    uint32_t change_count_after_prev = 0;
+    bool missed_change = false;
+
+    while (!is_done)
+    {
+        const uint32_t change_count_before = change_count.load(std::memory_order_acquire);
+
+        if ( (cache.IsLocationUnchanged(window, token)) && (change_count_before > change_count_after_prev) )
+        {
+            missed_change = true;
+        }
+
+        change_count_after_prev = change_count.load(std::memory_order_acquire);
+    }
+
+    feeder.join();
+
+    TEST_CHECK(!missed_change);
+}
+
+int main()
+{
+    TEST_RUN(TestForegroundWindow);
+    TEST_RUN(TestWatchedWindows);
+    TEST_RUN(TestSlotReuse);
+    TEST_RUN(TestWatchedWindowMax);
+    TEST_RUN(TestConcurrentChanges);
+
+    return TestResult();
+}